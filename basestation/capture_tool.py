@@ -0,0 +1,232 @@
+#!/usr/bin/env python3
+"""
+Motion Capture Tool for GuitarAcc Basestation
+
+Pulls a motion capture from the basestation ("capture dump"), writes it as
+a binary .gcap file for integration_test/replay, and converts captures to
+CSV.
+
+File layout (little-endian):
+    header   magic "GCAP"(4) version(1) record_size(1) flags(1) reserved(1)
+             record_count(4) overwritten(4)
+    records  timestamp_us(4) guitar(1) flags(1) x(2) y(2) z(2) gx(2) gy(2) gz(2)
+
+Records flagged F_GYRO carry the client's angular rate in gx/gy/gz;
+records flagged F_EVENT are edge events with x = type, y = flags, z = value.
+"""
+
+import argparse
+import csv
+import re
+import struct
+import sys
+import time
+
+CAPTURE_MAGIC = b'GCAP'
+CAPTURE_VERSION = 2
+HEADER_FMT = '<4sBBBBII'
+RECORD_FMT = '<IBBhhhhhh'
+HEADER_SIZE = struct.calcsize(HEADER_FMT)
+RECORD_SIZE = struct.calcsize(RECORD_FMT)
+
+F_TIMED = 0x01
+F_GYRO = 0x02
+F_EVENT = 0x04
+H_WRAPPED = 0x01
+
+# shell_hexdump() line: "00000000: 47 43 41 50 ... |GCAP...|"
+HEXDUMP_LINE = re.compile(r'^\s*[0-9A-Fa-f]{8}:\s((?:[0-9A-Fa-f]{2}\s+)+)')
+
+
+def hexdump_to_bytes(text):
+    """Concatenate the bytes of every hexdump line in text."""
+    data = bytearray()
+    for line in text.splitlines():
+        m = HEXDUMP_LINE.match(line)
+        if m:
+            data += bytes(int(b, 16) for b in m.group(1).split())
+    return bytes(data)
+
+
+def parse_capture(data):
+    """Return (header dict, list of record tuples), or raise ValueError."""
+    if len(data) < HEADER_SIZE:
+        raise ValueError('capture too short')
+    magic, version, rec_size, flags, _, count, overwritten = \
+        struct.unpack_from(HEADER_FMT, data, 0)
+    if magic != CAPTURE_MAGIC or version != CAPTURE_VERSION or rec_size != RECORD_SIZE:
+        raise ValueError('not a version %d capture' % CAPTURE_VERSION)
+    if len(data) < HEADER_SIZE + count * RECORD_SIZE:
+        raise ValueError('truncated: %d of %d records' %
+                         ((len(data) - HEADER_SIZE) // RECORD_SIZE, count))
+    records = [struct.unpack_from(RECORD_FMT, data, HEADER_SIZE + i * RECORD_SIZE)
+               for i in range(count)]
+    header = {'count': count, 'flags': flags, 'overwritten': overwritten}
+    return header, records
+
+
+def read_dump(ser, idle_timeout=1.0):
+    """Send "capture dump" and collect output until the line goes quiet."""
+    ser.reset_input_buffer()
+    ser.write(b"capture dump\r\n")
+    ser.flush()
+
+    text = bytearray()
+    last_rx = time.time()
+    while time.time() - last_rx < idle_timeout:
+        chunk = ser.read(4096)
+        if chunk:
+            text += chunk
+            last_rx = time.time()
+    return text.decode('utf-8', errors='replace')
+
+
+def print_info(header, records):
+    print(f"Records:     {header['count']}")
+    print(f"Overwritten: {header['overwritten']}"
+          f"{' (ring wrapped)' if header['flags'] & H_WRAPPED else ''}")
+    if records:
+        span = (records[-1][0] - records[0][0]) & 0xFFFFFFFF
+        guitars = sorted({r[1] for r in records})
+        timed = sum(1 for r in records if r[2] & F_TIMED)
+        gyro = sum(1 for r in records if r[2] & F_GYRO)
+        events = sum(1 for r in records if r[2] & F_EVENT)
+        print(f"Span:        {span / 1e6:.3f} s")
+        print(f"Guitars:     {', '.join(str(g) for g in guitars)}")
+        print(f"Timestamped: {timed} of {len(records)}")
+        print(f"With gyro:   {gyro}")
+        print(f"Edge events: {events}")
+
+
+def write_csv(path, records):
+    t0 = records[0][0] if records else 0
+    with open(path, 'w', newline='') as f:
+        writer = csv.writer(f)
+        writer.writerow(['time_us', 'guitar', 'timed', 'gyro', 'event',
+                         'x', 'y', 'z', 'gx', 'gy', 'gz'])
+        for ts, guitar, flags, x, y, z, gx, gy, gz in records:
+            writer.writerow([(ts - t0) & 0xFFFFFFFF, guitar, int(bool(flags & F_TIMED)),
+                             int(bool(flags & F_GYRO)), int(bool(flags & F_EVENT)),
+                             x, y, z, gx, gy, gz])
+
+
+def pull(args):
+    import serial
+    from select_port import select_port
+
+    port = args.port or select_port(auto_select=True)
+    if port is None:
+        print("No port selected. Exiting.", file=sys.stderr)
+        return False
+
+    with serial.Serial(port, 115200, timeout=0.1, rtscts=True) as ser:
+        print(f"Connected to {port}")
+        time.sleep(0.5)
+        if args.stop:
+            ser.write(b"capture stop\r\n")
+            ser.flush()
+            time.sleep(0.2)
+        text = read_dump(ser)
+
+    if 'Stop the capture first' in text:
+        print("Capture still recording; run 'capture stop' or pass --stop", file=sys.stderr)
+        return False
+
+    data = hexdump_to_bytes(text)
+    try:
+        header, records = parse_capture(data)
+    except ValueError as e:
+        print(f"Invalid dump: {e}", file=sys.stderr)
+        return False
+
+    with open(args.output, 'wb') as f:
+        f.write(data[:HEADER_SIZE + header['count'] * RECORD_SIZE])
+    print(f"Wrote {args.output}")
+    print_info(header, records)
+    if args.csv:
+        write_csv(args.csv, records)
+    return True
+
+
+def import_log(args):
+    """Convert a saved terminal log containing "capture dump" output."""
+    with open(args.input, 'r', errors='replace') as f:
+        data = hexdump_to_bytes(f.read())
+    try:
+        header, records = parse_capture(data)
+    except ValueError as e:
+        print(f"Invalid dump: {e}", file=sys.stderr)
+        return False
+
+    with open(args.output, 'wb') as f:
+        f.write(data[:HEADER_SIZE + header['count'] * RECORD_SIZE])
+    print(f"Wrote {args.output}")
+    print_info(header, records)
+    return True
+
+
+def info(args):
+    with open(args.input, 'rb') as f:
+        data = f.read()
+    try:
+        header, records = parse_capture(data)
+    except ValueError as e:
+        print(f"Invalid capture: {e}", file=sys.stderr)
+        return False
+
+    print_info(header, records)
+    if args.csv:
+        write_csv(args.csv, records)
+        print(f"Wrote {args.csv}")
+    return True
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='GuitarAcc Basestation Motion Capture Tool',
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+        epilog="""
+Examples:
+  # On the device: capture start ... play ... capture stop
+  %(prog)s pull -p /dev/ttyUSB0 -o show.gcap
+
+  # Stop and pull in one go, also write CSV
+  %(prog)s pull -p /dev/ttyUSB0 -o show.gcap --stop --csv show.csv
+
+  # Convert a terminal log that contains "capture dump" output
+  %(prog)s import -i terminal.log -o show.gcap
+
+  # Inspect, then replay on the host
+  %(prog)s info -i show.gcap
+  ../integration_test/replay show.gcap --midi show.bin --timing show.csv
+"""
+    )
+
+    subparsers = parser.add_subparsers(dest='command', help='Command to execute')
+
+    pull_parser = subparsers.add_parser('pull', help='Dump capture from device to .gcap')
+    pull_parser.add_argument('-p', '--port', help='Serial port (or use auto-select)')
+    pull_parser.add_argument('-o', '--output', required=True, help='Capture file to write')
+    pull_parser.add_argument('--stop', action='store_true', help='Stop recording first')
+    pull_parser.add_argument('--csv', help='Also write records to CSV')
+
+    import_parser = subparsers.add_parser('import', help='Convert a terminal log to .gcap')
+    import_parser.add_argument('-i', '--input', required=True, help='Terminal log')
+    import_parser.add_argument('-o', '--output', required=True, help='Capture file to write')
+
+    info_parser = subparsers.add_parser('info', help='Summarize a capture file')
+    info_parser.add_argument('-i', '--input', required=True, help='Capture file')
+    info_parser.add_argument('--csv', help='Write records to CSV')
+
+    args = parser.parse_args()
+
+    handlers = {'pull': pull, 'import': import_log, 'info': info}
+    if args.command not in handlers:
+        parser.print_help()
+        sys.exit(1)
+    if not handlers[args.command](args):
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
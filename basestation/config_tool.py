@@ -11,6 +11,10 @@ import time
 import sys
 import json
 import argparse
+import re
+import base64
+import hashlib
+import zlib
 from select_port import select_port
 
 
@@ -233,6 +237,302 @@ def validate_config(config_file):
         return False
 
 
+# Binary transfer ('config bin' shell commands)
+BIN_CHUNK_SIZE = 48
+BIN_FORMAT = 'guitaracc-config-bin'
+ANSI_ESCAPE = re.compile(r'\x1B(?:[@-Z\\-_]|\[[0-?]*[ -/]*[@-~])')
+REPLY_RE = re.compile(r'^(OK|ERR)\b\s*(.*)$')
+
+
+def read_lines(ser, until, timeout=2.0):
+    """Read shell output lines until until(line) is true; return them or None."""
+    deadline = time.time() + timeout
+    buf = ''
+    lines = []
+    while time.time() < deadline:
+        data = ser.read(ser.in_waiting or 1)
+        if not data:
+            continue
+        buf += data.decode('utf-8', errors='replace')
+        *complete, buf = buf.split('\n')
+        for raw in complete:
+            line = ANSI_ESCAPE.sub('', raw).strip()
+            lines.append(line)
+            if until(line):
+                return lines
+    return None
+
+
+def bin_command(ser, cmd, timeout=1.0):
+    """Send one 'config bin' command; return (ok, reply text), ok None on timeout."""
+    ser.write(f"{cmd}\r\n".encode())
+    lines = read_lines(ser, lambda line: REPLY_RE.match(line), timeout)
+    if lines is None:
+        return None, 'timeout'
+    m = REPLY_RE.match(lines[-1])
+    return m.group(1) == 'OK', m.group(2)
+
+
+def next_offset(reply):
+    """Next offset the device wants, from the last number of an OK/ERR reply."""
+    numbers = re.findall(r'-?\d+', reply.split('(')[0])
+    return int(numbers[-1]) if numbers else None
+
+
+def read_dump(ser):
+    """Run 'config bin dump'; return (version, image) or None."""
+    ser.write(b"config bin dump\r\n")
+    lines = read_lines(ser, lambda line: line.startswith('CFGBIN END'), timeout=3.0)
+    if lines is None:
+        print("Error: no complete dump received", file=sys.stderr)
+        return None
+
+    header = None
+    image = bytearray()
+    for line in lines:
+        fields = line.split()
+        if len(fields) == 5 and fields[:2] == ['CFGBIN', 'BEGIN']:
+            header = (int(fields[2]), int(fields[3]), fields[4].lower())
+        elif len(fields) == 4 and fields[0] == 'CFGBIN' and fields[1].isdigit():
+            offset, data = int(fields[1]), base64.b64decode(fields[2])
+            if offset != len(image) or zlib.crc32(data) != int(fields[3], 16):
+                print(f"Error: bad chunk at offset {offset}", file=sys.stderr)
+                return None
+            image += data
+
+    if header is None or len(image) != header[1]:
+        print("Error: incomplete dump", file=sys.stderr)
+        return None
+    if hashlib.sha256(image).hexdigest() != header[2]:
+        print("Error: SHA-256 mismatch", file=sys.stderr)
+        return None
+    return header[0], bytes(image)
+
+
+def read_schema(ser):
+    """Run 'config schema'; return the layout as a dict or None."""
+    ser.write(b"config schema\r\n")
+    lines = read_lines(ser, lambda line: line.startswith('CFGSCHEMA END'), timeout=2.0)
+    if lines is None:
+        return None
+
+    schema = None
+    for line in lines:
+        fields = line.split()
+        if len(fields) == 4 and fields[0] == 'CFGSCHEMA':
+            schema = {'version': int(fields[1]), 'size': int(fields[2]), 'fields': []}
+        elif len(fields) == 7 and fields[0] == 'CFGFIELD' and schema is not None:
+            schema['fields'].append({
+                'name': fields[1], 'kind': fields[2], 'offset': int(fields[3]),
+                'size': int(fields[4]), 'count': int(fields[5]), 'stride': int(fields[6]),
+            })
+    return schema
+
+
+def migrate_image(image, schema, target_schema, defaults):
+    """Convert image to target_schema's layout, field by field over defaults.
+
+    Same rules as config_schema_migrate() in the firmware: fields are
+    matched by name, integers are extended and clamped to the new width,
+    blobs keep their common leading bytes, repeated fields their common
+    repetitions. Fields not in the old layout keep the target's defaults.
+    The firmware's upgrade hooks are not run here.
+    """
+    old_fields = {f['name']: f for f in schema['fields']}
+    out = bytearray(defaults)
+    for t in target_schema['fields']:
+        f = old_fields.get(t['name'])
+        if f is None:
+            continue
+        ints = f['kind'] != 'bytes' and t['kind'] != 'bytes'
+        for i in range(min(f['count'], t['count'])):
+            src = f['offset'] + i * f['stride']
+            dst = t['offset'] + i * t['stride']
+            if ints:
+                value = int.from_bytes(image[src:src + f['size']], 'little',
+                                       signed=f['kind'] == 'int')
+                bits = 8 * t['size']
+                lo, hi = (-(1 << (bits - 1)), (1 << (bits - 1)) - 1) if t['kind'] == 'int' \
+                    else (0, (1 << bits) - 1)
+                value = min(max(value, lo), hi)
+                out[dst:dst + t['size']] = value.to_bytes(t['size'], 'little',
+                                                          signed=t['kind'] == 'int')
+            else:
+                n = min(f['size'], t['size'])
+                out[dst:dst + n] = image[src:src + n]
+    return bytes(out)
+
+
+def make_backup(version, image, schema):
+    """Backup file contents for an image."""
+    return {
+        'format': BIN_FORMAT,
+        'version': version,
+        'size': len(image),
+        'sha256': hashlib.sha256(image).hexdigest(),
+        'data': base64.b64encode(image).decode(),
+        'schema': schema,
+    }
+
+
+def load_backup(input_file):
+    """Read and check a backup file; return (backup, image) or None."""
+    with open(input_file, 'r') as f:
+        backup = json.load(f)
+    if backup.get('format') != BIN_FORMAT:
+        print(f"Error: '{input_file}' is not a binary backup", file=sys.stderr)
+        return None
+
+    image = base64.b64decode(backup['data'])
+    if len(image) != backup['size'] or hashlib.sha256(image).hexdigest() != backup['sha256']:
+        print(f"Error: '{input_file}' is corrupt (size or SHA-256)", file=sys.stderr)
+        return None
+    return backup, image
+
+
+def convert_backup(backup, image, target_schema, defaults):
+    """Migrate a backup's image to target_schema; return the new image or None."""
+    schema = backup.get('schema')
+    if schema is None or schema['version'] != backup['version']:
+        print(f"Error: backup is version {backup['version']} and has no layout "
+              f"to migrate from", file=sys.stderr)
+        return None
+    if backup['version'] > target_schema['version']:
+        print(f"Error: backup version {backup['version']} is newer than "
+              f"{target_schema['version']}", file=sys.stderr)
+        return None
+    print(f"Migrating backup from version {backup['version']} to {target_schema['version']}")
+    return migrate_image(image, schema, target_schema, defaults)
+
+
+def migrate_backup(input_file, target_file, output_file):
+    """Offline: convert a backup to the layout (and defaults) of another backup."""
+    try:
+        source = load_backup(input_file)
+        target = load_backup(target_file)
+        if source is None or target is None:
+            return False
+        if target[0].get('schema') is None:
+            print(f"Error: '{target_file}' has no layout", file=sys.stderr)
+            return False
+
+        image = convert_backup(source[0], source[1], target[0]['schema'], target[1])
+        if image is None:
+            return False
+        with open(output_file, 'w') as f:
+            json.dump(make_backup(target[0]['version'], image, target[0]['schema']), f, indent=2)
+        print(f"Wrote version {target[0]['version']} backup to {output_file}")
+        return True
+
+    except FileNotFoundError as e:
+        print(f"Error: File '{e.filename}' not found", file=sys.stderr)
+        return False
+    except Exception as e:
+        print(f'Error: {e}', file=sys.stderr)
+        return False
+
+
+def backup_config(port, output_file):
+    """Dump the whole configuration image as checksummed base64 chunks."""
+    try:
+        ser = serial.Serial(port, 115200, timeout=0.05, rtscts=True)
+        time.sleep(0.2)
+        ser.reset_input_buffer()
+        start = time.time()
+
+        dump = read_dump(ser)
+        schema = read_schema(ser) if dump else None
+        ser.close()
+        if dump is None:
+            return False
+        if schema is None or schema['version'] != dump[0]:
+            # Still a valid backup, just not one that can be migrated later
+            print("Warning: no config layout from the device", file=sys.stderr)
+            schema = None
+
+        version, image = dump
+        with open(output_file, 'w') as f:
+            json.dump(make_backup(version, image, schema), f, indent=2)
+
+        print(f"Backed up {len(image)} bytes in {time.time() - start:.2f} s")
+        return True
+
+    except Exception as e:
+        print(f'Error: {e}', file=sys.stderr)
+        return False
+
+
+def restore_config(port, input_file, retries=5):
+    """Send a backup image chunk by chunk, resuming from the device's next offset."""
+    try:
+        loaded = load_backup(input_file)
+        if loaded is None:
+            return False
+        backup, image = loaded
+        version = backup['version']
+
+        ser = serial.Serial(port, 115200, timeout=0.05, rtscts=True)
+        time.sleep(0.2)
+        ser.reset_input_buffer()
+        start = time.time()
+
+        # Backup from other firmware: migrate on top of the device's current config
+        device_schema = read_schema(ser)
+        if device_schema is not None and device_schema['version'] != version:
+            current = read_dump(ser)
+            image = convert_backup(backup, image, device_schema, current[1]) if current else None
+            if image is None:
+                ser.close()
+                return False
+            version = device_schema['version']
+
+        sha = hashlib.sha256(image).hexdigest()
+        ok, reply = bin_command(ser, f"config bin begin {version} {len(image)} {sha}")
+        if not ok:
+            print(f"Error: device refused import: {reply}", file=sys.stderr)
+            ser.close()
+            return False
+        offset = next_offset(reply)
+        if 'resumed' in reply:
+            print(f"Resuming at offset {offset}")
+
+        failures = 0
+        while offset is not None and offset < len(image):
+            data = image[offset:offset + BIN_CHUNK_SIZE]
+            ok, reply = bin_command(ser, f"config bin put {offset} "
+                                    f"{base64.b64encode(data).decode()} {zlib.crc32(data):08x}")
+            if ok is None:
+                # Lost the reply: ask where the device is
+                ok, reply = bin_command(ser, "config bin status")
+            if not ok:
+                failures += 1
+                if failures > retries:
+                    print(f"Error: giving up at offset {offset}: {reply}", file=sys.stderr)
+                    ser.close()
+                    return False
+            offset = next_offset(reply) if ok is not None else offset
+            if offset is None or offset < 0:
+                print(f"Error: import lost on the device: {reply}", file=sys.stderr)
+                ser.close()
+                return False
+
+        ok, reply = bin_command(ser, "config bin commit", timeout=3.0)
+        ser.close()
+        if not ok:
+            print(f"Error: commit failed: {reply}", file=sys.stderr)
+            return False
+
+        print(f"Restored {len(image)} bytes in {time.time() - start:.2f} s")
+        return True
+
+    except FileNotFoundError:
+        print(f"Error: File '{input_file}' not found", file=sys.stderr)
+        return False
+    except Exception as e:
+        print(f'Error: {e}', file=sys.stderr)
+        return False
+
+
 def main():
     parser = argparse.ArgumentParser(
         description='GuitarAcc Basestation Configuration Tool',
@@ -253,6 +553,13 @@ Examples:
   
   # Validate configuration file
   %(prog)s validate -i config.json
+  
+  # Fast binary backup and restore of the whole device
+  %(prog)s backup -p /dev/ttyUSB0 -o device.gcfg
+  %(prog)s restore -p /dev/ttyUSB0 -i device.gcfg
+  
+  # Convert an old backup to the layout of a backup from newer firmware
+  %(prog)s migrate -i old.gcfg --target new.gcfg -o converted.gcfg
 """
     )
     
@@ -275,6 +582,21 @@ Examples:
     validate_parser = subparsers.add_parser('validate', help='Validate configuration file')
     validate_parser.add_argument('-i', '--input', required=True, help='Input JSON file')
     
+    # Binary backup/restore commands
+    backup_parser = subparsers.add_parser('backup', help='Binary backup of the whole configuration')
+    backup_parser.add_argument('-p', '--port', help='Serial port (or use auto-select)')
+    backup_parser.add_argument('-o', '--output', required=True, help='Output backup file')
+    
+    restore_parser = subparsers.add_parser('restore', help='Binary restore of a backup')
+    restore_parser.add_argument('-p', '--port', help='Serial port (or use auto-select)')
+    restore_parser.add_argument('-i', '--input', required=True, help='Input backup file')
+    
+    migrate_parser = subparsers.add_parser('migrate', help='Convert a backup to another config version')
+    migrate_parser.add_argument('-i', '--input', required=True, help='Backup to convert')
+    migrate_parser.add_argument('--target', required=True,
+                                help='Backup from the target firmware (layout and defaults)')
+    migrate_parser.add_argument('-o', '--output', required=True, help='Output backup file')
+    
     args = parser.parse_args()
     
     if args.command == 'export':
@@ -317,6 +639,23 @@ Examples:
         if not import_config(port, args.input):
             sys.exit(1)
         
+    elif args.command in ('backup', 'restore'):
+        port = args.port or select_port(auto_select=True)
+        if port is None:
+            print("No port selected. Exiting.", file=sys.stderr)
+            sys.exit(1)
+        
+        if args.command == 'backup':
+            ok = backup_config(port, args.output)
+        else:
+            ok = restore_config(port, args.input)
+        if not ok:
+            sys.exit(1)
+        
+    elif args.command == 'migrate':
+        if not migrate_backup(args.input, args.target, args.output):
+            sys.exit(1)
+        
     elif args.command == 'validate':
         if not validate_config(args.input):
             sys.exit(1)
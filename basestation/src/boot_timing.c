@@ -0,0 +1,82 @@
+/*
+ * Boot Timing Implementation
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "boot_timing.h"
+#include <string.h>
+
+static const char *const milestone_names[BOOT_MS_COUNT] = {
+	[BOOT_MS_SCANNING] = "scanning",
+	[BOOT_MS_FIRST_MIDI] = "first MIDI",
+};
+
+void boot_timing_init(struct boot_timing *bt)
+{
+	if (bt) {
+		memset(bt, 0, sizeof(*bt));
+	}
+}
+
+int boot_timing_begin(struct boot_timing *bt, const char *name, uint32_t now_us)
+{
+	if (!bt || bt->count >= BOOT_TIMING_MAX_PHASES) {
+		return -1;
+	}
+
+	struct boot_phase *p = &bt->phases[bt->count];
+
+	p->name = name;
+	p->start_us = now_us;
+	p->end_us = now_us;
+	p->done = false;
+	return bt->count++;
+}
+
+void boot_timing_end(struct boot_timing *bt, int phase, uint32_t now_us)
+{
+	if (!bt || phase < 0 || phase >= bt->count || bt->phases[phase].done) {
+		return;
+	}
+
+	bt->phases[phase].end_us = now_us;
+	bt->phases[phase].done = true;
+}
+
+uint32_t boot_timing_duration(const struct boot_timing *bt, int phase)
+{
+	if (!bt || phase < 0 || phase >= bt->count || !bt->phases[phase].done) {
+		return 0;
+	}
+	return bt->phases[phase].end_us - bt->phases[phase].start_us;
+}
+
+bool boot_timing_milestone(struct boot_timing *bt, enum boot_milestone ms, uint32_t now_us)
+{
+	if (!bt || ms >= BOOT_MS_COUNT || bt->milestone_set[ms]) {
+		return false;
+	}
+
+	bt->milestone_us[ms] = now_us;
+	bt->milestone_set[ms] = true;
+	return true;
+}
+
+bool boot_timing_get_milestone(const struct boot_timing *bt, enum boot_milestone ms, uint32_t *us)
+{
+	if (!bt || ms >= BOOT_MS_COUNT || !bt->milestone_set[ms]) {
+		return false;
+	}
+
+	if (us) {
+		*us = bt->milestone_us[ms];
+	}
+	return true;
+}
+
+const char *boot_timing_milestone_name(enum boot_milestone ms)
+{
+	return (ms < BOOT_MS_COUNT) ? milestone_names[ms] : "?";
+}
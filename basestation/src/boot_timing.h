@@ -0,0 +1,120 @@
+/*
+ * Boot Timing
+ * Per-phase boot time and the two milestones that matter to a player
+ *
+ * main() wraps each init step in boot_timing_begin()/boot_timing_end().
+ * Phases may overlap: Bluetooth enable is started early and finishes in
+ * its ready callback while main() keeps initializing, so every phase keeps
+ * its own start time rather than a duration since the previous mark.
+ *
+ * Milestones are stamped once, the first time they are reached:
+ * - scanning:   BLE scanning started (a guitar can connect)
+ * - first MIDI: first message handed to the MIDI UART
+ *
+ * Times are microseconds of uptime. The record has no lock of its own:
+ * begin and end phases from one thread, and serialize milestones stamped
+ * from callbacks with the readers (main.c uses a spinlock).
+ *
+ * Pure logic with no hardware dependencies - can be tested on host.
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef BOOT_TIMING_H
+#define BOOT_TIMING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* ========================================
+ * CONSTANTS
+ * ======================================== */
+
+#define BOOT_TIMING_MAX_PHASES  12
+
+/**
+ * @brief Boot milestones
+ */
+enum boot_milestone {
+	BOOT_MS_SCANNING = 0,    /* BLE scanning started */
+	BOOT_MS_FIRST_MIDI,      /* First MIDI message queued to the UART */
+	BOOT_MS_COUNT
+};
+
+/* ========================================
+ * DATA STRUCTURES
+ * ======================================== */
+
+/**
+ * @brief One init phase
+ */
+struct boot_phase {
+	const char *name;          /* Static string */
+	uint32_t start_us;
+	uint32_t end_us;
+	bool done;
+};
+
+/**
+ * @brief Boot timing record
+ */
+struct boot_timing {
+	struct boot_phase phases[BOOT_TIMING_MAX_PHASES];
+	uint8_t count;
+	uint32_t milestone_us[BOOT_MS_COUNT];
+	bool milestone_set[BOOT_MS_COUNT];
+};
+
+/* ========================================
+ * API
+ * ======================================== */
+
+/**
+ * @brief Clear all phases and milestones
+ */
+void boot_timing_init(struct boot_timing *bt);
+
+/**
+ * @brief Start a phase
+ *
+ * @param bt Boot timing record
+ * @param name Phase name (must stay valid, e.g. a string literal)
+ * @param now_us Current uptime
+ * @return Phase index for boot_timing_end(), -1 if the table is full
+ */
+int boot_timing_begin(struct boot_timing *bt, const char *name, uint32_t now_us);
+
+/**
+ * @brief End a phase (ignored for -1 or a phase already ended)
+ */
+void boot_timing_end(struct boot_timing *bt, int phase, uint32_t now_us);
+
+/**
+ * @brief Phase duration in microseconds (0 while still running)
+ */
+uint32_t boot_timing_duration(const struct boot_timing *bt, int phase);
+
+/**
+ * @brief Stamp a milestone; only the first call for each one counts
+ *
+ * @return true if this call set it
+ */
+bool boot_timing_milestone(struct boot_timing *bt, enum boot_milestone ms, uint32_t now_us);
+
+/**
+ * @brief Get a milestone time
+ *
+ * @param bt Boot timing record
+ * @param ms Milestone
+ * @param us Output: uptime when it was reached
+ * @return true if reached
+ */
+bool boot_timing_get_milestone(const struct boot_timing *bt, enum boot_milestone ms, uint32_t *us);
+
+/**
+ * @brief Milestone name for display
+ */
+const char *boot_timing_milestone_name(enum boot_milestone ms);
+
+#endif /* BOOT_TIMING_H */
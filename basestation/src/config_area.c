@@ -0,0 +1,279 @@
+/*
+ * Configuration Areas Implementation
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "config_area.h"
+#include "config_journal.h"
+#include <errno.h>
+#include <string.h>
+
+static uint32_t header_crc(const struct config_header *header)
+{
+	return config_journal_crc32((const uint8_t *)header, offsetof(struct config_header, crc32));
+}
+
+static bool verify_hash(const struct config_area_store *store, const void *data, size_t len,
+			const uint8_t *expected)
+{
+	uint8_t hash[CONFIG_HASH_SIZE];
+
+	return store->hash(data, len, hash) == 0 && memcmp(hash, expected, CONFIG_HASH_SIZE) == 0;
+}
+
+uint32_t config_area_journal_offset(uint32_t image_size)
+{
+	uint32_t end = sizeof(struct config_header) + image_size;
+
+	return (end + JOURNAL_ALIGN - 1) / JOURNAL_ALIGN * JOURNAL_ALIGN;
+}
+
+size_t config_area_journal_size(const struct config_area_store *store)
+{
+	return store->area_size - store->journal_start;
+}
+
+int config_area_init(struct config_area_store *store, const struct storage_backend *backend,
+		     uint32_t offset_a, uint32_t offset_b, uint32_t area_size,
+		     uint32_t image_size, uint32_t version, config_area_hash_fn hash,
+		     uint8_t *scratch, size_t scratch_size)
+{
+	if (!store || !backend || !hash || !scratch || backend->page_size == 0 ||
+	    area_size % backend->page_size || offset_a % backend->page_size ||
+	    offset_b % backend->page_size || image_size % JOURNAL_ALIGN) {
+		return -EINVAL;
+	}
+
+	uint32_t journal_start = config_area_journal_offset(image_size);
+	size_t min_record = config_journal_record_size(JOURNAL_RECORD_MAX_DATA);
+
+	if (journal_start + min_record > area_size || scratch_size < area_size - journal_start) {
+		return -EINVAL;
+	}
+
+	memset(store, 0, sizeof(*store));
+	store->backend = backend;
+	store->offset[0] = offset_a;
+	store->offset[1] = offset_b;
+	store->area_size = area_size;
+	store->image_size = image_size;
+	store->version = version;
+	store->journal_start = journal_start;
+	store->hash = hash;
+	store->scratch = scratch;
+	store->scratch_size = scratch_size;
+	store->journal_used = config_area_journal_size(store);
+	return 0;
+}
+
+int config_area_read_header(const struct config_area_store *store, uint8_t area,
+			    struct config_header *header)
+{
+	if (area >= CONFIG_AREA_COUNT) {
+		return -EINVAL;
+	}
+
+	int ret = storage_read(store->backend, store->offset[area], header, sizeof(*header));
+	if (ret != 0) {
+		return ret;
+	}
+
+	if (header->magic != CONFIG_MAGIC || header_crc(header) != header->crc32 ||
+	    header->data_size > store->area_size - sizeof(*header)) {
+		return -EINVAL;
+	}
+	return 0;
+}
+
+int config_area_select(const struct config_header headers[CONFIG_AREA_COUNT],
+		       const bool valid[CONFIG_AREA_COUNT], uint8_t order[CONFIG_AREA_COUNT])
+{
+	int n = 0;
+
+	if (valid[0] && (!valid[1] || headers[0].sequence > headers[1].sequence)) {
+		order[n++] = 0;
+		if (valid[1]) {
+			order[n++] = 1;
+		}
+	} else if (valid[1]) {
+		order[n++] = 1;
+		if (valid[0]) {
+			order[n++] = 0;
+		}
+	}
+	return n;
+}
+
+int config_area_read_image(const struct config_area_store *store, uint8_t area,
+			   const struct config_header *header, void *data, bool verify)
+{
+	if (area >= CONFIG_AREA_COUNT) {
+		return -EINVAL;
+	}
+
+	int ret = storage_read(store->backend, store->offset[area] + sizeof(*header), data,
+			       header->data_size);
+	if (ret != 0) {
+		return ret;
+	}
+
+	if (verify && !verify_hash(store, data, header->data_size, header->hash)) {
+		return -EINVAL;
+	}
+	return 0;
+}
+
+int config_area_replay(const struct config_area_store *store, uint8_t area,
+		       uint8_t *image, size_t *used)
+{
+	size_t len = config_area_journal_size(store);
+
+	if (area >= CONFIG_AREA_COUNT) {
+		return -EINVAL;
+	}
+
+	int ret = storage_read(store->backend, store->offset[area] + store->journal_start,
+			       store->scratch, len);
+	if (ret != 0) {
+		return ret;
+	}
+	return config_journal_replay(image, store->image_size, store->scratch, len, used);
+}
+
+int config_area_load(struct config_area_store *store, uint8_t area,
+		     const struct config_header *header, void *data, bool verify)
+{
+	size_t used;
+
+	if (header->data_size != store->image_size) {
+		return -EINVAL;
+	}
+
+	int ret = config_area_read_image(store, area, header, data, verify);
+	if (ret != 0) {
+		return ret;
+	}
+
+	int records = config_area_replay(store, area, data, &used);
+	if (records < 0) {
+		return records;
+	}
+
+	store->active = area;
+	store->sequence = header->sequence;
+	store->journal_used = used;
+	store->journal_records = 0;
+	return records;
+}
+
+int config_area_write(const struct config_area_store *store, uint8_t area,
+		      const void *data, uint32_t sequence)
+{
+	if (area >= CONFIG_AREA_COUNT) {
+		return -EINVAL;
+	}
+
+	struct config_header header = {
+		.magic = CONFIG_MAGIC,
+		.version = store->version,
+		.sequence = sequence,
+		.data_size = store->image_size,
+	};
+	uint32_t offset = store->offset[area];
+
+	int ret = store->hash(data, store->image_size, header.hash);
+	if (ret != 0) {
+		return ret;
+	}
+	header.crc32 = header_crc(&header);
+
+	ret = storage_erase(store->backend, offset, store->area_size);
+	if (ret != 0) {
+		return ret;
+	}
+
+	ret = storage_write(store->backend, offset + sizeof(header), data, store->image_size);
+	if (ret != 0) {
+		return ret;
+	}
+
+	/* Header last: it marks the image complete */
+	return storage_write(store->backend, offset, &header, sizeof(header));
+}
+
+int config_area_compact(struct config_area_store *store, const void *data)
+{
+	uint8_t next = (uint8_t)(1 - store->active);
+
+	int ret = config_area_write(store, next, data, store->sequence + 1);
+	if (ret != 0) {
+		return ret;
+	}
+
+	store->active = next;
+	store->sequence++;
+	store->journal_used = 0;
+	store->journal_records = 0;
+	return 0;
+}
+
+int config_area_append(struct config_area_store *store, const void *old_data,
+		       const void *new_data)
+{
+	size_t space = config_area_journal_size(store) - store->journal_used;
+
+	if (space > CONFIG_AREA_APPEND_MAX) {
+		space = CONFIG_AREA_APPEND_MAX;
+	}
+
+	int len = config_journal_diff(old_data, new_data, store->image_size, store->scratch, space);
+	if (len < 0) {
+		return -ENOSPC;
+	}
+	if (len == 0) {
+		return 0;
+	}
+
+	uint32_t offset = store->offset[store->active] + store->journal_start + store->journal_used;
+	if (storage_write(store->backend, offset, store->scratch, len) != 0) {
+		/* Partly written records fail their CRC on replay; start afresh */
+		config_area_force_compact(store);
+		return -ENOSPC;
+	}
+
+	store->journal_used += len;
+	store->journal_records++;
+	return 0;
+}
+
+int config_area_save(struct config_area_store *store, const void *old_data,
+		     const void *new_data)
+{
+	/* Usual case: a few changed fields appended to the journal */
+	if (config_area_append(store, old_data, new_data) == 0) {
+		return 0;
+	}
+
+	/* Journal full or change too large: compact into the other area */
+	return config_area_compact(store, new_data);
+}
+
+void config_area_force_compact(struct config_area_store *store)
+{
+	store->journal_used = config_area_journal_size(store);
+}
+
+int config_area_erase_all(struct config_area_store *store)
+{
+	int ret = 0;
+
+	for (uint8_t a = 0; a < CONFIG_AREA_COUNT && ret == 0; a++) {
+		ret = storage_erase(store->backend, store->offset[a], store->area_size);
+	}
+
+	config_area_force_compact(store);
+	store->journal_records = 0;
+	return ret;
+}
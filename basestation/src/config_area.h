@@ -0,0 +1,222 @@
+/*
+ * Configuration Areas
+ * Ping-pong image + journal format on a storage backend
+ *
+ * Two flash areas of one erase page each. An area holds a header, the
+ * config_data image and, in the erased rest of the page, the change
+ * journal (config_journal.h):
+ *
+ *   | header (52) | image | pad to 4 | journal records ... | 0xFF ... |
+ *
+ * - A save appends the changed bytes to the active area's journal
+ * - When they do not fit, the full image is written to the other area
+ *   with the next sequence number (compaction): erase, image, header last
+ * - A header with a good magic and CRC therefore marks a complete image,
+ *   and boot picks the valid header with the highest sequence
+ *
+ * The image hash is computed by a caller-supplied function (SHA-256 on
+ * the target). config_storage.c adds versions, migration, locking and
+ * logging on top; the host tests run the same code on flash_sim.h.
+ *
+ * Pure logic with no hardware dependencies - can be tested on host.
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CONFIG_AREA_H
+#define CONFIG_AREA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "storage_backend.h"
+
+/* ========================================
+ * CONSTANTS
+ * ======================================== */
+
+#define CONFIG_MAGIC          0x47544143  /* "GTAC" */
+#define CONFIG_HASH_SIZE      32          /* SHA256 hash size */
+#define CONFIG_AREA_COUNT     2
+#define CONFIG_AREA_APPEND_MAX 512        /* Larger changes compact instead */
+
+/* ========================================
+ * DATA STRUCTURES
+ * ======================================== */
+
+/**
+ * @brief Configuration header structure
+ *
+ * Stored at the beginning of each configuration area to track version,
+ * sequence number, and hash for validation.
+ */
+struct config_header {
+	uint32_t magic;           /* Magic number: 0x47544143 ("GTAC") */
+	uint32_t version;         /* Configuration structure version */
+	uint32_t sequence;        /* Sequence number for ping-pong selection */
+	uint32_t data_size;       /* Size of configuration data */
+	uint8_t  hash[CONFIG_HASH_SIZE]; /* SHA256 hash of data */
+	uint32_t crc32;           /* CRC32 of header (excluding this field) */
+} __attribute__((packed));
+
+/**
+ * @brief Image hash function
+ *
+ * @return 0 on success, negative errno on failure
+ */
+typedef int (*config_area_hash_fn)(const void *data, size_t len, uint8_t hash[CONFIG_HASH_SIZE]);
+
+/**
+ * @brief Both areas and which one is active
+ */
+struct config_area_store {
+	const struct storage_backend *backend;
+	uint32_t offset[CONFIG_AREA_COUNT];  /* Flash address of each area */
+	uint32_t area_size;                  /* One erase page */
+	uint32_t image_size;                 /* Image written by this firmware */
+	uint32_t version;                    /* Version written by this firmware */
+	uint32_t journal_start;              /* Journal offset within an area */
+	config_area_hash_fn hash;
+	uint8_t *scratch;                    /* Journal reads and deltas */
+	size_t scratch_size;
+
+	/* Active area */
+	uint8_t active;
+	uint32_t sequence;
+	size_t journal_used;                 /* Bytes of journal in the active area */
+	uint32_t journal_records;            /* Saves appended since the last compaction */
+};
+
+/* ========================================
+ * API
+ * ======================================== */
+
+/**
+ * @brief Set up the areas (nothing is read or written)
+ *
+ * Area 0 becomes active with sequence 0 and a full journal, so the first
+ * save writes a full image.
+ *
+ * @param scratch Buffer of at least config_area_journal_size() bytes
+ * @return 0 on success, -EINVAL if the image leaves no room for a journal
+ *         record, offsets are not page aligned or scratch is too small
+ */
+int config_area_init(struct config_area_store *store, const struct storage_backend *backend,
+		     uint32_t offset_a, uint32_t offset_b, uint32_t area_size,
+		     uint32_t image_size, uint32_t version, config_area_hash_fn hash,
+		     uint8_t *scratch, size_t scratch_size);
+
+/**
+ * @brief Journal offset within an area for an image of image_size bytes
+ */
+uint32_t config_area_journal_offset(uint32_t image_size);
+
+/**
+ * @brief Journal bytes in an area (for the current image size)
+ */
+size_t config_area_journal_size(const struct config_area_store *store);
+
+/**
+ * @brief Read and check an area header (magic, CRC, size) without the data
+ *
+ * The version is not checked; that is the caller's policy.
+ *
+ * @return 0 if valid, -EINVAL if not, backend error if unreadable
+ */
+int config_area_read_header(const struct config_area_store *store, uint8_t area,
+			    struct config_header *header);
+
+/**
+ * @brief Order the areas with valid headers, newest sequence first
+ *
+ * @param headers Header of each area
+ * @param valid Whether each header is valid
+ * @param order Output: area indexes to try
+ * @return Number of areas in order (0-2)
+ */
+int config_area_select(const struct config_header headers[CONFIG_AREA_COUNT],
+		       const bool valid[CONFIG_AREA_COUNT], uint8_t order[CONFIG_AREA_COUNT]);
+
+/**
+ * @brief Read an area's image (any size) and optionally check its hash
+ *
+ * @param header Valid header of the area
+ * @param data Output: header->data_size bytes
+ * @return 0, -EINVAL on a hash mismatch, backend error
+ */
+int config_area_read_image(const struct config_area_store *store, uint8_t area,
+			   const struct config_header *header, void *data, bool verify);
+
+/**
+ * @brief Replay an area's journal onto its image (current layout)
+ *
+ * @param image Image of image_size bytes, updated in place
+ * @param used Output: journal bytes in use (the whole journal if a torn or
+ *             corrupt record ended it, so the next save compacts)
+ * @return Records applied, or negative errno
+ */
+int config_area_replay(const struct config_area_store *store, uint8_t area,
+		       uint8_t *image, size_t *used);
+
+/**
+ * @brief Load an area in the current layout and make it active
+ *
+ * Reads the image, checks its hash if verify, replays the journal.
+ *
+ * @param header Valid header of the area, with data_size == image_size
+ * @param data Output: image_size bytes
+ * @return Journal records applied, or negative errno (store unchanged)
+ */
+int config_area_load(struct config_area_store *store, uint8_t area,
+		     const struct config_header *header, void *data, bool verify);
+
+/**
+ * @brief Erase an area and write an image and its header (header last)
+ *
+ * Does not change the active area.
+ */
+int config_area_write(const struct config_area_store *store, uint8_t area,
+		      const void *data, uint32_t sequence);
+
+/**
+ * @brief Write a full image to the other area and make it active
+ */
+int config_area_compact(struct config_area_store *store, const void *data);
+
+/**
+ * @brief Append the changes from old_data to new_data to the active journal
+ *
+ * @return 0 on success (or no change), -ENOSPC if the journal cannot take
+ *         them; a failed write also returns -ENOSPC and marks the journal
+ *         full, since the partly written record ends it
+ */
+int config_area_append(struct config_area_store *store, const void *old_data,
+		       const void *new_data);
+
+/**
+ * @brief Save: append to the journal, compact when it is full
+ *
+ * @param old_data Image currently stored (image + journal)
+ * @param new_data Image to store
+ * @return 0 on success, negative errno (store unchanged)
+ */
+int config_area_save(struct config_area_store *store, const void *old_data,
+		     const void *new_data);
+
+/**
+ * @brief Make the next save compact instead of appending
+ */
+void config_area_force_compact(struct config_area_store *store);
+
+/**
+ * @brief Erase both areas
+ *
+ * Nothing is left to append a journal record to, so the next save writes
+ * a full image and header whatever the result.
+ *
+ * @return 0, or the first backend error
+ */
+int config_area_erase_all(struct config_area_store *store);
+
+#endif /* CONFIG_AREA_H */
@@ -0,0 +1,167 @@
+/*
+ * Configuration Journal Implementation
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "config_journal.h"
+#include <errno.h>
+#include <stdbool.h>
+#include <string.h>
+
+#define RECORD_HEADER_SIZE  sizeof(struct config_journal_record)
+
+static size_t data_len(const struct config_journal_record *rec)
+{
+	return rec->len & ~JOURNAL_LEN_MORE;
+}
+
+/* CRC of the record's offset, len (flag included) and data */
+static uint32_t record_crc(const struct config_journal_record *rec, const uint8_t *data)
+{
+	uint8_t buf[offsetof(struct config_journal_record, crc32) + JOURNAL_RECORD_MAX_DATA];
+
+	memcpy(buf, rec, offsetof(struct config_journal_record, crc32));
+	memcpy(&buf[offsetof(struct config_journal_record, crc32)], data, data_len(rec));
+	return config_journal_crc32(buf, offsetof(struct config_journal_record, crc32) +
+				    data_len(rec));
+}
+
+/* Whether the record at pos is complete and fits the image */
+static bool record_valid(const struct config_journal_record *rec, const uint8_t *journal,
+			 size_t pos, size_t journal_len, size_t size)
+{
+	size_t len = data_len(rec);
+
+	return len > 0 && len <= JOURNAL_RECORD_MAX_DATA && (size_t)rec->offset + len <= size &&
+	       pos + config_journal_record_size(len) <= journal_len &&
+	       record_crc(rec, &journal[pos + RECORD_HEADER_SIZE]) == rec->crc32;
+}
+
+uint32_t config_journal_crc32(const uint8_t *data, size_t len)
+{
+	uint32_t crc = 0xFFFFFFFF;
+
+	for (size_t i = 0; i < len; i++) {
+		crc ^= data[i];
+		for (int b = 0; b < 8; b++) {
+			crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : crc >> 1;
+		}
+	}
+	return ~crc;
+}
+
+size_t config_journal_record_size(size_t len)
+{
+	return RECORD_HEADER_SIZE + (len + JOURNAL_ALIGN - 1) / JOURNAL_ALIGN * JOURNAL_ALIGN;
+}
+
+int config_journal_diff(const uint8_t *old_image, const uint8_t *new_image, size_t size,
+                        uint8_t *out, size_t out_size)
+{
+	size_t pos = 0;
+	size_t last_rec = 0;
+	size_t i = 0;
+
+	if (!old_image || !new_image || !out || size > JOURNAL_ERASED) {
+		return -EINVAL;
+	}
+
+	while (i < size) {
+		if (old_image[i] == new_image[i]) {
+			i++;
+			continue;
+		}
+
+		/* Extend the run over short unchanged gaps, up to one record */
+		size_t last = i;
+		for (size_t j = i + 1; j < size && j - last < JOURNAL_MERGE_GAP &&
+		     j - i < JOURNAL_RECORD_MAX_DATA; j++) {
+			if (old_image[j] != new_image[j]) {
+				last = j;
+			}
+		}
+
+		struct config_journal_record rec = {
+			.offset = (uint16_t)i,
+			.len = (uint16_t)(last - i + 1) | JOURNAL_LEN_MORE,
+		};
+		size_t rec_size = config_journal_record_size(data_len(&rec));
+
+		if (pos + rec_size > out_size) {
+			return -ENOSPC;
+		}
+
+		rec.crc32 = record_crc(&rec, &new_image[i]);
+		memset(&out[pos], JOURNAL_ERASED_BYTE, rec_size);
+		memcpy(&out[pos], &rec, RECORD_HEADER_SIZE);
+		memcpy(&out[pos + RECORD_HEADER_SIZE], &new_image[i], data_len(&rec));
+		last_rec = pos;
+		pos += rec_size;
+		i = last + 1;
+	}
+
+	if (pos > 0) {
+		/* The last record ends the save */
+		struct config_journal_record rec;
+
+		memcpy(&rec, &out[last_rec], RECORD_HEADER_SIZE);
+		rec.len &= ~JOURNAL_LEN_MORE;
+		rec.crc32 = record_crc(&rec, &out[last_rec + RECORD_HEADER_SIZE]);
+		memcpy(&out[last_rec], &rec, RECORD_HEADER_SIZE);
+	}
+	return (int)pos;
+}
+
+int config_journal_replay(uint8_t *image, size_t size, const uint8_t *journal,
+                          size_t journal_len, size_t *used)
+{
+	size_t pos = 0;
+	int applied = 0;
+
+	if (!image || !journal) {
+		return -EINVAL;
+	}
+
+	while (pos + RECORD_HEADER_SIZE <= journal_len) {
+		struct config_journal_record rec;
+		size_t end = pos;
+		bool complete = false;
+
+		memcpy(&rec, &journal[pos], RECORD_HEADER_SIZE);
+		if (rec.offset == JOURNAL_ERASED && rec.len == JOURNAL_ERASED) {
+			break;  /* End of journal */
+		}
+
+		/* Find the end of this save before applying any of it */
+		while (end + RECORD_HEADER_SIZE <= journal_len) {
+			memcpy(&rec, &journal[end], RECORD_HEADER_SIZE);
+			if (!record_valid(&rec, journal, end, journal_len, size)) {
+				break;
+			}
+			end += config_journal_record_size(data_len(&rec));
+			if (!(rec.len & JOURNAL_LEN_MORE)) {
+				complete = true;
+				break;
+			}
+		}
+		if (!complete) {
+			/* Torn, corrupt or cut short: ignore the rest, compact on the next save */
+			pos = journal_len;
+			break;
+		}
+
+		while (pos < end) {
+			memcpy(&rec, &journal[pos], RECORD_HEADER_SIZE);
+			memcpy(&image[rec.offset], &journal[pos + RECORD_HEADER_SIZE], data_len(&rec));
+			pos += config_journal_record_size(data_len(&rec));
+			applied++;
+		}
+	}
+
+	if (used) {
+		*used = (pos > journal_len) ? journal_len : pos;
+	}
+	return applied;
+}
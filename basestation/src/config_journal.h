@@ -0,0 +1,115 @@
+/*
+ * Configuration Journal
+ * Append-only delta records on top of a stored configuration image
+ *
+ * A settings change rewrites only the bytes that changed: each changed run
+ * of config_data becomes one record (offset, length, data, CRC-32) appended
+ * to the erased space after the image in the active flash area. The
+ * current configuration is the image with the records replayed in order.
+ * Only when the journal is full is a fresh image written (compaction into
+ * the other ping-pong area), so most saves cost a few word writes instead
+ * of a page erase.
+ *
+ * Records are padded to JOURNAL_ALIGN bytes (the flash write block) with
+ * the erased value, so an unwritten header reads as JOURNAL_ERASED and
+ * ends the journal. A record whose CRC does not match (power lost during
+ * the write) ends it too, and everything after it is ignored.
+ *
+ * A save that changes several runs writes several records; all but the
+ * last carry JOURNAL_LEN_MORE, and replay applies a save's records only
+ * once its last record is there, so power loss between them cannot leave
+ * half a save applied. Records without the flag (journals written before
+ * it existed) are single-record saves.
+ *
+ * Pure logic with no hardware dependencies - can be tested on host.
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CONFIG_JOURNAL_H
+#define CONFIG_JOURNAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* ========================================
+ * CONSTANTS
+ * ======================================== */
+
+#define JOURNAL_ALIGN            4       /* Flash write block size */
+#define JOURNAL_ERASED_BYTE      0xFF    /* Flash erase value */
+#define JOURNAL_ERASED           0xFFFF  /* Offset and length of an unwritten record */
+#define JOURNAL_RECORD_MAX_DATA  64      /* Data bytes per record */
+#define JOURNAL_MERGE_GAP        8       /* Changed runs closer than this share a record */
+#define JOURNAL_LEN_MORE         0x8000  /* In len: more records of this save follow */
+
+/* ========================================
+ * DATA STRUCTURES
+ * ======================================== */
+
+/**
+ * @brief Record header, followed by len data bytes padded to JOURNAL_ALIGN
+ */
+struct config_journal_record {
+	uint16_t offset;        /* Byte offset in the image */
+	uint16_t len;           /* Data bytes (1 to JOURNAL_RECORD_MAX_DATA) | JOURNAL_LEN_MORE */
+	uint32_t crc32;         /* CRC-32 of offset, len and data */
+} __attribute__((packed));
+
+/* ========================================
+ * API
+ * ======================================== */
+
+/**
+ * @brief CRC-32 (IEEE 802.3, same as Zephyr's crc32_ieee())
+ *
+ * @param data Data bytes
+ * @param len Number of bytes
+ * @return CRC-32
+ */
+uint32_t config_journal_crc32(const uint8_t *data, size_t len);
+
+/**
+ * @brief Size of a record in the journal, header and padding included
+ *
+ * @param len Data bytes
+ * @return Bytes
+ */
+size_t config_journal_record_size(size_t len);
+
+/**
+ * @brief Encode the changes between two images as records
+ *
+ * @param old_image Image the journal currently replays to
+ * @param new_image Image to save
+ * @param size Image size (at most 65535 bytes)
+ * @param out Output: records, ready to append
+ * @param out_size Space left in the journal
+ * @return Bytes of records (0 if the images are equal),
+ *         -ENOSPC if they do not fit, -EINVAL on bad arguments
+ */
+int config_journal_diff(const uint8_t *old_image, const uint8_t *new_image, size_t size,
+                        uint8_t *out, size_t out_size);
+
+/**
+ * @brief Apply a journal to an image
+ *
+ * Stops at the first unwritten record, or at the first that is invalid
+ * (bad CRC, outside the image, cut off by the end of the journal). After
+ * an invalid record the rest of the journal may be partly written, so
+ * *used reports it as full and the next save compacts. The records of a
+ * save whose last record is missing are not applied, and the journal is
+ * reported full as well.
+ *
+ * @param image Image to update in place
+ * @param size Image size
+ * @param journal Journal as read from flash
+ * @param journal_len Journal size
+ * @param used Output: bytes in use, the next record goes here (may be NULL)
+ * @return Number of records applied, -EINVAL on bad arguments
+ */
+int config_journal_replay(uint8_t *image, size_t size, const uint8_t *journal,
+                          size_t journal_len, size_t *used);
+
+#endif /* CONFIG_JOURNAL_H */
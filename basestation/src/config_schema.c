@@ -0,0 +1,212 @@
+/*
+ * Configuration Schema Implementation
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "config_schema.h"
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+static const char *const kind_names[CONFIG_FIELD_KIND_COUNT] = {
+	[CONFIG_FIELD_BYTES] = "bytes",
+	[CONFIG_FIELD_UINT] = "uint",
+	[CONFIG_FIELD_INT] = "int",
+};
+
+static bool is_int_kind(uint8_t kind)
+{
+	return kind == CONFIG_FIELD_UINT || kind == CONFIG_FIELD_INT;
+}
+
+static int64_t read_int(const uint8_t *p, uint16_t size, bool is_signed)
+{
+	uint32_t u = 0;
+
+	for (int i = size - 1; i >= 0; i--) {
+		u = (u << 8) | p[i];
+	}
+	if (is_signed && size < 4 && (u & (1u << (size * 8 - 1)))) {
+		u |= ~0u << (size * 8);
+	}
+	return is_signed ? (int64_t)(int32_t)u : (int64_t)u;
+}
+
+static void write_int(uint8_t *p, uint16_t size, bool is_signed, int64_t v)
+{
+	int64_t min = is_signed ? -((int64_t)1 << (size * 8 - 1)) : 0;
+	int64_t max = is_signed ? ((int64_t)1 << (size * 8 - 1)) - 1 : ((int64_t)1 << (size * 8)) - 1;
+
+	if (v < min) {
+		v = min;
+	} else if (v > max) {
+		v = max;
+	}
+
+	uint32_t u = (uint32_t)v;
+	for (int i = 0; i < size; i++) {
+		p[i] = (uint8_t)(u >> (8 * i));
+	}
+}
+
+static void copy_field(const struct config_field *from, const uint8_t *src,
+		       const struct config_field *to, uint8_t *dst)
+{
+	uint16_t count = (from->count < to->count) ? from->count : to->count;
+	bool ints = is_int_kind(from->kind) && is_int_kind(to->kind);
+
+	for (uint16_t i = 0; i < count; i++) {
+		const uint8_t *s = src + from->offset + (size_t)i * from->stride;
+		uint8_t *d = dst + to->offset + (size_t)i * to->stride;
+
+		if (ints) {
+			write_int(d, to->size, to->kind == CONFIG_FIELD_INT,
+				  read_int(s, from->size, from->kind == CONFIG_FIELD_INT));
+		} else {
+			memcpy(d, s, (from->size < to->size) ? from->size : to->size);
+		}
+	}
+}
+
+const struct config_schema *config_schema_find(const struct config_schema *schemas, size_t n,
+					       uint32_t version)
+{
+	for (size_t i = 0; schemas && i < n; i++) {
+		if (schemas[i].version == version) {
+			return &schemas[i];
+		}
+	}
+	return NULL;
+}
+
+const struct config_field *config_schema_field(const struct config_schema *schema,
+					       const char *name)
+{
+	if (!schema || !name) {
+		return NULL;
+	}
+
+	for (uint16_t i = 0; i < schema->field_count; i++) {
+		if (strcmp(schema->fields[i].name, name) == 0) {
+			return &schema->fields[i];
+		}
+	}
+	return NULL;
+}
+
+int config_schema_check(const struct config_schema *schema)
+{
+	if (!schema || (schema->field_count > 0 && !schema->fields)) {
+		return -EINVAL;
+	}
+
+	for (uint16_t i = 0; i < schema->field_count; i++) {
+		const struct config_field *f = &schema->fields[i];
+
+		if (!f->name || f->name[0] == '\0' || strlen(f->name) >= CONFIG_SCHEMA_NAME_MAX ||
+		    strchr(f->name, ' ') || f->kind >= CONFIG_FIELD_KIND_COUNT ||
+		    f->size == 0 || f->count == 0) {
+			return -EINVAL;
+		}
+		if (is_int_kind(f->kind) && f->size != 1 && f->size != 2 && f->size != 4) {
+			return -EINVAL;
+		}
+		if (f->count > 1 && f->stride < f->size) {
+			return -EINVAL;
+		}
+		if ((uint32_t)f->offset + (uint32_t)(f->count - 1) * f->stride + f->size > schema->size) {
+			return -EINVAL;
+		}
+		for (uint16_t j = 0; j < i; j++) {
+			if (strcmp(schema->fields[j].name, f->name) == 0) {
+				return -EINVAL;
+			}
+		}
+	}
+	return 0;
+}
+
+int config_schema_check_registry(const struct config_schema *schemas, size_t n)
+{
+	if (!schemas || n == 0) {
+		return -EINVAL;
+	}
+
+	for (size_t i = 0; i < n; i++) {
+		if (config_schema_check(&schemas[i]) != 0) {
+			return -EINVAL;
+		}
+		if (i > 0 && schemas[i].version <= schemas[i - 1].version) {
+			return -EINVAL;
+		}
+	}
+	return 0;
+}
+
+int config_schema_copy_fields(const struct config_schema *from, const uint8_t *src,
+			      const struct config_schema *to, uint8_t *dst)
+{
+	int copied = 0;
+
+	for (uint16_t i = 0; i < to->field_count; i++) {
+		const struct config_field *t = &to->fields[i];
+		const struct config_field *f = config_schema_field(from, t->name);
+
+		if (f) {
+			copy_field(f, src, t, dst);
+			copied++;
+		}
+	}
+	return copied;
+}
+
+int config_schema_migrate(const struct config_schema *schemas, size_t n, uint32_t version,
+			  const uint8_t *src, size_t src_size, uint8_t *dst, size_t dst_size)
+{
+	if (!schemas || n == 0 || !src || !dst) {
+		return -EINVAL;
+	}
+
+	const struct config_schema *target = &schemas[n - 1];
+	const struct config_schema *from = config_schema_find(schemas, n, version);
+
+	if (version > target->version) {
+		return -ENOTSUP;
+	}
+	if (!from) {
+		return -ENOENT;
+	}
+	if (src_size != from->size || dst_size != target->size) {
+		return -EINVAL;
+	}
+
+	if (from == target) {
+		memcpy(dst, src, dst_size);
+		return 0;
+	}
+
+	config_schema_copy_fields(from, src, target, dst);
+
+	for (const struct config_schema *s = from + 1; s <= target; s++) {
+		if (s->upgrade) {
+			s->upgrade(dst, target, src, from);
+		}
+	}
+	return 0;
+}
+
+int config_schema_format_field(const struct config_field *field, char *buf, size_t len)
+{
+	int n = snprintf(buf, len, "CFGFIELD %s %s %u %u %u %u", field->name,
+			 config_schema_kind_name(field->kind), field->offset, field->size,
+			 field->count, field->stride);
+
+	return (n < 0 || (size_t)n >= len) ? -1 : n;
+}
+
+const char *config_schema_kind_name(uint8_t kind)
+{
+	return (kind < CONFIG_FIELD_KIND_COUNT) ? kind_names[kind] : "?";
+}
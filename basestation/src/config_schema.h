@@ -0,0 +1,179 @@
+/*
+ * Configuration Schema
+ * Field descriptors per config_data version and forward migration
+ *
+ * Every config_data layout that ever shipped is described by a schema: its
+ * version, its size and a table of named fields. A field is a scalar, a
+ * byte blob, or either of them repeated count times every stride bytes
+ * (e.g. one field of every patch). Reserved bytes are simply not listed.
+ *
+ * Migrating an image from an older version to the newest one:
+ * 1. The destination starts as the defaults of the newest layout.
+ * 2. Each destination field is copied from the source field with the same
+ *    name, if there is one:
+ *    - integers are sign- or zero-extended and clamped to the new width
+ *    - blobs copy the common leading bytes (so a blob that is an array of
+ *      unchanged elements keeps its first min(old, new) elements)
+ *    - repeated fields copy the first min(old, new) repetitions
+ * 3. Each newer schema's upgrade hook then runs in version order, with the
+ *    source image, for changes a copy by name cannot express (a renamed
+ *    field, or one that changed meaning or units).
+ *
+ * Fields that exist only in the new layout keep their defaults; fields
+ * that were dropped are ignored. config_tool.py applies the same rules to
+ * backups, using the schemas printed by 'config schema'.
+ *
+ * Pure logic with no hardware dependencies - can be tested on host.
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CONFIG_SCHEMA_H
+#define CONFIG_SCHEMA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* ========================================
+ * CONSTANTS
+ * ======================================== */
+
+#define CONFIG_SCHEMA_NAME_MAX   32     /* Field name length, including NUL */
+#define CONFIG_SCHEMA_LINE_MAX   80     /* config_schema_format_field() output */
+
+/**
+ * @brief How a field's bytes are interpreted when its width changes
+ */
+enum config_field_kind {
+	CONFIG_FIELD_BYTES = 0,   /* Opaque: copy the common leading bytes */
+	CONFIG_FIELD_UINT,        /* Little-endian unsigned, 1/2/4 bytes */
+	CONFIG_FIELD_INT,         /* Little-endian signed, 1/2/4 bytes */
+	CONFIG_FIELD_KIND_COUNT
+};
+
+/* ========================================
+ * DATA STRUCTURES
+ * ======================================== */
+
+/**
+ * @brief One field of a layout
+ */
+struct config_field {
+	const char *name;          /* Unique within the schema, e.g. "patch.led_mode" */
+	uint8_t kind;              /* enum config_field_kind */
+	uint16_t offset;           /* First repetition */
+	uint16_t size;             /* Bytes per repetition */
+	uint16_t count;            /* Repetitions (1 for a single field) */
+	uint16_t stride;           /* Bytes between repetitions */
+};
+
+struct config_schema;
+
+/**
+ * @brief Semantic fix-up after the field copy
+ *
+ * Hooks run on the final image, so they locate fields by name in schema
+ * rather than by the offsets of their own version.
+ *
+ * @param data Image in the newest layout, after the field copy
+ * @param schema Newest layout
+ * @param old Source image
+ * @param old_schema Layout of the source image
+ */
+typedef void (*config_schema_upgrade_fn)(uint8_t *data, const struct config_schema *schema,
+					 const uint8_t *old, const struct config_schema *old_schema);
+
+/**
+ * @brief Layout of one config_data version
+ */
+struct config_schema {
+	uint32_t version;
+	uint16_t size;                        /* sizeof(config_data) in this version */
+	const struct config_field *fields;
+	uint16_t field_count;
+	config_schema_upgrade_fn upgrade;     /* Run when migrating to this version, or NULL */
+};
+
+/* ========================================
+ * API
+ * ======================================== */
+
+/**
+ * @brief Find a version in a registry
+ *
+ * @param schemas Registry, oldest first
+ * @param n Number of schemas
+ * @param version Version to find
+ * @return Schema, or NULL if unknown
+ */
+const struct config_schema *config_schema_find(const struct config_schema *schemas, size_t n,
+					       uint32_t version);
+
+/**
+ * @brief Find a field by name
+ *
+ * @return Field, or NULL if the schema has none by that name
+ */
+const struct config_field *config_schema_field(const struct config_schema *schema,
+					       const char *name);
+
+/**
+ * @brief Check a schema: fields inside the image, valid kinds and widths,
+ *        repetitions not overlapping, names unique
+ *
+ * @return 0 if valid, -EINVAL otherwise
+ */
+int config_schema_check(const struct config_schema *schema);
+
+/**
+ * @brief Check a registry: every schema valid, versions strictly increasing
+ *
+ * @return 0 if valid, -EINVAL otherwise
+ */
+int config_schema_check_registry(const struct config_schema *schemas, size_t n);
+
+/**
+ * @brief Copy the fields two layouts share by name
+ *
+ * @param from Source layout
+ * @param src Source image (from->size bytes)
+ * @param to Destination layout
+ * @param dst Destination image (to->size bytes), fields not in from untouched
+ * @return Number of fields copied
+ */
+int config_schema_copy_fields(const struct config_schema *from, const uint8_t *src,
+			      const struct config_schema *to, uint8_t *dst);
+
+/**
+ * @brief Migrate an image to the newest version in the registry
+ *
+ * @param schemas Registry, oldest first; the last entry is the target
+ * @param n Number of schemas
+ * @param version Version of src
+ * @param src Source image
+ * @param src_size Size of src (must match its schema)
+ * @param dst Destination, filled with the newest layout's defaults
+ * @param dst_size Size of dst (must match the newest schema)
+ * @return 0 on success, -ENOENT for an unknown version, -ENOTSUP for a
+ *         version newer than the target, -EINVAL for a size mismatch
+ */
+int config_schema_migrate(const struct config_schema *schemas, size_t n, uint32_t version,
+			  const uint8_t *src, size_t src_size, uint8_t *dst, size_t dst_size);
+
+/**
+ * @brief Format a field as a line for 'config schema'
+ *
+ * "CFGFIELD <name> <kind> <offset> <size> <count> <stride>"
+ *
+ * @return Length written, or -1 if buf is too small
+ */
+int config_schema_format_field(const struct config_field *field, char *buf, size_t len);
+
+/**
+ * @brief Kind name ("bytes", "uint", "int")
+ */
+const char *config_schema_kind_name(uint8_t kind);
+
+#endif /* CONFIG_SCHEMA_H */
@@ -0,0 +1,115 @@
+/*
+ * Config Snapshots Implementation
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "config_snapshot.h"
+#include <errno.h>
+#include <string.h>
+
+static struct config_snapshot_slot *find_slot(const struct config_snapshot_pool *pool,
+					      const void *data)
+{
+	for (uint8_t i = 0; i < pool->count; i++) {
+		if (pool->slots[i].data == data) {
+			return (struct config_snapshot_slot *)&pool->slots[i];
+		}
+	}
+	return NULL;
+}
+
+int config_snapshot_init(struct config_snapshot_pool *pool, void *buffers, size_t size,
+			 uint8_t count)
+{
+	if (!pool || !buffers || size == 0 || count < 2 || count > CONFIG_SNAPSHOT_MAX_SLOTS) {
+		return -EINVAL;
+	}
+
+	memset(pool, 0, sizeof(*pool));
+	pool->count = count;
+	pool->size = size;
+	for (uint8_t i = 0; i < count; i++) {
+		atomic_init(&pool->slots[i].refs, 0);
+		pool->slots[i].data = (uint8_t *)buffers + i * size;
+	}
+	atomic_init(&pool->current, NULL);
+	return 0;
+}
+
+const void *config_snapshot_acquire(struct config_snapshot_pool *pool)
+{
+	while (1) {
+		struct config_snapshot_slot *slot = atomic_load(&pool->current);
+
+		if (!slot) {
+			return NULL;
+		}
+
+		atomic_fetch_add(&slot->refs, 1);
+
+		/* Still current: the writer cannot take it from under us now.
+		 * Otherwise a publish raced us and the slot may be refilled. */
+		if (atomic_load(&pool->current) == slot) {
+			return slot->data;
+		}
+		atomic_fetch_sub(&slot->refs, 1);
+	}
+}
+
+void config_snapshot_release(struct config_snapshot_pool *pool, const void *data)
+{
+	struct config_snapshot_slot *slot = find_slot(pool, data);
+
+	if (slot && atomic_load(&slot->refs) > 0) {
+		atomic_fetch_sub(&slot->refs, 1);
+	}
+}
+
+void *config_snapshot_prepare(struct config_snapshot_pool *pool)
+{
+	struct config_snapshot_slot *current = atomic_load(&pool->current);
+
+	for (uint8_t i = 0; i < pool->count; i++) {
+		struct config_snapshot_slot *slot = &pool->slots[i];
+
+		if (slot != current && atomic_load(&slot->refs) == 0) {
+			return slot->data;
+		}
+	}
+
+	pool->busy++;
+	return NULL;
+}
+
+void config_snapshot_publish(struct config_snapshot_pool *pool, void *data)
+{
+	struct config_snapshot_slot *slot = find_slot(pool, data);
+
+	if (!slot) {
+		return;
+	}
+
+	slot->generation = ++pool->generation;
+	atomic_store(&pool->current, slot);
+}
+
+uint32_t config_snapshot_generation(const struct config_snapshot_pool *pool, const void *data)
+{
+	const struct config_snapshot_slot *slot = find_slot(pool, data);
+
+	return slot ? slot->generation : 0;
+}
+
+uint8_t config_snapshot_in_use(const struct config_snapshot_pool *pool)
+{
+	uint8_t n = 0;
+
+	for (uint8_t i = 0; i < pool->count; i++) {
+		if (atomic_load(&pool->slots[i].refs) > 0) {
+			n++;
+		}
+	}
+	return n;
+}
@@ -0,0 +1,120 @@
+/*
+ * Config Snapshots
+ * Reference-counted read-only copies of the configuration
+ *
+ * A small pool of slots, each holding one complete configuration. One slot
+ * is published (current); readers take a reference to it and read it in
+ * place for as long as they need, without copying or locking. A save
+ * fills a free slot and publishes it in one pointer store, so readers see
+ * either the old or the new configuration, never a mix. A slot is reused
+ * only when no reader holds it any more (RCU-like: old versions live
+ * until their last reader releases them).
+ *
+ *   reader:  cfg = acquire()  ...read cfg...  release(cfg)
+ *   writer:  buf = prepare()  ...fill buf...  publish(buf)
+ *
+ * acquire() and release() are lock-free and may run in any thread.
+ * prepare() and publish() must be serialized by the caller (config_storage.c
+ * holds its storage lock).
+ *
+ * Pure logic with no hardware dependencies - can be tested on host.
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CONFIG_SNAPSHOT_H
+#define CONFIG_SNAPSHOT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdatomic.h>
+
+/* ========================================
+ * CONSTANTS
+ * ======================================== */
+
+#define CONFIG_SNAPSHOT_MAX_SLOTS 6
+
+/* ========================================
+ * DATA STRUCTURES
+ * ======================================== */
+
+struct config_snapshot_slot {
+	atomic_uint refs;           /* Readers holding this slot */
+	uint32_t generation;        /* Publish count when it was published */
+	uint8_t *data;
+};
+
+/**
+ * @brief Slot pool
+ */
+struct config_snapshot_pool {
+	struct config_snapshot_slot slots[CONFIG_SNAPSHOT_MAX_SLOTS];
+	uint8_t count;
+	size_t size;                /* Bytes per slot */
+	struct config_snapshot_slot *_Atomic current;
+	uint32_t generation;        /* Snapshots published so far */
+	uint32_t busy;              /* prepare() calls that found no free slot */
+};
+
+/* ========================================
+ * API
+ * ======================================== */
+
+/**
+ * @brief Set up a pool over caller-supplied slot buffers (nothing published)
+ *
+ * @param buffers count * size bytes
+ * @param size Bytes per snapshot
+ * @param count Slots, 2 to CONFIG_SNAPSHOT_MAX_SLOTS
+ * @return 0 on success, -EINVAL on bad arguments
+ */
+int config_snapshot_init(struct config_snapshot_pool *pool, void *buffers, size_t size,
+			 uint8_t count);
+
+/**
+ * @brief Take a reference to the current snapshot
+ *
+ * @return Snapshot data (valid until released), or NULL if none published
+ */
+const void *config_snapshot_acquire(struct config_snapshot_pool *pool);
+
+/**
+ * @brief Drop a reference taken by config_snapshot_acquire()
+ *
+ * NULL is ignored.
+ */
+void config_snapshot_release(struct config_snapshot_pool *pool, const void *data);
+
+/**
+ * @brief Get a free slot to fill with the next configuration
+ *
+ * The slot stays free until published; preparing again without
+ * publishing returns the same or another free slot.
+ *
+ * @return Buffer of size bytes, or NULL if readers hold every other slot
+ */
+void *config_snapshot_prepare(struct config_snapshot_pool *pool);
+
+/**
+ * @brief Make a prepared slot the current snapshot
+ *
+ * Readers holding the previous snapshot keep it until they release it.
+ *
+ * @param data Buffer returned by config_snapshot_prepare()
+ */
+void config_snapshot_publish(struct config_snapshot_pool *pool, void *data);
+
+/**
+ * @brief Generation of a snapshot (1 for the first published), 0 if unknown
+ */
+uint32_t config_snapshot_generation(const struct config_snapshot_pool *pool, const void *data);
+
+/**
+ * @brief Slots held by readers (the current slot counts only if held)
+ */
+uint8_t config_snapshot_in_use(const struct config_snapshot_pool *pool);
+
+#endif /* CONFIG_SNAPSHOT_H */
@@ -4,11 +4,16 @@
  */
 
 #include "config_storage.h"
+#include "config_area.h"
+#include "config_journal.h"
+#include "config_schema.h"
+#include "config_snapshot.h"
+#include "config_writer.h"
+#include "virtual_ports.h"
 #include <zephyr/kernel.h>
 #include <zephyr/device.h>
 #include <zephyr/drivers/flash.h>
 #include <zephyr/logging/log.h>
-#include <zephyr/sys/crc.h>
 #include <string.h>
 
 #if defined(CONFIG_MBEDTLS_SHA256_C)
@@ -17,9 +22,6 @@
 
 LOG_MODULE_REGISTER(config_storage, LOG_LEVEL_DBG);
 
-/* Magic number for configuration header */
-#define CONFIG_MAGIC 0x47544143  /* "GTAC" */
-
 /* Internal flash device (nRF5340 has 1MB internal flash) */
 #define FLASH_DEVICE DEVICE_DT_GET(DT_CHOSEN(zephyr_flash_controller))
 
@@ -39,11 +41,102 @@ LOG_MODULE_REGISTER(config_storage, LOG_LEVEL_DBG);
 /* Flash page size for nRF5340 internal flash */
 #define FLASH_PAGE_SIZE 4096
 
-/* Current configuration state */
-static struct config_data current_config;
-static enum config_area active_area = CONFIG_AREA_A;
-static uint32_t current_sequence = 0;
+/* Journal of setting changes: the erased rest of each area, after the image */
+#define JOURNAL_START       ROUND_UP(sizeof(struct config_header) + sizeof(struct config_data), \
+				     JOURNAL_ALIGN)
+#define JOURNAL_SIZE        (FLASH_PAGE_SIZE - JOURNAL_START)
+
+BUILD_ASSERT(JOURNAL_START + sizeof(struct config_journal_record) + JOURNAL_RECORD_MAX_DATA <=
+	     FLASH_PAGE_SIZE, "config_data leaves no room for the journal");
+/* Migration converts an old image held in store_scratch */
+BUILD_ASSERT(JOURNAL_SIZE >= sizeof(struct config_data), "store_scratch too small to migrate");
+
+/* SHA-256 check of the boot image, after the rest of boot has run */
+#define VERIFY_DELAY_MS     250
+
+/* Flash writer thread (SHA-256 and the journal diff run on its stack) */
+#define WRITER_STACK_SIZE   2048
+
+/* Snapshot slots: current, flash, main's pipeline and one reader or save
+ * in flight (the verify and writer scratch images use free slots too) */
+#define SNAPSHOT_SLOTS      4
+
+/*
+ * Schema registry: every config_data layout that shipped, oldest first.
+ * The last entry must describe the current struct config_data.
+ *
+ * Changing struct config_data:
+ * 1. Freeze the current table under its version with literal offsets
+ *    ('config schema' on the old firmware prints them), since the struct
+ *    will no longer have those offsets.
+ * 2. Bump CONFIG_VERSION and describe the new layout below.
+ * 3. Add an upgrade hook only for changes a copy by name cannot express.
+ * Stored configs then migrate at boot instead of resetting to defaults.
+ */
+#define CFG_FIELD(name, kind, member) \
+	{ name, kind, offsetof(struct config_data, member), \
+	  sizeof(((struct config_data *)0)->member), 1, 0 }
+#define CFG_ARRAY(name, kind, member, n) \
+	{ name, kind, offsetof(struct config_data, member[0]), \
+	  sizeof(((struct config_data *)0)->member[0]), n, \
+	  sizeof(((struct config_data *)0)->member[0]) }
+#define PATCH_FIELD(name, kind, member) \
+	{ name, kind, offsetof(struct config_data, patches[0].member), \
+	  sizeof(((struct config_data *)0)->patches[0].member), NUM_PATCHES, \
+	  sizeof(struct patch_config) }
+
+static const struct config_field config_v1_fields[] = {
+	CFG_FIELD("global.default_patch", CONFIG_FIELD_UINT, global.default_patch),
+	CFG_FIELD("global.midi_channel", CONFIG_FIELD_UINT, global.midi_channel),
+	CFG_FIELD("global.max_guitars", CONFIG_FIELD_UINT, global.max_guitars),
+	CFG_FIELD("global.scan_interval_ms", CONFIG_FIELD_UINT, global.scan_interval_ms),
+	CFG_FIELD("global.led_brightness", CONFIG_FIELD_UINT, global.led_brightness),
+	CFG_ARRAY("global.accel_scale", CONFIG_FIELD_INT, global.accel_scale, 6),
+	CFG_ARRAY("global.accel_offset", CONFIG_FIELD_INT, global.accel_offset, 6),
+	CFG_FIELD("global.running_average_enable", CONFIG_FIELD_UINT, global.running_average_enable),
+	CFG_FIELD("global.running_average_depth", CONFIG_FIELD_UINT, global.running_average_depth),
+	PATCH_FIELD("patch.led_mode", CONFIG_FIELD_UINT, led_mode),
+	PATCH_FIELD("patch.midi_deadzone", CONFIG_FIELD_INT, midi_deadzone),
+	PATCH_FIELD("patch.patch_name", CONFIG_FIELD_BYTES, patch_name),
+	PATCH_FIELD("patch.topologies", CONFIG_FIELD_BYTES, topologies),
+	PATCH_FIELD("patch.functions", CONFIG_FIELD_BYTES, functions),
+	PATCH_FIELD("patch.default_mixer_type", CONFIG_FIELD_UINT, default_mixer_type),
+	PATCH_FIELD("patch.gestures", CONFIG_FIELD_BYTES, gestures),
+};
+
+static const struct config_schema config_schemas[] = {
+	{ 1, sizeof(struct config_data), config_v1_fields, ARRAY_SIZE(config_v1_fields), NULL },
+};
+
+BUILD_ASSERT(CONFIG_VERSION == 1, "add the new layout to config_schemas[]");
+
+/* Current configuration state: the published snapshot is the latest save,
+ * which may not be on flash yet */
+static struct config_data snapshot_slots[SNAPSHOT_SLOTS];
+static struct config_snapshot_pool snapshots;
+static const struct config_data *flash_config; /* Held: what the active area holds */
+static struct config_area_store store;      /* Active area, sequence, journal use */
+static uint8_t store_scratch[JOURNAL_SIZE];
 static bool initialized = false;
+static uint32_t migrated_from = 0;  /* Version migrated from at boot, 0 if none */
+
+/* Background hash check of the image selected at boot */
+static enum config_verify_state verify_state = CONFIG_VERIFY_PENDING;
+static uint32_t verify_sequence;
+static uint32_t verify_generation;   /* Snapshots published at boot */
+static void (*fallback_handler)(void);
+
+/* Saves (prepare and publish) and the background check touch the state above */
+static K_MUTEX_DEFINE(storage_lock);
+
+/* Held for every flash operation on the areas (store, flash_config). Taken
+ * before storage_lock, which is only held for short copies, so loads and
+ * saves never wait for an erase. */
+static K_MUTEX_DEFINE(flash_lock);
+
+/* Saves waiting for the writer thread */
+static struct config_writer writer;
+static K_SEM_DEFINE(writer_sem, 0, 1);
 
 /* Runtime flag to enable DEFAULT area writes (double protection) */
 static bool default_write_unlocked = false;
@@ -51,6 +144,33 @@ static bool default_write_unlocked = false;
 /* Flash device handle */
 static const struct device *flash_dev;
 
+/*
+ * Storage backend on the internal flash (config_area.c goes through it,
+ * the host tests use flash_sim.c instead)
+ */
+static int flash_backend_read(void *ctx, uint32_t offset, void *buf, size_t len)
+{
+	return flash_read(ctx, offset, buf, len);
+}
+
+static int flash_backend_write(void *ctx, uint32_t offset, const void *buf, size_t len)
+{
+	return flash_write(ctx, offset, buf, len);
+}
+
+static int flash_backend_erase(void *ctx, uint32_t offset, size_t len)
+{
+	return flash_erase(ctx, offset, len);
+}
+
+static struct storage_backend flash_backend = {
+	.read = flash_backend_read,
+	.write = flash_backend_write,
+	.erase = flash_backend_erase,
+	.write_block_size = JOURNAL_ALIGN,
+	.page_size = FLASH_PAGE_SIZE,
+};
+
 /**
  * @brief Calculate SHA256 hash of data
  */
@@ -105,138 +225,165 @@ static bool verify_hash(const void *data, size_t len, const uint8_t *expected_ha
 }
 
 /**
- * @brief Calculate CRC32 of header (excluding crc32 field)
+ * @brief Read and check an area header (magic, CRC, size) without the data
+ *
+ * The header is written last (see config_area_write()), so a valid header
+ * means its image was completely written.
  */
-static uint32_t calculate_header_crc(const struct config_header *header)
+static int read_header(enum config_area area, struct config_header *header)
 {
-	size_t crc_len = offsetof(struct config_header, crc32);
-	return crc32_ieee((const uint8_t *)header, crc_len);
+	int ret = config_area_read_header(&store, area, header);
+	if (ret == -EINVAL) {
+		LOG_WRN("No valid header in area %d (magic 0x%08x)", area, header->magic);
+		return ret;
+	}
+	if (ret != 0) {
+		LOG_ERR("Failed to read header from area %d: %d", area, ret);
+		return ret;
+	}
+	
+	/* Layout: newer firmware's configs are left alone; older ones migrate */
+	if (header->version > CONFIG_VERSION) {
+		LOG_WRN("Area %d holds config version %u, newer than this firmware (%u)",
+			area, header->version, CONFIG_VERSION);
+		return -ENOTSUP;
+	}
+	if (header->version == CONFIG_VERSION && header->data_size != sizeof(struct config_data)) {
+		LOG_ERR("Area %d: size %u does not match version %u", area,
+			header->data_size, header->version);
+		return -EINVAL;
+	}
+	
+	return 0;
 }
 
 /**
- * @brief Get flash offset for configuration area
+ * @brief Replay an old area's journal onto its image, a window at a time
+ *
+ * An older, smaller image leaves more of the page to the journal than
+ * store_scratch holds, so it is read in scratch-sized windows. Replay
+ * applies only whole saves, so each window starts right after the last
+ * save applied; a window that applies nothing (erased, corrupt or torn
+ * record, or one save larger than the window) ends the journal.
+ *
+ * @return Records applied
  */
-static off_t get_area_offset(enum config_area area)
-{
-	switch (area) {
-	case CONFIG_AREA_A:
-		return CONFIG_AREA_A_OFFSET;
-	case CONFIG_AREA_B:
-		return CONFIG_AREA_B_OFFSET;
-	default:
-		return -EINVAL;
+static int replay_old_journal(enum config_area area, size_t journal_start, uint8_t *image,
+			      size_t image_size)
+{
+	size_t journal_len = FLASH_PAGE_SIZE - journal_start;
+	size_t pos = 0;
+	int records = 0;
+	
+	while (pos < journal_len) {
+		size_t start = pos;
+		size_t window = MIN(sizeof(store_scratch), journal_len - pos);
+		
+		if (storage_read(&flash_backend, store.offset[area] + journal_start + pos,
+				 store_scratch, window) != 0) {
+			break;
+		}
+		int n = config_journal_replay(image, image_size, store_scratch, window, NULL);
+		if (n <= 0) {
+			break;
+		}
+		records += n;
+		
+		/* Step over the records just applied */
+		for (int i = 0; i < n; i++) {
+			struct config_journal_record rec;
+			
+			memcpy(&rec, &store_scratch[pos - start], sizeof(rec));
+			pos += config_journal_record_size(rec.len & ~JOURNAL_LEN_MORE);
+		}
 	}
+	return records;
 }
 
 /**
- * @brief Read configuration area from flash
+ * @brief Read an area written in an older layout and migrate it
+ *
+ * The old image is read into data, hash-checked and its journal replayed
+ * there in the old layout. It is then moved to store_scratch and
+ * converted field by field into data on top of the hardcoded defaults,
+ * so migration needs no buffer of its own.
  */
-static int read_area(enum config_area area, struct config_header *header,
-		     struct config_data *data)
+static int read_old_area(enum config_area area, const struct config_header *header,
+			 struct config_data *data)
 {
-	off_t offset = get_area_offset(area);
-	if (offset < 0) {
-		return offset;
+	uint8_t *old = (uint8_t *)data;
+	size_t journal_start = ROUND_UP(sizeof(*header) + header->data_size, JOURNAL_ALIGN);
+	
+	const struct config_schema *schema = config_schema_find(config_schemas,
+								ARRAY_SIZE(config_schemas),
+								header->version);
+	if (!schema || schema->size != header->data_size ||
+	    header->data_size > sizeof(*data) || journal_start >= FLASH_PAGE_SIZE) {
+		LOG_ERR("Area %d: no migration from version %u (size %u)", area,
+			header->version, header->data_size);
+		return -ENOTSUP;
 	}
 	
-	/* Read header */
-	int ret = flash_read(flash_dev, offset, header, sizeof(*header));
+	int ret = storage_read(&flash_backend, store.offset[area] + sizeof(*header), old,
+			       header->data_size);
 	if (ret != 0) {
-		LOG_ERR("Failed to read header from area %d: %d", area, ret);
 		return ret;
 	}
-	
-	/* Validate magic number */
-	if (header->magic != CONFIG_MAGIC) {
-		LOG_WRN("Invalid magic in area %d: 0x%08x", area, header->magic);
-		return -EINVAL;
-	}
-	
-	/* Validate header CRC */
-	uint32_t calculated_crc = calculate_header_crc(header);
-	if (calculated_crc != header->crc32) {
-		LOG_WRN("Header CRC mismatch in area %d", area);
-		return -EINVAL;
-	}
-	
-	/* Validate data size */
-	if (header->data_size > CONFIG_DATA_MAX_SIZE) {
-		LOG_ERR("Invalid data size in area %d: %u", area, header->data_size);
+	if (!verify_hash(old, header->data_size, header->hash)) {
+		LOG_ERR("Data hash mismatch in area %d", area);
 		return -EINVAL;
 	}
+	int records = replay_old_journal(area, journal_start, old, header->data_size);
 	
-	/* Read data */
-	ret = flash_read(flash_dev, offset + sizeof(*header), data,
-			 sizeof(*data));
+	memcpy(store_scratch, old, header->data_size);
+	config_storage_get_hardcoded_defaults(data);
+	ret = config_schema_migrate(config_schemas, ARRAY_SIZE(config_schemas), header->version,
+				    store_scratch, header->data_size, (uint8_t *)data, sizeof(*data));
 	if (ret != 0) {
-		LOG_ERR("Failed to read data from area %d: %d", area, ret);
+		LOG_ERR("Area %d: migration from version %u failed: %d", area, header->version, ret);
 		return ret;
 	}
 	
-	/* Verify data hash */
-	if (!verify_hash(data, sizeof(*data), header->hash)) {
-		LOG_ERR("Data hash mismatch in area %d", area);
-		return -EINVAL;
-	}
-	
-	LOG_INF("Successfully read area %d (seq=%u)", area, header->sequence);
+	LOG_INF("Migrated area %d from version %u to %u (%d journal records)",
+		area, header->version, CONFIG_VERSION, records);
 	return 0;
 }
 
 /**
- * @brief Write configuration area to flash
+ * @brief Read configuration area from flash, journal replayed, and make it
+ *        the active area
+ *
+ * @param verify Check the image against the header's SHA-256 first; boot
+ *               skips this and leaves it to the background check
  */
-static int write_area(enum config_area area, const struct config_data *data,
-		      uint32_t sequence)
+static int read_area(enum config_area area, struct config_header *header,
+		     struct config_data *data, bool verify)
 {
-	off_t offset = get_area_offset(area);
-	if (offset < 0) {
-		return offset;
-	}
-	
-	/* Build header */
-	struct config_header header = {
-		.magic = CONFIG_MAGIC,
-		.version = CONFIG_VERSION,
-		.sequence = sequence,
-		.data_size = sizeof(*data),
-	};
-	
-	/* Calculate data hash */
-	int ret = calculate_hash(data, sizeof(*data), header.hash);
+	int ret = read_header(area, header);
 	if (ret != 0) {
-		LOG_ERR("Failed to calculate hash: %d", ret);
 		return ret;
 	}
 	
-	/* Calculate header CRC */
-	header.crc32 = calculate_header_crc(&header);
-	
-	/* Erase flash page */
-	LOG_DBG("Erasing flash at offset 0x%08lx, size 0x%x", (long)offset, FLASH_PAGE_SIZE);
-	ret = flash_erase(flash_dev, offset, FLASH_PAGE_SIZE);
-	if (ret != 0) {
-		LOG_ERR("Failed to erase area %d at 0x%08lx: %d", area, (long)offset, ret);
-		return ret;
-	}
-	
-	/* Write header */
-	LOG_DBG("Writing header to offset 0x%08lx", (long)offset);
-	ret = flash_write(flash_dev, offset, &header, sizeof(header));
-	if (ret != 0) {
-		LOG_ERR("Failed to write header to area %d at 0x%08lx: %d", area, (long)offset, ret);
+	if (header->version != CONFIG_VERSION) {
+		ret = read_old_area(area, header, data);
+		if (ret == 0) {
+			/* The old area cannot take journal records in the new layout */
+			store.active = area;
+			store.sequence = header->sequence;
+			store.journal_records = 0;
+			config_area_force_compact(&store);
+		}
 		return ret;
 	}
 	
-	/* Write data */
-	LOG_DBG("Writing data to offset 0x%08lx", (long)(offset + sizeof(header)));
-	ret = flash_write(flash_dev, offset + sizeof(header), data, sizeof(*data));
-	if (ret != 0) {
-		LOG_ERR("Failed to write data to area %d at 0x%08lx: %d", area, (long)(offset + sizeof(header)), ret);
-		return ret;
+	int records = config_area_load(&store, area, header, data, verify);
+	if (records < 0) {
+		LOG_ERR("Failed to read area %d: %d", area, records);
+		return records;
 	}
 	
-	LOG_INF("Successfully wrote area %d (seq=%u)", area, sequence);
+	LOG_INF("Successfully read area %d (seq=%u, %d journal records, %zu/%zu bytes)",
+		area, header->sequence, records, store.journal_used, JOURNAL_SIZE);
 	return 0;
 }
 
@@ -285,12 +432,193 @@ void config_storage_get_hardcoded_defaults(struct config_data *data)
 	}
 }
 
+int config_storage_hash(const struct config_data *data, uint8_t hash[CONFIG_HASH_SIZE])
+{
+	if (!data || !hash) {
+		return -EINVAL;
+	}
+	
+	return calculate_hash(data, sizeof(*data), hash);
+}
+
+int config_storage_validate(const struct config_data *data)
+{
+	if (!data) {
+		return -EINVAL;
+	}
+	
+	const struct global_config *g = &data->global;
+	
+	if (g->default_patch >= NUM_PATCHES || g->midi_channel > 15 ||
+	    g->max_guitars < 1 || g->max_guitars > 4 || g->running_average_enable > 1 ||
+	    (g->running_average_enable &&
+	     (g->running_average_depth < 3 || g->running_average_depth > 10))) {
+		LOG_WRN("Validate: global settings out of range");
+		return -EINVAL;
+	}
+	
+	for (int i = 0; i < 6; i++) {
+		/* 0 = not set, mapping uses its built-in range */
+		if (g->accel_scale[i] != 0 &&
+		    (g->accel_scale[i] < 100 || g->accel_scale[i] > 4000)) {
+			LOG_WRN("Validate: accel_scale[%d]=%d out of range", i, g->accel_scale[i]);
+			return -EINVAL;
+		}
+	}
+	
+	for (int p = 0; p < NUM_PATCHES; p++) {
+		const struct patch_config *patch = &data->patches[p];
+		
+		if (patch->default_mixer_type > MIXER_MIN || patch->midi_deadzone < 0 ||
+		    patch->midi_deadzone > 127) {
+			LOG_WRN("Validate: patch %d mixer or deadzone out of range", p);
+			return -EINVAL;
+		}
+		for (int i = 0; i < MAX_TOPOLOGY_INSTANCES; i++) {
+			if (!topology_validate(&patch->topologies[i])) {
+				LOG_WRN("Validate: patch %d topology %d invalid", p, i);
+				return -EINVAL;
+			}
+		}
+		for (int i = 0; i < MAX_FUNCTION_UNITS; i++) {
+			if (!func_validate(&patch->functions[i])) {
+				LOG_WRN("Validate: patch %d function %d invalid", p, i);
+				return -EINVAL;
+			}
+		}
+		if (!gesture_config_validate(&patch->gestures)) {
+			LOG_WRN("Validate: patch %d gestures invalid", p);
+			return -EINVAL;
+		}
+	}
+	
+	return 0;
+}
+
+/**
+ * @brief Check the boot image against its SHA-256, falling back on a mismatch
+ *
+ * The image is read into a free snapshot slot, which is published only if
+ * it replaces the configuration. With no free slot the check stays
+ * pending and is retried. Once anything was saved since boot the RAM
+ * copy is newer than either area, so a mismatch keeps it instead.
+ *
+ * @return true if the current configuration was replaced
+ */
+static bool verify_boot_image(void)
+{
+	struct config_header header;
+	enum config_area active = store.active;
+	
+	/* A compaction since boot rewrote the image from RAM: nothing to check */
+	if (store.sequence != verify_sequence) {
+		verify_state = CONFIG_VERIFY_OK;
+		return false;
+	}
+	
+	struct config_data *image = config_snapshot_prepare(&snapshots);
+	if (!image) {
+		return false;
+	}
+	
+	if (read_header(active, &header) == 0 && header.data_size == sizeof(*image) &&
+	    config_area_read_image(&store, active, &header, image, true) == 0) {
+		verify_state = CONFIG_VERIFY_OK;
+		LOG_INF("Area %d hash verified (seq=%u)", active, store.sequence);
+		return false;
+	}
+	
+	/* Saves since boot (journaled or still queued) built on the RAM copy:
+	 * falling back would drop them, and the next save would store the
+	 * older config. Keep RAM; the caller rewrites it as a full image. */
+	if (snapshots.generation != verify_generation) {
+		config_area_force_compact(&store);
+		store.journal_records = 0;
+		verify_state = CONFIG_VERIFY_REWRITTEN;
+		LOG_ERR("Area %d hash mismatch (seq=%u) after saves, keeping the saved config",
+			active, store.sequence);
+		return false;
+	}
+	
+	LOG_ERR("Area %d hash mismatch (seq=%u), trying the other area", active, store.sequence);
+	enum config_area other = (active == CONFIG_AREA_A) ? CONFIG_AREA_B : CONFIG_AREA_A;
+	
+	if (read_area(other, &header, image, true) == 0) {
+		verify_state = CONFIG_VERIFY_RECOVERED;
+		LOG_WRN("Recovered configuration from area %d (seq=%u)", other, store.sequence);
+	} else {
+		config_storage_get_hardcoded_defaults(image);
+		/* Force the next save to write a full image instead of journaling */
+		config_area_force_compact(&store);
+		store.journal_records = 0;
+		verify_state = CONFIG_VERIFY_FAILED;
+		LOG_ERR("No configuration with a valid hash, using hardcoded defaults");
+	}
+	
+	config_snapshot_publish(&snapshots, image);
+	config_snapshot_release(&snapshots, flash_config);
+	flash_config = config_snapshot_acquire(&snapshots);
+	return true;
+}
+
+/**
+ * @brief Background hash check, run once boot is done
+ */
+static void verify_work_handler(struct k_work *work)
+{
+	k_mutex_lock(&flash_lock, K_FOREVER);
+	k_mutex_lock(&storage_lock, K_FOREVER);
+	bool replaced = verify_boot_image();
+	bool retry = verify_state == CONFIG_VERIFY_PENDING;
+	k_mutex_unlock(&storage_lock);
+	
+	/* The corrupt area still has a valid header and the higher sequence, so
+	 * header-only selection would pick it again on every boot: rewrite the
+	 * recovered or kept config over it as the newest area (flash_lock only,
+	 * so loads and saves do not wait for the erase). flash_config is what
+	 * the flash holds after any journaled saves. */
+	if (verify_state == CONFIG_VERIFY_RECOVERED || verify_state == CONFIG_VERIFY_REWRITTEN) {
+		int ret = config_area_compact(&store, flash_config);
+		
+		if (ret == 0) {
+			LOG_INF("Configuration rewritten to area %d (seq=%u)",
+				store.active, store.sequence);
+		} else {
+			config_area_force_compact(&store);
+			LOG_ERR("Configuration not rewritten (%d), next save retries", ret);
+		}
+	}
+	k_mutex_unlock(&flash_lock);
+	
+	if (retry) {
+		LOG_WRN("No free snapshot slot for the hash check, retrying");
+		k_work_schedule(k_work_delayable_from_work(work), K_MSEC(VERIFY_DELAY_MS));
+		return;
+	}
+	
+	/* Outside the lock: the handler reloads through config_storage_acquire() */
+	if (replaced && fallback_handler) {
+		fallback_handler();
+	}
+}
+
+static K_WORK_DELAYABLE_DEFINE(verify_work, verify_work_handler);
+
 int config_storage_init(void)
 {
 	if (initialized) {
 		return 0;
 	}
 	
+	/* Readers always find a configuration, even if the flash fails below */
+	if (snapshots.count == 0) {
+		config_snapshot_init(&snapshots, snapshot_slots, sizeof(struct config_data),
+				     SNAPSHOT_SLOTS);
+		struct config_data *defaults = config_snapshot_prepare(&snapshots);
+		config_storage_get_hardcoded_defaults(defaults);
+		config_snapshot_publish(&snapshots, defaults);
+	}
+	
 	/* Get flash device */
 	flash_dev = FLASH_DEVICE;
 	if (!device_is_ready(flash_dev)) {
@@ -300,6 +628,15 @@ int config_storage_init(void)
 	
 	LOG_INF("Internal flash device ready");
 	
+	flash_backend.ctx = (void *)flash_dev;
+	int ret = config_area_init(&store, &flash_backend, CONFIG_AREA_A_OFFSET, CONFIG_AREA_B_OFFSET,
+				   FLASH_PAGE_SIZE, sizeof(struct config_data), CONFIG_VERSION,
+				   calculate_hash, store_scratch, sizeof(store_scratch));
+	if (ret != 0) {
+		LOG_ERR("Config area layout rejected: %d", ret);
+		return ret;
+	}
+	
 	/* Check flash parameters */
 	const struct flash_parameters *params = flash_get_parameters(flash_dev);
 	LOG_INF("Flash write block size: %zu bytes", params->write_block_size);
@@ -316,95 +653,250 @@ int config_storage_init(void)
 	LOG_INF("Storage: offset=0x%08x size=0x%x", CONFIG_FLASH_OFFSET, CONFIG_STORAGE_SIZE);
 	LOG_INF("A: 0x%08x, B: 0x%08x", CONFIG_AREA_A_OFFSET, CONFIG_AREA_B_OFFSET);
 	
-	/* Try to read from both active areas */
-	static struct config_header header_a, header_b;
-	static struct config_data data_a, data_b;
-	
-	int ret_a = read_area(CONFIG_AREA_A, &header_a, &data_a);
-	int ret_b = read_area(CONFIG_AREA_B, &header_b, &data_b);
-	
-	/* Determine which area to use based on sequence numbers */
-	if (ret_a == 0 && ret_b == 0) {
-		/* Both valid - use the one with higher sequence */
-		if (header_a.sequence > header_b.sequence) {
-			active_area = CONFIG_AREA_A;
-			current_sequence = header_a.sequence;
-			memcpy(&current_config, &data_a, sizeof(current_config));
-			LOG_INF("Using area A (seq=%u)", current_sequence);
-		} else {
-			active_area = CONFIG_AREA_B;
-			current_sequence = header_b.sequence;
-			memcpy(&current_config, &data_b, sizeof(current_config));
-			LOG_INF("Using area B (seq=%u)", current_sequence);
+	if (config_schema_check_registry(config_schemas, ARRAY_SIZE(config_schemas)) != 0 ||
+	    config_schemas[ARRAY_SIZE(config_schemas) - 1].version != CONFIG_VERSION) {
+		LOG_ERR("Config schema registry is inconsistent");
+	}
+	
+	/* Select on the header CRCs: only the newest valid area's image is read,
+	 * and its SHA-256 is checked in the background once boot is done */
+	struct config_header headers[CONFIG_AREA_COUNT], header;
+	bool valid[CONFIG_AREA_COUNT] = {
+		read_header(CONFIG_AREA_A, &headers[CONFIG_AREA_A]) == 0,
+		read_header(CONFIG_AREA_B, &headers[CONFIG_AREA_B]) == 0,
+	};
+	uint8_t order[CONFIG_AREA_COUNT];
+	int candidates = config_area_select(headers, valid, order);
+	
+	struct config_data *boot = config_snapshot_prepare(&snapshots);
+	bool selected = false;
+	
+	for (int i = 0; i < candidates && !selected; i++) {
+		if (read_area(order[i], &header, boot, false) == 0) {
+			selected = true;
+			LOG_INF("Using area %s (seq=%u, %d valid header(s))",
+				(store.active == CONFIG_AREA_A) ? "A" : "B", store.sequence, candidates);
+		}
+	}
+	
+	if (selected && header.version != CONFIG_VERSION) {
+		/* Migrated (hash already checked): commit it in the current layout
+		 * so this runs once; the old area stays as the fallback */
+		migrated_from = header.version;
+		verify_state = CONFIG_VERIFY_OK;
+		ret = config_area_compact(&store, boot);
+		if (ret != 0) {
+			LOG_WRN("Migrated config not committed (%d), will migrate again next boot", ret);
 		}
-	} else if (ret_a == 0) {
-		/* Only A is valid */
-		active_area = CONFIG_AREA_A;
-		current_sequence = header_a.sequence;
-		memcpy(&current_config, &data_a, sizeof(current_config));
-		LOG_INF("Using area A (seq=%u, B invalid)", current_sequence);
-	} else if (ret_b == 0) {
-		/* Only B is valid */
-		active_area = CONFIG_AREA_B;
-		current_sequence = header_b.sequence;
-		memcpy(&current_config, &data_b, sizeof(current_config));
-		LOG_INF("Using area B (seq=%u, A invalid)", current_sequence);
+	} else if (selected) {
+		verify_sequence = store.sequence;
+		verify_state = CONFIG_VERIFY_PENDING;
+		k_work_schedule(&verify_work, K_MSEC(VERIFY_DELAY_MS));
 	} else {
 		/* Neither valid - use hardcoded defaults */
 		LOG_WRN("No valid config found, using hardcoded defaults");
-		config_storage_get_hardcoded_defaults(&current_config);
-		current_sequence = 0;
-		active_area = CONFIG_AREA_A;
+		config_storage_get_hardcoded_defaults(boot);
+		verify_state = CONFIG_VERIFY_OK;
 		
-		/* Try to save hardcoded defaults to active area (non-fatal if it fails) */
-		int ret = write_area(CONFIG_AREA_A, &current_config, 1);
+		/* Try to save hardcoded defaults to active area (non-fatal if it fails;
+		 * the journal stays full, so the next save writes a full image) */
+		ret = config_area_write(&store, CONFIG_AREA_A, boot, 1);
 		if (ret == 0) {
-			current_sequence = 1;
+			store.active = CONFIG_AREA_A;
+			store.sequence = 1;
+			store.journal_used = 0;
 			LOG_INF("Hardcoded defaults written to area A");
 		} else {
 			LOG_WRN("Failed to write defaults to area A: %d (continuing anyway)", ret);
 		}
 	}
 	
+	config_snapshot_publish(&snapshots, boot);
+	verify_generation = snapshots.generation;
+	flash_config = config_snapshot_acquire(&snapshots);
+	config_writer_init(&writer);
 	initialized = true;
 	LOG_INF("Configuration storage initialized");
 	return 0;
 }
 
-int config_storage_save(const struct config_data *data)
+/**
+ * @brief Write a snapshot to flash (journal append or compaction)
+ *
+ * Caller holds flash_lock. Takes over the reference to data: it becomes
+ * flash_config on success and is released on failure.
+ */
+static int commit_locked(const struct config_data *data)
+{
+	uint32_t sequence = store.sequence;
+	
+	int ret = config_area_save(&store, flash_config, data);
+	if (ret != 0) {
+		config_snapshot_release(&snapshots, data);
+		LOG_ERR("Save failed: %d", ret);
+		return ret;
+	}
+	
+	config_snapshot_release(&snapshots, flash_config);
+	flash_config = data;
+	if (store.sequence != sequence) {
+		LOG_INF("Configuration saved to area %d (seq=%u)", store.active, store.sequence);
+	} else {
+		LOG_INF("Configuration journaled in area %d (%zu/%zu used)",
+			store.active, store.journal_used, JOURNAL_SIZE);
+	}
+	return 0;
+}
+
+/*
+ * Writer thread: commits the latest configuration at low priority. The
+ * erase is the long part; with CONFIG_SOC_FLASH_NRF_PARTIAL_ERASE the
+ * flash driver runs it in short slices, and interrupts and higher
+ * priority threads (BLE, MIDI) run between them.
+ */
+static void writer_thread(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+	
+	struct config_writer_batch batch;
+	
+	while (1) {
+		k_sem_take(&writer_sem, K_FOREVER);
+		
+		/* Let a burst of setters land in one commit */
+		k_sleep(K_MSEC(CONFIG_GUITARACC_CONFIG_WRITE_DELAY_MS));
+		
+		k_mutex_lock(&flash_lock, K_FOREVER);
+		k_mutex_lock(&storage_lock, K_FOREVER);
+		uint32_t saves = config_writer_begin(&writer, &batch);
+		k_mutex_unlock(&storage_lock);
+		
+		if (saves == 0) {
+			k_mutex_unlock(&flash_lock);
+			continue;
+		}
+		
+		/* Commit the latest snapshot in place; saves during the commit
+		 * publish other slots and get the next commit */
+		uint32_t start = k_cycle_get_32();
+		int ret = commit_locked(config_snapshot_acquire(&snapshots));
+		uint32_t duration_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+		k_mutex_unlock(&flash_lock);
+		
+		k_mutex_lock(&storage_lock, K_FOREVER);
+		config_writer_end(&writer, &batch, ret, duration_us);
+		bool more = config_writer_get_state(&writer) == CONFIG_WRITER_PENDING;
+		k_mutex_unlock(&storage_lock);
+		
+		if (saves > 1) {
+			LOG_DBG("%u saves in one commit (%u us)", saves, duration_us);
+		}
+		config_writer_notify(&batch, ret);
+		if (more) {
+			k_sem_give(&writer_sem);
+		}
+	}
+}
+
+K_THREAD_DEFINE(config_writer_tid, WRITER_STACK_SIZE, writer_thread, NULL, NULL, NULL,
+		CONFIG_GUITARACC_CONFIG_WRITER_PRIORITY, 0, 0);
+
+/**
+ * @brief Publish a new snapshot and queue its commit
+ *
+ * @param data Configuration to save, or NULL for the hardcoded defaults
+ *             (built straight into the snapshot slot)
+ */
+static int save_request(const struct config_data *data, config_storage_done_cb done,
+			void *user_data)
 {
 	if (!initialized) {
 		LOG_ERR("Save failed: not initialized");
 		return -EACCES;
 	}
 	
-	LOG_DBG("Save: current area=%d, seq=%u", active_area, current_sequence);
-	
-	/* Determine next area (ping-pong) */
-	enum config_area next_area = (active_area == CONFIG_AREA_A) ?
-				     CONFIG_AREA_B : CONFIG_AREA_A;
+	k_mutex_lock(&storage_lock, K_FOREVER);
+	struct config_data *next = config_snapshot_prepare(&snapshots);
+	int ret = next ? config_writer_request(&writer, done, user_data) : -EBUSY;
+	if (ret == 0) {
+		if (data) {
+			memcpy(next, data, sizeof(*next));
+		} else {
+			config_storage_get_hardcoded_defaults(next);
+		}
+		config_snapshot_publish(&snapshots, next);
+	}
+	k_mutex_unlock(&storage_lock);
 	
-	LOG_INF("Save: switching from area %d to area %d", active_area, next_area);
+	if (!next) {
+		LOG_WRN("Save rejected: every snapshot slot is held by a reader");
+		return ret;
+	}
+	if (ret != 0) {
+		LOG_WRN("Save rejected: %u commits already waiting", CONFIG_WRITER_MAX_CALLBACKS);
+		return ret;
+	}
 	
-	/* Increment sequence number */
-	uint32_t next_sequence = current_sequence + 1;
+	k_sem_give(&writer_sem);
+	return 0;
+}
+
+int config_storage_save_async(const struct config_data *data, config_storage_done_cb done,
+			      void *user_data)
+{
+	return save_request(data, done, user_data);
+}
+
+struct save_waiter {
+	struct k_sem done;
+	int result;
+};
+
+static void save_waiter_done(int result, void *user_data)
+{
+	struct save_waiter *waiter = user_data;
 	
-	LOG_DBG("Save: next_sequence=%u", next_sequence);
+	waiter->result = result;
+	k_sem_give(&waiter->done);
+}
+
+/* save_request() and wait for the commit */
+static int save_and_wait(const struct config_data *data)
+{
+	struct save_waiter waiter;
 	
-	/* Write to inactive area */
-	int ret = write_area(next_area, data, next_sequence);
+	k_sem_init(&waiter.done, 0, 1);
+	int ret = save_request(data, save_waiter_done, &waiter);
 	if (ret != 0) {
-		LOG_ERR("Save failed: write_area returned %d", ret);
 		return ret;
 	}
 	
-	/* Update current state */
-	memcpy(&current_config, data, sizeof(current_config));
-	active_area = next_area;
-	current_sequence = next_sequence;
+	k_sem_take(&waiter.done, K_FOREVER);
+	return waiter.result;
+}
+
+int config_storage_save(const struct config_data *data)
+{
+	return save_and_wait(data);
+}
+
+int config_storage_get_write_status(struct config_write_status *status)
+{
+	if (!initialized) {
+		return -EACCES;
+	}
 	
-	LOG_INF("Configuration saved to area %d (seq=%u)",
-		active_area, current_sequence);
+	k_mutex_lock(&storage_lock, K_FOREVER);
+	status->state = config_writer_get_state(&writer);
+	status->pending_saves = writer.pending_saves;
+	status->commits = writer.commits;
+	status->failures = writer.failures;
+	status->last_result = writer.last_result;
+	status->last_commit_us = writer.last_commit_us;
+	status->max_commit_us = writer.max_commit_us;
+	k_mutex_unlock(&storage_lock);
 	return 0;
 }
 
@@ -414,24 +906,51 @@ int config_storage_load(struct config_data *data)
 		return -EACCES;
 	}
 	
-	memcpy(data, &current_config, sizeof(*data));
+	const struct config_data *cfg = config_storage_acquire();
+	memcpy(data, cfg, sizeof(*data));
+	config_storage_release(cfg);
 	return 0;
 }
 
+const struct config_data *config_storage_acquire(void)
+{
+	return config_snapshot_acquire(&snapshots);
+}
+
+void config_storage_release(const struct config_data *config)
+{
+	config_snapshot_release(&snapshots, config);
+}
+
+const struct config_schema *config_storage_get_schema(void)
+{
+	return &config_schemas[ARRAY_SIZE(config_schemas) - 1];
+}
+
+uint32_t config_storage_get_migrated_from(void)
+{
+	return migrated_from;
+}
+
+enum config_verify_state config_storage_get_verify_state(void)
+{
+	return verify_state;
+}
+
+void config_storage_set_fallback_handler(void (*handler)(void))
+{
+	fallback_handler = handler;
+}
+
 int config_storage_restore_defaults(void)
 {
 	if (!initialized) {
 		return -EACCES;
 	}
 	
-	static struct config_data data;
-	
-	/* Use hardcoded defaults */
-	config_storage_get_hardcoded_defaults(&data);
+	/* Built in the snapshot slot that gets saved, no copy of its own */
 	LOG_INF("Restoring hardcoded factory defaults");
-	
-	/* Save to active storage */
-	return config_storage_save(&data);
+	return save_and_wait(NULL);
 }
 
 int config_storage_get_info(enum config_area *area, uint32_t *sequence)
@@ -441,10 +960,29 @@ int config_storage_get_info(enum config_area *area, uint32_t *sequence)
 	}
 	
 	if (area) {
-		*area = active_area;
+		*area = store.active;
 	}
 	if (sequence) {
-		*sequence = current_sequence;
+		*sequence = store.sequence;
+	}
+	
+	return 0;
+}
+
+int config_storage_get_journal_info(size_t *used, size_t *size, uint32_t *records)
+{
+	if (!initialized) {
+		return -EACCES;
+	}
+	
+	if (used) {
+		*used = store.journal_used;
+	}
+	if (size) {
+		*size = JOURNAL_SIZE;
+	}
+	if (records) {
+		*records = store.journal_records;
 	}
 	
 	return 0;
@@ -488,20 +1026,16 @@ int config_storage_erase_all(void)
 	LOG_WRN("*** ERASING ALL CONFIGURATION STORAGE ***");
 	LOG_WRN("This will erase DEFAULT, AREA_A, and AREA_B");
 	
-	/* Erase both areas */
-	int ret;
-	
-	LOG_INF("Erasing AREA_A at 0x%08x...", CONFIG_AREA_A_OFFSET);
-	ret = flash_erase(flash_dev, CONFIG_AREA_A_OFFSET, FLASH_PAGE_SIZE);
-	if (ret != 0) {
-		LOG_ERR("Failed to erase AREA_A: %d", ret);
-		return ret;
-	}
-	
-	LOG_INF("Erasing AREA_B at 0x%08x...", CONFIG_AREA_B_OFFSET);
-	ret = flash_erase(flash_dev, CONFIG_AREA_B_OFFSET, FLASH_PAGE_SIZE);
+	/* Erase both areas (a commit in progress finishes first). The store
+	 * is reset too: appending to an erased area would report success and
+	 * lose the save, so the next one writes a full image. */
+	k_mutex_lock(&flash_lock, K_FOREVER);
+	LOG_INF("Erasing AREA_A at 0x%08x and AREA_B at 0x%08x...",
+		CONFIG_AREA_A_OFFSET, CONFIG_AREA_B_OFFSET);
+	int ret = config_area_erase_all(&store);
+	k_mutex_unlock(&flash_lock);
 	if (ret != 0) {
-		LOG_ERR("Failed to erase AREA_B: %d", ret);
+		LOG_ERR("Failed to erase configuration areas: %d", ret);
 		return ret;
 	}
 	
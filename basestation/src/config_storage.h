@@ -10,6 +10,11 @@
 #include <stdint.h>
 #include "topology_config.h"
 #include "function_units.h"
+#include "gesture_engine.h"
+#include "patch_bank.h"
+#include "config_schema.h"
+#include "config_area.h"
+#include "config_writer.h"
 
 /**
  * @brief Configuration Storage Module
@@ -23,6 +28,21 @@
  * 
  * The system ping-pongs between A and B, always using the most recent valid
  * configuration (determined by sequence number and hash validation).
+ * At boot the area is chosen on its header CRC alone (headers are written
+ * after their image) and the SHA-256 of the image is checked in the
+ * background; see config_storage_get_verify_state().
+ * A config stored by older firmware (lower CONFIG_VERSION) is migrated
+ * field by field at boot and committed (see config_schema.h).
+ * 
+ * Saves normally append only the changed bytes to a journal in the erased
+ * rest of the active area (see config_journal.h); the full image is
+ * rewritten to the other area only when the journal is full. The area
+ * format (config_area.h) goes through a storage backend, so it also runs
+ * on the host flash simulator (flash_sim.h).
+ * 
+ * Saves take effect in RAM at once; a low-priority writer thread commits
+ * them to flash, coalescing saves that arrive before it runs (see
+ * config_writer.h and config_storage_save_async()).
  */
 
 /* Configuration data structure version */
@@ -34,24 +54,6 @@
 /* Maximum configuration data size (excluding header) */
 #define CONFIG_DATA_MAX_SIZE 4096
 
-/* SHA256 hash size */
-#define CONFIG_HASH_SIZE 32
-
-/**
- * @brief Configuration header structure
- * 
- * Stored at the beginning of each configuration area to track version,
- * sequence number, and hash for validation.
- */
-struct config_header {
-	uint32_t magic;           /* Magic number: 0x47544143 ("GTAC") */
-	uint32_t version;         /* Configuration structure version */
-	uint32_t sequence;        /* Sequence number for ping-pong selection */
-	uint32_t data_size;       /* Size of configuration data */
-	uint8_t  hash[CONFIG_HASH_SIZE]; /* SHA256 hash of data */
-	uint32_t crc32;           /* CRC32 of header (excluding this field) */
-} __packed;
-
 /**
  * @brief Global configuration structure
  * 
@@ -84,30 +86,7 @@ struct global_config {
 	uint8_t reserved[21];          /* Future expansion (21 bytes for 4-byte alignment) */
 } __packed;
 
-/**
- * @brief Patch configuration structure
- * 
- * Patch-specific settings that can vary between different
- * performances, songs, or sound designs.
- */
-struct patch_config {
-	/* LED configuration */
-	uint8_t led_mode;              /* LED mode (0-3) */
-	
-	/* MIDI threshold */
-	int16_t midi_deadzone;         /* MIDI CC change threshold for transmission */
-	
-	/* Patch metadata */
-	char patch_name[32];           /* Patch name (null-terminated) */
-	
-	/* Virtual ports topology configuration */
-	struct topology_instance topologies[MAX_TOPOLOGY_INSTANCES];  /* 6 × 12 = 72 bytes */
-	struct function_unit functions[MAX_FUNCTION_UNITS];           /* 8 × 16 = 128 bytes */
-	uint8_t default_mixer_type;                                   /* Default mixing algorithm */
-	
-	/* Reserved for future patch settings */
-	uint8_t reserved[19];          /* Future expansion (19 bytes for 4-byte alignment) */
-} __packed;
+/* struct patch_config is defined in patch_bank.h (shared with the patch bank) */
 
 /**
  * @brief Combined configuration data structure
@@ -138,6 +117,37 @@ enum config_area {
 	CONFIG_AREA_B = 1,        /* Active storage B */
 };
 
+/**
+ * @brief State of the background hash check of the boot image
+ */
+enum config_verify_state {
+	CONFIG_VERIFY_PENDING = 0,  /* Selected on header CRC, SHA-256 not checked yet */
+	CONFIG_VERIFY_OK,           /* Image matches its SHA-256 */
+	CONFIG_VERIFY_RECOVERED,    /* Mismatch: fell back to the other area */
+	CONFIG_VERIFY_FAILED,       /* No image with a valid hash: hardcoded defaults */
+	CONFIG_VERIFY_REWRITTEN,    /* Mismatch after saves: kept RAM, rewritten from it */
+};
+
+/**
+ * @brief Flash writer status, for 'status'
+ */
+struct config_write_status {
+	enum config_writer_state state;
+	uint32_t pending_saves;     /* Saves not yet handed to a commit */
+	uint32_t commits;
+	uint32_t failures;
+	int last_result;            /* Result of the last commit */
+	uint32_t last_commit_us;
+	uint32_t max_commit_us;
+};
+
+/**
+ * @brief Completion callback of config_storage_save_async()
+ *
+ * Runs on the writer thread; must not call config_storage_save().
+ */
+typedef config_writer_done_fn config_storage_done_cb;
+
 /**
  * @brief Initialize configuration storage system
  * 
@@ -150,26 +160,76 @@ enum config_area {
 int config_storage_init(void);
 
 /**
- * @brief Save configuration data
+ * @brief Save configuration data and wait until it is on flash
+ * 
+ * Appends the bytes that changed to the active area's journal. When they
+ * do not fit, writes configuration to the inactive area (ping-pong),
+ * increments sequence number, calculates hash, and updates header. The
+ * new area becomes active with an empty journal.
  * 
- * Writes configuration to the inactive area (ping-pong), increments sequence
- * number, calculates hash, and updates header. The new area becomes active.
+ * The write runs on the writer thread like config_storage_save_async();
+ * this call blocks until it is done.
  * 
  * @param data Pointer to configuration data structure
  * @return 0 on success, negative errno on failure
  */
 int config_storage_save(const struct config_data *data);
 
+/**
+ * @brief Save configuration data, commit to flash in the background
+ * 
+ * Loads and snapshots see data from now on. The writer thread
+ * commits it (with any later saves) after
+ * CONFIG_GUITARACC_CONFIG_WRITE_DELAY_MS, then calls done with the
+ * result. A failed commit is retried by the next save.
+ * 
+ * @param data Pointer to configuration data structure
+ * @param done Completion callback, or NULL
+ * @param user_data Passed to done
+ * @return 0 if queued, -EBUSY if too many callbacks are waiting or no
+ *         snapshot slot is free (nothing saved), -EACCES if not initialized
+ */
+int config_storage_save_async(const struct config_data *data, config_storage_done_cb done,
+			      void *user_data);
+
+/**
+ * @brief Get the flash writer status
+ * 
+ * @param status Output
+ * @return 0 on success, negative errno on failure
+ */
+int config_storage_get_write_status(struct config_write_status *status);
+
 /**
  * @brief Load current configuration data
  * 
- * Retrieves the currently active configuration (most recent valid area).
+ * Copies the current configuration (the latest save) for callers that
+ * edit it; read-only callers use config_storage_acquire() instead.
  * 
  * @param data Pointer to buffer for configuration data
  * @return 0 on success, negative errno on failure
  */
 int config_storage_load(struct config_data *data);
 
+/**
+ * @brief Take a read-only reference to the current configuration
+ * 
+ * No copy and no lock: the snapshot stays unchanged until released, while
+ * saves publish new snapshots next to it. Release it promptly; a save
+ * fails with -EBUSY while readers hold every free snapshot slot.
+ * 
+ * @return Current configuration (hardcoded defaults if the flash failed),
+ *         NULL before config_storage_init()
+ */
+const struct config_data *config_storage_acquire(void);
+
+/**
+ * @brief Release a snapshot taken by config_storage_acquire()
+ * 
+ * @param config Snapshot, or NULL (ignored)
+ */
+void config_storage_release(const struct config_data *config);
+
 /**
  * @brief Restore factory default configuration
  * 
@@ -191,6 +251,17 @@ int config_storage_restore_defaults(void);
  */
 int config_storage_get_info(enum config_area *active_area, uint32_t *sequence);
 
+/**
+ * @brief Get journal usage of the active area
+ * 
+ * @param used Pointer to store bytes of journal in use (may be NULL)
+ * @param size Pointer to store journal capacity in bytes (may be NULL)
+ * @param records Pointer to store saves journaled since the last
+ *                compaction in this boot (may be NULL)
+ * @return 0 on success, negative errno on failure
+ */
+int config_storage_get_journal_info(size_t *used, size_t *size, uint32_t *records);
+
 /**
  * @brief Erase all configuration storage areas (testing only)
  * 
@@ -214,4 +285,50 @@ int config_storage_erase_all(void);
  */
 void config_storage_get_hardcoded_defaults(struct config_data *data);
 
+/**
+ * @brief Get the layout descriptor of the current config_data version
+ */
+const struct config_schema *config_storage_get_schema(void);
+
+/**
+ * @brief Get the version the stored config was migrated from at this boot
+ *
+ * @return Old version, or 0 if no migration ran
+ */
+uint32_t config_storage_get_migrated_from(void);
+
+/**
+ * @brief Get the state of the background hash check of the boot image
+ */
+enum config_verify_state config_storage_get_verify_state(void);
+
+/**
+ * @brief Set the function called when the background hash check replaced
+ *        the configuration (other area or defaults)
+ *
+ * Called from the system workqueue; the handler should reload the
+ * configuration with config_storage_acquire().
+ */
+void config_storage_set_fallback_handler(void (*handler)(void));
+
+/**
+ * @brief SHA-256 of a configuration, as stored in the area header
+ * 
+ * @param data Configuration to hash
+ * @param hash Output: CONFIG_HASH_SIZE bytes
+ * @return 0 on success, negative errno on failure
+ */
+int config_storage_hash(const struct config_data *data, uint8_t hash[CONFIG_HASH_SIZE]);
+
+/**
+ * @brief Check a whole configuration before it is committed
+ * 
+ * Range-checks the global settings and validates every patch's
+ * topologies, function units and gesture slots.
+ * 
+ * @param data Configuration to check
+ * @return 0 if valid, -EINVAL otherwise (the first problem is logged)
+ */
+int config_storage_validate(const struct config_data *data);
+
 #endif /* CONFIG_STORAGE_H_ */
@@ -0,0 +1,253 @@
+/*
+ * Configuration Transfer Implementation
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "config_transfer.h"
+#include "config_journal.h"
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+static const char b64_alphabet[] =
+	"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/* Value of a base64 character, -1 if it is not one */
+static int b64_value(char c)
+{
+	if (c >= 'A' && c <= 'Z') {
+		return c - 'A';
+	}
+	if (c >= 'a' && c <= 'z') {
+		return c - 'a' + 26;
+	}
+	if (c >= '0' && c <= '9') {
+		return c - '0' + 52;
+	}
+	if (c == '+') {
+		return 62;
+	}
+	if (c == '/') {
+		return 63;
+	}
+	return -1;
+}
+
+static int hex_value(char c)
+{
+	if (c >= '0' && c <= '9') {
+		return c - '0';
+	}
+	if (c >= 'a' && c <= 'f') {
+		return c - 'a' + 10;
+	}
+	if (c >= 'A' && c <= 'F') {
+		return c - 'A' + 10;
+	}
+	return -1;
+}
+
+static size_t chunk_len(const struct config_xfer *xfer, uint32_t offset)
+{
+	size_t left = xfer->size - offset;
+
+	return (left < XFER_CHUNK_SIZE) ? left : XFER_CHUNK_SIZE;
+}
+
+size_t config_xfer_base64_encode(const uint8_t *in, size_t len, char *out, size_t out_size)
+{
+	size_t n = (len + 2) / 3 * 4;
+	size_t o = 0;
+
+	if (!in || !out || out_size < n + 1) {
+		return 0;
+	}
+
+	for (size_t i = 0; i < len; i += 3) {
+		uint32_t v = (uint32_t)in[i] << 16;
+
+		if (i + 1 < len) {
+			v |= (uint32_t)in[i + 1] << 8;
+		}
+		if (i + 2 < len) {
+			v |= in[i + 2];
+		}
+
+		out[o++] = b64_alphabet[(v >> 18) & 0x3F];
+		out[o++] = b64_alphabet[(v >> 12) & 0x3F];
+		out[o++] = (i + 1 < len) ? b64_alphabet[(v >> 6) & 0x3F] : '=';
+		out[o++] = (i + 2 < len) ? b64_alphabet[v & 0x3F] : '=';
+	}
+	out[o] = '\0';
+	return o;
+}
+
+int config_xfer_base64_decode(const char *in, uint8_t *out, size_t out_size)
+{
+	size_t len;
+	size_t o = 0;
+
+	if (!in || !out) {
+		return -EINVAL;
+	}
+
+	len = strlen(in);
+	if (len == 0 || len % 4 != 0) {
+		return -EINVAL;
+	}
+
+	for (size_t i = 0; i < len; i += 4) {
+		bool last = (i + 4 == len);
+		int pad = 0;
+		uint32_t v = 0;
+
+		for (int k = 0; k < 4; k++) {
+			int d;
+
+			if (in[i + k] == '=' && last && k >= 2) {
+				pad++;
+				d = 0;
+			} else if (pad > 0 || (d = b64_value(in[i + k])) < 0) {
+				return -EINVAL;  /* Bad character, or data after padding */
+			}
+			v = (v << 6) | (uint32_t)d;
+		}
+
+		if (o + 3 - pad > out_size) {
+			return -ENOSPC;
+		}
+		out[o++] = (uint8_t)(v >> 16);
+		if (pad < 2) {
+			out[o++] = (uint8_t)(v >> 8);
+		}
+		if (pad < 1) {
+			out[o++] = (uint8_t)v;
+		}
+	}
+	return (int)o;
+}
+
+int config_xfer_hex_decode(const char *hex, uint8_t *out, size_t len)
+{
+	if (!hex || !out || strlen(hex) != 2 * len) {
+		return -EINVAL;
+	}
+
+	for (size_t i = 0; i < len; i++) {
+		int hi = hex_value(hex[2 * i]);
+		int lo = hex_value(hex[2 * i + 1]);
+
+		if (hi < 0 || lo < 0) {
+			return -EINVAL;
+		}
+		out[i] = (uint8_t)(hi << 4 | lo);
+	}
+	return 0;
+}
+
+void config_xfer_hex_encode(const uint8_t *in, size_t len, char *out)
+{
+	static const char digits[] = "0123456789abcdef";
+
+	for (size_t i = 0; i < len; i++) {
+		out[2 * i] = digits[in[i] >> 4];
+		out[2 * i + 1] = digits[in[i] & 0x0F];
+	}
+	out[2 * len] = '\0';
+}
+
+int config_xfer_format_chunk(const uint8_t *image, size_t size, uint32_t offset,
+                             char *line, size_t line_size)
+{
+	char b64[XFER_CHUNK_CHARS + 1];
+
+	if (!image || !line || offset >= size || offset % XFER_CHUNK_SIZE != 0) {
+		return -EINVAL;
+	}
+
+	size_t len = size - offset;
+	if (len > XFER_CHUNK_SIZE) {
+		len = XFER_CHUNK_SIZE;
+	}
+
+	config_xfer_base64_encode(&image[offset], len, b64, sizeof(b64));
+	int n = snprintf(line, line_size, "%u %s %08x", (unsigned int)offset, b64,
+	                 (unsigned int)config_journal_crc32(&image[offset], len));
+	if (n < 0 || (size_t)n >= line_size) {
+		return -EINVAL;
+	}
+	return n;
+}
+
+int config_xfer_begin(struct config_xfer *xfer, uint8_t *image, size_t size,
+                      const uint8_t sha256[XFER_SHA256_SIZE])
+{
+	if (!xfer || !image || !sha256 || size == 0 || size > XFER_MAX_SIZE) {
+		return -EINVAL;
+	}
+
+	/* Same image announced again: keep what already arrived */
+	if (xfer->active && xfer->image == image && xfer->size == size &&
+	    memcmp(xfer->sha256, sha256, XFER_SHA256_SIZE) == 0) {
+		return 1;
+	}
+
+	memset(xfer, 0, sizeof(*xfer));
+	xfer->image = image;
+	xfer->size = size;
+	xfer->chunks = (uint16_t)((size + XFER_CHUNK_SIZE - 1) / XFER_CHUNK_SIZE);
+	memcpy(xfer->sha256, sha256, XFER_SHA256_SIZE);
+	xfer->active = true;
+	return 0;
+}
+
+int config_xfer_put(struct config_xfer *xfer, uint32_t offset, const char *b64,
+                    uint32_t crc32)
+{
+	uint8_t data[XFER_CHUNK_SIZE];
+
+	if (!xfer || !xfer->active || !b64 || offset >= xfer->size ||
+	    offset % XFER_CHUNK_SIZE != 0) {
+		return -EINVAL;
+	}
+
+	int len = config_xfer_base64_decode(b64, data, sizeof(data));
+	if (len < 0 || (size_t)len != chunk_len(xfer, offset)) {
+		return -EINVAL;
+	}
+	if (config_journal_crc32(data, (size_t)len) != crc32) {
+		return -EBADMSG;
+	}
+
+	uint16_t chunk = (uint16_t)(offset / XFER_CHUNK_SIZE);
+
+	memcpy(&xfer->image[offset], data, (size_t)len);
+	if (!(xfer->received[chunk / 8] & (1 << (chunk % 8)))) {
+		xfer->received[chunk / 8] |= (uint8_t)(1 << (chunk % 8));
+		xfer->received_count++;
+	}
+	return 0;
+}
+
+int config_xfer_next_missing(const struct config_xfer *xfer)
+{
+	if (!xfer || !xfer->active) {
+		return -EINVAL;
+	}
+
+	for (uint16_t chunk = 0; chunk < xfer->chunks; chunk++) {
+		if (!(xfer->received[chunk / 8] & (1 << (chunk % 8)))) {
+			return chunk * XFER_CHUNK_SIZE;
+		}
+	}
+	return (int)xfer->size;
+}
+
+void config_xfer_abort(struct config_xfer *xfer)
+{
+	if (xfer) {
+		memset(xfer, 0, sizeof(*xfer));
+	}
+}
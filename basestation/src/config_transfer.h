@@ -0,0 +1,156 @@
+/*
+ * Configuration Transfer
+ * Chunked, checksummed binary transfer of a configuration image
+ *
+ * Moves a whole config_data image over the text shell as base64 lines
+ * instead of JSON. The image is cut into XFER_CHUNK_SIZE byte chunks; each
+ * line carries the chunk's offset, its base64 data and the CRC-32 of the
+ * decoded bytes:
+ *
+ *   <offset> <base64> <crc32 hex>
+ *
+ * The receiver keeps a bitmap of the chunks it has, so a sender that lost
+ * its place (dropped line, bad CRC, reconnect) asks for the first missing
+ * offset and resumes from there. The image is only used once every chunk
+ * has arrived and the SHA-256 announced at the start matches.
+ *
+ * Pure logic with no hardware dependencies - can be tested on host.
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CONFIG_TRANSFER_H
+#define CONFIG_TRANSFER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/* ========================================
+ * CONSTANTS
+ * ======================================== */
+
+#define XFER_CHUNK_SIZE     48      /* Image bytes per line */
+#define XFER_CHUNK_CHARS    64      /* Base64 characters of a full chunk */
+#define XFER_MAX_SIZE       4096    /* Largest image (CONFIG_DATA_MAX_SIZE) */
+#define XFER_MAX_CHUNKS     ((XFER_MAX_SIZE + XFER_CHUNK_SIZE - 1) / XFER_CHUNK_SIZE)
+#define XFER_SHA256_SIZE    32
+
+/* Longest chunk line: offset, base64, CRC, two spaces and NUL */
+#define XFER_LINE_MAX       (5 + 1 + XFER_CHUNK_CHARS + 1 + 8 + 1)
+
+/* ========================================
+ * DATA STRUCTURES
+ * ======================================== */
+
+/**
+ * @brief Receive state of one transfer
+ */
+struct config_xfer {
+	uint8_t *image;                         /* Destination (caller's buffer) */
+	size_t size;                            /* Image size */
+	uint8_t sha256[XFER_SHA256_SIZE];       /* Expected hash of the whole image */
+	uint16_t chunks;                        /* Chunks in the image */
+	uint16_t received_count;                /* Distinct chunks received */
+	uint8_t received[(XFER_MAX_CHUNKS + 7) / 8];  /* Bitmap of received chunks */
+	bool active;                            /* Transfer in progress */
+};
+
+/* ========================================
+ * API
+ * ======================================== */
+
+/**
+ * @brief Base64-encode bytes (standard alphabet, '=' padded, NUL terminated)
+ *
+ * @param in Input bytes
+ * @param len Number of input bytes
+ * @param out Output characters
+ * @param out_size Size of out, including the NUL
+ * @return Characters written (without the NUL), 0 if out is too small
+ */
+size_t config_xfer_base64_encode(const uint8_t *in, size_t len, char *out, size_t out_size);
+
+/**
+ * @brief Decode a NUL terminated base64 string
+ *
+ * @param in Base64 characters
+ * @param out Output bytes
+ * @param out_size Size of out
+ * @return Bytes decoded, -EINVAL on a bad character, length or padding,
+ *         -ENOSPC if out is too small
+ */
+int config_xfer_base64_decode(const char *in, uint8_t *out, size_t out_size);
+
+/**
+ * @brief Decode exactly len bytes of hex (either case)
+ *
+ * @return 0 on success, -EINVAL if the string is not 2 * len hex digits
+ */
+int config_xfer_hex_decode(const char *hex, uint8_t *out, size_t len);
+
+/**
+ * @brief Encode bytes as lower-case hex
+ *
+ * @param out Output, 2 * len + 1 characters
+ */
+void config_xfer_hex_encode(const uint8_t *in, size_t len, char *out);
+
+/**
+ * @brief Format the line for the chunk at offset
+ *
+ * @param image Image to send
+ * @param size Image size
+ * @param offset Chunk offset (multiple of XFER_CHUNK_SIZE, below size)
+ * @param line Output line, NUL terminated
+ * @param line_size Size of line (XFER_LINE_MAX is always enough)
+ * @return Line length, -EINVAL on a bad offset or short buffer
+ */
+int config_xfer_format_chunk(const uint8_t *image, size_t size, uint32_t offset,
+                             char *line, size_t line_size);
+
+/**
+ * @brief Start receiving an image, or resume the same one
+ *
+ * If a transfer of the same size and SHA-256 is already active its
+ * received chunks are kept; otherwise all state is cleared.
+ *
+ * @param xfer Transfer state
+ * @param image Destination buffer of size bytes
+ * @param size Image size (1 to XFER_MAX_SIZE)
+ * @param sha256 Expected SHA-256 of the complete image
+ * @return 1 if resumed, 0 if started, -EINVAL on bad arguments
+ */
+int config_xfer_begin(struct config_xfer *xfer, uint8_t *image, size_t size,
+                      const uint8_t sha256[XFER_SHA256_SIZE]);
+
+/**
+ * @brief Store one received chunk
+ *
+ * Receiving a chunk twice is harmless; the later copy wins.
+ *
+ * @param xfer Transfer state
+ * @param offset Chunk offset
+ * @param b64 Base64 data of the chunk
+ * @param crc32 CRC-32 of the decoded data
+ * @return 0 on success, -EBADMSG on a CRC mismatch, -EINVAL if no
+ *         transfer is active or the offset, encoding or length is wrong
+ */
+int config_xfer_put(struct config_xfer *xfer, uint32_t offset, const char *b64,
+                    uint32_t crc32);
+
+/**
+ * @brief Offset of the first chunk not yet received
+ *
+ * @return Offset to resend from, the image size when complete,
+ *         -EINVAL if no transfer is active
+ */
+int config_xfer_next_missing(const struct config_xfer *xfer);
+
+/**
+ * @brief End the transfer and forget its state
+ */
+void config_xfer_abort(struct config_xfer *xfer);
+
+#endif /* CONFIG_TRANSFER_H */
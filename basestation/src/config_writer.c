@@ -0,0 +1,98 @@
+/*
+ * Config Writer Queue Implementation
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "config_writer.h"
+#include <errno.h>
+#include <string.h>
+
+void config_writer_init(struct config_writer *w)
+{
+	memset(w, 0, sizeof(*w));
+}
+
+int config_writer_request(struct config_writer *w, config_writer_done_fn fn, void *user_data)
+{
+	if (fn) {
+		if (w->count >= CONFIG_WRITER_MAX_CALLBACKS) {
+			return -EBUSY;
+		}
+		w->callbacks[w->count].fn = fn;
+		w->callbacks[w->count].user_data = user_data;
+		w->count++;
+	}
+
+	w->pending_saves++;
+	w->requests++;
+	return 0;
+}
+
+uint32_t config_writer_begin(struct config_writer *w, struct config_writer_batch *batch)
+{
+	batch->count = 0;
+	batch->saves = 0;
+
+	if (w->writing || w->pending_saves == 0) {
+		return 0;
+	}
+
+	memcpy(batch->callbacks, w->callbacks, w->count * sizeof(w->callbacks[0]));
+	batch->count = w->count;
+	batch->saves = w->pending_saves;
+
+	w->count = 0;
+	w->pending_saves = 0;
+	w->writing = true;
+	return batch->saves;
+}
+
+void config_writer_end(struct config_writer *w, const struct config_writer_batch *batch,
+		       int result, uint32_t duration_us)
+{
+	if (!w->writing || batch->saves == 0) {
+		return;
+	}
+
+	w->writing = false;
+	w->commits++;
+	if (result != 0) {
+		w->failures++;
+	}
+	w->last_result = result;
+	w->last_commit_us = duration_us;
+	if (duration_us > w->max_commit_us) {
+		w->max_commit_us = duration_us;
+	}
+}
+
+void config_writer_notify(const struct config_writer_batch *batch, int result)
+{
+	for (uint8_t i = 0; i < batch->count; i++) {
+		batch->callbacks[i].fn(result, batch->callbacks[i].user_data);
+	}
+}
+
+enum config_writer_state config_writer_get_state(const struct config_writer *w)
+{
+	if (w->writing) {
+		return CONFIG_WRITER_WRITING;
+	}
+	return w->pending_saves ? CONFIG_WRITER_PENDING : CONFIG_WRITER_IDLE;
+}
+
+const char *config_writer_state_name(enum config_writer_state state)
+{
+	switch (state) {
+	case CONFIG_WRITER_IDLE:
+		return "idle";
+	case CONFIG_WRITER_PENDING:
+		return "pending";
+	case CONFIG_WRITER_WRITING:
+		return "writing";
+	default:
+		return "?";
+	}
+}
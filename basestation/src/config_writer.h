@@ -0,0 +1,141 @@
+/*
+ * Config Writer Queue
+ * Bookkeeping for asynchronous config commits
+ *
+ * Saves update the configuration in RAM right away and only request a
+ * flash commit. A low-priority writer thread later commits the latest
+ * configuration, so requests that arrive before it starts are coalesced
+ * into one flash write:
+ *
+ *   request -> PENDING -> begin (takes the waiting callbacks) -> WRITING
+ *           -> end -> IDLE, or PENDING again if more requests arrived
+ *              while writing
+ *
+ * The caller supplies locking; config_storage.c holds its storage lock
+ * around every call except config_writer_notify(), which runs the
+ * callbacks of a finished commit.
+ *
+ * Pure logic with no hardware dependencies - can be tested on host.
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef CONFIG_WRITER_H
+#define CONFIG_WRITER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* ========================================
+ * CONSTANTS
+ * ======================================== */
+
+#define CONFIG_WRITER_MAX_CALLBACKS 8   /* Waiting callbacks per commit */
+
+/* ========================================
+ * DATA STRUCTURES
+ * ======================================== */
+
+/**
+ * @brief Called once the commit covering a save has finished
+ *
+ * @param result 0 if the save is on flash, negative errno otherwise
+ * @param user_data As passed with the request
+ */
+typedef void (*config_writer_done_fn)(int result, void *user_data);
+
+struct config_writer_callback {
+	config_writer_done_fn fn;
+	void *user_data;
+};
+
+/**
+ * @brief Writer state as shown by 'status'
+ */
+enum config_writer_state {
+	CONFIG_WRITER_IDLE = 0,     /* Flash matches RAM */
+	CONFIG_WRITER_PENDING,      /* Saves waiting for the writer */
+	CONFIG_WRITER_WRITING,      /* Commit in progress (more may be pending) */
+};
+
+/**
+ * @brief Callbacks taken by config_writer_begin() for one commit
+ */
+struct config_writer_batch {
+	struct config_writer_callback callbacks[CONFIG_WRITER_MAX_CALLBACKS];
+	uint8_t count;
+	uint32_t saves;             /* Requests coalesced into this commit */
+};
+
+/**
+ * @brief Queue state
+ */
+struct config_writer {
+	struct config_writer_callback callbacks[CONFIG_WRITER_MAX_CALLBACKS];
+	uint8_t count;              /* Callbacks waiting for the next commit */
+	uint32_t pending_saves;     /* Requests since the last begin */
+	bool writing;
+
+	/* Statistics */
+	uint32_t requests;
+	uint32_t commits;
+	uint32_t failures;
+	int last_result;
+	uint32_t last_commit_us;    /* Duration of the last commit */
+	uint32_t max_commit_us;
+};
+
+/* ========================================
+ * API
+ * ======================================== */
+
+/**
+ * @brief Reset to idle with no statistics
+ */
+void config_writer_init(struct config_writer *w);
+
+/**
+ * @brief Request a commit of the current configuration
+ *
+ * @param fn Completion callback, or NULL
+ * @return 0, or -EBUSY if fn is set and CONFIG_WRITER_MAX_CALLBACKS are
+ *         already waiting (nothing is queued; retry after a commit)
+ */
+int config_writer_request(struct config_writer *w, config_writer_done_fn fn, void *user_data);
+
+/**
+ * @brief Start a commit: take the pending requests and their callbacks
+ *
+ * @param batch Output: callbacks for config_writer_end() and _notify()
+ * @return Requests covered, 0 if nothing is pending or a commit is running
+ */
+uint32_t config_writer_begin(struct config_writer *w, struct config_writer_batch *batch);
+
+/**
+ * @brief Finish a commit (statistics, back to idle or pending)
+ *
+ * @param result Result of the commit
+ * @param duration_us Time the commit took
+ */
+void config_writer_end(struct config_writer *w, const struct config_writer_batch *batch,
+		       int result, uint32_t duration_us);
+
+/**
+ * @brief Call a finished batch's callbacks with the commit result
+ *
+ * Call without the lock around the queue, so callbacks may save again.
+ */
+void config_writer_notify(const struct config_writer_batch *batch, int result);
+
+/**
+ * @brief Current state
+ */
+enum config_writer_state config_writer_get_state(const struct config_writer *w);
+
+/**
+ * @brief Name of a state, for the shell
+ */
+const char *config_writer_state_name(enum config_writer_state state);
+
+#endif /* CONFIG_WRITER_H */
@@ -0,0 +1,171 @@
+/*
+ * Derived Sources Implementation
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "derived_sources.h"
+#include "fixed_math.h"
+#include <string.h>
+
+/* ========================================
+ * HELPERS
+ * ======================================== */
+
+static int16_t clamp16(int32_t v)
+{
+	if (v > INT16_MAX) {
+		return INT16_MAX;
+	}
+	if (v < INT16_MIN) {
+		return INT16_MIN;
+	}
+	return (int16_t)v;
+}
+
+static int16_t norm3(int32_t x, int32_t y, int32_t z)
+{
+	/* Each component fits int16, so the sum of squares fits 32 bits */
+	uint32_t sq = (uint32_t)(x * x) + (uint32_t)(y * y) + (uint32_t)(z * z);
+
+	return clamp16((int32_t)fx_isqrt32(sq));
+}
+
+static void gravity_lowpass(struct derived_sources *ds, const int16_t accel_mg[3])
+{
+	for (int i = 0; i < 3; i++) {
+		int32_t in_q8 = (int32_t)accel_mg[i] * 256;
+
+		if (ds->primed) {
+			ds->gravity_q8[i] += (in_q8 - ds->gravity_q8[i]) / (1 << ds->tilt_shift);
+		} else {
+			ds->gravity_q8[i] = in_q8;
+		}
+	}
+	ds->primed = true;
+}
+
+static void energy_reset(struct derived_sources *ds)
+{
+	memset(ds->sum, 0, sizeof(ds->sum));
+	ds->sum_sq = 0;
+	ds->head = 0;
+	ds->count = 0;
+}
+
+static int16_t energy_update(struct derived_sources *ds, const int16_t accel_mg[3])
+{
+	int16_t *slot = ds->window[ds->head];
+
+	if (ds->count == DERIVED_ENERGY_WINDOW) {
+		for (int i = 0; i < 3; i++) {
+			ds->sum[i] -= slot[i];
+			ds->sum_sq -= (uint64_t)((int32_t)slot[i] * slot[i]);
+		}
+	} else {
+		ds->count++;
+	}
+
+	for (int i = 0; i < 3; i++) {
+		slot[i] = accel_mg[i];
+		ds->sum[i] += accel_mg[i];
+		ds->sum_sq += (uint64_t)((int32_t)accel_mg[i] * accel_mg[i]);
+	}
+	ds->head = (uint8_t)((ds->head + 1) % DERIVED_ENERGY_WINDOW);
+
+	/* n * variance = sum(a^2) - sum(a)^2 / n, over all three axes */
+	int64_t mean_sq = 0;
+
+	for (int i = 0; i < 3; i++) {
+		mean_sq += (int64_t)ds->sum[i] * ds->sum[i];
+	}
+	int64_t dev_sq = (int64_t)ds->sum_sq - mean_sq / ds->count;
+
+	if (dev_sq <= 0) {
+		return 0;
+	}
+	return clamp16((int32_t)fx_isqrt32((uint32_t)(dev_sq / ds->count)));
+}
+
+/* ========================================
+ * API
+ * ======================================== */
+
+void derived_sources_init(struct derived_sources *ds, uint8_t tilt_shift)
+{
+	if (!ds) {
+		return;
+	}
+
+	memset(ds, 0, sizeof(*ds));
+	ds->tilt_shift = (tilt_shift > DERIVED_TILT_MAX_SHIFT) ? DERIVED_TILT_MAX_SHIFT : tilt_shift;
+}
+
+void derived_sources_tilt(struct derived_sources *ds, const int16_t accel_mg[3],
+                          int16_t tilt_ddeg[2])
+{
+	int32_t roll_mdeg, pitch_mdeg;
+
+	if (!ds || !accel_mg || !tilt_ddeg) {
+		return;
+	}
+
+	gravity_lowpass(ds, accel_mg);
+
+	fx_tilt_mdeg(ds->gravity_q8[0], ds->gravity_q8[1], ds->gravity_q8[2],
+	             &roll_mdeg, &pitch_mdeg);
+	tilt_ddeg[0] = fx_mdeg_to_ddeg(roll_mdeg);
+	tilt_ddeg[1] = fx_mdeg_to_ddeg(pitch_mdeg);
+}
+
+void derived_sources_update(struct derived_sources *ds, int16_t values[MAX_SENSOR_SOURCES],
+                            bool have_gyro, uint16_t used_mask)
+{
+	if (!ds || !values) {
+		return;
+	}
+
+	const int16_t *a = values;
+
+	if (!have_gyro) {
+		if (used_mask & DERIVED_MASK_TILT) {
+			derived_sources_tilt(ds, a, &values[DERIVED_SLOT_ROLL]);
+		} else {
+			gravity_lowpass(ds, a);
+			values[DERIVED_SLOT_ROLL] = 0;
+			values[DERIVED_SLOT_PITCH] = 0;
+		}
+		values[DERIVED_SLOT_YAW] = 0;
+	}
+
+	memset(&values[MAX_ACCEL_SOURCES], 0, MAX_DERIVED_SOURCES * sizeof(values[0]));
+
+	if (used_mask & (1u << SOURCE_MAGNITUDE)) {
+		values[SOURCE_MAGNITUDE] = norm3(a[0], a[1], a[2]);
+	}
+
+	if ((used_mask & DERIVED_MASK_JERK) && ds->have_prev) {
+		int16_t jerk[3];
+
+		for (int i = 0; i < 3; i++) {
+			jerk[i] = clamp16((int32_t)a[i] - ds->prev_mg[i]);
+		}
+		values[SOURCE_JERK_X] = jerk[0];
+		values[SOURCE_JERK_Y] = jerk[1];
+		values[SOURCE_JERK_Z] = jerk[2];
+		values[SOURCE_JERK] = norm3(jerk[0], jerk[1], jerk[2]);
+	}
+	memcpy(ds->prev_mg, a, sizeof(ds->prev_mg));
+	ds->have_prev = true;
+
+	if (used_mask & (1u << SOURCE_ENERGY)) {
+		if (!ds->energy_on) {
+			energy_reset(ds);
+			ds->energy_on = true;
+		}
+		values[SOURCE_ENERGY] = energy_update(ds, a);
+	} else {
+		ds->energy_on = false;
+	}
+}
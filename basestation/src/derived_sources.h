@@ -0,0 +1,120 @@
+/*
+ * Derived Sources
+ * Values computed from each sample before the topology layer
+ *
+ * Tilt: roll and pitch of the low-passed gravity vector, published into
+ * the GYRO_ROLL/GYRO_PITCH sensor slots for guitars without a gyroscope.
+ * Raw XYZ mixes tilt with motion; the low-pass keeps strums and shakes
+ * from moving the tilt sources. Yaw has no gravity reference and stays 0.
+ *
+ * Motion: |a|, per-axis and total jerk (change since the previous sample)
+ * and a motion-energy envelope (RMS of a around its mean over the last
+ * DERIVED_ENERGY_WINDOW samples), published into the source slots after
+ * the sensors (SOURCE_MAGNITUDE..SOURCE_ENERGY). They are computed once
+ * per sample for all topology instances, and only when a topology reads
+ * them.
+ *
+ * Pure logic with no hardware dependencies - can be tested on host.
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef DERIVED_SOURCES_H
+#define DERIVED_SOURCES_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "topology_config.h"
+
+/* ========================================
+ * CONSTANTS
+ * ======================================== */
+
+#define DERIVED_TILT_DEFAULT_SHIFT  2   /* Gravity low-pass: 1/4 of each new sample */
+#define DERIVED_TILT_MAX_SHIFT      7   /* 1/128: ~1.3 s time constant at 100 Hz */
+
+/* Sensor slots the tilt is published into */
+#define DERIVED_SLOT_ROLL   3
+#define DERIVED_SLOT_PITCH  4
+#define DERIVED_SLOT_YAW    5
+
+#define DERIVED_ENERGY_WINDOW  16  /* Samples in the energy envelope (160 ms at 100 Hz) */
+
+/* Source mask bits for derived_sources_update() */
+#define DERIVED_MASK_TILT    ((1u << DERIVED_SLOT_ROLL) | (1u << DERIVED_SLOT_PITCH))
+#define DERIVED_MASK_JERK    ((1u << SOURCE_JERK_X) | (1u << SOURCE_JERK_Y) | \
+                              (1u << SOURCE_JERK_Z) | (1u << SOURCE_JERK))
+
+/* ========================================
+ * DATA STRUCTURES
+ * ======================================== */
+
+/**
+ * @brief Derived source state for one guitar
+ */
+struct derived_sources {
+	int32_t gravity_q8[3];    /* Low-passed accel, 1/256 milli-g */
+	uint8_t tilt_shift;       /* gravity += (accel - gravity) >> tilt_shift */
+	bool primed;              /* gravity holds at least one sample */
+
+	/* Jerk */
+	int16_t prev_mg[3];       /* Previous sample */
+	bool have_prev;
+
+	/* Energy window: running sums over the ring */
+	int16_t window[DERIVED_ENERGY_WINDOW][3];
+	int32_t sum[3];
+	uint64_t sum_sq;
+	uint8_t head;
+	uint8_t count;            /* Samples in the window, up to DERIVED_ENERGY_WINDOW */
+	bool energy_on;           /* Energy was computed for the previous sample */
+};
+
+/* ========================================
+ * API
+ * ======================================== */
+
+/**
+ * @brief Initialize derived source state
+ *
+ * @param ds Derived source state
+ * @param tilt_shift Gravity low-pass shift, 0 (no filtering) to
+ *                   DERIVED_TILT_MAX_SHIFT; larger values are clamped
+ */
+void derived_sources_init(struct derived_sources *ds, uint8_t tilt_shift);
+
+/**
+ * @brief Feed one sample to the gravity low-pass and get its tilt
+ *
+ * The first sample after init primes the filter directly.
+ *
+ * @param ds Derived source state
+ * @param accel_mg Acceleration X, Y, Z in milli-g
+ * @param tilt_ddeg Output: roll (-1800..1800) and pitch (-900..900) in decidegrees
+ */
+void derived_sources_tilt(struct derived_sources *ds, const int16_t accel_mg[3],
+                          int16_t tilt_ddeg[2]);
+
+/**
+ * @brief Fill derived source slots for one sample
+ *
+ * values[0..2] hold the raw accel. Without a gyro, the roll and pitch
+ * slots get the gravity tilt and yaw is 0; with a gyro the fused
+ * angles already in those slots are kept.
+ *
+ * Only sources with their bit set in used_mask are computed; the rest
+ * are 0. The gravity low-pass and the previous sample are always kept
+ * current, so a source switched on by a patch change is right from its
+ * first sample. The energy window restarts empty when energy is
+ * switched on.
+ *
+ * @param ds Derived source state
+ * @param values Source slots: X, Y, Z, Roll, Pitch, Yaw, then the derived sources
+ * @param have_gyro Roll/pitch/yaw slots are already filled
+ * @param used_mask Bit n set if source n is read (midi_pipeline.source_mask)
+ */
+void derived_sources_update(struct derived_sources *ds, int16_t values[MAX_SENSOR_SOURCES],
+                            bool have_gyro, uint16_t used_mask);
+
+#endif /* DERIVED_SOURCES_H */
@@ -0,0 +1,124 @@
+/*
+ * Fixed-Point Math Helpers Implementation
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "fixed_math.h"
+
+/* atan(2^-i) in degrees, Q16 */
+static const int32_t cordic_atan_q16[FX_CORDIC_ITERATIONS] = {
+	2949120, 1740967, 919879, 466945, 234379, 117304, 58666, 29335,
+	14668, 7334, 3667, 1833, 917, 458, 229, 115,
+};
+
+int32_t fx_atan2_mdeg(int32_t y, int32_t x)
+{
+	int64_t x64 = x;
+	int64_t y64 = y;
+	int32_t angle_q16 = 0;
+
+	if (x == 0 && y == 0) {
+		return 0;
+	}
+
+	/* Rotate into the right half plane */
+	if (x64 < 0) {
+		angle_q16 = (y64 >= 0) ? (180 << 16) : -(180 << 16);
+		x64 = -x64;
+		y64 = -y64;
+	}
+
+	/* Normalize to 2^27..2^28: room for CORDIC gain, bits for precision */
+	int64_t abs_y = (y64 < 0) ? -y64 : y64;
+	int64_t mag = (x64 > abs_y) ? x64 : abs_y;
+	while (mag >= (1LL << 28)) {
+		x64 >>= 1;
+		y64 >>= 1;
+		mag >>= 1;
+	}
+	for (int shift = 16; shift > 0; shift >>= 1) {
+		if (mag < (1LL << (28 - shift))) {
+			x64 *= (1LL << shift);
+			y64 *= (1LL << shift);
+			mag *= (1LL << shift);
+		}
+	}
+
+	int32_t xi = (int32_t)x64;
+	int32_t yi = (int32_t)y64;
+
+	/* Rotate toward y = 0. Branchless: the direction depends on the data,
+	 * and a mispredicted branch per iteration costs more than the math. */
+	for (int i = 0; i < FX_CORDIC_ITERATIONS; i++) {
+		int32_t xs = xi >> i;
+		int32_t ys = yi >> i;
+		int32_t neg = yi >> 31;    /* 0 if y >= 0, -1 if y < 0 */
+
+		xi += (ys ^ neg) - neg;
+		yi -= (xs ^ neg) - neg;
+		angle_q16 += (cordic_atan_q16[i] ^ neg) - neg;
+	}
+
+	/* Q16 degrees to millidegrees, rounded */
+	int64_t mdeg = (int64_t)angle_q16 * 1000;
+	mdeg = (mdeg >= 0) ? (mdeg + (1 << 15)) >> 16 : -((-mdeg + (1 << 15)) >> 16);
+
+	/* Within a few mdeg of the range: no modulo needed */
+	if (mdeg > FX_MDEG_180) {
+		mdeg -= 2 * FX_MDEG_180;
+	} else if (mdeg < -FX_MDEG_180) {
+		mdeg += 2 * FX_MDEG_180;
+	}
+	return (int32_t)mdeg;
+}
+
+int32_t fx_wrap_mdeg(int32_t mdeg)
+{
+	mdeg %= 2 * FX_MDEG_180;
+	if (mdeg > FX_MDEG_180) {
+		mdeg -= 2 * FX_MDEG_180;
+	} else if (mdeg < -FX_MDEG_180) {
+		mdeg += 2 * FX_MDEG_180;
+	}
+	return mdeg;
+}
+
+void fx_tilt_mdeg(int32_t x, int32_t y, int32_t z, int32_t *roll_mdeg, int32_t *pitch_mdeg)
+{
+	*roll_mdeg = fx_atan2_mdeg(y, z);
+
+	/* Scale all three alike until y^2 + z^2 fits 32 bits */
+	while (y > 32767 || y < -32767 || z > 32767 || z < -32767 || x > INT32_MAX / 2 ||
+	       x < -INT32_MAX / 2) {
+		x /= 2;
+		y /= 2;
+		z /= 2;
+	}
+
+	uint32_t yz2 = (uint32_t)(y * y) + (uint32_t)(z * z);
+	*pitch_mdeg = fx_atan2_mdeg(-x, (int32_t)fx_isqrt32(yz2));
+}
+
+uint32_t fx_isqrt32(uint32_t value)
+{
+	uint32_t root = 0;
+	uint32_t bit = 1u << 30;
+
+	while (bit > value) {
+		bit >>= 2;
+	}
+
+	while (bit != 0) {
+		if (value >= root + bit) {
+			value -= root + bit;
+			root = (root >> 1) + bit;
+		} else {
+			root >>= 1;
+		}
+		bit >>= 2;
+	}
+
+	return root;
+}
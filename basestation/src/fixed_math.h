@@ -0,0 +1,80 @@
+/*
+ * Fixed-Point Math Helpers
+ * Integer angle and square root functions for per-sample motion processing
+ *
+ * No libm and no floating point, so they cost the same on the Cortex-M33
+ * with or without the FPU context enabled in the BLE thread.
+ *
+ * Pure logic with no hardware dependencies - can be tested on host.
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef FIXED_MATH_H
+#define FIXED_MATH_H
+
+#include <stdint.h>
+
+/* ========================================
+ * CONSTANTS
+ * ======================================== */
+
+#define FX_MDEG_180  180000   /* Half turn in millidegrees */
+#define FX_MDEG_90   90000
+#define FX_CORDIC_ITERATIONS 16
+
+/* ========================================
+ * API
+ * ======================================== */
+
+/**
+ * @brief Four-quadrant arctangent
+ *
+ * CORDIC in vectoring mode; error below 2 millidegrees.
+ *
+ * @param y Y component (any int32)
+ * @param x X component (any int32)
+ * @return Angle of (x, y) in millidegrees, -180000 to 180000 (0 if both are 0)
+ */
+int32_t fx_atan2_mdeg(int32_t y, int32_t x);
+
+/**
+ * @brief Wrap an angle to -180000..180000 millidegrees
+ *
+ * @param mdeg Angle in millidegrees
+ * @return Equivalent angle in range
+ */
+int32_t fx_wrap_mdeg(int32_t mdeg);
+
+/**
+ * @brief Roll and pitch of a gravity vector
+ *
+ * roll = atan2(y, z), pitch = atan2(-x, sqrt(y^2 + z^2)); the guitar
+ * frame used by the GYRO_ROLL/PITCH sources.
+ *
+ * @param x X component (any unit and scale, e.g. milli-g or Q8 milli-g)
+ * @param y Y component
+ * @param z Z component
+ * @param roll_mdeg Output: roll in millidegrees, -180000 to 180000
+ * @param pitch_mdeg Output: pitch in millidegrees, -90000 to 90000
+ */
+void fx_tilt_mdeg(int32_t x, int32_t y, int32_t z, int32_t *roll_mdeg, int32_t *pitch_mdeg);
+
+/**
+ * @brief Millidegrees to decidegrees, rounded half away from zero
+ */
+static inline int16_t fx_mdeg_to_ddeg(int32_t mdeg)
+{
+	return (int16_t)((mdeg >= 0) ? (mdeg + 50) / 100 : (mdeg - 50) / 100);
+}
+
+/**
+ * @brief Integer square root
+ *
+ * @param value Input
+ * @return floor(sqrt(value))
+ */
+uint32_t fx_isqrt32(uint32_t value);
+
+#endif /* FIXED_MATH_H */
@@ -0,0 +1,229 @@
+/*
+ * Flash Simulator Implementation
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "flash_sim.h"
+#include <errno.h>
+#include <string.h>
+
+#define ERASED_BYTE 0xFF
+
+static uint32_t next_random(struct flash_sim *sim)
+{
+	sim->rng = sim->rng * 1664525u + 1013904223u;
+	return sim->rng >> 8;
+}
+
+static bool in_range(const struct flash_sim *sim, uint32_t offset, size_t len)
+{
+	return offset >= sim->base && len <= sim->size && offset - sim->base <= sim->size - len;
+}
+
+/**
+ * @brief Count down one program/erase unit
+ *
+ * @return true if the unit completes, false if power is lost during it
+ */
+static bool consume_unit(struct flash_sim *sim)
+{
+	if (sim->units_before_loss == FLASH_SIM_NO_POWER_LOSS) {
+		return true;
+	}
+	if (sim->units_before_loss == 0) {
+		sim->powered = false;
+		sim->units_before_loss = FLASH_SIM_NO_POWER_LOSS;
+		return false;
+	}
+	sim->units_before_loss--;
+	return true;
+}
+
+static void add_busy(struct flash_sim *sim, uint32_t us)
+{
+	sim->stats.busy_us += us;
+	if (us > sim->stats.max_stall_us) {
+		sim->stats.max_stall_us = us;
+	}
+}
+
+static int sim_read(void *ctx, uint32_t offset, void *buf, size_t len)
+{
+	struct flash_sim *sim = ctx;
+	uint8_t *out = buf;
+
+	if (!sim->powered) {
+		return -EIO;
+	}
+	if (!in_range(sim, offset, len)) {
+		return -EINVAL;
+	}
+
+	memcpy(out, &sim->mem[offset - sim->base], len);
+	sim->stats.bytes_read += len;
+
+	for (size_t i = 0; sim->read_flip_ppm && i < len; i++) {
+		if (next_random(sim) % 1000000u < sim->read_flip_ppm) {
+			out[i] ^= (uint8_t)(1u << (next_random(sim) % 8));
+			sim->stats.read_flips++;
+		}
+	}
+	return 0;
+}
+
+static int sim_write(void *ctx, uint32_t offset, const void *buf, size_t len)
+{
+	struct flash_sim *sim = ctx;
+	const uint8_t *in = buf;
+
+	if (!sim->powered) {
+		return -EIO;
+	}
+	if (!in_range(sim, offset, len) || offset % FLASH_SIM_WRITE_BLOCK ||
+	    len % FLASH_SIM_WRITE_BLOCK) {
+		sim->stats.violations++;
+		return -EINVAL;
+	}
+
+	uint8_t *mem = &sim->mem[offset - sim->base];
+
+	for (size_t i = 0; i < len; i++) {
+		if (mem[i] != ERASED_BYTE) {
+			sim->stats.violations++;
+			return -EIO;
+		}
+	}
+
+	for (size_t pos = 0; pos < len; pos += FLASH_SIM_WRITE_BLOCK) {
+		if (!consume_unit(sim)) {
+			/* Torn word: the first half of its bytes made it */
+			memcpy(&mem[pos], &in[pos], FLASH_SIM_WRITE_BLOCK / 2);
+			return -EIO;
+		}
+		memcpy(&mem[pos], &in[pos], FLASH_SIM_WRITE_BLOCK);
+		sim->stats.blocks_written++;
+		add_busy(sim, sim->write_block_us);
+	}
+	return 0;
+}
+
+static int sim_erase(void *ctx, uint32_t offset, size_t len)
+{
+	struct flash_sim *sim = ctx;
+
+	if (!sim->powered) {
+		return -EIO;
+	}
+	if (!in_range(sim, offset, len) || (offset - sim->base) % FLASH_SIM_PAGE_SIZE ||
+	    len % FLASH_SIM_PAGE_SIZE) {
+		sim->stats.violations++;
+		return -EINVAL;
+	}
+
+	/* One slice per unit; a whole-page erase is a single slice */
+	uint32_t slice_us = sim->erase_slice_us ? sim->erase_slice_us : sim->erase_page_us;
+	uint32_t slices = (sim->erase_page_us + slice_us - 1) / slice_us;
+
+	for (size_t pos = 0; pos < len; pos += FLASH_SIM_PAGE_SIZE) {
+		uint32_t page = (offset - sim->base + pos) / FLASH_SIM_PAGE_SIZE;
+		uint8_t *mem = &sim->mem[page * FLASH_SIM_PAGE_SIZE];
+		uint32_t left = sim->erase_page_us;
+
+		for (uint32_t i = 0; i < slices; i++) {
+			if (!consume_unit(sim)) {
+				/* Interrupted erase: only part of the page reached 0xFF */
+				memset(mem, ERASED_BYTE, FLASH_SIM_PAGE_SIZE / 2);
+				sim->erase_counts[page]++;
+				return -EIO;
+			}
+			uint32_t step = (left < slice_us) ? left : slice_us;
+
+			add_busy(sim, step);
+			left -= step;
+		}
+		memset(mem, ERASED_BYTE, FLASH_SIM_PAGE_SIZE);
+		sim->erase_counts[page]++;
+		sim->stats.page_erases++;
+	}
+	return 0;
+}
+
+int flash_sim_init(struct flash_sim *sim, uint8_t *mem, uint32_t *erase_counts,
+		   uint32_t base, uint32_t size)
+{
+	if (!sim || !mem || !erase_counts || size == 0 || size % FLASH_SIM_PAGE_SIZE) {
+		return -EINVAL;
+	}
+
+	memset(sim, 0, sizeof(*sim));
+	sim->mem = mem;
+	sim->erase_counts = erase_counts;
+	sim->base = base;
+	sim->size = size;
+	sim->erase_page_us = FLASH_SIM_ERASE_PAGE_US;
+	sim->write_block_us = FLASH_SIM_WRITE_BLOCK_US;
+	sim->powered = true;
+	sim->units_before_loss = FLASH_SIM_NO_POWER_LOSS;
+
+	memset(mem, ERASED_BYTE, size);
+	memset(erase_counts, 0, (size / FLASH_SIM_PAGE_SIZE) * sizeof(*erase_counts));
+
+	sim->backend.read = sim_read;
+	sim->backend.write = sim_write;
+	sim->backend.erase = sim_erase;
+	sim->backend.ctx = sim;
+	sim->backend.write_block_size = FLASH_SIM_WRITE_BLOCK;
+	sim->backend.page_size = FLASH_SIM_PAGE_SIZE;
+	return 0;
+}
+
+const struct storage_backend *flash_sim_backend(struct flash_sim *sim)
+{
+	return &sim->backend;
+}
+
+void flash_sim_power_loss_after(struct flash_sim *sim, int32_t count)
+{
+	sim->units_before_loss = (count < 0) ? FLASH_SIM_NO_POWER_LOSS : count;
+}
+
+void flash_sim_power_on(struct flash_sim *sim)
+{
+	sim->powered = true;
+}
+
+void flash_sim_set_erase_slice(struct flash_sim *sim, uint32_t slice_us)
+{
+	sim->erase_slice_us = slice_us;
+}
+
+int flash_sim_flip_bit(struct flash_sim *sim, uint32_t addr, uint8_t bit)
+{
+	if (!in_range(sim, addr, 1) || bit > 7) {
+		return -EINVAL;
+	}
+
+	sim->mem[addr - sim->base] ^= (uint8_t)(1u << bit);
+	return 0;
+}
+
+void flash_sim_set_read_flips(struct flash_sim *sim, uint32_t ppm, uint32_t seed)
+{
+	sim->read_flip_ppm = ppm;
+	sim->rng = seed;
+}
+
+void flash_sim_reset_stats(struct flash_sim *sim)
+{
+	memset(&sim->stats, 0, sizeof(sim->stats));
+}
+
+uint32_t flash_sim_erase_count(const struct flash_sim *sim, uint32_t addr)
+{
+	if (!in_range(sim, addr, 1)) {
+		return 0;
+	}
+	return sim->erase_counts[(addr - sim->base) / FLASH_SIM_PAGE_SIZE];
+}
@@ -0,0 +1,160 @@
+/*
+ * Flash Simulator
+ * RAM-backed NOR flash behind a storage_backend, with timing and faults
+ *
+ * Models the nRF5340 internal flash as config_storage.c uses it:
+ * - erase-before-write: a write over any byte that is not erased fails
+ *   with -EIO and is counted as a violation
+ * - writes must be aligned to the write block (4 bytes), erases to pages
+ * - every page erase and block write adds the datasheet time to a modeled
+ *   clock (reads are memory mapped and cost nothing)
+ * - erase counts per page, for wear distribution
+ * - optional partial erase (NVMC ERASEPAGEPARTIAL): a page erase runs in
+ *   slices of a set duration, and the CPU is only stalled one slice at a
+ *   time; stats.max_stall_us is the longest single stall
+ *
+ * Faults:
+ * - power loss after N more program/erase units (block writes, page
+ *   erases or erase slices): the next block write is torn (first half of
+ *   its bytes programmed) or the erase stops half way, and every access
+ *   fails with -EIO until power is restored
+ * - a persistent bit flip at an address (retention failure)
+ * - random transient bit flips on reads, at a rate in parts per million
+ *   per byte, from a seeded generator so runs are reproducible
+ *
+ * Memory and erase counters are supplied by the caller.
+ *
+ * Pure logic with no hardware dependencies - can be tested on host.
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef FLASH_SIM_H
+#define FLASH_SIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "storage_backend.h"
+
+/* ========================================
+ * CONSTANTS
+ * ======================================== */
+
+/* nRF5340 application core internal flash (Product Specification, NVMC) */
+#define FLASH_SIM_PAGE_SIZE      4096
+#define FLASH_SIM_WRITE_BLOCK    4
+#define FLASH_SIM_ERASE_PAGE_US  87500   /* tERASEPAGE, max */
+#define FLASH_SIM_WRITE_BLOCK_US 41      /* tWRITE per 32-bit word, max */
+
+#define FLASH_SIM_NO_POWER_LOSS  (-1)
+
+/* ========================================
+ * DATA STRUCTURES
+ * ======================================== */
+
+/**
+ * @brief Counters since init or flash_sim_reset_stats()
+ */
+struct flash_sim_stats {
+	uint64_t busy_us;          /* Modeled erase and write time */
+	uint32_t page_erases;
+	uint32_t blocks_written;
+	uint32_t bytes_read;
+	uint32_t violations;       /* Rejected writes/erases: unerased target or misaligned */
+	uint32_t read_flips;       /* Transient bit flips injected on reads */
+	uint32_t max_stall_us;     /* Longest uninterruptible write or erase step */
+};
+
+/**
+ * @brief Simulated flash device
+ */
+struct flash_sim {
+	uint8_t *mem;              /* size bytes */
+	uint32_t *erase_counts;    /* One per page, lifetime */
+	uint32_t base;             /* Address of mem[0] */
+	uint32_t size;
+	uint32_t erase_page_us;
+	uint32_t write_block_us;
+	uint32_t erase_slice_us;   /* 0: whole-page erases */
+
+	bool powered;
+	int32_t units_before_loss; /* FLASH_SIM_NO_POWER_LOSS, or units still completed */
+	uint32_t read_flip_ppm;
+	uint32_t rng;
+
+	struct flash_sim_stats stats;
+	struct storage_backend backend;
+};
+
+/* ========================================
+ * API
+ * ======================================== */
+
+/**
+ * @brief Initialize an erased simulator with nRF5340 geometry and timing
+ *
+ * @param sim Simulator
+ * @param mem Backing memory, size bytes
+ * @param erase_counts size / FLASH_SIM_PAGE_SIZE counters
+ * @param base Flash address of the first byte (e.g. the config partition)
+ * @param size Bytes, a multiple of FLASH_SIM_PAGE_SIZE
+ * @return 0 on success, -EINVAL on bad arguments
+ */
+int flash_sim_init(struct flash_sim *sim, uint8_t *mem, uint32_t *erase_counts,
+		   uint32_t base, uint32_t size);
+
+/**
+ * @brief Backend to hand to config_area (valid while sim is)
+ */
+const struct storage_backend *flash_sim_backend(struct flash_sim *sim);
+
+/**
+ * @brief Cut power after count more block writes/page erases complete
+ *
+ * @param count Units that still complete; FLASH_SIM_NO_POWER_LOSS disarms
+ */
+void flash_sim_power_loss_after(struct flash_sim *sim, int32_t count);
+
+/**
+ * @brief Restore power (contents stay as they were at the cut)
+ */
+void flash_sim_power_on(struct flash_sim *sim);
+
+/**
+ * @brief Erase pages in slices of slice_us (partial erase)
+ *
+ * The page is only erased once all slices have run; a power cut before
+ * that leaves it half erased.
+ *
+ * @param slice_us Slice duration, 0 for whole-page erases
+ */
+void flash_sim_set_erase_slice(struct flash_sim *sim, uint32_t slice_us);
+
+/**
+ * @brief Flip one stored bit
+ *
+ * @return 0, or -EINVAL if addr is outside the device
+ */
+int flash_sim_flip_bit(struct flash_sim *sim, uint32_t addr, uint8_t bit);
+
+/**
+ * @brief Flip random bits in data returned by reads
+ *
+ * @param ppm Chance per byte read, in parts per million (0 disables)
+ * @param seed Generator seed
+ */
+void flash_sim_set_read_flips(struct flash_sim *sim, uint32_t ppm, uint32_t seed);
+
+/**
+ * @brief Clear the counters in stats (erase counts are kept)
+ */
+void flash_sim_reset_stats(struct flash_sim *sim);
+
+/**
+ * @brief Lifetime erase count of the page holding addr, or 0 if outside
+ */
+uint32_t flash_sim_erase_count(const struct flash_sim *sim, uint32_t addr);
+
+#endif /* FLASH_SIM_H */
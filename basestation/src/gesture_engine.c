@@ -0,0 +1,396 @@
+/*
+ * Gesture Engine Implementation
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "gesture_engine.h"
+#include "fixed_math.h"
+#include <string.h>
+
+#define MIDI_NOTE_OFF        0x80
+#define MIDI_NOTE_ON         0x90
+#define MIDI_CONTROL_CHANGE  0xB0
+#define MIDI_PROGRAM_CHANGE  0xC0
+
+/* Template shapes, peak at GESTURE_TEMPLATE_PEAK */
+static const int8_t flick_template[GESTURE_TEMPLATE_LEN] = {2, 6, 8, 3, -3, -7, -5, -1};
+static const int8_t tap_template[GESTURE_TEMPLATE_LEN] = {0, 3, 8, -4, 2, -1, 0, 0};
+
+/* ========================================
+ * HELPERS
+ * ======================================== */
+
+static bool slot_valid(const struct gesture_slot *slot)
+{
+	return slot->type > GESTURE_NONE && slot->type < GESTURE_TYPE_COUNT &&
+	       slot->source < MAX_SENSOR_SOURCES &&
+	       slot->action < GESTURE_ACTION_COUNT &&
+	       slot->number <= 127 && slot->threshold > 0 && slot->velocity_curve <= 127;
+}
+
+/* (level - threshold) over the span above it, 0..256 */
+static uint16_t strength_q8(int32_t level, int32_t threshold)
+{
+	int32_t s = (level - threshold) * 256 / (threshold * (GESTURE_VELOCITY_SPAN - 1));
+
+	if (s < 0) {
+		return 0;
+	}
+	return (s > 256) ? 256 : (uint16_t)s;
+}
+
+static int emit(struct gesture_event *events, int n, uint8_t slot,
+                uint8_t status, uint8_t data1, uint8_t data2, uint8_t len)
+{
+	if (n >= GESTURE_MAX_EVENTS) {
+		return n;
+	}
+
+	events[n].slot = slot;
+	events[n].len = len;
+	events[n].msg[0] = status;
+	events[n].msg[1] = data1;
+	events[n].msg[2] = data2;
+	return n + 1;
+}
+
+static int note_off(struct gesture_slot_state *st, uint8_t idx, uint8_t channel,
+                    struct gesture_event *events, int n)
+{
+	st->sounding = false;
+	st->hold = 0;
+	return emit(events, n, idx, MIDI_NOTE_OFF | channel, st->note, 0, 3);
+}
+
+static int fire(struct gesture_engine *ge, uint8_t idx, const struct gesture_slot *slot,
+                int32_t level, bool one_shot, uint8_t channel,
+                struct gesture_event *events, int n)
+{
+	struct gesture_slot_state *st = &ge->slots[idx];
+
+	ge->triggers++;
+
+	switch (slot->action) {
+	case GESTURE_ACTION_NOTE: {
+		uint8_t velocity = gesture_velocity(strength_q8(level, slot->threshold *
+		                                                GESTURE_THRESHOLD_UNIT),
+		                                    slot->velocity_curve);
+
+		if (st->sounding) {
+			n = note_off(st, idx, channel, events, n);
+		}
+		st->note = slot->number;
+		st->sounding = true;
+		st->hold = one_shot ? GESTURE_NOTE_SAMPLES : 0;
+		return emit(events, n, idx, MIDI_NOTE_ON | channel, slot->number, velocity, 3);
+	}
+	case GESTURE_ACTION_PROGRAM:
+		return emit(events, n, idx, MIDI_PROGRAM_CHANGE | channel, slot->number, 0, 2);
+	case GESTURE_ACTION_CC_TOGGLE:
+		st->toggled = !st->toggled;
+		return emit(events, n, idx, MIDI_CONTROL_CHANGE | channel, slot->number,
+		            st->toggled ? 127 : 0, 3);
+	default:
+		return n;
+	}
+}
+
+/* FLICK/TAP: is the window, peak at GESTURE_TEMPLATE_PEAK, the template's shape? */
+static bool template_match(const struct gesture_slot_state *st, const int8_t *tmpl,
+                           int32_t threshold, int32_t *peak)
+{
+	int32_t p = st->window[(st->head + GESTURE_TEMPLATE_PEAK) % GESTURE_TEMPLATE_LEN];
+	int32_t ap = (p < 0) ? -p : p;
+	int64_t dot = 0;
+	int64_t xx = 0;
+	int64_t tt = 0;
+
+	if (ap < threshold) {
+		return false;
+	}
+
+	for (int i = 0; i < GESTURE_TEMPLATE_LEN; i++) {
+		int32_t x = st->window[(st->head + i) % GESTURE_TEMPLATE_LEN];
+
+		if (x > ap || -x > ap) {
+			return false;    /* Peak not where the template has it */
+		}
+		dot += (int64_t)x * tmpl[i];
+		xx += (int64_t)x * x;
+		tt += tmpl[i] * tmpl[i];
+	}
+
+	/* |dot| / (|x| |t|) >= MIN_PCT / 100, in integers */
+	*peak = ap;
+	return dot * dot * 10000 >= (int64_t)GESTURE_MATCH_MIN_PCT * GESTURE_MATCH_MIN_PCT * xx * tt;
+}
+
+static int process_slot(struct gesture_engine *ge, uint8_t idx, const struct gesture_slot *slot,
+                        const int16_t values[MAX_SENSOR_SOURCES], uint8_t channel,
+                        struct gesture_event *events, int n)
+{
+	struct gesture_slot_state *st = &ge->slots[idx];
+	int32_t v = values[slot->source];
+	int32_t a = (v < 0) ? -v : v;
+	int32_t threshold = slot->threshold * GESTURE_THRESHOLD_UNIT;
+
+	if (st->refractory > 0) {
+		st->refractory--;
+	}
+	if (st->hold > 0 && --st->hold == 0 && st->sounding) {
+		n = note_off(st, idx, channel, events, n);
+	}
+	if (st->remote) {
+		return n;
+	}
+
+	switch (slot->type) {
+	case GESTURE_STRUM:
+		if (!st->armed) {
+			if (st->refractory == 0 && a >= threshold) {
+				st->armed = true;
+				st->peak = (int16_t)((a > INT16_MAX) ? INT16_MAX : a);
+				st->wait = 0;
+			}
+			break;
+		}
+		if (a > st->peak) {
+			st->peak = (int16_t)((a > INT16_MAX) ? INT16_MAX : a);
+			if (++st->wait < GESTURE_PEAK_WAIT_SAMPLES) {
+				break;
+			}
+		}
+		n = fire(ge, idx, slot, st->peak, true, channel, events, n);
+		st->armed = false;
+		st->refractory = GESTURE_REFRACTORY_SAMPLES;
+		break;
+
+	case GESTURE_SHAKE:
+	case GESTURE_TILT:
+		if (!st->armed) {
+			if (st->refractory == 0 && a >= threshold) {
+				st->armed = true;
+				st->wait = 0;
+				n = fire(ge, idx, slot, a, false, channel, events, n);
+			}
+			break;
+		}
+		if (a >= threshold / 2) {
+			st->wait = 0;
+		} else if (++st->wait >= GESTURE_RELEASE_SAMPLES) {
+			if (st->sounding) {
+				n = note_off(st, idx, channel, events, n);
+			}
+			st->armed = false;
+			st->refractory = GESTURE_REFRACTORY_SAMPLES;
+		}
+		break;
+
+	case GESTURE_FLICK:
+	case GESTURE_TAP: {
+		int32_t peak;
+
+		st->window[st->head] = (int16_t)v;
+		st->head = (st->head + 1) % GESTURE_TEMPLATE_LEN;
+		if (st->filled < GESTURE_TEMPLATE_LEN) {
+			st->filled++;
+			break;
+		}
+		if (st->refractory == 0 &&
+		    template_match(st, (slot->type == GESTURE_FLICK) ? flick_template : tap_template,
+		                   threshold, &peak)) {
+			n = fire(ge, idx, slot, peak, true, channel, events, n);
+			st->refractory = GESTURE_REFRACTORY_SAMPLES;
+		}
+		break;
+	}
+
+	default:
+		break;
+	}
+
+	return n;
+}
+
+/* ========================================
+ * API
+ * ======================================== */
+
+void gesture_engine_init(struct gesture_engine *ge)
+{
+	if (ge) {
+		memset(ge, 0, sizeof(*ge));
+	}
+}
+
+bool gesture_config_validate(const struct gesture_config *cfg)
+{
+	if (!cfg) {
+		return false;
+	}
+
+	for (int i = 0; i < GESTURE_SLOTS; i++) {
+		if (cfg->slots[i].type != GESTURE_NONE && !slot_valid(&cfg->slots[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+uint8_t gesture_velocity(uint16_t strength_q8, uint8_t curve)
+{
+	uint32_t s = (strength_q8 > 256) ? 256 : strength_q8;
+	uint32_t f;
+
+	if (curve > 127) {
+		curve = 127;
+	}
+
+	if (curve < GESTURE_VELOCITY_LINEAR) {
+		/* Blend toward s^2: more force for the same velocity */
+		uint32_t w = GESTURE_VELOCITY_LINEAR - curve;
+		uint32_t sq = s * s / 256;
+
+		f = (s * (GESTURE_VELOCITY_LINEAR - w) + sq * w) / GESTURE_VELOCITY_LINEAR;
+	} else {
+		/* Blend toward sqrt(s): less force for the same velocity */
+		uint32_t w = curve - GESTURE_VELOCITY_LINEAR;
+		uint32_t rt = fx_isqrt32(s * 256);
+
+		f = (s * (63 - w) + rt * w) / 63;
+	}
+
+	uint32_t velocity = 1 + (126 * f + 128) / 256;
+	return (velocity > 127) ? 127 : (uint8_t)velocity;
+}
+
+int gesture_engine_process(struct gesture_engine *ge, const struct gesture_config *cfg,
+                           const int16_t values[MAX_SENSOR_SOURCES], uint8_t channel,
+                           struct gesture_event events[GESTURE_MAX_EVENTS])
+{
+	int n = 0;
+
+	if (!ge || !cfg || !values || !events) {
+		return 0;
+	}
+
+	channel &= 0x0F;
+
+	for (uint8_t i = 0; i < GESTURE_SLOTS; i++) {
+		struct gesture_slot_state *st = &ge->slots[i];
+
+		if (st->off_pending) {
+			st->off_pending = false;
+			n = emit(events, n, i, MIDI_NOTE_OFF | channel, st->note, 0, 3);
+		}
+
+		if (!slot_valid(&cfg->slots[i])) {
+			/* Slot removed or invalid: end its note and start over */
+			if (st->sounding) {
+				n = note_off(st, i, channel, events, n);
+			}
+			memset(st, 0, sizeof(*st));
+			continue;
+		}
+
+		n = process_slot(ge, i, &cfg->slots[i], values, channel, events, n);
+	}
+
+	return n;
+}
+
+int gesture_engine_remote_event(struct gesture_engine *ge, const struct gesture_config *cfg,
+                                uint8_t type, bool end, int32_t level, uint8_t channel,
+                                struct gesture_event events[GESTURE_MAX_EVENTS])
+{
+	int n = 0;
+
+	if (!ge || !cfg || !events || type == GESTURE_NONE) {
+		return 0;
+	}
+
+	channel &= 0x0F;
+	if (level < 0) {
+		level = -level;
+	}
+
+	for (uint8_t i = 0; i < GESTURE_SLOTS; i++) {
+		const struct gesture_slot *slot = &cfg->slots[i];
+		struct gesture_slot_state *st = &ge->slots[i];
+
+		if (st->off_pending) {
+			st->off_pending = false;
+			n = emit(events, n, i, MIDI_NOTE_OFF | channel, st->note, 0, 3);
+		}
+		if (slot->type != type || !slot_valid(slot)) {
+			continue;
+		}
+
+		st->remote = true;
+		st->armed = false;
+		if (!end) {
+			n = fire(ge, i, slot, level, false, channel, events, n);
+		} else if (st->sounding) {
+			n = note_off(st, i, channel, events, n);
+		}
+	}
+
+	return n;
+}
+
+int gesture_engine_release(struct gesture_engine *ge, uint8_t channel,
+                           struct gesture_event events[GESTURE_MAX_EVENTS])
+{
+	int n = 0;
+
+	if (!ge || !events) {
+		return 0;
+	}
+
+	channel &= 0x0F;
+
+	for (uint8_t i = 0; i < GESTURE_SLOTS; i++) {
+		struct gesture_slot_state *st = &ge->slots[i];
+
+		if (st->sounding || st->off_pending) {
+			n = emit(events, n, i, MIDI_NOTE_OFF | channel, st->note, 0, 3);
+		}
+		memset(st, 0, sizeof(*st));
+	}
+
+	return n;
+}
+
+void gesture_engine_tx_failed(struct gesture_engine *ge, const struct gesture_event *ev)
+{
+	if (!ge || !ev || ev->slot >= GESTURE_SLOTS) {
+		return;
+	}
+
+	if ((ev->msg[0] & 0xF0) == MIDI_NOTE_OFF) {
+		ge->slots[ev->slot].off_pending = true;
+		ge->slots[ev->slot].note = ev->msg[1];
+	}
+}
+
+const char *gesture_type_name(uint8_t type)
+{
+	switch (type) {
+	case GESTURE_NONE:
+		return "NONE";
+	case GESTURE_STRUM:
+		return "STRUM";
+	case GESTURE_SHAKE:
+		return "SHAKE";
+	case GESTURE_FLICK:
+		return "FLICK";
+	case GESTURE_TAP:
+		return "TAP";
+	case GESTURE_TILT:
+		return "TILT";
+	default:
+		return "UNKNOWN";
+	}
+}
@@ -0,0 +1,244 @@
+/*
+ * Gesture Engine
+ * Event detection on the source slots: MIDI notes and triggers from
+ * strums, shakes, flicks and taps
+ *
+ * Each patch has GESTURE_SLOTS gesture slots. A slot watches one source
+ * (any index a topology can read, see topology_config.h) and fires its
+ * action when the gesture is detected:
+ *
+ * - STRUM: threshold crossing, then fire at the peak. The peak sets the
+ *   velocity.
+ * - SHAKE: sustained, with hysteresis. It starts at the threshold and ends
+ *   after GESTURE_RELEASE_SAMPLES samples below half of it. Meant for
+ *   SOURCE_ENERGY.
+ * - TILT: detected as SHAKE is, meant for the roll and pitch sources.
+ * - FLICK / TAP: normalized correlation of the last GESTURE_TEMPLATE_LEN
+ *   samples against a fixed shape, checked when the window's peak sample
+ *   reaches the threshold. FLICK is an out-and-back swing, TAP a single
+ *   sharp hit that dies away. Meant for the jerk sources. Either polarity
+ *   matches.
+ *
+ * After firing, a slot stays quiet for a refractory period. Every slot
+ * does a fixed amount of work per sample, so the cost per sample is
+ * bounded by GESTURE_SLOTS.
+ *
+ * Time is counted in samples (10 ms at the client's 100 Hz).
+ *
+ * Clients in edge event mode detect tap, shake and tilt themselves, on
+ * samples faster than they stream, and send only the start and end of
+ * each gesture. gesture_engine_remote_event() plays these through the
+ * slots of the same type; from the first one on, those slots ignore the
+ * streamed samples so a gesture never sounds twice.
+ *
+ * Pure logic with no hardware dependencies - can be tested on host.
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef GESTURE_ENGINE_H
+#define GESTURE_ENGINE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "topology_config.h"
+
+/* ========================================
+ * CONSTANTS
+ * ======================================== */
+
+#define GESTURE_SLOTS              3    /* Gesture slots per patch */
+#define GESTURE_MAX_EVENTS         (2 * GESTURE_SLOTS)  /* Per sample: note off + note on per slot */
+
+#define GESTURE_THRESHOLD_UNIT     16   /* gesture_slot.threshold step, in source units */
+#define GESTURE_VELOCITY_SPAN      4    /* Peak of threshold * span gives velocity 127 */
+#define GESTURE_VELOCITY_LINEAR    64   /* velocity_curve: linear response */
+
+#define GESTURE_REFRACTORY_SAMPLES 8    /* Quiet time after a one-shot gesture */
+#define GESTURE_PEAK_WAIT_SAMPLES  4    /* STRUM fires at the latest this long after crossing */
+#define GESTURE_NOTE_SAMPLES       8    /* One-shot note length (ends as refractory does) */
+#define GESTURE_RELEASE_SAMPLES    4    /* SHAKE ends after this long below threshold / 2 */
+#define GESTURE_TEMPLATE_LEN       8    /* FLICK/TAP window */
+#define GESTURE_TEMPLATE_PEAK      2    /* Window index of the template's peak */
+#define GESTURE_MATCH_MIN_PCT      75   /* Minimum |correlation| for a template match */
+
+enum gesture_type {
+	GESTURE_NONE = 0,       /* Slot unused */
+	GESTURE_STRUM,
+	GESTURE_SHAKE,
+	GESTURE_FLICK,
+	GESTURE_TAP,
+	GESTURE_TILT,
+	GESTURE_TYPE_COUNT
+};
+
+enum gesture_action {
+	GESTURE_ACTION_NOTE = 0,    /* Note On with velocity, Note Off when done */
+	GESTURE_ACTION_PROGRAM,     /* Program Change */
+	GESTURE_ACTION_CC_TOGGLE,   /* CC alternating 127 / 0 */
+	GESTURE_ACTION_COUNT
+};
+
+/* ========================================
+ * DATA STRUCTURES
+ * ======================================== */
+
+/**
+ * @brief One gesture slot of a patch (stored in flash)
+ */
+struct gesture_slot {
+	uint8_t type;           /* enum gesture_type */
+	uint8_t source;         /* Source index (0 to MAX_SENSOR_SOURCES-1) */
+	uint8_t action;         /* enum gesture_action */
+	uint8_t number;         /* Note, program or CC number (0-127) */
+	uint8_t threshold;      /* Trigger level in GESTURE_THRESHOLD_UNIT steps (1-255) */
+	uint8_t velocity_curve; /* 0 = hard, 64 = linear, 127 = soft */
+} __attribute__((packed));
+
+/**
+ * @brief Gesture configuration of a patch
+ */
+struct gesture_config {
+	struct gesture_slot slots[GESTURE_SLOTS];
+} __attribute__((packed));
+
+/**
+ * @brief Detection state of one slot
+ */
+struct gesture_slot_state {
+	int16_t window[GESTURE_TEMPLATE_LEN];  /* FLICK/TAP: last samples */
+	uint8_t head;
+	uint8_t filled;
+	uint8_t refractory;     /* Samples until the slot may fire again */
+	uint8_t wait;           /* STRUM: samples since the crossing; SHAKE: samples below release */
+	uint8_t hold;           /* Samples until the one-shot note ends */
+	int16_t peak;           /* STRUM: largest |value| since the crossing */
+	bool armed;             /* STRUM: crossed, waiting for the peak; SHAKE: active */
+	bool sounding;          /* Note On sent, Note Off due */
+	bool off_pending;       /* Note Off was rejected by TX, resend */
+	bool toggled;           /* CC toggle state */
+	bool remote;            /* Detected by the client: local detection off */
+	uint8_t note;           /* Note number sounding */
+};
+
+/**
+ * @brief Gesture state for one guitar
+ */
+struct gesture_engine {
+	struct gesture_slot_state slots[GESTURE_SLOTS];
+
+	/* Statistics */
+	uint32_t triggers;
+};
+
+/**
+ * @brief One MIDI message produced by the engine
+ */
+struct gesture_event {
+	uint8_t slot;
+	uint8_t len;
+	uint8_t msg[3];
+};
+
+/* ========================================
+ * API
+ * ======================================== */
+
+/**
+ * @brief Initialize gesture state
+ *
+ * @param ge Gesture state
+ */
+void gesture_engine_init(struct gesture_engine *ge);
+
+/**
+ * @brief Check a gesture configuration
+ *
+ * @param cfg Gesture configuration
+ * @return true if every used slot has a valid type, source, action,
+ *         number and non-zero threshold
+ */
+bool gesture_config_validate(const struct gesture_config *cfg);
+
+/**
+ * @brief Map gesture strength to a Note On velocity
+ *
+ * @param strength_q8 Strength 0 (at threshold) to 256 (full scale)
+ * @param curve 0 = hard (quadratic), 64 = linear, 127 = soft (square root)
+ * @return Velocity 1-127
+ */
+uint8_t gesture_velocity(uint16_t strength_q8, uint8_t curve);
+
+/**
+ * @brief Run detection for one sample
+ *
+ * Slots whose configuration is invalid are skipped. A slot whose note is
+ * sounding when its gesture is removed gets its Note Off.
+ *
+ * @param ge Gesture state
+ * @param cfg Gesture configuration of the active patch
+ * @param values Source slots, as given to midi_pipeline_process()
+ * @param channel MIDI channel (0-15)
+ * @param events Output: messages to send, in order
+ * @return Number of events (0 to GESTURE_MAX_EVENTS)
+ */
+int gesture_engine_process(struct gesture_engine *ge, const struct gesture_config *cfg,
+                           const int16_t values[MAX_SENSOR_SOURCES], uint8_t channel,
+                           struct gesture_event events[GESTURE_MAX_EVENTS]);
+
+/**
+ * @brief Play a gesture the client detected
+ *
+ * Every valid slot of the given type fires on a start, with the strength
+ * |level| against its threshold, and sends its Note Off on an end. Those
+ * slots stop detecting on the streamed samples until the next reset.
+ * Note Offs the TX backend rejected are retried here too, since a client
+ * sending only events gives gesture_engine_process() no samples.
+ *
+ * @param ge Gesture state
+ * @param cfg Gesture configuration of the active patch
+ * @param type Gesture type (GESTURE_TAP, GESTURE_SHAKE or GESTURE_TILT)
+ * @param end true for the end of the gesture
+ * @param level Strength, in the units of the slot's source
+ * @param channel MIDI channel (0-15)
+ * @param events Output: messages to send, in order
+ * @return Number of events (0 to GESTURE_MAX_EVENTS)
+ */
+int gesture_engine_remote_event(struct gesture_engine *ge, const struct gesture_config *cfg,
+                                uint8_t type, bool end, int32_t level, uint8_t channel,
+                                struct gesture_event events[GESTURE_MAX_EVENTS]);
+
+/**
+ * @brief End every sounding note and reset detection
+ *
+ * For a guitar that disconnects: no note may be left hanging.
+ *
+ * @param ge Gesture state
+ * @param channel MIDI channel (0-15)
+ * @param events Output: Note Off messages
+ * @return Number of events (0 to GESTURE_SLOTS)
+ */
+int gesture_engine_release(struct gesture_engine *ge, uint8_t channel,
+                           struct gesture_event events[GESTURE_MAX_EVENTS]);
+
+/**
+ * @brief Report an event the TX backend rejected
+ *
+ * A rejected Note Off is sent again on the next sample so no note is
+ * left hanging. Other messages are not retried.
+ *
+ * @param ge Gesture state
+ * @param ev Rejected event
+ */
+void gesture_engine_tx_failed(struct gesture_engine *ge, const struct gesture_event *ev);
+
+/**
+ * @brief Get the name of a gesture type
+ *
+ * @param type Gesture type
+ * @return String name (NONE, STRUM, SHAKE, FLICK, TAP, TILT), UNKNOWN if invalid
+ */
+const char *gesture_type_name(uint8_t type);
+
+#endif /* GESTURE_ENGINE_H */
@@ -0,0 +1,146 @@
+/*
+ * IMU Fusion Implementation
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "imu_fusion.h"
+#include "fixed_math.h"
+#include <string.h>
+
+/* 4096 (q12) * 10 (deci) * 1000000 (us) / 1000 (milli) */
+#define Q12_DDPS_US_PER_MDEG 40960000LL
+
+/* ========================================
+ * HELPERS
+ * ======================================== */
+
+static int32_t abs32(int32_t v)
+{
+	return (v < 0) ? -v : v;
+}
+
+static int32_t clamp_pitch(int32_t mdeg)
+{
+	if (mdeg > FX_MDEG_90) {
+		return FX_MDEG_90;
+	}
+	if (mdeg < -FX_MDEG_90) {
+		return -FX_MDEG_90;
+	}
+	return mdeg;
+}
+
+/* ========================================
+ * API
+ * ======================================== */
+
+void imu_fusion_init(struct imu_fusion *f, uint16_t tau_ms)
+{
+	if (!f) {
+		return;
+	}
+
+	memset(f, 0, sizeof(*f));
+	f->tau_ms = tau_ms ? tau_ms : IMU_FUSION_DEFAULT_TAU_MS;
+}
+
+void imu_fusion_update(struct imu_fusion *f, const int16_t accel_mg[3],
+                       const int16_t gyro_ddps[3], uint32_t timestamp_us)
+{
+	if (!f || !accel_mg || !gyro_ddps) {
+		return;
+	}
+
+	uint32_t dt_us = timestamp_us - f->last_us;
+	bool restart = (f->updates == 0 || dt_us > IMU_FUSION_MAX_DT_US);
+
+	if (restart) {
+		dt_us = 0;
+	}
+	f->last_us = timestamp_us;
+	f->updates++;
+
+	/* Accel is a tilt reference only when gravity dominates */
+	uint32_t mag2 = (uint32_t)(accel_mg[0] * accel_mg[0]) +
+	                (uint32_t)(accel_mg[1] * accel_mg[1]) +
+	                (uint32_t)(accel_mg[2] * accel_mg[2]);
+	bool accel_ok = abs32((int32_t)fx_isqrt32(mag2) - 1000) <= IMU_FUSION_ACCEL_TOL_MG;
+
+	if (!accel_ok) {
+		f->accel_rejected++;
+	}
+
+	/* Learn gyro bias while still */
+	int32_t rate_q12[IMU_AXES];
+	bool still = accel_ok;
+
+	for (int i = 0; i < IMU_AXES; i++) {
+		rate_q12[i] = gyro_ddps[i] * 4096 - f->bias_q12[i];
+		if (abs32(rate_q12[i]) >= IMU_FUSION_STILL_DDPS * 4096) {
+			still = false;
+		}
+	}
+	if (still) {
+		for (int i = 0; i < IMU_AXES; i++) {
+			f->bias_q12[i] += rate_q12[i] / (1 << IMU_FUSION_BIAS_SHIFT);
+			rate_q12[i] = gyro_ddps[i] * 4096 - f->bias_q12[i];
+		}
+	}
+
+	/* Integrate: q12 decidegrees/s * us -> millidegrees, remainder carried */
+	for (int i = 0; i < IMU_AXES; i++) {
+		int64_t num = (int64_t)rate_q12[i] * dt_us + f->rem[i];
+
+		f->angle_mdeg[i] += (int32_t)(num / Q12_DDPS_US_PER_MDEG);
+		f->rem[i] = (int32_t)(num % Q12_DDPS_US_PER_MDEG);
+	}
+	f->angle_mdeg[IMU_ROLL] = fx_wrap_mdeg(f->angle_mdeg[IMU_ROLL]);
+	f->angle_mdeg[IMU_PITCH] = clamp_pitch(f->angle_mdeg[IMU_PITCH]);
+	f->angle_mdeg[IMU_YAW] = fx_wrap_mdeg(f->angle_mdeg[IMU_YAW]);
+
+	if (!accel_ok) {
+		return;
+	}
+
+	/* Pull roll and pitch toward the accel tilt: k = dt / (tau + dt) */
+	int32_t tilt[2];
+
+	fx_tilt_mdeg(accel_mg[0], accel_mg[1], accel_mg[2], &tilt[IMU_ROLL], &tilt[IMU_PITCH]);
+
+	if (!f->valid || restart) {
+		f->angle_mdeg[IMU_ROLL] = tilt[IMU_ROLL];
+		f->angle_mdeg[IMU_PITCH] = tilt[IMU_PITCH];
+		f->valid = true;
+		return;
+	}
+
+	uint32_t tau_us = (uint32_t)f->tau_ms * 1000;
+	int32_t k_q16 = (int32_t)(((uint64_t)dt_us << 16) / (tau_us + dt_us));
+
+	for (int i = IMU_ROLL; i <= IMU_PITCH; i++) {
+		int32_t err = fx_wrap_mdeg(tilt[i] - f->angle_mdeg[i]);
+		f->angle_mdeg[i] += (int32_t)(((int64_t)err * k_q16) / 65536);
+	}
+	f->angle_mdeg[IMU_ROLL] = fx_wrap_mdeg(f->angle_mdeg[IMU_ROLL]);
+	f->angle_mdeg[IMU_PITCH] = clamp_pitch(f->angle_mdeg[IMU_PITCH]);
+}
+
+void imu_fusion_get_angles(const struct imu_fusion *f, int16_t angles_ddeg[IMU_AXES])
+{
+	if (!f || !angles_ddeg) {
+		return;
+	}
+
+	for (int i = 0; i < IMU_AXES; i++) {
+		angles_ddeg[i] = fx_mdeg_to_ddeg(f->angle_mdeg[i]);
+	}
+}
+
+void imu_fusion_zero_yaw(struct imu_fusion *f)
+{
+	if (f) {
+		f->angle_mdeg[IMU_YAW] = 0;
+	}
+}
@@ -0,0 +1,104 @@
+/*
+ * IMU Fusion
+ * Fixed-point complementary filter: accelerometer + gyroscope to roll,
+ * pitch and yaw for the GYRO_ROLL/PITCH/YAW sensor slots
+ *
+ * Gyro rates are integrated between sample timestamps; roll and pitch are
+ * pulled toward the gravity-vector tilt with time constant tau, so the
+ * blend does not depend on the client's sample rate. Accelerometer
+ * samples far from 1 g (strums, hits) are not trusted. Yaw has no
+ * absolute reference and is gyro only; while the guitar is still the
+ * gyro bias is learned so yaw holds steady.
+ *
+ * Body rates are used as Euler angle rates, which holds while pitch stays
+ * well away from +/-90 degrees (guitar neck straight up or down).
+ *
+ * Pure logic with no hardware dependencies - can be tested on host.
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef IMU_FUSION_H
+#define IMU_FUSION_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* ========================================
+ * CONSTANTS
+ * ======================================== */
+
+#define IMU_FUSION_DEFAULT_TAU_MS  500    /* Accel correction time constant */
+#define IMU_FUSION_MAX_DT_US       250000 /* Longer gaps restart from accel */
+#define IMU_FUSION_ACCEL_TOL_MG    250    /* Trust accel only within 1 g +/- this */
+#define IMU_FUSION_STILL_DDPS      30     /* Below this (3 dps) the gyro reads bias */
+#define IMU_FUSION_BIAS_SHIFT      6      /* Bias learning rate: 1/64 per still sample */
+
+enum imu_axis {
+	IMU_ROLL = 0,
+	IMU_PITCH,
+	IMU_YAW,
+	IMU_AXES
+};
+
+/* ========================================
+ * DATA STRUCTURES
+ * ======================================== */
+
+/**
+ * @brief Fusion state for one guitar
+ */
+struct imu_fusion {
+	int32_t angle_mdeg[IMU_AXES];   /* Roll, pitch, yaw in millidegrees */
+	int32_t bias_q12[IMU_AXES];     /* Gyro bias, 1/4096 decidegree/s */
+	int32_t rem[IMU_AXES];          /* Integration remainder below 1 mdeg */
+	uint32_t last_us;
+	uint16_t tau_ms;
+	bool valid;                     /* Angles initialized from accel */
+
+	/* Statistics */
+	uint32_t updates;
+	uint32_t accel_rejected;        /* Samples too far from 1 g */
+};
+
+/* ========================================
+ * API
+ * ======================================== */
+
+/**
+ * @brief Initialize fusion state
+ *
+ * @param f Fusion state
+ * @param tau_ms Accel correction time constant (0 = IMU_FUSION_DEFAULT_TAU_MS)
+ */
+void imu_fusion_init(struct imu_fusion *f, uint16_t tau_ms);
+
+/**
+ * @brief Feed one sample
+ *
+ * @param f Fusion state
+ * @param accel_mg Acceleration X, Y, Z in milli-g
+ * @param gyro_ddps Angular rate X, Y, Z in decidegrees per second
+ * @param timestamp_us Sample time (any microsecond clock, may wrap)
+ */
+void imu_fusion_update(struct imu_fusion *f, const int16_t accel_mg[3],
+                       const int16_t gyro_ddps[3], uint32_t timestamp_us);
+
+/**
+ * @brief Get angles for the sensor slots
+ *
+ * @param f Fusion state
+ * @param angles_ddeg Output: roll, pitch, yaw in decidegrees
+ *                    (roll and yaw -1800..1800, pitch -900..900)
+ */
+void imu_fusion_get_angles(const struct imu_fusion *f, int16_t angles_ddeg[IMU_AXES]);
+
+/**
+ * @brief Make the current heading yaw 0
+ *
+ * @param f Fusion state
+ */
+void imu_fusion_zero_yaw(struct imu_fusion *f);
+
+#endif /* IMU_FUSION_H */
@@ -0,0 +1,241 @@
+/*
+ * Motion-to-MIDI Latency Tracker Implementation
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "latency_tracker.h"
+#include <string.h>
+
+/* ========================================
+ * PRIVATE HELPERS
+ * ======================================== */
+
+static const char *const segment_names[LAT_SEG_COUNT] = {
+	[LAT_SEG_RADIO] = "radio",
+	[LAT_SEG_PROCESS] = "process",
+	[LAT_SEG_TX] = "uart_tx",
+	[LAT_SEG_TOTAL] = "total",
+};
+
+/**
+ * @brief Elapsed time between two wrapping timestamps, clamped at zero
+ *
+ * A negative interval can only come from clock offset error.
+ */
+static uint32_t elapsed_us(uint32_t from, uint32_t to)
+{
+	int32_t diff = (int32_t)(to - from);
+
+	return (diff < 0) ? 0 : (uint32_t)diff;
+}
+
+static void hist_reset(struct latency_hist *h)
+{
+	memset(h, 0, sizeof(*h));
+	h->min_us = UINT32_MAX;
+}
+
+static void hist_add(struct latency_hist *h, uint32_t us)
+{
+	uint32_t bucket = us / LATENCY_BUCKET_US;
+
+	if (bucket >= LATENCY_HIST_BUCKETS) {
+		bucket = LATENCY_HIST_BUCKETS - 1;
+	}
+
+	h->count++;
+	h->total_us += us;
+	if (us < h->min_us) {
+		h->min_us = us;
+	}
+	if (us > h->max_us) {
+		h->max_us = us;
+	}
+	h->buckets[bucket]++;
+}
+
+/* ========================================
+ * CLOCK OFFSET API
+ * ======================================== */
+
+void latency_clock_reset(struct latency_clock *clk)
+{
+	if (!clk) {
+		return;
+	}
+
+	memset(clk, 0, sizeof(*clk));
+}
+
+void latency_clock_update(struct latency_clock *clk, uint32_t remote_us,
+                          uint32_t local_rx_us)
+{
+	if (!clk) {
+		return;
+	}
+
+	uint32_t delta = local_rx_us - remote_us;
+
+	/* A faster packet than any seen so far is adopted immediately */
+	if (!clk->valid || (int32_t)(delta - clk->offset_us) < 0) {
+		clk->offset_us = delta;
+		clk->valid = true;
+	}
+
+	if (!clk->window_valid || (int32_t)(delta - clk->window_min_us) < 0) {
+		clk->window_min_us = delta;
+		clk->window_valid = true;
+	}
+
+	/* Re-anchor on the window minimum so the estimate follows crystal drift */
+	if (++clk->window_count >= LATENCY_CLOCK_WINDOW) {
+		clk->offset_us = clk->window_min_us;
+		clk->window_valid = false;
+		clk->window_count = 0;
+	}
+}
+
+uint32_t latency_clock_to_local(const struct latency_clock *clk, uint32_t remote_us)
+{
+	if (!clk || !clk->valid) {
+		return remote_us;
+	}
+
+	return remote_us + clk->offset_us;
+}
+
+/* ========================================
+ * TRACKER API
+ * ======================================== */
+
+void latency_init(struct latency_tracker *t)
+{
+	latency_reset(t);
+}
+
+void latency_reset(struct latency_tracker *t)
+{
+	if (!t) {
+		return;
+	}
+
+	for (int i = 0; i < LAT_SEG_COUNT; i++) {
+		hist_reset(&t->hist[i]);
+	}
+	t->pend_head = 0;
+	t->pend_tail = 0;
+	t->pending_dropped = 0;
+}
+
+void latency_record(struct latency_tracker *t, uint32_t sample_us, uint32_t rx_us,
+                    uint32_t queued_us, uint32_t done_us)
+{
+	if (!t) {
+		return;
+	}
+
+	hist_add(&t->hist[LAT_SEG_RADIO], elapsed_us(sample_us, rx_us));
+	hist_add(&t->hist[LAT_SEG_PROCESS], elapsed_us(rx_us, queued_us));
+	hist_add(&t->hist[LAT_SEG_TX], elapsed_us(queued_us, done_us));
+	hist_add(&t->hist[LAT_SEG_TOTAL], elapsed_us(sample_us, done_us));
+}
+
+int latency_mark_queued(struct latency_tracker *t, uint32_t sample_us, uint32_t rx_us,
+                        uint32_t queued_us, uint16_t end_pos)
+{
+	if (!t) {
+		return -1;
+	}
+
+	uint8_t next = (t->pend_head + 1) % LATENCY_MAX_PENDING;
+	if (next == t->pend_tail) {
+		t->pending_dropped++;
+		return -1;
+	}
+
+	struct latency_pending *p = &t->pending[t->pend_head];
+	p->sample_us = sample_us;
+	p->rx_us = rx_us;
+	p->queued_us = queued_us;
+	p->end_pos = end_pos;
+
+	/* Publish only after the entry is complete */
+	t->pend_head = next;
+
+	return 0;
+}
+
+void latency_mark_tx(struct latency_tracker *t, uint16_t tx_pos, uint32_t now_us)
+{
+	if (!t || t->pend_tail == t->pend_head) {
+		return;
+	}
+
+	const struct latency_pending *p = &t->pending[t->pend_tail];
+	if (p->end_pos != tx_pos) {
+		return;
+	}
+
+	latency_record(t, p->sample_us, p->rx_us, p->queued_us, now_us);
+	t->pend_tail = (t->pend_tail + 1) % LATENCY_MAX_PENDING;
+}
+
+uint32_t latency_percentile_us(const struct latency_hist *h, uint8_t percent)
+{
+	if (!h || h->count == 0 || percent == 0) {
+		return 0;
+	}
+	if (percent > 100) {
+		percent = 100;
+	}
+
+	/* Rank ceil(count * percent / 100) */
+	uint32_t rank = (uint32_t)(((uint64_t)h->count * percent + 99) / 100);
+	uint32_t seen = 0;
+
+	for (int b = 0; b < LATENCY_HIST_BUCKETS; b++) {
+		seen += h->buckets[b];
+		if (seen >= rank) {
+			uint32_t upper = (uint32_t)(b + 1) * LATENCY_BUCKET_US - 1;
+
+			if (b == LATENCY_HIST_BUCKETS - 1 || upper > h->max_us) {
+				upper = h->max_us;
+			}
+			return (upper < h->min_us) ? h->min_us : upper;
+		}
+	}
+
+	return h->max_us;
+}
+
+int latency_dump(const struct latency_tracker *t, uint8_t *buf, size_t len)
+{
+	if (!t || !buf || len < LATENCY_DUMP_SIZE) {
+		return -1;
+	}
+
+	struct latency_dump_header hdr = {
+		.magic = LATENCY_DUMP_MAGIC,
+		.version = LATENCY_DUMP_VERSION,
+		.segment_count = LAT_SEG_COUNT,
+		.bucket_count = LATENCY_HIST_BUCKETS,
+		.reserved = 0,
+		.bucket_us = LATENCY_BUCKET_US,
+	};
+
+	memcpy(buf, &hdr, sizeof(hdr));
+	memcpy(buf + sizeof(hdr), t->hist, LAT_SEG_COUNT * sizeof(struct latency_hist));
+
+	return (int)LATENCY_DUMP_SIZE;
+}
+
+const char *latency_segment_name(enum latency_segment seg)
+{
+	if (seg >= LAT_SEG_COUNT) {
+		return "unknown";
+	}
+
+	return segment_names[seg];
+}
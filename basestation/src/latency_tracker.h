@@ -0,0 +1,204 @@
+/*
+ * Motion-to-MIDI Latency Tracker
+ * End-to-end latency from client sample time to last MIDI byte out
+ *
+ * The client stamps each sample with its own microsecond uptime. The
+ * basestation estimates the per-connection clock offset with a windowed
+ * minimum filter: the fastest packets are the ones sampled just before a
+ * connection event anchor, so min(rx - sample) tracks the remote clock
+ * plus the fixed air/stack delay. The "radio" segment therefore measures
+ * the variable wait for the next connection event, not the constant part.
+ *
+ * Pure logic with no hardware dependencies - can be tested on host.
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef LATENCY_TRACKER_H
+#define LATENCY_TRACKER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* ========================================
+ * CONSTANTS
+ * ======================================== */
+
+#define LATENCY_HIST_BUCKETS    64      /* Last bucket collects overflow */
+#define LATENCY_BUCKET_US       1000    /* 1 ms per bucket */
+#define LATENCY_MAX_PENDING     8       /* CC messages awaiting UART completion */
+#define LATENCY_CLOCK_WINDOW    256     /* Samples per offset re-estimation window */
+
+#define LATENCY_DUMP_MAGIC      0x4C415444  /* "LATD" */
+#define LATENCY_DUMP_VERSION    1
+
+/**
+ * @brief Latency segments
+ */
+enum latency_segment {
+	LAT_SEG_RADIO = 0,   /* Sample time -> BLE notification received */
+	LAT_SEG_PROCESS,     /* BLE received -> CC queued for UART */
+	LAT_SEG_TX,          /* CC queued -> last byte handed to UART */
+	LAT_SEG_TOTAL,       /* Sample time -> last byte handed to UART */
+	LAT_SEG_COUNT
+};
+
+/* ========================================
+ * DATA STRUCTURES
+ * ======================================== */
+
+/**
+ * @brief Per-connection clock offset estimator
+ *
+ * local_us = remote_us + offset_us (all arithmetic modulo 2^32)
+ */
+struct latency_clock {
+	uint32_t offset_us;       /* Current offset estimate */
+	uint32_t window_min_us;   /* Minimum (rx - remote) seen in this window */
+	uint16_t window_count;
+	bool valid;
+	bool window_valid;
+};
+
+/**
+ * @brief Latency histogram for one segment (fixed memory)
+ */
+struct latency_hist {
+	uint32_t count;
+	uint32_t min_us;
+	uint32_t max_us;
+	uint64_t total_us;
+	uint32_t buckets[LATENCY_HIST_BUCKETS];
+};
+
+/**
+ * @brief CC message awaiting its last byte on the UART
+ */
+struct latency_pending {
+	uint32_t sample_us;   /* Sample time, already in local clock */
+	uint32_t rx_us;
+	uint32_t queued_us;
+	uint16_t end_pos;     /* TX ring position after the last byte */
+};
+
+/**
+ * @brief Latency tracker state
+ *
+ * Pending entries form a single-producer (queueing thread) /
+ * single-consumer (UART ISR) ring.
+ */
+struct latency_tracker {
+	struct latency_hist hist[LAT_SEG_COUNT];
+	struct latency_pending pending[LATENCY_MAX_PENDING];
+	volatile uint8_t pend_head;
+	volatile uint8_t pend_tail;
+	uint32_t pending_dropped;
+};
+
+/**
+ * @brief Binary dump header
+ *
+ * Followed by LAT_SEG_COUNT struct latency_hist in native (little-endian,
+ * naturally aligned) layout.
+ */
+struct latency_dump_header {
+	uint32_t magic;
+	uint8_t version;
+	uint8_t segment_count;
+	uint8_t bucket_count;
+	uint8_t reserved;
+	uint32_t bucket_us;
+} __attribute__((packed));
+
+#define LATENCY_DUMP_SIZE \
+	(sizeof(struct latency_dump_header) + LAT_SEG_COUNT * sizeof(struct latency_hist))
+
+/* ========================================
+ * CLOCK OFFSET API
+ * ======================================== */
+
+/**
+ * @brief Reset clock estimator (call on connect)
+ */
+void latency_clock_reset(struct latency_clock *clk);
+
+/**
+ * @brief Feed one (remote sample time, local receive time) pair
+ *
+ * @param clk Clock estimator
+ * @param remote_us Client timestamp from the packet
+ * @param local_rx_us Local time the packet was received
+ */
+void latency_clock_update(struct latency_clock *clk, uint32_t remote_us,
+                          uint32_t local_rx_us);
+
+/**
+ * @brief Convert a remote timestamp to local time
+ *
+ * @return Local time, or remote_us unchanged if no estimate yet
+ */
+uint32_t latency_clock_to_local(const struct latency_clock *clk, uint32_t remote_us);
+
+/* ========================================
+ * TRACKER API
+ * ======================================== */
+
+/**
+ * @brief Initialize tracker and clear all histograms
+ */
+void latency_init(struct latency_tracker *t);
+
+/**
+ * @brief Clear histograms and pending entries
+ */
+void latency_reset(struct latency_tracker *t);
+
+/**
+ * @brief Record a completed sample directly (all timestamps local)
+ */
+void latency_record(struct latency_tracker *t, uint32_t sample_us, uint32_t rx_us,
+                    uint32_t queued_us, uint32_t done_us);
+
+/**
+ * @brief Register a CC message about to be queued for UART transmission
+ *
+ * Must be called before the bytes become visible to the UART ISR.
+ *
+ * @param end_pos TX ring position once the message's last byte is consumed
+ * @return 0 on success, -1 if the pending ring is full
+ */
+int latency_mark_queued(struct latency_tracker *t, uint32_t sample_us, uint32_t rx_us,
+                        uint32_t queued_us, uint16_t end_pos);
+
+/**
+ * @brief Notify that the UART consumed bytes up to tx_pos
+ *
+ * Completes the oldest pending message if its last byte has gone out.
+ * Called from the UART ISR.
+ */
+void latency_mark_tx(struct latency_tracker *t, uint16_t tx_pos, uint32_t now_us);
+
+/**
+ * @brief Get percentile estimate for a segment (bucket upper bound)
+ *
+ * @param percent Percentile 1-100
+ * @return Latency in microseconds, 0 if no samples
+ */
+uint32_t latency_percentile_us(const struct latency_hist *h, uint8_t percent);
+
+/**
+ * @brief Serialize histograms into a binary dump
+ *
+ * @param buf Output buffer, at least LATENCY_DUMP_SIZE bytes
+ * @return Bytes written, or -1 if the buffer is too small
+ */
+int latency_dump(const struct latency_tracker *t, uint8_t *buf, size_t len);
+
+/**
+ * @brief Get human-readable segment name
+ */
+const char *latency_segment_name(enum latency_segment seg);
+
+#endif /* LATENCY_TRACKER_H */
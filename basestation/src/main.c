@@ -22,15 +22,29 @@
 #include "ui_interface.h"
 #include "config_storage.h"
 #include "topology_processor.h"
+#include "midi_pipeline.h"
+#include "patch_store.h"
+#include "imu_fusion.h"
+#include "derived_sources.h"
 #include "virtual_ports.h"
 #include "topology_config.h"
 #include "function_units.h"
+#include "perf_profiler.h"
+#include "latency_tracker.h"
+#include "boot_timing.h"
+#include "trace.h"
+#ifdef CONFIG_GUITARACC_TELEMETRY
+#include "telemetry_stream.h"
+#endif
+#ifdef CONFIG_GUITARACC_CAPTURE
+#include "motion_capture.h"
+#endif
 
 LOG_MODULE_REGISTER(basestation, LOG_LEVEL_DBG);
 
 /* Debug flags */
 #define MIDI_DEBUG 0  /* Enable detailed MIDI transmission logging */
-#define BLE_DEBUG 1   /* Enable BLE connection and discovery logging */
+#define BLE_DEBUG 1   /* Enable BLE connection and discovery logging (not per-sample; see trace.h) */
 
 /* Enable test mode to send periodic MIDI test messages */
 //#define TEST_MODE_ENABLED 1
@@ -59,9 +73,7 @@ static struct bt_uuid_128 guitar_accel_char_uuid = BT_UUID_INIT_128(
 /* MIDI UART device */
 static const struct device *midi_uart;
 
-/* MIDI TX queue for interrupt-driven transmission */
-#define MIDI_TX_QUEUE_SIZE 16
-#define MIDI_TX_MAX_QUEUED 6  /* Don't write if more than this many bytes queued */
+/* MIDI TX queue for interrupt-driven transmission (limits in midi_pipeline.h) */
 static uint8_t midi_tx_queue[MIDI_TX_QUEUE_SIZE];
 static volatile size_t midi_tx_head = 0;
 static volatile size_t midi_tx_tail = 0;
@@ -82,6 +94,66 @@ static volatile size_t midi_rx_tail = 0;
 /* MIDI receive statistics (structure defined in ui_interface.h) */
 static struct midi_rx_stats rx_stats = {0};
 
+/* Motion-to-MIDI latency tracing */
+static struct latency_tracker latency;
+
+/* Sample being turned into MIDI; consumed by queue_midi_bytes() */
+static struct {
+	bool valid;
+	uint32_t sample_us;  /* Sample time in local clock */
+	uint32_t rx_us;
+} tx_latency_ctx;
+
+static inline uint32_t latency_now_us(void)
+{
+	return (uint32_t)k_ticks_to_us_floor64(k_uptime_ticks());
+}
+
+/* Boot phases and milestones (see boot_timing.h). Only main() begins and
+ * ends phases; callbacks only stamp milestones. boot_lock keeps each
+ * milestone and its time consistent for readers on other threads. */
+static struct boot_timing boot;
+static struct k_spinlock boot_lock;
+static int boot_ble_phase = -1;
+
+/* Set by bt_ready(), read by main() once the semaphore is taken */
+static uint32_t bt_ready_us;
+static K_SEM_DEFINE(bt_ready_sem, 0, 1);
+#define BT_READY_WAIT_MS  2000
+
+/* Milestones already stamped: queue_midi_bytes() checks on every message */
+static atomic_t boot_ms_stamped;
+
+static bool boot_milestone(enum boot_milestone ms)
+{
+	if (atomic_test_bit(&boot_ms_stamped, ms)) {
+		return false;
+	}
+	
+	k_spinlock_key_t key = k_spin_lock(&boot_lock);
+	bool set = boot_timing_milestone(&boot, ms, latency_now_us());
+	k_spin_unlock(&boot_lock, key);
+	atomic_set_bit(&boot_ms_stamped, ms);
+	
+	return set;
+}
+
+static int boot_phase_begin(const char *name)
+{
+	k_spinlock_key_t key = k_spin_lock(&boot_lock);
+	int phase = boot_timing_begin(&boot, name, latency_now_us());
+	k_spin_unlock(&boot_lock, key);
+	
+	return phase;
+}
+
+static void boot_phase_end(int phase, uint32_t now_us)
+{
+	k_spinlock_key_t key = k_spin_lock(&boot_lock);
+	boot_timing_end(&boot, phase, now_us);
+	k_spin_unlock(&boot_lock, key);
+}
+
 /* MIDI Program Change state */
 static uint8_t current_program = 1;  /* Default power-up program */
 static uint8_t midi_rx_state = 0;    /* 0=waiting for status, 1=waiting for PC data */
@@ -92,55 +164,120 @@ struct guitar_connection {
 	struct bt_conn *conn;
 	uint16_t accel_handle;
 	bool subscribed;
+	struct latency_clock clock;  /* Client-to-local clock offset */
+	struct imu_fusion fusion;    /* Roll/pitch/yaw from accel + gyro */
+	struct derived_sources derived;  /* Accel-only tilt, motion sources */
+	struct gesture_engine gestures;  /* Note/trigger detection */
 };
 
 static struct guitar_connection guitar_conn = {0};
 
-/* Accelerometer to MIDI mapping configurations */
-/* Virtual ports topology processor */
-static struct topology_processor topo_proc;
+/* Accelerometer to MIDI pipeline (virtual ports topology processor) */
+static struct midi_pipeline pipeline;
 
-/* Current configuration */
-static struct config_data current_config;
+/* Current configuration: a held snapshot, read in place (no copy) */
+static const struct config_data *current_config;
 
 /* Configuration reload callback (defined in ui_interface.c) */
 extern void (*ui_config_reload_callback)(void);
 
+/* Load a patch into the MIDI pipeline */
+static void apply_patch(const struct patch_config *patch)
+{
+	midi_pipeline_configure(&pipeline, patch->topologies, patch->default_mixer_type,
+				patch->functions, current_config->global.midi_channel,
+				patch->midi_deadzone);
+	midi_pipeline_set_gestures(&pipeline, &patch->gestures);
+}
+
+/* Load the active patch into the MIDI pipeline */
+static void configure_pipeline(void)
+{
+	uint8_t patch_idx = current_config->global.default_patch;
+	if (patch_idx >= NUM_PATCHES) patch_idx = 0;
+	
+	apply_patch(&current_config->patches[patch_idx]);
+}
+
+/* Program Change: switch to the bank patch of the program, if stored.
+ * Runs on the system workqueue; the UART ISR only records the program. */
+static volatile uint8_t pending_program;
+
+static void program_change_handler(struct k_work *work)
+{
+	static struct patch_config patch;
+	uint8_t program = pending_program;
+	bool from_flash;
+	uint32_t start = k_cycle_get_32();
+	
+	if (patch_store_load(program, &patch, &from_flash) != 0) {
+		LOG_INF("Program %d: no bank patch, keeping current patch", program);
+		return;
+	}
+	
+	k_sched_lock();
+	apply_patch(&patch);
+	k_sched_unlock();
+	
+	uint32_t us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+	patch_store_record_switch(us, from_flash);
+	LOG_INF("Program %d: %s (%u us%s)", program, patch.patch_name, us,
+		from_flash ? ", from flash" : "");
+	
+	/* Read ahead only after the switch, so it never delays one */
+	patch_store_prefetch(program);
+}
+
+static K_WORK_DEFINE(program_change_work, program_change_handler);
+
+static void request_program_change(uint8_t program)
+{
+	pending_program = program;
+	k_work_submit(&program_change_work);
+}
+
 /* Reload configuration from storage */
 static void reload_config(void)
 {
-	int err = config_storage_load(&current_config);
-	if (err != 0) {
-		LOG_WRN("Config reload failed, using hardcoded defaults");
-		config_storage_get_hardcoded_defaults(&current_config);
-	} else {
-		uint8_t patch_idx = current_config.global.default_patch;
-		if (patch_idx >= NUM_PATCHES) patch_idx = 0;
-		LOG_INF("Config reloaded: MIDI ch=%d, Patch %d",
-			current_config.global.midi_channel + 1,
-			patch_idx);
+	const struct config_data *config = config_storage_acquire();
+	if (!config) {
+		LOG_WRN("Config reload failed, keeping current configuration");
+		return;
 	}
 	
-	/* Update virtual ports topology processor */
-	uint8_t patch_idx = current_config.global.default_patch;
+	const struct config_data *old = current_config;
+	uint8_t patch_idx = config->global.default_patch;
 	if (patch_idx >= NUM_PATCHES) patch_idx = 0;
+	LOG_INF("Config reloaded: MIDI ch=%d, Patch %d",
+		config->global.midi_channel + 1,
+		patch_idx);
 	
-	/* Reconfigure topology processor from patch */
-	struct patch_topology_config *topo_config = (struct patch_topology_config *)&current_config.patches[patch_idx].topologies[0];
-	topo_proc_init(&topo_proc, topo_config);
+	/* Reconfigure topology processor, CC numbers and deadzone from patch.
+	 * The BLE RX thread must not see a half-built pipeline, so swap the
+	 * whole patch in without being preempted. */
+	k_sched_lock();
+	current_config = config;
+	configure_pipeline();
+	k_sched_unlock();
 	
-	/* Update function configurations */
-	for (int i = 0; i < MAX_FUNCTION_UNITS; i++) {
-		topo_proc_set_function(&topo_proc, i, &current_config.patches[patch_idx].functions[i]);
-	}
+	/* The pipeline holds its own compiled copy; the old snapshot can go */
+	config_storage_release(old);
 	
-	LOG_INF("Virtual ports topology reloaded for patch %d", patch_idx);
+	LOG_INF("Virtual ports topology reloaded for patch %d", config->global.default_patch);
+}
+
+/* Get boot timing for UI access */
+void ui_get_boot_timing(struct boot_timing *out)
+{
+	k_spinlock_key_t key = k_spin_lock(&boot_lock);
+	*out = boot;
+	k_spin_unlock(&boot_lock, key);
 }
 
 /* Get topology processor for UI access */
 struct topology_processor *ui_get_topology_processor(void)
 {
-	return &topo_proc;
+	return &pipeline.proc;
 }
 
 /* UART ISR for interrupt-driven MIDI transmission */
@@ -149,6 +286,8 @@ static void uart_isr(const struct device *dev, void *user_data)
 	uart_irq_update(dev);
 	
 	if (uart_irq_tx_ready(dev)) {
+		PERF_BEGIN(t_tx);
+		
 		/* Check priority queue first (real-time messages) */
 		if (midi_tx_rt_tail != midi_tx_rt_head) {
 			/* Get next byte from priority queue */
@@ -174,6 +313,9 @@ static void uart_isr(const struct device *dev, void *user_data)
 #else
 			uart_fifo_fill(dev, &byte, 1);
 #endif
+			
+			/* Complete latency sample if this was the last byte of a traced CC */
+			latency_mark_tx(&latency, midi_tx_tail, latency_now_us());
 		} else {
 			/* Both queues empty, disable TX interrupt */
 			uart_irq_tx_disable(dev);
@@ -182,6 +324,8 @@ static void uart_isr(const struct device *dev, void *user_data)
 			LOG_DBG("UART ISR: queues empty, TX disabled");
 #endif
 		}
+		
+		PERF_END(PERF_STAGE_UART_TX, t_tx);
 	}
 	
 	/* Process RX FIFO */
@@ -232,6 +376,7 @@ static void uart_isr(const struct device *dev, void *user_data)
 				current_program = byte;
 				midi_rx_state = 0;
 				LOG_INF("MIDI PC: Program changed to %d", current_program);
+				request_program_change(byte);
 			}
 			
 			/* Forward real-time messages (0xF8-0xFF) to output via priority queue */
@@ -264,18 +409,16 @@ static int queue_midi_bytes(const uint8_t *data, size_t len)
 		(midi_tx_head - midi_tx_tail) : 
 		(MIDI_TX_QUEUE_SIZE - midi_tx_tail + midi_tx_head);
 	
-	/* Check if queue is too full - reject entire write if so */
-	if (queued > MIDI_TX_MAX_QUEUED) {
-		LOG_WRN("MIDI TX queue too full (%d bytes), dropping message", queued);
+	/* Reject the entire write if the queue is too full or the message doesn't fit */
+	if (!midi_tx_fits(queued, len)) {
+		TRACE_S16(TRACE_SITE_MIDI_TX_DROP, queued, len, 0, 0);
 		return -ENOMEM;
 	}
 	
-	/* Check if there's enough space for the entire message */
-	size_t available = (MIDI_TX_QUEUE_SIZE - 1) - queued;
-	if (len > available) {
-		LOG_WRN("Not enough space in MIDI TX queue (%d available, %d needed), dropping message", 
-			available, len);
-		return -ENOMEM;
+	/* Register for latency tracing before the ISR can see the bytes */
+	if (tx_latency_ctx.valid) {
+		latency_mark_queued(&latency, tx_latency_ctx.sample_us, tx_latency_ctx.rx_us,
+				    latency_now_us(), (midi_tx_head + len) % MIDI_TX_QUEUE_SIZE);
 	}
 	
 	/* Add bytes to queue */
@@ -284,6 +427,10 @@ static int queue_midi_bytes(const uint8_t *data, size_t len)
 		midi_tx_head = (midi_tx_head + 1) % MIDI_TX_QUEUE_SIZE;
 	}
 	
+	if (boot_milestone(BOOT_MS_FIRST_MIDI)) {
+		LOG_INF("Boot: first MIDI at %u ms", latency_now_us() / 1000);
+	}
+	
 #if MIDI_DEBUG
 	LOG_DBG("Queued %d bytes, head=%d tail=%d", len, midi_tx_head, midi_tx_tail);
 #endif
@@ -329,19 +476,19 @@ static int queue_midi_rt_bytes(const uint8_t *data, size_t len)
 	return 0;
 }
 
-static void send_midi_cc(uint8_t channel, uint8_t cc_number, uint8_t value)
+/* MIDI pipeline TX backend: queue for interrupt-driven transmission */
+static int pipeline_tx(int guitar_id, int output, const uint8_t *msg, size_t len,
+		       void *user_data)
 {
-	uint8_t midi_msg[3];
-	
-	/* Construct MIDI CC message using shared logic */
-	construct_midi_cc_msg(channel, cc_number, value, midi_msg);
-	
-	/* Queue for interrupt-driven transmission */
-	queue_midi_bytes(midi_msg, 3);
+	ARG_UNUSED(guitar_id);
+	ARG_UNUSED(output);
+	ARG_UNUSED(user_data);
 	
 #if MIDI_DEBUG
-	LOG_DBG("MIDI CC ch=%d, cc=%d, val=%d", channel, cc_number, value);
+	LOG_DBG("MIDI CC status=0x%02x, cc=%d, val=%d", msg[0], msg[1], msg[2]);
 #endif
+	
+	return queue_midi_bytes(msg, len);
 }
 
 /* Get MIDI RX statistics */
@@ -358,6 +505,21 @@ void ui_reset_midi_rx_stats(void)
 	memset(&rx_stats, 0, sizeof(rx_stats));
 }
 
+/* Get latency tracker for UI access */
+const struct latency_tracker *ui_get_latency_tracker(void)
+{
+	return &latency;
+}
+
+/* Reset latency statistics */
+void ui_reset_latency_stats(void)
+{
+	/* The UART ISR completes pending samples; keep it out while clearing */
+	unsigned int key = irq_lock();
+	latency_reset(&latency);
+	irq_unlock(key);
+}
+
 /* Get current MIDI program */
 uint8_t ui_get_current_program(void)
 {
@@ -373,6 +535,7 @@ void ui_set_current_program(uint8_t program)
 	}
 	current_program = program;
 	LOG_INF("MIDI Program set to %d", current_program);
+	request_program_change(program);
 }
 
 /* Send MIDI real-time message (single byte, high priority) */
@@ -387,63 +550,103 @@ int send_midi_realtime(uint8_t rt_byte)
 	return queue_midi_rt_bytes(&rt_byte, 1);
 }
 
-/* Process acceleration data and convert to MIDI CC through topology processor */
-static void process_accel_data(const struct accel_data *accel, int guitar_id)
+#ifdef CONFIG_GUITARACC_TELEMETRY
+/* Bytes waiting in a TX ring */
+static inline uint8_t tx_ring_depth(size_t head, size_t tail, size_t size)
 {
-	/* Get active patch index */
-	uint8_t patch_idx = current_config.global.default_patch;
-	if (patch_idx >= NUM_PATCHES) patch_idx = 0;
-	
-	/* Get deadzone threshold from patch config */
-	int16_t deadzone = current_config.patches[patch_idx].midi_deadzone;
-	if (deadzone < 0) deadzone = 0;  /* Sanity check */
-	
-	/* Prepare accelerometer input array (6 axes: X, Y, Z, Roll, Pitch, Yaw) */
-	int16_t accel_values[6] = {accel->x, accel->y, accel->z, 0, 0, 0};
+	return (uint8_t)((head >= tail) ? (head - tail) : (size - tail + head));
+}
+
+/* Snapshot the pipeline for the telemetry stream (copy only, never blocks) */
+static void capture_telemetry(const struct accel_data *accel, const uint8_t *midi_outputs)
+{
+	struct telemetry_record rec;
 	
-	/* Set inputs and execute topology */
-	topo_proc_set_accel_inputs(&topo_proc, accel_values);
-	topo_proc_execute(&topo_proc);
+	rec.timestamp_ms = k_uptime_get_32();
+	rec.raw[0] = accel->x;
+	rec.raw[1] = accel->y;
+	rec.raw[2] = accel->z;
+	memcpy(rec.calibrated, pipeline.proc.accel_values, sizeof(rec.calibrated));
+	for (int i = 0; i < MAX_VIRTUAL_PORTS; i++) {
+		rec.vports[i] = vport_read_raw(&pipeline.proc.vport_system, i);
+	}
+	memcpy(rec.midi, midi_outputs, sizeof(rec.midi));
+	rec.tx_queue_depth = tx_ring_depth(midi_tx_head, midi_tx_tail, MIDI_TX_QUEUE_SIZE);
+	rec.rt_queue_depth = tx_ring_depth(midi_tx_rt_head, midi_tx_rt_tail, MIDI_TX_RT_QUEUE_SIZE);
 	
-	/* Get MIDI outputs and send changed values */
-	uint8_t midi_outputs[MAX_MIDI_OUTPUTS];
-	topo_proc_get_all_midi_outputs(&topo_proc, midi_outputs);
+	telemetry_stream_capture(&rec);
+}
+#endif /* CONFIG_GUITARACC_TELEMETRY */
+
+/* Process acceleration data and convert to MIDI CC through topology processor.
+ * gyro may be NULL; roll/pitch then come from the accel tilt and yaw is 0. */
+static void process_accel_data(const struct accel_data *accel, const struct gyro_data *gyro,
+			       uint32_t timestamp_us, int guitar_id)
+{
+	PERF_BEGIN(t_process);
 	
-	/* Send MIDI CC messages for each configured output */
-	static uint8_t last_midi_outputs[MAX_MIDI_OUTPUTS] = {255, 255, 255, 255, 255, 255};
-	bool sent_any = false;
+	/* Source array: X, Y, Z, Roll, Pitch, Yaw, then the derived sources */
+	int16_t accel_values[MAX_SENSOR_SOURCES] = {accel->x, accel->y, accel->z};
 	
-	for (int i = 0; i < MAX_MIDI_OUTPUTS; i++) {
-		/* Get configured CC number from topology */
-		uint8_t cc_num = 16 + i;  /* Default CC 16-21 */
-		if (i < MAX_TOPOLOGY_INSTANCES && 
-		    current_config.patches[patch_idx].topologies[i].enabled) {
-			cc_num = current_config.patches[patch_idx].topologies[i].midi_outputs[0];
-		}
-		
-		/* Send if value changed (deadzone check) */
-		int16_t delta = (int16_t)midi_outputs[i] - (int16_t)last_midi_outputs[i];
-		if (delta < 0) delta = -delta;
+	if (gyro) {
+		const int16_t a[3] = {accel->x, accel->y, accel->z};
+		const int16_t g[3] = {gyro->x, gyro->y, gyro->z};
 		
-		if (last_midi_outputs[i] == 255 || delta >= deadzone) {
-			send_midi_cc(current_config.global.midi_channel, cc_num, midi_outputs[i]);
-			last_midi_outputs[i] = midi_outputs[i];
-			sent_any = true;
-		}
+		imu_fusion_update(&guitar_conn.fusion, a, g, timestamp_us);
+		imu_fusion_get_angles(&guitar_conn.fusion, &accel_values[3]);
 	}
+	derived_sources_update(&guitar_conn.derived, accel_values, gyro != NULL,
+			       pipeline.source_mask);
+	
+	/* Gesture notes/triggers first, then changed CC values (deadzone check) */
+	int sent = midi_pipeline_process_gestures(&pipeline, guitar_id, &guitar_conn.gestures,
+						  accel_values);
+	sent += midi_pipeline_process(&pipeline, guitar_id, accel_values);
 	
 	/* Brief LED flash to indicate MIDI activity */
-	if (sent_any) {
+	if (sent > 0) {
 		ui_led_flash(UI_LED_WHITE, 30);  /* 30ms white flash */
 	}
 	
-#if BLE_DEBUG
-	LOG_INF("Accel: x=%d y=%d z=%d -> Topology", 
-		accel->x, accel->y, accel->z);
-	LOG_INF("MIDI out: [%d,%d,%d,%d,%d,%d]",
-		midi_outputs[0], midi_outputs[1], midi_outputs[2],
-		midi_outputs[3], midi_outputs[4], midi_outputs[5]);
+#ifdef CONFIG_GUITARACC_TELEMETRY
+	if (telemetry_stream_active()) {
+		capture_telemetry(accel, pipeline.outputs);
+	}
 #endif
+	
+	TRACE_S16(TRACE_SITE_ACCEL_IN, accel->x, accel->y, accel->z, 0);
+	TRACE_BYTES(TRACE_SITE_MIDI_OUT, pipeline.outputs, MAX_MIDI_OUTPUTS);
+	
+	PERF_END(PERF_STAGE_PROCESS_ACCEL, t_process);
+}
+
+/* Play a gesture a client in edge event mode detected */
+static void process_motion_event(const struct motion_event *ev, int guitar_id)
+{
+	uint8_t type;
+	
+	switch (ev->type) {
+	case MOTION_EVENT_TAP:
+		type = GESTURE_TAP;
+		break;
+	case MOTION_EVENT_SHAKE:
+		type = GESTURE_SHAKE;
+		break;
+	case MOTION_EVENT_TILT:
+		type = GESTURE_TILT;
+		break;
+	default:
+		LOG_WRN("Unknown motion event type %d", ev->type);
+		return;
+	}
+	
+	int sent = midi_pipeline_process_remote_gesture(&pipeline, guitar_id,
+							&guitar_conn.gestures, type,
+							(ev->flags & MOTION_EVENT_F_END) != 0,
+							ev->value);
+	if (sent > 0) {
+		ui_led_flash(UI_LED_WHITE, 30);
+	}
 }
 
 /**
@@ -546,6 +749,9 @@ static uint8_t accel_notify_callback(struct bt_conn *conn,
 				     const void *data, uint16_t length)
 {
 	const struct accel_data *accel;
+	const struct gyro_data *gyro = NULL;
+	uint32_t sample_us = 0;
+	uint32_t rx_us = latency_now_us();
 	
 	if (!data) {
 		LOG_INF("Unsubscribed from acceleration notifications");
@@ -553,17 +759,71 @@ static uint8_t accel_notify_callback(struct bt_conn *conn,
 		return BT_GATT_ITER_STOP;
 	}
 	
-#if BLE_DEBUG
-	LOG_INF("BLE: Received notification, length=%d", length);
-#endif
+	PERF_BEGIN(t_rx);
 	
-	if (length != sizeof(struct accel_data)) {
-		LOG_WRN("Invalid acceleration data length: %d (expected %d)", length, sizeof(struct accel_data));
+	TRACE_S16(TRACE_SITE_BLE_RX, length, 0, 0, 0);
+	
+	if (length == sizeof(struct accel_sample)) {
+		/* Timestamped sample: update clock offset and trace latency */
+		const struct accel_sample *sample = (const struct accel_sample *)data;
+		
+		latency_clock_update(&guitar_conn.clock, sample->timestamp_us, rx_us);
+		tx_latency_ctx.sample_us = latency_clock_to_local(&guitar_conn.clock,
+								  sample->timestamp_us);
+		tx_latency_ctx.rx_us = rx_us;
+		tx_latency_ctx.valid = true;
+		accel = &sample->accel;
+	} else if (length == sizeof(struct imu_sample)) {
+		/* Timestamped sample with gyro */
+		const struct imu_sample *sample = (const struct imu_sample *)data;
+		
+		latency_clock_update(&guitar_conn.clock, sample->timestamp_us, rx_us);
+		tx_latency_ctx.sample_us = latency_clock_to_local(&guitar_conn.clock,
+								  sample->timestamp_us);
+		tx_latency_ctx.rx_us = rx_us;
+		tx_latency_ctx.valid = true;
+		accel = &sample->accel;
+		gyro = &sample->gyro;
+		sample_us = sample->timestamp_us;
+	} else if (length == sizeof(struct accel_data)) {
+		/* Legacy client without timestamps */
+		accel = (const struct accel_data *)data;
+	} else if (length == sizeof(struct motion_event)) {
+		/* Gesture detected on the client: notes only, no CC update */
+		const struct motion_event *ev = (const struct motion_event *)data;
+		
+		latency_clock_update(&guitar_conn.clock, ev->timestamp_us, rx_us);
+		tx_latency_ctx.sample_us = latency_clock_to_local(&guitar_conn.clock,
+								  ev->timestamp_us);
+		tx_latency_ctx.rx_us = rx_us;
+		tx_latency_ctx.valid = true;
+#ifdef CONFIG_GUITARACC_CAPTURE
+		capture_record(0, rx_us, CAPTURE_F_TIMED | CAPTURE_F_EVENT,
+			       ev->type, ev->flags, ev->value, 0, 0, 0);
+#endif
+		process_motion_event(ev, 0);  /* Single guitar, ID = 0 */
+		tx_latency_ctx.valid = false;
+		PERF_END(PERF_STAGE_BLE_RX, t_rx);
+		return BT_GATT_ITER_CONTINUE;
+	} else {
+		LOG_WRN("Invalid acceleration data length: %d (expected %d, %d, %d or %d)", length,
+			sizeof(struct accel_data), sizeof(struct accel_sample),
+			sizeof(struct imu_sample), sizeof(struct motion_event));
 		return BT_GATT_ITER_CONTINUE;
 	}
 	
-	accel = (const struct accel_data *)data;
-	process_accel_data(accel, 0);  /* Single guitar, ID = 0 */
+#ifdef CONFIG_GUITARACC_CAPTURE
+	/* Record the sample as received, before any processing */
+	capture_record(0, rx_us,
+		       (tx_latency_ctx.valid ? CAPTURE_F_TIMED : 0) | (gyro ? CAPTURE_F_GYRO : 0),
+		       accel->x, accel->y, accel->z,
+		       gyro ? gyro->x : 0, gyro ? gyro->y : 0, gyro ? gyro->z : 0);
+#endif
+	
+	process_accel_data(accel, gyro, sample_us, 0);  /* Single guitar, ID = 0 */
+	tx_latency_ctx.valid = false;
+	
+	PERF_END(PERF_STAGE_BLE_RX, t_rx);
 	
 	return BT_GATT_ITER_CONTINUE;
 }
@@ -717,6 +977,10 @@ static void connected(struct bt_conn *conn, uint8_t conn_err)
 	/* Track guitar connection */
 	guitar_conn.conn = bt_conn_ref(conn);
 	guitar_conn.subscribed = false;
+	latency_clock_reset(&guitar_conn.clock);
+	imu_fusion_init(&guitar_conn.fusion, 0);
+	derived_sources_init(&guitar_conn.derived, CONFIG_GUITARACC_TILT_LPF_SHIFT);
+	gesture_engine_init(&guitar_conn.gestures);
 	
 	/* Update LED to show connected state */
 	ui_led_update_connection_count(1);
@@ -755,6 +1019,9 @@ static void disconnected(struct bt_conn *conn, uint8_t reason)
 
 	/* Clean up guitar connection */
 	if (guitar_conn.conn == conn) {
+		/* No gesture note may outlive its guitar */
+		midi_pipeline_release_gestures(&pipeline, 0, &guitar_conn.gestures);
+		
 			bt_conn_unref(guitar_conn.conn);
 		guitar_conn.conn = NULL;
 		guitar_conn.subscribed = false;
@@ -1182,33 +1449,100 @@ static struct bt_conn_auth_info_cb conn_auth_info_callbacks = {
 };
 
 
+static void log_boot_timing(void)
+{
+	struct boot_timing bt;
+	uint32_t us;
+	
+	ui_get_boot_timing(&bt);
+	for (int i = 0; i < bt.count; i++) {
+		const struct boot_phase *p = &bt.phases[i];
+		LOG_INF("Boot: %-12s start %6u us, %6u us%s", p->name, p->start_us,
+			boot_timing_duration(&bt, i), p->done ? "" : " (running)");
+	}
+	if (boot_timing_get_milestone(&bt, BOOT_MS_SCANNING, &us)) {
+		LOG_INF("Boot: scanning at %u ms", us / 1000);
+	}
+}
+
+/* Bluetooth ready (system workqueue): start scanning while main() may
+ * still be bringing up the rest. main() ends the bt_enable phase. */
+static void bt_ready(int err)
+{
+	bt_ready_us = latency_now_us();
+	k_sem_give(&bt_ready_sem);
+	
+	if (err) {
+		printk("Bluetooth init failed (err %d)\n", err);
+		ui_led_set_state(UI_STATE_ERROR);
+		return;
+	}
+
+	printk("Bluetooth initialized\n");
+
+	if (IS_ENABLED(CONFIG_SETTINGS)) {
+		settings_load();
+	}
+
+	scan_init();
+
+	err = bt_scan_start(BT_SCAN_TYPE_SCAN_ACTIVE);
+	if (err) {
+		printk("Scanning failed to start (err %d)\n", err);
+		ui_led_set_state(UI_STATE_ERROR);
+		return;
+	}
+
+	boot_milestone(BOOT_MS_SCANNING);
+	printk("Scanning successfully started\n");
+	
+	/* Set LED to scanning state */
+	ui_led_set_state(UI_STATE_SCANNING);
+}
+
 int main(void)
 {
 	int err;
+	int phase;
 
 	printk("Starting Bluetooth Central HIDS sample\n");
 
-	/* Initialize configuration storage */
+#ifdef CONFIG_GUITARACC_PERF
+	/* Enable cycle counter for pipeline profiling */
+	perf_init();
+#endif
+	boot_timing_init(&boot);
+	latency_init(&latency);
+#ifdef CONFIG_GUITARACC_TRACE
+	trace_init();
+#endif
+#ifdef CONFIG_GUITARACC_CAPTURE
+	capture_init();
+#endif
+
+	/* Configuration first: the pipeline and the MIDI channel need it.
+	 * Selection is on header CRCs; the SHA-256 check runs later. */
+	phase = boot_phase_begin("config");
 	err = config_storage_init();
+	
+	/* Hardcoded defaults if the storage failed */
+	current_config = config_storage_acquire();
 	if (err) {
 		LOG_ERR("Failed to initialize config storage (err %d)", err);
 		LOG_WRN("Continuing with hardcoded defaults...");
 	} else {
 		LOG_INF("Configuration storage initialized");
 		
-		/* Load configuration */
-		err = config_storage_load(&current_config);
-		if (err == 0) {
-			uint8_t patch_idx = current_config.global.default_patch;
-			if (patch_idx >= NUM_PATCHES) patch_idx = 0;
-			LOG_INF("Loaded config: MIDI ch=%d, Patch %d",
-				current_config.global.midi_channel + 1,
-				patch_idx);
-		} else {
-			/* Load hardcoded defaults if config load fails */
-			config_storage_get_hardcoded_defaults(&current_config);
-		}
+		uint8_t patch_idx = current_config->global.default_patch;
+		if (patch_idx >= NUM_PATCHES) patch_idx = 0;
+		LOG_INF("Loaded config: MIDI ch=%d, Patch %d",
+			current_config->global.midi_channel + 1,
+			patch_idx);
+		/* Hash mismatch found in the background: reload what it fell back to */
+		config_storage_set_fallback_handler(reload_config);
 	} 
+	boot_phase_end(phase, latency_now_us());
+	
 	/* Initialize UI LED subsystem */
 	err = ui_led_init();
 	if (err) {
@@ -1231,31 +1565,18 @@ int main(void)
 	
 	LOG_INF("MIDI UART initialized (interrupt-driven, RX enabled)");
 
-	/* Initialize UI interface (Zephyr Shell - no UART setup needed) */
-	err = ui_interface_init();
-	if (err) {
-		LOG_ERR("Failed to initialize UI interface (err %d)", err);
-	} else {
-		LOG_INF("UI interface ready (Zephyr Shell)");
-		/* Set config reload callback */
-		ui_config_reload_callback = reload_config;
-	}
-
-	/* Initialize virtual ports topology processor */
-	uint8_t patch_idx = current_config.global.default_patch;
-	if (patch_idx >= NUM_PATCHES) patch_idx = 0;
+	/* Initialize MIDI pipeline from the active patch */
+	phase = boot_phase_begin("pipeline");
+	midi_pipeline_init(&pipeline, pipeline_tx, NULL);
+	configure_pipeline();
+	boot_phase_end(phase, latency_now_us());
 	
-	/* Configure virtual ports system from patch configuration */
-	struct patch_topology_config *topo_config = (struct patch_topology_config *)&current_config.patches[patch_idx].topologies[0];
-	topo_proc_init(&topo_proc, topo_config);
-	
-	/* Copy function configurations */
-	for (int i = 0; i < MAX_FUNCTION_UNITS; i++) {
-		topo_proc_set_function(&topo_proc, i, &current_config.patches[patch_idx].functions[i]);
-	}
-	
-	LOG_INF("Virtual ports topology processor initialized for patch %d", patch_idx);
+	LOG_INF("Virtual ports topology processor initialized for patch %d",
+		current_config->global.default_patch);
 
+	/* Bluetooth: everything a connection needs is ready, so start the
+	 * controller now and let scanning begin from bt_ready() while the
+	 * rest of init runs */
 	bt_hogp_init(&hogp, &hogp_init_params);
 
 	err = bt_conn_auth_cb_register(&conn_auth_callbacks);
@@ -1270,22 +1591,32 @@ int main(void)
 		return 0;
 	}
 
-	printk("DEBUG: About to call bt_enable(NULL)\n");
-
-	err = bt_enable(NULL);
-	printk("DEBUG: bt_enable returned with err=%d\n", err);
+	boot_ble_phase = boot_phase_begin("bt_enable");
+	err = bt_enable(bt_ready);
 	if (err) {
 		printk("Bluetooth init failed (err %d)\n", err);
 		return 0;
 	}
 
-	printk("Bluetooth initialized\n");
-
-	if (IS_ENABLED(CONFIG_SETTINGS)) {
-		settings_load();
+	/* Program Change patch bank (separate flash region) */
+	phase = boot_phase_begin("patch_bank");
+	err = patch_store_init();
+	if (err) {
+		LOG_WRN("Patch bank unavailable (err %d), Program Change ignored", err);
 	}
+	boot_phase_end(phase, latency_now_us());
 
-	scan_init();
+	/* Initialize UI interface (Zephyr Shell - no UART setup needed) */
+	phase = boot_phase_begin("shell");
+	err = ui_interface_init();
+	if (err) {
+		LOG_ERR("Failed to initialize UI interface (err %d)", err);
+	} else {
+		LOG_INF("UI interface ready (Zephyr Shell)");
+		/* Set config reload callback */
+		ui_config_reload_callback = reload_config;
+	}
+	boot_phase_end(phase, latency_now_us());
 
 	err = dk_buttons_init(button_handler);
 	if (err) {
@@ -1293,17 +1624,14 @@ int main(void)
 		return 0;
 	}
 
-	err = bt_scan_start(BT_SCAN_TYPE_SCAN_ACTIVE);
-	if (err) {
-		printk("Scanning failed to start (err %d)\n", err);
-		ui_led_set_state(UI_STATE_ERROR);
-		return 0;
-	}
+	LOG_INF("Boot: main init done at %u ms", latency_now_us() / 1000);
 
-	printk("Scanning successfully started\n");
-	
-	/* Set LED to scanning state */
-	ui_led_set_state(UI_STATE_SCANNING);
+	/* Bluetooth normally comes up while the steps above run; wait for it
+	 * briefly so the phase table is logged once, complete */
+	if (k_sem_take(&bt_ready_sem, K_MSEC(BT_READY_WAIT_MS)) == 0) {
+		boot_phase_end(boot_ble_phase, bt_ready_us);
+	}
+	log_boot_timing();
 
 	return 0;
 }
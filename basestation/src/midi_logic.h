@@ -24,6 +24,43 @@ struct accel_data {
 	int16_t z;  /* Z-axis in milli-g */
 } __attribute__((packed));
 
+/* Timestamped sample as sent by clients that support latency tracing */
+struct accel_sample {
+	struct accel_data accel;
+	uint32_t timestamp_us;  /* Client uptime when the sample was taken */
+} __attribute__((packed));
+
+/* Angular rate from clients with a gyroscope */
+struct gyro_data {
+	int16_t x;  /* X-axis (roll) in decidegrees/s */
+	int16_t y;  /* Y-axis (pitch) in decidegrees/s */
+	int16_t z;  /* Z-axis (yaw) in decidegrees/s */
+} __attribute__((packed));
+
+/* Timestamped accel + gyro sample; fills the GYRO_ROLL/PITCH/YAW sources */
+struct imu_sample {
+	struct accel_data accel;
+	struct gyro_data gyro;
+	uint32_t timestamp_us;  /* Client uptime when the sample was taken */
+} __attribute__((packed));
+
+/* Gesture types detected by clients in edge event mode */
+enum motion_event_type {
+	MOTION_EVENT_TAP = 1,   /* Sharp hit: value is the jerk peak in milli-g */
+	MOTION_EVENT_SHAKE,     /* Sustained shake: value is the envelope in milli-g */
+	MOTION_EVENT_TILT,      /* Neck past the tilt threshold: value is pitch in decidegrees */
+};
+
+#define MOTION_EVENT_F_END  0x01  /* Gesture ended */
+
+/* Gesture start or end from a client in edge event mode */
+struct motion_event {
+	uint8_t type;           /* enum motion_event_type */
+	uint8_t flags;          /* MOTION_EVENT_F_* */
+	int16_t value;          /* Strength, see enum motion_event_type */
+	uint32_t timestamp_us;  /* Client uptime when the triggering sample was taken */
+} __attribute__((packed));
+
 /**
  * Convert milli-g value to MIDI CC value (0-127)
  * Uses the configured mapping to translate accelerometer data.
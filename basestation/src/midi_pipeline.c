@@ -0,0 +1,287 @@
+/*
+ * Motion-to-MIDI Pipeline Implementation
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "midi_pipeline.h"
+#include "midi_logic.h"
+#include "perf_profiler.h"
+#include <errno.h>
+#include <string.h>
+
+/* ========================================
+ * PIPELINE
+ * ======================================== */
+
+static void update_source_mask(struct midi_pipeline *pipe)
+{
+	pipe->source_mask = 0;
+	for (int i = 0; i < MAX_TOPOLOGY_INSTANCES; i++) {
+		const struct topology_instance *topo = &pipe->topo.topologies[i];
+		uint8_t inputs = topology_get_accel_input_count(topo->topology_type);
+
+		if (!topo->enabled) {
+			continue;
+		}
+		for (int j = 0; j < inputs; j++) {
+			if (topo->accel_inputs[j] < MAX_SENSOR_SOURCES) {
+				pipe->source_mask |= (uint16_t)(1u << topo->accel_inputs[j]);
+			}
+		}
+	}
+
+	for (int i = 0; i < GESTURE_SLOTS; i++) {
+		const struct gesture_slot *slot = &pipe->gestures.slots[i];
+
+		if (slot->type != GESTURE_NONE && slot->source < MAX_SENSOR_SOURCES) {
+			pipe->source_mask |= (uint16_t)(1u << slot->source);
+		}
+	}
+}
+
+void midi_pipeline_init(struct midi_pipeline *pipe, midi_tx_fn_t tx, void *tx_data)
+{
+	if (!pipe) {
+		return;
+	}
+
+	memset(pipe, 0, sizeof(*pipe));
+	pipe->tx = tx;
+	pipe->tx_data = tx_data;
+	topo_proc_init(&pipe->proc, &pipe->topo);
+
+	for (int i = 0; i < MAX_MIDI_OUTPUTS; i++) {
+		pipe->cc_numbers[i] = MIDI_PIPELINE_DEFAULT_CC + i;
+	}
+	memset(pipe->last_outputs, MIDI_OUTPUT_UNSENT, sizeof(pipe->last_outputs));
+}
+
+void midi_pipeline_configure(struct midi_pipeline *pipe,
+                             const struct topology_instance *topologies,
+                             uint8_t mixer_type,
+                             const struct function_unit *functions,
+                             uint8_t midi_channel, int16_t deadzone)
+{
+	if (!pipe || !topologies || !functions) {
+		return;
+	}
+
+	memset(&pipe->topo, 0, sizeof(pipe->topo));
+	memcpy(pipe->topo.topologies, topologies, sizeof(pipe->topo.topologies));
+	pipe->topo.default_mixer_type = mixer_type;
+
+	topo_proc_init(&pipe->proc, &pipe->topo);
+	for (int i = 0; i < MAX_FUNCTION_UNITS; i++) {
+		topo_proc_set_function(&pipe->proc, (uint8_t)i, &functions[i]);
+	}
+	topo_proc_compile(&pipe->proc);
+
+	/* Outputs without an enabled topology keep the default CC 16-21 */
+	for (int i = 0; i < MAX_MIDI_OUTPUTS; i++) {
+		pipe->cc_numbers[i] = MIDI_PIPELINE_DEFAULT_CC + i;
+		if (i < MAX_TOPOLOGY_INSTANCES && topologies[i].enabled) {
+			pipe->cc_numbers[i] = topologies[i].midi_outputs[0];
+		}
+	}
+
+	pipe->midi_channel = midi_channel & 0x0F;
+	pipe->deadzone = (deadzone < 0) ? 0 : deadzone;
+
+	update_source_mask(pipe);
+}
+
+static int send_gesture_events(struct midi_pipeline *pipe, int guitar_id,
+                               struct gesture_engine *ge,
+                               const struct gesture_event *events, int count)
+{
+	int sent = 0;
+
+	for (int i = 0; i < count; i++) {
+		int output = MIDI_PIPELINE_GESTURE_OUTPUT(events[i].slot);
+
+		PERF_BEGIN(t_queue);
+		int err = pipe->tx ? pipe->tx(guitar_id, output, events[i].msg, events[i].len,
+		                              pipe->tx_data) : -ENODEV;
+		PERF_END(PERF_STAGE_MIDI_QUEUE, t_queue);
+
+		if (err == 0) {
+			pipe->messages++;
+			sent++;
+		} else {
+			pipe->dropped++;
+			gesture_engine_tx_failed(ge, &events[i]);
+		}
+	}
+
+	return sent;
+}
+
+void midi_pipeline_set_gestures(struct midi_pipeline *pipe,
+                                const struct gesture_config *gestures)
+{
+	if (!pipe) {
+		return;
+	}
+
+	if (gestures) {
+		memcpy(&pipe->gestures, gestures, sizeof(pipe->gestures));
+	} else {
+		memset(&pipe->gestures, 0, sizeof(pipe->gestures));
+	}
+	update_source_mask(pipe);
+}
+
+int midi_pipeline_process_gestures(struct midi_pipeline *pipe, int guitar_id,
+                                   struct gesture_engine *ge,
+                                   const int16_t accel_values[MAX_SENSOR_SOURCES])
+{
+	struct gesture_event events[GESTURE_MAX_EVENTS];
+
+	if (!pipe || !ge || !accel_values) {
+		return 0;
+	}
+
+	PERF_BEGIN(t_gesture);
+	int count = gesture_engine_process(ge, &pipe->gestures, accel_values,
+	                                   pipe->midi_channel, events);
+	PERF_END(PERF_STAGE_GESTURE, t_gesture);
+
+	return send_gesture_events(pipe, guitar_id, ge, events, count);
+}
+
+int midi_pipeline_process_remote_gesture(struct midi_pipeline *pipe, int guitar_id,
+                                         struct gesture_engine *ge, uint8_t type,
+                                         bool end, int16_t level)
+{
+	struct gesture_event events[GESTURE_MAX_EVENTS];
+
+	if (!pipe || !ge) {
+		return 0;
+	}
+
+	PERF_BEGIN(t_gesture);
+	int count = gesture_engine_remote_event(ge, &pipe->gestures, type, end, level,
+	                                        pipe->midi_channel, events);
+	PERF_END(PERF_STAGE_GESTURE, t_gesture);
+
+	return send_gesture_events(pipe, guitar_id, ge, events, count);
+}
+
+int midi_pipeline_release_gestures(struct midi_pipeline *pipe, int guitar_id,
+                                   struct gesture_engine *ge)
+{
+	struct gesture_event events[GESTURE_MAX_EVENTS];
+
+	if (!pipe || !ge) {
+		return 0;
+	}
+
+	int count = gesture_engine_release(ge, pipe->midi_channel, events);
+	return send_gesture_events(pipe, guitar_id, ge, events, count);
+}
+
+int midi_pipeline_process(struct midi_pipeline *pipe, int guitar_id,
+                          const int16_t accel_values[MAX_SENSOR_SOURCES])
+{
+	int sent = 0;
+
+	if (!pipe || !accel_values) {
+		return 0;
+	}
+
+	pipe->samples++;
+
+	topo_proc_set_accel_inputs(&pipe->proc, accel_values);
+	PERF_BEGIN(t_topo);
+	topo_proc_execute(&pipe->proc);
+	PERF_END(PERF_STAGE_TOPO_EXECUTE, t_topo);
+	topo_proc_get_all_midi_outputs(&pipe->proc, pipe->outputs);
+
+	for (int i = 0; i < MAX_MIDI_OUTPUTS; i++) {
+		uint8_t value = pipe->outputs[i];
+		int16_t delta = (int16_t)value - (int16_t)pipe->last_outputs[i];
+
+		if (delta < 0) {
+			delta = -delta;
+		}
+		if (pipe->last_outputs[i] != MIDI_OUTPUT_UNSENT && delta < pipe->deadzone) {
+			continue;
+		}
+
+		uint8_t msg[3];
+		construct_midi_cc_msg(pipe->midi_channel, pipe->cc_numbers[i], value, msg);
+
+		PERF_BEGIN(t_queue);
+		int err = pipe->tx ? pipe->tx(guitar_id, i, msg, sizeof(msg), pipe->tx_data) : -ENODEV;
+		PERF_END(PERF_STAGE_MIDI_QUEUE, t_queue);
+
+		if (err == 0) {
+			pipe->messages++;
+			sent++;
+		} else {
+			pipe->dropped++;
+		}
+		pipe->last_outputs[i] = value;
+	}
+
+	return sent;
+}
+
+void midi_pipeline_resend_all(struct midi_pipeline *pipe)
+{
+	if (pipe) {
+		memset(pipe->last_outputs, MIDI_OUTPUT_UNSENT, sizeof(pipe->last_outputs));
+	}
+}
+
+/* ========================================
+ * UART MODEL
+ * ======================================== */
+
+void midi_uart_model_init(struct midi_uart_model *uart)
+{
+	if (uart) {
+		memset(uart, 0, sizeof(*uart));
+	}
+}
+
+int midi_uart_model_queue(struct midi_uart_model *uart, uint32_t now_us,
+                          size_t len, uint32_t *done_us)
+{
+	uint32_t backlog_us = 0;
+
+	if (!uart) {
+		return -EINVAL;
+	}
+
+	if (uart->busy_valid && (int32_t)(uart->busy_until_us - now_us) > 0) {
+		backlog_us = uart->busy_until_us - now_us;
+	}
+
+	/* Bytes still in the ring: all but the one being shifted out */
+	size_t queued = 0;
+	if (backlog_us > 0) {
+		queued = (backlog_us + MIDI_BYTE_TIME_US - 1) / MIDI_BYTE_TIME_US - 1;
+	}
+
+	if (!midi_tx_fits(queued, len)) {
+		uart->dropped++;
+		return -ENOMEM;
+	}
+
+	if (backlog_us > uart->max_backlog_us) {
+		uart->max_backlog_us = backlog_us;
+	}
+
+	uint32_t start_us = (backlog_us > 0) ? uart->busy_until_us : now_us;
+	uart->busy_until_us = start_us + (uint32_t)len * MIDI_BYTE_TIME_US;
+	uart->busy_valid = true;
+	uart->queued++;
+
+	if (done_us) {
+		*done_us = uart->busy_until_us;
+	}
+	return 0;
+}
@@ -0,0 +1,251 @@
+/*
+ * Motion-to-MIDI Pipeline
+ * Per-sample path from accelerometer values to queued MIDI CC messages
+ *
+ * Runs the topology processor, applies the patch CC numbers and deadzone,
+ * builds each message with construct_midi_cc_msg() and hands it to a TX
+ * backend. The firmware backend is the UART0 ring in main.c; host tools
+ * plug in midi_uart_model, which applies the same queue admission rule
+ * with simulated timestamps.
+ *
+ * Pure logic with no hardware dependencies - can be tested on host.
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef MIDI_PIPELINE_H
+#define MIDI_PIPELINE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "topology_processor.h"
+#include "gesture_engine.h"
+
+/* ========================================
+ * CONSTANTS
+ * ======================================== */
+
+#define MIDI_PIPELINE_DEFAULT_CC  16    /* CC for output i without a topology: 16 + i */
+#define MIDI_OUTPUT_UNSENT        255   /* last_outputs[] marker: always send */
+
+/* TX output index for gesture slot n (after the CC outputs) */
+#define MIDI_PIPELINE_GESTURE_OUTPUT(n)  (MAX_MIDI_OUTPUTS + (n))
+#define MIDI_PIPELINE_NUM_OUTPUTS        (MAX_MIDI_OUTPUTS + GESTURE_SLOTS)
+
+/* MIDI DIN TX ring (UART0) */
+#define MIDI_TX_QUEUE_SIZE  16
+#define MIDI_TX_MAX_QUEUED  6     /* Don't write if more than this many bytes queued */
+#define MIDI_BYTE_TIME_US   320   /* 10 bits per byte at 31250 baud */
+
+/* ========================================
+ * DATA STRUCTURES
+ * ======================================== */
+
+/**
+ * @brief TX backend: queue one complete MIDI message
+ *
+ * @param guitar_id Guitar the sample came from
+ * @param output MIDI output index (0 to MAX_MIDI_OUTPUTS-1), or
+ *               MIDI_PIPELINE_GESTURE_OUTPUT(slot) for gesture messages
+ * @param msg Message bytes
+ * @param len Message length
+ * @param user_data Pointer given to midi_pipeline_init()
+ * @return 0 if queued, negative errno if dropped
+ */
+typedef int (*midi_tx_fn_t)(int guitar_id, int output, const uint8_t *msg,
+                            size_t len, void *user_data);
+
+/**
+ * @brief Pipeline state
+ *
+ * One instance is shared by all guitars, as in the firmware.
+ */
+struct midi_pipeline {
+	struct topology_processor proc;
+	struct patch_topology_config topo;             /* Active patch topology */
+	struct gesture_config gestures;                /* Active patch gestures */
+	uint8_t cc_numbers[MAX_MIDI_OUTPUTS];          /* Resolved at configure */
+	uint8_t last_outputs[MAX_MIDI_OUTPUTS];        /* Last value handed to TX */
+	uint8_t outputs[MAX_MIDI_OUTPUTS];             /* Outputs of the last sample */
+	uint8_t midi_channel;
+	int16_t deadzone;
+	uint16_t source_mask;                          /* Bit n: source n read by a topology or gesture */
+
+	midi_tx_fn_t tx;
+	void *tx_data;
+
+	/* Statistics */
+	uint32_t samples;
+	uint32_t messages;    /* Accepted by the TX backend */
+	uint32_t dropped;     /* Rejected by the TX backend */
+};
+
+/**
+ * @brief Host model of the MIDI UART and its TX ring
+ *
+ * Bytes leave one every MIDI_BYTE_TIME_US; a message is admitted by the
+ * same rule as queue_midi_bytes().
+ */
+struct midi_uart_model {
+	uint32_t busy_until_us;   /* Time the last queued byte finishes */
+	bool busy_valid;          /* Anything queued since init */
+	uint32_t max_backlog_us;
+	uint32_t queued;          /* Messages admitted */
+	uint32_t dropped;         /* Messages rejected */
+};
+
+/* ========================================
+ * PIPELINE API
+ * ======================================== */
+
+/**
+ * @brief Initialize pipeline with an empty patch
+ *
+ * @param pipe Pipeline state
+ * @param tx TX backend
+ * @param tx_data Passed to the TX backend
+ */
+void midi_pipeline_init(struct midi_pipeline *pipe, midi_tx_fn_t tx, void *tx_data);
+
+/**
+ * @brief Load a patch
+ *
+ * Copies the topology and function units, so the caller's config can
+ * change afterwards, and compiles them for the per-sample path. Values
+ * already sent are kept: only outputs that change under the new patch
+ * are re-sent. source_mask is rebuilt so the caller computes only the
+ * derived sources the patch reads. Gestures are set separately and are
+ * kept.
+ *
+ * @param pipe Pipeline state
+ * @param topologies MAX_TOPOLOGY_INSTANCES topology instances
+ * @param mixer_type Default virtual port mixer (enum vport_mixer_type)
+ * @param functions MAX_FUNCTION_UNITS function units
+ * @param midi_channel MIDI channel (0-15)
+ * @param deadzone Minimum CC change to send (negative treated as 0)
+ */
+void midi_pipeline_configure(struct midi_pipeline *pipe,
+                             const struct topology_instance *topologies,
+                             uint8_t mixer_type,
+                             const struct function_unit *functions,
+                             uint8_t midi_channel, int16_t deadzone);
+
+/**
+ * @brief Run one sample through the pipeline
+ *
+ * An output whose TX is rejected still counts as sent, so it is not
+ * retried until its value changes again.
+ *
+ * @param pipe Pipeline state
+ * @param guitar_id Guitar the sample came from (passed to TX)
+ * @param accel_values Inputs: X, Y, Z, Roll, Pitch, Yaw, then the derived
+ *                     sources (see derived_sources.h)
+ * @return Number of messages accepted by the TX backend
+ */
+int midi_pipeline_process(struct midi_pipeline *pipe, int guitar_id,
+                          const int16_t accel_values[MAX_SENSOR_SOURCES]);
+
+/**
+ * @brief Load the gesture slots of a patch
+ *
+ * Invalid slots are kept but never fire (see gesture_engine_process()).
+ *
+ * @param pipe Pipeline state
+ * @param gestures Gesture configuration, NULL for none
+ */
+void midi_pipeline_set_gestures(struct midi_pipeline *pipe,
+                                const struct gesture_config *gestures);
+
+/**
+ * @brief Run gesture detection for one sample and send its messages
+ *
+ * Call before midi_pipeline_process() with the same values, so note and
+ * trigger messages reach the TX ring ahead of the CC burst. Messages are
+ * not subject to the deadzone. A rejected Note Off is retried on the
+ * next sample.
+ *
+ * @param pipe Pipeline state
+ * @param guitar_id Guitar the sample came from (passed to TX)
+ * @param ge Gesture state of that guitar
+ * @param accel_values Sources, as for midi_pipeline_process()
+ * @return Number of messages accepted by the TX backend
+ */
+int midi_pipeline_process_gestures(struct midi_pipeline *pipe, int guitar_id,
+                                   struct gesture_engine *ge,
+                                   const int16_t accel_values[MAX_SENSOR_SOURCES]);
+
+/**
+ * @brief Send the messages for a gesture the client detected
+ *
+ * For clients in edge event mode (see gesture_engine_remote_event()).
+ *
+ * @param pipe Pipeline state
+ * @param guitar_id Guitar the event came from (passed to TX)
+ * @param ge Gesture state of that guitar
+ * @param type Gesture type (GESTURE_TAP, GESTURE_SHAKE or GESTURE_TILT)
+ * @param end true for the end of the gesture
+ * @param level Strength, in the units of the slot's source
+ * @return Number of messages accepted by the TX backend
+ */
+int midi_pipeline_process_remote_gesture(struct midi_pipeline *pipe, int guitar_id,
+                                         struct gesture_engine *ge, uint8_t type,
+                                         bool end, int16_t level);
+
+/**
+ * @brief Send Note Off for every gesture note a guitar has sounding
+ *
+ * Call when the guitar disconnects. Detection state is reset.
+ *
+ * @param pipe Pipeline state
+ * @param guitar_id Guitar (passed to TX)
+ * @param ge Gesture state of that guitar
+ * @return Number of messages accepted by the TX backend
+ */
+int midi_pipeline_release_gestures(struct midi_pipeline *pipe, int guitar_id,
+                                   struct gesture_engine *ge);
+
+/**
+ * @brief Forget sent values so every output is sent on the next sample
+ *
+ * @param pipe Pipeline state
+ */
+void midi_pipeline_resend_all(struct midi_pipeline *pipe);
+
+/* ========================================
+ * TX QUEUE API
+ * ======================================== */
+
+/**
+ * @brief TX ring admission rule
+ *
+ * @param queued Bytes waiting in the ring
+ * @param len Message length
+ * @return true if the whole message may be queued
+ */
+static inline bool midi_tx_fits(size_t queued, size_t len)
+{
+	return queued <= MIDI_TX_MAX_QUEUED && len <= (MIDI_TX_QUEUE_SIZE - 1) - queued;
+}
+
+/**
+ * @brief Reset UART model
+ *
+ * @param uart UART model
+ */
+void midi_uart_model_init(struct midi_uart_model *uart);
+
+/**
+ * @brief Queue a message on the UART model
+ *
+ * @param uart UART model
+ * @param now_us Current simulated time
+ * @param len Message length
+ * @param done_us Output: time the last byte finishes (may be NULL)
+ * @return 0 if queued, -ENOMEM if the firmware ring would drop it
+ */
+int midi_uart_model_queue(struct midi_uart_model *uart, uint32_t now_us,
+                          size_t len, uint32_t *done_us);
+
+#endif /* MIDI_PIPELINE_H */
@@ -0,0 +1,165 @@
+/*
+ * Motion Capture Recorder Implementation
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "motion_capture.h"
+#include <string.h>
+
+#ifdef __ZEPHYR__
+#include <zephyr/kernel.h>
+#endif
+
+/* ========================================
+ * PRIVATE STATE
+ * ======================================== */
+
+static struct capture_record ring[CAPTURE_RING_SIZE];
+static size_t ring_head;       /* Oldest record */
+static size_t ring_count;
+static uint32_t ring_overwritten;
+static volatile bool recording;
+
+#ifdef __ZEPHYR__
+#define CAPTURE_LOCK()      unsigned int _capture_key = irq_lock()
+#define CAPTURE_UNLOCK()    irq_unlock(_capture_key)
+#else
+#define CAPTURE_LOCK()      do { } while (0)
+#define CAPTURE_UNLOCK()    do { } while (0)
+#endif
+
+/* ========================================
+ * API FUNCTIONS
+ * ======================================== */
+
+void capture_init(void)
+{
+	CAPTURE_LOCK();
+	recording = false;
+	ring_head = 0;
+	ring_count = 0;
+	ring_overwritten = 0;
+	CAPTURE_UNLOCK();
+}
+
+void capture_start(bool clear)
+{
+	CAPTURE_LOCK();
+	if (clear) {
+		ring_head = 0;
+		ring_count = 0;
+		ring_overwritten = 0;
+	}
+	recording = true;
+	CAPTURE_UNLOCK();
+}
+
+void capture_stop(void)
+{
+	recording = false;
+}
+
+bool capture_active(void)
+{
+	return recording;
+}
+
+void capture_record(uint8_t guitar, uint32_t timestamp_us, uint8_t flags,
+		    int16_t x, int16_t y, int16_t z,
+		    int16_t gx, int16_t gy, int16_t gz)
+{
+	if (!recording) {
+		return;
+	}
+
+	CAPTURE_LOCK();
+
+	size_t slot;
+
+	if (ring_count == CAPTURE_RING_SIZE) {
+		slot = ring_head;
+		ring_head = (ring_head + 1) % CAPTURE_RING_SIZE;
+		ring_overwritten++;
+	} else {
+		slot = (ring_head + ring_count) % CAPTURE_RING_SIZE;
+		ring_count++;
+	}
+
+	struct capture_record *rec = &ring[slot];
+	rec->timestamp_us = timestamp_us;
+	rec->guitar = guitar;
+	rec->flags = flags;
+	rec->x = x;
+	rec->y = y;
+	rec->z = z;
+	rec->gx = gx;
+	rec->gy = gy;
+	rec->gz = gz;
+
+	CAPTURE_UNLOCK();
+}
+
+size_t capture_count(void)
+{
+	return ring_count;
+}
+
+uint32_t capture_overwritten(void)
+{
+	return ring_overwritten;
+}
+
+int capture_get(size_t index, struct capture_record *rec)
+{
+	int ret = -1;
+
+	if (!rec) {
+		return -1;
+	}
+
+	CAPTURE_LOCK();
+	if (index < ring_count) {
+		memcpy(rec, &ring[(ring_head + index) % CAPTURE_RING_SIZE], sizeof(*rec));
+		ret = 0;
+	}
+	CAPTURE_UNLOCK();
+
+	return ret;
+}
+
+void capture_fill_header(struct capture_header *hdr)
+{
+	if (!hdr) {
+		return;
+	}
+
+	CAPTURE_LOCK();
+	hdr->magic = CAPTURE_MAGIC;
+	hdr->version = CAPTURE_VERSION;
+	hdr->record_size = sizeof(struct capture_record);
+	hdr->flags = ring_overwritten ? CAPTURE_H_WRAPPED : 0;
+	hdr->reserved = 0;
+	hdr->record_count = (uint32_t)ring_count;
+	hdr->overwritten = ring_overwritten;
+	CAPTURE_UNLOCK();
+}
+
+int capture_check_header(const struct capture_header *hdr, size_t data_len)
+{
+	if (!hdr) {
+		return -1;
+	}
+
+	if (hdr->magic != CAPTURE_MAGIC || hdr->version != CAPTURE_VERSION ||
+	    hdr->record_size != sizeof(struct capture_record)) {
+		return -1;
+	}
+
+	if ((size_t)hdr->record_count * sizeof(struct capture_record) > data_len) {
+		return -1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,154 @@
+/*
+ * Motion Capture Recorder
+ * RAM ring of timestamped motion samples for offline replay
+ *
+ * Every accel, accel+gyro and edge event notification is copied into a
+ * fixed-size record ring as it arrives, before any processing. The ring keeps the most recent
+ * CAPTURE_RING_SIZE samples; stopping the capture freezes it so a glitch
+ * seen on stage can be dumped afterwards ("capture dump") and replayed
+ * through the real pipeline on the host (integration_test/replay).
+ *
+ * Capture file layout (little-endian):
+ *   struct capture_header, then record_count x struct capture_record,
+ *   oldest first.
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef MOTION_CAPTURE_H
+#define MOTION_CAPTURE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* ========================================
+ * CONSTANTS
+ * ======================================== */
+
+#ifdef CONFIG_GUITARACC_CAPTURE_RECORDS
+#define CAPTURE_RING_SIZE   CONFIG_GUITARACC_CAPTURE_RECORDS
+#else
+#define CAPTURE_RING_SIZE   2048    /* 36 KB, ~20 s of one guitar at 100 Hz */
+#endif
+
+#define CAPTURE_MAGIC       0x50414347  /* "GCAP" */
+#define CAPTURE_VERSION     2
+
+#define CAPTURE_MAX_GUITARS 4
+
+/* Record flags */
+#define CAPTURE_F_TIMED     0x01    /* Client sent a timestamped sample */
+#define CAPTURE_F_GYRO      0x02    /* gx/gy/gz hold the client's angular rate */
+#define CAPTURE_F_EVENT     0x04    /* Edge event: x = type, y = flags, z = value */
+
+/* Header flags */
+#define CAPTURE_H_WRAPPED   0x01    /* Older records were overwritten */
+
+/* ========================================
+ * DATA STRUCTURES
+ * ======================================== */
+
+/**
+ * @brief Capture file header (16 bytes)
+ */
+struct capture_header {
+	uint32_t magic;
+	uint8_t version;
+	uint8_t record_size;      /* sizeof(struct capture_record) */
+	uint8_t flags;            /* CAPTURE_H_* */
+	uint8_t reserved;
+	uint32_t record_count;
+	uint32_t overwritten;     /* Records lost to ring wrap before the first one */
+} __attribute__((packed));
+
+/**
+ * @brief One captured sample (18 bytes)
+ */
+struct capture_record {
+	uint32_t timestamp_us;    /* Basestation receive time */
+	uint8_t guitar;           /* Guitar id passed to process_accel_data() */
+	uint8_t flags;            /* CAPTURE_F_* */
+	int16_t x;                /* milli-g */
+	int16_t y;
+	int16_t z;
+	int16_t gx;               /* decidegrees/s, 0 without CAPTURE_F_GYRO */
+	int16_t gy;
+	int16_t gz;
+} __attribute__((packed));
+
+/* ========================================
+ * API FUNCTIONS
+ * ======================================== */
+
+/**
+ * @brief Clear the ring and stop recording
+ */
+void capture_init(void);
+
+/**
+ * @brief Start recording
+ *
+ * @param clear Discard records from a previous capture
+ */
+void capture_start(bool clear);
+
+/**
+ * @brief Stop recording and freeze the ring
+ */
+void capture_stop(void);
+
+/**
+ * @brief Check whether samples are being recorded
+ */
+bool capture_active(void);
+
+/**
+ * @brief Hot-path entry: append one sample if recording
+ *
+ * Overwrites the oldest record when the ring is full.
+ *
+ * @param guitar Guitar id
+ * @param timestamp_us Receive time in microseconds
+ * @param flags CAPTURE_F_* flags
+ * @param x,y,z Acceleration in milli-g (event fields with CAPTURE_F_EVENT)
+ * @param gx,gy,gz Angular rate in decidegrees/s (with CAPTURE_F_GYRO)
+ */
+void capture_record(uint8_t guitar, uint32_t timestamp_us, uint8_t flags,
+		    int16_t x, int16_t y, int16_t z,
+		    int16_t gx, int16_t gy, int16_t gz);
+
+/**
+ * @brief Number of records currently held
+ */
+size_t capture_count(void);
+
+/**
+ * @brief Records overwritten since the capture was started
+ */
+uint32_t capture_overwritten(void);
+
+/**
+ * @brief Copy a record without removing it
+ *
+ * @param index 0 = oldest record held
+ * @return 0 on success, -1 if index is out of range
+ */
+int capture_get(size_t index, struct capture_record *rec);
+
+/**
+ * @brief Fill a file header describing the records currently held
+ */
+void capture_fill_header(struct capture_header *hdr);
+
+/**
+ * @brief Validate a file header read from a capture file
+ *
+ * @param hdr Header
+ * @param data_len Bytes following the header
+ * @return 0 if valid, -1 on bad magic/version/record size or truncated data
+ */
+int capture_check_header(const struct capture_header *hdr, size_t data_len);
+
+#endif /* MOTION_CAPTURE_H */
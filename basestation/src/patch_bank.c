@@ -0,0 +1,195 @@
+/*
+ * Patch Bank Implementation
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "patch_bank.h"
+#include "config_journal.h"
+#include <errno.h>
+#include <string.h>
+
+static int find_slot(const struct patch_bank *bank, uint8_t program)
+{
+	for (int i = 0; i < PATCH_BANK_CACHE_SLOTS; i++) {
+		if (bank->cache[i].valid && bank->cache[i].program == program) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+/* Free slot, or the least recently used one that is not in use */
+static int victim_slot(struct patch_bank *bank)
+{
+	int victim = -1;
+
+	for (int i = 0; i < PATCH_BANK_CACHE_SLOTS; i++) {
+		if (!bank->cache[i].valid) {
+			return i;
+		}
+		if (i != bank->last &&
+		    (victim < 0 || bank->cache[i].last_used < bank->cache[victim].last_used)) {
+			victim = i;
+		}
+	}
+	bank->stats.evictions++;
+	return victim;
+}
+
+/* Read and check a record into a cache slot; -1 if it cannot be used */
+static int load_slot(struct patch_bank *bank, uint8_t program)
+{
+	static struct patch_record rec;
+
+	if (!bank->read || bank->read(bank->ctx, program, &rec) != 0 ||
+	    patch_record_check(&rec) != 0) {
+		bank->stats.errors++;
+		return -1;
+	}
+
+	int slot = victim_slot(bank);
+	struct patch_bank_entry *e = &bank->cache[slot];
+
+	memcpy(&e->patch, &rec.patch, sizeof(e->patch));
+	e->program = program;
+	e->valid = true;
+	e->last_used = ++bank->clock;
+	return slot;
+}
+
+void patch_bank_init(struct patch_bank *bank, patch_bank_read_fn read, void *ctx)
+{
+	if (!bank) {
+		return;
+	}
+
+	memset(bank, 0, sizeof(*bank));
+	bank->read = read;
+	bank->ctx = ctx;
+	bank->last = -1;
+}
+
+void patch_bank_set_stored(struct patch_bank *bank, uint8_t program, bool stored)
+{
+	if (!bank || program >= PATCH_BANK_PROGRAMS) {
+		return;
+	}
+
+	if (stored) {
+		bank->stored[program / 8] |= (uint8_t)(1 << (program % 8));
+		return;
+	}
+
+	bank->stored[program / 8] &= (uint8_t)~(1 << (program % 8));
+
+	int slot = find_slot(bank, program);
+	if (slot >= 0) {
+		bank->cache[slot].valid = false;
+		if (slot == bank->last) {
+			bank->last = -1;
+		}
+	}
+}
+
+bool patch_bank_is_stored(const struct patch_bank *bank, uint8_t program)
+{
+	if (!bank || program >= PATCH_BANK_PROGRAMS) {
+		return false;
+	}
+	return (bank->stored[program / 8] & (1 << (program % 8))) != 0;
+}
+
+int patch_bank_count(const struct patch_bank *bank)
+{
+	int count = 0;
+
+	for (int p = 0; p < PATCH_BANK_PROGRAMS; p++) {
+		count += patch_bank_is_stored(bank, (uint8_t)p);
+	}
+	return count;
+}
+
+const struct patch_config *patch_bank_get(struct patch_bank *bank, uint8_t program)
+{
+	if (!patch_bank_is_stored(bank, program)) {
+		return NULL;
+	}
+
+	int slot = find_slot(bank, program);
+	if (slot >= 0) {
+		bank->stats.hits++;
+		bank->cache[slot].last_used = ++bank->clock;
+	} else {
+		bank->stats.misses++;
+		slot = load_slot(bank, program);
+		if (slot < 0) {
+			return NULL;
+		}
+	}
+
+	bank->last = slot;
+	return &bank->cache[slot].patch;
+}
+
+int patch_bank_prefetch(struct patch_bank *bank, uint8_t program)
+{
+	int loaded = 0;
+
+	if (!bank) {
+		return 0;
+	}
+
+	for (int d = 1; d <= PATCH_BANK_PREFETCH; d++) {
+		int neighbours[2] = {program + d, program - d};
+
+		for (int k = 0; k < 2; k++) {
+			int p = neighbours[k];
+
+			if (p < 0 || p >= PATCH_BANK_PROGRAMS ||
+			    !patch_bank_is_stored(bank, (uint8_t)p) ||
+			    find_slot(bank, (uint8_t)p) >= 0) {
+				continue;
+			}
+			if (load_slot(bank, (uint8_t)p) >= 0) {
+				bank->stats.prefetches++;
+				loaded++;
+			}
+		}
+	}
+	return loaded;
+}
+
+void patch_bank_update(struct patch_bank *bank, uint8_t program,
+                       const struct patch_config *patch)
+{
+	if (!bank || !patch || program >= PATCH_BANK_PROGRAMS) {
+		return;
+	}
+
+	patch_bank_set_stored(bank, program, true);
+
+	int slot = find_slot(bank, program);
+	if (slot >= 0) {
+		memcpy(&bank->cache[slot].patch, patch, sizeof(*patch));
+	}
+}
+
+void patch_record_encode(struct patch_record *rec, const struct patch_config *patch)
+{
+	memset(rec, 0, sizeof(*rec));
+	rec->version = PATCH_RECORD_VERSION;
+	rec->size = sizeof(rec->patch);
+	memcpy(&rec->patch, patch, sizeof(rec->patch));
+	rec->crc32 = config_journal_crc32((const uint8_t *)&rec->patch, sizeof(rec->patch));
+}
+
+int patch_record_check(const struct patch_record *rec)
+{
+	if (rec->version != PATCH_RECORD_VERSION || rec->size != sizeof(rec->patch) ||
+	    rec->crc32 != config_journal_crc32((const uint8_t *)&rec->patch, sizeof(rec->patch))) {
+		return -EBADMSG;
+	}
+	return 0;
+}
@@ -0,0 +1,202 @@
+/*
+ * Patch Bank
+ * RAM cache of the 128 Program Change patches stored in flash
+ *
+ * Every program (0-127) can have its own patch record in flash, separate
+ * from the global configuration, so storing one patch never rewrites the
+ * others or the global settings. The bank keeps an index of which
+ * programs are stored and an LRU cache of PATCH_BANK_CACHE_SLOTS decoded,
+ * CRC-checked patches, ready to load into the pipeline.
+ *
+ * A Program Change for a cached patch costs no flash access. An uncached
+ * one costs exactly one record read through the backend (one
+ * sizeof(struct patch_record) read and a CRC), so the switch time is
+ * bounded whatever the cache state. After a switch the neighbouring
+ * programs are prefetched, since setlists usually step through programs
+ * in order.
+ *
+ * The backend (flash, or RAM in the host tests) is a read callback; the
+ * bank itself never writes.
+ *
+ * Pure logic with no hardware dependencies - can be tested on host.
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef PATCH_BANK_H
+#define PATCH_BANK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "topology_config.h"
+#include "function_units.h"
+#include "gesture_engine.h"
+
+/* ========================================
+ * CONSTANTS
+ * ======================================== */
+
+#define PATCH_BANK_PROGRAMS      128    /* Program Change 0-127 */
+#define PATCH_BANK_CACHE_SLOTS   8      /* Decoded patches held in RAM */
+#define PATCH_BANK_PREFETCH      1      /* Neighbours prefetched on each side */
+#define PATCH_RECORD_VERSION     1
+
+/* ========================================
+ * DATA STRUCTURES
+ * ======================================== */
+
+/**
+ * @brief Patch configuration structure
+ *
+ * Patch-specific settings that can vary between different
+ * performances, songs, or sound designs. Stored in config_data and as
+ * patch bank records.
+ */
+struct patch_config {
+	/* LED configuration */
+	uint8_t led_mode;              /* LED mode (0-3) */
+
+	/* MIDI threshold */
+	int16_t midi_deadzone;         /* MIDI CC change threshold for transmission */
+
+	/* Patch metadata */
+	char patch_name[32];           /* Patch name (null-terminated) */
+
+	/* Virtual ports topology configuration */
+	struct topology_instance topologies[MAX_TOPOLOGY_INSTANCES];  /* 6 × 12 = 72 bytes */
+	struct function_unit functions[MAX_FUNCTION_UNITS];           /* 8 × 16 = 128 bytes */
+	uint8_t default_mixer_type;                                   /* Default mixing algorithm */
+
+	/* Gesture slots (notes and triggers) */
+	struct gesture_config gestures;                               /* 3 × 6 = 18 bytes */
+
+	/* Reserved for future patch settings */
+	uint8_t reserved[1];           /* Future expansion (1 byte for 4-byte alignment) */
+} __attribute__((packed));
+
+/**
+ * @brief Flash record of one bank patch
+ */
+struct patch_record {
+	uint16_t version;              /* PATCH_RECORD_VERSION */
+	uint16_t size;                 /* sizeof(struct patch_config) */
+	uint32_t crc32;                /* CRC-32 of patch */
+	struct patch_config patch;
+} __attribute__((packed));
+
+/**
+ * @brief Read the record of a program from the backend
+ *
+ * @return 0 on success, -ENOENT if the program is not stored,
+ *         other negative errno on failure
+ */
+typedef int (*patch_bank_read_fn)(void *ctx, uint8_t program, struct patch_record *rec);
+
+/**
+ * @brief Cache slot
+ */
+struct patch_bank_entry {
+	struct patch_config patch;
+	uint32_t last_used;            /* LRU clock when last returned or prefetched */
+	uint8_t program;
+	bool valid;
+};
+
+/**
+ * @brief Cache statistics
+ */
+struct patch_bank_stats {
+	uint32_t hits;                 /* patch_bank_get() served from RAM */
+	uint32_t misses;               /* patch_bank_get() that read the backend */
+	uint32_t prefetches;           /* Neighbours read ahead */
+	uint32_t evictions;            /* Cached patches dropped for another */
+	uint32_t errors;               /* Backend failures and bad records */
+};
+
+/**
+ * @brief Patch bank state
+ */
+struct patch_bank {
+	struct patch_bank_entry cache[PATCH_BANK_CACHE_SLOTS];
+	uint8_t stored[PATCH_BANK_PROGRAMS / 8];   /* Index: programs with a record */
+	patch_bank_read_fn read;
+	void *ctx;
+	uint32_t clock;                /* LRU clock */
+	int last;                      /* Slot last returned by patch_bank_get(), -1 if none */
+	struct patch_bank_stats stats;
+};
+
+/* ========================================
+ * API
+ * ======================================== */
+
+/**
+ * @brief Initialize an empty bank (no programs stored, cache empty)
+ *
+ * @param bank Bank state
+ * @param read Backend read callback
+ * @param ctx Passed to read
+ */
+void patch_bank_init(struct patch_bank *bank, patch_bank_read_fn read, void *ctx);
+
+/**
+ * @brief Mark a program stored or not (index kept by the backend owner)
+ *
+ * Marking a program not stored also drops it from the cache.
+ */
+void patch_bank_set_stored(struct patch_bank *bank, uint8_t program, bool stored);
+
+/**
+ * @brief Check whether a program has a record
+ */
+bool patch_bank_is_stored(const struct patch_bank *bank, uint8_t program);
+
+/**
+ * @brief Number of programs with a record
+ */
+int patch_bank_count(const struct patch_bank *bank);
+
+/**
+ * @brief Get a program's patch, reading it on a cache miss
+ *
+ * The pointer stays valid until the next patch_bank_get(),
+ * patch_bank_prefetch() or patch_bank_update() call; the slot returned
+ * last is never evicted by a prefetch.
+ *
+ * @param bank Bank state
+ * @param program Program number (0-127)
+ * @return Patch, or NULL if the program is not stored or its record is bad
+ */
+const struct patch_config *patch_bank_get(struct patch_bank *bank, uint8_t program);
+
+/**
+ * @brief Read the stored neighbours of a program into the cache
+ *
+ * @param bank Bank state
+ * @param program Program just selected
+ * @return Number of patches read
+ */
+int patch_bank_prefetch(struct patch_bank *bank, uint8_t program);
+
+/**
+ * @brief Refresh a program after its record was rewritten
+ *
+ * Marks it stored and replaces its cached copy, if any.
+ */
+void patch_bank_update(struct patch_bank *bank, uint8_t program,
+                       const struct patch_config *patch);
+
+/**
+ * @brief Fill a record for a patch (version, size and CRC)
+ */
+void patch_record_encode(struct patch_record *rec, const struct patch_config *patch);
+
+/**
+ * @brief Check a record read from flash
+ *
+ * @return 0 if valid, -EBADMSG on a bad version, size or CRC
+ */
+int patch_record_check(const struct patch_record *rec);
+
+#endif /* PATCH_BANK_H */
@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "patch_store.h"
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/flash.h>
+#include <zephyr/fs/nvs.h>
+#include <zephyr/logging/log.h>
+#include <pm_config.h>
+#include <string.h>
+
+LOG_MODULE_REGISTER(patch_store, LOG_LEVEL_INF);
+
+/* Internal flash device (same as config_storage) */
+#define FLASH_DEVICE DEVICE_DT_GET(DT_CHOSEN(zephyr_flash_controller))
+
+/* Bank region: the patch_bank partition (pm_static.yml), 48KB directly
+ * below the config storage. 128 records of ~260 bytes plus NVS overhead
+ * need ~36KB; the rest is headroom for garbage collection.
+ */
+#define PATCH_BANK_OFFSET       PM_PATCH_BANK_ADDRESS
+#define PATCH_BANK_SECTOR_SIZE  4096
+#define PATCH_BANK_SECTORS      (PM_PATCH_BANK_SIZE / PATCH_BANK_SECTOR_SIZE)
+
+BUILD_ASSERT(PM_APP_ADDRESS + PM_APP_SIZE <= PM_PATCH_BANK_ADDRESS,
+	     "Application image overlaps the patch bank");
+BUILD_ASSERT(PM_PATCH_BANK_SIZE % PATCH_BANK_SECTOR_SIZE == 0 && PATCH_BANK_SECTORS >= 2,
+	     "Patch bank must be at least two whole flash pages");
+
+/* NVS ids 1-128 (id 0 left unused) */
+#define PROGRAM_ID(program)     ((uint16_t)(program) + 1)
+
+static struct nvs_fs fs;
+static struct patch_bank bank;
+static struct patch_store_timing timing;
+static bool mounted;
+
+/* Serializes the shell (store/delete/list) with Program Change handling */
+static K_MUTEX_DEFINE(bank_lock);
+
+/* patch_bank backend: one NVS read */
+static int read_record(void *ctx, uint8_t program, struct patch_record *rec)
+{
+	ARG_UNUSED(ctx);
+
+	ssize_t len = nvs_read(&fs, PROGRAM_ID(program), rec, sizeof(*rec));
+	if (len == -ENOENT) {
+		return -ENOENT;
+	}
+	if (len != sizeof(*rec)) {
+		LOG_WRN("Program %d: bad record length %d", program, (int)len);
+		return (len < 0) ? (int)len : -EBADMSG;
+	}
+	return 0;
+}
+
+int patch_store_init(void)
+{
+	uint32_t marker;
+
+	fs.flash_device = FLASH_DEVICE;
+	if (!device_is_ready(fs.flash_device)) {
+		LOG_ERR("Flash device not ready");
+		return -ENODEV;
+	}
+
+	fs.offset = PATCH_BANK_OFFSET;
+	fs.sector_size = PATCH_BANK_SECTOR_SIZE;
+	fs.sector_count = PATCH_BANK_SECTORS;
+
+	int err = nvs_mount(&fs);
+	if (err) {
+		LOG_ERR("Patch bank mount failed: %d", err);
+		return err;
+	}
+
+	patch_bank_init(&bank, read_record, NULL);
+
+	/* Index: a short read returns the record length without copying it */
+	for (int p = 0; p < PATCH_BANK_PROGRAMS; p++) {
+		if (nvs_read(&fs, PROGRAM_ID(p), &marker, sizeof(marker)) > 0) {
+			patch_bank_set_stored(&bank, (uint8_t)p, true);
+		}
+	}
+
+	mounted = true;
+	LOG_INF("Patch bank: %d programs stored, %d cache slots",
+		patch_bank_count(&bank), PATCH_BANK_CACHE_SLOTS);
+	return 0;
+}
+
+int patch_store_load(uint8_t program, struct patch_config *patch, bool *from_flash)
+{
+	if (!mounted) {
+		return -EACCES;
+	}
+
+	k_mutex_lock(&bank_lock, K_FOREVER);
+	uint32_t misses = bank.stats.misses;
+	const struct patch_config *cached = patch_bank_get(&bank, program);
+	if (cached) {
+		memcpy(patch, cached, sizeof(*patch));
+	}
+	if (from_flash) {
+		*from_flash = (bank.stats.misses != misses);
+	}
+	k_mutex_unlock(&bank_lock);
+
+	return cached ? 0 : -ENOENT;
+}
+
+void patch_store_prefetch(uint8_t program)
+{
+	if (!mounted) {
+		return;
+	}
+
+	k_mutex_lock(&bank_lock, K_FOREVER);
+	patch_bank_prefetch(&bank, program);
+	k_mutex_unlock(&bank_lock);
+}
+
+int patch_store_write(uint8_t program, const struct patch_config *patch)
+{
+	static struct patch_record rec;
+
+	if (!mounted) {
+		return -EACCES;
+	}
+	if (program >= PATCH_BANK_PROGRAMS || !patch) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&bank_lock, K_FOREVER);
+	patch_record_encode(&rec, patch);
+	ssize_t len = nvs_write(&fs, PROGRAM_ID(program), &rec, sizeof(rec));
+	if (len >= 0) {
+		/* 0 means identical to the stored record: nothing written */
+		patch_bank_update(&bank, program, patch);
+	}
+	k_mutex_unlock(&bank_lock);
+
+	if (len < 0) {
+		LOG_ERR("Program %d: write failed: %d", program, (int)len);
+		return (int)len;
+	}
+
+	LOG_INF("Program %d stored (%s)", program, patch->patch_name);
+	return 0;
+}
+
+int patch_store_delete(uint8_t program)
+{
+	if (!mounted) {
+		return -EACCES;
+	}
+	if (program >= PATCH_BANK_PROGRAMS) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&bank_lock, K_FOREVER);
+	int err = nvs_delete(&fs, PROGRAM_ID(program));
+	if (err == 0) {
+		patch_bank_set_stored(&bank, program, false);
+	}
+	k_mutex_unlock(&bank_lock);
+
+	return err;
+}
+
+int patch_store_get_name(uint8_t program, char *name)
+{
+	static struct patch_record rec;
+
+	if (!mounted) {
+		return -EACCES;
+	}
+	if (!patch_bank_is_stored(&bank, program)) {
+		return -ENOENT;
+	}
+
+	k_mutex_lock(&bank_lock, K_FOREVER);
+	int err = read_record(NULL, program, &rec);
+	if (err == 0) {
+		err = patch_record_check(&rec);
+	}
+	if (err == 0) {
+		memcpy(name, rec.patch.patch_name, sizeof(rec.patch.patch_name));
+		name[sizeof(rec.patch.patch_name) - 1] = '\0';
+	}
+	k_mutex_unlock(&bank_lock);
+
+	return err;
+}
+
+void patch_store_record_switch(uint32_t us, bool miss)
+{
+	timing.last_us = us;
+	if (us > timing.max_us) {
+		timing.max_us = us;
+	}
+	if (miss && us > timing.max_miss_us) {
+		timing.max_miss_us = us;
+	}
+}
+
+const struct patch_bank *patch_store_get_bank(void)
+{
+	return &bank;
+}
+
+const struct patch_store_timing *patch_store_get_timing(void)
+{
+	return &timing;
+}
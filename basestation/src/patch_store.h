@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef PATCH_STORE_H_
+#define PATCH_STORE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "patch_bank.h"
+
+/**
+ * @brief Patch Bank Storage
+ *
+ * Stores one patch_record per program (0-127) in its own NVS entry, in a
+ * flash region separate from the configuration areas. Writing a program
+ * appends a new record for that program only; NVS reclaims old records
+ * sector by sector. Reads go through a patch_bank RAM cache (see
+ * patch_bank.h).
+ */
+
+/**
+ * @brief Switch timing, in microseconds
+ */
+struct patch_store_timing {
+	uint32_t last_us;              /* Last Program Change: lookup and apply */
+	uint32_t max_us;               /* Slowest since boot */
+	uint32_t max_miss_us;          /* Slowest that had to read flash */
+};
+
+/**
+ * @brief Mount the bank region and build the index of stored programs
+ *
+ * @return 0 on success, negative errno on failure
+ */
+int patch_store_init(void);
+
+/**
+ * @brief Copy a program's patch (from the cache or one flash read)
+ *
+ * @param program Program number (0-127)
+ * @param patch Output patch
+ * @param from_flash Output: true if it was not cached (may be NULL)
+ * @return 0 on success, -ENOENT if not stored or unreadable
+ */
+int patch_store_load(uint8_t program, struct patch_config *patch, bool *from_flash);
+
+/**
+ * @brief Read the stored neighbours of a program into the cache
+ */
+void patch_store_prefetch(uint8_t program);
+
+/**
+ * @brief Store a patch as a program, leaving all other programs untouched
+ *
+ * @param program Program number (0-127)
+ * @param patch Patch to store
+ * @return 0 on success, negative errno on failure
+ */
+int patch_store_write(uint8_t program, const struct patch_config *patch);
+
+/**
+ * @brief Delete a program's patch
+ *
+ * @return 0 on success, negative errno on failure
+ */
+int patch_store_delete(uint8_t program);
+
+/**
+ * @brief Read a program's name without touching the cache
+ *
+ * @param program Program number (0-127)
+ * @param name Output buffer (at least 32 bytes)
+ * @return 0 on success, -ENOENT if not stored, negative errno on failure
+ */
+int patch_store_get_name(uint8_t program, char *name);
+
+/**
+ * @brief Record how long a Program Change took
+ *
+ * @param us Lookup plus apply time
+ * @param miss True if the patch was read from flash
+ */
+void patch_store_record_switch(uint32_t us, bool miss);
+
+/**
+ * @brief Get the bank (index and cache statistics, read-only)
+ */
+const struct patch_bank *patch_store_get_bank(void);
+
+/**
+ * @brief Get Program Change switch timing
+ */
+const struct patch_store_timing *patch_store_get_timing(void);
+
+#endif /* PATCH_STORE_H_ */
@@ -0,0 +1,189 @@
+/*
+ * Pipeline Performance Profiler Implementation
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __ZEPHYR__
+#define _POSIX_C_SOURCE 199309L  /* clock_gettime() on host */
+#endif
+
+#include "perf_profiler.h"
+#include <string.h>
+
+#ifdef __ZEPHYR__
+#include <cmsis_core.h>
+#else
+#include <time.h>
+#endif
+
+/* ========================================
+ * PRIVATE STATE
+ * ======================================== */
+
+static struct perf_stage_stats stage_stats[PERF_STAGE_COUNT];
+
+static const char *const stage_names[PERF_STAGE_COUNT] = {
+	[PERF_STAGE_BLE_RX] = "ble_rx",
+	[PERF_STAGE_PROCESS_ACCEL] = "process_accel",
+	[PERF_STAGE_TOPO_EXECUTE] = "topo_execute",
+	[PERF_STAGE_FUNC_PROCESS] = "func_process",
+	[PERF_STAGE_MIDI_QUEUE] = "midi_queue",
+	[PERF_STAGE_UART_TX] = "uart_tx",
+	[PERF_STAGE_GESTURE] = "gesture",
+};
+
+/* ========================================
+ * PRIVATE HELPERS
+ * ======================================== */
+
+/**
+ * @brief Cycle counter frequency in Hz
+ */
+static uint32_t perf_freq_hz(void)
+{
+#ifdef __ZEPHYR__
+	return SystemCoreClock;
+#else
+	return 1000000000U;  /* Host backend counts nanoseconds */
+#endif
+}
+
+/**
+ * @brief Map a cycle count to its log2 histogram bucket
+ */
+static uint8_t perf_bucket(uint32_t cycles)
+{
+	uint8_t bucket = 0;
+
+	while (cycles != 0 && bucket < PERF_HIST_BUCKETS - 1) {
+		cycles >>= 1;
+		bucket++;
+	}
+
+	return bucket;
+}
+
+/* ========================================
+ * API FUNCTIONS
+ * ======================================== */
+
+void perf_init(void)
+{
+#ifdef __ZEPHYR__
+	/* Enable trace and the DWT cycle counter */
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+	perf_reset();
+}
+
+void perf_reset(void)
+{
+	memset(stage_stats, 0, sizeof(stage_stats));
+	for (int i = 0; i < PERF_STAGE_COUNT; i++) {
+		stage_stats[i].min_cycles = UINT32_MAX;
+	}
+}
+
+uint32_t perf_now(void)
+{
+#ifdef __ZEPHYR__
+	return DWT->CYCCNT;
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint32_t)((uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec);
+#endif
+}
+
+void perf_record(enum perf_stage stage, uint32_t cycles)
+{
+	if (stage >= PERF_STAGE_COUNT) {
+		return;
+	}
+
+	struct perf_stage_stats *s = &stage_stats[stage];
+
+	s->count++;
+	s->total_cycles += cycles;
+	if (cycles < s->min_cycles) {
+		s->min_cycles = cycles;
+	}
+	if (cycles > s->max_cycles) {
+		s->max_cycles = cycles;
+	}
+	s->hist[perf_bucket(cycles)]++;
+}
+
+uint32_t perf_cycles_to_ns(uint32_t cycles)
+{
+	uint64_t ns = ((uint64_t)cycles * 1000000000ULL) / perf_freq_hz();
+
+	return (ns > UINT32_MAX) ? UINT32_MAX : (uint32_t)ns;
+}
+
+const struct perf_stage_stats *perf_get_stats(enum perf_stage stage)
+{
+	if (stage >= PERF_STAGE_COUNT) {
+		return NULL;
+	}
+
+	return &stage_stats[stage];
+}
+
+int perf_get_summary(enum perf_stage stage, struct perf_summary *summary)
+{
+	if (stage >= PERF_STAGE_COUNT || !summary) {
+		return -1;
+	}
+
+	const struct perf_stage_stats *s = &stage_stats[stage];
+
+	memset(summary, 0, sizeof(*summary));
+	summary->count = s->count;
+	if (s->count == 0) {
+		return 0;
+	}
+
+	summary->min_ns = perf_cycles_to_ns(s->min_cycles);
+	summary->max_ns = perf_cycles_to_ns(s->max_cycles);
+	summary->avg_ns = perf_cycles_to_ns((uint32_t)(s->total_cycles / s->count));
+
+	/* Walk the histogram to the bucket holding rank ceil(0.99 * count) */
+	uint32_t rank = s->count - (s->count / 100);
+	uint32_t seen = 0;
+	uint32_t p99_cycles = s->max_cycles;
+
+	for (int b = 0; b < PERF_HIST_BUCKETS; b++) {
+		seen += s->hist[b];
+		if (seen >= rank) {
+			if (b < PERF_HIST_BUCKETS - 1) {
+				p99_cycles = (b == 0) ? 0 : (uint32_t)((1ULL << b) - 1);
+			}
+			break;
+		}
+	}
+
+	/* Bucket bounds are coarse; keep the estimate inside the observed range */
+	if (p99_cycles > s->max_cycles) {
+		p99_cycles = s->max_cycles;
+	}
+	if (p99_cycles < s->min_cycles) {
+		p99_cycles = s->min_cycles;
+	}
+	summary->p99_ns = perf_cycles_to_ns(p99_cycles);
+
+	return 0;
+}
+
+const char *perf_stage_name(enum perf_stage stage)
+{
+	if (stage >= PERF_STAGE_COUNT) {
+		return "unknown";
+	}
+
+	return stage_names[stage];
+}
@@ -0,0 +1,159 @@
+/*
+ * Pipeline Performance Profiler
+ * Per-stage cycle counting for the motion-to-MIDI processing chain
+ *
+ * On target the DWT cycle counter is used; host builds fall back to
+ * clock_gettime(CLOCK_MONOTONIC) so the same code can be unit tested.
+ *
+ * All instrumentation compiles out to nothing unless
+ * CONFIG_GUITARACC_PERF is defined.
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef PERF_PROFILER_H
+#define PERF_PROFILER_H
+
+#include <stdint.h>
+
+/* ========================================
+ * CONSTANTS
+ * ======================================== */
+
+/**
+ * @brief Number of log2 histogram buckets per stage
+ *
+ * Bucket 0 holds zero-cycle samples, bucket k holds samples in
+ * [2^(k-1), 2^k). The last bucket also collects anything larger.
+ */
+#define PERF_HIST_BUCKETS 32
+
+/**
+ * @brief Instrumented pipeline stages
+ */
+enum perf_stage {
+	PERF_STAGE_BLE_RX = 0,       /* GATT notification callback */
+	PERF_STAGE_PROCESS_ACCEL,    /* process_accel_data() */
+	PERF_STAGE_TOPO_EXECUTE,     /* topo_proc_execute() */
+	PERF_STAGE_FUNC_PROCESS,     /* func_process(), per call */
+	PERF_STAGE_MIDI_QUEUE,       /* queue_midi_bytes() */
+	PERF_STAGE_UART_TX,          /* UART ISR, one byte out */
+	PERF_STAGE_GESTURE,          /* gesture_engine_process() */
+	PERF_STAGE_COUNT
+};
+
+/* ========================================
+ * DATA STRUCTURES
+ * ======================================== */
+
+/**
+ * @brief Raw accumulated statistics for one stage (fixed memory)
+ */
+struct perf_stage_stats {
+	uint32_t count;
+	uint32_t min_cycles;
+	uint32_t max_cycles;
+	uint64_t total_cycles;
+	uint32_t hist[PERF_HIST_BUCKETS];
+};
+
+/**
+ * @brief Summary of one stage, converted to nanoseconds
+ */
+struct perf_summary {
+	uint32_t count;
+	uint32_t min_ns;
+	uint32_t avg_ns;
+	uint32_t max_ns;
+	uint32_t p99_ns;     /* Upper bound of the bucket holding the 99th percentile */
+};
+
+/* ========================================
+ * INSTRUMENTATION MACROS
+ * ======================================== */
+
+#ifdef CONFIG_GUITARACC_PERF
+
+/**
+ * @brief Start timing a stage; declares a local timestamp variable
+ */
+#define PERF_BEGIN(var) uint32_t var = perf_now()
+
+/**
+ * @brief Stop timing and record the elapsed cycles for a stage
+ */
+#define PERF_END(stage, var) perf_record((stage), perf_now() - (var))
+
+#else
+
+#define PERF_BEGIN(var) do { } while (0)
+#define PERF_END(stage, var) do { } while (0)
+
+#endif /* CONFIG_GUITARACC_PERF */
+
+/* ========================================
+ * API FUNCTIONS
+ * ======================================== */
+
+/**
+ * @brief Initialize the profiler and enable the cycle counter
+ */
+void perf_init(void);
+
+/**
+ * @brief Clear all stage statistics
+ */
+void perf_reset(void);
+
+/**
+ * @brief Read the current cycle counter
+ *
+ * @return Free-running 32-bit cycle count (wraps)
+ */
+uint32_t perf_now(void);
+
+/**
+ * @brief Record one sample for a stage
+ *
+ * Each stage must only be recorded from a single context (thread or ISR).
+ *
+ * @param stage Stage identifier
+ * @param cycles Elapsed cycles
+ */
+void perf_record(enum perf_stage stage, uint32_t cycles);
+
+/**
+ * @brief Convert cycles to nanoseconds
+ *
+ * @param cycles Cycle count
+ * @return Nanoseconds (saturates at UINT32_MAX)
+ */
+uint32_t perf_cycles_to_ns(uint32_t cycles);
+
+/**
+ * @brief Get raw statistics for a stage
+ *
+ * @param stage Stage identifier
+ * @return Pointer to statistics, or NULL if stage is invalid
+ */
+const struct perf_stage_stats *perf_get_stats(enum perf_stage stage);
+
+/**
+ * @brief Compute min/avg/max/p99 summary for a stage
+ *
+ * @param stage Stage identifier
+ * @param summary Output summary
+ * @return 0 on success, -1 if stage is invalid
+ */
+int perf_get_summary(enum perf_stage stage, struct perf_summary *summary);
+
+/**
+ * @brief Get human-readable stage name
+ *
+ * @param stage Stage identifier
+ * @return Stage name string
+ */
+const char *perf_stage_name(enum perf_stage stage);
+
+#endif /* PERF_PROFILER_H */
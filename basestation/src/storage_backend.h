@@ -0,0 +1,55 @@
+/*
+ * Storage Backend
+ * Flash access behind function pointers
+ *
+ * The configuration area code (config_area.c) reads, writes and erases
+ * through this interface instead of calling Zephyr's flash API, so the
+ * same code runs on the nRF5340 internal flash (config_storage.c wraps
+ * the flash device) and on the host flash simulator (flash_sim.h).
+ *
+ * Semantics are those of NOR flash:
+ * - erase works on whole pages and sets every byte to 0xFF
+ * - write offsets and lengths are multiples of write_block_size, and only
+ *   erased bytes may be written
+ * Functions return 0 or a negative errno.
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef STORAGE_BACKEND_H
+#define STORAGE_BACKEND_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief Flash device operations
+ */
+struct storage_backend {
+	int (*read)(void *ctx, uint32_t offset, void *buf, size_t len);
+	int (*write)(void *ctx, uint32_t offset, const void *buf, size_t len);
+	int (*erase)(void *ctx, uint32_t offset, size_t len);
+	void *ctx;
+	uint32_t write_block_size;   /* Write offset/length granularity */
+	uint32_t page_size;          /* Erase granularity */
+};
+
+static inline int storage_read(const struct storage_backend *be, uint32_t offset,
+			       void *buf, size_t len)
+{
+	return be->read(be->ctx, offset, buf, len);
+}
+
+static inline int storage_write(const struct storage_backend *be, uint32_t offset,
+				const void *buf, size_t len)
+{
+	return be->write(be->ctx, offset, buf, len);
+}
+
+static inline int storage_erase(const struct storage_backend *be, uint32_t offset, size_t len)
+{
+	return be->erase(be->ctx, offset, len);
+}
+
+#endif /* STORAGE_BACKEND_H */
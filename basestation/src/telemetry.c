@@ -0,0 +1,231 @@
+/*
+ * Binary Telemetry Records Implementation
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "telemetry.h"
+#include <string.h>
+
+/* ========================================
+ * PRIVATE HELPERS
+ * ======================================== */
+
+static uint8_t *put_u16(uint8_t *p, uint16_t v)
+{
+	p[0] = (uint8_t)(v & 0xFF);
+	p[1] = (uint8_t)(v >> 8);
+	return p + 2;
+}
+
+static uint8_t *put_u32(uint8_t *p, uint32_t v)
+{
+	p = put_u16(p, (uint16_t)(v & 0xFFFF));
+	return put_u16(p, (uint16_t)(v >> 16));
+}
+
+static uint8_t *put_i16_array(uint8_t *p, const int16_t *v, size_t n)
+{
+	for (size_t i = 0; i < n; i++) {
+		p = put_u16(p, (uint16_t)v[i]);
+	}
+	return p;
+}
+
+/* ========================================
+ * RING API
+ * ======================================== */
+
+void telemetry_ring_init(struct telemetry_ring *ring)
+{
+	if (!ring) {
+		return;
+	}
+
+	ring->head = 0;
+	ring->count = 0;
+	ring->dropped = 0;
+}
+
+int telemetry_ring_push(struct telemetry_ring *ring, const struct telemetry_record *rec)
+{
+	if (!ring || !rec) {
+		return -1;
+	}
+
+	uint8_t slot = (ring->head + ring->count) % TELEMETRY_RING_SIZE;
+	int dropped = 0;
+
+	if (ring->count == TELEMETRY_RING_SIZE) {
+		/* Full: the new record takes the oldest slot */
+		slot = ring->head;
+		ring->head = (ring->head + 1) % TELEMETRY_RING_SIZE;
+		ring->dropped++;
+		dropped = 1;
+	} else {
+		ring->count++;
+	}
+
+	memcpy(&ring->records[slot], rec, sizeof(*rec));
+
+	return dropped;
+}
+
+int telemetry_ring_pop(struct telemetry_ring *ring, struct telemetry_record *rec)
+{
+	if (!ring || !rec || ring->count == 0) {
+		return -1;
+	}
+
+	memcpy(rec, &ring->records[ring->head], sizeof(*rec));
+	ring->head = (ring->head + 1) % TELEMETRY_RING_SIZE;
+	ring->count--;
+
+	return 0;
+}
+
+/* ========================================
+ * ENCODING API
+ * ======================================== */
+
+uint16_t telemetry_crc16(const uint8_t *data, size_t len)
+{
+	uint16_t crc = 0xFFFF;
+
+	for (size_t i = 0; i < len; i++) {
+		crc ^= (uint16_t)data[i] << 8;
+		for (int b = 0; b < 8; b++) {
+			crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+		}
+	}
+
+	return crc;
+}
+
+int telemetry_encode_payload(const struct telemetry_record *rec, uint8_t mask,
+                             uint16_t seq, uint16_t dropped,
+                             uint8_t *buf, size_t len)
+{
+	if (!rec || !buf || len < TELEMETRY_MAX_PAYLOAD) {
+		return -1;
+	}
+
+	mask &= TELEM_F_ALL;
+
+	uint8_t *p = buf;
+	*p++ = TELEMETRY_VERSION;
+	*p++ = mask;
+	p = put_u16(p, seq);
+	p = put_u32(p, rec->timestamp_ms);
+
+	if (mask & TELEM_F_RAW_ACCEL) {
+		p = put_i16_array(p, rec->raw, TELEMETRY_RAW_AXES);
+	}
+	if (mask & TELEM_F_CALIBRATED) {
+		p = put_i16_array(p, rec->calibrated, MAX_ACCEL_SOURCES);
+	}
+	if (mask & TELEM_F_VPORTS) {
+		p = put_i16_array(p, rec->vports, MAX_VIRTUAL_PORTS);
+	}
+	if (mask & TELEM_F_MIDI_OUT) {
+		memcpy(p, rec->midi, MAX_MIDI_OUTPUTS);
+		p += MAX_MIDI_OUTPUTS;
+	}
+	if (mask & TELEM_F_QUEUE) {
+		*p++ = rec->tx_queue_depth;
+		*p++ = rec->rt_queue_depth;
+		p = put_u16(p, dropped);
+	}
+
+	p = put_u16(p, telemetry_crc16(buf, (size_t)(p - buf)));
+
+	return (int)(p - buf);
+}
+
+int telemetry_cobs_encode(const uint8_t *in, size_t len, uint8_t *out, size_t out_len)
+{
+	if (!in || !out || out_len < len + (len / 254) + 1) {
+		return -1;
+	}
+
+	size_t code_pos = 0;
+	size_t o = 1;
+	uint8_t code = 1;
+
+	for (size_t i = 0; i < len; i++) {
+		if (in[i] == 0) {
+			out[code_pos] = code;
+			code_pos = o++;
+			code = 1;
+			continue;
+		}
+
+		out[o++] = in[i];
+		if (++code == 0xFF) {
+			out[code_pos] = code;
+			code_pos = o++;
+			code = 1;
+		}
+	}
+	out[code_pos] = code;
+
+	return (int)o;
+}
+
+int telemetry_cobs_decode(const uint8_t *in, size_t len, uint8_t *out, size_t out_len)
+{
+	if (!in || !out) {
+		return -1;
+	}
+
+	size_t i = 0;
+	size_t o = 0;
+
+	while (i < len) {
+		uint8_t code = in[i++];
+
+		if (code == 0 || i + code - 1 > len) {
+			return -1;
+		}
+		for (uint8_t k = 1; k < code; k++) {
+			if (o >= out_len || in[i] == 0) {
+				return -1;
+			}
+			out[o++] = in[i++];
+		}
+		/* A short block implies a zero, except at the very end */
+		if (code < 0xFF && i < len) {
+			if (o >= out_len) {
+				return -1;
+			}
+			out[o++] = 0;
+		}
+	}
+
+	return (int)o;
+}
+
+int telemetry_build_frame(const struct telemetry_record *rec, uint8_t mask,
+                          uint16_t seq, uint16_t dropped,
+                          uint8_t *buf, size_t len)
+{
+	uint8_t payload[TELEMETRY_MAX_PAYLOAD];
+
+	if (!buf || len < TELEMETRY_MAX_FRAME) {
+		return -1;
+	}
+
+	int plen = telemetry_encode_payload(rec, mask, seq, dropped, payload, sizeof(payload));
+	if (plen < 0) {
+		return -1;
+	}
+
+	int flen = telemetry_cobs_encode(payload, (size_t)plen, buf, len - 1);
+	if (flen < 0) {
+		return -1;
+	}
+	buf[flen++] = 0x00;
+
+	return flen;
+}
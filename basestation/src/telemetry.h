@@ -0,0 +1,162 @@
+/*
+ * Binary Telemetry Records
+ * Compact COBS-framed snapshots of the motion-to-MIDI pipeline
+ *
+ * Each frame carries one pipeline sample. Sections are selected by a field
+ * mask and appear in bit order:
+ *
+ *   version(1) mask(1) seq(2) timestamp_ms(4) [sections...] crc16(2)
+ *
+ * All multi-byte values are little-endian. The payload is COBS encoded and
+ * terminated by 0x00, so a host can resynchronise on any delimiter and
+ * discard shell text that ends up between frames (it fails the CRC).
+ *
+ * Pure logic with no hardware dependencies - can be tested on host.
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "topology_config.h"
+#include "virtual_ports.h"
+
+/* ========================================
+ * CONSTANTS
+ * ======================================== */
+
+#define TELEMETRY_VERSION       1
+#define TELEMETRY_RING_SIZE     16      /* Records buffered for the stream thread */
+#define TELEMETRY_RAW_AXES      3       /* X, Y, Z as received from the client */
+#define TELEMETRY_MAX_RATE_HZ   100
+
+/* Field mask bits (section order on the wire) */
+#define TELEM_F_RAW_ACCEL       0x01    /* 3 x int16 raw accel (milli-g) */
+#define TELEM_F_CALIBRATED      0x02    /* 6 x int16 topology source values */
+#define TELEM_F_VPORTS          0x04    /* 18 x int16 virtual port values */
+#define TELEM_F_MIDI_OUT        0x08    /* 6 x uint8 MIDI output values */
+#define TELEM_F_QUEUE           0x10    /* tx depth, rt depth, dropped records */
+#define TELEM_F_ALL             0x1F
+
+#define TELEMETRY_HEADER_SIZE   8
+#define TELEMETRY_CRC_SIZE      2
+#define TELEMETRY_MAX_PAYLOAD \
+	(TELEMETRY_HEADER_SIZE + \
+	 TELEMETRY_RAW_AXES * 2 + \
+	 MAX_ACCEL_SOURCES * 2 + \
+	 MAX_VIRTUAL_PORTS * 2 + \
+	 MAX_MIDI_OUTPUTS + \
+	 4 + \
+	 TELEMETRY_CRC_SIZE)
+
+/* COBS adds one byte per 254 plus the leading code; one more for the delimiter */
+#define TELEMETRY_MAX_FRAME \
+	(TELEMETRY_MAX_PAYLOAD + (TELEMETRY_MAX_PAYLOAD / 254) + 2)
+
+/* ========================================
+ * DATA STRUCTURES
+ * ======================================== */
+
+/**
+ * @brief One pipeline snapshot
+ */
+struct telemetry_record {
+	uint32_t timestamp_ms;
+	int16_t raw[TELEMETRY_RAW_AXES];
+	int16_t calibrated[MAX_ACCEL_SOURCES];
+	int16_t vports[MAX_VIRTUAL_PORTS];
+	uint8_t midi[MAX_MIDI_OUTPUTS];
+	uint8_t tx_queue_depth;
+	uint8_t rt_queue_depth;
+};
+
+/**
+ * @brief Drop-oldest record ring
+ *
+ * A full ring overwrites its oldest entry, so the producer never waits on
+ * the consumer. Callers serialize push and pop.
+ */
+struct telemetry_ring {
+	struct telemetry_record records[TELEMETRY_RING_SIZE];
+	uint8_t head;
+	uint8_t count;
+	uint32_t dropped;
+};
+
+/* ========================================
+ * RING API
+ * ======================================== */
+
+/**
+ * @brief Empty the ring and clear the drop counter
+ */
+void telemetry_ring_init(struct telemetry_ring *ring);
+
+/**
+ * @brief Append a record, overwriting the oldest one if full
+ *
+ * @return 1 if an old record was dropped, 0 otherwise, -1 on bad arguments
+ */
+int telemetry_ring_push(struct telemetry_ring *ring, const struct telemetry_record *rec);
+
+/**
+ * @brief Remove the oldest record
+ *
+ * @return 0 on success, -1 if the ring is empty
+ */
+int telemetry_ring_pop(struct telemetry_ring *ring, struct telemetry_record *rec);
+
+/* ========================================
+ * ENCODING API
+ * ======================================== */
+
+/**
+ * @brief CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF)
+ */
+uint16_t telemetry_crc16(const uint8_t *data, size_t len);
+
+/**
+ * @brief Serialize a record into an unframed payload (including CRC)
+ *
+ * @param rec Record to encode
+ * @param mask Field mask (TELEM_F_*)
+ * @param seq Frame sequence number; gaps tell the host records were lost
+ * @param dropped Records dropped so far (sent in the queue section)
+ * @param buf Output buffer
+ * @param len Buffer size
+ * @return Payload length, or -1 on error
+ */
+int telemetry_encode_payload(const struct telemetry_record *rec, uint8_t mask,
+                             uint16_t seq, uint16_t dropped,
+                             uint8_t *buf, size_t len);
+
+/**
+ * @brief COBS-encode a buffer (no delimiter appended)
+ *
+ * @return Encoded length, or -1 if the output buffer is too small
+ */
+int telemetry_cobs_encode(const uint8_t *in, size_t len, uint8_t *out, size_t out_len);
+
+/**
+ * @brief COBS-decode a buffer (delimiter already stripped)
+ *
+ * @return Decoded length, or -1 on malformed input or short output buffer
+ */
+int telemetry_cobs_decode(const uint8_t *in, size_t len, uint8_t *out, size_t out_len);
+
+/**
+ * @brief Build a complete wire frame: payload, COBS, 0x00 delimiter
+ *
+ * @param buf Output buffer, at least TELEMETRY_MAX_FRAME bytes
+ * @return Frame length, or -1 on error
+ */
+int telemetry_build_frame(const struct telemetry_record *rec, uint8_t mask,
+                          uint16_t seq, uint16_t dropped,
+                          uint8_t *buf, size_t len);
+
+#endif /* TELEMETRY_H */
@@ -0,0 +1,169 @@
+/*
+ * Telemetry Stream Implementation
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "telemetry_stream.h"
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/uart.h>
+#include <zephyr/logging/log.h>
+#include <errno.h>
+
+LOG_MODULE_REGISTER(telemetry, LOG_LEVEL_INF);
+
+#define TELEMETRY_STACK_SIZE 1024
+
+/* ========================================
+ * PRIVATE STATE
+ * ======================================== */
+
+static const struct device *const ui_uart = DEVICE_DT_GET(DT_CHOSEN(zephyr_shell_uart));
+
+static struct telemetry_ring ring;
+static struct k_spinlock ring_lock;
+static K_SEM_DEFINE(ring_sem, 0, 1);
+
+static volatile bool stream_active;
+static uint8_t stream_mask;
+static uint16_t stream_rate_hz;
+static uint32_t min_interval_ms;
+static uint32_t last_accept_ms;
+static bool have_last_accept;
+
+static uint16_t frame_seq;
+static uint32_t frames_sent;
+static uint32_t records_skipped;
+
+/* ========================================
+ * STREAM THREAD
+ * ======================================== */
+
+static void write_frame(const uint8_t *frame, int len)
+{
+	/* Polled output: this thread is the lowest priority, so any MIDI or
+	 * BLE work preempts it between bytes.
+	 */
+	for (int i = 0; i < len; i++) {
+		uart_poll_out(ui_uart, frame[i]);
+	}
+}
+
+static void telemetry_thread(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	static uint8_t frame[TELEMETRY_MAX_FRAME];
+	struct telemetry_record rec;
+
+	while (1) {
+		k_sem_take(&ring_sem, K_FOREVER);
+
+		while (stream_active) {
+			k_spinlock_key_t key = k_spin_lock(&ring_lock);
+			int err = telemetry_ring_pop(&ring, &rec);
+			uint16_t dropped = (uint16_t)ring.dropped;
+			k_spin_unlock(&ring_lock, key);
+
+			if (err) {
+				break;
+			}
+
+			int len = telemetry_build_frame(&rec, stream_mask, frame_seq++, dropped,
+							frame, sizeof(frame));
+			if (len > 0) {
+				write_frame(frame, len);
+				frames_sent++;
+			}
+		}
+	}
+}
+
+K_THREAD_DEFINE(telemetry_tid, TELEMETRY_STACK_SIZE, telemetry_thread, NULL, NULL, NULL,
+		CONFIG_GUITARACC_TELEMETRY_PRIORITY, 0, 0);
+
+/* ========================================
+ * API FUNCTIONS
+ * ======================================== */
+
+int telemetry_stream_start(uint8_t mask, uint16_t rate_hz)
+{
+	if ((mask & TELEM_F_ALL) == 0 || rate_hz == 0 || rate_hz > TELEMETRY_MAX_RATE_HZ) {
+		return -EINVAL;
+	}
+	if (!device_is_ready(ui_uart)) {
+		return -ENODEV;
+	}
+
+	k_spinlock_key_t key = k_spin_lock(&ring_lock);
+	telemetry_ring_init(&ring);
+	stream_mask = mask & TELEM_F_ALL;
+	stream_rate_hz = rate_hz;
+	min_interval_ms = 1000U / rate_hz;
+	have_last_accept = false;
+	frame_seq = 0;
+	frames_sent = 0;
+	records_skipped = 0;
+	stream_active = true;
+	k_spin_unlock(&ring_lock, key);
+
+	LOG_INF("Telemetry started: mask=0x%02x rate=%u Hz", stream_mask, rate_hz);
+	return 0;
+}
+
+void telemetry_stream_stop(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&ring_lock);
+	stream_active = false;
+	telemetry_ring_init(&ring);
+	k_spin_unlock(&ring_lock, key);
+
+	LOG_INF("Telemetry stopped after %u frames", frames_sent);
+}
+
+bool telemetry_stream_active(void)
+{
+	return stream_active;
+}
+
+void telemetry_stream_capture(const struct telemetry_record *rec)
+{
+	if (!stream_active || !rec) {
+		return;
+	}
+
+	k_spinlock_key_t key = k_spin_lock(&ring_lock);
+
+	if (have_last_accept && (rec->timestamp_ms - last_accept_ms) < min_interval_ms) {
+		records_skipped++;
+		k_spin_unlock(&ring_lock, key);
+		return;
+	}
+	last_accept_ms = rec->timestamp_ms;
+	have_last_accept = true;
+
+	telemetry_ring_push(&ring, rec);
+	k_spin_unlock(&ring_lock, key);
+
+	k_sem_give(&ring_sem);
+}
+
+void telemetry_stream_get_stats(struct telemetry_stream_stats *stats)
+{
+	if (!stats) {
+		return;
+	}
+
+	k_spinlock_key_t key = k_spin_lock(&ring_lock);
+	stats->active = stream_active;
+	stats->mask = stream_mask;
+	stats->rate_hz = stream_rate_hz;
+	stats->frames_sent = frames_sent;
+	stats->records_dropped = ring.dropped;
+	stats->records_skipped = records_skipped;
+	k_spin_unlock(&ring_lock, key);
+}
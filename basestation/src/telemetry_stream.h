@@ -0,0 +1,65 @@
+/*
+ * Telemetry Stream
+ * Streams pipeline records over the UI UART from a low-priority thread
+ *
+ * The MIDI path only copies a record into a drop-oldest ring; encoding
+ * and the (slow, 115200 baud) UART writes happen in the stream thread,
+ * which runs below every other application thread.
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef TELEMETRY_STREAM_H
+#define TELEMETRY_STREAM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "telemetry.h"
+
+/**
+ * @brief Stream counters for the shell
+ */
+struct telemetry_stream_stats {
+	bool active;
+	uint8_t mask;
+	uint16_t rate_hz;
+	uint32_t frames_sent;
+	uint32_t records_dropped;   /* Overwritten in the ring before sending */
+	uint32_t records_skipped;   /* Decimated to honour the rate */
+};
+
+/**
+ * @brief Start streaming
+ *
+ * @param mask Field mask (TELEM_F_*), must be non-zero
+ * @param rate_hz Maximum records per second (1-TELEMETRY_MAX_RATE_HZ)
+ * @return 0 on success, -EINVAL on bad arguments, -ENODEV if no UI UART
+ */
+int telemetry_stream_start(uint8_t mask, uint16_t rate_hz);
+
+/**
+ * @brief Stop streaming and discard buffered records
+ */
+void telemetry_stream_stop(void);
+
+/**
+ * @brief Check whether a capture would be accepted
+ *
+ * Cheap enough to call on every sample before building a record.
+ */
+bool telemetry_stream_active(void);
+
+/**
+ * @brief Offer a pipeline record to the stream
+ *
+ * Applies rate decimation and pushes into the ring. Never blocks.
+ */
+void telemetry_stream_capture(const struct telemetry_record *rec);
+
+/**
+ * @brief Get stream counters
+ */
+void telemetry_stream_get_stats(struct telemetry_stream_stats *stats);
+
+#endif /* TELEMETRY_STREAM_H */
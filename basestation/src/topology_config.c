@@ -35,7 +35,7 @@ bool topology_validate(const struct topology_instance *topo)
 	
 	/* Check accelerometer inputs */
 	for (int i = 0; i < expected_accel_inputs; i++) {
-		if (topo->accel_inputs[i] >= MAX_ACCEL_SOURCES) {
+		if (topo->accel_inputs[i] >= MAX_SENSOR_SOURCES) {
 			return false;
 		}
 	}
@@ -146,6 +146,18 @@ const char *topology_get_sensor_name(uint8_t source_idx)
 		return "GYRO_PITCH";
 	case 5:
 		return "GYRO_YAW";
+	case SOURCE_MAGNITUDE:
+		return "MAGNITUDE";
+	case SOURCE_JERK_X:
+		return "JERK_X";
+	case SOURCE_JERK_Y:
+		return "JERK_Y";
+	case SOURCE_JERK_Z:
+		return "JERK_Z";
+	case SOURCE_JERK:
+		return "JERK";
+	case SOURCE_ENERGY:
+		return "ENERGY";
 	default:
 		return "UNKNOWN";
 	}
@@ -19,9 +19,19 @@
 #define MAX_TOPOLOGY_INSTANCES  6    /* Concurrent topology instances per patch */
 #define MAX_FUNCTION_UNITS      8    /* Function processing blocks */
 #define MAX_ACCEL_SOURCES       6    /* X, Y, Z, Roll, Pitch, Yaw */
+#define MAX_DERIVED_SOURCES     6    /* |a|, Jerk X/Y/Z, |Jerk|, Energy */
+#define MAX_SENSOR_SOURCES      (MAX_ACCEL_SOURCES + MAX_DERIVED_SOURCES)
 #define MAX_MIDI_OUTPUTS        6    /* Configurable CC numbers per patch */
 #define NUM_TOPOLOGY_TYPES      4    /* T1, T2, T3, T4 */
 
+/* Derived source indices, after the sensor slots (see derived_sources.h) */
+#define SOURCE_MAGNITUDE        6    /* |a| in milli-g */
+#define SOURCE_JERK_X           7    /* Per-sample change of X in milli-g */
+#define SOURCE_JERK_Y           8
+#define SOURCE_JERK_Z           9
+#define SOURCE_JERK             10   /* |change of a| in milli-g */
+#define SOURCE_ENERGY           11   /* Windowed RMS of a around its mean, milli-g */
+
 /* ========================================
  * TOPOLOGY TYPES
  * ======================================== */
@@ -52,7 +62,7 @@ enum topology_type {
  */
 struct topology_instance {
 	uint8_t topology_type;      /* enum topology_type */
-	uint8_t accel_inputs[2];    /* Which accel axis/axes (0-5) */
+	uint8_t accel_inputs[2];    /* Which source(s) (0-11) */
 	uint8_t func_units[2];      /* Which function unit(s) to use (0-7) */
 	uint8_t midi_outputs[2];    /* Which MIDI CC(s) for output (0-127) */
 	uint8_t enabled;            /* Instance active flag */
@@ -128,8 +138,9 @@ uint8_t topology_get_vport_count(enum topology_type type);
 /**
  * @brief Get the human-readable name for a sensor source
  * 
- * @param source_idx Sensor source index (0-5)
- * @return String name (ACCEL_X, ACCEL_Y, ACCEL_Z, GYRO_ROLL, GYRO_PITCH, GYRO_YAW)
+ * @param source_idx Source index (0 to MAX_SENSOR_SOURCES-1)
+ * @return String name (ACCEL_X, ACCEL_Y, ACCEL_Z, GYRO_ROLL, GYRO_PITCH, GYRO_YAW,
+ *         MAGNITUDE, JERK_X, JERK_Y, JERK_Z, JERK, ENERGY)
  */
 const char *topology_get_sensor_name(uint8_t source_idx);
 
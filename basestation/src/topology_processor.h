@@ -13,6 +13,7 @@
 #include "virtual_ports.h"
 #include "topology_config.h"
 #include "function_units.h"
+#include "topology_runtime.h"
 
 /* ========================================
  * DATA STRUCTURES
@@ -21,13 +22,17 @@
 /**
  * @brief Complete processing context
  * 
- * Contains all state needed to process topology instances.
+ * Contains all state needed to process topology instances. The patch and
+ * function units are kept in their flash format and compiled into
+ * runtime (see topology_runtime.h), which is what runs per sample.
  */
 struct topology_processor {
 	struct virtual_port_system vport_system;
 	struct function_unit functions[MAX_FUNCTION_UNITS];
 	struct patch_topology_config *current_patch;
-	int16_t accel_values[MAX_ACCEL_SOURCES];  /* Current accel readings */
+	struct topology_runtime runtime;          /* Compiled current_patch + functions */
+	bool compiled;                             /* runtime is up to date */
+	int16_t accel_values[MAX_SENSOR_SOURCES]; /* Current sensor + derived readings */
 	uint8_t midi_outputs[MAX_MIDI_OUTPUTS];    /* Resulting MIDI CC values */
 };
 
@@ -50,10 +55,11 @@ void topo_proc_init(struct topology_processor *proc,
  * Call this before processing to update accelerometer readings.
  * 
  * @param proc Pointer to processor structure
- * @param accel_data Array of 6 accelerometer values (X,Y,Z,Roll,Pitch,Yaw)
+ * @param accel_data Array of MAX_SENSOR_SOURCES values: X, Y, Z, Roll, Pitch,
+ *                   Yaw, then the derived sources (see derived_sources.h)
  */
 void topo_proc_set_accel_inputs(struct topology_processor *proc, 
-                                const int16_t accel_data[MAX_ACCEL_SOURCES]);
+                                const int16_t accel_data[MAX_SENSOR_SOURCES]);
 
 /**
  * @brief Apply global scale/offset calibration to sensor values
@@ -78,6 +84,19 @@ void topo_proc_apply_global_calibration(const int16_t raw_values[MAX_ACCEL_SOURC
                                         const int16_t scale[MAX_ACCEL_SOURCES],
                                         const int16_t offset[MAX_ACCEL_SOURCES]);
 
+/**
+ * @brief Compile the current patch and function units for execution
+ * 
+ * topo_proc_init() and topo_proc_set_function() mark the processor for
+ * recompiling, and topo_proc_execute() compiles it when needed. Call
+ * this after changing the patch or a port mixer in place, or ahead of
+ * the first sample to keep compiling off the sample path.
+ * 
+ * @param proc Pointer to processor structure
+ * @return 0 on success, negative on error
+ */
+int topo_proc_compile(struct topology_processor *proc);
+
 /**
  * @brief Process all enabled topology instances
  * 
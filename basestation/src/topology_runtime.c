@@ -0,0 +1,322 @@
+/*
+ * Topology Runtime Implementation
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "topology_runtime.h"
+#include "perf_profiler.h"
+#include <string.h>
+
+/* ========================================
+ * COMPILE
+ * ======================================== */
+
+/**
+ * @brief Expand one function unit into an op code and parameters
+ *
+ * Mirrors the cases of func_process().
+ */
+static void compile_function(struct topology_runtime *rt, uint8_t idx,
+                             const struct function_unit *func)
+{
+	uint8_t op = TOPO_RT_OP_ZERO;
+	int32_t p[4] = { 0 };
+
+	if (func->enabled) {
+		switch (func->function_type) {
+		case FUNC_PASSTHROUGH:
+		case FUNC_SCALE_OFFSET:
+			op = TOPO_RT_OP_PASS;
+			break;
+
+		case FUNC_LINEAR:
+			op = TOPO_RT_OP_PASS;
+			if (func->param_count < 4) {
+				break;
+			}
+			if (func->params[0] == func->params[1]) {
+				op = TOPO_RT_OP_CONST;
+				p[0] = func->params[2];
+				break;
+			}
+			/* Normalize to a rising input range */
+			op = TOPO_RT_OP_LINEAR;
+			if (func->params[0] < func->params[1]) {
+				p[0] = func->params[0];
+				p[1] = func->params[1];
+				p[2] = func->params[2];
+				p[3] = func->params[3];
+			} else {
+				p[0] = func->params[1];
+				p[1] = func->params[0];
+				p[2] = func->params[3];
+				p[3] = func->params[2];
+			}
+			break;
+
+		case FUNC_DEADZONE:
+			op = (func->param_count >= 1) ? TOPO_RT_OP_DEADZONE : TOPO_RT_OP_PASS;
+			p[0] = func->params[0];
+			break;
+
+		case FUNC_INVERT:
+			op = TOPO_RT_OP_INVERT;
+			break;
+
+		case FUNC_SCALE:
+			op = (func->param_count >= 1) ? TOPO_RT_OP_SCALE : TOPO_RT_OP_PASS;
+			p[0] = func->params[0];
+			break;
+
+		case FUNC_CLAMP:
+			op = (func->param_count >= 2) ? TOPO_RT_OP_CLAMP : TOPO_RT_OP_PASS;
+			p[0] = func->params[0];
+			p[1] = func->params[1];
+			break;
+
+		default:
+			break;
+		}
+	}
+
+	rt->fn_op[idx] = op;
+	for (int i = 0; i < 4; i++) {
+		rt->fn_param[i][idx] = p[i];
+	}
+}
+
+/**
+ * @brief CC number (16-21) to output index, TOPO_RT_NO_OUTPUT if out of range
+ */
+static inline uint8_t output_index(uint8_t cc)
+{
+	uint8_t idx = cc - 16;
+
+	return (idx < MAX_MIDI_OUTPUTS) ? idx : TOPO_RT_NO_OUTPUT;
+}
+
+void topology_runtime_compile(struct topology_runtime *rt,
+                              const struct topology_instance *topologies,
+                              const struct function_unit *functions,
+                              const struct virtual_port_system *vps)
+{
+	if (!rt || !topologies || !functions || !vps) {
+		return;
+	}
+
+	memset(rt, 0, sizeof(*rt));
+
+	for (uint8_t i = 0; i < MAX_FUNCTION_UNITS; i++) {
+		compile_function(rt, i, &functions[i]);
+	}
+
+	for (uint8_t i = 0; i < MAX_TOPOLOGY_INSTANCES; i++) {
+		const struct topology_instance *topo = &topologies[i];
+		uint8_t flags;
+
+		if (!topo->enabled) {
+			continue;
+		}
+
+		switch (topo->topology_type) {
+		case TOPO_T1:
+			flags = 0;
+			break;
+		case TOPO_T2:
+			flags = TOPO_RT_TWO_INPUTS;
+			break;
+		case TOPO_T3:
+			flags = TOPO_RT_FAN_OUT;
+			break;
+		case TOPO_T4:
+			flags = TOPO_RT_TWO_INPUTS | TOPO_RT_CASCADE;
+			break;
+		default:
+			continue;
+		}
+
+		/* Same checks the interpreter made on every sample */
+		if (topo->accel_inputs[0] >= MAX_SENSOR_SOURCES ||
+		    topo->func_units[0] >= MAX_FUNCTION_UNITS) {
+			continue;
+		}
+		if ((flags & TOPO_RT_TWO_INPUTS) && topo->accel_inputs[1] >= MAX_SENSOR_SOURCES) {
+			continue;
+		}
+		if ((flags & TOPO_RT_CASCADE) && topo->func_units[1] >= MAX_FUNCTION_UNITS) {
+			continue;
+		}
+
+		uint8_t s = rt->steps++;
+		uint8_t port = i * 3;   /* Instance i owns VP[3i] to VP[3i+2] */
+
+		rt->flags[s] = flags;
+		rt->port[s] = port;
+		rt->mixer[s] = vps->ports[port].mixer_type;
+		rt->source[0][s] = topo->accel_inputs[0];
+		rt->source[1][s] = topo->accel_inputs[1];
+		rt->func[0][s] = topo->func_units[0];
+		rt->func[1][s] = topo->func_units[1];
+		rt->output[0][s] = output_index(topo->midi_outputs[0]);
+		rt->output[1][s] = (flags & (TOPO_RT_FAN_OUT | TOPO_RT_CASCADE)) ?
+		                   output_index(topo->midi_outputs[1]) : TOPO_RT_NO_OUTPUT;
+	}
+}
+
+/* ========================================
+ * EXECUTE
+ * ======================================== */
+
+static inline int16_t clamp16(int16_t value, int16_t min, int16_t max)
+{
+	if (value < min) {
+		return min;
+	}
+	if (value > max) {
+		return max;
+	}
+	return value;
+}
+
+static inline uint8_t clamp_midi(int16_t value)
+{
+	return (uint8_t)clamp16(value, MIDI_MIN_VALUE, MIDI_MAX_VALUE);
+}
+
+static inline int16_t eval_function(const struct topology_runtime *rt, uint8_t idx,
+                                    int16_t input)
+{
+	int32_t p0 = rt->fn_param[0][idx];
+
+	switch (rt->fn_op[idx]) {
+	case TOPO_RT_OP_PASS:
+		return input;
+
+	case TOPO_RT_OP_CONST:
+		return (int16_t)p0;
+
+	case TOPO_RT_OP_LINEAR: {
+		int32_t p1 = rt->fn_param[1][idx];
+		int32_t p2 = rt->fn_param[2][idx];
+		int32_t p3 = rt->fn_param[3][idx];
+
+		if (input <= p0) {
+			return (int16_t)p2;
+		}
+		if (input >= p1) {
+			return (int16_t)p3;
+		}
+		return (int16_t)(p2 + ((input - p0) * (p3 - p2)) / (p1 - p0));
+	}
+
+	case TOPO_RT_OP_DEADZONE: {
+		int32_t magnitude = (input < 0) ? -(int32_t)input : input;
+
+		return (magnitude < p0) ? 0 : input;
+	}
+
+	case TOPO_RT_OP_INVERT:
+		return 127 - clamp16(input, 0, 127);
+
+	case TOPO_RT_OP_SCALE:
+		return clamp16((int16_t)((input * p0) / 100), 0, 127);
+
+	case TOPO_RT_OP_CLAMP:
+		return clamp16(input, (int16_t)p0, (int16_t)rt->fn_param[1][idx]);
+
+	default:
+		return 0;
+	}
+}
+
+/**
+ * @brief Evaluate a function unit, timing it when profiling is enabled
+ */
+static inline int16_t run_function(const struct topology_runtime *rt, uint8_t idx,
+                                   int16_t input)
+{
+	PERF_BEGIN(t_func);
+	int16_t output = eval_function(rt, idx, input);
+	PERF_END(PERF_STAGE_FUNC_PROCESS, t_func);
+
+	return output;
+}
+
+/**
+ * @brief Second write to a port, combined as vport_write() does
+ */
+static inline int16_t mix(uint8_t mixer, int16_t value, int16_t input)
+{
+	switch (mixer) {
+	case MIXER_SUM:
+	case MIXER_AVERAGE:
+		return (int16_t)(value + input);
+	case MIXER_MAX:
+		return (input > value) ? input : value;
+	case MIXER_MIN:
+		return (input < value) ? input : value;
+	default:
+		return input;
+	}
+}
+
+void topology_runtime_execute(const struct topology_runtime *rt,
+                              const int16_t *sources,
+                              struct virtual_port_system *vps,
+                              uint8_t *outputs)
+{
+	for (uint8_t s = 0; s < rt->steps; s++) {
+		uint8_t flags = rt->flags[s];
+		struct virtual_port *vp = &vps->ports[rt->port[s]];
+		int16_t input = sources[rt->source[0][s]];
+
+		/* VP[0]: source, or two sources mixed */
+		vp[0].value = input;
+		vp[0].input_count = 1;
+		if (flags & TOPO_RT_TWO_INPUTS) {
+			vp[0].value = mix(rt->mixer[s], input, sources[rt->source[1][s]]);
+			vp[0].input_count = 2;
+			input = vp[0].value;
+			if (rt->mixer[s] == MIXER_AVERAGE) {
+				input = (int16_t)(input / 2);
+			}
+		}
+
+		/* VP[1]: first function */
+		int16_t out0 = run_function(rt, rt->func[0][s], input);
+		uint8_t midi0 = clamp_midi(out0);
+
+		vp[1].value = out0;
+		vp[1].input_count = 1;
+		if (rt->output[0][s] != TOPO_RT_NO_OUTPUT) {
+			outputs[rt->output[0][s]] = midi0;
+		}
+
+		if (flags & TOPO_RT_FAN_OUT) {
+			if (rt->output[1][s] != TOPO_RT_NO_OUTPUT) {
+				outputs[rt->output[1][s]] = midi0;
+			}
+		} else if (flags & TOPO_RT_CASCADE) {
+			/* VP[2]: second function on the first one's output */
+			int16_t out1 = run_function(rt, rt->func[1][s], out0);
+
+			vp[2].value = out1;
+			vp[2].input_count = 1;
+			if (rt->output[1][s] != TOPO_RT_NO_OUTPUT) {
+				outputs[rt->output[1][s]] = clamp_midi(out1);
+			}
+		}
+	}
+}
+
+int16_t topology_runtime_function(const struct topology_runtime *rt,
+                                  uint8_t func_idx, int16_t input)
+{
+	if (!rt || func_idx >= MAX_FUNCTION_UNITS) {
+		return 0;
+	}
+
+	return eval_function(rt, func_idx, input);
+}
@@ -0,0 +1,127 @@
+/*
+ * Topology Runtime
+ * Compiled per-sample form of a patch topology
+ *
+ * The patch format (struct topology_instance, struct function_unit) is
+ * packed and versioned for flash: byte fields, CC numbers, parameters
+ * behind param_count, disabled entries in place. Interpreting it directly
+ * costs branches and unaligned loads on every sample.
+ *
+ * topology_runtime_compile() expands it once per patch load into flat,
+ * naturally aligned arrays, one entry per step in the order the processor
+ * runs them:
+ *   - only enabled, valid instances become steps
+ *   - CC numbers become output indices (TOPO_RT_NO_OUTPUT if unused)
+ *   - each function becomes an op code with int32 parameters, with the
+ *     linear range already normalized
+ *   - port mixers are resolved from the virtual port system
+ *
+ * topology_runtime_execute() gives the same outputs and virtual port
+ * values as interpreting the packed form.
+ *
+ * Pure logic with no hardware dependencies - can be tested on host.
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef TOPOLOGY_RUNTIME_H
+#define TOPOLOGY_RUNTIME_H
+
+#include <stdint.h>
+#include "virtual_ports.h"
+#include "topology_config.h"
+#include "function_units.h"
+
+/* ========================================
+ * CONSTANTS
+ * ======================================== */
+
+#define TOPO_RT_NO_OUTPUT   0xFF    /* Step output not connected */
+
+/* Step flags */
+#define TOPO_RT_TWO_INPUTS  0x01    /* Mix source[1] into the input port (T2, T4) */
+#define TOPO_RT_CASCADE     0x02    /* Second function into port + 2 (T4) */
+#define TOPO_RT_FAN_OUT     0x04    /* Port + 1 to both outputs (T3) */
+
+/**
+ * @brief Compiled function op codes
+ */
+enum topo_rt_op {
+	TOPO_RT_OP_ZERO = 0,    /* Disabled or unknown: 0 */
+	TOPO_RT_OP_PASS,        /* Passthrough, scale/offset, too few params */
+	TOPO_RT_OP_CONST,       /* Linear with an empty input range: p[0] */
+	TOPO_RT_OP_LINEAR,      /* p[0..1] input low..high, p[2..3] output at each end */
+	TOPO_RT_OP_DEADZONE,    /* p[0] threshold */
+	TOPO_RT_OP_INVERT,
+	TOPO_RT_OP_SCALE,       /* p[0] percent */
+	TOPO_RT_OP_CLAMP,       /* p[0] min, p[1] max */
+};
+
+/* ========================================
+ * DATA STRUCTURES
+ * ======================================== */
+
+/**
+ * @brief Compiled patch topology (structure of arrays, indexed by step)
+ */
+struct topology_runtime {
+	uint8_t steps;
+	uint8_t flags[MAX_TOPOLOGY_INSTANCES];
+	uint8_t port[MAX_TOPOLOGY_INSTANCES];           /* First virtual port */
+	uint8_t mixer[MAX_TOPOLOGY_INSTANCES];          /* Mixer of the input port */
+	uint8_t source[2][MAX_TOPOLOGY_INSTANCES];
+	uint8_t func[2][MAX_TOPOLOGY_INSTANCES];
+	uint8_t output[2][MAX_TOPOLOGY_INSTANCES];      /* MIDI output index */
+
+	/* Function units, indexed by unit */
+	uint8_t fn_op[MAX_FUNCTION_UNITS];              /* enum topo_rt_op */
+	int32_t fn_param[4][MAX_FUNCTION_UNITS];
+};
+
+/* ========================================
+ * API FUNCTIONS
+ * ======================================== */
+
+/**
+ * @brief Compile a patch topology
+ *
+ * Instances that are disabled, of unknown type or that reference a
+ * source or function unit out of range are left out, as the interpreter
+ * skipped them. Port mixers are read from vps, so set them first.
+ *
+ * @param rt Output
+ * @param topologies MAX_TOPOLOGY_INSTANCES topology instances
+ * @param functions MAX_FUNCTION_UNITS function units
+ * @param vps Virtual port system the runtime will write
+ */
+void topology_runtime_compile(struct topology_runtime *rt,
+                              const struct topology_instance *topologies,
+                              const struct function_unit *functions,
+                              const struct virtual_port_system *vps);
+
+/**
+ * @brief Run one sample
+ *
+ * Call vport_reset_all() and clear outputs first; steps only write the
+ * ports and outputs they use.
+ *
+ * @param rt Compiled topology
+ * @param sources MAX_SENSOR_SOURCES source values
+ * @param vps Virtual ports, updated as vport_write() would
+ * @param outputs MAX_MIDI_OUTPUTS MIDI values
+ */
+void topology_runtime_execute(const struct topology_runtime *rt,
+                              const int16_t *sources,
+                              struct virtual_port_system *vps,
+                              uint8_t *outputs);
+
+/**
+ * @brief Run one compiled function unit
+ *
+ * Same result as func_process() on the unit it was compiled from.
+ */
+int16_t topology_runtime_function(const struct topology_runtime *rt,
+                                  uint8_t func_idx, int16_t input);
+
+#endif /* TOPOLOGY_RUNTIME_H */
@@ -0,0 +1,304 @@
+/*
+ * Deferred Trace Points Implementation
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __ZEPHYR__
+#define _POSIX_C_SOURCE 199309L  /* clock_gettime() on host */
+#endif
+
+#include "trace.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef __ZEPHYR__
+#include <zephyr/kernel.h>
+#else
+#include <time.h>
+#endif
+
+/* ========================================
+ * SITE TABLE
+ * ======================================== */
+
+enum trace_arg_kind {
+	TRACE_ARGS_S16 = 0,
+	TRACE_ARGS_U8,
+};
+
+struct trace_site_info {
+	const char *name;
+	const char *fmt;          /* Applied to 4 x int16 or 8 x uint8 */
+	uint8_t kind;
+	uint16_t default_every;
+	uint16_t default_max_per_sec;
+};
+
+static const struct trace_site_info site_info[TRACE_SITE_COUNT] = {
+	[TRACE_SITE_BLE_RX] = {
+		"ble_rx", "len=%d guitar=%d", TRACE_ARGS_S16, 1, 10 },
+	[TRACE_SITE_ACCEL_IN] = {
+		"accel_in", "x=%d y=%d z=%d", TRACE_ARGS_S16, 1, 10 },
+	[TRACE_SITE_MIDI_OUT] = {
+		"midi_out", "[%u,%u,%u,%u,%u,%u]", TRACE_ARGS_U8, 1, 10 },
+	[TRACE_SITE_MIDI_TX_DROP] = {
+		"midi_tx_drop", "queued=%d len=%d", TRACE_ARGS_S16, 1, 5 },
+};
+
+/* ========================================
+ * PRIVATE STATE
+ * ======================================== */
+
+static struct trace_event ring[TRACE_RING_SIZE];
+static size_t ring_head;       /* Oldest event */
+static size_t ring_count;
+static uint32_t ring_overwritten;
+
+static struct trace_site_state sites[TRACE_SITE_COUNT];
+
+#ifdef __ZEPHYR__
+#define TRACE_LOCK()      unsigned int _trace_key = irq_lock()
+#define TRACE_UNLOCK()    irq_unlock(_trace_key)
+#else
+#define TRACE_LOCK()      do { } while (0)
+#define TRACE_UNLOCK()    do { } while (0)
+#endif
+
+/* ========================================
+ * PRIVATE HELPERS
+ * ======================================== */
+
+/**
+ * @brief Decide whether a hit at this site is recorded
+ *
+ * Sampling runs first, so the rate limit counts sampled events only.
+ */
+static bool site_admit(struct trace_site_state *s, uint32_t now_us)
+{
+	s->hits++;
+
+	if (s->sample_every == 0) {
+		return false;
+	}
+	if (++s->sample_count < s->sample_every) {
+		return false;
+	}
+	s->sample_count = 0;
+
+	if (s->max_per_sec != 0) {
+		if ((uint32_t)(now_us - s->window_start_us) >= 1000000U) {
+			s->window_start_us = now_us;
+			s->window_count = 0;
+		}
+		if (s->window_count >= s->max_per_sec) {
+			return false;
+		}
+		s->window_count++;
+	}
+
+	return true;
+}
+
+/* ========================================
+ * API FUNCTIONS
+ * ======================================== */
+
+void trace_init(void)
+{
+	for (int i = 0; i < TRACE_SITE_COUNT; i++) {
+		sites[i].sample_every = site_info[i].default_every;
+		sites[i].max_per_sec = site_info[i].default_max_per_sec;
+	}
+	trace_clear();
+}
+
+void trace_clear(void)
+{
+	TRACE_LOCK();
+	ring_head = 0;
+	ring_count = 0;
+	ring_overwritten = 0;
+	for (int i = 0; i < TRACE_SITE_COUNT; i++) {
+		struct trace_site_state *s = &sites[i];
+		uint16_t every = s->sample_every;
+		uint16_t max = s->max_per_sec;
+
+		memset(s, 0, sizeof(*s));
+		s->sample_every = every;
+		s->max_per_sec = max;
+	}
+	TRACE_UNLOCK();
+}
+
+uint32_t trace_now_us(void)
+{
+#ifdef __ZEPHYR__
+	return (uint32_t)k_ticks_to_us_floor64(k_uptime_ticks());
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint32_t)((uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000ULL);
+#endif
+}
+
+void trace_point(enum trace_site site, const void *args, size_t len)
+{
+	trace_point_at(site, trace_now_us(), args, len);
+}
+
+bool trace_point_at(enum trace_site site, uint32_t now_us, const void *args, size_t len)
+{
+	if (site >= TRACE_SITE_COUNT) {
+		return false;
+	}
+
+	bool recorded = false;
+
+	TRACE_LOCK();
+
+	struct trace_site_state *s = &sites[site];
+
+	if (!site_admit(s, now_us)) {
+		if (s->pending_suppressed < UINT16_MAX) {
+			s->pending_suppressed++;
+		}
+	} else {
+		size_t slot;
+
+		if (ring_count == TRACE_RING_SIZE) {
+			slot = ring_head;
+			ring_head = (ring_head + 1) % TRACE_RING_SIZE;
+			ring_overwritten++;
+		} else {
+			slot = (ring_head + ring_count) % TRACE_RING_SIZE;
+			ring_count++;
+		}
+
+		struct trace_event *ev = &ring[slot];
+		ev->timestamp_us = now_us;
+		ev->site = (uint8_t)site;
+		ev->reserved = 0;
+		ev->suppressed = s->pending_suppressed;
+		memset(&ev->arg, 0, sizeof(ev->arg));
+		if (args) {
+			memcpy(&ev->arg, args, (len > TRACE_ARG_BYTES) ? TRACE_ARG_BYTES : len);
+		}
+
+		s->pending_suppressed = 0;
+		s->recorded++;
+		recorded = true;
+	}
+
+	TRACE_UNLOCK();
+
+	return recorded;
+}
+
+int trace_site_configure(enum trace_site site, uint16_t sample_every, uint16_t max_per_sec)
+{
+	if (site >= TRACE_SITE_COUNT) {
+		return -1;
+	}
+
+	TRACE_LOCK();
+	sites[site].sample_every = sample_every;
+	sites[site].max_per_sec = max_per_sec;
+	sites[site].sample_count = 0;
+	sites[site].window_count = 0;
+	TRACE_UNLOCK();
+
+	return 0;
+}
+
+const struct trace_site_state *trace_site_get(enum trace_site site)
+{
+	if (site >= TRACE_SITE_COUNT) {
+		return NULL;
+	}
+
+	return &sites[site];
+}
+
+const char *trace_site_name(enum trace_site site)
+{
+	if (site >= TRACE_SITE_COUNT) {
+		return "unknown";
+	}
+
+	return site_info[site].name;
+}
+
+int trace_site_find(const char *name)
+{
+	if (!name) {
+		return -1;
+	}
+
+	for (int i = 0; i < TRACE_SITE_COUNT; i++) {
+		if (strcmp(name, site_info[i].name) == 0) {
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+size_t trace_count(void)
+{
+	return ring_count;
+}
+
+uint32_t trace_overwritten(void)
+{
+	return ring_overwritten;
+}
+
+int trace_get(size_t index, struct trace_event *ev)
+{
+	int ret = -1;
+
+	if (!ev) {
+		return -1;
+	}
+
+	TRACE_LOCK();
+	if (index < ring_count) {
+		memcpy(ev, &ring[(ring_head + index) % TRACE_RING_SIZE], sizeof(*ev));
+		ret = 0;
+	}
+	TRACE_UNLOCK();
+
+	return ret;
+}
+
+int trace_format(const struct trace_event *ev, char *buf, size_t len)
+{
+	if (!ev || !buf || len == 0) {
+		return 0;
+	}
+
+	if (ev->site >= TRACE_SITE_COUNT) {
+		return snprintf(buf, len, "site %u ?", ev->site);
+	}
+
+	const struct trace_site_info *info = &site_info[ev->site];
+	int n = snprintf(buf, len, "%-12s ", info->name);
+
+	if (n < 0 || (size_t)n >= len) {
+		return n;
+	}
+
+	/* Formats use fewer conversions than arguments; the extras are ignored */
+	if (info->kind == TRACE_ARGS_U8) {
+		const uint8_t *a = ev->arg.u8;
+		n += snprintf(buf + n, len - n, info->fmt,
+			      a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7]);
+	} else {
+		const int16_t *a = ev->arg.s16;
+		n += snprintf(buf + n, len - n, info->fmt, a[0], a[1], a[2], a[3]);
+	}
+
+	return n;
+}
@@ -0,0 +1,206 @@
+/*
+ * Deferred Trace Points
+ * Fixed-size binary events for hot-path diagnostics
+ *
+ * A trace point copies up to 8 bytes of arguments into a ring buffer; no
+ * string formatting happens at the call site. Each site can be sampled
+ * (record 1 in N hits) and rate limited (at most M events per second).
+ * Events are formatted later by the shell ("trace show") or dumped in
+ * binary ("trace dump") for host-side decoding.
+ *
+ * All trace points compile out to nothing unless CONFIG_GUITARACC_TRACE
+ * is defined.
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* ========================================
+ * CONSTANTS
+ * ======================================== */
+
+#define TRACE_RING_SIZE     128     /* Events kept; oldest overwritten */
+#define TRACE_ARG_BYTES     8
+
+#define TRACE_DUMP_MAGIC    0x54524345  /* "TRCE" */
+#define TRACE_DUMP_VERSION  1
+
+/**
+ * @brief Trace sites
+ *
+ * Append new sites at the end; the id is stored in dumped events.
+ */
+enum trace_site {
+	TRACE_SITE_BLE_RX = 0,       /* Notification received: length, guitar */
+	TRACE_SITE_ACCEL_IN,         /* Accel into topology: x, y, z */
+	TRACE_SITE_MIDI_OUT,         /* Topology MIDI outputs: 6 x uint8 */
+	TRACE_SITE_MIDI_TX_DROP,     /* CC dropped, TX ring full: queued, len */
+	TRACE_SITE_COUNT
+};
+
+/* ========================================
+ * DATA STRUCTURES
+ * ======================================== */
+
+/**
+ * @brief One recorded event (16 bytes)
+ */
+struct trace_event {
+	uint32_t timestamp_us;
+	uint8_t site;             /* enum trace_site */
+	uint8_t reserved;
+	uint16_t suppressed;      /* Hits at this site skipped since the previous event */
+	union {
+		int16_t s16[TRACE_ARG_BYTES / 2];
+		uint8_t u8[TRACE_ARG_BYTES];
+	} arg;
+};
+
+/**
+ * @brief Per-site sampling, rate limit and counters
+ */
+struct trace_site_state {
+	uint16_t sample_every;    /* Record 1 in N hits; 0 disables the site */
+	uint16_t max_per_sec;     /* 0 = no rate limit */
+	uint16_t sample_count;
+	uint16_t window_count;
+	uint32_t window_start_us;
+	uint32_t hits;
+	uint32_t recorded;
+	uint16_t pending_suppressed;
+};
+
+/**
+ * @brief Binary dump header
+ *
+ * Followed by event_count struct trace_event, oldest first, in native
+ * (little-endian) layout.
+ */
+struct trace_dump_header {
+	uint32_t magic;
+	uint8_t version;
+	uint8_t event_size;
+	uint16_t event_count;
+} __attribute__((packed));
+
+/* ========================================
+ * TRACE POINT MACROS
+ * ======================================== */
+
+#ifdef CONFIG_GUITARACC_TRACE
+
+/**
+ * @brief Record a trace point with up to four int16 arguments
+ */
+#define TRACE_S16(site, a0, a1, a2, a3) \
+	do { \
+		int16_t _targs[4] = {(int16_t)(a0), (int16_t)(a1), (int16_t)(a2), (int16_t)(a3)}; \
+		trace_point((site), _targs, sizeof(_targs)); \
+	} while (0)
+
+/**
+ * @brief Record a trace point with up to eight raw bytes
+ */
+#define TRACE_BYTES(site, ptr, len) trace_point((site), (ptr), (len))
+
+#else
+
+#define TRACE_S16(site, a0, a1, a2, a3) do { } while (0)
+#define TRACE_BYTES(site, ptr, len) do { } while (0)
+
+#endif /* CONFIG_GUITARACC_TRACE */
+
+/* ========================================
+ * API FUNCTIONS
+ * ======================================== */
+
+/**
+ * @brief Reset the ring and restore default site settings
+ */
+void trace_init(void);
+
+/**
+ * @brief Clear recorded events and counters, keep site settings
+ */
+void trace_clear(void);
+
+/**
+ * @brief Current trace timestamp in microseconds
+ */
+uint32_t trace_now_us(void);
+
+/**
+ * @brief Hot-path entry: sample, rate limit and record one event
+ *
+ * @param site Trace site
+ * @param args Argument bytes (copied, truncated to TRACE_ARG_BYTES)
+ * @param len Number of argument bytes
+ */
+void trace_point(enum trace_site site, const void *args, size_t len);
+
+/**
+ * @brief Same as trace_point() with an explicit timestamp
+ *
+ * @return true if the event was recorded
+ */
+bool trace_point_at(enum trace_site site, uint32_t now_us, const void *args, size_t len);
+
+/**
+ * @brief Configure sampling and rate limit for a site
+ *
+ * @param sample_every Record 1 in N hits (0 disables the site)
+ * @param max_per_sec Maximum events per second (0 = unlimited)
+ * @return 0 on success, -1 on invalid site
+ */
+int trace_site_configure(enum trace_site site, uint16_t sample_every, uint16_t max_per_sec);
+
+/**
+ * @brief Get a site's settings and counters
+ */
+const struct trace_site_state *trace_site_get(enum trace_site site);
+
+/**
+ * @brief Get human-readable site name
+ */
+const char *trace_site_name(enum trace_site site);
+
+/**
+ * @brief Look up a site by name
+ *
+ * @return Site id, or -1 if not found
+ */
+int trace_site_find(const char *name);
+
+/**
+ * @brief Number of events currently held in the ring
+ */
+size_t trace_count(void);
+
+/**
+ * @brief Total events overwritten since the last clear
+ */
+uint32_t trace_overwritten(void);
+
+/**
+ * @brief Copy an event without removing it
+ *
+ * @param index 0 = oldest event held
+ * @return 0 on success, -1 if index is out of range
+ */
+int trace_get(size_t index, struct trace_event *ev);
+
+/**
+ * @brief Format one event into text
+ *
+ * @return Characters written (excluding terminator)
+ */
+int trace_format(const struct trace_event *ev, char *buf, size_t len);
+
+#endif /* TRACE_H */
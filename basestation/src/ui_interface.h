@@ -11,6 +11,8 @@
 
 /* Forward declarations */
 struct topology_processor;
+struct latency_tracker;
+struct boot_timing;
 
 /**
  * @brief Initialize the UI interface (Zephyr Shell)
@@ -59,6 +61,25 @@ void ui_get_midi_rx_stats(struct midi_rx_stats *stats);
  */
 void ui_reset_midi_rx_stats(void);
 
+/**
+ * @brief Get motion-to-MIDI latency tracker
+ * 
+ * @return Pointer to the latency tracker (read-only access)
+ */
+const struct latency_tracker *ui_get_latency_tracker(void);
+
+/**
+ * @brief Reset motion-to-MIDI latency statistics
+ */
+void ui_reset_latency_stats(void);
+
+/**
+ * @brief Get boot phase timing and milestones
+ * 
+ * @param out Output: consistent copy of the boot timing record
+ */
+void ui_get_boot_timing(struct boot_timing *out);
+
 /**
  * @brief Get current MIDI program number
  * 
@@ -5,15 +5,28 @@
 
 #include "ui_interface.h"
 #include "config_storage.h"
+#include "config_transfer.h"
+#include "patch_store.h"
+#include "boot_timing.h"
 #include "topology_config.h"
 #include "topology_processor.h"
 #include "virtual_ports.h"
 #include "function_units.h"
+#include "perf_profiler.h"
+#include "latency_tracker.h"
+#include "trace.h"
+#ifdef CONFIG_GUITARACC_TELEMETRY
+#include "telemetry_stream.h"
+#endif
+#ifdef CONFIG_GUITARACC_CAPTURE
+#include "motion_capture.h"
+#endif
 #include <zephyr/kernel.h>
 #include <zephyr/shell/shell.h>
 #include <zephyr/logging/log.h>
 #include <zephyr/data/json.h>
 #include <stdlib.h>
+#include <string.h>
 
 LOG_MODULE_REGISTER(ui_shell, LOG_LEVEL_DBG);
 
@@ -24,6 +37,100 @@ static bool midi_output_active = false;
 /* Configuration reload callback */
 void (*ui_config_reload_callback)(void) = NULL;
 
+/*
+ * Shell working copy
+ *
+ * The one configuration image the shell changes; read-only commands use
+ * config_view() and need no copy. Commands run one at a time, and what it
+ * holds depends on the mode:
+ * - edit session ('config begin' to 'config commit'): the staged
+ *   configuration. Setters change it in place; nothing is written to flash
+ *   and the pipeline is not rebuilt until commit, which validates the
+ *   result, saves it once and reloads once.
+ * - binary import ('config bin'): the received image. Setters are refused
+ *   until the import is committed or aborted.
+ * - otherwise: each setter loads it, changes it and saves it.
+ * Setters check their arguments before changing it, so a rejected command
+ * leaves a session's staged changes as they were.
+ */
+static struct config_data work_config;
+static bool edit_active;
+static uint32_t edit_changes;
+
+/* Binary import chunk bookkeeping */
+static struct config_xfer xfer;
+
+static int config_edit_load(struct config_data *cfg)
+{
+	if (xfer.active) {
+		LOG_WRN("Binary import in progress, configuration locked");
+		return -EBUSY;
+	}
+	if (edit_active) {
+		if (cfg != &work_config) {
+			memcpy(cfg, &work_config, sizeof(*cfg));
+		}
+		return 0;
+	}
+	return config_storage_load(cfg);
+}
+
+/* Read-only command body: gets the session's working copy, or a snapshot
+ * of the stored configuration read in place (no copy) */
+typedef int (*config_view_fn)(const struct shell *sh, const struct config_data *cfg,
+			      size_t argc, char **argv);
+
+static int config_view(const struct shell *sh, size_t argc, char **argv, config_view_fn fn)
+{
+	const struct config_data *cfg = edit_active ? &work_config : config_storage_acquire();
+	
+	if (!cfg) {
+		shell_error(sh, "Error loading configuration");
+		return -EACCES;
+	}
+	
+	int ret = fn(sh, cfg, argc, argv);
+	
+	if (cfg != &work_config) {
+		config_storage_release(cfg);
+	}
+	return ret;
+}
+
+/* Setters return once the change is in RAM; the flash write follows on
+ * the writer thread (failures are logged and shown by 'status') */
+static int config_edit_save(const struct config_data *cfg)
+{
+	if (edit_active) {
+		if (cfg != &work_config) {
+			memcpy(&work_config, cfg, sizeof(work_config));
+		}
+		edit_changes++;
+		return 0;
+	}
+	return config_storage_save_async(cfg, NULL, NULL);
+}
+
+/* Completion of a flash write started by 'config save' */
+static void config_save_done(int result, void *user_data)
+{
+	const struct shell *sh = user_data;
+	
+	if (result != 0) {
+		shell_error(sh, "Flash write failed (code: %d)", result);
+	} else {
+		shell_print(sh, "Configuration written to flash");
+	}
+}
+
+/* Apply a saved change to the running pipeline (deferred in a session) */
+static void config_edit_apply(void)
+{
+	if (!edit_active && ui_config_reload_callback) {
+		ui_config_reload_callback();
+	}
+}
+
 /*
  * Shell command handlers
  */
@@ -42,6 +149,55 @@ static int cmd_status(const struct shell *sh, size_t argc, char **argv)
 		shell_print(sh, "Config area: %s (seq=%u)", area_name, sequence);
 	}
 	
+	size_t journal_used, journal_size;
+	uint32_t journal_records;
+	
+	if (config_storage_get_journal_info(&journal_used, &journal_size, &journal_records) == 0) {
+		shell_print(sh, "Config journal: %zu/%zu bytes (%u saves since compaction)",
+			    journal_used, journal_size, journal_records);
+	}
+	
+	struct config_write_status write;
+	
+	if (config_storage_get_write_status(&write) == 0) {
+		shell_print(sh, "Config write: %s (%u saves waiting, %u commits, last %u ms, max %u ms)",
+			    config_writer_state_name(write.state), write.pending_saves,
+			    write.commits, write.last_commit_us / 1000, write.max_commit_us / 1000);
+		if (write.failures) {
+			shell_print(sh, "Config write failures: %u (last commit: %s)", write.failures,
+				    write.last_result ? "FAILED" : "ok");
+		}
+	}
+	
+	if (edit_active) {
+		shell_print(sh, "Config edit session: open (%u changes staged)", edit_changes);
+	}
+	
+	static const char *const verify_names[] = {
+		[CONFIG_VERIFY_PENDING] = "pending",
+		[CONFIG_VERIFY_OK] = "verified",
+		[CONFIG_VERIFY_RECOVERED] = "MISMATCH, recovered from other area",
+		[CONFIG_VERIFY_FAILED] = "MISMATCH, using hardcoded defaults",
+		[CONFIG_VERIFY_REWRITTEN] = "MISMATCH, rewritten from saved changes",
+	};
+	shell_print(sh, "Config hash: %s", verify_names[config_storage_get_verify_state()]);
+	
+	if (config_storage_get_migrated_from() != 0) {
+		shell_print(sh, "Config layout: v%u (migrated from v%u at boot)",
+			    CONFIG_VERSION, config_storage_get_migrated_from());
+	}
+	
+	struct boot_timing boot;
+	uint32_t scan_us, midi_us;
+	
+	ui_get_boot_timing(&boot);
+	bool scanning = boot_timing_get_milestone(&boot, BOOT_MS_SCANNING, &scan_us);
+	bool first_midi = boot_timing_get_milestone(&boot, BOOT_MS_FIRST_MIDI, &midi_us);
+	
+	shell_print(sh, "Boot: scanning at %s%u ms, first MIDI at %s%u ms",
+		    scanning ? "" : "(not yet) ", scanning ? scan_us / 1000 : 0,
+		    first_midi ? "" : "(not yet) ", first_midi ? midi_us / 1000 : 0);
+	
 	shell_print(sh, "\n=== GuitarAcc Basestation Status ===");
 	shell_print(sh, "Connected devices: %d", connected_devices);
 	shell_print(sh, "MIDI output: %s", midi_output_active ? "Active" : "Inactive");
@@ -49,65 +205,70 @@ static int cmd_status(const struct shell *sh, size_t argc, char **argv)
 	return 0;
 }
 
-static int cmd_config_show(const struct shell *sh, size_t argc, char **argv)
+static int config_show_view(const struct shell *sh, const struct config_data *cfg,
+			    size_t argc, char **argv)
 {
 	ARG_UNUSED(argc);
 	ARG_UNUSED(argv);
 	
-	static struct config_data cfg;
-	
-	if (config_storage_load(&cfg) != 0) {
-		shell_error(sh, "Error loading configuration");
-		return -1;
-	}
-	
 	shell_print(sh, "\n=== Configuration ===");
 	
 	shell_print(sh, "\n--- GLOBAL SETTINGS ---");
-	shell_print(sh, "Active patch: %d", cfg.global.default_patch);
+	shell_print(sh, "Active patch: %d", cfg->global.default_patch);
 	shell_print(sh, "MIDI:");
-	shell_print(sh, "  Channel: %d", cfg.global.midi_channel + 1);
+	shell_print(sh, "  Channel: %d", cfg->global.midi_channel + 1);
 	shell_print(sh, "BLE:");
-	shell_print(sh, "  Max guitars: %d", cfg.global.max_guitars);
-	shell_print(sh, "  Scan interval: %d ms", cfg.global.scan_interval_ms);
+	shell_print(sh, "  Max guitars: %d", cfg->global.max_guitars);
+	shell_print(sh, "  Scan interval: %d ms", cfg->global.scan_interval_ms);
 	shell_print(sh, "LED:");
-	shell_print(sh, "  Brightness: %d", cfg.global.led_brightness);
+	shell_print(sh, "  Brightness: %d", cfg->global.led_brightness);
 	shell_print(sh, "Filters:");
-	shell_print(sh, "  Running average: %s", cfg.global.running_average_enable ? "Enabled" : "Disabled");
-	shell_print(sh, "  Average depth: %d samples", cfg.global.running_average_depth);
+	shell_print(sh, "  Running average: %s", cfg->global.running_average_enable ? "Enabled" : "Disabled");
+	shell_print(sh, "  Average depth: %d samples", cfg->global.running_average_depth);
 	
-	uint8_t patch_idx = cfg.global.default_patch;
+	uint8_t patch_idx = cfg->global.default_patch;
 	if (patch_idx >= NUM_PATCHES) patch_idx = 0;
 	
 	shell_print(sh, "\n--- PATCH SETTINGS (Patch %d) ---", patch_idx);
-	shell_print(sh, "Name: %s", cfg.patches[patch_idx].patch_name);
+	shell_print(sh, "Name: %s", cfg->patches[patch_idx].patch_name);
 	shell_print(sh, "MIDI:");
 	shell_print(sh, "LED:");
-	shell_print(sh, "  Mode: %d", cfg.patches[patch_idx].led_mode);
+	shell_print(sh, "  Mode: %d", cfg->patches[patch_idx].led_mode);
 	shell_print(sh, "Accelerometer:");
-	shell_print(sh, "  Deadzone: %d", cfg.patches[patch_idx].midi_deadzone);
+	shell_print(sh, "  Deadzone: %d", cfg->patches[patch_idx].midi_deadzone);
 	
 	return 0;
 }
 
+static int cmd_config_show(const struct shell *sh, size_t argc, char **argv)
+{
+	return config_view(sh, argc, argv, config_show_view);
+}
+
 static int cmd_config_save(const struct shell *sh, size_t argc, char **argv)
 {
 	ARG_UNUSED(argc);
 	ARG_UNUSED(argv);
 	
-	static struct config_data cfg;
+	if (edit_active) {
+		shell_error(sh, "Edit session open: 'config commit' or 'config abort' first");
+		return -EBUSY;
+	}
 	
-	if (config_storage_load(&cfg) != 0) {
+	const struct config_data *cfg = config_storage_acquire();
+	if (!cfg) {
 		shell_error(sh, "Error loading configuration");
 		return -1;
 	}
 	
-	if (config_storage_save(&cfg) != 0) {
+	int err = config_storage_save_async(cfg, config_save_done, (void *)sh);
+	config_storage_release(cfg);
+	if (err != 0) {
 		shell_error(sh, "Error saving configuration");
 		return -1;
 	}
 	
-	shell_print(sh, "Configuration saved to flash");
+	shell_print(sh, "Configuration save queued");
 	return 0;
 }
 
@@ -116,6 +277,11 @@ static int cmd_config_restore(const struct shell *sh, size_t argc, char **argv)
 	ARG_UNUSED(argc);
 	ARG_UNUSED(argv);
 	
+	if (edit_active) {
+		shell_error(sh, "Edit session open: 'config commit' or 'config abort' first");
+		return -EBUSY;
+	}
+	
 	if (config_storage_restore_defaults() != 0) {
 		shell_error(sh, "Error restoring defaults");
 		return -1;
@@ -138,15 +304,15 @@ static int cmd_config_midi_ch(const struct shell *sh, size_t argc, char **argv)
 		return -1;
 	}
 	
-	static struct config_data cfg;
-	if (config_storage_load(&cfg) != 0) {
+	struct config_data *cfg = &work_config;
+	if (config_edit_load(cfg) != 0) {
 		shell_error(sh, "Error loading configuration");
 		return -1;
 	}
 	
-	cfg.global.midi_channel = ch - 1;  /* 0-indexed internally */
+	cfg->global.midi_channel = ch - 1;  /* 0-indexed internally */
 	
-	int ret = config_storage_save(&cfg);
+	int ret = config_edit_save(cfg);
 	if (ret != 0) {
 		shell_error(sh, "Error saving configuration (code: %d)", ret);
 		return -1;
@@ -155,9 +321,7 @@ static int cmd_config_midi_ch(const struct shell *sh, size_t argc, char **argv)
 	shell_print(sh, "MIDI channel set to %d (global setting)", ch);
 	
 	/* Trigger config reload */
-	if (ui_config_reload_callback) {
-		ui_config_reload_callback();
-	}
+	config_edit_apply();
 	
 	return 0;
 }
@@ -186,7 +350,7 @@ static int cmd_config_cc(const struct shell *sh, size_t argc, char **argv)
 	}
 	
 	static struct config_data cfg;
-	if (config_storage_load(&cfg) != 0) {
+	if (config_edit_load(&cfg) != 0) {
 		shell_error(sh, "Error loading configuration");
 		return -1;
 	}
@@ -196,7 +360,7 @@ static int cmd_config_cc(const struct shell *sh, size_t argc, char **argv)
 	
 	cfg.patches[patch_idx].cc_mapping[axis] = cc_num;
 	
-	if (config_storage_save(&cfg) != 0) {
+	if (config_edit_save(&cfg) != 0) {
 		shell_error(sh, "Error saving configuration");
 		return -1;
 	}
@@ -204,9 +368,7 @@ static int cmd_config_cc(const struct shell *sh, size_t argc, char **argv)
 	const char *axis_names[] = {"X", "Y", "Z"};
 	shell_print(sh, "%s-axis CC set to %d (patch %d setting)", axis_names[axis], cc_num, patch_idx);
 	
-	if (ui_config_reload_callback) {
-		ui_config_reload_callback();
-	}
+	config_edit_apply();
 	
 	return 0;
 }
@@ -233,7 +395,7 @@ static int cmd_config_accel_min(const struct shell *sh, size_t argc, char **argv
 	}
 	
 	static struct config_data cfg;
-	if (config_storage_load(&cfg) != 0) {
+	if (config_edit_load(&cfg) != 0) {
 		shell_error(sh, "Error loading configuration");
 		return -1;
 	}
@@ -243,16 +405,14 @@ static int cmd_config_accel_min(const struct shell *sh, size_t argc, char **argv
 	
 	cfg.patches[patch_idx].accel_min[axis] = (uint8_t)value;
 	
-	if (config_storage_save(&cfg) != 0) {
+	if (config_edit_save(&cfg) != 0) {
 		shell_error(sh, "Error saving configuration");
 		return -1;
 	}
 	
 	shell_print(sh, "Axis %d min CC set to %d (patch %d)", axis, value, patch_idx);
 	
-	if (ui_config_reload_callback) {
-		ui_config_reload_callback();
-	}
+	config_edit_apply();
 	
 	return 0;
 }
@@ -277,7 +437,7 @@ static int cmd_config_accel_max(const struct shell *sh, size_t argc, char **argv
 	}
 	
 	static struct config_data cfg;
-	if (config_storage_load(&cfg) != 0) {
+	if (config_edit_load(&cfg) != 0) {
 		shell_error(sh, "Error loading configuration");
 		return -1;
 	}
@@ -287,16 +447,14 @@ static int cmd_config_accel_max(const struct shell *sh, size_t argc, char **argv
 	
 	cfg.patches[patch_idx].accel_max[axis] = (uint8_t)value;
 	
-	if (config_storage_save(&cfg) != 0) {
+	if (config_edit_save(&cfg) != 0) {
 		shell_error(sh, "Error saving configuration");
 		return -1;
 	}
 	
 	shell_print(sh, "Axis %d max CC set to %d (patch %d)", axis, value, patch_idx);
 	
-	if (ui_config_reload_callback) {
-		ui_config_reload_callback();
-	}
+	config_edit_apply();
 	
 	return 0;
 }
@@ -321,7 +479,7 @@ static int cmd_config_accel_invert(const struct shell *sh, size_t argc, char **a
 	}
 	
 	static struct config_data cfg;
-	if (config_storage_load(&cfg) != 0) {
+	if (config_edit_load(&cfg) != 0) {
 		shell_error(sh, "Error loading configuration");
 		return -1;
 	}
@@ -335,16 +493,14 @@ static int cmd_config_accel_invert(const struct shell *sh, size_t argc, char **a
 		cfg.patches[patch_idx].accel_invert &= ~(1 << axis);
 	}
 	
-	if (config_storage_save(&cfg) != 0) {
+	if (config_edit_save(&cfg) != 0) {
 		shell_error(sh, "Error saving configuration");
 		return -1;
 	}
 	
 	shell_print(sh, "Axis %d invert set to %s (patch %d)", axis, invert ? "ON" : "OFF", patch_idx);
 	
-	if (ui_config_reload_callback) {
-		ui_config_reload_callback();
-	}
+	config_edit_apply();
 	
 	return 0;
 }
@@ -364,7 +520,7 @@ static int cmd_config_accel_deadzone(const struct shell *sh, size_t argc, char *
 	}
 	
 	static struct config_data cfg;
-	if (config_storage_load(&cfg) != 0) {
+	if (config_edit_load(&cfg) != 0) {
 		shell_error(sh, "Error loading configuration");
 		return -1;
 	}
@@ -374,7 +530,7 @@ static int cmd_config_accel_deadzone(const struct shell *sh, size_t argc, char *
 	
 	cfg.patches[patch_idx].midi_deadzone = (int16_t)deadzone;
 	
-	if (config_storage_save(&cfg) != 0) {
+	if (config_edit_save(&cfg) != 0) {
 		shell_error(sh, "Error saving configuration");
 		return -1;
 	}
@@ -382,9 +538,7 @@ static int cmd_config_accel_deadzone(const struct shell *sh, size_t argc, char *
 	shell_print(sh, "CC change threshold set to %d (patch %d)", deadzone, patch_idx);
 	shell_print(sh, "MIDI CC will only be sent when value changes by >= %d", deadzone);
 	
-	if (ui_config_reload_callback) {
-		ui_config_reload_callback();
-	}
+	config_edit_apply();
 	
 	return 0;
 }
@@ -416,14 +570,14 @@ static int cmd_config_accel_scale(const struct shell *sh, size_t argc, char **ar
 	}
 	
 	static struct config_data cfg;
-	if (config_storage_load(&cfg) != 0) {
+	if (config_edit_load(&cfg) != 0) {
 		shell_error(sh, "Error loading configuration");
 		return -1;
 	}
 	
 	cfg.global.accel_scale[axis] = (int16_t)scale_mg;
 	
-	if (config_storage_save(&cfg) != 0) {
+	if (config_edit_save(&cfg) != 0) {
 		shell_error(sh, "Error saving configuration");
 		return -1;
 	}
@@ -434,9 +588,7 @@ static int cmd_config_accel_scale(const struct shell *sh, size_t argc, char **ar
 	shell_print(sh, "Accelerometer range ±%dmg now maps to MIDI 0-127", scale_mg);
 	shell_print(sh, "Values beyond this range will be clamped");
 	
-	if (ui_config_reload_callback) {
-		ui_config_reload_callback();
-	}
+	config_edit_apply();
 	
 	return 0;
 }
@@ -467,14 +619,14 @@ static int cmd_config_accel_offset(const struct shell *sh, size_t argc, char **a
 	}
 	
 	static struct config_data cfg;
-	if (config_storage_load(&cfg) != 0) {
+	if (config_edit_load(&cfg) != 0) {
 		shell_error(sh, "Error loading configuration");
 		return -1;
 	}
 	
 	cfg.global.accel_offset[axis] = (int16_t)offset_mg;
 	
-	if (config_storage_save(&cfg) != 0) {
+	if (config_edit_save(&cfg) != 0) {
 		shell_error(sh, "Error saving configuration");
 		return -1;
 	}
@@ -484,9 +636,7 @@ static int cmd_config_accel_offset(const struct shell *sh, size_t argc, char **a
 		axis_names[axis], offset_mg, offset_mg / 1000.0);
 	shell_print(sh, "This accelerometer value now maps to MIDI 64 (center)");
 	
-	if (ui_config_reload_callback) {
-		ui_config_reload_callback();
-	}
+	config_edit_apply();
 	
 	return 0;
 }
@@ -507,7 +657,7 @@ static int cmd_config_velocity_curve(const struct shell *sh, size_t argc, char *
 	}
 	
 	static struct config_data cfg;
-	if (config_storage_load(&cfg) != 0) {
+	if (config_edit_load(&cfg) != 0) {
 		shell_error(sh, "Error loading configuration");
 		return -1;
 	}
@@ -517,16 +667,14 @@ static int cmd_config_velocity_curve(const struct shell *sh, size_t argc, char *
 	
 	cfg.patches[patch_idx].velocity_curve = (uint8_t)curve;
 	
-	if (config_storage_save(&cfg) != 0) {
+	if (config_edit_save(&cfg) != 0) {
 		shell_error(sh, "Error saving configuration");
 		return -1;
 	}
 	
 	shell_print(sh, "Velocity curve set to %d (patch %d setting)", curve, patch_idx);
 	
-	if (ui_config_reload_callback) {
-		ui_config_reload_callback();
-	}
+	config_edit_apply();
 	
 	return 0;
 }
@@ -545,15 +693,15 @@ static int cmd_config_scan_interval(const struct shell *sh, size_t argc, char **
 		return -1;
 	}
 	
-	static struct config_data cfg;
-	if (config_storage_load(&cfg) != 0) {
+	struct config_data *cfg = &work_config;
+	if (config_edit_load(cfg) != 0) {
 		shell_error(sh, "Error loading configuration");
 		return -1;
 	}
 	
-	cfg.global.scan_interval_ms = (uint8_t)interval;
+	cfg->global.scan_interval_ms = (uint8_t)interval;
 	
-	if (config_storage_save(&cfg) != 0) {
+	if (config_edit_save(cfg) != 0) {
 		shell_error(sh, "Error saving configuration");
 		return -1;
 	}
@@ -561,9 +709,7 @@ static int cmd_config_scan_interval(const struct shell *sh, size_t argc, char **
 	shell_print(sh, "BLE scan interval set to %d ms (global setting)", interval);
 	
 	/* Trigger config reload */
-	if (ui_config_reload_callback) {
-		ui_config_reload_callback();
-	}
+	config_edit_apply();
 	
 	return 0;
 }
@@ -581,15 +727,15 @@ static int cmd_config_avg_enable(const struct shell *sh, size_t argc, char **arg
 		return -1;
 	}
 	
-	static struct config_data cfg;
-	if (config_storage_load(&cfg) != 0) {
+	struct config_data *cfg = &work_config;
+	if (config_edit_load(cfg) != 0) {
 		shell_error(sh, "Error loading configuration");
 		return -1;
 	}
 	
-	cfg.global.running_average_enable = (uint8_t)enable;
+	cfg->global.running_average_enable = (uint8_t)enable;
 	
-	if (config_storage_save(&cfg) != 0) {
+	if (config_edit_save(cfg) != 0) {
 		shell_error(sh, "Error saving configuration");
 		return -1;
 	}
@@ -597,9 +743,7 @@ static int cmd_config_avg_enable(const struct shell *sh, size_t argc, char **arg
 	shell_print(sh, "Running average %s (global setting)", enable ? "enabled" : "disabled");
 	
 	/* Trigger config reload */
-	if (ui_config_reload_callback) {
-		ui_config_reload_callback();
-	}
+	config_edit_apply();
 	
 	return 0;
 }
@@ -617,15 +761,15 @@ static int cmd_config_avg_depth(const struct shell *sh, size_t argc, char **argv
 		return -1;
 	}
 	
-	static struct config_data cfg;
-	if (config_storage_load(&cfg) != 0) {
+	struct config_data *cfg = &work_config;
+	if (config_edit_load(cfg) != 0) {
 		shell_error(sh, "Error loading configuration");
 		return -1;
 	}
 	
-	cfg.global.running_average_depth = (uint8_t)depth;
+	cfg->global.running_average_depth = (uint8_t)depth;
 	
-	if (config_storage_save(&cfg) != 0) {
+	if (config_edit_save(cfg) != 0) {
 		shell_error(sh, "Error saving configuration");
 		return -1;
 	}
@@ -633,9 +777,7 @@ static int cmd_config_avg_depth(const struct shell *sh, size_t argc, char **argv
 	shell_print(sh, "Running average depth set to %d samples (global setting)", depth);
 	
 	/* Trigger config reload */
-	if (ui_config_reload_callback) {
-		ui_config_reload_callback();
-	}
+	config_edit_apply();
 	
 	return 0;
 }
@@ -680,188 +822,563 @@ static int cmd_midi_rx_reset(const struct shell *sh, size_t argc, char **argv)
 	return 0;
 }
 
-static int cmd_midi_program(const struct shell *sh, size_t argc, char **argv)
+static int cmd_latency_show(const struct shell *sh, size_t argc, char **argv)
 {
-	if (argc == 1) {
-		/* No argument - show current program */
-		uint8_t program = ui_get_current_program();
-		shell_print(sh, "Current MIDI Program: %d", program);
-	} else {
-		/* Set program */
-		int program = atoi(argv[1]);
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+	
+	const struct latency_tracker *lat = ui_get_latency_tracker();
+	
+	shell_print(sh, "\n=== Motion-to-MIDI Latency (us) ===");
+	shell_print(sh, "%-8s %8s %8s %8s %8s %8s %8s",
+		    "Segment", "Count", "Min", "Avg", "P50", "P99", "Max");
+	
+	for (int i = 0; i < LAT_SEG_COUNT; i++) {
+		const struct latency_hist *h = &lat->hist[i];
 		
-		if (program < 0 || program > 127) {
-			shell_error(sh, "Program must be 0-127");
-			return -1;
+		if (h->count == 0) {
+			shell_print(sh, "%-8s %8u %8s %8s %8s %8s %8s",
+				    latency_segment_name((enum latency_segment)i), 0,
+				    "-", "-", "-", "-", "-");
+			continue;
 		}
 		
-		ui_set_current_program((uint8_t)program);
-		shell_print(sh, "MIDI Program set to %d", program);
+		shell_print(sh, "%-8s %8u %8u %8u %8u %8u %8u",
+			    latency_segment_name((enum latency_segment)i), h->count,
+			    h->min_us, (uint32_t)(h->total_us / h->count),
+			    latency_percentile_us(h, 50), latency_percentile_us(h, 99),
+			    h->max_us);
+	}
+	
+	if (lat->pending_dropped > 0) {
+		shell_warn(sh, "Untraced CC messages (pending ring full): %u",
+			   lat->pending_dropped);
 	}
 	
 	return 0;
 }
 
-static int cmd_midi_send_rt(const struct shell *sh, size_t argc, char **argv)
+static int cmd_latency_reset(const struct shell *sh, size_t argc, char **argv)
 {
-	if (argc < 2) {
-		shell_error(sh, "Usage: midi send_rt <0xF8-0xFF>");
-		shell_print(sh, "Common real-time messages:");
-		shell_print(sh, "  0xF8 - Timing Clock");
-		shell_print(sh, "  0xFA - Start");
-		shell_print(sh, "  0xFB - Continue");
-		shell_print(sh, "  0xFC - Stop");
-		shell_print(sh, "  0xFE - Active Sensing");
-		shell_print(sh, "  0xFF - Reset");
-		return -1;
-	}
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
 	
-	/* Parse hex value */
-	unsigned long rt_byte = strtoul(argv[1], NULL, 16);
+	ui_reset_latency_stats();
+	shell_print(sh, "Latency statistics reset");
 	
-	if (rt_byte < 0xF8 || rt_byte > 0xFF) {
-		shell_error(sh, "Invalid real-time byte (must be 0xF8-0xFF)");
-		return -1;
-	}
+	return 0;
+}
+
+static int cmd_latency_dump(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
 	
-	int err = send_midi_realtime((uint8_t)rt_byte);
-	if (err != 0) {
-		shell_error(sh, "Failed to send real-time message (err %d)", err);
-		return err;
+	static uint8_t buf[LATENCY_DUMP_SIZE];
+	
+	int len = latency_dump(ui_get_latency_tracker(), buf, sizeof(buf));
+	if (len < 0) {
+		shell_error(sh, "Failed to serialize latency histograms");
+		return -1;
 	}
 	
-	shell_print(sh, "Sent real-time message: 0x%02X", (uint8_t)rt_byte);
+	shell_hexdump(sh, buf, len);
 	return 0;
 }
 
-static int cmd_config_patch(const struct shell *sh, size_t argc, char **argv)
+#ifdef CONFIG_GUITARACC_TRACE
+static int cmd_trace_show(const struct shell *sh, size_t argc, char **argv)
 {
-	if (argc != 2) {
-		shell_error(sh, "Usage: config patch <0-15>");
-		return -1;
-	}
+	size_t count = trace_count();
+	size_t limit = 32;
 	
-	int patch_num = atoi(argv[1]);
-	if (patch_num < 0 || patch_num > 15) {
-		shell_error(sh, "Invalid patch number (0-15)");
-		return -1;
+	if (argc > 1) {
+		limit = (size_t)strtoul(argv[1], NULL, 10);
+		if (limit == 0) {
+			shell_error(sh, "Invalid count: %s", argv[1]);
+			return -1;
+		}
 	}
 	
-	static struct config_data cfg;
-	if (config_storage_load(&cfg) != 0) {
-		shell_error(sh, "Error loading configuration");
-		return -1;
-	}
+	size_t first = (count > limit) ? count - limit : 0;
+	char line[80];
+	struct trace_event ev;
 	
-	uint8_t patch_idx = (uint8_t)patch_num;
-	bool is_active = (patch_idx == cfg.global.default_patch);
+	shell_print(sh, "\n=== Trace (%u of %u events, %u overwritten) ===",
+		    (unsigned int)(count - first), (unsigned int)count, trace_overwritten());
 	
-	shell_print(sh, "\n--- PATCH %d%s ---", patch_idx, is_active ? " (ACTIVE)" : "");
-	shell_print(sh, "Name: %s", cfg.patches[patch_idx].patch_name);
-	shell_print(sh, "LED:");
-	shell_print(sh, "  Mode: %d", cfg.patches[patch_idx].led_mode);
-	shell_print(sh, "Accelerometer:");
-	shell_print(sh, "  Deadzone: %d", cfg.patches[patch_idx].midi_deadzone);
+	for (size_t i = first; i < count; i++) {
+		if (trace_get(i, &ev) != 0) {
+			break;
+		}
+		trace_format(&ev, line, sizeof(line));
+		if (ev.suppressed > 0) {
+			shell_print(sh, "%10u.%03u  %s  (+%u skipped)", ev.timestamp_us / 1000,
+				    ev.timestamp_us % 1000, line, ev.suppressed);
+		} else {
+			shell_print(sh, "%10u.%03u  %s", ev.timestamp_us / 1000,
+				    ev.timestamp_us % 1000, line);
+		}
+	}
 	
 	return 0;
 }
 
-static int cmd_config_select_patch(const struct shell *sh, size_t argc, char **argv)
+static int cmd_trace_sites(const struct shell *sh, size_t argc, char **argv)
 {
-	if (argc != 2) {
-		shell_error(sh, "Usage: config select <0-15>");
-		return -1;
-	}
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
 	
-	int patch_num = atoi(argv[1]);
-	if (patch_num < 0 || patch_num > 15) {
-		shell_error(sh, "Invalid patch number (0-15)");
-		return -1;
-	}
+	shell_print(sh, "\n=== Trace Sites ===");
+	shell_print(sh, "%-14s %6s %6s %10s %10s", "Site", "1-in-N", "Max/s", "Hits", "Recorded");
 	
-	static struct config_data cfg;
-	if (config_storage_load(&cfg) != 0) {
-		shell_error(sh, "Error loading configuration");
-		return -1;
+	for (int i = 0; i < TRACE_SITE_COUNT; i++) {
+		const struct trace_site_state *st = trace_site_get((enum trace_site)i);
+		
+		shell_print(sh, "%-14s %6u %6u %10u %10u", trace_site_name((enum trace_site)i),
+			    st->sample_every, st->max_per_sec, st->hits, st->recorded);
 	}
 	
-	cfg.global.default_patch = (uint8_t)patch_num;
+	return 0;
+}
+
+static int cmd_trace_set(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	
+	unsigned long every = strtoul(argv[2], NULL, 10);
+	unsigned long max = strtoul(argv[3], NULL, 10);
 	
-	if (config_storage_save(&cfg) != 0) {
-		shell_error(sh, "Error saving configuration");
+	if (every > UINT16_MAX || max > UINT16_MAX) {
+		shell_error(sh, "Values must be 0-65535");
 		return -1;
 	}
 	
-	shell_print(sh, "Active patch changed to %d (%s)", 
-		    patch_num, cfg.patches[patch_num].patch_name);
-	
-	/* Trigger config reload */
-	if (ui_config_reload_callback) {
-		ui_config_reload_callback();
+	if (strcmp(argv[1], "all") == 0) {
+		for (int i = 0; i < TRACE_SITE_COUNT; i++) {
+			trace_site_configure((enum trace_site)i, (uint16_t)every, (uint16_t)max);
+		}
+	} else {
+		int site = trace_site_find(argv[1]);
+		if (site < 0) {
+			shell_error(sh, "Unknown trace site: %s", argv[1]);
+			return -1;
+		}
+		trace_site_configure((enum trace_site)site, (uint16_t)every, (uint16_t)max);
 	}
 	
+	shell_print(sh, "Trace %s: 1 in %lu, max %lu/s%s", argv[1], every, max,
+		    every == 0 ? " (disabled)" : "");
+	
 	return 0;
 }
 
-static int cmd_config_list_patches(const struct shell *sh, size_t argc, char **argv)
+static int cmd_trace_clear(const struct shell *sh, size_t argc, char **argv)
 {
 	ARG_UNUSED(argc);
 	ARG_UNUSED(argv);
 	
-	static struct config_data cfg;
-	if (config_storage_load(&cfg) != 0) {
-		shell_error(sh, "Error loading configuration");
-		return -1;
-	}
+	trace_clear();
+	shell_print(sh, "Trace buffer cleared");
 	
-	uint8_t active = cfg.global.default_patch;
+	return 0;
+}
+
+static int cmd_trace_dump(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
 	
-	shell_print(sh, "\n=== Patches (0-15) ===");
-	shell_print(sh, "Active patch: %d\n", active);
+	size_t count = trace_count();
+	struct trace_dump_header hdr = {
+		.magic = TRACE_DUMP_MAGIC,
+		.version = TRACE_DUMP_VERSION,
+		.event_size = sizeof(struct trace_event),
+		.event_count = (uint16_t)count,
+	};
+	struct trace_event ev;
 	
-	/* Show first 10 patches as a sample */
-	for (int i = 0; i < 10; i++) {
-		shell_print(sh, "%c %3d: %s",
-			    (i == active) ? '*' : ' ',
-			    i,
-			    cfg.patches[i].patch_name);
+	/* Header then one event per line; no large staging buffer needed */
+	shell_hexdump(sh, (const uint8_t *)&hdr, sizeof(hdr));
+	for (size_t i = 0; i < count; i++) {
+		if (trace_get(i, &ev) != 0) {
+			break;
+		}
+		shell_hexdump(sh, (const uint8_t *)&ev, sizeof(ev));
 	}
 	
-	shell_print(sh, "  ...  (use 'config patch <num>' to view specific patch)");
-	shell_print(sh, "\nUse 'config select <num>' to change active patch");
-	
 	return 0;
 }
+#endif /* CONFIG_GUITARACC_TRACE */
 
-static int cmd_config_erase_all(const struct shell *sh, size_t argc, char **argv)
+#ifdef CONFIG_GUITARACC_TELEMETRY
+static int cmd_telemetry_start(const struct shell *sh, size_t argc, char **argv)
 {
 	ARG_UNUSED(argc);
-	ARG_UNUSED(argv);
 	
-	shell_warn(sh, "*** WARNING: ERASE ALL CONFIGURATION STORAGE ***");
-	shell_warn(sh, "This will erase AREA_A and AREA_B");
-	shell_warn(sh, "Device will use hardcoded defaults on next boot");
-	shell_warn(sh, "This command is for TESTING ONLY!");
+	char *end;
+	unsigned long mask = strtoul(argv[1], &end, 0);
+	if (*end != '\0' || mask == 0 || mask > TELEM_F_ALL) {
+		shell_error(sh, "Invalid mask: %s (0x01-0x%02X)", argv[1], TELEM_F_ALL);
+		return -1;
+	}
 	
-	if (config_storage_erase_all() != 0) {
-		shell_error(sh, "Error erasing configuration storage");
+	unsigned long rate = strtoul(argv[2], &end, 10);
+	if (*end != '\0' || rate < 1 || rate > TELEMETRY_MAX_RATE_HZ) {
+		shell_error(sh, "Invalid rate: %s (1-%d Hz)", argv[2], TELEMETRY_MAX_RATE_HZ);
 		return -1;
 	}
 	
-	shell_print(sh, "All configuration erased successfully");
-	shell_warn(sh, "*** REBOOT REQUIRED ***");
-	shell_print(sh, "Use 'kernel reboot cold' or power cycle");
+	int err = telemetry_stream_start((uint8_t)mask, (uint16_t)rate);
+	if (err) {
+		shell_error(sh, "Failed to start telemetry (err %d)", err);
+		return err;
+	}
+	
+	shell_print(sh, "Telemetry streaming: mask=0x%02lX rate=%lu Hz", mask, rate);
+	shell_print(sh, "Stop with: telemetry stop");
 	
 	return 0;
 }
 
-/* Helper function to print JSON boolean */
-static const char *json_bool(bool value)
+static int cmd_telemetry_stop(const struct shell *sh, size_t argc, char **argv)
 {
-	return value ? "true" : "false";
-}
-
-/* Helper function to print patch as JSON */
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+	
+	telemetry_stream_stop();
+	shell_print(sh, "Telemetry stopped");
+	
+	return 0;
+}
+
+static int cmd_telemetry_status(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+	
+	struct telemetry_stream_stats stats;
+	telemetry_stream_get_stats(&stats);
+	
+	shell_print(sh, "\n=== Telemetry Stream ===");
+	shell_print(sh, "State: %s", stats.active ? "Streaming" : "Stopped");
+	shell_print(sh, "Mask: 0x%02X  Rate: %u Hz", stats.mask, stats.rate_hz);
+	shell_print(sh, "Frames sent: %u", stats.frames_sent);
+	shell_print(sh, "Records dropped (buffer full): %u", stats.records_dropped);
+	shell_print(sh, "Records skipped (rate limit): %u", stats.records_skipped);
+	
+	return 0;
+}
+#endif /* CONFIG_GUITARACC_TELEMETRY */
+
+#ifdef CONFIG_GUITARACC_CAPTURE
+static int cmd_capture_start(const struct shell *sh, size_t argc, char **argv)
+{
+	bool keep = (argc > 1 && strcmp(argv[1], "keep") == 0);
+	
+	if (argc > 1 && !keep) {
+		shell_error(sh, "Unknown option: %s (use 'keep')", argv[1]);
+		return -1;
+	}
+	
+	capture_start(!keep);
+	shell_print(sh, "Capture %s (%d records, oldest overwritten)",
+		    keep ? "resumed" : "started", CAPTURE_RING_SIZE);
+	
+	return 0;
+}
+
+static int cmd_capture_stop(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+	
+	capture_stop();
+	shell_print(sh, "Capture stopped: %u records held", (unsigned int)capture_count());
+	
+	return 0;
+}
+
+static int cmd_capture_status(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+	
+	size_t count = capture_count();
+	struct capture_record first, last;
+	
+	shell_print(sh, "\n=== Motion Capture ===");
+	shell_print(sh, "State: %s", capture_active() ? "Recording" : "Stopped");
+	shell_print(sh, "Records: %u / %d", (unsigned int)count, CAPTURE_RING_SIZE);
+	shell_print(sh, "Overwritten: %u", capture_overwritten());
+	
+	if (count > 1 && capture_get(0, &first) == 0 && capture_get(count - 1, &last) == 0) {
+		shell_print(sh, "Span: %u ms", (last.timestamp_us - first.timestamp_us) / 1000U);
+	}
+	
+	return 0;
+}
+
+static int cmd_capture_dump(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+	
+	if (capture_active()) {
+		shell_error(sh, "Stop the capture first: capture stop");
+		return -1;
+	}
+	
+	struct capture_header hdr;
+	struct capture_record batch[16];
+	size_t count;
+	
+	capture_fill_header(&hdr);
+	count = hdr.record_count;
+	
+	/* Header, then records in small batches; capture_tool.py reassembles */
+	shell_hexdump(sh, (const uint8_t *)&hdr, sizeof(hdr));
+	for (size_t i = 0; i < count; ) {
+		size_t n = 0;
+		
+		while (n < ARRAY_SIZE(batch) && i < count && capture_get(i, &batch[n]) == 0) {
+			n++;
+			i++;
+		}
+		if (n == 0) {
+			break;
+		}
+		shell_hexdump(sh, (const uint8_t *)batch, n * sizeof(batch[0]));
+	}
+	
+	return 0;
+}
+#endif /* CONFIG_GUITARACC_CAPTURE */
+
+#ifdef CONFIG_GUITARACC_PERF
+static int cmd_perf_show(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+	
+	shell_print(sh, "\n=== Pipeline Profile (ns) ===");
+	shell_print(sh, "%-14s %8s %8s %8s %8s %8s",
+		    "Stage", "Count", "Min", "Avg", "Max", "P99");
+	
+	for (int i = 0; i < PERF_STAGE_COUNT; i++) {
+		struct perf_summary sum;
+		
+		perf_get_summary((enum perf_stage)i, &sum);
+		if (sum.count == 0) {
+			shell_print(sh, "%-14s %8u %8s %8s %8s %8s",
+				    perf_stage_name((enum perf_stage)i), 0, "-", "-", "-", "-");
+			continue;
+		}
+		
+		shell_print(sh, "%-14s %8u %8u %8u %8u %8u",
+			    perf_stage_name((enum perf_stage)i), sum.count,
+			    sum.min_ns, sum.avg_ns, sum.max_ns, sum.p99_ns);
+	}
+	
+	return 0;
+}
+
+static int cmd_perf_reset(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+	
+	perf_reset();
+	shell_print(sh, "Pipeline profile reset");
+	
+	return 0;
+}
+#endif /* CONFIG_GUITARACC_PERF */
+
+static int cmd_midi_program(const struct shell *sh, size_t argc, char **argv)
+{
+	if (argc == 1) {
+		/* No argument - show current program */
+		uint8_t program = ui_get_current_program();
+		shell_print(sh, "Current MIDI Program: %d", program);
+	} else {
+		/* Set program */
+		int program = atoi(argv[1]);
+		
+		if (program < 0 || program > 127) {
+			shell_error(sh, "Program must be 0-127");
+			return -1;
+		}
+		
+		ui_set_current_program((uint8_t)program);
+		shell_print(sh, "MIDI Program set to %d", program);
+	}
+	
+	return 0;
+}
+
+static int cmd_midi_send_rt(const struct shell *sh, size_t argc, char **argv)
+{
+	if (argc < 2) {
+		shell_error(sh, "Usage: midi send_rt <0xF8-0xFF>");
+		shell_print(sh, "Common real-time messages:");
+		shell_print(sh, "  0xF8 - Timing Clock");
+		shell_print(sh, "  0xFA - Start");
+		shell_print(sh, "  0xFB - Continue");
+		shell_print(sh, "  0xFC - Stop");
+		shell_print(sh, "  0xFE - Active Sensing");
+		shell_print(sh, "  0xFF - Reset");
+		return -1;
+	}
+	
+	/* Parse hex value */
+	unsigned long rt_byte = strtoul(argv[1], NULL, 16);
+	
+	if (rt_byte < 0xF8 || rt_byte > 0xFF) {
+		shell_error(sh, "Invalid real-time byte (must be 0xF8-0xFF)");
+		return -1;
+	}
+	
+	int err = send_midi_realtime((uint8_t)rt_byte);
+	if (err != 0) {
+		shell_error(sh, "Failed to send real-time message (err %d)", err);
+		return err;
+	}
+	
+	shell_print(sh, "Sent real-time message: 0x%02X", (uint8_t)rt_byte);
+	return 0;
+}
+
+static int config_patch_view(const struct shell *sh, const struct config_data *cfg,
+			     size_t argc, char **argv)
+{
+	if (argc != 2) {
+		shell_error(sh, "Usage: config patch <0-%d>", NUM_PATCHES - 1);
+		return -1;
+	}
+	
+	int patch_num = atoi(argv[1]);
+	if (patch_num < 0 || patch_num >= NUM_PATCHES) {
+		shell_error(sh, "Invalid patch number (0-%d)", NUM_PATCHES - 1);
+		return -1;
+	}
+	
+	uint8_t patch_idx = (uint8_t)patch_num;
+	bool is_active = (patch_idx == cfg->global.default_patch);
+	
+	shell_print(sh, "\n--- PATCH %d%s ---", patch_idx, is_active ? " (ACTIVE)" : "");
+	shell_print(sh, "Name: %s", cfg->patches[patch_idx].patch_name);
+	shell_print(sh, "LED:");
+	shell_print(sh, "  Mode: %d", cfg->patches[patch_idx].led_mode);
+	shell_print(sh, "Accelerometer:");
+	shell_print(sh, "  Deadzone: %d", cfg->patches[patch_idx].midi_deadzone);
+	
+	return 0;
+}
+
+static int cmd_config_patch(const struct shell *sh, size_t argc, char **argv)
+{
+	return config_view(sh, argc, argv, config_patch_view);
+}
+
+static int cmd_config_select_patch(const struct shell *sh, size_t argc, char **argv)
+{
+	if (argc != 2) {
+		shell_error(sh, "Usage: config select <0-%d>", NUM_PATCHES - 1);
+		return -1;
+	}
+	
+	int patch_num = atoi(argv[1]);
+	if (patch_num < 0 || patch_num >= NUM_PATCHES) {
+		shell_error(sh, "Invalid patch number (0-%d)", NUM_PATCHES - 1);
+		return -1;
+	}
+	
+	struct config_data *cfg = &work_config;
+	if (config_edit_load(cfg) != 0) {
+		shell_error(sh, "Error loading configuration");
+		return -1;
+	}
+	
+	cfg->global.default_patch = (uint8_t)patch_num;
+	
+	if (config_edit_save(cfg) != 0) {
+		shell_error(sh, "Error saving configuration");
+		return -1;
+	}
+	
+	shell_print(sh, "Active patch changed to %d (%s)", 
+		    patch_num, cfg->patches[patch_num].patch_name);
+	
+	/* Trigger config reload */
+	config_edit_apply();
+	
+	return 0;
+}
+
+static int config_list_patches_view(const struct shell *sh, const struct config_data *cfg,
+				    size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+	
+	uint8_t active = cfg->global.default_patch;
+	
+	shell_print(sh, "\n=== Patches (0-%d) ===", NUM_PATCHES - 1);
+	shell_print(sh, "Active patch: %d\n", active);
+	
+	for (int i = 0; i < NUM_PATCHES; i++) {
+		shell_print(sh, "%c %3d: %s",
+			    (i == active) ? '*' : ' ',
+			    i,
+			    cfg->patches[i].patch_name);
+	}
+	
+	shell_print(sh, "\nUse 'config patch <num>' to view a patch, 'bank list' for programs 0-127");
+	shell_print(sh, "\nUse 'config select <num>' to change active patch");
+	
+	return 0;
+}
+
+static int cmd_config_list_patches(const struct shell *sh, size_t argc, char **argv)
+{
+	return config_view(sh, argc, argv, config_list_patches_view);
+}
+
+static int cmd_config_erase_all(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+	
+	if (edit_active) {
+		shell_error(sh, "Edit session open: 'config commit' or 'config abort' first");
+		return -EBUSY;
+	}
+	
+	shell_warn(sh, "*** WARNING: ERASE ALL CONFIGURATION STORAGE ***");
+	shell_warn(sh, "This will erase AREA_A and AREA_B");
+	shell_warn(sh, "Device will use hardcoded defaults on next boot");
+	shell_warn(sh, "This command is for TESTING ONLY!");
+	
+	if (config_storage_erase_all() != 0) {
+		shell_error(sh, "Error erasing configuration storage");
+		return -1;
+	}
+	
+	shell_print(sh, "All configuration erased successfully");
+	shell_warn(sh, "*** REBOOT REQUIRED ***");
+	shell_print(sh, "Use 'kernel reboot cold' or power cycle");
+	
+	return 0;
+}
+
+/* Helper function to print JSON boolean */
+static const char *json_bool(bool value)
+{
+	return value ? "true" : "false";
+}
+
+/* Helper function to print patch as JSON */
 static void print_patch_json(const struct shell *sh, const struct patch_config *patch, int patch_num, bool last)
 {
 	shell_print(sh, "      {");
@@ -908,14 +1425,9 @@ static void print_patch_json(const struct shell *sh, const struct patch_config *
 	shell_print(sh, "      }%s", last ? "" : ",");
 }
 
-static int cmd_config_export(const struct shell *sh, size_t argc, char **argv)
+static int config_export_view(const struct shell *sh, const struct config_data *cfg,
+			      size_t argc, char **argv)
 {
-	static struct config_data cfg;
-	if (config_storage_load(&cfg) != 0) {
-		shell_error(sh, "Error loading configuration");
-		return -1;
-	}
-	
 	/* Determine export type: full, global, or single patch */
 	bool export_global = false;
 	bool export_patches = false;
@@ -946,25 +1458,25 @@ static int cmd_config_export(const struct shell *sh, size_t argc, char **argv)
 	shell_print(sh, "  \"version\": 1,");
 	shell_print(sh, "  \"firmware_version\": \"1.0.0\",");
 	shell_print(sh, "  \"patch_count\": %d,", NUM_PATCHES);
-	shell_print(sh, "  \"current_patch\": %d,", cfg.global.default_patch);
+	shell_print(sh, "  \"current_patch\": %d,", cfg->global.default_patch);
 	shell_print(sh, "  \"config\": {");
 	
 	/* Export global section */
 	if (export_global) {
 		shell_print(sh, "    \"global\": {");
-		shell_print(sh, "      \"default_patch\": %d,", cfg.global.default_patch);
-		shell_print(sh, "      \"midi_channel\": %d,", cfg.global.midi_channel);
-		shell_print(sh, "      \"max_guitars\": %d,", cfg.global.max_guitars);
-		shell_print(sh, "      \"ble_scan_interval_ms\": %d,", cfg.global.scan_interval_ms);
-		shell_print(sh, "      \"led_brightness\": %d,", cfg.global.led_brightness);
-		shell_print(sh, "      \"running_average_enable\": %s,", json_bool(cfg.global.running_average_enable));
-		shell_print(sh, "      \"running_average_depth\": %d,", cfg.global.running_average_depth);
+		shell_print(sh, "      \"default_patch\": %d,", cfg->global.default_patch);
+		shell_print(sh, "      \"midi_channel\": %d,", cfg->global.midi_channel);
+		shell_print(sh, "      \"max_guitars\": %d,", cfg->global.max_guitars);
+		shell_print(sh, "      \"ble_scan_interval_ms\": %d,", cfg->global.scan_interval_ms);
+		shell_print(sh, "      \"led_brightness\": %d,", cfg->global.led_brightness);
+		shell_print(sh, "      \"running_average_enable\": %s,", json_bool(cfg->global.running_average_enable));
+		shell_print(sh, "      \"running_average_depth\": %d,", cfg->global.running_average_depth);
 		shell_print(sh, "      \"accel_scale\": [%d, %d, %d, %d, %d, %d],", 
-			cfg.global.accel_scale[0], cfg.global.accel_scale[1], cfg.global.accel_scale[2],
-			cfg.global.accel_scale[3], cfg.global.accel_scale[4], cfg.global.accel_scale[5]);
+			cfg->global.accel_scale[0], cfg->global.accel_scale[1], cfg->global.accel_scale[2],
+			cfg->global.accel_scale[3], cfg->global.accel_scale[4], cfg->global.accel_scale[5]);
 		shell_print(sh, "      \"accel_offset\": [%d, %d, %d, %d, %d, %d]", 
-			cfg.global.accel_offset[0], cfg.global.accel_offset[1], cfg.global.accel_offset[2],
-			cfg.global.accel_offset[3], cfg.global.accel_offset[4], cfg.global.accel_offset[5]);
+			cfg->global.accel_offset[0], cfg->global.accel_offset[1], cfg->global.accel_offset[2],
+			cfg->global.accel_offset[3], cfg->global.accel_offset[4], cfg->global.accel_offset[5]);
 		shell_print(sh, "    }%s", export_patches ? "," : "");
 	}
 	
@@ -974,11 +1486,11 @@ static int cmd_config_export(const struct shell *sh, size_t argc, char **argv)
 		
 		if (single_patch >= 0) {
 			/* Export single patch */
-			print_patch_json(sh, &cfg.patches[single_patch], single_patch, true);
+			print_patch_json(sh, &cfg->patches[single_patch], single_patch, true);
 		} else {
 			/* Export all patches */
 			for (int i = 0; i < NUM_PATCHES; i++) {
-				print_patch_json(sh, &cfg.patches[i], i, (i == NUM_PATCHES - 1));
+				print_patch_json(sh, &cfg->patches[i], i, (i == NUM_PATCHES - 1));
 			}
 		}
 		
@@ -992,29 +1504,28 @@ static int cmd_config_export(const struct shell *sh, size_t argc, char **argv)
 	return 0;
 }
 
+static int cmd_config_export(const struct shell *sh, size_t argc, char **argv)
+{
+	return config_view(sh, argc, argv, config_export_view);
+}
+
 /*
  * Topology commands
  */
 
-static int cmd_topo_show(const struct shell *sh, size_t argc, char **argv)
+static int topo_show_view(const struct shell *sh, const struct config_data *cfg,
+			  size_t argc, char **argv)
 {
-	struct config_data cfg;
-	int err = config_storage_load(&cfg);
-	if (err) {
-		shell_error(sh, "Failed to load configuration");
-		return err;
-	}
-	
-	uint8_t patch_idx = cfg.global.default_patch;
+	uint8_t patch_idx = cfg->global.default_patch;
 	if (patch_idx >= NUM_PATCHES) patch_idx = 0;
 	
 	shell_print(sh, "Virtual Ports Topology - Patch %d [ALWAYS ACTIVE]", patch_idx);
 	shell_print(sh, "Default Mixer: %d (0=PASSTHROUGH, 1=SUM, 2=AVERAGE, 3=MAX, 4=MIN)",
-		cfg.patches[patch_idx].default_mixer_type);
+		cfg->patches[patch_idx].default_mixer_type);
 	shell_print(sh, "");
 	
 	for (int i = 0; i < MAX_TOPOLOGY_INSTANCES; i++) {
-		struct topology_instance *topo = &cfg.patches[patch_idx].topologies[i];
+		const struct topology_instance *topo = &cfg->patches[patch_idx].topologies[i];
 		if (!topo->enabled) continue;
 		
 		shell_print(sh, "Instance %d: %s", i, topology_get_name(topo->topology_type));
@@ -1026,11 +1537,16 @@ static int cmd_topo_show(const struct shell *sh, size_t argc, char **argv)
 	return 0;
 }
 
-/* Legacy command - topology is now always active
-static int cmd_topo_enable(const struct shell *sh, size_t argc, char **argv)
+static int cmd_topo_show(const struct shell *sh, size_t argc, char **argv)
+{
+	return config_view(sh, argc, argv, topo_show_view);
+}
+
+/* Legacy command - topology is now always active
+static int cmd_topo_enable(const struct shell *sh, size_t argc, char **argv)
 {
 	struct config_data cfg;
-	int err = config_storage_load(&cfg);
+	int err = config_edit_load(&cfg);
 	if (err) {
 		shell_error(sh, "Failed to load configuration");
 		return err;
@@ -1042,7 +1558,7 @@ static int cmd_topo_enable(const struct shell *sh, size_t argc, char **argv)
 	int enable = atoi(argv[1]);
 	cfg.patches[patch_idx].topology_enabled = (enable != 0) ? 1 : 0;
 	
-	err = config_storage_save(&cfg);
+	err = config_edit_save(&cfg);
 	if (err) {
 		shell_error(sh, "Failed to save configuration");
 		return err;
@@ -1072,14 +1588,14 @@ static int cmd_topo_mixer(const struct shell *sh, size_t argc, char **argv)
 		return -EINVAL;
 	}
 	
-	struct config_data cfg;
-	int err = config_storage_load(&cfg);
+	struct config_data *cfg = &work_config;
+	int err = config_edit_load(cfg);
 	if (err) {
 		shell_error(sh, "Failed to load configuration");
 		return err;
 	}
 	
-	uint8_t patch_idx = cfg.global.default_patch;
+	uint8_t patch_idx = cfg->global.default_patch;
 	if (patch_idx >= NUM_PATCHES) patch_idx = 0;
 	
 	int mixer_type = atoi(argv[1]);
@@ -1088,9 +1604,9 @@ static int cmd_topo_mixer(const struct shell *sh, size_t argc, char **argv)
 		return -EINVAL;
 	}
 	
-	cfg.patches[patch_idx].default_mixer_type = mixer_type;
+	cfg->patches[patch_idx].default_mixer_type = mixer_type;
 	
-	err = config_storage_save(&cfg);
+	err = config_edit_save(cfg);
 	if (err) {
 		shell_error(sh, "Failed to save configuration");
 		return err;
@@ -1113,7 +1629,8 @@ static int cmd_topo_config(const struct shell *sh, size_t argc, char **argv)
 		shell_error(sh, "Usage: topo config <instance> <type> <accel> [func] [midi_cc]");
 		shell_print(sh, "  instance: 0-5");
 		shell_print(sh, "  type: 1=T1 (1 accel), 2=T2 (2 accel), 3=T3 (1 accel), 4=T4 (2 accel)");
-		shell_print(sh, "  accel: axis index 0-5 (X,Y,Z,Roll,Pitch,Yaw)");
+		shell_print(sh, "  accel: source index 0-11 (X,Y,Z,Roll,Pitch,Yaw,");
+		shell_print(sh, "         |a|,JerkX,JerkY,JerkZ,|Jerk|,Energy)");
 		shell_print(sh, "         For T2/T4: use comma-separated like '0,1' for X+Y axes");
 		shell_print(sh, "  func: function unit index 0-7 (optional)");
 		shell_print(sh, "  midi_cc: MIDI CC number 0-127 (optional)");
@@ -1123,14 +1640,14 @@ static int cmd_topo_config(const struct shell *sh, size_t argc, char **argv)
 		return -EINVAL;
 	}
 	
-	struct config_data cfg;
-	int err = config_storage_load(&cfg);
+	struct config_data *cfg = &work_config;
+	int err = config_edit_load(cfg);
 	if (err) {
 		shell_error(sh, "Failed to load configuration");
 		return err;
 	}
 	
-	uint8_t patch_idx = cfg.global.default_patch;
+	uint8_t patch_idx = cfg->global.default_patch;
 	if (patch_idx >= NUM_PATCHES) patch_idx = 0;
 	
 	int instance = atoi(argv[1]);
@@ -1146,7 +1663,9 @@ static int cmd_topo_config(const struct shell *sh, size_t argc, char **argv)
 		return -EINVAL;
 	}
 	
-	struct topology_instance *topo = &cfg.patches[patch_idx].topologies[instance];
+	/* Built aside and stored once every argument is checked */
+	struct topology_instance new_topo = cfg->patches[patch_idx].topologies[instance];
+	struct topology_instance *topo = &new_topo;
 	topo->topology_type = type;
 	topo->enabled = 1;
 	
@@ -1175,9 +1694,9 @@ static int cmd_topo_config(const struct shell *sh, size_t argc, char **argv)
 	
 	/* Validate accelerometer input indices */
 	for (int i = 0; i < num_accel_inputs; i++) {
-		if (topo->accel_inputs[i] >= MAX_ACCEL_SOURCES) {
+		if (topo->accel_inputs[i] >= MAX_SENSOR_SOURCES) {
 			shell_error(sh, "Invalid accel input: %d (must be 0-%d)", 
-				topo->accel_inputs[i], MAX_ACCEL_SOURCES-1);
+				topo->accel_inputs[i], MAX_SENSOR_SOURCES-1);
 			return -EINVAL;
 		}
 	}
@@ -1234,7 +1753,8 @@ static int cmd_topo_config(const struct shell *sh, size_t argc, char **argv)
 		}
 	}
 	
-	err = config_storage_save(&cfg);
+	cfg->patches[patch_idx].topologies[instance] = new_topo;
+	err = config_edit_save(cfg);
 	if (err) {
 		shell_error(sh, "Failed to save configuration");
 		return err;
@@ -1265,16 +1785,10 @@ static int cmd_topo_config(const struct shell *sh, size_t argc, char **argv)
  * Function commands
  */
 
-static int cmd_func_show(const struct shell *sh, size_t argc, char **argv)
+static int func_show_view(const struct shell *sh, const struct config_data *cfg,
+			  size_t argc, char **argv)
 {
-	struct config_data cfg;
-	int err = config_storage_load(&cfg);
-	if (err) {
-		shell_error(sh, "Failed to load configuration");
-		return err;
-	}
-	
-	uint8_t patch_idx = cfg.global.default_patch;
+	uint8_t patch_idx = cfg->global.default_patch;
 	if (patch_idx >= NUM_PATCHES) patch_idx = 0;
 	
 	int func_idx = 0;
@@ -1287,7 +1801,7 @@ static int cmd_func_show(const struct shell *sh, size_t argc, char **argv)
 		return -EINVAL;
 	}
 	
-	struct function_unit *func = &cfg.patches[patch_idx].functions[func_idx];
+	const struct function_unit *func = &cfg->patches[patch_idx].functions[func_idx];
 	
 	shell_print(sh, "Function Unit %d:", func_idx);
 	shell_print(sh, "  Type: %d %s", func->function_type, 
@@ -1308,6 +1822,11 @@ static int cmd_func_show(const struct shell *sh, size_t argc, char **argv)
 	return 0;
 }
 
+static int cmd_func_show(const struct shell *sh, size_t argc, char **argv)
+{
+	return config_view(sh, argc, argv, func_show_view);
+}
+
 static int cmd_func_linear(const struct shell *sh, size_t argc, char **argv)
 {
 	if (argc < 6) {
@@ -1315,14 +1834,14 @@ static int cmd_func_linear(const struct shell *sh, size_t argc, char **argv)
 		return -EINVAL;
 	}
 	
-	struct config_data cfg;
-	int err = config_storage_load(&cfg);
+	struct config_data *cfg = &work_config;
+	int err = config_edit_load(cfg);
 	if (err) {
 		shell_error(sh, "Failed to load configuration");
 		return err;
 	}
 	
-	uint8_t patch_idx = cfg.global.default_patch;
+	uint8_t patch_idx = cfg->global.default_patch;
 	if (patch_idx >= NUM_PATCHES) patch_idx = 0;
 	
 	int func_idx = atoi(argv[1]);
@@ -1336,10 +1855,10 @@ static int cmd_func_linear(const struct shell *sh, size_t argc, char **argv)
 		return -EINVAL;
 	}
 	
-	struct function_unit *func = &cfg.patches[patch_idx].functions[func_idx];
+	struct function_unit *func = &cfg->patches[patch_idx].functions[func_idx];
 	func_init_linear(func, in_min, in_max, out_min, out_max);
 	
-	err = config_storage_save(&cfg);
+	err = config_edit_save(cfg);
 	if (err) {
 		shell_error(sh, "Failed to save configuration");
 		return err;
@@ -1356,7 +1875,8 @@ static int cmd_func_linear(const struct shell *sh, size_t argc, char **argv)
  * Virtual Port commands
  */
 
-static int cmd_vport_show(const struct shell *sh, size_t argc, char **argv)
+static int vport_show_view(const struct shell *sh, const struct config_data *cfg,
+			   size_t argc, char **argv)
 {
 	if (argc < 2) {
 		shell_error(sh, "Usage: vport show <instance> [vport_offset]");
@@ -1381,18 +1901,10 @@ static int cmd_vport_show(const struct shell *sh, size_t argc, char **argv)
 		return -EIO;
 	}
 	
-	/* Load configuration to get topology info */
-	struct config_data cfg;
-	int err = config_storage_load(&cfg);
-	if (err) {
-		shell_error(sh, "Failed to load configuration");
-		return err;
-	}
-	
-	uint8_t patch_idx = cfg.global.default_patch;
+	uint8_t patch_idx = cfg->global.default_patch;
 	if (patch_idx >= NUM_PATCHES) patch_idx = 0;
 	
-	const struct topology_instance *topo = &cfg.patches[patch_idx].topologies[instance];
+	const struct topology_instance *topo = &cfg->patches[patch_idx].topologies[instance];
 	
 	/* Check if instance is enabled */
 	if (!topo->enabled || topo->topology_type == TOPO_DISABLED) {
@@ -1412,7 +1924,7 @@ static int cmd_vport_show(const struct shell *sh, size_t argc, char **argv)
 	int pos = 0;
 	for (int i = 0; i < num_inputs; i++) {
 		uint8_t sensor_idx = topo->accel_inputs[i];
-		if (sensor_idx >= MAX_ACCEL_SOURCES) continue;
+		if (sensor_idx >= MAX_SENSOR_SOURCES) continue;
 		
 		int16_t sensor_value = proc->accel_values[sensor_idx];
 		const char *sensor_name = topology_get_sensor_name(sensor_idx);
@@ -1483,6 +1995,262 @@ static int cmd_vport_show(const struct shell *sh, size_t argc, char **argv)
 	return 0;
 }
 
+static int cmd_vport_show(const struct shell *sh, size_t argc, char **argv)
+{
+	return config_view(sh, argc, argv, vport_show_view);
+}
+
+/*
+ * Configuration edit session commands
+ */
+
+static int cmd_config_begin(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+	
+	if (edit_active) {
+		shell_error(sh, "Edit session already open (%u changes staged)", edit_changes);
+		return -EBUSY;
+	}
+	
+	if (xfer.active) {
+		shell_error(sh, "Binary import in progress ('config bin abort' first)");
+		return -EBUSY;
+	}
+	
+	if (config_storage_load(&work_config) != 0) {
+		shell_error(sh, "Error loading configuration");
+		return -1;
+	}
+	
+	edit_active = true;
+	edit_changes = 0;
+	shell_print(sh, "Edit session started: changes are staged until 'config commit'");
+	return 0;
+}
+
+static int cmd_config_commit(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+	
+	if (!edit_active) {
+		shell_error(sh, "No edit session open ('config begin' first)");
+		return -EINVAL;
+	}
+	
+	/* On failure the session stays open so the edits can be fixed */
+	int err = config_storage_validate(&work_config);
+	if (err) {
+		shell_error(sh, "Validation failed, nothing saved (see log)");
+		return err;
+	}
+	
+	err = config_storage_save(&work_config);
+	if (err) {
+		shell_error(sh, "Error saving configuration (code: %d)", err);
+		return err;
+	}
+	
+	edit_active = false;
+	config_edit_apply();
+	
+	shell_print(sh, "Committed %u changes", edit_changes);
+	return 0;
+}
+
+static int cmd_config_abort(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+	
+	if (!edit_active) {
+		shell_error(sh, "No edit session open");
+		return -EINVAL;
+	}
+	
+	edit_active = false;
+	shell_print(sh, "Discarded %u staged changes", edit_changes);
+	return 0;
+}
+
+/*
+ * Prints the current config_data layout for config_tool.py, which uses it
+ * to migrate backups taken from firmware with another CONFIG_VERSION.
+ */
+static int cmd_config_schema(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+	
+	const struct config_schema *schema = config_storage_get_schema();
+	char line[CONFIG_SCHEMA_LINE_MAX];
+	
+	shell_print(sh, "CFGSCHEMA %u %u %u", schema->version, schema->size, schema->field_count);
+	for (uint16_t i = 0; i < schema->field_count; i++) {
+		if (config_schema_format_field(&schema->fields[i], line, sizeof(line)) > 0) {
+			shell_print(sh, "%s", line);
+		}
+	}
+	shell_print(sh, "CFGSCHEMA END");
+	return 0;
+}
+
+/*
+ * Binary configuration transfer commands
+ *
+ * Replies start with "OK" or "ERR" followed by the next offset the sender
+ * should send, so config_tool.py can stream chunks and resume after an
+ * error without parsing anything else.
+ */
+
+static int cmd_config_bin_dump(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+	
+	const struct config_data *cfg = config_storage_acquire();
+	uint8_t hash[CONFIG_HASH_SIZE];
+	char hex[2 * CONFIG_HASH_SIZE + 1];
+	char line[XFER_LINE_MAX];
+	
+	if (!cfg || config_storage_hash(cfg, hash) != 0) {
+		config_storage_release(cfg);
+		shell_error(sh, "ERR Error loading configuration");
+		return -1;
+	}
+	
+	config_xfer_hex_encode(hash, sizeof(hash), hex);
+	shell_print(sh, "CFGBIN BEGIN %u %zu %s", CONFIG_VERSION, sizeof(*cfg), hex);
+	
+	for (uint32_t offset = 0; offset < sizeof(*cfg); offset += XFER_CHUNK_SIZE) {
+		config_xfer_format_chunk((const uint8_t *)cfg, sizeof(*cfg), offset,
+					 line, sizeof(line));
+		shell_print(sh, "CFGBIN %s", line);
+	}
+	
+	config_storage_release(cfg);
+	shell_print(sh, "CFGBIN END");
+	return 0;
+}
+
+static int cmd_config_bin_begin(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	
+	uint8_t hash[CONFIG_HASH_SIZE];
+	unsigned long version = strtoul(argv[1], NULL, 10);
+	unsigned long size = strtoul(argv[2], NULL, 10);
+	
+	if (edit_active) {
+		shell_error(sh, "ERR Edit session open: 'config commit' or 'config abort' first");
+		return -EBUSY;
+	}
+	
+	if (version != CONFIG_VERSION || size != sizeof(struct config_data)) {
+		shell_error(sh, "ERR Expected version %u size %zu", CONFIG_VERSION,
+			    sizeof(struct config_data));
+		return -EINVAL;
+	}
+	
+	if (config_xfer_hex_decode(argv[3], hash, sizeof(hash)) != 0) {
+		shell_error(sh, "ERR Invalid SHA-256");
+		return -EINVAL;
+	}
+	
+	int resumed = config_xfer_begin(&xfer, (uint8_t *)&work_config, size, hash);
+	if (resumed < 0) {
+		shell_error(sh, "ERR %d", resumed);
+		return resumed;
+	}
+	
+	shell_print(sh, "OK %d%s", config_xfer_next_missing(&xfer), resumed ? " resumed" : "");
+	return 0;
+}
+
+static int cmd_config_bin_put(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	
+	uint32_t offset = strtoul(argv[1], NULL, 10);
+	uint32_t crc = strtoul(argv[3], NULL, 16);
+	
+	int err = config_xfer_put(&xfer, offset, argv[2], crc);
+	if (err) {
+		shell_error(sh, "ERR %d %d", err, config_xfer_next_missing(&xfer));
+		return err;
+	}
+	
+	shell_print(sh, "OK %d", config_xfer_next_missing(&xfer));
+	return 0;
+}
+
+static int cmd_config_bin_status(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+	
+	if (!xfer.active) {
+		shell_error(sh, "ERR No binary import in progress");
+		return -EINVAL;
+	}
+	
+	shell_print(sh, "OK %d (%u/%u chunks)", config_xfer_next_missing(&xfer),
+		    xfer.received_count, xfer.chunks);
+	return 0;
+}
+
+static int cmd_config_bin_commit(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+	
+	uint8_t hash[CONFIG_HASH_SIZE];
+	int next = config_xfer_next_missing(&xfer);
+	
+	if (next < 0) {
+		shell_error(sh, "ERR No binary import in progress");
+		return -EINVAL;
+	}
+	if ((size_t)next != xfer.size) {
+		shell_error(sh, "ERR Incomplete %d", next);
+		return -EINVAL;
+	}
+	
+	/* Whole-image check on top of the per-chunk CRCs */
+	if (config_storage_hash(&work_config, hash) != 0 ||
+	    memcmp(hash, xfer.sha256, sizeof(hash)) != 0) {
+		config_xfer_abort(&xfer);
+		shell_error(sh, "ERR SHA-256 mismatch, import discarded");
+		return -EBADMSG;
+	}
+	
+	int err = config_storage_validate(&work_config);
+	if (err == 0) {
+		err = config_storage_save(&work_config);
+	}
+	config_xfer_abort(&xfer);
+	if (err) {
+		shell_error(sh, "ERR Import rejected (code: %d)", err);
+		return err;
+	}
+	
+	config_edit_apply();
+	shell_print(sh, "OK Configuration imported");
+	return 0;
+}
+
+static int cmd_config_bin_abort(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+	
+	config_xfer_abort(&xfer);
+	shell_print(sh, "OK Binary import discarded");
+	return 0;
+}
+
 /*
  * Configuration reload command
  */
@@ -1507,13 +2275,321 @@ static int cmd_config_import(const struct shell *sh, size_t argc, char **argv)
 	ARG_UNUSED(argc);
 	ARG_UNUSED(argv);
 	
-	shell_warn(sh, "Interactive import not yet implemented");
-	shell_print(sh, "Use config_tool.py script for importing configurations");
+	shell_warn(sh, "Interactive JSON import not yet implemented");
+	shell_print(sh, "Use 'config_tool.py restore' (binary import via 'config bin')");
 	shell_print(sh, "Or manually set values using:");
 	shell_print(sh, "  config midi_ch <1-16>");
-	shell_print(sh, "  config select <0-15>");
+	shell_print(sh, "  config select <0-3>");
 	shell_print(sh, "  config save");
+	shell_print(sh, "Wrap a batch of setters in 'config begin' ... 'config commit'");
+	shell_print(sh, "to save and apply them once");
+	
+	return 0;
+}
+
+static int gesture_show_view(const struct shell *sh, const struct config_data *cfg,
+			     size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+	
+	static const char *const action_names[GESTURE_ACTION_COUNT] = {
+		"NOTE", "PROGRAM", "CC_TOGGLE"
+	};
+	
+	uint8_t patch_idx = cfg->global.default_patch;
+	if (patch_idx >= NUM_PATCHES) patch_idx = 0;
+	
+	const struct gesture_config *gc = &cfg->patches[patch_idx].gestures;
+	
+	shell_print(sh, "Patch %d gestures:", patch_idx);
+	for (int i = 0; i < GESTURE_SLOTS; i++) {
+		const struct gesture_slot *slot = &gc->slots[i];
+		
+		if (slot->type == GESTURE_NONE) {
+			shell_print(sh, "  [%d] -", i);
+			continue;
+		}
+		shell_print(sh, "  [%d] %-5s %-10s -> %s %d, threshold %d, curve %d", i,
+			gesture_type_name(slot->type), topology_get_sensor_name(slot->source),
+			slot->action < GESTURE_ACTION_COUNT ? action_names[slot->action] : "UNKNOWN",
+			slot->number, slot->threshold * GESTURE_THRESHOLD_UNIT, slot->velocity_curve);
+	}
+	
+	return 0;
+}
+
+static int cmd_gesture_show(const struct shell *sh, size_t argc, char **argv)
+{
+	return config_view(sh, argc, argv, gesture_show_view);
+}
+
+static int cmd_gesture_set(const struct shell *sh, size_t argc, char **argv)
+{
+	if (argc < 7) {
+		shell_error(sh, "Usage: gesture set <slot> <type> <source> <action> <number> <threshold> [curve]");
+		shell_print(sh, "  slot: 0-%d", GESTURE_SLOTS - 1);
+		shell_print(sh, "  type: 1=STRUM, 2=SHAKE, 3=FLICK, 4=TAP, 5=TILT");
+		shell_print(sh, "  source: source index 0-%d (as for topo config)", MAX_SENSOR_SOURCES - 1);
+		shell_print(sh, "  action: 0=NOTE, 1=PROGRAM, 2=CC_TOGGLE");
+		shell_print(sh, "  number: note, program or CC number 0-127");
+		shell_print(sh, "  threshold: trigger level in source units (%d-%d)",
+			GESTURE_THRESHOLD_UNIT, 255 * GESTURE_THRESHOLD_UNIT);
+		shell_print(sh, "  curve: velocity curve 0=hard, 64=linear (default), 127=soft");
+		shell_print(sh, "Examples:");
+		shell_print(sh, "  gesture set 0 1 8 0 60 400    # Strum on Jerk Y plays C4");
+		shell_print(sh, "  gesture set 1 2 11 2 80 300   # Shake (energy) toggles CC 80");
+		return -EINVAL;
+	}
+	
+	int threshold = atoi(argv[6]);
+	struct gesture_slot slot = {
+		.type = (uint8_t)atoi(argv[2]),
+		.source = (uint8_t)atoi(argv[3]),
+		.action = (uint8_t)atoi(argv[4]),
+		.number = (uint8_t)atoi(argv[5]),
+		.threshold = (uint8_t)(threshold / GESTURE_THRESHOLD_UNIT),
+		.velocity_curve = (argc > 7) ? (uint8_t)atoi(argv[7]) : GESTURE_VELOCITY_LINEAR,
+	};
+	int idx = atoi(argv[1]);
+	
+	if (idx < 0 || idx >= GESTURE_SLOTS) {
+		shell_error(sh, "Invalid slot: %d (must be 0-%d)", idx, GESTURE_SLOTS - 1);
+		return -EINVAL;
+	}
+	if (threshold < GESTURE_THRESHOLD_UNIT || threshold > 255 * GESTURE_THRESHOLD_UNIT) {
+		shell_error(sh, "Invalid threshold: %d (must be %d-%d)", threshold,
+			GESTURE_THRESHOLD_UNIT, 255 * GESTURE_THRESHOLD_UNIT);
+		return -EINVAL;
+	}
+	
+	struct config_data *cfg = &work_config;
+	int err = config_edit_load(cfg);
+	if (err) {
+		shell_error(sh, "Failed to load configuration");
+		return err;
+	}
+	
+	uint8_t patch_idx = cfg->global.default_patch;
+	if (patch_idx >= NUM_PATCHES) patch_idx = 0;
+	
+	struct gesture_config gc = cfg->patches[patch_idx].gestures;
+	gc.slots[idx] = slot;
+	if (slot.type == GESTURE_NONE || !gesture_config_validate(&gc)) {
+		shell_error(sh, "Invalid gesture (check type, source, action and number)");
+		return -EINVAL;
+	}
+	cfg->patches[patch_idx].gestures = gc;
+	
+	err = config_edit_save(cfg);
+	if (err) {
+		shell_error(sh, "Failed to save configuration");
+		return err;
+	}
+	
+	shell_print(sh, "Patch %d gesture %d set: %s on %s", patch_idx, idx,
+		gesture_type_name(slot.type), topology_get_sensor_name(slot.source));
+	shell_print(sh, "Run 'config reload' to apply changes");
+	
+	return 0;
+}
+
+static int cmd_gesture_clear(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	
+	int idx = atoi(argv[1]);
+	if (idx < 0 || idx >= GESTURE_SLOTS) {
+		shell_error(sh, "Invalid slot: %d (must be 0-%d)", idx, GESTURE_SLOTS - 1);
+		return -EINVAL;
+	}
+	
+	struct config_data *cfg = &work_config;
+	int err = config_edit_load(cfg);
+	if (err) {
+		shell_error(sh, "Failed to load configuration");
+		return err;
+	}
+	
+	uint8_t patch_idx = cfg->global.default_patch;
+	if (patch_idx >= NUM_PATCHES) patch_idx = 0;
+	
+	memset(&cfg->patches[patch_idx].gestures.slots[idx], 0, sizeof(struct gesture_slot));
+	
+	err = config_edit_save(cfg);
+	if (err) {
+		shell_error(sh, "Failed to save configuration");
+		return err;
+	}
+	
+	shell_print(sh, "Patch %d gesture %d cleared", patch_idx, idx);
+	shell_print(sh, "Run 'config reload' to apply changes");
+	
+	return 0;
+}
+
+static int cmd_boot(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+	
+	struct boot_timing boot;
+	uint32_t us;
+	
+	ui_get_boot_timing(&boot);
+	shell_print(sh, "%-12s %10s %10s", "Phase", "Start us", "Took us");
+	for (int i = 0; i < boot.count; i++) {
+		const struct boot_phase *p = &boot.phases[i];
+		
+		if (p->done) {
+			shell_print(sh, "%-12s %10u %10u", p->name, p->start_us,
+				    boot_timing_duration(&boot, i));
+		} else {
+			shell_print(sh, "%-12s %10u %10s", p->name, p->start_us, "running");
+		}
+	}
+	
+	for (int ms = 0; ms < BOOT_MS_COUNT; ms++) {
+		if (boot_timing_get_milestone(&boot, ms, &us)) {
+			shell_print(sh, "%-12s %10u", boot_timing_milestone_name(ms), us);
+		} else {
+			shell_print(sh, "%-12s %10s", boot_timing_milestone_name(ms), "not yet");
+		}
+	}
+	
+	return 0;
+}
+
+/*
+ * Patch bank commands (Program Change 0-127)
+ */
+
+static int parse_program(const struct shell *sh, const char *arg)
+{
+	int program = atoi(arg);
+	
+	if (program < 0 || program >= PATCH_BANK_PROGRAMS) {
+		shell_error(sh, "Invalid program: %d (must be 0-%d)", program, PATCH_BANK_PROGRAMS - 1);
+		return -EINVAL;
+	}
+	return program;
+}
+
+static int bank_store_view(const struct shell *sh, const struct config_data *cfg,
+			   size_t argc, char **argv)
+{
+	int program = parse_program(sh, argv[1]);
+	
+	if (program < 0) {
+		return program;
+	}
+	
+	/* Source: the given config patch, or the active one */
+	int patch_idx = (argc > 2) ? atoi(argv[2]) : cfg->global.default_patch;
+	if (patch_idx < 0 || patch_idx >= NUM_PATCHES) {
+		shell_error(sh, "Invalid patch: %d (must be 0-%d)", patch_idx, NUM_PATCHES - 1);
+		return -EINVAL;
+	}
+	
+	int err = patch_store_write((uint8_t)program, &cfg->patches[patch_idx]);
+	if (err) {
+		shell_error(sh, "Failed to store program %d (code: %d)", program, err);
+		return err;
+	}
+	
+	shell_print(sh, "Patch %d (%s) stored as program %d", patch_idx,
+		    cfg->patches[patch_idx].patch_name, program);
+	return 0;
+}
+
+static int cmd_bank_store(const struct shell *sh, size_t argc, char **argv)
+{
+	return config_view(sh, argc, argv, bank_store_view);
+}
+
+static int cmd_bank_load(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	
+	int program = parse_program(sh, argv[1]);
+	if (program < 0) {
+		return program;
+	}
+	
+	if (!patch_bank_is_stored(patch_store_get_bank(), (uint8_t)program)) {
+		shell_warn(sh, "Program %d has no bank patch; current patch stays", program);
+	}
 	
+	/* Same path as a received Program Change */
+	ui_set_current_program((uint8_t)program);
+	shell_print(sh, "Program %d selected", program);
+	return 0;
+}
+
+static int cmd_bank_delete(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	
+	int program = parse_program(sh, argv[1]);
+	if (program < 0) {
+		return program;
+	}
+	
+	int err = patch_store_delete((uint8_t)program);
+	if (err) {
+		shell_error(sh, "Failed to delete program %d (code: %d)", program, err);
+		return err;
+	}
+	
+	shell_print(sh, "Program %d deleted", program);
+	return 0;
+}
+
+static int cmd_bank_list(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+	
+	char name[32];
+	const struct patch_bank *bank = patch_store_get_bank();
+	uint8_t current = ui_get_current_program();
+	
+	shell_print(sh, "\n=== Patch Bank (%d/%d programs) ===", patch_bank_count(bank),
+		    PATCH_BANK_PROGRAMS);
+	
+	for (int p = 0; p < PATCH_BANK_PROGRAMS; p++) {
+		if (!patch_bank_is_stored(bank, (uint8_t)p)) {
+			continue;
+		}
+		if (patch_store_get_name((uint8_t)p, name) != 0) {
+			strcpy(name, "<unreadable>");
+		}
+		shell_print(sh, "%c %3d: %s", (p == current) ? '*' : ' ', p, name);
+	}
+	
+	return 0;
+}
+
+static int cmd_bank_stats(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+	
+	const struct patch_bank *bank = patch_store_get_bank();
+	const struct patch_store_timing *t = patch_store_get_timing();
+	int cached = 0;
+	
+	for (int i = 0; i < PATCH_BANK_CACHE_SLOTS; i++) {
+		cached += bank->cache[i].valid;
+	}
+	
+	shell_print(sh, "Programs stored: %d", patch_bank_count(bank));
+	shell_print(sh, "Cache: %d/%d slots", cached, PATCH_BANK_CACHE_SLOTS);
+	shell_print(sh, "Hits: %u  Misses: %u  Prefetches: %u  Evictions: %u  Errors: %u",
+		    bank->stats.hits, bank->stats.misses, bank->stats.prefetches,
+		    bank->stats.evictions, bank->stats.errors);
+	shell_print(sh, "Switch time: last %u us, max %u us, max from flash %u us",
+		    t->last_us, t->max_us, t->max_miss_us);
 	return 0;
 }
 
@@ -1521,13 +2597,35 @@ static int cmd_config_import(const struct shell *sh, size_t argc, char **argv)
  * Shell command registration
  */
 
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_bank,
+	SHELL_CMD_ARG(store, NULL, "Store a config patch as a program <program> [patch]", cmd_bank_store, 2, 1),
+	SHELL_CMD_ARG(load, NULL, "Switch to a program <0-127> (like Program Change)", cmd_bank_load, 2, 0),
+	SHELL_CMD_ARG(delete, NULL, "Delete a program <0-127>", cmd_bank_delete, 2, 0),
+	SHELL_CMD(list, NULL, "List stored programs", cmd_bank_list),
+	SHELL_CMD(stats, NULL, "Show cache and switch time statistics", cmd_bank_stats),
+	SHELL_SUBCMD_SET_END
+);
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_config_bin,
+	SHELL_CMD(dump, NULL, "Dump config as base64 chunks", cmd_config_bin_dump),
+	SHELL_CMD_ARG(begin, NULL, "Start/resume import <version> <size> <sha256>", cmd_config_bin_begin, 4, 0),
+	SHELL_CMD_ARG(put, NULL, "Import chunk <offset> <base64> <crc32>", cmd_config_bin_put, 4, 0),
+	SHELL_CMD(status, NULL, "Show next missing chunk offset", cmd_config_bin_status),
+	SHELL_CMD(commit, NULL, "Check SHA-256, validate, save and apply", cmd_config_bin_commit),
+	SHELL_CMD(abort, NULL, "Discard the import", cmd_config_bin_abort),
+	SHELL_SUBCMD_SET_END
+);
+
 SHELL_STATIC_SUBCMD_SET_CREATE(sub_config,
 	SHELL_CMD(show, NULL, "Show current configuration", cmd_config_show),
 	SHELL_CMD(save, NULL, "Save configuration to flash", cmd_config_save),
 	SHELL_CMD(restore, NULL, "Restore factory defaults", cmd_config_restore),
 	SHELL_CMD(reload, NULL, "Reload configuration from storage", cmd_config_reload),
-	SHELL_CMD_ARG(patch, NULL, "Show specific patch <0-15>", cmd_config_patch, 2, 0),
-	SHELL_CMD_ARG(select, NULL, "Select active patch <0-15>", cmd_config_select_patch, 2, 0),
+	SHELL_CMD(begin, NULL, "Start an edit session (stage changes in RAM)", cmd_config_begin),
+	SHELL_CMD(commit, NULL, "Validate, save and apply staged changes", cmd_config_commit),
+	SHELL_CMD(abort, NULL, "Discard staged changes", cmd_config_abort),
+	SHELL_CMD_ARG(patch, NULL, "Show specific patch <0-3>", cmd_config_patch, 2, 0),
+	SHELL_CMD_ARG(select, NULL, "Select active patch <0-3>", cmd_config_select_patch, 2, 0),
 	SHELL_CMD(list, NULL, "List patches", cmd_config_list_patches),
 	SHELL_CMD_ARG(midi_ch, NULL, "Set MIDI channel <1-16>", cmd_config_midi_ch, 2, 0),
 	SHELL_CMD_ARG(accel_deadzone, NULL, "Set CC change threshold <0-127>", cmd_config_accel_deadzone, 2, 0),
@@ -1536,6 +2634,8 @@ SHELL_STATIC_SUBCMD_SET_CREATE(sub_config,
 	SHELL_CMD_ARG(avg_depth, NULL, "Set average depth <3-10> samples", cmd_config_avg_depth, 2, 0),
 	SHELL_CMD_ARG(export, NULL, "Export config [global | patch <0-3>]", cmd_config_export, 1, 2),
 	SHELL_CMD(import, NULL, "Import config from JSON", cmd_config_import),
+	SHELL_CMD(bin, &sub_config_bin, "Binary chunked import/export", NULL),
+	SHELL_CMD(schema, NULL, "Print the config layout (for config_tool.py)", cmd_config_schema),
 	SHELL_CMD(erase_all, NULL, "Erase all config (testing only)", cmd_config_erase_all),
 	SHELL_SUBCMD_SET_END
 );
@@ -1548,6 +2648,51 @@ SHELL_STATIC_SUBCMD_SET_CREATE(sub_midi,
 	SHELL_SUBCMD_SET_END
 );
 
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_latency,
+	SHELL_CMD(show, NULL, "Show motion-to-MIDI latency histograms", cmd_latency_show),
+	SHELL_CMD(reset, NULL, "Reset latency statistics", cmd_latency_reset),
+	SHELL_CMD(dump, NULL, "Hex dump of binary latency histograms", cmd_latency_dump),
+	SHELL_SUBCMD_SET_END
+);
+
+#ifdef CONFIG_GUITARACC_TRACE
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_trace,
+	SHELL_CMD_ARG(show, NULL, "Show recent trace events [count]", cmd_trace_show, 1, 1),
+	SHELL_CMD(sites, NULL, "Show trace sites, sampling and counters", cmd_trace_sites),
+	SHELL_CMD_ARG(set, NULL, "Set sampling <site|all> <1-in-N, 0=off> <max/s, 0=unlimited>", cmd_trace_set, 4, 0),
+	SHELL_CMD(clear, NULL, "Clear trace buffer and counters", cmd_trace_clear),
+	SHELL_CMD(dump, NULL, "Hex dump of binary trace events", cmd_trace_dump),
+	SHELL_SUBCMD_SET_END
+);
+#endif
+
+#ifdef CONFIG_GUITARACC_CAPTURE
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_capture,
+	SHELL_CMD_ARG(start, NULL, "Start recording accel samples [keep = append to held records]", cmd_capture_start, 1, 1),
+	SHELL_CMD(stop, NULL, "Stop recording and freeze the ring", cmd_capture_stop),
+	SHELL_CMD(status, NULL, "Show capture state and span", cmd_capture_status),
+	SHELL_CMD(dump, NULL, "Hex dump of capture file (header + records)", cmd_capture_dump),
+	SHELL_SUBCMD_SET_END
+);
+#endif
+
+#ifdef CONFIG_GUITARACC_TELEMETRY
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_telemetry,
+	SHELL_CMD_ARG(start, NULL, "Stream binary records <mask 0x01-0x1F> <rate 1-100 Hz>", cmd_telemetry_start, 3, 0),
+	SHELL_CMD(stop, NULL, "Stop telemetry stream", cmd_telemetry_stop),
+	SHELL_CMD(status, NULL, "Show telemetry stream counters", cmd_telemetry_status),
+	SHELL_SUBCMD_SET_END
+);
+#endif
+
+#ifdef CONFIG_GUITARACC_PERF
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_perf,
+	SHELL_CMD(show, NULL, "Show per-stage pipeline timing", cmd_perf_show),
+	SHELL_CMD(reset, NULL, "Reset pipeline timing statistics", cmd_perf_reset),
+	SHELL_SUBCMD_SET_END
+);
+#endif
+
 SHELL_STATIC_SUBCMD_SET_CREATE(sub_topo,
 	SHELL_CMD(show, NULL, "Show topology configuration", cmd_topo_show),
 	/* SHELL_CMD_ARG(enable, NULL, "Enable virtual ports <0|1>", cmd_topo_enable, 2, 0), */ /* Legacy - topology always active */
@@ -1562,6 +2707,13 @@ SHELL_STATIC_SUBCMD_SET_CREATE(sub_func,
 	SHELL_SUBCMD_SET_END
 );
 
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_gesture,
+	SHELL_CMD(show, NULL, "Show gesture slots of the active patch", cmd_gesture_show),
+	SHELL_CMD_ARG(set, NULL, "Set gesture <slot> <type> <source> <action> <number> <threshold> [curve]", cmd_gesture_set, 7, 1),
+	SHELL_CMD_ARG(clear, NULL, "Clear gesture slot <slot>", cmd_gesture_clear, 2, 0),
+	SHELL_SUBCMD_SET_END
+);
+
 SHELL_STATIC_SUBCMD_SET_CREATE(sub_vport,
 	SHELL_CMD_ARG(show, NULL, "Show virtual port value <instance> [vport_offset]", cmd_vport_show, 2, 1),
 	SHELL_SUBCMD_SET_END
@@ -1569,10 +2721,26 @@ SHELL_STATIC_SUBCMD_SET_CREATE(sub_vport,
 
 SHELL_CMD_REGISTER(config, &sub_config, "Configuration commands", NULL);
 SHELL_CMD_REGISTER(midi, &sub_midi, "MIDI commands", NULL);
+SHELL_CMD_REGISTER(latency, &sub_latency, "Motion-to-MIDI latency commands", NULL);
+#ifdef CONFIG_GUITARACC_TRACE
+SHELL_CMD_REGISTER(trace, &sub_trace, "Hot-path trace commands", NULL);
+#endif
+#ifdef CONFIG_GUITARACC_TELEMETRY
+SHELL_CMD_REGISTER(telemetry, &sub_telemetry, "Binary telemetry stream commands", NULL);
+#endif
+#ifdef CONFIG_GUITARACC_CAPTURE
+SHELL_CMD_REGISTER(capture, &sub_capture, "Motion capture record/dump commands", NULL);
+#endif
+#ifdef CONFIG_GUITARACC_PERF
+SHELL_CMD_REGISTER(perf, &sub_perf, "Pipeline profiling commands", NULL);
+#endif
 SHELL_CMD_REGISTER(topo, &sub_topo, "Topology commands", NULL);
 SHELL_CMD_REGISTER(func, &sub_func, "Function unit commands", NULL);
 SHELL_CMD_REGISTER(vport, &sub_vport, "Virtual port debug commands", NULL);
+SHELL_CMD_REGISTER(gesture, &sub_gesture, "Gesture note/trigger commands", NULL);
+SHELL_CMD_REGISTER(bank, &sub_bank, "Patch bank (Program Change) commands", NULL);
 SHELL_CMD_REGISTER(status, NULL, "Show system status", cmd_status);
+SHELL_CMD_REGISTER(boot, NULL, "Show boot phase timing", cmd_boot);
 
 /*
  * Public API
@@ -0,0 +1,351 @@
+#!/usr/bin/env python3
+"""
+Telemetry Stream Tool for GuitarAcc Basestation
+
+Starts the binary telemetry stream on the UI UART, decodes the COBS-framed
+records, and writes them to CSV and/or plots them live. Can also decode a
+raw capture file recorded earlier with --raw.
+
+Frame layout (after COBS decoding, little-endian):
+    version(1) mask(1) seq(2) timestamp_ms(4) [sections...] crc16(2)
+
+Sections, in mask bit order:
+    0x01  raw accel       3 x int16
+    0x02  calibrated      6 x int16 (topology source values)
+    0x04  virtual ports  18 x int16
+    0x08  MIDI outputs    6 x uint8
+    0x10  queue           tx depth(1) rt depth(1) dropped(2)
+"""
+
+import argparse
+import csv
+import struct
+import sys
+import time
+
+TELEMETRY_VERSION = 1
+
+F_RAW_ACCEL = 0x01
+F_CALIBRATED = 0x02
+F_VPORTS = 0x04
+F_MIDI_OUT = 0x08
+F_QUEUE = 0x10
+F_ALL = 0x1F
+
+NUM_RAW = 3
+NUM_SOURCES = 6
+NUM_VPORTS = 18
+NUM_MIDI = 6
+
+
+def crc16_ccitt(data):
+    """CRC-16/CCITT-FALSE, matching telemetry_crc16() in firmware."""
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def cobs_decode(data):
+    """Decode one COBS block (delimiter stripped). Returns None if malformed."""
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        i += 1
+        if code == 0 or i + code - 1 > len(data):
+            return None
+        block = data[i:i + code - 1]
+        if 0 in block:
+            return None
+        out += block
+        i += code - 1
+        if code < 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def parse_payload(payload):
+    """Parse a decoded payload into a dict, or None if invalid."""
+    if len(payload) < 10:
+        return None
+    body, crc = payload[:-2], struct.unpack('<H', payload[-2:])[0]
+    if crc16_ccitt(body) != crc:
+        return None
+
+    version, mask, seq, ts = struct.unpack_from('<BBHI', body, 0)
+    if version != TELEMETRY_VERSION:
+        return None
+
+    rec = {'seq': seq, 'timestamp_ms': ts, 'mask': mask}
+    off = 8
+    try:
+        if mask & F_RAW_ACCEL:
+            rec['raw'] = list(struct.unpack_from(f'<{NUM_RAW}h', body, off))
+            off += 2 * NUM_RAW
+        if mask & F_CALIBRATED:
+            rec['cal'] = list(struct.unpack_from(f'<{NUM_SOURCES}h', body, off))
+            off += 2 * NUM_SOURCES
+        if mask & F_VPORTS:
+            rec['vp'] = list(struct.unpack_from(f'<{NUM_VPORTS}h', body, off))
+            off += 2 * NUM_VPORTS
+        if mask & F_MIDI_OUT:
+            rec['midi'] = list(body[off:off + NUM_MIDI])
+            off += NUM_MIDI
+        if mask & F_QUEUE:
+            tx, rt, dropped = struct.unpack_from('<BBH', body, off)
+            rec['tx_depth'], rec['rt_depth'], rec['dropped'] = tx, rt, dropped
+            off += 4
+    except struct.error:
+        return None
+
+    return rec if off == len(body) else None
+
+
+class FrameDecoder:
+    """Split a byte stream on 0x00 delimiters and decode telemetry frames.
+
+    Shell text interleaved with the stream never contains 0x00, so it ends
+    up glued to the next frame and is rejected by the CRC check.
+    """
+
+    def __init__(self):
+        self.buf = bytearray()
+        self.good = 0
+        self.bad = 0
+        self.lost = 0
+        self.last_seq = None
+
+    def feed(self, data):
+        records = []
+        self.buf += data
+        while True:
+            idx = self.buf.find(0)
+            if idx < 0:
+                break
+            frame = bytes(self.buf[:idx])
+            del self.buf[:idx + 1]
+            if not frame:
+                continue
+            payload = cobs_decode(frame)
+            rec = parse_payload(payload) if payload else None
+            if rec is None:
+                self.bad += 1
+                continue
+            if self.last_seq is not None:
+                self.lost += (rec['seq'] - self.last_seq - 1) & 0xFFFF
+            self.last_seq = rec['seq']
+            self.good += 1
+            records.append(rec)
+        return records
+
+
+def csv_header(mask):
+    cols = ['seq', 'timestamp_ms']
+    if mask & F_RAW_ACCEL:
+        cols += ['raw_x', 'raw_y', 'raw_z']
+    if mask & F_CALIBRATED:
+        cols += [f'cal_{i}' for i in range(NUM_SOURCES)]
+    if mask & F_VPORTS:
+        cols += [f'vp_{i}' for i in range(NUM_VPORTS)]
+    if mask & F_MIDI_OUT:
+        cols += [f'midi_{i}' for i in range(NUM_MIDI)]
+    if mask & F_QUEUE:
+        cols += ['tx_depth', 'rt_depth', 'dropped']
+    return cols
+
+
+def csv_row(rec):
+    row = [rec['seq'], rec['timestamp_ms']]
+    for key in ('raw', 'cal', 'vp', 'midi'):
+        row += rec.get(key, [])
+    if 'tx_depth' in rec:
+        row += [rec['tx_depth'], rec['rt_depth'], rec['dropped']]
+    return row
+
+
+class LivePlot:
+    """Rolling plot of raw accel and MIDI outputs (requires matplotlib)."""
+
+    def __init__(self, window=200):
+        import matplotlib.pyplot as plt
+        self.plt = plt
+        self.window = window
+        self.t = []
+        self.series = {}
+        plt.ion()
+        self.fig, (self.ax_accel, self.ax_midi) = plt.subplots(2, 1, sharex=True)
+        self.ax_accel.set_ylabel('milli-g')
+        self.ax_midi.set_ylabel('CC value')
+        self.ax_midi.set_xlabel('time (s)')
+        self.ax_midi.set_ylim(-5, 132)
+        self.lines = {}
+
+    def _line(self, ax, name):
+        if name not in self.lines:
+            (self.lines[name],) = ax.plot([], [], label=name)
+            ax.legend(loc='upper left', fontsize='small')
+            self.series[name] = []
+        return self.lines[name]
+
+    def add(self, rec):
+        self.t.append(rec['timestamp_ms'] / 1000.0)
+        for i, v in enumerate(rec.get('raw', [])):
+            self._line(self.ax_accel, 'xyz'[i])
+            self.series['xyz'[i]].append(v)
+        for i, v in enumerate(rec.get('midi', [])):
+            self._line(self.ax_midi, f'out{i}')
+            self.series[f'out{i}'].append(v)
+        self.t = self.t[-self.window:]
+        for name in self.series:
+            self.series[name] = self.series[name][-self.window:]
+
+    def draw(self):
+        for name, line in self.lines.items():
+            ys = self.series[name]
+            line.set_data(self.t[-len(ys):], ys)
+        for ax in (self.ax_accel, self.ax_midi):
+            ax.relim()
+            ax.autoscale_view(scaley=(ax is self.ax_accel))
+        self.plt.pause(0.001)
+
+
+def stream(args):
+    import serial
+    from select_port import select_port
+
+    port = args.port or select_port(auto_select=True)
+    if port is None:
+        print("No port selected. Exiting.", file=sys.stderr)
+        return False
+
+    ser = serial.Serial(port, 115200, timeout=0.1, rtscts=True)
+    print(f"Connected to {port}")
+    time.sleep(0.5)
+    ser.reset_input_buffer()
+    ser.write(f"telemetry start 0x{args.mask:02X} {args.rate}\r\n".encode())
+    ser.flush()
+
+    decoder = FrameDecoder()
+    raw_out = open(args.raw, 'wb') if args.raw else None
+    csv_file = open(args.csv, 'w', newline='') if args.csv else None
+    writer = csv.writer(csv_file) if csv_file else None
+    if writer:
+        writer.writerow(csv_header(args.mask))
+    plot = LivePlot() if args.plot else None
+
+    start = time.time()
+    last_report = start
+    try:
+        while args.duration <= 0 or time.time() - start < args.duration:
+            data = ser.read(512)
+            if not data:
+                continue
+            if raw_out:
+                raw_out.write(data)
+            for rec in decoder.feed(data):
+                if writer:
+                    writer.writerow(csv_row(rec))
+                if plot:
+                    plot.add(rec)
+                if not writer and not plot:
+                    print(rec)
+            if plot:
+                plot.draw()
+            if time.time() - last_report >= 1.0:
+                last_report = time.time()
+                print(f"frames={decoder.good} bad={decoder.bad} lost={decoder.lost}",
+                      file=sys.stderr)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        ser.write(b"telemetry stop\r\n")
+        ser.flush()
+        ser.close()
+        if raw_out:
+            raw_out.close()
+        if csv_file:
+            csv_file.close()
+
+    print(f"\nDecoded {decoder.good} frames ({decoder.bad} rejected, {decoder.lost} lost)")
+    return True
+
+
+def decode_file(args):
+    decoder = FrameDecoder()
+    with open(args.input, 'rb') as f:
+        records = decoder.feed(f.read())
+
+    if args.csv:
+        mask = records[0]['mask'] if records else F_ALL
+        with open(args.csv, 'w', newline='') as f:
+            writer = csv.writer(f)
+            writer.writerow(csv_header(mask))
+            for rec in records:
+                writer.writerow(csv_row(rec))
+    else:
+        for rec in records:
+            print(rec)
+
+    print(f"Decoded {decoder.good} frames ({decoder.bad} rejected, {decoder.lost} lost)",
+          file=sys.stderr)
+    return True
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='GuitarAcc Basestation Telemetry Tool',
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+        epilog="""
+Examples:
+  # Stream everything at 50 Hz and plot live
+  %(prog)s stream -p /dev/ttyUSB0 --plot
+
+  # Stream MIDI outputs and queue depth to CSV for 30 s
+  %(prog)s stream -p /dev/ttyUSB0 -m 0x18 -r 20 --csv run.csv -d 30
+
+  # Save the raw byte stream, decode it later
+  %(prog)s stream -p /dev/ttyUSB0 --raw capture.bin
+  %(prog)s decode -i capture.bin --csv capture.csv
+"""
+    )
+
+    subparsers = parser.add_subparsers(dest='command', help='Command to execute')
+
+    stream_parser = subparsers.add_parser('stream', help='Start stream on device and decode')
+    stream_parser.add_argument('-p', '--port', help='Serial port (or use auto-select)')
+    stream_parser.add_argument('-m', '--mask', type=lambda s: int(s, 0), default=F_ALL,
+                               help='Field mask (default 0x1F = all)')
+    stream_parser.add_argument('-r', '--rate', type=int, default=50,
+                               help='Records per second (1-100)')
+    stream_parser.add_argument('-d', '--duration', type=float, default=0,
+                               help='Seconds to record (default: until Ctrl-C)')
+    stream_parser.add_argument('--csv', help='Write decoded records to CSV')
+    stream_parser.add_argument('--raw', help='Save raw byte stream to file')
+    stream_parser.add_argument('--plot', action='store_true', help='Live plot (matplotlib)')
+
+    decode_parser = subparsers.add_parser('decode', help='Decode a raw capture file')
+    decode_parser.add_argument('-i', '--input', required=True, help='Raw capture file')
+    decode_parser.add_argument('--csv', help='Write decoded records to CSV')
+
+    args = parser.parse_args()
+
+    if args.command == 'stream':
+        if not (0 < args.mask <= F_ALL) or not (1 <= args.rate <= 100):
+            print("Error: mask must be 0x01-0x1F and rate 1-100", file=sys.stderr)
+            sys.exit(1)
+        if not stream(args):
+            sys.exit(1)
+    elif args.command == 'decode':
+        if not decode_file(args):
+            sys.exit(1)
+    else:
+        parser.print_help()
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,436 @@
+/*
+ * Config Storage Benchmark and Torture Test
+ *
+ * Runs the production area format (config_area.c, config_journal.c) on the
+ * flash simulator with nRF5340 timing and reports, per storage scheme and
+ * save workload:
+ * - modeled save latency (erase + write time): mean, p50, p99, max
+ * - page erases per 1000 saves and the erase count of each area
+ * - saves until the busier area reaches the rated 10,000 erase cycles
+ *
+ * Schemes:
+ * - pingpong: every save writes a full image to the other area (the
+ *   format before the journal)
+ * - journal: changes are appended, full image only when the journal is full
+ *
+ * Workloads (IMAGE_SIZE bytes, the size of config_data on the target):
+ * - setter: one 2-byte field per save, like the shell setters
+ * - patch: a 40-byte run inside one patch, like a topology edit
+ * - import: every byte changes, like 'config bin' restore
+ * - mixed: 90% setter, 9% patch, 1% import
+ *
+ * The stall pass repeats the mixed workload with whole-page and partial
+ * (sliced) erases and reports the longest single CPU stall, which is what
+ * BLE and MIDI threads wait for while the writer thread commits.
+ *
+ * The torture pass then cuts power at a random unit of random saves
+ * (optionally with random stored bit flips) and checks that every boot
+ * finds the last completed save or the interrupted one, never anything
+ * else. Any failure makes the exit status non-zero.
+ *
+ * Usage: bench_config_storage [--json out.json] [--quick] [--seed N]
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "../src/flash_sim.h"
+#include "../src/config_area.h"
+#include "../src/config_journal.h"
+
+/* ============================================================
+ * CONSTANTS
+ * ============================================================ */
+
+#define BASE              0x000FC000
+#define FLASH_SIZE        (2 * FLASH_SIM_PAGE_SIZE)
+#define IMAGE_SIZE        1104      /* sizeof(struct config_data) on the target */
+#define PATCH_OFFSET      64        /* First patch in config_data */
+#define PATCH_SIZE        249
+#define RATED_CYCLES      10000     /* nRF5340 flash endurance */
+#define BENCH_SAVES       20000
+#define QUICK_SAVES       2000
+#define TORTURE_RUNS      5000
+#define QUICK_TORTURE     500
+#define ERASE_SLICE_US    3000      /* CONFIG_SOC_FLASH_NRF_PARTIAL_ERASE_MS */
+
+enum workload { WL_SETTER, WL_PATCH, WL_IMPORT, WL_MIXED, WL_COUNT };
+enum scheme { SCHEME_PINGPONG, SCHEME_JOURNAL, SCHEME_COUNT };
+
+static const char *const workload_names[WL_COUNT] = { "setter", "patch", "import", "mixed" };
+static const char *const scheme_names[SCHEME_COUNT] = { "pingpong", "journal" };
+
+/* ============================================================
+ * FIXTURE
+ * ============================================================ */
+
+static uint8_t flash_mem[FLASH_SIZE];
+static uint32_t erase_counts[FLASH_SIZE / FLASH_SIM_PAGE_SIZE];
+static uint8_t scratch[FLASH_SIM_PAGE_SIZE];
+static struct flash_sim sim;
+static struct config_area_store store;
+
+/* Deterministic so runs are comparable between commits */
+static uint32_t rng_state = 0x12345678u;
+
+static uint32_t rnd(uint32_t n)
+{
+	rng_state = rng_state * 1664525u + 1013904223u;
+	return (rng_state >> 8) % n;
+}
+
+/* Stand-in for SHA-256 (timing is modeled, not measured) */
+static int bench_hash(const void *data, size_t len, uint8_t hash[CONFIG_HASH_SIZE])
+{
+	uint32_t crc = config_journal_crc32(data, len);
+
+	memset(hash, 0, CONFIG_HASH_SIZE);
+	memcpy(hash, &crc, sizeof(crc));
+	return 0;
+}
+
+static void open_store(void)
+{
+	config_area_init(&store, flash_sim_backend(&sim), BASE, BASE + FLASH_SIM_PAGE_SIZE,
+			 FLASH_SIM_PAGE_SIZE, IMAGE_SIZE, 1, bench_hash, scratch, sizeof(scratch));
+}
+
+static void fresh_flash(uint8_t *image)
+{
+	flash_sim_init(&sim, flash_mem, erase_counts, BASE, FLASH_SIZE);
+	open_store();
+	for (size_t i = 0; i < IMAGE_SIZE; i++) {
+		image[i] = (uint8_t)(i * 31);
+	}
+	config_area_compact(&store, image);
+	flash_sim_reset_stats(&sim);
+}
+
+/* What config_storage_init() does, with the hash checked right away */
+static bool boot(uint8_t *image)
+{
+	struct config_header headers[CONFIG_AREA_COUNT];
+	bool valid[CONFIG_AREA_COUNT];
+	uint8_t order[CONFIG_AREA_COUNT];
+
+	open_store();
+	for (uint8_t a = 0; a < CONFIG_AREA_COUNT; a++) {
+		valid[a] = config_area_read_header(&store, a, &headers[a]) == 0;
+	}
+
+	int n = config_area_select(headers, valid, order);
+	for (int i = 0; i < n; i++) {
+		if (config_area_load(&store, order[i], &headers[order[i]], image, true) >= 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static void mutate(uint8_t *image, enum workload wl)
+{
+	if (wl == WL_MIXED) {
+		uint32_t r = rnd(100);
+		wl = (r < 90) ? WL_SETTER : (r < 99) ? WL_PATCH : WL_IMPORT;
+	}
+
+	switch (wl) {
+	case WL_SETTER: {
+		uint32_t field = rnd(IMAGE_SIZE / 2);
+		image[field * 2]++;
+		image[field * 2 + 1] ^= 0x01;
+		break;
+	}
+	case WL_PATCH: {
+		uint32_t start = PATCH_OFFSET + rnd(4) * PATCH_SIZE + rnd(PATCH_SIZE - 40);
+		for (uint32_t i = start; i < start + 40; i++) {
+			image[i] += 3;
+		}
+		break;
+	}
+	default:
+		for (size_t i = 0; i < IMAGE_SIZE; i++) {
+			image[i] += 1;
+		}
+		break;
+	}
+}
+
+static int save(const uint8_t *old_image, const uint8_t *new_image, enum scheme scheme)
+{
+	if (scheme == SCHEME_PINGPONG) {
+		config_area_force_compact(&store);
+	}
+	return config_area_save(&store, old_image, new_image);
+}
+
+/* ============================================================
+ * LATENCY AND WEAR
+ * ============================================================ */
+
+struct bench_result {
+	double mean_us;
+	uint32_t p50_us;
+	uint32_t p99_us;
+	uint32_t max_us;
+	double erases_per_1000;
+	uint32_t erases[CONFIG_AREA_COUNT];
+	double lifetime_saves;
+	uint32_t max_stall_us;  /* Longest uninterruptible erase or write step */
+	int errors;
+};
+
+static int cmp_u32(const void *a, const void *b)
+{
+	uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+static void run_bench(enum scheme scheme, enum workload wl, int saves, uint32_t erase_slice_us,
+		      struct bench_result *r)
+{
+	static uint8_t current[IMAGE_SIZE], next[IMAGE_SIZE];
+	uint32_t *latency = calloc(saves, sizeof(*latency));
+	uint64_t total = 0;
+
+	memset(r, 0, sizeof(*r));
+	rng_state = 0x12345678u;
+	fresh_flash(current);
+	flash_sim_set_erase_slice(&sim, erase_slice_us);
+	uint32_t base_erases[CONFIG_AREA_COUNT] = { erase_counts[0], erase_counts[1] };
+
+	for (int i = 0; i < saves; i++) {
+		uint64_t before = sim.stats.busy_us;
+
+		memcpy(next, current, IMAGE_SIZE);
+		mutate(next, wl);
+		if (save(current, next, scheme) != 0) {
+			r->errors++;
+		}
+		memcpy(current, next, IMAGE_SIZE);
+		latency[i] = (uint32_t)(sim.stats.busy_us - before);
+		total += latency[i];
+	}
+
+	qsort(latency, saves, sizeof(*latency), cmp_u32);
+	r->mean_us = (double)total / saves;
+	r->p50_us = latency[saves / 2];
+	r->p99_us = latency[(saves * 99) / 100];
+	r->max_us = latency[saves - 1];
+	r->erases_per_1000 = 1000.0 * sim.stats.page_erases / saves;
+	uint32_t busiest = 0;
+	for (int a = 0; a < CONFIG_AREA_COUNT; a++) {
+		r->erases[a] = erase_counts[a] - base_erases[a];
+		if (r->erases[a] > busiest) {
+			busiest = r->erases[a];
+		}
+	}
+	r->lifetime_saves = busiest ? (double)RATED_CYCLES * saves / busiest : 0.0;
+	r->max_stall_us = sim.stats.max_stall_us;
+
+	uint8_t loaded[IMAGE_SIZE];
+	if (!boot(loaded) || memcmp(loaded, current, IMAGE_SIZE) != 0) {
+		r->errors++;
+	}
+	free(latency);
+}
+
+/* ============================================================
+ * TORTURE
+ * ============================================================ */
+
+struct torture_result {
+	int runs;
+	int old_state;         /* Boot found the last completed save */
+	int new_state;         /* Boot found the interrupted save */
+	int failures;          /* Neither, or no configuration at all */
+	int flip_runs;         /* Runs with a stored bit flipped before boot */
+	int flip_consistent;   /* ... where boot still found a state that was saved */
+	int flip_lost;         /* ... where no area was left (flip plus a cut compaction) */
+};
+
+static void run_torture(enum scheme scheme, int runs, bool flips, struct torture_result *t)
+{
+	static uint8_t current[IMAGE_SIZE], next[IMAGE_SIZE], loaded[IMAGE_SIZE];
+
+	memset(t, 0, sizeof(*t));
+	fresh_flash(current);
+
+	for (int i = 0; i < runs; i++) {
+		/* A few uninterrupted saves move the journal to a random fill level */
+		for (uint32_t k = rnd(20); k > 0; k--) {
+			memcpy(next, current, IMAGE_SIZE);
+			mutate(next, WL_MIXED);
+			if (save(current, next, scheme) == 0) {
+				memcpy(current, next, IMAGE_SIZE);
+			}
+		}
+
+		memcpy(next, current, IMAGE_SIZE);
+		mutate(next, WL_MIXED);
+		flash_sim_power_loss_after(&sim, (int32_t)rnd(400));
+		bool done = save(current, next, scheme) == 0;
+		flash_sim_power_loss_after(&sim, FLASH_SIM_NO_POWER_LOSS);
+		flash_sim_power_on(&sim);
+
+		bool flipped = flips && rnd(10) == 0;
+		if (flipped) {
+			flash_sim_flip_bit(&sim, BASE + rnd(FLASH_SIZE), (uint8_t)rnd(8));
+			t->flip_runs++;
+		}
+
+		t->runs++;
+		if (!boot(loaded)) {
+			/* Both areas lost: only acceptable if a bit flip did it */
+			t->failures += !flipped;
+			t->flip_lost += flipped;
+			fresh_flash(current);
+			continue;
+		}
+		if (memcmp(loaded, next, IMAGE_SIZE) == 0) {
+			t->new_state++;
+			t->flip_consistent += flipped;
+		} else if (memcmp(loaded, current, IMAGE_SIZE) == 0 && !done) {
+			t->old_state++;
+			t->flip_consistent += flipped;
+		} else if (flipped) {
+			/* Fell back to the older area: consistent, just not the latest */
+			t->flip_consistent++;
+		} else {
+			t->failures++;
+		}
+		memcpy(current, loaded, IMAGE_SIZE);
+		/* Continue from whatever boot found, as the device would */
+		if (flipped) {
+			config_area_compact(&store, current);
+		}
+	}
+}
+
+/* ============================================================
+ * OUTPUT
+ * ============================================================ */
+
+int main(int argc, char **argv)
+{
+	const char *json_path = NULL;
+	bool quick = false;
+
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "--json") && i + 1 < argc) {
+			json_path = argv[++i];
+		} else if (!strcmp(argv[i], "--quick")) {
+			quick = true;
+		} else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+			rng_state = (uint32_t)strtoul(argv[++i], NULL, 0);
+		} else {
+			fprintf(stderr, "Usage: %s [--json out.json] [--quick] [--seed N]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	int saves = quick ? QUICK_SAVES : BENCH_SAVES;
+	int runs = quick ? QUICK_TORTURE : TORTURE_RUNS;
+	uint32_t torture_seed = rng_state;
+	int failures = 0;
+	FILE *out = NULL;
+
+	if (json_path) {
+		out = fopen(json_path, "w");
+		if (!out) {
+			fprintf(stderr, "Cannot write %s\n", json_path);
+			return 2;
+		}
+		fprintf(out, "{\n  \"image_size\": %d,\n  \"saves\": %d,\n  \"results\": [", IMAGE_SIZE, saves);
+	}
+
+	fprintf(stderr, "%-9s %-7s %9s %7s %7s %7s %10s %13s %14s\n", "scheme", "load",
+		"mean_us", "p50_us", "p99_us", "max_us", "erase/1k", "erases A/B", "lifetime");
+	for (int s = 0; s < SCHEME_COUNT; s++) {
+		for (int w = 0; w < WL_COUNT; w++) {
+			struct bench_result r;
+
+			run_bench(s, w, saves, 0, &r);
+			failures += r.errors;
+			fprintf(stderr, "%-9s %-7s %9.0f %7u %7u %7u %10.1f %6u/%-6u %14.0f\n",
+				scheme_names[s], workload_names[w], r.mean_us, r.p50_us, r.p99_us,
+				r.max_us, r.erases_per_1000, r.erases[0], r.erases[1], r.lifetime_saves);
+			if (out) {
+				fprintf(out, "%s\n    {\"scheme\": \"%s\", \"workload\": \"%s\", "
+					"\"mean_us\": %.1f, \"p50_us\": %u, \"p99_us\": %u, \"max_us\": %u, "
+					"\"erases_per_1000\": %.2f, \"erases_a\": %u, \"erases_b\": %u, "
+					"\"lifetime_saves\": %.0f, \"errors\": %d}",
+					(s || w) ? "," : "", scheme_names[s], workload_names[w], r.mean_us,
+					r.p50_us, r.p99_us, r.max_us, r.erases_per_1000, r.erases[0],
+					r.erases[1], r.lifetime_saves, r.errors);
+			}
+		}
+	}
+
+	if (out) {
+		fprintf(out, "\n  ],\n  \"stall\": [");
+	}
+	fprintf(stderr, "\n%-9s %-7s %9s %12s\n", "scheme", "erase", "mean_us", "max_stall_us");
+	for (int s = 0; s < SCHEME_COUNT; s++) {
+		for (int sliced = 0; sliced < 2; sliced++) {
+			struct bench_result r;
+
+			run_bench(s, WL_MIXED, saves, sliced ? ERASE_SLICE_US : 0, &r);
+			failures += r.errors;
+			fprintf(stderr, "%-9s %-7s %9.0f %12u\n", scheme_names[s],
+				sliced ? "sliced" : "page", r.mean_us, r.max_stall_us);
+			if (out) {
+				fprintf(out, "%s\n    {\"scheme\": \"%s\", \"erase_slice_us\": %u, "
+					"\"mean_us\": %.1f, \"max_stall_us\": %u, \"errors\": %d}",
+					(s || sliced) ? "," : "", scheme_names[s],
+					sliced ? ERASE_SLICE_US : 0, r.mean_us, r.max_stall_us, r.errors);
+			}
+		}
+	}
+
+	if (out) {
+		fprintf(out, "\n  ],\n  \"torture\": [");
+	}
+	fprintf(stderr, "\n%-9s %-6s %6s %6s %6s %8s %6s %10s %5s\n", "scheme", "flips", "runs",
+		"old", "new", "failures", "flips", "consistent", "lost");
+	for (int s = 0; s < SCHEME_COUNT; s++) {
+		for (int f = 0; f < 2; f++) {
+			struct torture_result t;
+
+			rng_state = torture_seed + (uint32_t)(s * 2 + f);
+			run_torture(s, runs, f, &t);
+			failures += t.failures;
+			fprintf(stderr, "%-9s %-6s %6d %6d %6d %8d %6d %10d %5d\n", scheme_names[s],
+				f ? "yes" : "no", t.runs, t.old_state, t.new_state, t.failures,
+				t.flip_runs, t.flip_consistent, t.flip_lost);
+			if (out) {
+				fprintf(out, "%s\n    {\"scheme\": \"%s\", \"bit_flips\": %s, \"runs\": %d, "
+					"\"old_state\": %d, \"new_state\": %d, \"failures\": %d, "
+					"\"flip_runs\": %d, \"flip_consistent\": %d, \"flip_lost\": %d}",
+					(s || f) ? "," : "", scheme_names[s], f ? "true" : "false", t.runs,
+					t.old_state, t.new_state, t.failures, t.flip_runs, t.flip_consistent,
+					t.flip_lost);
+			}
+		}
+	}
+
+	if (out) {
+		fprintf(out, "\n  ]\n}\n");
+		fclose(out);
+		fprintf(stderr, "Results written to %s\n", json_path);
+	}
+
+	if (failures) {
+		fprintf(stderr, "FAILED: %d inconsistent boots or save errors\n", failures);
+		return 1;
+	}
+	return 0;
+}
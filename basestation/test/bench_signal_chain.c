@@ -0,0 +1,941 @@
+/*
+ * Signal Chain Benchmark
+ *
+ * Drives the production topology processor, function units, virtual ports,
+ * accel mapping and MIDI message construction with motion traces across
+ * several patch shapes, and reports ns/sample, samples/sec and MIDI bytes
+ * per sample as JSON.
+ *
+ * The per-sample work is midi_pipeline_process(), the same call
+ * process_accel_data() makes in main.c: set inputs, execute topology,
+ * apply the CC deadzone and build a 3-byte CC message for every output
+ * that changed. The TX backend only counts bytes.
+ *
+ * The accel-only tilt stage (derived_sources_tilt(): gravity low-pass and
+ * CORDIC atan2) is timed separately against the same filter in float
+ * with atan2f(), and both are checked against a double reference.
+ *
+ * derived_sources_update() is timed with no derived source read, with
+ * every one read, and with each group alone, so the cost of an unused
+ * source can be checked to be nothing.
+ *
+ * gesture_engine_process() is timed per gesture type on the derived
+ * sources, and with all slots in use: the per-sample bound.
+ *
+ * Topology execution alone is timed per patch shape two ways: the
+ * compiled runtime topo_proc_execute() runs, and an interpreter over the
+ * packed flash structs as the processor ran before the runtime existed.
+ * Every sample's outputs and virtual ports are compared; a mismatch
+ * fails the run.
+ *
+ * Usage: bench_signal_chain [--trace file.csv] [--json out.json] [--quick]
+ *
+ * A recorded trace is a CSV with x,y,z milli-g columns. A header row is
+ * optional; telemetry_tool.py CSVs are accepted (raw_x, raw_y, raw_z).
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#define _POSIX_C_SOURCE 199309L  /* clock_gettime() */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "../src/topology_processor.h"
+#include "../src/topology_runtime.h"
+#include "../src/midi_pipeline.h"
+#include "../src/midi_logic.h"
+#include "../src/derived_sources.h"
+#include "../src/gesture_engine.h"
+
+#ifndef BENCH_OPT_LEVEL
+#define BENCH_OPT_LEVEL "unknown"
+#endif
+
+/* ============================================================
+ * CONSTANTS
+ * ============================================================ */
+
+#define TRACE_SAMPLE_HZ     100     /* Synthetic traces: 100 Hz sensor rate */
+#define TRACE_SECONDS       20
+#define SYNTH_SAMPLES       (TRACE_SAMPLE_HZ * TRACE_SECONDS)
+#define MAX_TRACE_SAMPLES   100000
+#define MAX_TRACES          8
+#define BENCH_REPEATS       5       /* Best of N runs is reported */
+#define MIN_RUN_SAMPLES     200000  /* Samples per run (trace is looped) */
+#define QUICK_RUN_SAMPLES   20000
+#define MIDI_DEADZONE       1       /* Patch default: send on any change */
+
+#define PI_F 3.14159265f
+
+/* ============================================================
+ * TRACES
+ * ============================================================ */
+
+struct motion_trace {
+	const char *name;
+	int16_t (*xyz)[3];
+	size_t count;
+};
+
+static struct motion_trace traces[MAX_TRACES];
+static int trace_count;
+
+/* Deterministic noise so runs are comparable between commits */
+static uint32_t rng_state = 0x12345678u;
+
+static int16_t noise(int16_t amplitude)
+{
+	rng_state = rng_state * 1664525u + 1013904223u;
+	int32_t r = (int32_t)(rng_state >> 16) % (2 * amplitude + 1);
+	return (int16_t)(r - amplitude);
+}
+
+static int16_t clamp_mg(float v)
+{
+	if (v > 4000.0f) {
+		return 4000;
+	}
+	if (v < -4000.0f) {
+		return -4000;
+	}
+	return (int16_t)v;
+}
+
+static struct motion_trace *new_trace(const char *name, size_t count)
+{
+	if (trace_count >= MAX_TRACES) {
+		return NULL;
+	}
+
+	struct motion_trace *t = &traces[trace_count];
+	t->name = name;
+	t->count = count;
+	t->xyz = calloc(count, sizeof(*t->xyz));
+	if (!t->xyz) {
+		return NULL;
+	}
+
+	trace_count++;
+	return t;
+}
+
+/* Guitar at rest: gravity on Z plus sensor noise */
+static void synth_still(void)
+{
+	struct motion_trace *t = new_trace("still", SYNTH_SAMPLES);
+
+	for (size_t i = 0; t && i < t->count; i++) {
+		t->xyz[i][0] = noise(5);
+		t->xyz[i][1] = noise(5);
+		t->xyz[i][2] = (int16_t)(1000 + noise(5));
+	}
+}
+
+/* Slow neck tilt sweeping the full +-2 g range */
+static void synth_sweep(void)
+{
+	struct motion_trace *t = new_trace("sweep", SYNTH_SAMPLES);
+
+	for (size_t i = 0; t && i < t->count; i++) {
+		float phase = 2.0f * PI_F * (float)i / (float)(TRACE_SAMPLE_HZ * 4);
+		t->xyz[i][0] = clamp_mg(2000.0f * sinf(phase) + noise(10));
+		t->xyz[i][1] = clamp_mg(1000.0f * cosf(phase) + noise(10));
+		t->xyz[i][2] = clamp_mg(1000.0f * cosf(phase * 0.5f) + noise(10));
+	}
+}
+
+/* Strumming: decaying 6-8 Hz bursts twice a second over a gravity baseline */
+static void synth_strum(void)
+{
+	struct motion_trace *t = new_trace("strum", SYNTH_SAMPLES);
+
+	for (size_t i = 0; t && i < t->count; i++) {
+		float sec = (float)i / TRACE_SAMPLE_HZ;
+		float since = fmodf(sec, 0.5f);
+		float env = expf(-since * 6.0f);
+		t->xyz[i][0] = clamp_mg(1500.0f * env * sinf(2.0f * PI_F * 7.0f * sec) + noise(20));
+		t->xyz[i][1] = clamp_mg(600.0f * env * sinf(2.0f * PI_F * 6.0f * sec + 1.0f) + noise(20));
+		t->xyz[i][2] = clamp_mg(1000.0f + 300.0f * env * cosf(2.0f * PI_F * 8.0f * sec) + noise(20));
+	}
+}
+
+/* Full-range random input: every output changes every sample (worst case) */
+static void synth_noise(void)
+{
+	struct motion_trace *t = new_trace("noise", SYNTH_SAMPLES);
+
+	for (size_t i = 0; t && i < t->count; i++) {
+		t->xyz[i][0] = noise(2000);
+		t->xyz[i][1] = noise(2000);
+		t->xyz[i][2] = noise(2000);
+	}
+}
+
+/**
+ * Load a recorded trace (x,y,z per line; optional header row)
+ */
+static int load_trace(const char *path)
+{
+	FILE *f = fopen(path, "r");
+	if (!f) {
+		fprintf(stderr, "Cannot open trace %s\n", path);
+		return -1;
+	}
+
+	static int16_t buf[MAX_TRACE_SAMPLES][3];
+	char line[1024];
+	int col[3] = {0, 1, 2};
+	size_t n = 0;
+	bool first = true;
+
+	while (fgets(line, sizeof(line), f) && n < MAX_TRACE_SAMPLES) {
+		char *fields[128];
+		int nf = 0;
+
+		for (char *tok = strtok(line, ",\r\n"); tok && nf < 128; tok = strtok(NULL, ",\r\n")) {
+			fields[nf++] = tok;
+		}
+
+		if (first) {
+			first = false;
+			/* Header row: locate raw_x/raw_y/raw_z or x/y/z columns */
+			if (nf > 0 && (fields[0][0] < '0' || fields[0][0] > '9') && fields[0][0] != '-') {
+				for (int i = 0; i < nf; i++) {
+					if (!strcmp(fields[i], "raw_x") || !strcmp(fields[i], "x")) col[0] = i;
+					if (!strcmp(fields[i], "raw_y") || !strcmp(fields[i], "y")) col[1] = i;
+					if (!strcmp(fields[i], "raw_z") || !strcmp(fields[i], "z")) col[2] = i;
+				}
+				continue;
+			}
+		}
+
+		if (nf <= col[0] || nf <= col[1] || nf <= col[2]) {
+			continue;
+		}
+		for (int a = 0; a < 3; a++) {
+			buf[n][a] = (int16_t)strtol(fields[col[a]], NULL, 10);
+		}
+		n++;
+	}
+	fclose(f);
+
+	if (n == 0) {
+		fprintf(stderr, "No samples in trace %s\n", path);
+		return -1;
+	}
+
+	struct motion_trace *t = new_trace("recorded", n);
+	if (!t) {
+		return -1;
+	}
+	memcpy(t->xyz, buf, n * sizeof(*t->xyz));
+
+	return 0;
+}
+
+/* ============================================================
+ * PATCH SHAPES
+ * ============================================================ */
+
+struct patch_shape {
+	const char *name;
+	struct patch_topology_config topo;
+	struct function_unit funcs[MAX_FUNCTION_UNITS];
+};
+
+static void set_topo(struct topology_instance *t, enum topology_type type,
+                     uint8_t a0, uint8_t a1, uint8_t f0, uint8_t f1, uint8_t cc0, uint8_t cc1)
+{
+	topology_init_default(t, type);
+	t->accel_inputs[0] = a0;
+	t->accel_inputs[1] = a1;
+	t->func_units[0] = f0;
+	t->func_units[1] = f1;
+	t->midi_outputs[0] = cc0;
+	t->midi_outputs[1] = cc1;
+}
+
+/* Factory default: six T1 linear paths */
+static void shape_all_t1(struct patch_shape *p)
+{
+	p->name = "all_t1";
+	topology_patch_init_default(&p->topo);
+	for (int i = 0; i < MAX_FUNCTION_UNITS; i++) {
+		func_init_linear(&p->funcs[i], -2000, 2000, 0, 127);
+	}
+}
+
+/* Mixed: T2 merges and T4 dual-function fan-outs with assorted functions */
+static void shape_mixed_t2_t4(struct patch_shape *p)
+{
+	p->name = "mixed_t2_t4";
+	memset(&p->topo, 0, sizeof(p->topo));
+	p->topo.default_mixer_type = MIXER_AVERAGE;
+
+	set_topo(&p->topo.topologies[0], TOPO_T2, 0, 1, 0, 0, 16, 0);
+	set_topo(&p->topo.topologies[1], TOPO_T4, 1, 2, 1, 2, 17, 18);
+	set_topo(&p->topo.topologies[2], TOPO_T2, 2, 0, 3, 0, 19, 0);
+	set_topo(&p->topo.topologies[3], TOPO_T4, 0, 2, 4, 5, 20, 21);
+
+	func_init_linear(&p->funcs[0], -2000, 2000, 0, 127);
+	func_init_linear(&p->funcs[1], -1000, 1000, 0, 127);
+	func_init(&p->funcs[2], FUNC_INVERT);
+	func_init_deadzone(&p->funcs[3], 50);
+	func_init_linear(&p->funcs[4], -2000, 2000, 0, 127);
+	func_init(&p->funcs[5], FUNC_SCALE);
+	p->funcs[5].params[0] = 150;
+	p->funcs[5].param_count = 1;
+	func_init(&p->funcs[6], FUNC_PASSTHROUGH);
+	func_init(&p->funcs[7], FUNC_PASSTHROUGH);
+}
+
+/* Deepest chains the fixed topologies allow: six T4 cascades, summing mixer */
+static void shape_deep_chain(struct patch_shape *p)
+{
+	p->name = "deep_chain";
+	memset(&p->topo, 0, sizeof(p->topo));
+	p->topo.default_mixer_type = MIXER_SUM;
+
+	for (int i = 0; i < MAX_TOPOLOGY_INSTANCES; i++) {
+		set_topo(&p->topo.topologies[i], TOPO_T4, i % 3, (i + 1) % 3,
+		         (2 * i) % MAX_FUNCTION_UNITS, (2 * i + 1) % MAX_FUNCTION_UNITS,
+		         16 + i, 16 + (i + 3) % MAX_MIDI_OUTPUTS);
+	}
+
+	for (int i = 0; i < MAX_FUNCTION_UNITS; i += 2) {
+		func_init_linear(&p->funcs[i], -4000, 4000, 0, 127);
+		func_init(&p->funcs[i + 1], FUNC_CLAMP);
+		p->funcs[i + 1].params[0] = 10;
+		p->funcs[i + 1].params[1] = 117;
+		p->funcs[i + 1].param_count = 2;
+	}
+}
+
+/* ============================================================
+ * BENCHMARK
+ * ============================================================ */
+
+struct bench_result {
+	double ns_per_sample;
+	double samples_per_sec;
+	double midi_bytes_per_sample;
+	uint64_t samples;
+};
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static volatile uint32_t sink;
+
+/* TX backend: accept everything, count bytes */
+static int count_tx(int guitar_id, int output, const uint8_t *msg, size_t len, void *user_data)
+{
+	uint64_t *bytes = user_data;
+
+	(void)guitar_id;
+	(void)output;
+	sink += msg[0] ^ msg[len - 1];
+	*bytes += len;
+	return 0;
+}
+
+static void bench_topology(struct patch_shape *shape, const struct motion_trace *t,
+                           uint64_t run_samples, struct bench_result *res)
+{
+	static struct midi_pipeline pipe;
+	uint64_t best_ns = UINT64_MAX;
+	uint64_t bytes = 0;
+
+	for (int rep = 0; rep < BENCH_REPEATS; rep++) {
+		midi_pipeline_init(&pipe, count_tx, &bytes);
+		midi_pipeline_configure(&pipe, shape->topo.topologies, shape->topo.default_mixer_type,
+		                        shape->funcs, 0, MIDI_DEADZONE);
+		bytes = 0;
+
+		uint64_t start = now_ns();
+		for (uint64_t n = 0; n < run_samples; n++) {
+			const int16_t *xyz = t->xyz[n % t->count];
+			int16_t accel_values[MAX_SENSOR_SOURCES] = {xyz[0], xyz[1], xyz[2]};
+
+			midi_pipeline_process(&pipe, 0, accel_values);
+		}
+		uint64_t elapsed = now_ns() - start;
+
+		if (elapsed < best_ns) {
+			best_ns = elapsed;
+		}
+	}
+
+	res->samples = run_samples;
+	res->ns_per_sample = (double)best_ns / (double)run_samples;
+	res->samples_per_sec = res->ns_per_sample > 0 ? 1e9 / res->ns_per_sample : 0;
+	res->midi_bytes_per_sample = (double)bytes / (double)run_samples;
+}
+
+/* Legacy direct path: accel_to_midi_cc() per axis, no topology */
+static void bench_legacy_mapping(const struct motion_trace *t, uint64_t run_samples,
+                                 struct bench_result *res)
+{
+	uint64_t best_ns = UINT64_MAX;
+	uint64_t bytes = 0;
+
+	for (int rep = 0; rep < BENCH_REPEATS; rep++) {
+		uint8_t last[3] = {255, 255, 255};
+		uint8_t msg[3];
+
+		bytes = 0;
+		uint64_t start = now_ns();
+		for (uint64_t n = 0; n < run_samples; n++) {
+			const int16_t *xyz = t->xyz[n % t->count];
+			for (int a = 0; a < 3; a++) {
+				uint8_t v = accel_to_midi_cc(xyz[a], NULL);
+				if (v != last[a]) {
+					construct_midi_cc_msg(0, (uint8_t)(16 + a), v, msg);
+					sink += msg[2];
+					bytes += sizeof(msg);
+					last[a] = v;
+				}
+			}
+		}
+		uint64_t elapsed = now_ns() - start;
+
+		if (elapsed < best_ns) {
+			best_ns = elapsed;
+		}
+	}
+
+	res->samples = run_samples;
+	res->ns_per_sample = (double)best_ns / (double)run_samples;
+	res->samples_per_sec = res->ns_per_sample > 0 ? 1e9 / res->ns_per_sample : 0;
+	res->midi_bytes_per_sample = (double)bytes / (double)run_samples;
+}
+
+/* ============================================================
+ * TOPOLOGY EXECUTE: PACKED VS COMPILED
+ * ============================================================ */
+
+struct execute_result {
+	double packed_ns;
+	double compiled_ns;
+	uint64_t mismatches;
+};
+
+/* Interpreter over the packed flash structs (the pre-runtime processor) */
+static void packed_execute(const struct patch_topology_config *patch,
+                           const struct function_unit *functions, const int16_t *sources,
+                           struct virtual_port_system *vps, uint8_t *outputs)
+{
+	vport_reset_all(vps);
+	memset(outputs, 0, MAX_MIDI_OUTPUTS);
+
+	for (int i = 0; i < MAX_TOPOLOGY_INSTANCES; i++) {
+		const struct topology_instance *t = &patch->topologies[i];
+		uint8_t type = t->topology_type;
+		bool two = (type == TOPO_T2 || type == TOPO_T4);
+		uint8_t base = i * 3;
+		uint8_t m0 = t->midi_outputs[0] - 16;
+		uint8_t m1 = t->midi_outputs[1] - 16;
+
+		if (!t->enabled || type < TOPO_T1 || type > TOPO_T4) {
+			continue;
+		}
+		if (t->accel_inputs[0] >= MAX_SENSOR_SOURCES || t->func_units[0] >= MAX_FUNCTION_UNITS ||
+		    (two && t->accel_inputs[1] >= MAX_SENSOR_SOURCES) ||
+		    (type == TOPO_T4 && t->func_units[1] >= MAX_FUNCTION_UNITS)) {
+			continue;
+		}
+
+		vport_write(vps, base, sources[t->accel_inputs[0]]);
+		if (two) {
+			vport_write(vps, base, sources[t->accel_inputs[1]]);
+		}
+		int16_t f0 = func_process(&functions[t->func_units[0]], vport_read_raw(vps, base));
+
+		vport_write(vps, base + 1, f0);
+		if (m0 < MAX_MIDI_OUTPUTS) {
+			outputs[m0] = vport_read(vps, base + 1);
+		}
+		if (type == TOPO_T3 && m1 < MAX_MIDI_OUTPUTS) {
+			outputs[m1] = vport_read(vps, base + 1);
+		}
+		if (type == TOPO_T4) {
+			int16_t f1 = func_process(&functions[t->func_units[1]], f0);
+
+			vport_write(vps, base + 2, f1);
+			if (m1 < MAX_MIDI_OUTPUTS) {
+				outputs[m1] = vport_read(vps, base + 2);
+			}
+		}
+	}
+}
+
+static void trace_sources(const struct motion_trace *t, uint64_t n,
+                          int16_t sources[MAX_SENSOR_SOURCES])
+{
+	const int16_t *xyz = t->xyz[n % t->count];
+
+	memset(sources, 0, MAX_SENSOR_SOURCES * sizeof(sources[0]));
+	sources[0] = xyz[0];
+	sources[1] = xyz[1];
+	sources[2] = xyz[2];
+}
+
+static void bench_execute(struct patch_shape *shape, const struct motion_trace *t,
+                          uint64_t run_samples, struct execute_result *res)
+{
+	static struct topology_processor proc;
+	static struct virtual_port_system vps;
+	int16_t sources[MAX_SENSOR_SOURCES];
+	uint8_t outputs[MAX_MIDI_OUTPUTS];
+	uint64_t best_packed = UINT64_MAX;
+	uint64_t best_compiled = UINT64_MAX;
+
+	topo_proc_init(&proc, &shape->topo);
+	for (int i = 0; i < MAX_FUNCTION_UNITS; i++) {
+		topo_proc_set_function(&proc, (uint8_t)i, &shape->funcs[i]);
+	}
+	topo_proc_compile(&proc);
+	vport_init(&vps, (enum vport_mixer_type)shape->topo.default_mixer_type);
+
+	/* Same outputs and port values on every sample of the trace */
+	res->mismatches = 0;
+	for (uint64_t n = 0; n < t->count; n++) {
+		trace_sources(t, n, sources);
+		topo_proc_set_accel_inputs(&proc, sources);
+		topo_proc_execute(&proc);
+		packed_execute(&shape->topo, shape->funcs, sources, &vps, outputs);
+
+		bool same = memcmp(proc.midi_outputs, outputs, sizeof(outputs)) == 0;
+		for (int p = 0; p < MAX_VIRTUAL_PORTS; p++) {
+			same &= proc.vport_system.ports[p].value == vps.ports[p].value &&
+			        proc.vport_system.ports[p].input_count == vps.ports[p].input_count;
+		}
+		res->mismatches += !same;
+	}
+
+	for (int rep = 0; rep < BENCH_REPEATS; rep++) {
+		uint64_t start = now_ns();
+		for (uint64_t n = 0; n < run_samples; n++) {
+			trace_sources(t, n, sources);
+			packed_execute(&shape->topo, shape->funcs, sources, &vps, outputs);
+			sink += outputs[0] ^ outputs[MAX_MIDI_OUTPUTS - 1];
+		}
+		uint64_t elapsed = now_ns() - start;
+		best_packed = elapsed < best_packed ? elapsed : best_packed;
+
+		start = now_ns();
+		for (uint64_t n = 0; n < run_samples; n++) {
+			trace_sources(t, n, sources);
+			topo_proc_set_accel_inputs(&proc, sources);
+			topo_proc_execute(&proc);
+			sink += proc.midi_outputs[0] ^ proc.midi_outputs[MAX_MIDI_OUTPUTS - 1];
+		}
+		elapsed = now_ns() - start;
+		best_compiled = elapsed < best_compiled ? elapsed : best_compiled;
+	}
+
+	res->packed_ns = (double)best_packed / (double)run_samples;
+	res->compiled_ns = (double)best_compiled / (double)run_samples;
+}
+
+static void json_execute(FILE *out, bool *first, const char *patch, const char *trace,
+                         const struct execute_result *r)
+{
+	double speedup = r->compiled_ns > 0 ? r->packed_ns / r->compiled_ns : 0;
+
+	fprintf(out, "%s    {\"patch\": \"%s\", \"trace\": \"%s\", "
+	        "\"packed_ns_per_sample\": %.2f, \"compiled_ns_per_sample\": %.2f, "
+	        "\"speedup\": %.2f, \"mismatches\": %llu}",
+	        *first ? "" : ",\n", patch, trace, r->packed_ns, r->compiled_ns, speedup,
+	        (unsigned long long)r->mismatches);
+	*first = false;
+
+	fprintf(stderr, "  %-14s %-9s %9.1f ns/sample (packed %6.1f) %5.2fx%s\n",
+	        patch, trace, r->compiled_ns, r->packed_ns, speedup,
+	        r->mismatches ? "  OUTPUT MISMATCH" : "");
+}
+
+/* ============================================================
+ * TILT
+ * ============================================================ */
+
+#define TILT_SHIFT  DERIVED_TILT_DEFAULT_SHIFT
+#define RAD_TO_DEG  (180.0 / 3.14159265358979323846)
+
+struct tilt_result {
+	double fixed_ns;
+	double float_ns;
+	double fixed_max_err_deg;
+	double float_max_err_deg;
+};
+
+/* Same low-pass as derived_sources_tilt(), in float, with libm */
+static void float_tilt(float g[3], bool *primed, const int16_t *xyz, float out[2])
+{
+	for (int a = 0; a < 3; a++) {
+		g[a] = *primed ? g[a] + (xyz[a] - g[a]) * (1.0f / (1 << TILT_SHIFT)) : xyz[a];
+	}
+	*primed = true;
+	out[0] = atan2f(g[1], g[2]) * (180.0f / PI_F);
+	out[1] = atan2f(-g[0], sqrtf(g[1] * g[1] + g[2] * g[2])) * (180.0f / PI_F);
+}
+
+static double angle_err(double a, double b)
+{
+	double d = fabs(a - b);
+	return d > 180.0 ? 360.0 - d : d;
+}
+
+static void bench_tilt(const struct motion_trace *t, uint64_t run_samples,
+                       struct tilt_result *res)
+{
+	struct derived_sources ds;
+	uint64_t best_fixed = UINT64_MAX;
+	uint64_t best_float = UINT64_MAX;
+
+	for (int rep = 0; rep < BENCH_REPEATS; rep++) {
+		int16_t tilt[2];
+		float g[3], out[2];
+		bool primed = false;
+
+		derived_sources_init(&ds, TILT_SHIFT);
+		uint64_t start = now_ns();
+		for (uint64_t n = 0; n < run_samples; n++) {
+			derived_sources_tilt(&ds, t->xyz[n % t->count], tilt);
+			sink += (uint16_t)(tilt[0] ^ tilt[1]);
+		}
+		uint64_t elapsed = now_ns() - start;
+		best_fixed = elapsed < best_fixed ? elapsed : best_fixed;
+
+		start = now_ns();
+		for (uint64_t n = 0; n < run_samples; n++) {
+			float_tilt(g, &primed, t->xyz[n % t->count], out);
+			sink += (uint32_t)(int32_t)(out[0] + out[1]);
+		}
+		elapsed = now_ns() - start;
+		best_float = elapsed < best_float ? elapsed : best_float;
+	}
+
+	/* Accuracy: one pass against the filter and atan2 in double */
+	double g_ref[3];
+	float g[3], out[2];
+	bool primed = false;
+	int16_t tilt[2];
+
+	res->fixed_max_err_deg = 0;
+	res->float_max_err_deg = 0;
+	derived_sources_init(&ds, TILT_SHIFT);
+	for (size_t n = 0; n < t->count; n++) {
+		const int16_t *xyz = t->xyz[n];
+
+		for (int a = 0; a < 3; a++) {
+			g_ref[a] = n ? g_ref[a] + (xyz[a] - g_ref[a]) / (1 << TILT_SHIFT) : xyz[a];
+		}
+		if (g_ref[0] == 0 && g_ref[1] == 0 && g_ref[2] == 0) {
+			continue;
+		}
+		double ref[2] = {
+			atan2(g_ref[1], g_ref[2]) * RAD_TO_DEG,
+			atan2(-g_ref[0], sqrt(g_ref[1] * g_ref[1] + g_ref[2] * g_ref[2])) * RAD_TO_DEG,
+		};
+
+		derived_sources_tilt(&ds, xyz, tilt);
+		float_tilt(g, &primed, xyz, out);
+		for (int a = 0; a < 2; a++) {
+			double e_fixed = angle_err(tilt[a] / 10.0, ref[a]);
+			double e_float = angle_err(out[a], ref[a]);
+
+			res->fixed_max_err_deg = fmax(res->fixed_max_err_deg, e_fixed);
+			res->float_max_err_deg = fmax(res->float_max_err_deg, e_float);
+		}
+	}
+
+	res->fixed_ns = (double)best_fixed / (double)run_samples;
+	res->float_ns = (double)best_float / (double)run_samples;
+}
+
+static void json_tilt(FILE *out, bool *first, const char *trace, const struct tilt_result *r)
+{
+	fprintf(out, "%s    {\"trace\": \"%s\", \"fixed_ns_per_sample\": %.2f, "
+	        "\"atan2f_ns_per_sample\": %.2f, \"fixed_max_err_deg\": %.3f, "
+	        "\"atan2f_max_err_deg\": %.3f}",
+	        *first ? "" : ",\n", trace, r->fixed_ns, r->float_ns,
+	        r->fixed_max_err_deg, r->float_max_err_deg);
+	*first = false;
+
+	fprintf(stderr, "  %-14s %-9s %9.1f ns/sample (atan2f %6.1f)  max err %.3f deg (atan2f %.3f)\n",
+	        "tilt", trace, r->fixed_ns, r->float_ns, r->fixed_max_err_deg, r->float_max_err_deg);
+}
+
+/* ============================================================
+ * DERIVED SOURCES
+ * ============================================================ */
+
+static const struct {
+	const char *name;
+	uint16_t mask;
+} derived_masks[] = {
+	{"none", 0},
+	{"magnitude", 1u << SOURCE_MAGNITUDE},
+	{"jerk", DERIVED_MASK_JERK},
+	{"energy", 1u << SOURCE_ENERGY},
+	{"all", 0xFFFF},
+};
+
+#define NUM_DERIVED_MASKS (sizeof(derived_masks) / sizeof(derived_masks[0]))
+
+static double bench_derived(const struct motion_trace *t, uint64_t run_samples, uint16_t mask)
+{
+	struct derived_sources ds;
+	uint64_t best = UINT64_MAX;
+
+	for (int rep = 0; rep < BENCH_REPEATS; rep++) {
+		int16_t values[MAX_SENSOR_SOURCES] = {0};
+
+		derived_sources_init(&ds, TILT_SHIFT);
+		uint64_t start = now_ns();
+		for (uint64_t n = 0; n < run_samples; n++) {
+			memcpy(values, t->xyz[n % t->count], 3 * sizeof(values[0]));
+			derived_sources_update(&ds, values, true, mask);
+			sink += (uint16_t)(values[SOURCE_MAGNITUDE] ^ values[SOURCE_JERK] ^
+			                   values[SOURCE_ENERGY]);
+		}
+		uint64_t elapsed = now_ns() - start;
+		best = elapsed < best ? elapsed : best;
+	}
+
+	return (double)best / (double)run_samples;
+}
+
+static void json_derived(FILE *out, bool *first, const char *sources, const char *trace,
+                         double ns)
+{
+	fprintf(out, "%s    {\"sources\": \"%s\", \"trace\": \"%s\", \"ns_per_sample\": %.2f}",
+	        *first ? "" : ",\n", sources, trace, ns);
+	*first = false;
+
+	fprintf(stderr, "  %-14s %-9s %9.1f ns/sample\n", sources, trace, ns);
+}
+
+/* ============================================================
+ * GESTURES
+ * ============================================================ */
+
+static const struct {
+	const char *name;
+	struct gesture_config cfg;
+} gesture_sets[] = {
+	{"strum", {{{GESTURE_STRUM, SOURCE_JERK_Y, GESTURE_ACTION_NOTE, 60, 25, 64}}}},
+	{"shake", {{{GESTURE_SHAKE, SOURCE_ENERGY, GESTURE_ACTION_NOTE, 36, 20, 64}}}},
+	{"flick", {{{GESTURE_FLICK, SOURCE_JERK_X, GESTURE_ACTION_NOTE, 40, 25, 64}}}},
+	{"all", {{{GESTURE_STRUM, SOURCE_JERK_Y, GESTURE_ACTION_NOTE, 60, 25, 64},
+	          {GESTURE_SHAKE, SOURCE_ENERGY, GESTURE_ACTION_CC_TOGGLE, 80, 20, 64},
+	          {GESTURE_TAP, SOURCE_JERK_Z, GESTURE_ACTION_PROGRAM, 1, 25, 64}}}},
+};
+
+#define NUM_GESTURE_SETS (sizeof(gesture_sets) / sizeof(gesture_sets[0]))
+
+/* Sources are computed once per trace sample; only the engine is timed */
+static double bench_gestures(const struct motion_trace *t, uint64_t run_samples,
+                             const struct gesture_config *cfg, double *events_per_sample)
+{
+	int16_t (*values)[MAX_SENSOR_SOURCES];
+	struct derived_sources ds;
+	struct gesture_engine ge;
+	struct gesture_event events[GESTURE_MAX_EVENTS];
+	uint64_t best = UINT64_MAX;
+	uint64_t count = 0;
+
+	values = calloc(t->count, sizeof(*values));
+	if (!values) {
+		return 0.0;
+	}
+	derived_sources_init(&ds, TILT_SHIFT);
+	for (size_t n = 0; n < t->count; n++) {
+		memcpy(values[n], t->xyz[n], 3 * sizeof(values[n][0]));
+		derived_sources_update(&ds, values[n], false, 0xFFFF);
+	}
+
+	for (int rep = 0; rep < BENCH_REPEATS; rep++) {
+		gesture_engine_init(&ge);
+		count = 0;
+		uint64_t start = now_ns();
+		for (uint64_t n = 0; n < run_samples; n++) {
+			count += (uint64_t)gesture_engine_process(&ge, cfg, values[n % t->count], 0, events);
+		}
+		uint64_t elapsed = now_ns() - start;
+		best = elapsed < best ? elapsed : best;
+	}
+
+	free(values);
+	*events_per_sample = (double)count / (double)run_samples;
+	return (double)best / (double)run_samples;
+}
+
+static void json_gestures(FILE *out, bool *first, const char *gestures, const char *trace,
+                          double ns, double events)
+{
+	fprintf(out, "%s    {\"gestures\": \"%s\", \"trace\": \"%s\", \"ns_per_sample\": %.2f, "
+	        "\"events_per_sample\": %.4f}",
+	        *first ? "" : ",\n", gestures, trace, ns, events);
+	*first = false;
+
+	fprintf(stderr, "  %-14s %-9s %9.1f ns/sample %8.4f events/sample\n",
+	        gestures, trace, ns, events);
+}
+
+static void json_result(FILE *out, bool *first, const char *patch, const char *trace,
+                        const struct bench_result *r)
+{
+	fprintf(out, "%s    {\"patch\": \"%s\", \"trace\": \"%s\", \"samples\": %llu, "
+	        "\"ns_per_sample\": %.2f, \"samples_per_sec\": %.0f, "
+	        "\"midi_bytes_per_sample\": %.3f}",
+	        *first ? "" : ",\n", patch, trace, (unsigned long long)r->samples,
+	        r->ns_per_sample, r->samples_per_sec, r->midi_bytes_per_sample);
+	*first = false;
+
+	fprintf(stderr, "  %-14s %-9s %9.1f ns/sample %12.0f samples/s %6.2f MIDI B/sample\n",
+	        patch, trace, r->ns_per_sample, r->samples_per_sec, r->midi_bytes_per_sample);
+}
+
+/* ============================================================
+ * MAIN
+ * ============================================================ */
+
+int main(int argc, char **argv)
+{
+	const char *trace_path = NULL;
+	const char *json_path = NULL;
+	uint64_t run_samples = MIN_RUN_SAMPLES;
+
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "--trace") && i + 1 < argc) {
+			trace_path = argv[++i];
+		} else if (!strcmp(argv[i], "--json") && i + 1 < argc) {
+			json_path = argv[++i];
+		} else if (!strcmp(argv[i], "--quick")) {
+			run_samples = QUICK_RUN_SAMPLES;
+		} else {
+			fprintf(stderr, "Usage: %s [--trace file.csv] [--json out.json] [--quick]\n",
+			        argv[0]);
+			return 2;
+		}
+	}
+
+	synth_still();
+	synth_sweep();
+	synth_strum();
+	synth_noise();
+	if (trace_path && load_trace(trace_path) != 0) {
+		return 1;
+	}
+
+	static struct patch_shape shapes[3];
+	shape_all_t1(&shapes[0]);
+	shape_mixed_t2_t4(&shapes[1]);
+	shape_deep_chain(&shapes[2]);
+
+	FILE *out = stdout;
+	if (json_path) {
+		out = fopen(json_path, "w");
+		if (!out) {
+			fprintf(stderr, "Cannot write %s\n", json_path);
+			return 1;
+		}
+	}
+
+	fprintf(stderr, "Signal chain benchmark (%s, best of %d x %llu samples)\n",
+	        BENCH_OPT_LEVEL, BENCH_REPEATS, (unsigned long long)run_samples);
+
+	fprintf(out, "{\n  \"benchmark\": \"signal_chain\",\n  \"format\": 1,\n");
+	fprintf(out, "  \"compiler\": \"%s\",\n  \"opt\": \"%s\",\n", __VERSION__, BENCH_OPT_LEVEL);
+	fprintf(out, "  \"repeats\": %d,\n  \"results\": [\n", BENCH_REPEATS);
+
+	bool first = true;
+	struct bench_result r;
+
+	for (int s = 0; s < 3; s++) {
+		for (int t = 0; t < trace_count; t++) {
+			bench_topology(&shapes[s], &traces[t], run_samples, &r);
+			json_result(out, &first, shapes[s].name, traces[t].name, &r);
+		}
+	}
+	for (int t = 0; t < trace_count; t++) {
+		bench_legacy_mapping(&traces[t], run_samples, &r);
+		json_result(out, &first, "legacy_mapping", traces[t].name, &r);
+	}
+
+	fprintf(out, "\n  ],\n  \"execute\": [\n");
+
+	struct execute_result er;
+	uint64_t mismatches = 0;
+
+	first = true;
+	for (int s = 0; s < 3; s++) {
+		for (int t = 0; t < trace_count; t++) {
+			bench_execute(&shapes[s], &traces[t], run_samples, &er);
+			json_execute(out, &first, shapes[s].name, traces[t].name, &er);
+			mismatches += er.mismatches;
+		}
+	}
+
+	fprintf(out, "\n  ],\n  \"tilt\": [\n");
+
+	struct tilt_result tr;
+
+	first = true;
+	for (int t = 0; t < trace_count; t++) {
+		bench_tilt(&traces[t], run_samples, &tr);
+		json_tilt(out, &first, traces[t].name, &tr);
+	}
+
+	fprintf(out, "\n  ],\n  \"derived\": [\n");
+
+	first = true;
+	for (size_t m = 0; m < NUM_DERIVED_MASKS; m++) {
+		for (int t = 0; t < trace_count; t++) {
+			double ns = bench_derived(&traces[t], run_samples, derived_masks[m].mask);
+			json_derived(out, &first, derived_masks[m].name, traces[t].name, ns);
+		}
+	}
+
+	fprintf(out, "\n  ],\n  \"gestures\": [\n");
+
+	first = true;
+	for (size_t g = 0; g < NUM_GESTURE_SETS; g++) {
+		for (int t = 0; t < trace_count; t++) {
+			double events;
+			double ns = bench_gestures(&traces[t], run_samples, &gesture_sets[g].cfg, &events);
+			json_gestures(out, &first, gesture_sets[g].name, traces[t].name, ns, events);
+		}
+	}
+
+	fprintf(out, "\n  ]\n}\n");
+
+	if (out != stdout) {
+		fclose(out);
+		fprintf(stderr, "Results written to %s\n", json_path);
+	}
+
+	for (int t = 0; t < trace_count; t++) {
+		free(traces[t].xyz);
+	}
+
+	if (mismatches) {
+		fprintf(stderr, "Compiled topology differs from the packed interpreter on %llu samples\n",
+		        (unsigned long long)mismatches);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,148 @@
+/*
+ * Boot Timing Unit Tests
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "../src/boot_timing.h"
+
+/* Test statistics */
+static int total_tests = 0;
+static int passed_tests = 0;
+static int failed_tests = 0;
+
+/* Test utilities */
+static void print_separator(char c, int length)
+{
+	for (int i = 0; i < length; i++) {
+		putchar(c);
+	}
+	putchar('\n');
+}
+
+static void assert_equal_uint32(const char *test_name, uint32_t expected, uint32_t actual)
+{
+	total_tests++;
+	if (expected == actual) {
+		printf("  ✓ %s: %u\n", test_name, actual);
+		passed_tests++;
+	} else {
+		printf("  ✗ %s: expected %u, got %u\n", test_name, expected, actual);
+		failed_tests++;
+	}
+}
+
+static void assert_true(const char *test_name, bool condition)
+{
+	total_tests++;
+	if (condition) {
+		printf("  ✓ %s\n", test_name);
+		passed_tests++;
+	} else {
+		printf("  ✗ %s: assertion failed\n", test_name);
+		failed_tests++;
+	}
+}
+
+/* ============================================================
+ * TESTS
+ * ============================================================ */
+
+static void test_phases(void)
+{
+	printf("\nTest: Sequential and Overlapping Phases\n");
+	print_separator('-', 60);
+
+	struct boot_timing bt;
+	boot_timing_init(&bt);
+
+	int config = boot_timing_begin(&bt, "config", 1000);
+	boot_timing_end(&bt, config, 1800);
+	assert_equal_uint32("Config phase index", 0, config);
+	assert_equal_uint32("Config duration", 800, boot_timing_duration(&bt, config));
+
+	/* BT enable runs in the background while main() continues */
+	int ble = boot_timing_begin(&bt, "bt_enable", 1800);
+	int shell = boot_timing_begin(&bt, "shell", 1850);
+	boot_timing_end(&bt, shell, 2100);
+	assert_equal_uint32("BT still running: duration 0", 0, boot_timing_duration(&bt, ble));
+	boot_timing_end(&bt, ble, 30000);
+	assert_equal_uint32("BT duration from its own start", 28200, boot_timing_duration(&bt, ble));
+	assert_equal_uint32("Shell duration unaffected", 250, boot_timing_duration(&bt, shell));
+
+	boot_timing_end(&bt, ble, 99999);
+	assert_equal_uint32("Second end ignored", 28200, boot_timing_duration(&bt, ble));
+	boot_timing_end(&bt, -1, 5000);
+	boot_timing_end(&bt, 7, 5000);
+	assert_equal_uint32("Bad index ignored", 3, bt.count);
+	assert_equal_uint32("Unknown phase: duration 0", 0, boot_timing_duration(&bt, 7));
+
+	/* Uptime wrap between begin and end */
+	int wrap = boot_timing_begin(&bt, "wrap", 0xFFFFFF00u);
+	boot_timing_end(&bt, wrap, 0x100);
+	assert_equal_uint32("Duration across wrap", 0x200, boot_timing_duration(&bt, wrap));
+
+	/* Table full */
+	while (boot_timing_begin(&bt, "filler", 0) >= 0) {
+	}
+	assert_equal_uint32("Phases capped", BOOT_TIMING_MAX_PHASES, bt.count);
+	assert_true("Begin on full table returns -1", boot_timing_begin(&bt, "late", 0) == -1);
+	assert_true("Names kept", strcmp(bt.phases[1].name, "bt_enable") == 0);
+}
+
+static void test_milestones(void)
+{
+	printf("\nTest: Milestones\n");
+	print_separator('-', 60);
+
+	struct boot_timing bt;
+	uint32_t us = 0;
+
+	boot_timing_init(&bt);
+	assert_true("Not reached yet", !boot_timing_get_milestone(&bt, BOOT_MS_SCANNING, &us));
+
+	assert_true("First stamp sets it", boot_timing_milestone(&bt, BOOT_MS_SCANNING, 42000));
+	assert_true("Later stamp ignored", !boot_timing_milestone(&bt, BOOT_MS_SCANNING, 90000));
+	assert_true("Reached", boot_timing_get_milestone(&bt, BOOT_MS_SCANNING, &us));
+	assert_equal_uint32("Scanning at first stamp", 42000, us);
+
+	assert_true("First MIDI independent", !boot_timing_get_milestone(&bt, BOOT_MS_FIRST_MIDI, NULL));
+	boot_timing_milestone(&bt, BOOT_MS_FIRST_MIDI, 650000);
+	assert_true("First MIDI reached (NULL output allowed)",
+	            boot_timing_get_milestone(&bt, BOOT_MS_FIRST_MIDI, NULL));
+
+	assert_true("Out of range milestone", !boot_timing_milestone(&bt, BOOT_MS_COUNT, 1));
+	assert_true("Names", strcmp(boot_timing_milestone_name(BOOT_MS_SCANNING), "scanning") == 0 &&
+	            strcmp(boot_timing_milestone_name(BOOT_MS_FIRST_MIDI), "first MIDI") == 0);
+}
+
+int main(void)
+{
+	printf("\n");
+	print_separator('=', 60);
+	printf("BOOT TIMING TESTS\n");
+	print_separator('=', 60);
+
+	test_phases();
+	test_milestones();
+
+	printf("\n");
+	print_separator('=', 60);
+	printf("TEST SUMMARY\n");
+	print_separator('=', 60);
+	printf("Total tests:  %d\n", total_tests);
+	printf("Passed:       %d\n", passed_tests);
+	printf("Failed:       %d\n", failed_tests);
+	printf("Success rate: %.1f%%\n",
+	       total_tests > 0 ? (100.0 * passed_tests / total_tests) : 0.0);
+	print_separator('=', 60);
+
+	return (failed_tests == 0) ? 0 : 1;
+}
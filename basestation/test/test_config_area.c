@@ -0,0 +1,471 @@
+/*
+ * Configuration Area and Flash Simulator Unit Tests
+ *
+ * Runs the ping-pong area format (config_area.c) on the flash simulator:
+ * flash rules, partial erase, save/boot round trips, power loss at every
+ * program/erase unit of a save, and bit flips.
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+
+#include "../src/flash_sim.h"
+#include "../src/config_area.h"
+#include "../src/config_journal.h"
+
+#define BASE        0x000FC000   /* Config partition on the target */
+#define FLASH_SIZE  (2 * FLASH_SIM_PAGE_SIZE)
+#define IMAGE_SIZE  1104         /* sizeof(struct config_data) on the target */
+
+/* Test statistics */
+static int total_tests = 0;
+static int passed_tests = 0;
+static int failed_tests = 0;
+
+/* Test utilities */
+static void print_separator(char c, int length)
+{
+	for (int i = 0; i < length; i++) {
+		putchar(c);
+	}
+	putchar('\n');
+}
+
+static void assert_equal_int(const char *test_name, int expected, int actual)
+{
+	total_tests++;
+	if (expected == actual) {
+		printf("  ✓ %s: %d\n", test_name, actual);
+		passed_tests++;
+	} else {
+		printf("  ✗ %s: expected %d, got %d\n", test_name, expected, actual);
+		failed_tests++;
+	}
+}
+
+static void assert_true(const char *test_name, bool condition)
+{
+	total_tests++;
+	if (condition) {
+		printf("  ✓ %s\n", test_name);
+		passed_tests++;
+	} else {
+		printf("  ✗ %s: assertion failed\n", test_name);
+		failed_tests++;
+	}
+}
+
+/* ============================================================
+ * FIXTURE
+ * ============================================================ */
+
+static uint8_t flash_mem[FLASH_SIZE];
+static uint32_t erase_counts[FLASH_SIZE / FLASH_SIM_PAGE_SIZE];
+static uint8_t scratch[FLASH_SIM_PAGE_SIZE];
+static struct flash_sim sim;
+static struct config_area_store store;
+
+/* Stand-in for SHA-256: four CRC-32s, each with a different prefix byte */
+static int test_hash(const void *data, size_t len, uint8_t hash[CONFIG_HASH_SIZE])
+{
+	static uint8_t buf[FLASH_SIM_PAGE_SIZE + 1];
+
+	memcpy(&buf[1], data, len);
+	memset(hash, 0, CONFIG_HASH_SIZE);
+	for (int i = 0; i < 4; i++) {
+		buf[0] = (uint8_t)i;
+		uint32_t crc = config_journal_crc32(buf, len + 1);
+		memcpy(&hash[i * 4], &crc, sizeof(crc));
+	}
+	return 0;
+}
+
+static void fixture_init(void)
+{
+	flash_sim_init(&sim, flash_mem, erase_counts, BASE, FLASH_SIZE);
+	config_area_init(&store, flash_sim_backend(&sim), BASE, BASE + FLASH_SIM_PAGE_SIZE,
+			 FLASH_SIM_PAGE_SIZE, IMAGE_SIZE, 1, test_hash, scratch, sizeof(scratch));
+}
+
+/* What config_storage_init() does, with the hash checked right away */
+static int boot(uint8_t *image)
+{
+	struct config_header headers[CONFIG_AREA_COUNT];
+	bool valid[CONFIG_AREA_COUNT];
+	uint8_t order[CONFIG_AREA_COUNT];
+
+	config_area_init(&store, flash_sim_backend(&sim), BASE, BASE + FLASH_SIM_PAGE_SIZE,
+			 FLASH_SIM_PAGE_SIZE, IMAGE_SIZE, 1, test_hash, scratch, sizeof(scratch));
+	for (uint8_t a = 0; a < CONFIG_AREA_COUNT; a++) {
+		valid[a] = config_area_read_header(&store, a, &headers[a]) == 0;
+	}
+
+	int n = config_area_select(headers, valid, order);
+	for (int i = 0; i < n; i++) {
+		if (config_area_load(&store, order[i], &headers[order[i]], image, true) >= 0) {
+			return order[i];
+		}
+	}
+	return -ENOENT;
+}
+
+/**
+ * @brief Boot as the firmware does: headers only, hash checked afterwards
+ *
+ * Mirrors config_storage_init() and the background verify: on a mismatch
+ * the other area is loaded and compacted over the corrupt one.
+ *
+ * @param recovered Output: the hash check failed and the other area was used
+ * @return Area selected from the headers, or -ENOENT
+ */
+static int boot_deferred(uint8_t *image, bool *recovered)
+{
+	static uint8_t check[IMAGE_SIZE];
+	struct config_header headers[CONFIG_AREA_COUNT];
+	bool valid[CONFIG_AREA_COUNT];
+	uint8_t order[CONFIG_AREA_COUNT];
+
+	*recovered = false;
+	config_area_init(&store, flash_sim_backend(&sim), BASE, BASE + FLASH_SIM_PAGE_SIZE,
+			 FLASH_SIM_PAGE_SIZE, IMAGE_SIZE, 1, test_hash, scratch, sizeof(scratch));
+	for (uint8_t a = 0; a < CONFIG_AREA_COUNT; a++) {
+		valid[a] = config_area_read_header(&store, a, &headers[a]) == 0;
+	}
+
+	int n = config_area_select(headers, valid, order);
+	if (n == 0 || config_area_load(&store, order[0], &headers[order[0]], image, false) < 0) {
+		return -ENOENT;
+	}
+
+	uint8_t other = 1 - order[0];
+	if (config_area_read_image(&store, order[0], &headers[order[0]], check, true) == 0) {
+		return order[0];
+	}
+	if (valid[other] && config_area_load(&store, other, &headers[other], image, true) >= 0) {
+		*recovered = true;
+		config_area_compact(&store, image);
+	}
+	return order[0];
+}
+
+static void fill_image(uint8_t *image, uint8_t seed)
+{
+	for (size_t i = 0; i < IMAGE_SIZE; i++) {
+		image[i] = (uint8_t)(seed + i * 7);
+	}
+}
+
+/* ============================================================
+ * TESTS
+ * ============================================================ */
+
+static void test_flash_rules(void)
+{
+	printf("\nTest: Flash Simulator Rules and Timing\n");
+	print_separator('-', 60);
+
+	const struct storage_backend *be;
+	uint8_t buf[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+	uint8_t out[8];
+
+	fixture_init();
+	be = flash_sim_backend(&sim);
+
+	assert_true("Starts erased", flash_mem[0] == 0xFF && flash_mem[FLASH_SIZE - 1] == 0xFF);
+	assert_equal_int("Aligned write", 0, storage_write(be, BASE, buf, 8));
+	assert_equal_int("Write costs 2 blocks", 2 * FLASH_SIM_WRITE_BLOCK_US, (int)sim.stats.busy_us);
+	assert_equal_int("Rewrite without erase rejected", -EIO, storage_write(be, BASE, buf, 4));
+	assert_equal_int("Misaligned offset rejected", -EINVAL, storage_write(be, BASE + 9, buf, 4));
+	assert_equal_int("Odd length rejected", -EINVAL, storage_write(be, BASE + 8, buf, 3));
+	assert_equal_int("Violations counted", 3, (int)sim.stats.violations);
+	assert_equal_int("Outside device rejected", -EINVAL, storage_read(be, BASE + FLASH_SIZE, out, 1));
+
+	assert_equal_int("Partial page erase rejected", -EINVAL, storage_erase(be, BASE, 100));
+	assert_equal_int("Page erase", 0, storage_erase(be, BASE, FLASH_SIM_PAGE_SIZE));
+	assert_true("Erase takes tERASEPAGE",
+		    sim.stats.busy_us == FLASH_SIM_ERASE_PAGE_US + 2 * FLASH_SIM_WRITE_BLOCK_US);
+	assert_equal_int("Write after erase", 0, storage_write(be, BASE, buf, 8));
+	storage_read(be, BASE, out, 8);
+	assert_true("Read back", memcmp(out, buf, 8) == 0);
+	assert_equal_int("Erase count page 0", 1, (int)flash_sim_erase_count(&sim, BASE));
+	assert_equal_int("Erase count page 1", 0, (int)flash_sim_erase_count(&sim, BASE + 4096));
+}
+
+static void test_faults(void)
+{
+	printf("\nTest: Power Loss and Bit Flips\n");
+	print_separator('-', 60);
+
+	const struct storage_backend *be;
+	uint8_t buf[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+	uint8_t out[8];
+
+	fixture_init();
+	be = flash_sim_backend(&sim);
+
+	/* One block completes, the second is torn */
+	flash_sim_power_loss_after(&sim, 1);
+	assert_equal_int("Write cut", -EIO, storage_write(be, BASE, buf, 8));
+	assert_true("First block written, second torn",
+		    flash_mem[3] == 0 && flash_mem[5] == 0 && flash_mem[6] == 0xFF);
+	assert_equal_int("Everything fails while off", -EIO, storage_read(be, BASE, out, 8));
+	flash_sim_power_on(&sim);
+	assert_equal_int("Reads after power on", 0, storage_read(be, BASE, out, 8));
+
+	flash_sim_power_loss_after(&sim, 0);
+	assert_equal_int("Erase cut", -EIO, storage_erase(be, BASE, FLASH_SIM_PAGE_SIZE));
+	flash_sim_power_on(&sim);
+	assert_true("Half erased", flash_mem[0] == 0xFF && flash_mem[FLASH_SIM_PAGE_SIZE - 1] == 0xFF);
+
+	flash_sim_flip_bit(&sim, BASE + 100, 3);
+	assert_true("Stored bit flipped", flash_mem[100] == (0xFF ^ 0x08));
+
+	static uint8_t big[FLASH_SIM_PAGE_SIZE];
+	flash_sim_set_read_flips(&sim, 10000, 42);    /* 1% of bytes */
+	storage_read(be, BASE + FLASH_SIM_PAGE_SIZE, big, sizeof(big));
+	assert_true("Transient flips injected", sim.stats.read_flips > 10 && sim.stats.read_flips < 100);
+	assert_true("Stored data unchanged", flash_mem[FLASH_SIM_PAGE_SIZE + 1] == 0xFF);
+}
+
+static void test_partial_erase(void)
+{
+	printf("\nTest: Partial Erase in Slices\n");
+	print_separator('-', 60);
+
+	const struct storage_backend *be;
+	uint8_t buf[4] = { 0, 0, 0, 0 };
+	uint32_t slices = (FLASH_SIM_ERASE_PAGE_US + 2999) / 3000;
+
+	fixture_init();
+	be = flash_sim_backend(&sim);
+	assert_equal_int("Whole-page erase stalls tERASEPAGE", 0,
+			 storage_erase(be, BASE, FLASH_SIM_PAGE_SIZE));
+	assert_equal_int("Stall", FLASH_SIM_ERASE_PAGE_US, (int)sim.stats.max_stall_us);
+
+	flash_sim_reset_stats(&sim);
+	flash_sim_set_erase_slice(&sim, 3000);
+	storage_write(be, BASE, buf, 4);
+	assert_equal_int("Sliced erase", 0, storage_erase(be, BASE, FLASH_SIM_PAGE_SIZE));
+	assert_equal_int("Longest stall is one slice", 3000, (int)sim.stats.max_stall_us);
+	assert_true("Same total time",
+		    sim.stats.busy_us == FLASH_SIM_ERASE_PAGE_US + FLASH_SIM_WRITE_BLOCK_US);
+	assert_equal_int("One page erase", 1, (int)sim.stats.page_erases);
+
+	storage_write(be, BASE + FLASH_SIM_PAGE_SIZE - 4, buf, 4);
+	flash_sim_power_loss_after(&sim, slices - 1);
+	assert_equal_int("Cut in the last slice", -EIO, storage_erase(be, BASE, FLASH_SIM_PAGE_SIZE));
+	flash_sim_power_on(&sim);
+	assert_true("Page not fully erased", flash_mem[FLASH_SIM_PAGE_SIZE - 1] == 0);
+	flash_sim_power_loss_after(&sim, slices);
+	assert_equal_int("All slices complete", 0, storage_erase(be, BASE, FLASH_SIM_PAGE_SIZE));
+	flash_sim_power_loss_after(&sim, FLASH_SIM_NO_POWER_LOSS);
+}
+
+static void test_save_and_boot(void)
+{
+	printf("\nTest: Save, Journal, Compaction and Boot\n");
+	print_separator('-', 60);
+
+	static uint8_t a[IMAGE_SIZE], b[IMAGE_SIZE], loaded[IMAGE_SIZE];
+
+	fixture_init();
+	assert_equal_int("Empty flash: nothing to boot", -ENOENT, boot(loaded));
+
+	fill_image(a, 1);
+	assert_equal_int("Unchanged save writes nothing", 0, config_area_save(&store, a, a));
+	assert_equal_int("Nothing erased", 0, (int)sim.stats.page_erases);
+	assert_equal_int("First image", 0, config_area_compact(&store, a));
+	assert_equal_int("Sequence 1", 1, (int)store.sequence);
+	assert_equal_int("Into area B (A was active)", 1, store.active);
+
+	memcpy(b, a, IMAGE_SIZE);
+	b[10] ^= 0x55;
+	flash_sim_reset_stats(&sim);
+	assert_equal_int("Small change journaled", 0, config_area_save(&store, a, b));
+	assert_equal_int("Same sequence", 1, (int)store.sequence);
+	assert_equal_int("No erase for a journaled save", 0, (int)sim.stats.page_erases);
+	assert_true("Journal in use", store.journal_used > 0 && store.journal_records == 1);
+
+	assert_equal_int("Boot picks area B", 1, boot(loaded));
+	assert_true("Journal replayed", memcmp(loaded, b, IMAGE_SIZE) == 0);
+
+	/* Fill the journal until a save compacts */
+	int saves = 0;
+	while (store.sequence == 1 && saves < 1000) {
+		memcpy(a, b, IMAGE_SIZE);
+		b[(saves * 13) % IMAGE_SIZE]++;
+		config_area_save(&store, a, b);
+		saves++;
+	}
+	assert_true("Compaction when full", store.sequence == 2 && store.active == 0);
+	assert_equal_int("Boot after compaction", 0, boot(loaded));
+	assert_true("Image intact", memcmp(loaded, b, IMAGE_SIZE) == 0);
+
+	/* Persistent flip in the active image: the hash check falls back */
+	flash_sim_flip_bit(&sim, BASE + sizeof(struct config_header) + 5, 0);
+	assert_equal_int("Corrupt image: other area used", 1, boot(loaded));
+	assert_true("Older configuration", memcmp(loaded, b, IMAGE_SIZE) != 0);
+}
+
+/*
+ * Cut power at every program/erase unit of a save and check that boot
+ * then finds the old or the new configuration, never anything else, and
+ * never the old one again once the new one has been seen.
+ *
+ * @return Number of cut points (units in the save)
+ */
+static void test_recovery_repairs(void)
+{
+	printf("\nTest: Recovery Rewrites the Corrupt Area\n");
+	print_separator('-', 60);
+
+	static uint8_t a[IMAGE_SIZE], b[IMAGE_SIZE], loaded[IMAGE_SIZE];
+	bool recovered;
+
+	fixture_init();
+	fill_image(a, 3);
+	fill_image(b, 4);
+	config_area_compact(&store, a);
+	config_area_compact(&store, b);
+	assert_true("Newest image in area A", store.active == 0 && store.sequence == 2);
+
+	/* The header stays valid, only the hash check sees the flip */
+	flash_sim_flip_bit(&sim, BASE + sizeof(struct config_header) + 7, 2);
+	assert_equal_int("First boot selects area A", 0, boot_deferred(loaded, &recovered));
+	assert_true("Hash mismatch recovered", recovered);
+	assert_true("Older configuration", memcmp(loaded, a, IMAGE_SIZE) == 0);
+	assert_true("Rewritten as the newest area", store.active == 0 && store.sequence == 2);
+
+	memcpy(b, a, IMAGE_SIZE);
+	b[20] ^= 0x0F;
+	assert_equal_int("Save after recovery", 0, config_area_save(&store, a, b));
+
+	assert_equal_int("Second boot selects area A", 0, boot_deferred(loaded, &recovered));
+	assert_true("No recovery needed", !recovered);
+	assert_true("Save kept", memcmp(loaded, b, IMAGE_SIZE) == 0);
+}
+
+static void test_erase_all(void)
+{
+	printf("\nTest: Save After Erasing Both Areas\n");
+	print_separator('-', 60);
+
+	static uint8_t a[IMAGE_SIZE], b[IMAGE_SIZE], loaded[IMAGE_SIZE];
+
+	fixture_init();
+	fill_image(a, 5);
+	config_area_compact(&store, a);
+	memcpy(b, a, IMAGE_SIZE);
+	b[30] ^= 0x11;
+	config_area_save(&store, a, b);
+	assert_true("Journal in use", store.journal_records == 1);
+
+	assert_equal_int("Boot before erase", 1, boot(loaded));
+	assert_equal_int("Erase both areas", 0, config_area_erase_all(&store));
+	assert_true("Journal reset", store.journal_records == 0);
+
+	/* The caller still holds b as the stored image: a small change must
+	 * not be appended to the erased area */
+	memcpy(a, b, IMAGE_SIZE);
+	b[31] ^= 0x22;
+	assert_equal_int("Save after erase", 0, config_area_save(&store, a, b));
+	assert_true("Full image written", store.journal_records == 0);
+
+	assert_true("Boot finds the save", boot(loaded) >= 0);
+	assert_true("Saved value read back", memcmp(loaded, b, IMAGE_SIZE) == 0);
+}
+
+static int torture_save(bool compact, uint32_t erase_slice_us, int *bad)
+{
+	static uint8_t old_img[IMAGE_SIZE], new_img[IMAGE_SIZE], loaded[IMAGE_SIZE];
+	bool seen_new = false;
+
+	*bad = 0;
+	for (int cut = 0; ; cut++) {
+		fixture_init();
+		flash_sim_set_erase_slice(&sim, erase_slice_us);
+		fill_image(old_img, 3);
+		config_area_compact(&store, old_img);
+		memcpy(new_img, old_img, IMAGE_SIZE);
+		new_img[200] ^= 0xFF;
+		new_img[900] ^= 0x0F;
+		if (compact) {
+			config_area_force_compact(&store);
+		}
+
+		flash_sim_power_loss_after(&sim, cut);
+		bool done = config_area_save(&store, old_img, new_img) == 0;
+		flash_sim_power_loss_after(&sim, FLASH_SIM_NO_POWER_LOSS);
+		flash_sim_power_on(&sim);
+
+		if (boot(loaded) < 0) {
+			(*bad)++;
+		} else if (memcmp(loaded, new_img, IMAGE_SIZE) == 0) {
+			seen_new = true;
+		} else if (memcmp(loaded, old_img, IMAGE_SIZE) != 0 || seen_new || done) {
+			(*bad)++;
+		}
+		if (done) {
+			return cut;
+		}
+	}
+}
+
+static void test_power_loss(void)
+{
+	printf("\nTest: Power Loss at Every Unit of a Save\n");
+	print_separator('-', 60);
+
+	int bad;
+	int cuts = torture_save(false, 0, &bad);
+	printf("  Journal append: %d cut points\n", cuts);
+	assert_equal_int("Append: always old or new, never back", 0, bad);
+	assert_true("Append: a few word writes", cuts > 0 && cuts < 16);
+
+	cuts = torture_save(true, 0, &bad);
+	printf("  Compaction: %d cut points\n", cuts);
+	assert_equal_int("Compaction: always old or new, never back", 0, bad);
+	assert_true("Compaction: erase, image and header", cuts == 1 + (IMAGE_SIZE + 52) / 4);
+
+	cuts = torture_save(true, 3000, &bad);
+	printf("  Compaction, sliced erase: %d cut points\n", cuts);
+	assert_equal_int("Sliced: always old or new, never back", 0, bad);
+	assert_true("Sliced: every slice is a cut point",
+		    cuts == (FLASH_SIM_ERASE_PAGE_US + 2999) / 3000 + (IMAGE_SIZE + 52) / 4);
+}
+
+int main(void)
+{
+	printf("\n");
+	print_separator('=', 60);
+	printf("CONFIG AREA / FLASH SIMULATOR TESTS\n");
+	print_separator('=', 60);
+
+	test_flash_rules();
+	test_faults();
+	test_partial_erase();
+	test_save_and_boot();
+	test_recovery_repairs();
+	test_erase_all();
+	test_power_loss();
+
+	printf("\n");
+	print_separator('=', 60);
+	printf("TEST SUMMARY\n");
+	print_separator('=', 60);
+	printf("Total tests:  %d\n", total_tests);
+	printf("Passed:       %d\n", passed_tests);
+	printf("Failed:       %d\n", failed_tests);
+	printf("Success rate: %.1f%%\n",
+	       total_tests > 0 ? (100.0 * passed_tests / total_tests) : 0.0);
+	print_separator('=', 60);
+
+	return (failed_tests == 0) ? 0 : 1;
+}
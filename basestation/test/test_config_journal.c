@@ -0,0 +1,263 @@
+/*
+ * Config Journal Unit Tests
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+
+#include "../src/config_journal.h"
+
+#define IMAGE_SIZE    1104   /* sizeof(struct config_data) on the firmware */
+#define JOURNAL_LEN   2940   /* Rest of the 4 KB area after header and image */
+
+/* Test statistics */
+static int total_tests = 0;
+static int passed_tests = 0;
+static int failed_tests = 0;
+
+/* Test utilities */
+static void print_separator(char c, int length)
+{
+	for (int i = 0; i < length; i++) {
+		putchar(c);
+	}
+	putchar('\n');
+}
+
+static void assert_equal_uint32(const char *test_name, uint32_t expected, uint32_t actual)
+{
+	total_tests++;
+	if (expected == actual) {
+		printf("  ✓ %s: %u\n", test_name, actual);
+		passed_tests++;
+	} else {
+		printf("  ✗ %s: expected %u, got %u\n", test_name, expected, actual);
+		failed_tests++;
+	}
+}
+
+static void assert_true(const char *test_name, bool condition)
+{
+	total_tests++;
+	if (condition) {
+		printf("  ✓ %s\n", test_name);
+		passed_tests++;
+	} else {
+		printf("  ✗ %s: assertion failed\n", test_name);
+		failed_tests++;
+	}
+}
+
+/* ============================================================
+ * HELPERS
+ * ============================================================ */
+
+static uint8_t base[IMAGE_SIZE];
+static uint8_t image[IMAGE_SIZE];
+static uint8_t replayed[IMAGE_SIZE];
+static uint8_t journal[JOURNAL_LEN];
+
+static void reset(void)
+{
+	for (int i = 0; i < IMAGE_SIZE; i++) {
+		base[i] = (uint8_t)(i * 7);
+	}
+	memcpy(image, base, sizeof(image));
+	memset(journal, JOURNAL_ERASED_BYTE, sizeof(journal));
+}
+
+/* Replay the journal onto the base image into replayed[] */
+static int boot(size_t *used)
+{
+	memcpy(replayed, base, sizeof(replayed));
+	return config_journal_replay(replayed, sizeof(replayed), journal, sizeof(journal), used);
+}
+
+/* ============================================================
+ * TESTS
+ * ============================================================ */
+
+static void test_crc_and_sizes(void)
+{
+	printf("\nTest: CRC-32 and Record Sizes\n");
+	print_separator('-', 60);
+
+	assert_equal_uint32("CRC-32 check value", 0xCBF43926,
+	                    config_journal_crc32((const uint8_t *)"123456789", 9));
+	assert_equal_uint32("Record header", 8, sizeof(struct config_journal_record));
+	assert_equal_uint32("1 byte record", 12, config_journal_record_size(1));
+	assert_equal_uint32("4 byte record", 12, config_journal_record_size(4));
+	assert_equal_uint32("5 byte record", 16, config_journal_record_size(5));
+	assert_equal_uint32("Largest record", 8 + JOURNAL_RECORD_MAX_DATA,
+	                    config_journal_record_size(JOURNAL_RECORD_MAX_DATA));
+}
+
+static void test_diff(void)
+{
+	printf("\nTest: Diff Into Records\n");
+	print_separator('-', 60);
+
+	uint8_t out[512];
+	size_t used;
+
+	reset();
+	assert_equal_uint32("Equal images: nothing to write", 0,
+	                    config_journal_diff(base, image, IMAGE_SIZE, out, sizeof(out)));
+
+	/* One field (MIDI channel) */
+	image[1] = 9;
+	int len = config_journal_diff(base, image, IMAGE_SIZE, out, sizeof(out));
+	assert_equal_uint32("One byte: one record", 12, len);
+	memcpy(journal, out, len);
+	assert_equal_uint32("Replay applies it", 1, boot(&used));
+	assert_true("Replayed image matches", memcmp(replayed, image, IMAGE_SIZE) == 0);
+	assert_equal_uint32("Next record goes after it", 12, used);
+	assert_true("Padding left erased", out[9] == JOURNAL_ERASED_BYTE && out[11] == JOURNAL_ERASED_BYTE);
+
+	/* Changes a few bytes apart share a record, far apart do not */
+	reset();
+	image[100] ^= 1;
+	image[105] ^= 1;
+	assert_equal_uint32("Gap under 8: one record", 16,
+	                    config_journal_diff(base, image, IMAGE_SIZE, out, sizeof(out)));
+	image[100 + JOURNAL_MERGE_GAP + 5 + 1] ^= 1;
+	assert_equal_uint32("Gap of 8: second record", 16 + 12,
+	                    config_journal_diff(base, image, IMAGE_SIZE, out, sizeof(out)));
+
+	/* A long change is split at JOURNAL_RECORD_MAX_DATA */
+	reset();
+	for (int i = 200; i < 200 + 100; i++) {
+		image[i] ^= 0xA5;
+	}
+	len = config_journal_diff(base, image, IMAGE_SIZE, out, sizeof(out));
+	assert_equal_uint32("100 bytes: 64 + 36", config_journal_record_size(64) +
+	                    config_journal_record_size(36), len);
+	memcpy(journal, out, len);
+	assert_equal_uint32("Two records replayed", 2, boot(&used));
+	assert_true("Long change replayed", memcmp(replayed, image, IMAGE_SIZE) == 0);
+
+	assert_true("No room: -ENOSPC",
+	            config_journal_diff(base, image, IMAGE_SIZE, out, len - 1) == -ENOSPC);
+	assert_true("NULL: -EINVAL", config_journal_diff(NULL, image, IMAGE_SIZE, out, 64) == -EINVAL);
+}
+
+static void test_many_saves(void)
+{
+	printf("\nTest: Setting Changes Until the Journal Is Full\n");
+	print_separator('-', 60);
+
+	uint8_t current[IMAGE_SIZE];
+	uint8_t out[512];
+	size_t pos = 0;
+	int saves = 0;
+	size_t used;
+
+	reset();
+	memcpy(current, base, sizeof(current));
+
+	/* Shell setters: one 2-byte field at a time, cycling through the image */
+	for (;;) {
+		int field = (saves * 37) % (IMAGE_SIZE / 2);
+		image[field * 2] = (uint8_t)(saves + 1);
+		image[field * 2 + 1] = (uint8_t)(saves >> 8);
+
+		int len = config_journal_diff(current, image, IMAGE_SIZE, out, JOURNAL_LEN - pos);
+		if (len < 0) {
+			break;
+		}
+		memcpy(&journal[pos], out, len);
+		pos += len;
+		memcpy(current, image, sizeof(current));
+		saves++;
+	}
+	printf("  %d single-field saves per page erase (was 1)\n", saves);
+	assert_true("Over 200 saves before compaction", saves > 200);
+
+	/* Restore the image of the last save that fit, then boot */
+	assert_equal_uint32("Every save replayed", saves, boot(&used));
+	assert_true("Boot state is the last save", memcmp(replayed, current, IMAGE_SIZE) == 0);
+	assert_equal_uint32("Used bytes", pos, used);
+}
+
+static void test_torn_write(void)
+{
+	printf("\nTest: Power Loss During a Save\n");
+	print_separator('-', 60);
+
+	uint8_t out[512];
+	size_t used;
+
+	reset();
+	image[10] = 1;
+	int first = config_journal_diff(base, image, IMAGE_SIZE, out, sizeof(out));
+	memcpy(journal, out, first);
+
+	uint8_t after_first[IMAGE_SIZE];
+	memcpy(after_first, image, sizeof(after_first));
+	image[500] = 2;
+	int second = config_journal_diff(after_first, image, IMAGE_SIZE, out, sizeof(out));
+
+	/* Header and half the data made it */
+	memcpy(&journal[first], out, second / 2 + 2);
+	journal[first + 8] ^= 0xFF;
+	assert_equal_uint32("Only the complete record applies", 1, boot(&used));
+	assert_true("State of the first save", memcmp(replayed, after_first, IMAGE_SIZE) == 0);
+	assert_equal_uint32("Journal treated as full", JOURNAL_LEN, used);
+
+	/* One save, two records: power lost before the second */
+	reset();
+	image[20] = 3;
+	image[700] = 4;
+	int both = config_journal_diff(base, image, IMAGE_SIZE, out, sizeof(out));
+	assert_equal_uint32("Two records in the save", 24, both);
+	memcpy(journal, out, 12);
+	assert_equal_uint32("Half a save: nothing applied", 0, boot(&used));
+	assert_true("Image untouched", memcmp(replayed, base, IMAGE_SIZE) == 0);
+	assert_equal_uint32("Journal treated as full", JOURNAL_LEN, used);
+	memcpy(journal, out, both);
+	assert_equal_uint32("Whole save: both applied", 2, boot(&used));
+
+	/* Record pointing outside the image */
+	reset();
+	struct config_journal_record rec = {.offset = IMAGE_SIZE - 2, .len = 4};
+	memcpy(journal, &rec, sizeof(rec));
+	assert_equal_uint32("Out of range: ignored", 0, boot(&used));
+	assert_true("Image untouched", memcmp(replayed, base, IMAGE_SIZE) == 0);
+
+	/* Empty journal */
+	reset();
+	assert_equal_uint32("Erased journal: no records", 0, boot(&used));
+	assert_equal_uint32("Nothing used", 0, used);
+}
+
+int main(void)
+{
+	printf("\n");
+	print_separator('=', 60);
+	printf("CONFIG JOURNAL TESTS\n");
+	print_separator('=', 60);
+
+	test_crc_and_sizes();
+	test_diff();
+	test_many_saves();
+	test_torn_write();
+
+	printf("\n");
+	print_separator('=', 60);
+	printf("TEST SUMMARY\n");
+	print_separator('=', 60);
+	printf("Total tests:  %d\n", total_tests);
+	printf("Passed:       %d\n", passed_tests);
+	printf("Failed:       %d\n", failed_tests);
+	printf("Success rate: %.1f%%\n",
+	       total_tests > 0 ? (100.0 * passed_tests / total_tests) : 0.0);
+	print_separator('=', 60);
+
+	return (failed_tests == 0) ? 0 : 1;
+}
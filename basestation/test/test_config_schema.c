@@ -0,0 +1,344 @@
+/*
+ * Config Schema Unit Tests
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+
+#include "../src/config_schema.h"
+
+/* Test statistics */
+static int total_tests = 0;
+static int passed_tests = 0;
+static int failed_tests = 0;
+
+/* Test utilities */
+static void print_separator(char c, int length)
+{
+	for (int i = 0; i < length; i++) {
+		putchar(c);
+	}
+	putchar('\n');
+}
+
+static void assert_equal_int(const char *test_name, int expected, int actual)
+{
+	total_tests++;
+	if (expected == actual) {
+		printf("  ✓ %s: %d\n", test_name, actual);
+		passed_tests++;
+	} else {
+		printf("  ✗ %s: expected %d, got %d\n", test_name, expected, actual);
+		failed_tests++;
+	}
+}
+
+static void assert_true(const char *test_name, bool condition)
+{
+	total_tests++;
+	if (condition) {
+		printf("  ✓ %s\n", test_name);
+		passed_tests++;
+	} else {
+		printf("  ✗ %s: assertion failed\n", test_name);
+		failed_tests++;
+	}
+}
+
+/* ============================================================
+ * SYNTHETIC LAYOUTS
+ *
+ * v1: channel, trim (int8), legacy flag, 2 patches of {name[8]}
+ * v2: trim widened to int16, legacy dropped, 3 patches of
+ *     {name[8], level}
+ * v3: trim renamed to offset and now in tenths (upgrade hook)
+ * ============================================================ */
+
+struct v1 {
+	uint8_t channel;
+	int8_t trim;
+	uint8_t legacy;
+	char names[2][8];
+	uint8_t reserved[3];
+} __attribute__((packed));
+
+struct v2_patch {
+	char name[8];
+	uint8_t level;
+} __attribute__((packed));
+
+struct v2 {
+	uint8_t channel;
+	int16_t trim;
+	struct v2_patch patches[3];
+	uint8_t reserved[2];
+} __attribute__((packed));
+
+struct v3 {
+	uint8_t channel;
+	int16_t offset;
+	struct v2_patch patches[3];
+	uint8_t reserved[2];
+} __attribute__((packed));
+
+#define FIELD(n, k, type, member, c, s) \
+	{ .name = n, .kind = k, .offset = offsetof(type, member), \
+	  .size = sizeof(((type *)0)->member), .count = c, .stride = s }
+
+static const struct config_field v1_fields[] = {
+	FIELD("channel", CONFIG_FIELD_UINT, struct v1, channel, 1, 0),
+	FIELD("trim", CONFIG_FIELD_INT, struct v1, trim, 1, 0),
+	FIELD("legacy", CONFIG_FIELD_UINT, struct v1, legacy, 1, 0),
+	FIELD("patch.name", CONFIG_FIELD_BYTES, struct v1, names[0], 2, 8),
+};
+
+static const struct config_field v2_fields[] = {
+	FIELD("channel", CONFIG_FIELD_UINT, struct v2, channel, 1, 0),
+	FIELD("trim", CONFIG_FIELD_INT, struct v2, trim, 1, 0),
+	FIELD("patch.name", CONFIG_FIELD_BYTES, struct v2, patches[0].name, 3, sizeof(struct v2_patch)),
+	FIELD("patch.level", CONFIG_FIELD_UINT, struct v2, patches[0].level, 3, sizeof(struct v2_patch)),
+};
+
+static const struct config_field v3_fields[] = {
+	FIELD("channel", CONFIG_FIELD_UINT, struct v3, channel, 1, 0),
+	FIELD("offset", CONFIG_FIELD_INT, struct v3, offset, 1, 0),
+	FIELD("patch.name", CONFIG_FIELD_BYTES, struct v3, patches[0].name, 3, sizeof(struct v2_patch)),
+	FIELD("patch.level", CONFIG_FIELD_UINT, struct v3, patches[0].level, 3, sizeof(struct v2_patch)),
+};
+
+static int upgrade_v3_calls;
+
+/* trim (units) -> offset (tenths) */
+static void upgrade_v3(uint8_t *data, const struct config_schema *schema,
+		       const uint8_t *old, const struct config_schema *old_schema)
+{
+	const struct config_field *trim = config_schema_field(old_schema, "trim");
+	const struct config_field *offset = config_schema_field(schema, "offset");
+	int16_t value;
+
+	upgrade_v3_calls++;
+	if (!trim || !offset) {
+		return;
+	}
+	value = (trim->size == 1) ? (int8_t)old[trim->offset]
+	                          : (int16_t)(old[trim->offset] | (old[trim->offset + 1] << 8));
+	value *= 10;
+	memcpy(data + offset->offset, &value, sizeof(value));
+}
+
+static const struct config_schema registry[] = {
+	{ 1, sizeof(struct v1), v1_fields, 4, NULL },
+	{ 2, sizeof(struct v2), v2_fields, 4, NULL },
+	{ 3, sizeof(struct v3), v3_fields, 4, upgrade_v3 },
+};
+
+#define REGISTRY_SIZE (sizeof(registry) / sizeof(registry[0]))
+
+static void v3_defaults(struct v3 *d)
+{
+	memset(d, 0, sizeof(*d));
+	d->channel = 1;
+	d->offset = 7;
+	for (int i = 0; i < 3; i++) {
+		strcpy(d->patches[i].name, "Init");
+		d->patches[i].level = 100;
+	}
+}
+
+/* ============================================================
+ * TESTS
+ * ============================================================ */
+
+static void test_check(void)
+{
+	printf("\nTest: Schema Checks\n");
+	print_separator('-', 60);
+
+	assert_equal_int("Registry valid", 0, config_schema_check_registry(registry, REGISTRY_SIZE));
+	assert_true("Find v2", config_schema_find(registry, REGISTRY_SIZE, 2) == &registry[1]);
+	assert_true("Unknown version", config_schema_find(registry, REGISTRY_SIZE, 9) == NULL);
+	assert_true("Field by name", config_schema_field(&registry[1], "patch.level") == &v2_fields[3]);
+	assert_true("Missing field", config_schema_field(&registry[0], "patch.level") == NULL);
+
+	struct config_field bad[2] = { v2_fields[0], v2_fields[2] };
+	struct config_schema s = { 1, sizeof(struct v2), bad, 2, NULL };
+	assert_equal_int("Two valid fields", 0, config_schema_check(&s));
+
+	bad[1].stride = 4;
+	assert_equal_int("Repetitions overlap", -EINVAL, config_schema_check(&s));
+	bad[1] = v2_fields[2];
+	bad[1].count = 4;
+	assert_equal_int("Past the end of the image", -EINVAL, config_schema_check(&s));
+	bad[1] = v2_fields[0];
+	assert_equal_int("Duplicate name", -EINVAL, config_schema_check(&s));
+	bad[1] = v2_fields[2];
+	bad[1].kind = CONFIG_FIELD_INT;
+	assert_equal_int("8-byte integer", -EINVAL, config_schema_check(&s));
+	bad[1] = v2_fields[2];
+	bad[1].name = "patch name";
+	assert_equal_int("Space in name", -EINVAL, config_schema_check(&s));
+
+	struct config_schema unordered[2] = { registry[1], registry[0] };
+	assert_equal_int("Versions must increase", -EINVAL, config_schema_check_registry(unordered, 2));
+}
+
+static void test_migrate(void)
+{
+	printf("\nTest: Migrate v1 -> v3\n");
+	print_separator('-', 60);
+
+	struct v1 old = {0};
+	struct v3 out;
+
+	old.channel = 9;
+	old.trim = -5;
+	old.legacy = 1;
+	strcpy(old.names[0], "Lead");
+	strcpy(old.names[1], "Rhythm");
+	memset(old.reserved, 0xEE, sizeof(old.reserved));
+
+	v3_defaults(&out);
+	upgrade_v3_calls = 0;
+	assert_equal_int("Migrate", 0, config_schema_migrate(registry, REGISTRY_SIZE, 1,
+	                 (const uint8_t *)&old, sizeof(old), (uint8_t *)&out, sizeof(out)));
+	assert_equal_int("Channel kept", 9, out.channel);
+	assert_equal_int("Hook converted trim to tenths", -50, out.offset);
+	assert_equal_int("Hook ran once", 1, upgrade_v3_calls);
+	assert_true("Patch names kept", strcmp(out.patches[0].name, "Lead") == 0 &&
+	            strcmp(out.patches[1].name, "Rhythm") == 0);
+	assert_true("New patch gets defaults", strcmp(out.patches[2].name, "Init") == 0);
+	assert_equal_int("New field gets defaults", 100, out.patches[0].level);
+	assert_true("Reserved bytes not carried over", out.reserved[0] == 0 && out.reserved[1] == 0);
+
+	printf("\nTest: Migrate v2 -> v3 and Same Version\n");
+	print_separator('-', 60);
+
+	struct v2 mid = {0};
+	mid.channel = 3;
+	mid.trim = 1200;
+	mid.patches[2].level = 42;
+	strcpy(mid.patches[2].name, "Solo");
+
+	v3_defaults(&out);
+	upgrade_v3_calls = 0;
+	config_schema_migrate(registry, REGISTRY_SIZE, 2, (const uint8_t *)&mid, sizeof(mid),
+	                      (uint8_t *)&out, sizeof(out));
+	assert_equal_int("Int16 trim through the hook", 12000, out.offset);
+	assert_equal_int("Third patch level", 42, out.patches[2].level);
+	assert_true("Third patch name", strcmp(out.patches[2].name, "Solo") == 0);
+
+	struct v3 same, copy;
+	v3_defaults(&same);
+	same.offset = -3;
+	memset(&copy, 0xAA, sizeof(copy));
+	assert_equal_int("Current version", 0, config_schema_migrate(registry, REGISTRY_SIZE, 3,
+	                 (const uint8_t *)&same, sizeof(same), (uint8_t *)&copy, sizeof(copy)));
+	assert_true("Current version copied unchanged", memcmp(&same, &copy, sizeof(same)) == 0);
+}
+
+static void test_integers(void)
+{
+	printf("\nTest: Integer Widths\n");
+	print_separator('-', 60);
+
+	/* Same name, different widths and signedness */
+	uint8_t src[8] = {0};
+	uint8_t dst[8] = {0};
+	struct config_field from = { "x", CONFIG_FIELD_INT, 0, 2, 1, 0 };
+	struct config_field to = { "x", CONFIG_FIELD_INT, 0, 1, 1, 0 };
+	struct config_schema sf = { 1, 8, &from, 1, NULL };
+	struct config_schema st = { 2, 8, &to, 1, NULL };
+	int16_t v16;
+
+	v16 = -300;
+	memcpy(src, &v16, 2);
+	config_schema_copy_fields(&sf, src, &st, dst);
+	assert_equal_int("int16 -300 -> int8 clamps", -128, (int8_t)dst[0]);
+
+	v16 = 77;
+	memcpy(src, &v16, 2);
+	config_schema_copy_fields(&sf, src, &st, dst);
+	assert_equal_int("int16 77 -> int8", 77, (int8_t)dst[0]);
+
+	to.kind = CONFIG_FIELD_UINT;
+	v16 = -1;
+	memcpy(src, &v16, 2);
+	config_schema_copy_fields(&sf, src, &st, dst);
+	assert_equal_int("Negative -> uint8 clamps to 0", 0, dst[0]);
+
+	from.kind = CONFIG_FIELD_UINT;
+	from.size = 1;
+	to.kind = CONFIG_FIELD_INT;
+	to.size = 4;
+	src[0] = 200;
+	config_schema_copy_fields(&sf, src, &st, dst);
+	int32_t v32;
+	memcpy(&v32, dst, 4);
+	assert_equal_int("uint8 200 -> int32 zero-extended", 200, v32);
+
+	from.kind = CONFIG_FIELD_INT;
+	config_schema_copy_fields(&sf, src, &st, dst);
+	memcpy(&v32, dst, 4);
+	assert_equal_int("int8 200 (-56) -> int32 sign-extended", -56, v32);
+}
+
+static void test_errors(void)
+{
+	printf("\nTest: Errors and Formatting\n");
+	print_separator('-', 60);
+
+	uint8_t src[64] = {0};
+	uint8_t dst[64] = {0};
+	char line[CONFIG_SCHEMA_LINE_MAX];
+
+	assert_equal_int("Unknown old version", -ENOENT,
+	                 config_schema_migrate(registry, REGISTRY_SIZE, 0, src, sizeof(struct v1),
+	                                       dst, sizeof(struct v3)));
+	assert_equal_int("Newer than firmware", -ENOTSUP,
+	                 config_schema_migrate(registry, REGISTRY_SIZE, 4, src, sizeof(struct v1),
+	                                       dst, sizeof(struct v3)));
+	assert_equal_int("Source size mismatch", -EINVAL,
+	                 config_schema_migrate(registry, REGISTRY_SIZE, 1, src, sizeof(struct v1) + 4,
+	                                       dst, sizeof(struct v3)));
+	assert_equal_int("Destination size mismatch", -EINVAL,
+	                 config_schema_migrate(registry, REGISTRY_SIZE, 1, src, sizeof(struct v1),
+	                                       dst, sizeof(struct v3) - 1));
+
+	assert_true("Format field", config_schema_format_field(&v2_fields[3], line, sizeof(line)) > 0 &&
+	            strcmp(line, "CFGFIELD patch.level uint 11 1 3 9") == 0);
+	assert_equal_int("Format into a short buffer", -1,
+	                 config_schema_format_field(&v2_fields[3], line, 10));
+}
+
+int main(void)
+{
+	printf("\n");
+	print_separator('=', 60);
+	printf("CONFIG SCHEMA TESTS\n");
+	print_separator('=', 60);
+
+	test_check();
+	test_migrate();
+	test_integers();
+	test_errors();
+
+	printf("\n");
+	print_separator('=', 60);
+	printf("TEST SUMMARY\n");
+	print_separator('=', 60);
+	printf("Total tests:  %d\n", total_tests);
+	printf("Passed:       %d\n", passed_tests);
+	printf("Failed:       %d\n", failed_tests);
+	printf("Success rate: %.1f%%\n",
+	       total_tests > 0 ? (100.0 * passed_tests / total_tests) : 0.0);
+	print_separator('=', 60);
+
+	return (failed_tests == 0) ? 0 : 1;
+}
@@ -0,0 +1,253 @@
+/*
+ * Config Snapshot Unit Tests
+ *
+ * Tests publish/acquire/release, slot reuse only after the last reader
+ * releases, the busy case, and a threaded stress run in which readers
+ * check that every snapshot they hold is one whole published config.
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+
+#include "../src/config_snapshot.h"
+
+#define SNAP_SIZE   1104         /* sizeof(struct config_data) on the target */
+#define SNAP_SLOTS  4            /* As in config_storage.c */
+
+/* Test statistics */
+static int total_tests = 0;
+static int passed_tests = 0;
+static int failed_tests = 0;
+
+/* Test utilities */
+static void print_separator(char c, int length)
+{
+	for (int i = 0; i < length; i++) {
+		putchar(c);
+	}
+	putchar('\n');
+}
+
+static void assert_equal_int(const char *test_name, int expected, int actual)
+{
+	total_tests++;
+	if (expected == actual) {
+		printf("  ✓ %s: %d\n", test_name, actual);
+		passed_tests++;
+	} else {
+		printf("  ✗ %s: expected %d, got %d\n", test_name, expected, actual);
+		failed_tests++;
+	}
+}
+
+static void assert_true(const char *test_name, bool condition)
+{
+	total_tests++;
+	if (condition) {
+		printf("  ✓ %s\n", test_name);
+		passed_tests++;
+	} else {
+		printf("  ✗ %s: assertion failed\n", test_name);
+		failed_tests++;
+	}
+}
+
+/* ============================================================
+ * FIXTURE
+ * ============================================================ */
+
+static uint8_t buffers[SNAP_SLOTS][SNAP_SIZE];
+static struct config_snapshot_pool pool;
+
+/* Every byte holds the same value, so a torn snapshot is easy to spot */
+static void publish_value(uint8_t value)
+{
+	uint8_t *buf = config_snapshot_prepare(&pool);
+
+	if (buf) {
+		memset(buf, value, SNAP_SIZE);
+		config_snapshot_publish(&pool, buf);
+	}
+}
+
+static bool uniform(const uint8_t *data)
+{
+	for (size_t i = 1; i < SNAP_SIZE; i++) {
+		if (data[i] != data[0]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/* ============================================================
+ * TESTS
+ * ============================================================ */
+
+static void test_publish_and_acquire(void)
+{
+	printf("\nTest: Publish, Acquire, Release\n");
+	print_separator('-', 60);
+
+	assert_equal_int("Too few slots rejected", -EINVAL,
+			 config_snapshot_init(&pool, buffers, SNAP_SIZE, 1));
+	assert_equal_int("Init", 0, config_snapshot_init(&pool, buffers, SNAP_SIZE, SNAP_SLOTS));
+	assert_true("Nothing published yet", config_snapshot_acquire(&pool) == NULL);
+
+	publish_value(1);
+	const uint8_t *a = config_snapshot_acquire(&pool);
+	assert_true("First snapshot", a && a[0] == 1);
+	assert_equal_int("Generation 1", 1, (int)config_snapshot_generation(&pool, a));
+
+	const uint8_t *a2 = config_snapshot_acquire(&pool);
+	assert_true("Same slot, no copy", a2 == a);
+	assert_equal_int("One slot in use", 1, config_snapshot_in_use(&pool));
+
+	publish_value(2);
+	assert_true("Old reader keeps its data", a[0] == 1 && uniform(a));
+	const uint8_t *b = config_snapshot_acquire(&pool);
+	assert_true("New reader sees the new config", b != a && b[0] == 2);
+	assert_equal_int("Generation 2", 2, (int)config_snapshot_generation(&pool, b));
+
+	config_snapshot_release(&pool, a);
+	config_snapshot_release(&pool, a2);
+	config_snapshot_release(&pool, b);
+	config_snapshot_release(&pool, NULL);
+	assert_equal_int("All released", 0, config_snapshot_in_use(&pool));
+}
+
+static void test_slot_reuse(void)
+{
+	printf("\nTest: Slots Reused Only When Released\n");
+	print_separator('-', 60);
+
+	config_snapshot_init(&pool, buffers, SNAP_SIZE, SNAP_SLOTS);
+	const uint8_t *held[SNAP_SLOTS];
+
+	/* Hold every published snapshot: each publish needs a new slot */
+	for (int i = 0; i < SNAP_SLOTS; i++) {
+		publish_value((uint8_t)(10 + i));
+		held[i] = config_snapshot_acquire(&pool);
+	}
+	assert_equal_int("Every slot held", SNAP_SLOTS, config_snapshot_in_use(&pool));
+	assert_true("No slot to prepare", config_snapshot_prepare(&pool) == NULL);
+	assert_equal_int("Busy counted", 1, (int)pool.busy);
+
+	bool intact = true;
+	for (int i = 0; i < SNAP_SLOTS; i++) {
+		intact &= held[i][0] == 10 + i && uniform(held[i]);
+	}
+	assert_true("Every held snapshot intact", intact);
+
+	/* Releasing the current one frees nothing: it is still current */
+	config_snapshot_release(&pool, held[SNAP_SLOTS - 1]);
+	assert_true("Current slot is never prepared", config_snapshot_prepare(&pool) == NULL);
+
+	config_snapshot_release(&pool, held[0]);
+	uint8_t *buf = config_snapshot_prepare(&pool);
+	assert_true("Released old slot reused", buf == (const uint8_t *)held[0]);
+	for (int i = 1; i < SNAP_SLOTS - 1; i++) {
+		config_snapshot_release(&pool, held[i]);
+	}
+}
+
+/* Threaded stress: readers verify every snapshot while the writer publishes */
+#define STRESS_READERS   3
+#define STRESS_PUBLISHES 20000
+
+static atomic_bool stress_done;
+static atomic_int stress_torn;
+static atomic_int stress_reads;
+
+static void *stress_reader(void *arg)
+{
+	(void)arg;
+
+	while (!atomic_load(&stress_done)) {
+		const uint8_t *cfg = config_snapshot_acquire(&pool);
+
+		if (!cfg) {
+			continue;
+		}
+		/* Read it in place while the writer keeps publishing */
+		if (!uniform(cfg)) {
+			atomic_fetch_add(&stress_torn, 1);
+		}
+		config_snapshot_release(&pool, cfg);
+		atomic_fetch_add(&stress_reads, 1);
+	}
+	return NULL;
+}
+
+static void test_concurrent_readers(void)
+{
+	printf("\nTest: Concurrent Readers During Publishes\n");
+	print_separator('-', 60);
+
+	pthread_t readers[STRESS_READERS];
+	int published = 0;
+
+	config_snapshot_init(&pool, buffers, SNAP_SIZE, SNAP_SLOTS);
+	publish_value(0);
+	atomic_store(&stress_done, false);
+	atomic_store(&stress_torn, 0);
+	atomic_store(&stress_reads, 0);
+
+	for (int i = 0; i < STRESS_READERS; i++) {
+		pthread_create(&readers[i], NULL, stress_reader, NULL);
+	}
+	for (int i = 1; i <= STRESS_PUBLISHES; i++) {
+		uint8_t *buf = config_snapshot_prepare(&pool);
+
+		if (!buf) {
+			continue;
+		}
+		memset(buf, (uint8_t)i, SNAP_SIZE);
+		config_snapshot_publish(&pool, buf);
+		published++;
+	}
+	atomic_store(&stress_done, true);
+	for (int i = 0; i < STRESS_READERS; i++) {
+		pthread_join(readers[i], NULL);
+	}
+
+	printf("  %d publishes, %d reads, %u busy\n", published, atomic_load(&stress_reads),
+	       pool.busy);
+	assert_equal_int("No torn snapshot seen", 0, atomic_load(&stress_torn));
+	assert_true("Readers ran", atomic_load(&stress_reads) > 0);
+	assert_true("Most publishes found a slot", published > STRESS_PUBLISHES / 2);
+	assert_equal_int("All released at the end", 0, config_snapshot_in_use(&pool));
+}
+
+int main(void)
+{
+	printf("\n");
+	print_separator('=', 60);
+	printf("CONFIG SNAPSHOT TESTS\n");
+	print_separator('=', 60);
+
+	test_publish_and_acquire();
+	test_slot_reuse();
+	test_concurrent_readers();
+
+	printf("\n");
+	print_separator('=', 60);
+	printf("TEST SUMMARY\n");
+	print_separator('=', 60);
+	printf("Total tests:  %d\n", total_tests);
+	printf("Passed:       %d\n", passed_tests);
+	printf("Failed:       %d\n", failed_tests);
+	printf("Success rate: %.1f%%\n",
+	       total_tests > 0 ? (100.0 * passed_tests / total_tests) : 0.0);
+	print_separator('=', 60);
+
+	return (failed_tests == 0) ? 0 : 1;
+}
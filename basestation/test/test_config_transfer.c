@@ -0,0 +1,264 @@
+/*
+ * Config Transfer Unit Tests
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+
+#include "../src/config_transfer.h"
+#include "../src/config_journal.h"
+
+#define IMAGE_SIZE    1104   /* sizeof(struct config_data) on the firmware */
+#define ODD_SIZE      1100   /* Last chunk shorter than XFER_CHUNK_SIZE */
+
+/* Test statistics */
+static int total_tests = 0;
+static int passed_tests = 0;
+static int failed_tests = 0;
+
+/* Test utilities */
+static void print_separator(char c, int length)
+{
+	for (int i = 0; i < length; i++) {
+		putchar(c);
+	}
+	putchar('\n');
+}
+
+static void assert_equal_uint32(const char *test_name, uint32_t expected, uint32_t actual)
+{
+	total_tests++;
+	if (expected == actual) {
+		printf("  ✓ %s: %u\n", test_name, actual);
+		passed_tests++;
+	} else {
+		printf("  ✗ %s: expected %u, got %u\n", test_name, expected, actual);
+		failed_tests++;
+	}
+}
+
+static void assert_true(const char *test_name, bool condition)
+{
+	total_tests++;
+	if (condition) {
+		printf("  ✓ %s\n", test_name);
+		passed_tests++;
+	} else {
+		printf("  ✗ %s: assertion failed\n", test_name);
+		failed_tests++;
+	}
+}
+
+/* ============================================================
+ * HELPERS
+ * ============================================================ */
+
+static uint8_t source[IMAGE_SIZE];
+static uint8_t dest[IMAGE_SIZE];
+static const uint8_t sha_a[XFER_SHA256_SIZE] = {0xAA};
+static const uint8_t sha_b[XFER_SHA256_SIZE] = {0xBB};
+
+static void fill_source(void)
+{
+	for (int i = 0; i < IMAGE_SIZE; i++) {
+		source[i] = (uint8_t)(i * 31 + 7);
+	}
+	memset(dest, 0, sizeof(dest));
+}
+
+/* Parse a formatted chunk line and feed it to the receiver, as the shell does */
+static int send_line(struct config_xfer *xfer, char *line)
+{
+	char *offset = strtok(line, " ");
+	char *b64 = strtok(NULL, " ");
+	char *crc = strtok(NULL, " ");
+
+	if (!offset || !b64 || !crc) {
+		return -EINVAL;
+	}
+	return config_xfer_put(xfer, strtoul(offset, NULL, 10), b64, strtoul(crc, NULL, 16));
+}
+
+static int send_chunk(struct config_xfer *xfer, size_t size, uint32_t offset)
+{
+	char line[XFER_LINE_MAX];
+
+	if (config_xfer_format_chunk(source, size, offset, line, sizeof(line)) < 0) {
+		return -EINVAL;
+	}
+	return send_line(xfer, line);
+}
+
+/* ============================================================
+ * TESTS
+ * ============================================================ */
+
+static void test_encoding(void)
+{
+	printf("\nTest: Base64 and Hex\n");
+	print_separator('-', 60);
+
+	char out[16];
+	uint8_t bytes[16];
+
+	/* RFC 4648 test vectors */
+	config_xfer_base64_encode((const uint8_t *)"f", 1, out, sizeof(out));
+	assert_true("\"f\" -> Zg==", strcmp(out, "Zg==") == 0);
+	config_xfer_base64_encode((const uint8_t *)"fo", 2, out, sizeof(out));
+	assert_true("\"fo\" -> Zm8=", strcmp(out, "Zm8=") == 0);
+	assert_equal_uint32("\"foobar\" length", 8,
+	                    config_xfer_base64_encode((const uint8_t *)"foobar", 6, out, sizeof(out)));
+	assert_true("\"foobar\" -> Zm9vYmFy", strcmp(out, "Zm9vYmFy") == 0);
+	assert_equal_uint32("Output too small", 0,
+	                    config_xfer_base64_encode((const uint8_t *)"foobar", 6, out, 8));
+
+	assert_equal_uint32("Decode Zm9vYmE=", 5, config_xfer_base64_decode("Zm9vYmE=", bytes, sizeof(bytes)));
+	assert_true("Decoded bytes", memcmp(bytes, "fooba", 5) == 0);
+	assert_equal_uint32("Decode Zg==", 1, config_xfer_base64_decode("Zg==", bytes, sizeof(bytes)));
+	assert_true("Bad character", config_xfer_base64_decode("Zm9*", bytes, sizeof(bytes)) == -EINVAL);
+	assert_true("Bad length", config_xfer_base64_decode("Zm9", bytes, sizeof(bytes)) == -EINVAL);
+	assert_true("Padding mid-string", config_xfer_base64_decode("Zg==Zm9v", bytes, sizeof(bytes)) == -EINVAL);
+	assert_true("Data after padding", config_xfer_base64_decode("Zm=v", bytes, sizeof(bytes)) == -EINVAL);
+	assert_true("No room", config_xfer_base64_decode("Zm9vYmFy", bytes, 5) == -ENOSPC);
+
+	uint8_t hash[4] = {0x01, 0xAB, 0xcd, 0xFF};
+	char hex[9];
+	config_xfer_hex_encode(hash, sizeof(hash), hex);
+	assert_true("Hex encode", strcmp(hex, "01abcdff") == 0);
+	assert_true("Hex decode (upper case)", config_xfer_hex_decode("01ABCDFF", bytes, 4) == 0 &&
+	            memcmp(bytes, hash, 4) == 0);
+	assert_true("Hex wrong length", config_xfer_hex_decode("01abcd", bytes, 4) == -EINVAL);
+	assert_true("Hex bad digit", config_xfer_hex_decode("01abcdfg", bytes, 4) == -EINVAL);
+}
+
+static void test_round_trip(void)
+{
+	printf("\nTest: Dump and Import a Whole Image\n");
+	print_separator('-', 60);
+
+	struct config_xfer xfer = {0};
+	char line[XFER_LINE_MAX];
+	size_t wire = 0;
+	int max_line = 0;
+	bool ok = true;
+
+	fill_source();
+	assert_equal_uint32("Begin", 0, config_xfer_begin(&xfer, dest, IMAGE_SIZE, sha_a));
+	assert_equal_uint32("Chunks", (IMAGE_SIZE + XFER_CHUNK_SIZE - 1) / XFER_CHUNK_SIZE, xfer.chunks);
+	assert_equal_uint32("Nothing received yet", 0, config_xfer_next_missing(&xfer));
+
+	for (uint32_t offset = 0; offset < IMAGE_SIZE; offset += XFER_CHUNK_SIZE) {
+		int n = config_xfer_format_chunk(source, IMAGE_SIZE, offset, line, sizeof(line));
+		if (n > max_line) {
+			max_line = n;
+		}
+		wire += strlen("config bin put ") + n + 2;
+		ok &= (send_line(&xfer, line) == 0);
+	}
+	assert_true("Every chunk accepted", ok);
+	assert_equal_uint32("Complete", IMAGE_SIZE, config_xfer_next_missing(&xfer));
+	assert_true("Image identical", memcmp(source, dest, IMAGE_SIZE) == 0);
+	assert_true("Lines fit XFER_LINE_MAX", max_line < XFER_LINE_MAX);
+
+	/* 10 bits per byte at 115200 baud */
+	unsigned int ms = (unsigned int)(wire * 10 * 1000 / 115200);
+	printf("  %zu bytes on the wire for a %d byte image: %u ms at 115200 baud\n",
+	       wire, IMAGE_SIZE, ms);
+	assert_true("Import under 250 ms of line time", ms < 250);
+
+	/* Short last chunk */
+	fill_source();
+	config_xfer_begin(&xfer, dest, ODD_SIZE, sha_b);
+	ok = true;
+	for (uint32_t offset = 0; offset < ODD_SIZE; offset += XFER_CHUNK_SIZE) {
+		ok &= (send_chunk(&xfer, ODD_SIZE, offset) == 0);
+	}
+	assert_true("Odd size accepted", ok);
+	assert_true("Odd size identical", memcmp(source, dest, ODD_SIZE) == 0);
+	assert_equal_uint32("Odd size complete", ODD_SIZE, config_xfer_next_missing(&xfer));
+}
+
+static void test_errors_and_resume(void)
+{
+	printf("\nTest: Bad Chunks and Resume\n");
+	print_separator('-', 60);
+
+	struct config_xfer xfer = {0};
+	char line[XFER_LINE_MAX];
+
+	fill_source();
+	assert_true("Put before begin", send_chunk(&xfer, IMAGE_SIZE, 0) == -EINVAL);
+	config_xfer_begin(&xfer, dest, IMAGE_SIZE, sha_a);
+
+	/* Corrupted on the wire: CRC catches it, chunk stays missing */
+	config_xfer_format_chunk(source, IMAGE_SIZE, 0, line, sizeof(line));
+	line[10] = (line[10] == 'A') ? 'B' : 'A';
+	assert_true("Flipped character: -EBADMSG", send_line(&xfer, line) == -EBADMSG);
+	assert_equal_uint32("Still missing", 0, config_xfer_next_missing(&xfer));
+
+	/* Wrong offset or length */
+	assert_true("Unaligned offset", config_xfer_put(&xfer, 5, "Zm9v", 0) == -EINVAL);
+	assert_true("Offset past end", config_xfer_put(&xfer, IMAGE_SIZE, "Zm9v", 0) == -EINVAL);
+	assert_true("Short chunk", config_xfer_put(&xfer, 0, "Zm9v",
+	            config_journal_crc32((const uint8_t *)"foo", 3)) == -EINVAL);
+
+	/* Link dropped after chunk 0..4, with chunk 7 arriving out of order */
+	for (uint32_t c = 0; c < 5; c++) {
+		send_chunk(&xfer, IMAGE_SIZE, c * XFER_CHUNK_SIZE);
+	}
+	send_chunk(&xfer, IMAGE_SIZE, 7 * XFER_CHUNK_SIZE);
+	assert_equal_uint32("Next missing after gap", 5 * XFER_CHUNK_SIZE, config_xfer_next_missing(&xfer));
+
+	/* Sender reconnects and announces the same image: progress kept */
+	assert_equal_uint32("Same image resumes", 1, config_xfer_begin(&xfer, dest, IMAGE_SIZE, sha_a));
+	assert_equal_uint32("Chunks kept", 6, xfer.received_count);
+	send_chunk(&xfer, IMAGE_SIZE, 0);
+	assert_equal_uint32("Duplicate not counted twice", 6, xfer.received_count);
+	for (int next; (next = config_xfer_next_missing(&xfer)) < IMAGE_SIZE;) {
+		if (send_chunk(&xfer, IMAGE_SIZE, (uint32_t)next) != 0) {
+			break;
+		}
+	}
+	assert_equal_uint32("Completed after resume", IMAGE_SIZE, config_xfer_next_missing(&xfer));
+	assert_true("Image identical", memcmp(source, dest, IMAGE_SIZE) == 0);
+
+	/* A different image starts over */
+	assert_equal_uint32("New hash restarts", 0, config_xfer_begin(&xfer, dest, IMAGE_SIZE, sha_b));
+	assert_equal_uint32("Nothing kept", 0, xfer.received_count);
+
+	config_xfer_abort(&xfer);
+	assert_true("Abort ends the transfer", config_xfer_next_missing(&xfer) == -EINVAL);
+	assert_true("Oversize image", config_xfer_begin(&xfer, dest, XFER_MAX_SIZE + 1, sha_a) == -EINVAL);
+}
+
+int main(void)
+{
+	printf("\n");
+	print_separator('=', 60);
+	printf("CONFIG TRANSFER TESTS\n");
+	print_separator('=', 60);
+
+	test_encoding();
+	test_round_trip();
+	test_errors_and_resume();
+
+	printf("\n");
+	print_separator('=', 60);
+	printf("TEST SUMMARY\n");
+	print_separator('=', 60);
+	printf("Total tests:  %d\n", total_tests);
+	printf("Passed:       %d\n", passed_tests);
+	printf("Failed:       %d\n", failed_tests);
+	printf("Success rate: %.1f%%\n",
+	       total_tests > 0 ? (100.0 * passed_tests / total_tests) : 0.0);
+	print_separator('=', 60);
+
+	return (failed_tests == 0) ? 0 : 1;
+}
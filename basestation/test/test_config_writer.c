@@ -0,0 +1,225 @@
+/*
+ * Config Writer Queue Unit Tests
+ *
+ * Tests request coalescing, completion callbacks and the state shown by
+ * 'status', driven the way the writer thread in config_storage.c does:
+ * begin, commit, end, notify.
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+
+#include "../src/config_writer.h"
+
+/* Test statistics */
+static int total_tests = 0;
+static int passed_tests = 0;
+static int failed_tests = 0;
+
+/* Test utilities */
+static void print_separator(char c, int length)
+{
+	for (int i = 0; i < length; i++) {
+		putchar(c);
+	}
+	putchar('\n');
+}
+
+static void assert_equal_int(const char *test_name, int expected, int actual)
+{
+	total_tests++;
+	if (expected == actual) {
+		printf("  ✓ %s: %d\n", test_name, actual);
+		passed_tests++;
+	} else {
+		printf("  ✗ %s: expected %d, got %d\n", test_name, expected, actual);
+		failed_tests++;
+	}
+}
+
+static void assert_true(const char *test_name, bool condition)
+{
+	total_tests++;
+	if (condition) {
+		printf("  ✓ %s\n", test_name);
+		passed_tests++;
+	} else {
+		printf("  ✗ %s: assertion failed\n", test_name);
+		failed_tests++;
+	}
+}
+
+/* ============================================================
+ * FIXTURE
+ * ============================================================ */
+
+struct done_record {
+	int calls;
+	int result;
+};
+
+static void on_done(int result, void *user_data)
+{
+	struct done_record *rec = user_data;
+
+	rec->calls++;
+	rec->result = result;
+}
+
+/* Writer whose callback saves again, like a shell command chaining saves */
+static struct config_writer *chained_writer;
+static struct done_record chained_rec;
+
+static void on_done_save_again(int result, void *user_data)
+{
+	on_done(result, user_data);
+	config_writer_request(chained_writer, on_done, &chained_rec);
+}
+
+/* ============================================================
+ * TESTS
+ * ============================================================ */
+
+static void test_coalescing(void)
+{
+	printf("\nTest: Requests Coalesce Into One Commit\n");
+	print_separator('-', 60);
+
+	struct config_writer w;
+	struct config_writer_batch batch;
+	struct done_record a = { 0 }, b = { 0 };
+
+	config_writer_init(&w);
+	assert_equal_int("Starts idle", CONFIG_WRITER_IDLE, config_writer_get_state(&w));
+	assert_equal_int("Nothing to begin", 0, (int)config_writer_begin(&w, &batch));
+
+	assert_equal_int("Request with callback", 0, config_writer_request(&w, on_done, &a));
+	assert_equal_int("Request without callback", 0, config_writer_request(&w, NULL, NULL));
+	assert_equal_int("Request with callback", 0, config_writer_request(&w, on_done, &b));
+	assert_equal_int("Pending", CONFIG_WRITER_PENDING, config_writer_get_state(&w));
+
+	assert_equal_int("One commit covers 3 saves", 3, (int)config_writer_begin(&w, &batch));
+	assert_equal_int("Two callbacks taken", 2, batch.count);
+	assert_equal_int("Writing", CONFIG_WRITER_WRITING, config_writer_get_state(&w));
+	assert_equal_int("No second commit while writing", 0,
+			 (int)config_writer_begin(&w, &(struct config_writer_batch){ 0 }));
+	assert_equal_int("Not called before the commit ends", 0, a.calls);
+
+	config_writer_end(&w, &batch, 0, 1500);
+	config_writer_notify(&batch, 0);
+	assert_equal_int("Idle again", CONFIG_WRITER_IDLE, config_writer_get_state(&w));
+	assert_true("Each callback called once", a.calls == 1 && b.calls == 1);
+	assert_equal_int("Result passed", 0, a.result);
+	assert_equal_int("Commits", 1, (int)w.commits);
+	assert_equal_int("Requests", 3, (int)w.requests);
+	assert_equal_int("Commit time kept", 1500, (int)w.last_commit_us);
+}
+
+static void test_request_while_writing(void)
+{
+	printf("\nTest: Save During a Commit Gets the Next Commit\n");
+	print_separator('-', 60);
+
+	struct config_writer w;
+	struct config_writer_batch first, second;
+	struct done_record a = { 0 }, b = { 0 };
+
+	config_writer_init(&w);
+	config_writer_request(&w, on_done, &a);
+	config_writer_begin(&w, &first);
+
+	/* The commit in progress may have snapshotted the old data */
+	config_writer_request(&w, on_done, &b);
+	assert_equal_int("Still writing", CONFIG_WRITER_WRITING, config_writer_get_state(&w));
+
+	config_writer_end(&w, &first, 0, 100);
+	config_writer_notify(&first, 0);
+	assert_true("Only the first callback", a.calls == 1 && b.calls == 0);
+	assert_equal_int("Pending for the next commit", CONFIG_WRITER_PENDING,
+			 config_writer_get_state(&w));
+
+	assert_equal_int("Second commit", 1, (int)config_writer_begin(&w, &second));
+	config_writer_end(&w, &second, 0, 100);
+	config_writer_notify(&second, 0);
+	assert_true("Second callback", b.calls == 1);
+	assert_equal_int("Two commits", 2, (int)w.commits);
+}
+
+static void test_failure_and_limits(void)
+{
+	printf("\nTest: Failures and Callback Limit\n");
+	print_separator('-', 60);
+
+	struct config_writer w;
+	struct config_writer_batch batch;
+	struct done_record rec = { 0 };
+
+	config_writer_init(&w);
+	for (int i = 0; i < CONFIG_WRITER_MAX_CALLBACKS; i++) {
+		config_writer_request(&w, on_done, &rec);
+	}
+	assert_equal_int("Callback slots full", -EBUSY, config_writer_request(&w, on_done, &rec));
+	assert_equal_int("Rejected request not counted", CONFIG_WRITER_MAX_CALLBACKS,
+			 (int)w.pending_saves);
+	assert_equal_int("Request without callback still queues", 0,
+			 config_writer_request(&w, NULL, NULL));
+
+	config_writer_begin(&w, &batch);
+	config_writer_end(&w, &batch, -EIO, 90000);
+	config_writer_notify(&batch, -EIO);
+	assert_equal_int("Every callback called", CONFIG_WRITER_MAX_CALLBACKS, rec.calls);
+	assert_equal_int("Failure passed on", -EIO, rec.result);
+	assert_equal_int("Failure counted", 1, (int)w.failures);
+	assert_equal_int("Last result kept", -EIO, w.last_result);
+	assert_equal_int("Longest commit", 90000, (int)w.max_commit_us);
+	assert_equal_int("Slots free again", 0, config_writer_request(&w, on_done, &rec));
+
+	/* A callback may save again: that request waits for the next commit */
+	config_writer_init(&w);
+	chained_writer = &w;
+	config_writer_request(&w, on_done_save_again, &rec);
+	config_writer_begin(&w, &batch);
+	config_writer_end(&w, &batch, 0, 10);
+	config_writer_notify(&batch, 0);
+	assert_equal_int("Save from a callback is pending", CONFIG_WRITER_PENDING,
+			 config_writer_get_state(&w));
+	config_writer_begin(&w, &batch);
+	config_writer_end(&w, &batch, 0, 10);
+	config_writer_notify(&batch, 0);
+	assert_equal_int("And completes", 1, chained_rec.calls);
+
+	assert_true("State names", strcmp(config_writer_state_name(CONFIG_WRITER_PENDING),
+					  "pending") == 0);
+}
+
+int main(void)
+{
+	printf("\n");
+	print_separator('=', 60);
+	printf("CONFIG WRITER QUEUE TESTS\n");
+	print_separator('=', 60);
+
+	test_coalescing();
+	test_request_while_writing();
+	test_failure_and_limits();
+
+	printf("\n");
+	print_separator('=', 60);
+	printf("TEST SUMMARY\n");
+	print_separator('=', 60);
+	printf("Total tests:  %d\n", total_tests);
+	printf("Passed:       %d\n", passed_tests);
+	printf("Failed:       %d\n", failed_tests);
+	printf("Success rate: %.1f%%\n",
+	       total_tests > 0 ? (100.0 * passed_tests / total_tests) : 0.0);
+	print_separator('=', 60);
+
+	return (failed_tests == 0) ? 0 : 1;
+}
@@ -0,0 +1,343 @@
+/*
+ * Derived Sources Unit Tests
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "../src/derived_sources.h"
+
+#define DEG_TO_RAD (3.14159265358979323846 / 180.0)
+
+/* Test statistics */
+static int total_tests = 0;
+static int passed_tests = 0;
+static int failed_tests = 0;
+
+/* Test utilities */
+static void print_separator(char c, int length)
+{
+	for (int i = 0; i < length; i++) {
+		putchar(c);
+	}
+	putchar('\n');
+}
+
+static void assert_equal_uint32(const char *test_name, uint32_t expected, uint32_t actual)
+{
+	total_tests++;
+	if (expected == actual) {
+		printf("  ✓ %s: %u\n", test_name, actual);
+		passed_tests++;
+	} else {
+		printf("  ✗ %s: expected %u, got %u\n", test_name, expected, actual);
+		failed_tests++;
+	}
+}
+
+static void assert_near(const char *test_name, int32_t expected, int32_t actual, int32_t tol)
+{
+	total_tests++;
+	if (abs(expected - actual) <= tol) {
+		printf("  ✓ %s: %d (expected %d +/- %d)\n", test_name, actual, expected, tol);
+		passed_tests++;
+	} else {
+		printf("  ✗ %s: expected %d +/- %d, got %d\n", test_name, expected, tol, actual);
+		failed_tests++;
+	}
+}
+
+static void assert_true(const char *test_name, bool condition)
+{
+	total_tests++;
+	if (condition) {
+		printf("  ✓ %s\n", test_name);
+		passed_tests++;
+	} else {
+		printf("  ✗ %s: assertion failed\n", test_name);
+		failed_tests++;
+	}
+}
+
+/* ============================================================
+ * HELPERS
+ * ============================================================ */
+
+/* Gravity in the body frame for a guitar at this roll and pitch */
+static void gravity_mg(double roll_deg, double pitch_deg, int16_t accel[3])
+{
+	double r = roll_deg * DEG_TO_RAD;
+	double p = pitch_deg * DEG_TO_RAD;
+
+	accel[0] = (int16_t)lround(-1000.0 * sin(p));
+	accel[1] = (int16_t)lround(1000.0 * sin(r) * cos(p));
+	accel[2] = (int16_t)lround(1000.0 * cos(r) * cos(p));
+}
+
+/* ============================================================
+ * TILT
+ * ============================================================ */
+
+static void test_init(void)
+{
+	printf("\nTest: Init\n");
+	print_separator('-', 60);
+
+	struct derived_sources ds;
+
+	derived_sources_init(&ds, DERIVED_TILT_DEFAULT_SHIFT);
+	assert_equal_uint32("Default shift", DERIVED_TILT_DEFAULT_SHIFT, ds.tilt_shift);
+	assert_true("Not primed", !ds.primed);
+
+	derived_sources_init(&ds, 12);
+	assert_equal_uint32("Shift clamped", DERIVED_TILT_MAX_SHIFT, ds.tilt_shift);
+}
+
+static void test_tilt_accuracy(void)
+{
+	printf("\nTest: Tilt Accuracy vs libm\n");
+	print_separator('-', 60);
+
+	struct derived_sources ds;
+	int16_t accel[3];
+	int16_t tilt[2];
+	int32_t max_err = 0;
+
+	for (int roll = -175; roll <= 175; roll += 5) {
+		for (int pitch = -85; pitch <= 85; pitch += 5) {
+			gravity_mg(roll, pitch, accel);
+			derived_sources_init(&ds, 0);
+			derived_sources_tilt(&ds, accel, tilt);
+
+			/* Reference from the same quantized milli-g vector */
+			double ref_roll = atan2(accel[1], accel[2]) / DEG_TO_RAD * 10.0;
+			double ref_pitch = atan2(-accel[0], sqrt((double)accel[1] * accel[1] +
+			                                         (double)accel[2] * accel[2])) /
+			                   DEG_TO_RAD * 10.0;
+			int32_t e1 = abs(tilt[0] - (int32_t)lround(ref_roll));
+			int32_t e2 = abs(tilt[1] - (int32_t)lround(ref_pitch));
+
+			max_err = e1 > max_err ? e1 : max_err;
+			max_err = e2 > max_err ? e2 : max_err;
+		}
+	}
+	printf("  Max error over roll x pitch grid: %d decidegrees\n", max_err);
+	assert_true("Within 0.1 degree everywhere", max_err <= 1);
+
+	derived_sources_init(&ds, 0);
+	gravity_mg(30.0, -20.0, accel);
+	derived_sources_tilt(&ds, accel, tilt);
+	assert_near("Roll 30", 300, tilt[0], 1);
+	assert_near("Pitch -20", -200, tilt[1], 1);
+
+	const int16_t zero[3] = {0, 0, 0};
+	derived_sources_init(&ds, 0);
+	derived_sources_tilt(&ds, zero, tilt);
+	assert_near("Free fall: roll 0", 0, tilt[0], 0);
+	assert_near("Free fall: pitch 0", 0, tilt[1], 0);
+}
+
+static void test_low_pass(void)
+{
+	printf("\nTest: Gravity Low-Pass\n");
+	print_separator('-', 60);
+
+	struct derived_sources ds;
+	int16_t flat[3], tilted[3];
+	int16_t tilt[2];
+
+	gravity_mg(0.0, 0.0, flat);
+	gravity_mg(40.0, 0.0, tilted);
+
+	/* First sample primes: no ramp from zero */
+	derived_sources_init(&ds, 2);
+	derived_sources_tilt(&ds, tilted, tilt);
+	assert_near("Primed at 40", 400, tilt[0], 1);
+
+	/* Step from flat to 40 degrees */
+	derived_sources_init(&ds, 2);
+	derived_sources_tilt(&ds, flat, tilt);
+	derived_sources_tilt(&ds, tilted, tilt);
+	assert_true("One sample: partway", tilt[0] > 50 && tilt[0] < 200);
+	for (int i = 0; i < 30; i++) {
+		derived_sources_tilt(&ds, tilted, tilt);
+	}
+	assert_near("Settled at 40", 400, tilt[0], 2);
+
+	/* Shift 0 is unfiltered */
+	derived_sources_init(&ds, 0);
+	derived_sources_tilt(&ds, flat, tilt);
+	derived_sources_tilt(&ds, tilted, tilt);
+	assert_near("Unfiltered step", 400, tilt[0], 1);
+
+	/* A strum spike barely moves a slow filter */
+	const int16_t spike[3] = {1500, 2000, -500};
+	derived_sources_init(&ds, 5);
+	for (int i = 0; i < 10; i++) {
+		derived_sources_tilt(&ds, flat, tilt);
+	}
+	derived_sources_tilt(&ds, spike, tilt);
+	assert_true("Spike moves roll under 5 degrees", abs(tilt[0]) < 50);
+	assert_true("Spike moves pitch under 5 degrees", abs(tilt[1]) < 50);
+}
+
+static void test_update_slots(void)
+{
+	printf("\nTest: Sensor Slot Publishing\n");
+	print_separator('-', 60);
+
+	struct derived_sources ds;
+	int16_t values[MAX_SENSOR_SOURCES];
+
+	gravity_mg(-25.0, 10.0, values);
+	values[3] = values[4] = values[5] = 999;
+	derived_sources_init(&ds, 0);
+	derived_sources_update(&ds, values, false, DERIVED_MASK_TILT);
+	assert_near("No gyro: roll slot", -250, values[DERIVED_SLOT_ROLL], 1);
+	assert_near("No gyro: pitch slot", 100, values[DERIVED_SLOT_PITCH], 1);
+	assert_near("No gyro: yaw slot 0", 0, values[DERIVED_SLOT_YAW], 0);
+
+	values[3] = 111;
+	values[4] = 222;
+	values[5] = 333;
+	derived_sources_update(&ds, values, true, DERIVED_MASK_TILT);
+	assert_true("Gyro: fused angles kept",
+	            values[3] == 111 && values[4] == 222 && values[5] == 333);
+
+	values[3] = 999;
+	derived_sources_update(&ds, values, false, 0);
+	assert_equal_uint32("Tilt not read: roll slot 0", 0, (uint32_t)values[DERIVED_SLOT_ROLL]);
+}
+
+static void test_motion_sources(void)
+{
+	printf("\nTest: Magnitude and Jerk\n");
+	print_separator('-', 60);
+
+	struct derived_sources ds;
+	const uint16_t all = 0xFFFF;
+	int16_t values[MAX_SENSOR_SOURCES] = {300, -400, 1200};
+
+	derived_sources_init(&ds, DERIVED_TILT_DEFAULT_SHIFT);
+	derived_sources_update(&ds, values, false, all);
+	assert_equal_uint32("|(300,-400,1200)| = 1300", 1300, (uint32_t)values[SOURCE_MAGNITUDE]);
+	assert_equal_uint32("First sample: no jerk", 0, (uint32_t)values[SOURCE_JERK]);
+
+	int16_t next[MAX_SENSOR_SOURCES] = {330, -440, 1200};
+	derived_sources_update(&ds, next, false, all);
+	assert_near("Jerk X", 30, next[SOURCE_JERK_X], 0);
+	assert_near("Jerk Y", -40, next[SOURCE_JERK_Y], 0);
+	assert_near("Jerk Z", 0, next[SOURCE_JERK_Z], 0);
+	assert_equal_uint32("|jerk| = 50", 50, (uint32_t)next[SOURCE_JERK]);
+
+	int16_t big[MAX_SENSOR_SOURCES] = {32767, 32767, 32767};
+	derived_sources_update(&ds, big, false, all);
+	assert_equal_uint32("Magnitude saturates", 32767, (uint32_t)big[SOURCE_MAGNITUDE]);
+
+	int16_t swing[MAX_SENSOR_SOURCES] = {-32768, -32768, -32768};
+	derived_sources_update(&ds, swing, false, all);
+	assert_near("Jerk X saturates", -32768, swing[SOURCE_JERK_X], 0);
+	assert_equal_uint32("|jerk| saturates", 32767, (uint32_t)swing[SOURCE_JERK]);
+
+	/* Unreferenced sources are left at 0 but jerk history stays current */
+	int16_t quiet[MAX_SENSOR_SOURCES] = {0, 0, 1000};
+	derived_sources_update(&ds, quiet, false, 1u << SOURCE_MAGNITUDE);
+	assert_true("Only magnitude computed",
+	            quiet[SOURCE_MAGNITUDE] == 1000 && quiet[SOURCE_JERK] == 0 &&
+	            quiet[SOURCE_ENERGY] == 0);
+	int16_t after[MAX_SENSOR_SOURCES] = {0, 100, 1000};
+	derived_sources_update(&ds, after, false, 1u << SOURCE_JERK_Y);
+	assert_near("Jerk switched on uses last sample", 100, after[SOURCE_JERK_Y], 0);
+}
+
+static void test_energy(void)
+{
+	printf("\nTest: Motion Energy Envelope\n");
+	print_separator('-', 60);
+
+	struct derived_sources ds;
+	const uint16_t mask = 1u << SOURCE_ENERGY;
+	int16_t v[MAX_SENSOR_SOURCES];
+
+	/* Still guitar: gravity only, no energy whatever the tilt */
+	derived_sources_init(&ds, DERIVED_TILT_DEFAULT_SHIFT);
+	for (int i = 0; i < 2 * DERIVED_ENERGY_WINDOW; i++) {
+		gravity_mg(30.0, -20.0, v);
+		derived_sources_update(&ds, v, false, mask);
+	}
+	assert_near("Still: energy ~0", 0, v[SOURCE_ENERGY], 1);
+
+	/* Square wave of +/-A on X: RMS around the mean is A */
+	for (int i = 0; i < 2 * DERIVED_ENERGY_WINDOW; i++) {
+		v[0] = (i & 1) ? 500 : -500;
+		v[1] = 0;
+		v[2] = 1000;
+		derived_sources_update(&ds, v, false, mask);
+	}
+	assert_near("Shake +/-500 mg: energy 500", 500, v[SOURCE_ENERGY], 1);
+
+	/* Sine of amplitude A on Y: RMS A/sqrt(2) */
+	for (int i = 0; i < 4 * DERIVED_ENERGY_WINDOW; i++) {
+		v[0] = 0;
+		v[1] = (int16_t)lround(800.0 * sin(2.0 * 3.14159265358979323846 * i / DERIVED_ENERGY_WINDOW));
+		v[2] = 1000;
+		derived_sources_update(&ds, v, false, mask);
+	}
+	assert_near("Sine 800 mg: energy 566", 566, v[SOURCE_ENERGY], 2);
+
+	/* Envelope decays to 0 one window after motion stops */
+	for (int i = 0; i < DERIVED_ENERGY_WINDOW; i++) {
+		v[0] = 0;
+		v[1] = 0;
+		v[2] = 1000;
+		derived_sources_update(&ds, v, false, mask);
+	}
+	assert_equal_uint32("Energy back to 0 after one window", 0, (uint32_t)v[SOURCE_ENERGY]);
+
+	/* Window restarts when energy is switched back on */
+	v[0] = 2000;
+	derived_sources_update(&ds, v, false, 0);
+	assert_equal_uint32("Energy not read: 0", 0, (uint32_t)v[SOURCE_ENERGY]);
+	v[0] = 0;
+	derived_sources_update(&ds, v, false, mask);
+	assert_equal_uint32("Switched on: window restarts", 1, ds.count);
+	assert_equal_uint32("Switched on: single sample, no energy", 0, (uint32_t)v[SOURCE_ENERGY]);
+}
+
+/* ============================================================
+ * MAIN
+ * ============================================================ */
+
+int main(void)
+{
+	printf("\n");
+	print_separator('=', 60);
+	printf("DERIVED SOURCES UNIT TESTS\n");
+	print_separator('=', 60);
+
+	test_init();
+	test_tilt_accuracy();
+	test_low_pass();
+	test_update_slots();
+	test_motion_sources();
+	test_energy();
+
+	printf("\n");
+	print_separator('=', 60);
+	printf("TEST SUMMARY\n");
+	print_separator('=', 60);
+	printf("Total tests:  %d\n", total_tests);
+	printf("Passed:       %d\n", passed_tests);
+	printf("Failed:       %d\n", failed_tests);
+	printf("Success rate: %.1f%%\n",
+	       total_tests > 0 ? (100.0 * passed_tests / total_tests) : 0.0);
+	print_separator('=', 60);
+
+	return (failed_tests == 0) ? 0 : 1;
+}
@@ -0,0 +1,547 @@
+/*
+ * Gesture Engine Unit Tests
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../src/gesture_engine.h"
+
+#define CH 2    /* MIDI channel used throughout */
+
+/* Test statistics */
+static int total_tests = 0;
+static int passed_tests = 0;
+static int failed_tests = 0;
+
+/* Test utilities */
+static void print_separator(char c, int length)
+{
+	for (int i = 0; i < length; i++) {
+		putchar(c);
+	}
+	putchar('\n');
+}
+
+static void assert_equal_uint32(const char *test_name, uint32_t expected, uint32_t actual)
+{
+	total_tests++;
+	if (expected == actual) {
+		printf("  ✓ %s: %u\n", test_name, actual);
+		passed_tests++;
+	} else {
+		printf("  ✗ %s: expected %u, got %u\n", test_name, expected, actual);
+		failed_tests++;
+	}
+}
+
+static void assert_true(const char *test_name, bool condition)
+{
+	total_tests++;
+	if (condition) {
+		printf("  ✓ %s\n", test_name);
+		passed_tests++;
+	} else {
+		printf("  ✗ %s: assertion failed\n", test_name);
+		failed_tests++;
+	}
+}
+
+/* ============================================================
+ * HELPERS
+ * ============================================================ */
+
+static struct gesture_slot make_slot(uint8_t type, uint8_t source, uint8_t action,
+                                     uint8_t number, int threshold)
+{
+	struct gesture_slot slot = {
+		.type = type,
+		.source = source,
+		.action = action,
+		.number = number,
+		.threshold = (uint8_t)(threshold / GESTURE_THRESHOLD_UNIT),
+		.velocity_curve = GESTURE_VELOCITY_LINEAR,
+	};
+	return slot;
+}
+
+/* One sample with value v on one source, every other source 0 */
+static int step(struct gesture_engine *ge, const struct gesture_config *cfg,
+                uint8_t source, int16_t v, struct gesture_event *events)
+{
+	int16_t values[MAX_SENSOR_SOURCES] = {0};
+
+	values[source] = v;
+	return gesture_engine_process(ge, cfg, values, CH, events);
+}
+
+/* Feed a sequence; count Note On / Note Off events */
+static void feed(struct gesture_engine *ge, const struct gesture_config *cfg, uint8_t source,
+                 const int16_t *seq, int len, int *note_on, int *note_off)
+{
+	struct gesture_event events[GESTURE_MAX_EVENTS];
+
+	for (int i = 0; i < len; i++) {
+		int n = step(ge, cfg, source, seq[i], events);
+
+		for (int j = 0; j < n; j++) {
+			if (events[j].msg[0] == (0x90 | CH)) {
+				(*note_on)++;
+			} else if (events[j].msg[0] == (0x80 | CH)) {
+				(*note_off)++;
+			}
+		}
+	}
+}
+
+/* Note Ons for one shape (scaled) between quiet samples */
+static int count_flicks(uint8_t type, const int8_t *shape, int scale)
+{
+	struct gesture_engine ge;
+	struct gesture_config cfg = {0};
+	int16_t seq[3 * GESTURE_TEMPLATE_LEN] = {0};
+	int on = 0;
+	int off = 0;
+
+	cfg.slots[0] = make_slot(type, SOURCE_JERK_Y, GESTURE_ACTION_NOTE, 40, 400);
+	for (int i = 0; i < GESTURE_TEMPLATE_LEN; i++) {
+		seq[GESTURE_TEMPLATE_LEN + i] = (int16_t)(shape[i] * scale);
+	}
+
+	gesture_engine_init(&ge);
+	feed(&ge, &cfg, SOURCE_JERK_Y, seq, 3 * GESTURE_TEMPLATE_LEN, &on, &off);
+	return on;
+}
+
+/* ============================================================
+ * CONFIGURATION
+ * ============================================================ */
+
+static void test_validate(void)
+{
+	printf("\nTest: Config Validation\n");
+	print_separator('-', 60);
+
+	struct gesture_config cfg = {0};
+
+	assert_true("Empty config valid", gesture_config_validate(&cfg));
+	assert_true("NULL invalid", !gesture_config_validate(NULL));
+	assert_equal_uint32("Slot size", 6, sizeof(struct gesture_slot));
+	assert_equal_uint32("Config size", 6 * GESTURE_SLOTS, sizeof(struct gesture_config));
+
+	cfg.slots[1] = make_slot(GESTURE_STRUM, SOURCE_JERK_Y, GESTURE_ACTION_NOTE, 60, 400);
+	assert_true("Strum slot valid", gesture_config_validate(&cfg));
+
+	cfg.slots[1].source = MAX_SENSOR_SOURCES;
+	assert_true("Source out of range rejected", !gesture_config_validate(&cfg));
+	cfg.slots[1].source = SOURCE_JERK_Y;
+
+	cfg.slots[1].threshold = 0;
+	assert_true("Zero threshold rejected", !gesture_config_validate(&cfg));
+	cfg.slots[1].threshold = 25;
+
+	cfg.slots[1].number = 128;
+	assert_true("Note 128 rejected", !gesture_config_validate(&cfg));
+	cfg.slots[1].number = 60;
+
+	cfg.slots[1].action = GESTURE_ACTION_COUNT;
+	assert_true("Unknown action rejected", !gesture_config_validate(&cfg));
+	cfg.slots[1].action = GESTURE_ACTION_NOTE;
+
+	cfg.slots[1].type = GESTURE_TYPE_COUNT;
+	assert_true("Unknown type rejected", !gesture_config_validate(&cfg));
+
+	assert_true("Type name", strcmp(gesture_type_name(GESTURE_FLICK), "FLICK") == 0);
+	assert_true("Tilt type name", strcmp(gesture_type_name(GESTURE_TILT), "TILT") == 0);
+	assert_true("Unknown type name", strcmp(gesture_type_name(99), "UNKNOWN") == 0);
+}
+
+static void test_velocity_curve(void)
+{
+	printf("\nTest: Velocity Curve\n");
+	print_separator('-', 60);
+
+	assert_equal_uint32("Linear at threshold", 1, gesture_velocity(0, 64));
+	assert_equal_uint32("Linear full scale", 127, gesture_velocity(256, 64));
+	assert_equal_uint32("Linear half", 64, gesture_velocity(128, 64));
+	assert_equal_uint32("Hard half", 33, gesture_velocity(128, 0));
+	assert_equal_uint32("Soft half", 90, gesture_velocity(128, 127));
+	assert_equal_uint32("Strength clamped", 127, gesture_velocity(1000, 0));
+
+	bool monotonic = true;
+	for (int curve = 0; curve <= 127; curve += 9) {
+		uint8_t prev = 0;
+		for (int s = 0; s <= 256; s++) {
+			uint8_t v = gesture_velocity((uint16_t)s, (uint8_t)curve);
+			if (v < prev || v < 1 || v > 127) {
+				monotonic = false;
+			}
+			prev = v;
+		}
+	}
+	assert_true("Monotonic in strength, 1-127, every curve", monotonic);
+
+	bool ordered = true;
+	for (int s = 0; s <= 256; s += 8) {
+		if (gesture_velocity((uint16_t)s, 0) > gesture_velocity((uint16_t)s, 64) ||
+		    gesture_velocity((uint16_t)s, 64) > gesture_velocity((uint16_t)s, 127)) {
+			ordered = false;
+		}
+	}
+	assert_true("Hard <= linear <= soft", ordered);
+}
+
+/* ============================================================
+ * DETECTION
+ * ============================================================ */
+
+static void test_strum(void)
+{
+	printf("\nTest: Strum (Peak Detection, Refractory)\n");
+	print_separator('-', 60);
+
+	struct gesture_engine ge;
+	struct gesture_config cfg = {0};
+	struct gesture_event ev[GESTURE_MAX_EVENTS];
+
+	cfg.slots[0] = make_slot(GESTURE_STRUM, SOURCE_JERK_Y, GESTURE_ACTION_NOTE, 60, 400);
+	gesture_engine_init(&ge);
+
+	assert_equal_uint32("Below threshold: nothing", 0, step(&ge, &cfg, SOURCE_JERK_Y, 300, ev));
+	assert_equal_uint32("Crossing: wait for peak", 0, step(&ge, &cfg, SOURCE_JERK_Y, 500, ev));
+	assert_equal_uint32("Rising: wait for peak", 0, step(&ge, &cfg, SOURCE_JERK_Y, -800, ev));
+
+	int n = step(&ge, &cfg, SOURCE_JERK_Y, 700, ev);
+	assert_equal_uint32("Falling: fires", 1, n);
+	assert_equal_uint32("Note On status", 0x90 | CH, ev[0].msg[0]);
+	assert_equal_uint32("Note number", 60, ev[0].msg[1]);
+	/* Peak 800 at threshold 400: strength (800 - 400) * 256 / 1200 = 85 */
+	assert_equal_uint32("Velocity from peak", gesture_velocity(85, 64), ev[0].msg[2]);
+	assert_equal_uint32("Trigger counted", 1, ge.triggers);
+
+	int fired = 0;
+	int off_at = -1;
+	for (int i = 1; i <= GESTURE_NOTE_SAMPLES; i++) {
+		n = step(&ge, &cfg, SOURCE_JERK_Y, 900, ev);
+		for (int j = 0; j < n; j++) {
+			if (ev[j].msg[0] == (0x90 | CH)) {
+				fired++;
+			} else if (ev[j].msg[0] == (0x80 | CH) && off_at < 0) {
+				off_at = i;
+			}
+		}
+	}
+	assert_equal_uint32("Refractory: no retrigger", 0, fired);
+	assert_equal_uint32("Note Off after note length", GESTURE_NOTE_SAMPLES, off_at);
+
+	/* Re-armed at the end of the refractory period: a long push fires
+	 * after the wait limit */
+	for (int i = 0; i < GESTURE_PEAK_WAIT_SAMPLES + 2; i++) {
+		int16_t rising = (int16_t)(1000 + 100 * i);
+		n = step(&ge, &cfg, SOURCE_JERK_Y, rising, ev);
+		if (n > 0) {
+			break;
+		}
+	}
+	assert_equal_uint32("Rising push fires at wait limit", 1, n);
+	assert_equal_uint32("Second trigger", 2, ge.triggers);
+}
+
+static void test_shake(void)
+{
+	printf("\nTest: Shake (Hysteresis, Sustained Note)\n");
+	print_separator('-', 60);
+
+	struct gesture_engine ge;
+	struct gesture_config cfg = {0};
+	struct gesture_event ev[GESTURE_MAX_EVENTS];
+
+	cfg.slots[2] = make_slot(GESTURE_SHAKE, SOURCE_ENERGY, GESTURE_ACTION_NOTE, 36, 320);
+	gesture_engine_init(&ge);
+
+	int n = step(&ge, &cfg, SOURCE_ENERGY, 400, ev);
+	assert_equal_uint32("Fires at threshold", 1, n);
+	assert_equal_uint32("Slot index", 2, ev[0].slot);
+	assert_equal_uint32("Note On", 0x90 | CH, ev[0].msg[0]);
+
+	int events = 0;
+	for (int i = 0; i < 50; i++) {
+		events += step(&ge, &cfg, SOURCE_ENERGY, (i & 1) ? 170 : 300, ev);
+	}
+	assert_equal_uint32("Sustained above threshold / 2: no events", 0, events);
+
+	for (int i = 0; i < GESTURE_RELEASE_SAMPLES - 1; i++) {
+		events += step(&ge, &cfg, SOURCE_ENERGY, 100, ev);
+	}
+	assert_equal_uint32("Brief dip: still sounding", 0, events);
+	assert_true("Sounding", ge.slots[2].sounding);
+
+	n = step(&ge, &cfg, SOURCE_ENERGY, 100, ev);
+	assert_equal_uint32("Release: Note Off", 1, n);
+	assert_equal_uint32("Note Off status", 0x80 | CH, ev[0].msg[0]);
+	assert_equal_uint32("Note Off number", 36, ev[0].msg[1]);
+	assert_true("Not sounding", !ge.slots[2].sounding);
+}
+
+static void test_templates(void)
+{
+	printf("\nTest: Flick / Tap Template Matching\n");
+	print_separator('-', 60);
+
+	static const int8_t flick[GESTURE_TEMPLATE_LEN] = {2, 6, 8, 3, -3, -7, -5, -1};
+	static const int8_t tap[GESTURE_TEMPLATE_LEN] = {0, 3, 8, -4, 2, -1, 0, 0};
+	static const int8_t ramp[GESTURE_TEMPLATE_LEN] = {1, 4, 8, 8, 8, 8, 8, 8};
+	static const int8_t wobble[GESTURE_TEMPLATE_LEN] = {-6, 7, 8, -7, 6, -8, 7, -6};
+
+	assert_equal_uint32("Flick matches flick", 1, count_flicks(GESTURE_FLICK, flick, 100));
+	assert_equal_uint32("Inverted flick matches", 1, count_flicks(GESTURE_FLICK, flick, -100));
+	assert_equal_uint32("Tap matches tap", 1, count_flicks(GESTURE_TAP, tap, 100));
+	assert_equal_uint32("Tap rejected by flick", 0, count_flicks(GESTURE_FLICK, tap, 100));
+	assert_equal_uint32("Flick rejected by tap", 0, count_flicks(GESTURE_TAP, flick, 100));
+	assert_equal_uint32("Step rejected", 0, count_flicks(GESTURE_FLICK, ramp, 100));
+	assert_equal_uint32("Vibration rejected", 0, count_flicks(GESTURE_TAP, wobble, 100));
+	assert_equal_uint32("Flick below threshold", 0, count_flicks(GESTURE_FLICK, flick, 40));
+}
+
+/* ============================================================
+ * ACTIONS AND NOTE BOOKKEEPING
+ * ============================================================ */
+
+static void test_actions(void)
+{
+	printf("\nTest: Program Change / CC Toggle Actions\n");
+	print_separator('-', 60);
+
+	struct gesture_engine ge;
+	struct gesture_config cfg = {0};
+	struct gesture_event ev[GESTURE_MAX_EVENTS];
+	int n;
+
+	cfg.slots[0] = make_slot(GESTURE_SHAKE, 0, GESTURE_ACTION_PROGRAM, 5, 320);
+	cfg.slots[1] = make_slot(GESTURE_SHAKE, 1, GESTURE_ACTION_CC_TOGGLE, 80, 320);
+	gesture_engine_init(&ge);
+
+	int16_t both[MAX_SENSOR_SOURCES] = {500, 500};
+	int16_t quiet[MAX_SENSOR_SOURCES] = {0};
+
+	n = gesture_engine_process(&ge, &cfg, both, CH, ev);
+	assert_equal_uint32("Both slots fire", 2, n);
+	assert_equal_uint32("Program Change status", 0xC0 | CH, ev[0].msg[0]);
+	assert_equal_uint32("Program Change length", 2, ev[0].len);
+	assert_equal_uint32("Program number", 5, ev[0].msg[1]);
+	assert_equal_uint32("CC status", 0xB0 | CH, ev[1].msg[0]);
+	assert_equal_uint32("CC number", 80, ev[1].msg[1]);
+	assert_equal_uint32("CC toggled on", 127, ev[1].msg[2]);
+
+	int ends = 0;
+	for (int i = 0; i < GESTURE_RELEASE_SAMPLES + GESTURE_REFRACTORY_SAMPLES; i++) {
+		ends += gesture_engine_process(&ge, &cfg, quiet, CH, ev);
+	}
+	assert_equal_uint32("No Note Off for non-note actions", 0, ends);
+
+	n = gesture_engine_process(&ge, &cfg, both, CH, ev);
+	assert_equal_uint32("Second shake fires both", 2, n);
+	assert_equal_uint32("CC toggled off", 0, ev[1].msg[2]);
+}
+
+static void test_tx_failed(void)
+{
+	printf("\nTest: Rejected Note Off Is Retried\n");
+	print_separator('-', 60);
+
+	struct gesture_engine ge;
+	struct gesture_config cfg = {0};
+	struct gesture_event ev[GESTURE_MAX_EVENTS];
+	int n = 0;
+
+	cfg.slots[0] = make_slot(GESTURE_SHAKE, 0, GESTURE_ACTION_NOTE, 50, 320);
+	gesture_engine_init(&ge);
+
+	step(&ge, &cfg, 0, 500, ev);
+	for (int i = 0; i < GESTURE_RELEASE_SAMPLES && n == 0; i++) {
+		n = step(&ge, &cfg, 0, 0, ev);
+	}
+	assert_equal_uint32("Note Off produced", 0x80 | CH, ev[0].msg[0]);
+
+	gesture_engine_tx_failed(&ge, &ev[0]);
+	n = step(&ge, &cfg, 0, 0, ev);
+	assert_equal_uint32("Resent on next sample", 1, n);
+	assert_equal_uint32("Resent Note Off", 0x80 | CH, ev[0].msg[0]);
+	assert_equal_uint32("Resent note number", 50, ev[0].msg[1]);
+	assert_equal_uint32("Only once", 0, step(&ge, &cfg, 0, 0, ev));
+
+	/* A rejected Note On is not retried */
+	struct gesture_event on = {.slot = 0, .len = 3, .msg = {0x90 | CH, 50, 100}};
+	gesture_engine_tx_failed(&ge, &on);
+	assert_equal_uint32("Note On not retried", 0, step(&ge, &cfg, 0, 0, ev));
+}
+
+static void test_remote_events(void)
+{
+	printf("\nTest: Remote Events (Client Edge Detection)\n");
+	print_separator('-', 60);
+
+	struct gesture_engine ge;
+	struct gesture_config cfg = {0};
+	struct gesture_event ev[GESTURE_MAX_EVENTS];
+
+	cfg.slots[0] = make_slot(GESTURE_TAP, SOURCE_JERK, GESTURE_ACTION_NOTE, 60, 400);
+	cfg.slots[1] = make_slot(GESTURE_TILT, 4, GESTURE_ACTION_NOTE, 64, 320);
+	cfg.slots[2] = make_slot(GESTURE_SHAKE, SOURCE_ENERGY, GESTURE_ACTION_CC_TOGGLE, 80, 320);
+	gesture_engine_init(&ge);
+
+	int n = gesture_engine_remote_event(&ge, &cfg, GESTURE_TAP, false, -1600, CH, ev);
+	assert_equal_uint32("Tap start: Note On", 1, n);
+	assert_equal_uint32("Tap slot", 0, ev[0].slot);
+	assert_equal_uint32("Tap note", 60, ev[0].msg[1]);
+	assert_equal_uint32("Either polarity, full strength", 127, ev[0].msg[2]);
+	assert_true("Tap slot now remote", ge.slots[0].remote && !ge.slots[1].remote);
+
+	/* Held until the client's end event, whatever the streamed samples do */
+	int events = 0;
+	int16_t values[MAX_SENSOR_SOURCES] = {0};
+	for (int i = 0; i < 3 * GESTURE_NOTE_SAMPLES; i++) {
+		values[SOURCE_JERK] = (int16_t)((i % GESTURE_TEMPLATE_LEN == 2) ? 3200 : 0);
+		events += gesture_engine_process(&ge, &cfg, values, CH, ev);
+	}
+	assert_equal_uint32("Remote slot ignores the stream", 0, events);
+	assert_true("Still sounding", ge.slots[0].sounding);
+
+	n = gesture_engine_remote_event(&ge, &cfg, GESTURE_TAP, true, 0, CH, ev);
+	assert_equal_uint32("Tap end: Note Off", 1, n);
+	assert_equal_uint32("Note Off status", 0x80 | CH, ev[0].msg[0]);
+	assert_equal_uint32("Second end: nothing", 0,
+	                    gesture_engine_remote_event(&ge, &cfg, GESTURE_TAP, true, 0, CH, ev));
+
+	/* Tilt slot still detects locally until its first remote event */
+	values[SOURCE_JERK] = 0;
+	values[4] = 400;
+	n = gesture_engine_process(&ge, &cfg, values, CH, ev);
+	assert_equal_uint32("Local tilt: Note On", 1, n);
+	assert_equal_uint32("Local tilt note", 64, ev[0].msg[1]);
+	n = gesture_engine_remote_event(&ge, &cfg, GESTURE_TILT, false, 400, CH, ev);
+	assert_equal_uint32("Remote tilt restarts the note", 2, n);
+	assert_equal_uint32("Note Off first", 0x80 | CH, ev[0].msg[0]);
+	assert_equal_uint32("Then Note On", 0x90 | CH, ev[1].msg[0]);
+
+	/* A rejected Note Off is retried by the next remote event */
+	n = gesture_engine_remote_event(&ge, &cfg, GESTURE_TILT, true, 0, CH, ev);
+	gesture_engine_tx_failed(&ge, &ev[0]);
+	n = gesture_engine_remote_event(&ge, &cfg, GESTURE_SHAKE, false, 400, CH, ev);
+	assert_equal_uint32("Retried Note Off + CC toggle", 2, n);
+	assert_equal_uint32("Retry is the tilt Note Off", 64, ev[0].msg[1]);
+	assert_equal_uint32("Toggle on", 127, ev[1].msg[2]);
+
+	assert_equal_uint32("No slot of that type", 0,
+	                    gesture_engine_remote_event(&ge, &cfg, GESTURE_FLICK, false, 800, CH, ev));
+
+	/* Release clears the remote flag */
+	gesture_engine_release(&ge, CH, ev);
+	assert_true("Release resets remote", !ge.slots[0].remote && !ge.slots[1].remote);
+}
+
+static void test_release(void)
+{
+	printf("\nTest: Release and Slot Removal\n");
+	print_separator('-', 60);
+
+	struct gesture_engine ge;
+	struct gesture_config cfg = {0};
+	struct gesture_event ev[GESTURE_MAX_EVENTS];
+
+	cfg.slots[0] = make_slot(GESTURE_SHAKE, 0, GESTURE_ACTION_NOTE, 48, 320);
+	cfg.slots[1] = make_slot(GESTURE_SHAKE, 1, GESTURE_ACTION_NOTE, 52, 320);
+	gesture_engine_init(&ge);
+
+	int16_t both[MAX_SENSOR_SOURCES] = {500, 500};
+	gesture_engine_process(&ge, &cfg, both, CH, ev);
+
+	int n = gesture_engine_release(&ge, CH, ev);
+	assert_equal_uint32("Release: one Note Off per sounding note", 2, n);
+	assert_equal_uint32("First Note Off", 48, ev[0].msg[1]);
+	assert_equal_uint32("Second Note Off", 52, ev[1].msg[1]);
+	assert_equal_uint32("Nothing left to release", 0, gesture_engine_release(&ge, CH, ev));
+
+	gesture_engine_process(&ge, &cfg, both, CH, ev);
+	memset(&cfg.slots[1], 0, sizeof(cfg.slots[1]));
+	n = gesture_engine_process(&ge, &cfg, both, CH, ev);
+	assert_equal_uint32("Removed slot: Note Off", 1, n);
+	assert_equal_uint32("Removed slot's note", 52, ev[0].msg[1]);
+	assert_true("Removed slot state cleared", !ge.slots[1].armed && !ge.slots[1].sounding);
+}
+
+static void test_bounded(void)
+{
+	printf("\nTest: Bounded Events on Random Input\n");
+	print_separator('-', 60);
+
+	struct gesture_engine ge;
+	struct gesture_config cfg = {0};
+	struct gesture_event ev[GESTURE_MAX_EVENTS];
+	int16_t values[MAX_SENSOR_SOURCES];
+	int max_events = 0;
+	int on = 0;
+	int off = 0;
+
+	cfg.slots[0] = make_slot(GESTURE_STRUM, 0, GESTURE_ACTION_NOTE, 60, 320);
+	cfg.slots[1] = make_slot(GESTURE_SHAKE, 1, GESTURE_ACTION_NOTE, 62, 320);
+	cfg.slots[2] = make_slot(GESTURE_FLICK, 2, GESTURE_ACTION_NOTE, 64, 320);
+	gesture_engine_init(&ge);
+	srand(1234);
+
+	for (int i = 0; i < 20000; i++) {
+		for (int s = 0; s < MAX_SENSOR_SOURCES; s++) {
+			values[s] = (int16_t)(rand() % 2001 - 1000);
+		}
+		int n = gesture_engine_process(&ge, &cfg, values, CH, ev);
+		max_events = (n > max_events) ? n : max_events;
+		for (int j = 0; j < n; j++) {
+			on += (ev[j].msg[0] == (0x90 | CH));
+			off += (ev[j].msg[0] == (0x80 | CH));
+		}
+	}
+	on -= gesture_engine_release(&ge, CH, ev);
+
+	printf("  Note On %d, Note Off %d, max %d events in one sample\n", on, off, max_events);
+	assert_true("Within GESTURE_MAX_EVENTS", max_events <= GESTURE_MAX_EVENTS);
+	assert_true("Notes fired", off > 0);
+	assert_equal_uint32("Every Note On has its Note Off", (uint32_t)off, (uint32_t)on);
+}
+
+int main(void)
+{
+	printf("\n");
+	print_separator('=', 60);
+	printf("GESTURE ENGINE UNIT TESTS\n");
+	print_separator('=', 60);
+
+	test_validate();
+	test_velocity_curve();
+	test_strum();
+	test_shake();
+	test_templates();
+	test_actions();
+	test_tx_failed();
+	test_remote_events();
+	test_release();
+	test_bounded();
+
+	printf("\n");
+	print_separator('=', 60);
+	printf("TEST SUMMARY\n");
+	print_separator('=', 60);
+	printf("Total tests:  %d\n", total_tests);
+	printf("Passed:       %d\n", passed_tests);
+	printf("Failed:       %d\n", failed_tests);
+	printf("Success rate: %.1f%%\n",
+	       total_tests > 0 ? (100.0 * passed_tests / total_tests) : 0.0);
+	print_separator('=', 60);
+
+	return (failed_tests == 0) ? 0 : 1;
+}
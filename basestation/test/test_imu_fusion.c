@@ -0,0 +1,371 @@
+/*
+ * IMU Fusion Unit Tests
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "../src/fixed_math.h"
+#include "../src/imu_fusion.h"
+
+#define DEG_TO_RAD (3.14159265358979323846 / 180.0)
+
+/* Test statistics */
+static int total_tests = 0;
+static int passed_tests = 0;
+static int failed_tests = 0;
+
+/* Test utilities */
+static void print_separator(char c, int length)
+{
+	for (int i = 0; i < length; i++) {
+		putchar(c);
+	}
+	putchar('\n');
+}
+
+static void assert_equal_uint32(const char *test_name, uint32_t expected, uint32_t actual)
+{
+	total_tests++;
+	if (expected == actual) {
+		printf("  ✓ %s: %u\n", test_name, actual);
+		passed_tests++;
+	} else {
+		printf("  ✗ %s: expected %u, got %u\n", test_name, expected, actual);
+		failed_tests++;
+	}
+}
+
+static void assert_near(const char *test_name, int32_t expected, int32_t actual, int32_t tol)
+{
+	total_tests++;
+	if (abs(expected - actual) <= tol) {
+		printf("  ✓ %s: %d (expected %d +/- %d)\n", test_name, actual, expected, tol);
+		passed_tests++;
+	} else {
+		printf("  ✗ %s: expected %d +/- %d, got %d\n", test_name, expected, tol, actual);
+		failed_tests++;
+	}
+}
+
+static void assert_true(const char *test_name, bool condition)
+{
+	total_tests++;
+	if (condition) {
+		printf("  ✓ %s\n", test_name);
+		passed_tests++;
+	} else {
+		printf("  ✗ %s: assertion failed\n", test_name);
+		failed_tests++;
+	}
+}
+
+/* ============================================================
+ * SYNTHETIC MOTION
+ * ============================================================ */
+
+/* Gravity in the body frame for a guitar at this roll and pitch */
+static void gravity_mg(double roll_deg, double pitch_deg, int16_t accel[3])
+{
+	double r = roll_deg * DEG_TO_RAD;
+	double p = pitch_deg * DEG_TO_RAD;
+
+	accel[0] = (int16_t)lround(-1000.0 * sin(p));
+	accel[1] = (int16_t)lround(1000.0 * sin(r) * cos(p));
+	accel[2] = (int16_t)lround(1000.0 * cos(r) * cos(p));
+}
+
+/* Feed a held pose with constant gyro reading; returns the next timestamp */
+static uint32_t feed(struct imu_fusion *f, uint32_t t_us, uint32_t period_us, int samples,
+                     double roll_deg, double pitch_deg, const int16_t gyro[3])
+{
+	int16_t accel[3];
+
+	gravity_mg(roll_deg, pitch_deg, accel);
+	for (int i = 0; i < samples; i++) {
+		imu_fusion_update(f, accel, gyro, t_us);
+		t_us += period_us;
+	}
+	return t_us;
+}
+
+static int16_t angle_ddeg(const struct imu_fusion *f, int axis)
+{
+	int16_t angles[IMU_AXES];
+
+	imu_fusion_get_angles(f, angles);
+	return angles[axis];
+}
+
+/* ============================================================
+ * FIXED-POINT MATH
+ * ============================================================ */
+
+static void test_atan2(void)
+{
+	printf("\nTest: CORDIC atan2 vs libm\n");
+	print_separator('-', 60);
+
+	int32_t max_err = 0;
+	static const int32_t radii[] = {1000, 32767, 1000000, 2000000000};
+
+	for (size_t r = 0; r < sizeof(radii) / sizeof(radii[0]); r++) {
+		for (int deg10 = -1800; deg10 <= 1800; deg10 += 7) {
+			double a = deg10 / 10.0 * DEG_TO_RAD;
+			int32_t x = (int32_t)lround(radii[r] * cos(a));
+			int32_t y = (int32_t)lround(radii[r] * sin(a));
+			int32_t ref = (int32_t)lround(atan2((double)y, (double)x) / DEG_TO_RAD * 1000.0);
+			int32_t err = abs(fx_wrap_mdeg(fx_atan2_mdeg(y, x) - ref));
+			max_err = err > max_err ? err : max_err;
+		}
+	}
+	printf("  Max error over grid: %d mdeg\n", max_err);
+	assert_true("Grid error under 5 mdeg", max_err < 5);
+
+	assert_near("atan2(0, 0)", 0, fx_atan2_mdeg(0, 0), 0);
+	assert_near("atan2(0, 1)", 0, fx_atan2_mdeg(0, 1), 2);
+	assert_near("atan2(1, 0)", 90000, fx_atan2_mdeg(1, 0), 2);
+	assert_near("atan2(-1, 0)", -90000, fx_atan2_mdeg(-1, 0), 2);
+	assert_near("atan2(1, -1)", 135000, fx_atan2_mdeg(1, -1), 2);
+	assert_near("atan2(-7, -7)", -135000, fx_atan2_mdeg(-7, -7), 2);
+	assert_near("|atan2(0, -5)| = 180", 180000, abs(fx_atan2_mdeg(0, -5)), 2);
+	assert_near("atan2(INT32_MIN, INT32_MIN)", -135000,
+	            fx_atan2_mdeg(INT32_MIN, INT32_MIN), 2);
+	assert_near("atan2(INT32_MAX, 1)", 90000, fx_atan2_mdeg(INT32_MAX, 1), 2);
+}
+
+static void test_wrap_and_sqrt(void)
+{
+	printf("\nTest: Angle Wrap and Integer Square Root\n");
+	print_separator('-', 60);
+
+	assert_near("wrap(190000)", -170000, fx_wrap_mdeg(190000), 0);
+	assert_near("wrap(-190000)", 170000, fx_wrap_mdeg(-190000), 0);
+	assert_near("wrap(720000 + 5)", 5, fx_wrap_mdeg(720005), 0);
+
+	assert_equal_uint32("isqrt(0)", 0, fx_isqrt32(0));
+	assert_equal_uint32("isqrt(1)", 1, fx_isqrt32(1));
+	assert_equal_uint32("isqrt(1000000)", 1000, fx_isqrt32(1000000));
+	assert_equal_uint32("isqrt(999999)", 999, fx_isqrt32(999999));
+	assert_equal_uint32("isqrt(UINT32_MAX)", 65535, fx_isqrt32(UINT32_MAX));
+
+	bool exact = true;
+	for (uint32_t v = 0; v < 100000; v++) {
+		uint32_t r = fx_isqrt32(v);
+		if (r * r > v || (r + 1) * (r + 1) <= v) {
+			exact = false;
+		}
+	}
+	assert_true("floor(sqrt) for 0..99999", exact);
+}
+
+/* ============================================================
+ * FUSION
+ * ============================================================ */
+
+static void test_static_tilt(void)
+{
+	printf("\nTest: Static Tilt from Gravity\n");
+	print_separator('-', 60);
+
+	static const int16_t still[3] = {0, 0, 0};
+	struct imu_fusion f;
+
+	imu_fusion_init(&f, 0);
+	assert_equal_uint32("Default tau", IMU_FUSION_DEFAULT_TAU_MS, f.tau_ms);
+
+	feed(&f, 0, 10000, 1, 30.0, -20.0, still);
+	assert_true("Valid after first sample", f.valid);
+	assert_near("Roll 30 deg (first sample)", 300, angle_ddeg(&f, IMU_ROLL), 2);
+	assert_near("Pitch -20 deg (first sample)", -200, angle_ddeg(&f, IMU_PITCH), 2);
+	assert_near("Yaw starts at 0", 0, angle_ddeg(&f, IMU_YAW), 0);
+
+	feed(&f, 10000, 10000, 200, 30.0, -20.0, still);
+	assert_near("Roll holds", 300, angle_ddeg(&f, IMU_ROLL), 2);
+	assert_near("Pitch holds", -200, angle_ddeg(&f, IMU_PITCH), 2);
+	assert_equal_uint32("No accel rejected", 0, f.accel_rejected);
+}
+
+static void test_yaw_integration(void)
+{
+	printf("\nTest: Yaw Integrates Gyro Z\n");
+	print_separator('-', 60);
+
+	static const int16_t spin[3] = {0, 0, 900};   /* 90 dps */
+	struct imu_fusion f;
+
+	imu_fusion_init(&f, 0);
+	feed(&f, 0, 10000, 101, 0.0, 0.0, spin);      /* 100 intervals = 1 s */
+	assert_near("Yaw after 1 s at 90 dps", 900, angle_ddeg(&f, IMU_YAW), 2);
+	assert_near("Roll unaffected", 0, angle_ddeg(&f, IMU_ROLL), 2);
+
+	imu_fusion_zero_yaw(&f);
+	assert_near("Yaw zeroed", 0, angle_ddeg(&f, IMU_YAW), 0);
+}
+
+static void test_yaw_wrap(void)
+{
+	printf("\nTest: Yaw Wraps at +/-180\n");
+	print_separator('-', 60);
+
+	static const int16_t spin[3] = {0, 0, 1800};  /* 180 dps */
+	struct imu_fusion f;
+
+	imu_fusion_init(&f, 0);
+	feed(&f, 0, 10000, 151, 0.0, 0.0, spin);      /* 1.5 s = 270 deg */
+	assert_near("Yaw 270 deg reads -90", -900, angle_ddeg(&f, IMU_YAW), 2);
+}
+
+static void test_roll_tracking(void)
+{
+	printf("\nTest: Roll Follows a Rotation\n");
+	print_separator('-', 60);
+
+	static const int16_t rate[3] = {450, 0, 0};   /* 45 dps */
+	struct imu_fusion f;
+	int16_t accel[3];
+	int32_t worst = 0;
+
+	imu_fusion_init(&f, 0);
+	for (int i = 0; i <= 100; i++) {
+		double roll = 45.0 * i / 100.0;
+		gravity_mg(roll, 0.0, accel);
+		imu_fusion_update(&f, accel, rate, (uint32_t)i * 10000);
+		int32_t err = abs(angle_ddeg(&f, IMU_ROLL) - (int32_t)lround(roll * 10.0));
+		worst = err > worst ? err : worst;
+	}
+	assert_near("Roll after 1 s at 45 dps", 450, angle_ddeg(&f, IMU_ROLL), 3);
+	assert_true("Tracks within 0.3 deg throughout", worst <= 3);
+}
+
+static void test_gyro_bias(void)
+{
+	printf("\nTest: Gyro Bias Learned While Still\n");
+	print_separator('-', 60);
+
+	static const int16_t biased[3] = {12, -8, 15}; /* 1.2, -0.8, 1.5 dps offset */
+	struct imu_fusion f;
+
+	imu_fusion_init(&f, 0);
+	uint32_t t = feed(&f, 0, 10000, 500, 0.0, 0.0, biased);
+	assert_near("Bias X learned (q12)", 12 * 4096, f.bias_q12[0], 64);
+	assert_near("Bias Z learned (q12)", 15 * 4096, f.bias_q12[2], 64);
+
+	/* Without learning, 1.5 dps over 10 s would be 15 degrees */
+	imu_fusion_zero_yaw(&f);
+	feed(&f, t, 10000, 1000, 0.0, 0.0, biased);
+	assert_near("Yaw drift over 10 s", 0, angle_ddeg(&f, IMU_YAW), 5);
+
+	static const int16_t moving[3] = {0, 0, 600};
+	int32_t before = f.bias_q12[2];
+	feed(&f, t + 10000000, 10000, 50, 0.0, 0.0, moving);
+	assert_near("Bias not learned while rotating", before, f.bias_q12[2], 0);
+}
+
+static void test_strum_rejection(void)
+{
+	printf("\nTest: Strum Spikes Do Not Pull Tilt\n");
+	print_separator('-', 60);
+
+	static const int16_t still[3] = {0, 0, 0};
+	static const int16_t spike[3] = {2500, -1800, 3000};
+	struct imu_fusion f;
+
+	imu_fusion_init(&f, 0);
+	uint32_t t = feed(&f, 0, 10000, 50, 10.0, 5.0, still);
+
+	for (int i = 0; i < 20; i++) {
+		imu_fusion_update(&f, spike, still, t);
+		t += 10000;
+	}
+	assert_equal_uint32("Spikes rejected", 20, f.accel_rejected);
+	assert_near("Roll unchanged", 100, angle_ddeg(&f, IMU_ROLL), 2);
+	assert_near("Pitch unchanged", 50, angle_ddeg(&f, IMU_PITCH), 2);
+}
+
+static void test_rate_independence(void)
+{
+	printf("\nTest: Correction Independent of Sample Rate\n");
+	print_separator('-', 60);
+
+	/* Same gyro error at 50 Hz and 200 Hz settles to the same angle */
+	static const int16_t zero[3] = {0, 0, 0};
+	struct imu_fusion slow, fast;
+
+	imu_fusion_init(&slow, 0);
+	imu_fusion_init(&fast, 0);
+	feed(&slow, 0, 20000, 1, 0.0, 0.0, zero);
+	feed(&fast, 0, 5000, 1, 0.0, 0.0, zero);
+
+	/* Pose jumps to 40 deg roll with no gyro: pure accel correction */
+	feed(&slow, 20000, 20000, 25, 40.0, 0.0, zero);   /* 0.5 s */
+	feed(&fast, 5000, 5000, 100, 40.0, 0.0, zero);    /* 0.5 s */
+
+	int16_t r_slow = angle_ddeg(&slow, IMU_ROLL);
+	int16_t r_fast = angle_ddeg(&fast, IMU_ROLL);
+	printf("  Roll after 0.5 s: %d (50 Hz), %d (200 Hz) ddeg\n", r_slow, r_fast);
+	assert_near("~1 - 1/e of the step after tau", 253, r_fast, 15);
+	assert_near("50 Hz matches 200 Hz", r_fast, r_slow, 10);
+}
+
+static void test_gap_restart(void)
+{
+	printf("\nTest: Long Gap Restarts from Accel\n");
+	print_separator('-', 60);
+
+	static const int16_t zero[3] = {0, 0, 0};
+	static const int16_t spin[3] = {0, 0, 300};
+	struct imu_fusion f;
+
+	imu_fusion_init(&f, 0);
+	uint32_t t = feed(&f, 0xFFFFF000u, 10000, 50, 0.0, 0.0, spin);  /* Clock wraps */
+	int16_t yaw = angle_ddeg(&f, IMU_YAW);
+	assert_near("Yaw across clock wrap", 147, yaw, 2);
+
+	/* One second gap, guitar now at 60 deg roll */
+	feed(&f, t + 1000000, 10000, 1, 60.0, 0.0, zero);
+	assert_near("Roll snaps after gap", 600, angle_ddeg(&f, IMU_ROLL), 2);
+	assert_near("Yaw kept, gap not integrated", yaw, angle_ddeg(&f, IMU_YAW), 0);
+}
+
+/* ============================================================
+ * MAIN
+ * ============================================================ */
+
+int main(void)
+{
+	printf("\n");
+	print_separator('=', 60);
+	printf("IMU FUSION UNIT TESTS\n");
+	print_separator('=', 60);
+
+	test_atan2();
+	test_wrap_and_sqrt();
+	test_static_tilt();
+	test_yaw_integration();
+	test_yaw_wrap();
+	test_roll_tracking();
+	test_gyro_bias();
+	test_strum_rejection();
+	test_rate_independence();
+	test_gap_restart();
+
+	printf("\n");
+	print_separator('=', 60);
+	printf("TEST SUMMARY\n");
+	print_separator('=', 60);
+	printf("Total tests:  %d\n", total_tests);
+	printf("Passed:       %d\n", passed_tests);
+	printf("Failed:       %d\n", failed_tests);
+	printf("Success rate: %.1f%%\n",
+	       total_tests > 0 ? (100.0 * passed_tests / total_tests) : 0.0);
+	print_separator('=', 60);
+
+	return (failed_tests == 0) ? 0 : 1;
+}
@@ -0,0 +1,298 @@
+/*
+ * Motion-to-MIDI Latency Tracker Unit Tests
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "../src/latency_tracker.h"
+
+/* Test statistics */
+static int total_tests = 0;
+static int passed_tests = 0;
+static int failed_tests = 0;
+
+/* Test utilities */
+static void print_separator(char c, int length)
+{
+	for (int i = 0; i < length; i++) {
+		putchar(c);
+	}
+	putchar('\n');
+}
+
+static void assert_equal_uint32(const char *test_name, uint32_t expected, uint32_t actual)
+{
+	total_tests++;
+	if (expected == actual) {
+		printf("  ✓ %s: %u\n", test_name, actual);
+		passed_tests++;
+	} else {
+		printf("  ✗ %s: expected %u, got %u\n", test_name, expected, actual);
+		failed_tests++;
+	}
+}
+
+static void assert_true(const char *test_name, bool condition)
+{
+	total_tests++;
+	if (condition) {
+		printf("  ✓ %s\n", test_name);
+		passed_tests++;
+	} else {
+		printf("  ✗ %s: assertion failed\n", test_name);
+		failed_tests++;
+	}
+}
+
+/* ============================================================
+ * TEST CASES
+ * ============================================================ */
+
+static void test_clock_min_filter(void)
+{
+	printf("\nTest: Clock Offset Min Filter\n");
+	print_separator('-', 60);
+
+	struct latency_clock clk;
+	latency_clock_reset(&clk);
+
+	/* Remote clock runs 5 s behind local; transit varies 2-9 ms */
+	const uint32_t true_offset = 5000000;
+	const uint32_t transit[] = {7000, 2000, 9000, 4000, 3000};
+
+	assert_equal_uint32("Unsynced passthrough", 1234, latency_clock_to_local(&clk, 1234));
+
+	for (int i = 0; i < 5; i++) {
+		uint32_t remote = 100000 * i;
+		latency_clock_update(&clk, remote, remote + true_offset + transit[i]);
+	}
+
+	assert_true("Clock valid after samples", clk.valid);
+	assert_equal_uint32("Offset = true offset + min transit", true_offset + 2000, clk.offset_us);
+	assert_equal_uint32("Remote->local conversion", 600000 + true_offset + 2000,
+	                    latency_clock_to_local(&clk, 600000));
+}
+
+static void test_clock_wraparound(void)
+{
+	printf("\nTest: Clock Offset Across 32-bit Wrap\n");
+	print_separator('-', 60);
+
+	struct latency_clock clk;
+	latency_clock_reset(&clk);
+
+	/* Local clock just below wrap, remote clock near zero */
+	uint32_t remote = 1000;
+	uint32_t local = 0xFFFFF000u;
+
+	latency_clock_update(&clk, remote, local + 3000);
+	latency_clock_update(&clk, remote + 100000, local + 100000 + 1500);
+
+	/* Local time wraps past zero; conversion must follow */
+	uint32_t converted = latency_clock_to_local(&clk, remote + 200000);
+	assert_equal_uint32("Converted time wraps", local + 200000 + 1500, converted);
+	assert_true("Converted time is past wrap", converted < local);
+}
+
+static void test_clock_window_drift(void)
+{
+	printf("\nTest: Clock Offset Follows Drift\n");
+	print_separator('-', 60);
+
+	struct latency_clock clk;
+	latency_clock_reset(&clk);
+
+	/* First window establishes a low minimum */
+	for (int i = 0; i < LATENCY_CLOCK_WINDOW; i++) {
+		uint32_t remote = 100000 * i;
+		latency_clock_update(&clk, remote, remote + 1000 + (i % 4) * 1000);
+	}
+	assert_equal_uint32("Offset after first window", 1000, clk.offset_us);
+
+	/* Remote clock now lags by an extra 3 ms; minimum rises accordingly */
+	for (int i = 0; i < LATENCY_CLOCK_WINDOW; i++) {
+		uint32_t remote = 100000 * (LATENCY_CLOCK_WINDOW + i);
+		latency_clock_update(&clk, remote, remote + 4000 + (i % 4) * 1000);
+	}
+	assert_equal_uint32("Offset re-anchored to new window min", 4000, clk.offset_us);
+}
+
+static void test_record_segments(void)
+{
+	printf("\nTest: Segment Recording\n");
+	print_separator('-', 60);
+
+	static struct latency_tracker t;
+	latency_init(&t);
+
+	/* sample=0, rx=7.5 ms, queued=7.6 ms, done=8.56 ms */
+	latency_record(&t, 0, 7500, 7600, 8560);
+
+	assert_equal_uint32("Radio", 7500, t.hist[LAT_SEG_RADIO].max_us);
+	assert_equal_uint32("Process", 100, t.hist[LAT_SEG_PROCESS].max_us);
+	assert_equal_uint32("UART TX", 960, t.hist[LAT_SEG_TX].max_us);
+	assert_equal_uint32("Total", 8560, t.hist[LAT_SEG_TOTAL].max_us);
+	assert_equal_uint32("Total in 8 ms bucket", 1, t.hist[LAT_SEG_TOTAL].buckets[8]);
+
+	/* Sample time after receive (offset error) clamps to zero */
+	latency_record(&t, 9000, 8000, 8000, 8000);
+	assert_equal_uint32("Negative radio clamps to 0", 0, t.hist[LAT_SEG_RADIO].min_us);
+
+	/* Overflow lands in last bucket */
+	latency_record(&t, 0, 0, 0, 500000);
+	assert_equal_uint32("Overflow bucket", 1,
+	                    t.hist[LAT_SEG_TX].buckets[LATENCY_HIST_BUCKETS - 1]);
+}
+
+static void test_percentiles(void)
+{
+	printf("\nTest: Percentiles\n");
+	print_separator('-', 60);
+
+	static struct latency_tracker t;
+	latency_init(&t);
+
+	assert_equal_uint32("Empty histogram", 0,
+	                    latency_percentile_us(&t.hist[LAT_SEG_TOTAL], 99));
+
+	/* 90 samples at 2.5 ms, 10 samples at 20.2 ms */
+	for (int i = 0; i < 90; i++) {
+		latency_record(&t, 0, 0, 0, 2500);
+	}
+	for (int i = 0; i < 10; i++) {
+		latency_record(&t, 0, 0, 0, 20200);
+	}
+
+	const struct latency_hist *h = &t.hist[LAT_SEG_TOTAL];
+	assert_equal_uint32("P50 = 2 ms bucket upper bound", 2999, latency_percentile_us(h, 50));
+	assert_equal_uint32("P90 still in 2 ms bucket", 2999, latency_percentile_us(h, 90));
+	assert_equal_uint32("P99 clamped to max", 20200, latency_percentile_us(h, 99));
+	assert_equal_uint32("P100 = max", 20200, latency_percentile_us(h, 100));
+}
+
+static void test_pending_uart_completion(void)
+{
+	printf("\nTest: Pending UART Completion\n");
+	print_separator('-', 60);
+
+	static struct latency_tracker t;
+	latency_init(&t);
+
+	/* Model a 16-byte TX ring; three 3-byte CCs queued starting at position 14 */
+	const uint16_t ring = 16;
+	uint16_t head = 14;
+	uint16_t tail = 14;
+
+	for (int i = 0; i < 3; i++) {
+		head = (head + 3) % ring;
+		assert_true("Queued", latency_mark_queued(&t, 0, 7000, 7100, head) == 0);
+	}
+
+	/* UART sends 9 bytes, 320 us each (31250 baud) */
+	uint32_t now = 7100;
+	for (int b = 0; b < 9; b++) {
+		now += 320;
+		tail = (tail + 1) % ring;
+		latency_mark_tx(&t, tail, now);
+	}
+
+	const struct latency_hist *tx = &t.hist[LAT_SEG_TX];
+	assert_equal_uint32("Three CCs completed", 3, tx->count);
+	assert_equal_uint32("First CC after 3 bytes", 960, tx->min_us);
+	assert_equal_uint32("Last CC after 9 bytes", 2880, tx->max_us);
+	assert_true("Pending ring drained", t.pend_head == t.pend_tail);
+
+	/* Bytes with no pending entry are ignored */
+	latency_mark_tx(&t, 5, now);
+	assert_equal_uint32("No spurious completion", 3, tx->count);
+}
+
+static void test_pending_overflow(void)
+{
+	printf("\nTest: Pending Ring Overflow\n");
+	print_separator('-', 60);
+
+	static struct latency_tracker t;
+	latency_init(&t);
+
+	int accepted = 0;
+	for (int i = 0; i < LATENCY_MAX_PENDING + 2; i++) {
+		if (latency_mark_queued(&t, 0, 0, 0, (uint16_t)i) == 0) {
+			accepted++;
+		}
+	}
+
+	assert_equal_uint32("Ring holds MAX_PENDING - 1", LATENCY_MAX_PENDING - 1, (uint32_t)accepted);
+	assert_equal_uint32("Drops counted", 3, t.pending_dropped);
+
+	latency_reset(&t);
+	assert_equal_uint32("Reset clears drops", 0, t.pending_dropped);
+	assert_true("Reset clears pending", t.pend_head == t.pend_tail);
+}
+
+static void test_dump(void)
+{
+	printf("\nTest: Binary Dump\n");
+	print_separator('-', 60);
+
+	static struct latency_tracker t;
+	static uint8_t buf[LATENCY_DUMP_SIZE];
+
+	latency_init(&t);
+	latency_record(&t, 0, 1000, 1200, 2500);
+
+	assert_true("Short buffer rejected", latency_dump(&t, buf, 10) == -1);
+	assert_equal_uint32("Dump size", LATENCY_DUMP_SIZE, (uint32_t)latency_dump(&t, buf, sizeof(buf)));
+
+	struct latency_dump_header hdr;
+	memcpy(&hdr, buf, sizeof(hdr));
+	assert_equal_uint32("Magic", LATENCY_DUMP_MAGIC, hdr.magic);
+	assert_equal_uint32("Segments", LAT_SEG_COUNT, hdr.segment_count);
+	assert_equal_uint32("Bucket width", LATENCY_BUCKET_US, hdr.bucket_us);
+
+	struct latency_hist total;
+	memcpy(&total, buf + sizeof(hdr) + LAT_SEG_TOTAL * sizeof(struct latency_hist),
+	       sizeof(total));
+	assert_equal_uint32("Total histogram round-trips", 2500, total.max_us);
+	assert_true("Segment name", strcmp(latency_segment_name(LAT_SEG_TX), "uart_tx") == 0);
+}
+
+/* ============================================================
+ * MAIN
+ * ============================================================ */
+
+int main(void)
+{
+	printf("\n");
+	print_separator('=', 60);
+	printf("LATENCY TRACKER UNIT TESTS\n");
+	print_separator('=', 60);
+
+	test_clock_min_filter();
+	test_clock_wraparound();
+	test_clock_window_drift();
+	test_record_segments();
+	test_percentiles();
+	test_pending_uart_completion();
+	test_pending_overflow();
+	test_dump();
+
+	printf("\n");
+	print_separator('=', 60);
+	printf("TEST SUMMARY\n");
+	print_separator('=', 60);
+	printf("Total tests:  %d\n", total_tests);
+	printf("Passed:       %d\n", passed_tests);
+	printf("Failed:       %d\n", failed_tests);
+	printf("Success rate: %.1f%%\n",
+	       total_tests > 0 ? (100.0 * passed_tests / total_tests) : 0.0);
+	print_separator('=', 60);
+
+	return (failed_tests == 0) ? 0 : 1;
+}
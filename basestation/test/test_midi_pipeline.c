@@ -0,0 +1,381 @@
+/*
+ * MIDI Pipeline Unit Tests
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+
+#include "../src/midi_pipeline.h"
+
+/* Test statistics */
+static int total_tests = 0;
+static int passed_tests = 0;
+static int failed_tests = 0;
+
+/* Test utilities */
+static void print_separator(char c, int length)
+{
+	for (int i = 0; i < length; i++) {
+		putchar(c);
+	}
+	putchar('\n');
+}
+
+static void assert_equal_uint32(const char *test_name, uint32_t expected, uint32_t actual)
+{
+	total_tests++;
+	if (expected == actual) {
+		printf("  ✓ %s: %u\n", test_name, actual);
+		passed_tests++;
+	} else {
+		printf("  ✗ %s: expected %u, got %u\n", test_name, expected, actual);
+		failed_tests++;
+	}
+}
+
+static void assert_true(const char *test_name, bool condition)
+{
+	total_tests++;
+	if (condition) {
+		printf("  ✓ %s\n", test_name);
+		passed_tests++;
+	} else {
+		printf("  ✗ %s: assertion failed\n", test_name);
+		failed_tests++;
+	}
+}
+
+/* ============================================================
+ * TX BACKEND
+ * ============================================================ */
+
+struct tx_log {
+	uint8_t msgs[64][3];
+	int outputs[64];
+	int guitars[64];
+	int count;
+	int accept;       /* Accept this many, then reject (-1 = all) */
+};
+
+static int log_tx(int guitar_id, int output, const uint8_t *msg, size_t len, void *user_data)
+{
+	struct tx_log *log = user_data;
+
+	if (log->accept == 0 || len != 3 || log->count >= 64) {
+		return -ENOMEM;
+	}
+	if (log->accept > 0) {
+		log->accept--;
+	}
+	memcpy(log->msgs[log->count], msg, 3);
+	log->outputs[log->count] = output;
+	log->guitars[log->count] = guitar_id;
+	log->count++;
+	return 0;
+}
+
+/* UART model backend at the simulated time in ctx */
+struct uart_ctx {
+	struct midi_uart_model uart;
+	uint32_t now_us;
+};
+
+static int uart_tx(int guitar_id, int output, const uint8_t *msg, size_t len, void *user_data)
+{
+	struct uart_ctx *ctx = user_data;
+
+	(void)guitar_id;
+	(void)output;
+	(void)msg;
+	return midi_uart_model_queue(&ctx->uart, ctx->now_us, len, NULL);
+}
+
+/* Factory default patch: T1 per axis, linear ±2g -> 0..127, CC 16-21 */
+static void configure_default(struct midi_pipeline *pipe, uint8_t channel, int16_t deadzone)
+{
+	struct patch_topology_config topo;
+	struct function_unit funcs[MAX_FUNCTION_UNITS];
+
+	topology_patch_init_default(&topo);
+	for (int f = 0; f < MAX_FUNCTION_UNITS; f++) {
+		func_init_linear(&funcs[f], -2000, 2000, 0, 127);
+	}
+	midi_pipeline_configure(pipe, topo.topologies, topo.default_mixer_type, funcs,
+	                        channel, deadzone);
+}
+
+/* ============================================================
+ * TEST CASES
+ * ============================================================ */
+
+static void test_first_sample(void)
+{
+	printf("\nTest: First Sample Sends Every Output\n");
+	print_separator('-', 60);
+
+	static struct midi_pipeline pipe;
+	struct tx_log log = {.accept = -1};
+	int16_t in[MAX_SENSOR_SOURCES] = {1000, 0, -2000, 0, 0, 0};
+
+	midi_pipeline_init(&pipe, log_tx, &log);
+	configure_default(&pipe, 2, 1);
+
+	assert_equal_uint32("Messages accepted", MAX_MIDI_OUTPUTS,
+	                    (uint32_t)midi_pipeline_process(&pipe, 3, in));
+	assert_equal_uint32("TX calls", MAX_MIDI_OUTPUTS, (uint32_t)log.count);
+	assert_equal_uint32("Status byte (CC, channel 3)", 0xB2, log.msgs[0][0]);
+	assert_equal_uint32("Output 0 CC", 16, log.msgs[0][1]);
+	assert_equal_uint32("Output 5 CC", 21, log.msgs[5][1]);
+	assert_equal_uint32("X=1000 mg", 95, log.msgs[0][2]);
+	assert_equal_uint32("Z=-2000 mg", 0, log.msgs[2][2]);
+	assert_equal_uint32("Output index passed", 4, (uint32_t)log.outputs[4]);
+	assert_equal_uint32("Guitar id passed", 3, (uint32_t)log.guitars[0]);
+	assert_equal_uint32("Outputs kept for telemetry", 95, pipe.outputs[0]);
+	assert_equal_uint32("Samples", 1, pipe.samples);
+}
+
+static void test_deadzone(void)
+{
+	printf("\nTest: Deadzone\n");
+	print_separator('-', 60);
+
+	static struct midi_pipeline pipe;
+	struct tx_log log = {.accept = -1};
+	int16_t in[MAX_SENSOR_SOURCES] = {0, 0, 0, 0, 0, 0};
+
+	midi_pipeline_init(&pipe, log_tx, &log);
+	configure_default(&pipe, 0, 4);
+	midi_pipeline_process(&pipe, 0, in);
+	log.count = 0;
+
+	/* 63 -> 66: below deadzone of 4 */
+	in[0] = 100;
+	assert_equal_uint32("Change of 3 suppressed", 0, (uint32_t)midi_pipeline_process(&pipe, 0, in));
+
+	/* 63 -> 67: reaches deadzone, measured from the last value sent */
+	in[0] = 130;
+	assert_equal_uint32("Change of 4 sent", 1, (uint32_t)midi_pipeline_process(&pipe, 0, in));
+	assert_equal_uint32("Sent value", 67, log.msgs[0][2]);
+
+	midi_pipeline_resend_all(&pipe);
+	assert_equal_uint32("Resend all", MAX_MIDI_OUTPUTS,
+	                    (uint32_t)midi_pipeline_process(&pipe, 0, in));
+
+	/* Negative deadzone is treated as 0: every sample sends */
+	configure_default(&pipe, 0, -5);
+	assert_equal_uint32("Deadzone clamped", 0, (uint32_t)pipe.deadzone);
+	assert_equal_uint32("Unchanged values sent with deadzone 0", MAX_MIDI_OUTPUTS,
+	                    (uint32_t)midi_pipeline_process(&pipe, 0, in));
+}
+
+static void test_cc_numbers(void)
+{
+	printf("\nTest: CC Numbers From Patch\n");
+	print_separator('-', 60);
+
+	static struct midi_pipeline pipe;
+	struct patch_topology_config topo;
+	struct function_unit funcs[MAX_FUNCTION_UNITS];
+	struct tx_log log = {.accept = -1};
+	int16_t in[MAX_SENSOR_SOURCES] = {0, 0, 0, 0, 0, 0};
+
+	topology_patch_init_default(&topo);
+	for (int f = 0; f < MAX_FUNCTION_UNITS; f++) {
+		func_init_linear(&funcs[f], -2000, 2000, 0, 127);
+	}
+	topo.topologies[0].midi_outputs[0] = 74;
+	topo.topologies[1].enabled = 0;
+
+	midi_pipeline_init(&pipe, log_tx, &log);
+	midi_pipeline_configure(&pipe, topo.topologies, topo.default_mixer_type, funcs, 0, 1);
+
+	/* Configure takes a copy: later edits to the caller's patch have no effect */
+	topo.topologies[0].midi_outputs[0] = 1;
+
+	midi_pipeline_process(&pipe, 0, in);
+	assert_equal_uint32("Topology CC", 74, log.msgs[0][1]);
+	assert_equal_uint32("Disabled topology falls back to 16 + i", 17, log.msgs[1][1]);
+	assert_equal_uint32("Disabled topology outputs 0", 0, log.msgs[1][2]);
+	assert_equal_uint32("Mixer type copied", topo.default_mixer_type,
+	                    pipe.topo.default_mixer_type);
+}
+
+static void test_source_mask(void)
+{
+	printf("\nTest: Referenced Source Mask\n");
+	print_separator('-', 60);
+
+	static struct midi_pipeline pipe;
+	struct patch_topology_config topo;
+	struct function_unit funcs[MAX_FUNCTION_UNITS];
+	struct tx_log log = {.accept = -1};
+	int16_t in[MAX_SENSOR_SOURCES] = {0};
+
+	midi_pipeline_init(&pipe, log_tx, &log);
+	assert_equal_uint32("Empty patch reads nothing", 0, pipe.source_mask);
+
+	configure_default(&pipe, 0, 1);
+	assert_equal_uint32("Default patch reads sensors only", 0x3F, pipe.source_mask);
+
+	topology_patch_init_default(&topo);
+	for (int f = 0; f < MAX_FUNCTION_UNITS; f++) {
+		func_init_linear(&funcs[f], 0, 2000, 0, 127);
+	}
+	topo.topologies[0].accel_inputs[0] = SOURCE_MAGNITUDE;
+	topo.topologies[1].topology_type = TOPO_T2;
+	topo.topologies[1].accel_inputs[0] = SOURCE_JERK;
+	topo.topologies[1].accel_inputs[1] = SOURCE_ENERGY;
+	topo.topologies[2].enabled = 0;
+	midi_pipeline_configure(&pipe, topo.topologies, topo.default_mixer_type, funcs, 0, 1);
+	assert_equal_uint32("Derived inputs and T2 second input set",
+	                    (1u << SOURCE_MAGNITUDE) | (1u << SOURCE_JERK) | (1u << SOURCE_ENERGY) |
+	                    0x38, pipe.source_mask);
+
+	in[SOURCE_MAGNITUDE] = 1000;
+	midi_pipeline_process(&pipe, 0, in);
+	assert_equal_uint32("Derived source routed to CC", 63, log.msgs[0][2]);
+}
+
+static void test_tx_drop(void)
+{
+	printf("\nTest: TX Backend Drops\n");
+	print_separator('-', 60);
+
+	static struct midi_pipeline pipe;
+	struct tx_log log = {.accept = 3};
+	int16_t in[MAX_SENSOR_SOURCES] = {0, 0, 0, 0, 0, 0};
+
+	midi_pipeline_init(&pipe, log_tx, &log);
+	configure_default(&pipe, 0, 1);
+
+	assert_equal_uint32("Accepted", 3, (uint32_t)midi_pipeline_process(&pipe, 0, in));
+	assert_equal_uint32("Messages", 3, pipe.messages);
+	assert_equal_uint32("Dropped", 3, pipe.dropped);
+
+	/* As in the firmware, a dropped value is not retried until it changes */
+	log.accept = -1;
+	log.count = 0;
+	assert_equal_uint32("No retry of unchanged drops", 0,
+	                    (uint32_t)midi_pipeline_process(&pipe, 0, in));
+
+	static struct midi_pipeline no_tx;
+	midi_pipeline_init(&no_tx, NULL, NULL);
+	configure_default(&no_tx, 0, 1);
+	assert_equal_uint32("No backend: nothing accepted", 0,
+	                    (uint32_t)midi_pipeline_process(&no_tx, 0, in));
+	assert_equal_uint32("No backend: all dropped", MAX_MIDI_OUTPUTS, no_tx.dropped);
+}
+
+static void test_tx_fits(void)
+{
+	printf("\nTest: TX Ring Admission\n");
+	print_separator('-', 60);
+
+	assert_true("Empty ring accepts 3", midi_tx_fits(0, 3));
+	assert_true("6 queued accepts 3", midi_tx_fits(MIDI_TX_MAX_QUEUED, 3));
+	assert_true("7 queued rejects", !midi_tx_fits(MIDI_TX_MAX_QUEUED + 1, 1));
+	assert_true("Message larger than free space rejected", !midi_tx_fits(0, MIDI_TX_QUEUE_SIZE));
+	assert_true("Message filling free space accepted", midi_tx_fits(0, MIDI_TX_QUEUE_SIZE - 1));
+}
+
+static void test_uart_model(void)
+{
+	printf("\nTest: UART Model\n");
+	print_separator('-', 60);
+
+	struct midi_uart_model uart;
+	uint32_t done = 0;
+	const uint32_t t0 = 0xFFFFF000u;  /* Cross the 32-bit wrap */
+
+	midi_uart_model_init(&uart);
+
+	assert_equal_uint32("First CC queued", 0, (uint32_t)midi_uart_model_queue(&uart, t0, 3, &done));
+	assert_equal_uint32("First CC done", t0 + 960, done);
+	midi_uart_model_queue(&uart, t0, 3, &done);
+	midi_uart_model_queue(&uart, t0, 3, &done);
+	assert_equal_uint32("Third CC waits behind two", t0 + 2880, done);
+	assert_equal_uint32("Fourth CC dropped (8 bytes queued)", (uint32_t)-ENOMEM,
+	                    (uint32_t)midi_uart_model_queue(&uart, t0, 3, &done));
+	assert_equal_uint32("Max backlog", 1920, uart.max_backlog_us);
+
+	/* Two bytes later 6 remain behind the one on the wire */
+	assert_equal_uint32("Accepted once drained to 6", 0,
+	                    (uint32_t)midi_uart_model_queue(&uart, t0 + 640, 3, &done));
+	assert_equal_uint32("Appended after backlog", t0 + 3840, done);
+
+	/* Idle line: starts immediately */
+	assert_equal_uint32("Idle queue", 0,
+	                    (uint32_t)midi_uart_model_queue(&uart, t0 + 10000, 3, &done));
+	assert_equal_uint32("Idle done", t0 + 10960, done);
+	assert_equal_uint32("Queued count", 5, uart.queued);
+	assert_equal_uint32("Dropped count", 1, uart.dropped);
+}
+
+static void test_pipeline_with_uart(void)
+{
+	printf("\nTest: Pipeline Into UART Model\n");
+	print_separator('-', 60);
+
+	static struct midi_pipeline pipe;
+	struct uart_ctx ctx = {.now_us = 0};
+	int16_t in[MAX_SENSOR_SOURCES] = {0, 0, 0, 0, 0, 0};
+
+	midi_uart_model_init(&ctx.uart);
+	midi_pipeline_init(&pipe, uart_tx, &ctx);
+	configure_default(&pipe, 0, 1);
+
+	/* Six CCs at once overflow the 16-byte ring after three */
+	assert_equal_uint32("Initial burst accepted", 3, (uint32_t)midi_pipeline_process(&pipe, 0, in));
+	assert_equal_uint32("Initial burst dropped", 3, pipe.dropped);
+
+	/* 100 Hz motion on X, Y, Z: three CCs per sample fit in 10 ms */
+	for (int n = 1; n <= 100; n++) {
+		ctx.now_us = (uint32_t)n * 10000;
+		in[0] = (int16_t)(n * 30);
+		in[1] = (int16_t)(-n * 30);
+		in[2] = (int16_t)(n * 15);
+		midi_pipeline_process(&pipe, 0, in);
+	}
+	assert_equal_uint32("No drops at 100 Hz", 3, pipe.dropped);
+	assert_true("Backlog under 3 CCs", ctx.uart.max_backlog_us < 3 * 960);
+}
+
+/* ============================================================
+ * MAIN
+ * ============================================================ */
+
+int main(void)
+{
+	printf("\n");
+	print_separator('=', 60);
+	printf("MIDI PIPELINE UNIT TESTS\n");
+	print_separator('=', 60);
+
+	test_first_sample();
+	test_deadzone();
+	test_cc_numbers();
+	test_source_mask();
+	test_tx_drop();
+	test_tx_fits();
+	test_uart_model();
+	test_pipeline_with_uart();
+
+	printf("\n");
+	print_separator('=', 60);
+	printf("TEST SUMMARY\n");
+	print_separator('=', 60);
+	printf("Total tests:  %d\n", total_tests);
+	printf("Passed:       %d\n", passed_tests);
+	printf("Failed:       %d\n", failed_tests);
+	printf("Success rate: %.1f%%\n",
+	       total_tests > 0 ? (100.0 * passed_tests / total_tests) : 0.0);
+	print_separator('=', 60);
+
+	return (failed_tests == 0) ? 0 : 1;
+}
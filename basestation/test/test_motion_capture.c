@@ -0,0 +1,205 @@
+/*
+ * Motion Capture Recorder Unit Tests
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "../src/motion_capture.h"
+
+/* Test statistics */
+static int total_tests = 0;
+static int passed_tests = 0;
+static int failed_tests = 0;
+
+/* Test utilities */
+static void print_separator(char c, int length)
+{
+	for (int i = 0; i < length; i++) {
+		putchar(c);
+	}
+	putchar('\n');
+}
+
+static void assert_equal_uint32(const char *test_name, uint32_t expected, uint32_t actual)
+{
+	total_tests++;
+	if (expected == actual) {
+		printf("  ✓ %s: %u\n", test_name, actual);
+		passed_tests++;
+	} else {
+		printf("  ✗ %s: expected %u, got %u\n", test_name, expected, actual);
+		failed_tests++;
+	}
+}
+
+static void assert_true(const char *test_name, bool condition)
+{
+	total_tests++;
+	if (condition) {
+		printf("  ✓ %s\n", test_name);
+		passed_tests++;
+	} else {
+		printf("  ✗ %s: assertion failed\n", test_name);
+		failed_tests++;
+	}
+}
+
+/* ============================================================
+ * TEST CASES
+ * ============================================================ */
+
+static void test_layout(void)
+{
+	printf("\nTest: File Layout\n");
+	print_separator('-', 60);
+
+	assert_equal_uint32("Header size", 16, sizeof(struct capture_header));
+	assert_equal_uint32("Record size", 18, sizeof(struct capture_record));
+
+	const uint8_t magic[4] = {'G', 'C', 'A', 'P'};
+	uint32_t m = CAPTURE_MAGIC;
+	assert_true("Magic reads GCAP in file order", memcmp(&m, magic, 4) == 0);
+}
+
+static void test_start_stop(void)
+{
+	printf("\nTest: Start and Stop\n");
+	print_separator('-', 60);
+
+	capture_init();
+	assert_true("Idle after init", !capture_active());
+
+	capture_record(0, 100, 0, 1, 2, 3, 0, 0, 0);
+	assert_equal_uint32("Not recorded while idle", 0, (uint32_t)capture_count());
+
+	capture_start(true);
+	assert_true("Recording", capture_active());
+	capture_record(0, 1000, CAPTURE_F_TIMED | CAPTURE_F_GYRO, 10, -20, 1000, 450, -5, 300);
+	capture_record(1, 2000, 0, 11, -21, 999, 0, 0, 0);
+	capture_stop();
+	capture_record(0, 3000, 0, 12, -22, 998, 0, 0, 0);
+	assert_equal_uint32("Two records held", 2, (uint32_t)capture_count());
+
+	struct capture_record rec;
+	assert_true("Get oldest", capture_get(0, &rec) == 0);
+	assert_equal_uint32("Timestamp", 1000, rec.timestamp_us);
+	assert_equal_uint32("Guitar", 0, rec.guitar);
+	assert_equal_uint32("Flags", CAPTURE_F_TIMED | CAPTURE_F_GYRO, rec.flags);
+	assert_true("Accel values", rec.x == 10 && rec.y == -20 && rec.z == 1000);
+	assert_true("Gyro values", rec.gx == 450 && rec.gy == -5 && rec.gz == 300);
+	assert_true("Get newest", capture_get(1, &rec) == 0);
+	assert_equal_uint32("Second guitar", 1, rec.guitar);
+	assert_true("Accel-only record has no gyro", rec.gx == 0 && rec.gy == 0 && rec.gz == 0);
+	assert_true("Out of range rejected", capture_get(2, &rec) == -1);
+	assert_true("NULL rejected", capture_get(0, NULL) == -1);
+
+	capture_start(false);
+	capture_record(0, 4000, 0, 0, 0, 0, 0, 0, 0);
+	capture_stop();
+	assert_equal_uint32("Resume keeps records", 3, (uint32_t)capture_count());
+
+	capture_start(true);
+	capture_stop();
+	assert_equal_uint32("Restart clears records", 0, (uint32_t)capture_count());
+}
+
+static void test_ring_wrap(void)
+{
+	printf("\nTest: Ring Wrap\n");
+	print_separator('-', 60);
+
+	capture_init();
+	capture_start(true);
+	for (uint32_t i = 0; i < CAPTURE_RING_SIZE + 5; i++) {
+		capture_record(0, i * 10, 0, (int16_t)i, 0, 0, 0, 0, 0);
+	}
+	capture_stop();
+
+	struct capture_record rec;
+	assert_equal_uint32("Ring full", CAPTURE_RING_SIZE, (uint32_t)capture_count());
+	assert_equal_uint32("Overwritten", 5, capture_overwritten());
+	capture_get(0, &rec);
+	assert_equal_uint32("Oldest is sample 5", 50, rec.timestamp_us);
+	capture_get(CAPTURE_RING_SIZE - 1, &rec);
+	assert_equal_uint32("Newest is last sample", (CAPTURE_RING_SIZE + 4) * 10, rec.timestamp_us);
+}
+
+static void test_header(void)
+{
+	printf("\nTest: Header Fill and Check\n");
+	print_separator('-', 60);
+
+	struct capture_header hdr;
+
+	capture_init();
+	capture_start(true);
+	capture_record(0, 1, 0, 0, 0, 0, 0, 0, 0);
+	capture_record(0, 2, 0, 0, 0, 0, 0, 0, 0);
+	capture_stop();
+	capture_fill_header(&hdr);
+
+	assert_equal_uint32("Magic", CAPTURE_MAGIC, hdr.magic);
+	assert_equal_uint32("Version", CAPTURE_VERSION, hdr.version);
+	assert_equal_uint32("Record size", sizeof(struct capture_record), hdr.record_size);
+	assert_equal_uint32("Record count", 2, hdr.record_count);
+	assert_equal_uint32("Not wrapped", 0, hdr.flags);
+
+	size_t data_len = 2 * sizeof(struct capture_record);
+	assert_true("Valid header accepted", capture_check_header(&hdr, data_len) == 0);
+	assert_true("Truncated data rejected", capture_check_header(&hdr, data_len - 1) == -1);
+
+	hdr.magic ^= 1;
+	assert_true("Bad magic rejected", capture_check_header(&hdr, data_len) == -1);
+	hdr.magic ^= 1;
+	hdr.version = CAPTURE_VERSION + 1;
+	assert_true("Bad version rejected", capture_check_header(&hdr, data_len) == -1);
+	hdr.version = CAPTURE_VERSION;
+	hdr.record_size = 12;
+	assert_true("Version 1 record size rejected", capture_check_header(&hdr, data_len) == -1);
+	assert_true("NULL rejected", capture_check_header(NULL, data_len) == -1);
+
+	capture_start(true);
+	for (uint32_t i = 0; i < CAPTURE_RING_SIZE + 1; i++) {
+		capture_record(0, i, 0, 0, 0, 0, 0, 0, 0);
+	}
+	capture_stop();
+	capture_fill_header(&hdr);
+	assert_equal_uint32("Wrapped flag", CAPTURE_H_WRAPPED, hdr.flags);
+	assert_equal_uint32("Overwritten in header", 1, hdr.overwritten);
+}
+
+/* ============================================================
+ * MAIN
+ * ============================================================ */
+
+int main(void)
+{
+	printf("\n");
+	print_separator('=', 60);
+	printf("MOTION CAPTURE UNIT TESTS\n");
+	print_separator('=', 60);
+
+	test_layout();
+	test_start_stop();
+	test_ring_wrap();
+	test_header();
+
+	printf("\n");
+	print_separator('=', 60);
+	printf("TEST SUMMARY\n");
+	print_separator('=', 60);
+	printf("Total tests:  %d\n", total_tests);
+	printf("Passed:       %d\n", passed_tests);
+	printf("Failed:       %d\n", failed_tests);
+	printf("Success rate: %.1f%%\n",
+	       total_tests > 0 ? (100.0 * passed_tests / total_tests) : 0.0);
+	print_separator('=', 60);
+
+	return (failed_tests == 0) ? 0 : 1;
+}
@@ -0,0 +1,308 @@
+/*
+ * Patch Bank Unit Tests
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+
+#include "../src/patch_bank.h"
+
+/* Test statistics */
+static int total_tests = 0;
+static int passed_tests = 0;
+static int failed_tests = 0;
+
+/* Test utilities */
+static void print_separator(char c, int length)
+{
+	for (int i = 0; i < length; i++) {
+		putchar(c);
+	}
+	putchar('\n');
+}
+
+static void assert_equal_uint32(const char *test_name, uint32_t expected, uint32_t actual)
+{
+	total_tests++;
+	if (expected == actual) {
+		printf("  ✓ %s: %u\n", test_name, actual);
+		passed_tests++;
+	} else {
+		printf("  ✗ %s: expected %u, got %u\n", test_name, expected, actual);
+		failed_tests++;
+	}
+}
+
+static void assert_true(const char *test_name, bool condition)
+{
+	total_tests++;
+	if (condition) {
+		printf("  ✓ %s\n", test_name);
+		passed_tests++;
+	} else {
+		printf("  ✗ %s: assertion failed\n", test_name);
+		failed_tests++;
+	}
+}
+
+/* ============================================================
+ * RAM BACKEND
+ * ============================================================ */
+
+static struct patch_record flash[PATCH_BANK_PROGRAMS];
+static bool flash_stored[PATCH_BANK_PROGRAMS];
+static uint32_t reads;
+
+static int ram_read(void *ctx, uint8_t program, struct patch_record *rec)
+{
+	(void)ctx;
+	reads++;
+	if (!flash_stored[program]) {
+		return -ENOENT;
+	}
+	memcpy(rec, &flash[program], sizeof(*rec));
+	return 0;
+}
+
+static void make_patch(struct patch_config *patch, int program)
+{
+	memset(patch, 0, sizeof(*patch));
+	patch->led_mode = (uint8_t)(program % 4);
+	patch->midi_deadzone = (int16_t)program;
+	snprintf(patch->patch_name, sizeof(patch->patch_name), "Program %d", program);
+}
+
+/* Store programs [first, last] in the RAM backend and the bank index */
+static void setup(struct patch_bank *bank, int first, int last)
+{
+	struct patch_config patch;
+
+	memset(flash, 0, sizeof(flash));
+	memset(flash_stored, 0, sizeof(flash_stored));
+	patch_bank_init(bank, ram_read, NULL);
+
+	for (int p = first; p <= last; p++) {
+		make_patch(&patch, p);
+		patch_record_encode(&flash[p], &patch);
+		flash_stored[p] = true;
+		patch_bank_set_stored(bank, (uint8_t)p, true);
+	}
+	reads = 0;
+}
+
+/* ============================================================
+ * TESTS
+ * ============================================================ */
+
+static void test_record(void)
+{
+	printf("\nTest: Patch Record\n");
+	print_separator('-', 60);
+
+	struct patch_config patch;
+	struct patch_record rec;
+
+	make_patch(&patch, 42);
+	patch_record_encode(&rec, &patch);
+	assert_equal_uint32("Version", PATCH_RECORD_VERSION, rec.version);
+	assert_equal_uint32("Size", sizeof(struct patch_config), rec.size);
+	assert_equal_uint32("Valid record", 0, patch_record_check(&rec));
+
+	rec.patch.patch_name[0] ^= 0x01;
+	assert_true("Flipped bit: -EBADMSG", patch_record_check(&rec) == -EBADMSG);
+	rec.patch.patch_name[0] ^= 0x01;
+	rec.version = PATCH_RECORD_VERSION + 1;
+	assert_true("Unknown version: -EBADMSG", patch_record_check(&rec) == -EBADMSG);
+	rec.version = PATCH_RECORD_VERSION;
+	rec.size--;
+	assert_true("Wrong size: -EBADMSG", patch_record_check(&rec) == -EBADMSG);
+}
+
+static void test_index(void)
+{
+	printf("\nTest: Index\n");
+	print_separator('-', 60);
+
+	struct patch_bank bank;
+
+	setup(&bank, 10, 19);
+	assert_equal_uint32("Programs stored", 10, patch_bank_count(&bank));
+	assert_true("Program 10 stored", patch_bank_is_stored(&bank, 10));
+	assert_true("Program 9 not stored", !patch_bank_is_stored(&bank, 9));
+	assert_true("Program 128 out of range", !patch_bank_is_stored(&bank, 128));
+
+	assert_true("Unstored program: NULL", patch_bank_get(&bank, 5) == NULL);
+	assert_equal_uint32("No read for an unstored program", 0, reads);
+	assert_equal_uint32("Not counted as a miss", 0, bank.stats.misses);
+}
+
+static void test_hit_and_miss(void)
+{
+	printf("\nTest: Cache Hits and Misses\n");
+	print_separator('-', 60);
+
+	struct patch_bank bank;
+	const struct patch_config *patch;
+
+	setup(&bank, 0, 127);
+
+	patch = patch_bank_get(&bank, 64);
+	assert_true("Miss returns the patch", patch && strcmp(patch->patch_name, "Program 64") == 0);
+	assert_equal_uint32("Miss: one read", 1, reads);
+	assert_equal_uint32("Misses", 1, bank.stats.misses);
+
+	patch = patch_bank_get(&bank, 64);
+	assert_true("Hit returns the patch", patch && patch->midi_deadzone == 64);
+	assert_equal_uint32("Hit: no read", 1, reads);
+	assert_equal_uint32("Hits", 1, bank.stats.hits);
+
+	/* Bounded cost: every get does at most one read, whatever the cache holds */
+	bool bounded = true;
+	srand(1);
+	for (int i = 0; i < 1000; i++) {
+		uint32_t before = reads;
+		patch_bank_get(&bank, (uint8_t)(rand() % PATCH_BANK_PROGRAMS));
+		bounded &= (reads - before) <= 1;
+	}
+	assert_true("1000 random switches: at most one read each", bounded);
+	assert_equal_uint32("Reads equal misses", bank.stats.misses, reads);
+}
+
+static void test_lru(void)
+{
+	printf("\nTest: LRU Eviction\n");
+	print_separator('-', 60);
+
+	struct patch_bank bank;
+
+	setup(&bank, 0, 127);
+
+	/* Fill the cache with programs 0..7, then touch 0 again */
+	for (int p = 0; p < PATCH_BANK_CACHE_SLOTS; p++) {
+		patch_bank_get(&bank, (uint8_t)p);
+	}
+	patch_bank_get(&bank, 0);
+	assert_equal_uint32("Cache full, no eviction yet", 0, bank.stats.evictions);
+
+	/* Program 8 evicts the least recently used: program 1 */
+	patch_bank_get(&bank, 8);
+	assert_equal_uint32("One eviction", 1, bank.stats.evictions);
+
+	reads = 0;
+	patch_bank_get(&bank, 0);
+	assert_equal_uint32("Program 0 (recently used) still cached", 0, reads);
+	patch_bank_get(&bank, 1);
+	assert_equal_uint32("Program 1 (least recent) was evicted", 1, reads);
+}
+
+static void test_prefetch(void)
+{
+	printf("\nTest: Prefetch\n");
+	print_separator('-', 60);
+
+	struct patch_bank bank;
+	const struct patch_config *patch;
+
+	setup(&bank, 20, 29);
+
+	patch = patch_bank_get(&bank, 22);
+	assert_equal_uint32("Neighbours read", 2, patch_bank_prefetch(&bank, 22));
+	assert_equal_uint32("Prefetches", 2, bank.stats.prefetches);
+	assert_equal_uint32("Prefetch again: already cached", 0, patch_bank_prefetch(&bank, 22));
+
+	reads = 0;
+	patch_bank_get(&bank, 23);
+	patch_bank_get(&bank, 21);
+	assert_equal_uint32("Next and previous program: no read", 0, reads);
+
+	/* Edge of the stored range: only program 28 exists next to 29 */
+	assert_true("Program 29 loads", patch_bank_get(&bank, 29) != NULL);
+	assert_equal_uint32("Program 29 prefetch reads 28 only", 1, patch_bank_prefetch(&bank, 29));
+
+	/* The active patch survives prefetches into a full cache */
+	setup(&bank, 0, 127);
+	patch = patch_bank_get(&bank, 50);
+	for (int p = 0; p < 40; p += 2) {
+		patch_bank_prefetch(&bank, (uint8_t)(p + 1));
+	}
+	assert_true("Active slot never evicted by prefetch",
+	            patch && patch->midi_deadzone == 50 && strcmp(patch->patch_name, "Program 50") == 0);
+	reads = 0;
+	patch_bank_get(&bank, 50);
+	assert_equal_uint32("Active program still cached", 0, reads);
+}
+
+static void test_errors(void)
+{
+	printf("\nTest: Bad Records and Updates\n");
+	print_separator('-', 60);
+
+	struct patch_bank bank;
+	struct patch_config patch;
+	const struct patch_config *got;
+
+	setup(&bank, 0, 9);
+
+	/* Corrupted in flash */
+	flash[3].patch.patch_name[2] ^= 0x40;
+	assert_true("Bad record: NULL", patch_bank_get(&bank, 3) == NULL);
+	assert_equal_uint32("Counted as an error", 1, bank.stats.errors);
+
+	/* Index says stored, backend has nothing */
+	flash_stored[4] = false;
+	assert_true("Missing record: NULL", patch_bank_get(&bank, 4) == NULL);
+	assert_equal_uint32("Errors", 2, bank.stats.errors);
+
+	/* Rewrite a cached program */
+	got = patch_bank_get(&bank, 5);
+	make_patch(&patch, 99);
+	patch_bank_update(&bank, 5, &patch);
+	reads = 0;
+	got = patch_bank_get(&bank, 5);
+	assert_true("Update refreshes the cached copy", got && got->midi_deadzone == 99);
+	assert_equal_uint32("Update: no read", 0, reads);
+
+	/* Update of a new program marks it stored */
+	patch_bank_update(&bank, 100, &patch);
+	assert_true("Update marks stored", patch_bank_is_stored(&bank, 100));
+
+	/* Delete drops the cached copy */
+	patch_bank_set_stored(&bank, 5, false);
+	assert_true("Deleted program: NULL", patch_bank_get(&bank, 5) == NULL);
+	assert_equal_uint32("Deleted program: no read", 0, reads);
+}
+
+int main(void)
+{
+	printf("\n");
+	print_separator('=', 60);
+	printf("PATCH BANK TESTS\n");
+	print_separator('=', 60);
+
+	test_record();
+	test_index();
+	test_hit_and_miss();
+	test_lru();
+	test_prefetch();
+	test_errors();
+
+	printf("\n");
+	print_separator('=', 60);
+	printf("TEST SUMMARY\n");
+	print_separator('=', 60);
+	printf("Total tests:  %d\n", total_tests);
+	printf("Passed:       %d\n", passed_tests);
+	printf("Failed:       %d\n", failed_tests);
+	printf("Success rate: %.1f%%\n",
+	       total_tests > 0 ? (100.0 * passed_tests / total_tests) : 0.0);
+	print_separator('=', 60);
+
+	return (failed_tests == 0) ? 0 : 1;
+}
@@ -0,0 +1,217 @@
+/*
+ * Pipeline Performance Profiler Unit Tests
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "../src/perf_profiler.h"
+
+/* Test statistics */
+static int total_tests = 0;
+static int passed_tests = 0;
+static int failed_tests = 0;
+
+/* Test utilities */
+static void print_separator(char c, int length)
+{
+	for (int i = 0; i < length; i++) {
+		putchar(c);
+	}
+	putchar('\n');
+}
+
+static void assert_equal_uint32(const char *test_name, uint32_t expected, uint32_t actual)
+{
+	total_tests++;
+	if (expected == actual) {
+		printf("  ✓ %s: %u\n", test_name, actual);
+		passed_tests++;
+	} else {
+		printf("  ✗ %s: expected %u, got %u\n", test_name, expected, actual);
+		failed_tests++;
+	}
+}
+
+static void assert_true(const char *test_name, bool condition)
+{
+	total_tests++;
+	if (condition) {
+		printf("  ✓ %s\n", test_name);
+		passed_tests++;
+	} else {
+		printf("  ✗ %s: assertion failed\n", test_name);
+		failed_tests++;
+	}
+}
+
+/* ============================================================
+ * TEST CASES
+ * ============================================================ */
+
+static void test_perf_reset(void)
+{
+	printf("\nTest: Reset\n");
+	print_separator('-', 60);
+
+	perf_init();
+	perf_record(PERF_STAGE_BLE_RX, 100);
+	perf_reset();
+
+	const struct perf_stage_stats *s = perf_get_stats(PERF_STAGE_BLE_RX);
+	assert_equal_uint32("Count cleared", 0, s->count);
+	assert_equal_uint32("Max cleared", 0, s->max_cycles);
+	assert_true("Min reset to sentinel", s->min_cycles == UINT32_MAX);
+
+	struct perf_summary sum;
+	assert_equal_uint32("Empty summary ok", 0, (uint32_t)perf_get_summary(PERF_STAGE_BLE_RX, &sum));
+	assert_equal_uint32("Empty summary count", 0, sum.count);
+}
+
+static void test_perf_min_avg_max(void)
+{
+	printf("\nTest: Min/Avg/Max\n");
+	print_separator('-', 60);
+
+	perf_reset();
+	perf_record(PERF_STAGE_TOPO_EXECUTE, 100);
+	perf_record(PERF_STAGE_TOPO_EXECUTE, 200);
+	perf_record(PERF_STAGE_TOPO_EXECUTE, 300);
+
+	/* Host backend counts nanoseconds, so cycles == ns */
+	struct perf_summary sum;
+	perf_get_summary(PERF_STAGE_TOPO_EXECUTE, &sum);
+	assert_equal_uint32("Count", 3, sum.count);
+	assert_equal_uint32("Min", 100, sum.min_ns);
+	assert_equal_uint32("Avg", 200, sum.avg_ns);
+	assert_equal_uint32("Max", 300, sum.max_ns);
+
+	/* Other stages untouched */
+	perf_get_summary(PERF_STAGE_UART_TX, &sum);
+	assert_equal_uint32("Other stage count", 0, sum.count);
+}
+
+static void test_perf_histogram_buckets(void)
+{
+	printf("\nTest: Log2 Histogram Buckets\n");
+	print_separator('-', 60);
+
+	perf_reset();
+	perf_record(PERF_STAGE_MIDI_QUEUE, 0);
+	perf_record(PERF_STAGE_MIDI_QUEUE, 1);
+	perf_record(PERF_STAGE_MIDI_QUEUE, 3);
+	perf_record(PERF_STAGE_MIDI_QUEUE, 4);
+	perf_record(PERF_STAGE_MIDI_QUEUE, UINT32_MAX);
+
+	const struct perf_stage_stats *s = perf_get_stats(PERF_STAGE_MIDI_QUEUE);
+	assert_equal_uint32("0 -> bucket 0", 1, s->hist[0]);
+	assert_equal_uint32("1 -> bucket 1", 1, s->hist[1]);
+	assert_equal_uint32("3 -> bucket 2", 1, s->hist[2]);
+	assert_equal_uint32("4 -> bucket 3", 1, s->hist[3]);
+	assert_equal_uint32("Overflow -> last bucket", 1, s->hist[PERF_HIST_BUCKETS - 1]);
+}
+
+static void test_perf_p99(void)
+{
+	printf("\nTest: P99 Estimate\n");
+	print_separator('-', 60);
+
+	/* 99 fast samples and one slow outlier: p99 stays in the fast bucket */
+	perf_reset();
+	for (int i = 0; i < 99; i++) {
+		perf_record(PERF_STAGE_FUNC_PROCESS, 50);
+	}
+	perf_record(PERF_STAGE_FUNC_PROCESS, 10000);
+
+	struct perf_summary sum;
+	perf_get_summary(PERF_STAGE_FUNC_PROCESS, &sum);
+	assert_equal_uint32("P99 ignores single outlier", 63, sum.p99_ns);
+	assert_equal_uint32("Max sees outlier", 10000, sum.max_ns);
+
+	/* Two slow samples in 100 push p99 into the slow bucket, clamped to max */
+	perf_record(PERF_STAGE_FUNC_PROCESS, 10000);
+	perf_get_summary(PERF_STAGE_FUNC_PROCESS, &sum);
+	assert_equal_uint32("P99 clamped to max", 10000, sum.p99_ns);
+
+	/* Single sample: p99 equals that sample */
+	perf_reset();
+	perf_record(PERF_STAGE_FUNC_PROCESS, 700);
+	perf_get_summary(PERF_STAGE_FUNC_PROCESS, &sum);
+	assert_equal_uint32("P99 of one sample", 700, sum.p99_ns);
+}
+
+static void test_perf_invalid_stage(void)
+{
+	printf("\nTest: Invalid Stage\n");
+	print_separator('-', 60);
+
+	struct perf_summary sum;
+
+	perf_record(PERF_STAGE_COUNT, 10);  /* Must not crash */
+	assert_true("Stats NULL for invalid stage", perf_get_stats(PERF_STAGE_COUNT) == NULL);
+	assert_true("Summary fails for invalid stage",
+	            perf_get_summary(PERF_STAGE_COUNT, &sum) == -1);
+	assert_true("Summary fails for NULL output",
+	            perf_get_summary(PERF_STAGE_BLE_RX, NULL) == -1);
+	assert_true("Name for invalid stage",
+	            strcmp(perf_stage_name(PERF_STAGE_COUNT), "unknown") == 0);
+	assert_true("Name for UART stage",
+	            strcmp(perf_stage_name(PERF_STAGE_UART_TX), "uart_tx") == 0);
+}
+
+static void test_perf_macros(void)
+{
+	printf("\nTest: Instrumentation Macros\n");
+	print_separator('-', 60);
+
+	perf_reset();
+
+	PERF_BEGIN(t);
+	volatile uint32_t sink = 0;
+	for (uint32_t i = 0; i < 1000; i++) {
+		sink += i;
+	}
+	PERF_END(PERF_STAGE_PROCESS_ACCEL, t);
+
+	const struct perf_stage_stats *s = perf_get_stats(PERF_STAGE_PROCESS_ACCEL);
+	assert_equal_uint32("Macro recorded one sample", 1, s->count);
+	assert_true("Elapsed time is non-zero", s->max_cycles > 0);
+	assert_equal_uint32("Cycles to ns identity on host", 1234, perf_cycles_to_ns(1234));
+}
+
+/* ============================================================
+ * MAIN
+ * ============================================================ */
+
+int main(void)
+{
+	printf("\n");
+	print_separator('=', 60);
+	printf("PERF PROFILER UNIT TESTS\n");
+	print_separator('=', 60);
+
+	test_perf_reset();
+	test_perf_min_avg_max();
+	test_perf_histogram_buckets();
+	test_perf_p99();
+	test_perf_invalid_stage();
+	test_perf_macros();
+
+	printf("\n");
+	print_separator('=', 60);
+	printf("TEST SUMMARY\n");
+	print_separator('=', 60);
+	printf("Total tests:  %d\n", total_tests);
+	printf("Passed:       %d\n", passed_tests);
+	printf("Failed:       %d\n", failed_tests);
+	printf("Success rate: %.1f%%\n",
+	       total_tests > 0 ? (100.0 * passed_tests / total_tests) : 0.0);
+	print_separator('=', 60);
+
+	return (failed_tests == 0) ? 0 : 1;
+}
@@ -0,0 +1,276 @@
+/*
+ * Binary Telemetry Unit Tests
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "../src/telemetry.h"
+
+/* Test statistics */
+static int total_tests = 0;
+static int passed_tests = 0;
+static int failed_tests = 0;
+
+/* Test utilities */
+static void print_separator(char c, int length)
+{
+	for (int i = 0; i < length; i++) {
+		putchar(c);
+	}
+	putchar('\n');
+}
+
+static void assert_equal_uint32(const char *test_name, uint32_t expected, uint32_t actual)
+{
+	total_tests++;
+	if (expected == actual) {
+		printf("  ✓ %s: %u\n", test_name, actual);
+		passed_tests++;
+	} else {
+		printf("  ✗ %s: expected %u, got %u\n", test_name, expected, actual);
+		failed_tests++;
+	}
+}
+
+static void assert_true(const char *test_name, bool condition)
+{
+	total_tests++;
+	if (condition) {
+		printf("  ✓ %s\n", test_name);
+		passed_tests++;
+	} else {
+		printf("  ✗ %s: assertion failed\n", test_name);
+		failed_tests++;
+	}
+}
+
+/* ============================================================
+ * TEST CASES
+ * ============================================================ */
+
+static void fill_record(struct telemetry_record *rec)
+{
+	memset(rec, 0, sizeof(*rec));
+	rec->timestamp_ms = 0x01020304;
+	rec->raw[0] = -1000;
+	rec->raw[1] = 0;
+	rec->raw[2] = 256;
+	for (int i = 0; i < MAX_ACCEL_SOURCES; i++) {
+		rec->calibrated[i] = (int16_t)(i * 10);
+	}
+	for (int i = 0; i < MAX_VIRTUAL_PORTS; i++) {
+		rec->vports[i] = (int16_t)(i - 5);
+	}
+	for (int i = 0; i < MAX_MIDI_OUTPUTS; i++) {
+		rec->midi[i] = (uint8_t)(i * 20);
+	}
+	rec->tx_queue_depth = 3;
+	rec->rt_queue_depth = 1;
+}
+
+static void test_crc16(void)
+{
+	printf("\nTest: CRC-16/CCITT-FALSE\n");
+	print_separator('-', 60);
+
+	const uint8_t check[] = "123456789";
+	assert_equal_uint32("Standard check value", 0x29B1, telemetry_crc16(check, 9));
+	assert_equal_uint32("Empty input", 0xFFFF, telemetry_crc16(check, 0));
+}
+
+static void test_cobs_roundtrip(void)
+{
+	printf("\nTest: COBS Round Trip\n");
+	print_separator('-', 60);
+
+	const uint8_t in[] = {0x11, 0x00, 0x00, 0x22, 0x33, 0x00};
+	uint8_t enc[16];
+	uint8_t dec[16];
+
+	int elen = telemetry_cobs_encode(in, sizeof(in), enc, sizeof(enc));
+	assert_equal_uint32("Encoded length", 7, (uint32_t)elen);
+
+	bool has_zero = false;
+	for (int i = 0; i < elen; i++) {
+		has_zero |= (enc[i] == 0);
+	}
+	assert_true("No zero bytes in encoding", !has_zero);
+
+	int dlen = telemetry_cobs_decode(enc, (size_t)elen, dec, sizeof(dec));
+	assert_equal_uint32("Decoded length", sizeof(in), (uint32_t)dlen);
+	assert_true("Decoded matches input", memcmp(in, dec, sizeof(in)) == 0);
+
+	assert_true("Short output rejected",
+	            telemetry_cobs_encode(in, sizeof(in), enc, 3) == -1);
+}
+
+static void test_cobs_long_run(void)
+{
+	printf("\nTest: COBS 254-Byte Blocks\n");
+	print_separator('-', 60);
+
+	static uint8_t in[300];
+	static uint8_t enc[310];
+	static uint8_t dec[310];
+
+	for (int i = 0; i < 300; i++) {
+		in[i] = (uint8_t)(i % 255 + 1);  /* No zeros */
+	}
+
+	int elen = telemetry_cobs_encode(in, sizeof(in), enc, sizeof(enc));
+	assert_equal_uint32("Two code bytes for 300 non-zero bytes", 302, (uint32_t)elen);
+	assert_equal_uint32("First block code", 0xFF, enc[0]);
+
+	int dlen = telemetry_cobs_decode(enc, (size_t)elen, dec, sizeof(dec));
+	assert_equal_uint32("Decoded length", 300, (uint32_t)dlen);
+	assert_true("Decoded matches input", memcmp(in, dec, sizeof(in)) == 0);
+}
+
+static void test_cobs_malformed(void)
+{
+	printf("\nTest: COBS Malformed Input\n");
+	print_separator('-', 60);
+
+	uint8_t dec[16];
+	const uint8_t overrun[] = {0x05, 0x11, 0x22};
+	const uint8_t zero_code[] = {0x02, 0x11, 0x00};
+
+	assert_true("Block past end rejected",
+	            telemetry_cobs_decode(overrun, sizeof(overrun), dec, sizeof(dec)) == -1);
+	assert_true("Embedded zero rejected",
+	            telemetry_cobs_decode(zero_code, sizeof(zero_code), dec, sizeof(dec)) == -1);
+}
+
+static void test_payload_layout(void)
+{
+	printf("\nTest: Payload Layout\n");
+	print_separator('-', 60);
+
+	struct telemetry_record rec;
+	uint8_t buf[TELEMETRY_MAX_PAYLOAD];
+	fill_record(&rec);
+
+	int len = telemetry_encode_payload(&rec, TELEM_F_ALL, 0x1234, 7, buf, sizeof(buf));
+	assert_equal_uint32("Full mask uses max payload", TELEMETRY_MAX_PAYLOAD, (uint32_t)len);
+	assert_equal_uint32("Version", TELEMETRY_VERSION, buf[0]);
+	assert_equal_uint32("Mask", TELEM_F_ALL, buf[1]);
+	assert_equal_uint32("Sequence LE", 0x1234, (uint32_t)(buf[2] | (buf[3] << 8)));
+	assert_equal_uint32("Timestamp LE", 0x01020304,
+	                    (uint32_t)(buf[4] | (buf[5] << 8) | (buf[6] << 16) | ((uint32_t)buf[7] << 24)));
+	assert_equal_uint32("Raw X (int16 -1000)", (uint16_t)-1000, (uint32_t)(buf[8] | (buf[9] << 8)));
+
+	uint16_t crc = (uint16_t)(buf[len - 2] | (buf[len - 1] << 8));
+	assert_equal_uint32("CRC covers payload", telemetry_crc16(buf, (size_t)len - 2), crc);
+
+	/* MIDI-only record: header + 6 bytes + CRC */
+	len = telemetry_encode_payload(&rec, TELEM_F_MIDI_OUT, 0, 0, buf, sizeof(buf));
+	assert_equal_uint32("MIDI-only length", TELEMETRY_HEADER_SIZE + MAX_MIDI_OUTPUTS + 2, (uint32_t)len);
+	assert_equal_uint32("MIDI[5]", 100, buf[TELEMETRY_HEADER_SIZE + 5]);
+
+	/* Queue section carries depths and the drop counter */
+	len = telemetry_encode_payload(&rec, TELEM_F_QUEUE, 0, 0x0102, buf, sizeof(buf));
+	assert_equal_uint32("TX depth", 3, buf[TELEMETRY_HEADER_SIZE]);
+	assert_equal_uint32("RT depth", 1, buf[TELEMETRY_HEADER_SIZE + 1]);
+	assert_equal_uint32("Dropped LE", 0x0102,
+	                    (uint32_t)(buf[TELEMETRY_HEADER_SIZE + 2] | (buf[TELEMETRY_HEADER_SIZE + 3] << 8)));
+
+	assert_true("Short buffer rejected",
+	            telemetry_encode_payload(&rec, TELEM_F_ALL, 0, 0, buf, 8) == -1);
+}
+
+static void test_frame_has_single_delimiter(void)
+{
+	printf("\nTest: Wire Frame\n");
+	print_separator('-', 60);
+
+	struct telemetry_record rec;
+	uint8_t frame[TELEMETRY_MAX_FRAME];
+	uint8_t payload[TELEMETRY_MAX_PAYLOAD];
+	fill_record(&rec);
+
+	int flen = telemetry_build_frame(&rec, TELEM_F_ALL, 1, 0, frame, sizeof(frame));
+	assert_true("Frame built", flen > 0);
+	assert_true("Frame fits max size", flen <= (int)TELEMETRY_MAX_FRAME);
+	assert_equal_uint32("Ends with delimiter", 0, frame[flen - 1]);
+
+	int zeros = 0;
+	for (int i = 0; i < flen; i++) {
+		zeros += (frame[i] == 0);
+	}
+	assert_equal_uint32("Exactly one zero byte", 1, (uint32_t)zeros);
+
+	int plen = telemetry_cobs_decode(frame, (size_t)flen - 1, payload, sizeof(payload));
+	assert_equal_uint32("Decodes to full payload", TELEMETRY_MAX_PAYLOAD, (uint32_t)plen);
+	uint16_t crc = (uint16_t)(payload[plen - 2] | (payload[plen - 1] << 8));
+	assert_equal_uint32("CRC valid after decode", telemetry_crc16(payload, (size_t)plen - 2), crc);
+}
+
+static void test_ring_drop_oldest(void)
+{
+	printf("\nTest: Drop-Oldest Ring\n");
+	print_separator('-', 60);
+
+	static struct telemetry_ring ring;
+	struct telemetry_record rec;
+	memset(&rec, 0, sizeof(rec));
+
+	telemetry_ring_init(&ring);
+	assert_true("Pop from empty fails", telemetry_ring_pop(&ring, &rec) == -1);
+
+	for (uint32_t i = 0; i < TELEMETRY_RING_SIZE + 3; i++) {
+		rec.timestamp_ms = i;
+		telemetry_ring_push(&ring, &rec);
+	}
+	assert_equal_uint32("Ring stays full", TELEMETRY_RING_SIZE, ring.count);
+	assert_equal_uint32("Three dropped", 3, ring.dropped);
+
+	telemetry_ring_pop(&ring, &rec);
+	assert_equal_uint32("Oldest surviving record", 3, rec.timestamp_ms);
+
+	uint32_t last = 0;
+	while (telemetry_ring_pop(&ring, &rec) == 0) {
+		last = rec.timestamp_ms;
+	}
+	assert_equal_uint32("Newest record kept", TELEMETRY_RING_SIZE + 2, last);
+	assert_equal_uint32("Push into space does not drop", 0,
+	                    (uint32_t)telemetry_ring_push(&ring, &rec));
+}
+
+/* ============================================================
+ * MAIN
+ * ============================================================ */
+
+int main(void)
+{
+	printf("\n");
+	print_separator('=', 60);
+	printf("TELEMETRY UNIT TESTS\n");
+	print_separator('=', 60);
+
+	test_crc16();
+	test_cobs_roundtrip();
+	test_cobs_long_run();
+	test_cobs_malformed();
+	test_payload_layout();
+	test_frame_has_single_delimiter();
+	test_ring_drop_oldest();
+
+	printf("\n");
+	print_separator('=', 60);
+	printf("TEST SUMMARY\n");
+	print_separator('=', 60);
+	printf("Total tests:  %d\n", total_tests);
+	printf("Passed:       %d\n", passed_tests);
+	printf("Failed:       %d\n", failed_tests);
+	printf("Success rate: %.1f%%\n",
+	       total_tests > 0 ? (100.0 * passed_tests / total_tests) : 0.0);
+	print_separator('=', 60);
+
+	return (failed_tests == 0) ? 0 : 1;
+}
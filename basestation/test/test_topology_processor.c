@@ -83,7 +83,7 @@ static void test_topology_t1_simple_linear(void)
 	topo_proc_set_function(&proc, 0, &func);
 	
 	/* Test with accelerometer values */
-	int16_t accel_data[6] = {0, 0, 0, 0, 0, 0};
+	int16_t accel_data[MAX_SENSOR_SOURCES] = {0, 0, 0, 0, 0, 0};
 	
 	/* Test 1: Center value (0mg) */
 	accel_data[0] = 0;
@@ -139,7 +139,7 @@ static void test_topology_t2_two_inputs_merged(void)
 	topo_proc_set_function(&proc, 0, &func);
 	
 	/* Test with accelerometer values */
-	int16_t accel_data[6] = {0, 0, 0, 0, 0, 0};
+	int16_t accel_data[MAX_SENSOR_SOURCES] = {0, 0, 0, 0, 0, 0};
 	
 	/* Test: Average of X=40 and Y=60 should be 50 */
 	accel_data[0] = 40;
@@ -185,7 +185,7 @@ static void test_topology_t3_fan_out(void)
 	topo_proc_set_function(&proc, 0, &func);
 	
 	/* Test with accelerometer value */
-	int16_t accel_data[6] = {1000, 0, 0, 0, 0, 0};  /* +1000mg on X */
+	int16_t accel_data[MAX_SENSOR_SOURCES] = {1000, 0, 0, 0, 0, 0};  /* +1000mg on X */
 	topo_proc_set_accel_inputs(&proc, accel_data);
 	topo_proc_execute(&proc);
 	
@@ -236,7 +236,7 @@ static void test_topology_t4_cascaded(void)
 	topo_proc_set_function(&proc, 1, &func1);
 	
 	/* Test with X=40, Y=60 (average = 50) */
-	int16_t accel_data[6] = {40, 60, 0, 0, 0, 0};
+	int16_t accel_data[MAX_SENSOR_SOURCES] = {40, 60, 0, 0, 0, 0};
 	topo_proc_set_accel_inputs(&proc, accel_data);
 	topo_proc_execute(&proc);
 	
@@ -292,7 +292,7 @@ static void test_multiple_topologies_parallel(void)
 	}
 	
 	/* Set distinct accelerometer values */
-	int16_t accel_data[6] = {-2000, 0, 2000, 0, 0, 0};  /* X=min, Y=center, Z=max */
+	int16_t accel_data[MAX_SENSOR_SOURCES] = {-2000, 0, 2000, 0, 0, 0};  /* X=min, Y=center, Z=max */
 	topo_proc_set_accel_inputs(&proc, accel_data);
 	topo_proc_execute(&proc);
 	
@@ -330,7 +330,7 @@ static void test_default_patch_config(void)
 	}
 	
 	/* All axes at center (0) */
-	int16_t accel_data[6] = {0, 0, 0, 0, 0, 0};
+	int16_t accel_data[MAX_SENSOR_SOURCES] = {0, 0, 0, 0, 0, 0};
 	topo_proc_set_accel_inputs(&proc, accel_data);
 	topo_proc_execute(&proc);
 	
@@ -0,0 +1,421 @@
+/*
+ * Topology Runtime Tests
+ *
+ * Checks that the compiled runtime gives the same results as interpreting
+ * the packed patch format: every function op against func_process(), what
+ * compiling leaves out, and random patches run through the processor
+ * against a reference interpreter (outputs and virtual port state).
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "../src/topology_processor.h"
+#include "../src/topology_runtime.h"
+
+/* Test statistics */
+static int total_tests = 0;
+static int passed_tests = 0;
+static int failed_tests = 0;
+
+/* Test utilities */
+static void print_separator(char c, int length)
+{
+	for (int i = 0; i < length; i++) {
+		putchar(c);
+	}
+	putchar('\n');
+}
+
+static void assert_equal_int(const char *test_name, int expected, int actual)
+{
+	total_tests++;
+	if (expected == actual) {
+		printf("  ✓ %s: %d\n", test_name, actual);
+		passed_tests++;
+	} else {
+		printf("  ✗ %s: expected %d, got %d\n", test_name, expected, actual);
+		failed_tests++;
+	}
+}
+
+static void assert_true(const char *test_name, bool condition)
+{
+	total_tests++;
+	if (condition) {
+		printf("  ✓ %s\n", test_name);
+		passed_tests++;
+	} else {
+		printf("  ✗ %s: assertion failed\n", test_name);
+		failed_tests++;
+	}
+}
+
+/* ============================================================
+ * REFERENCE
+ * ============================================================ */
+
+/* The packed-format interpreter the processor ran before compiling */
+static void reference_execute(const struct patch_topology_config *patch,
+                              const struct function_unit *functions,
+                              const int16_t *sources,
+                              struct virtual_port_system *vps, uint8_t *outputs)
+{
+	vport_reset_all(vps);
+	memset(outputs, 0, MAX_MIDI_OUTPUTS);
+
+	for (int i = 0; i < MAX_TOPOLOGY_INSTANCES; i++) {
+		const struct topology_instance *t = &patch->topologies[i];
+		uint8_t type = t->topology_type;
+		bool two = (type == TOPO_T2 || type == TOPO_T4);
+		uint8_t base = i * 3;
+		uint8_t m0 = t->midi_outputs[0] - 16;
+		uint8_t m1 = t->midi_outputs[1] - 16;
+
+		if (!t->enabled || type < TOPO_T1 || type > TOPO_T4) {
+			continue;
+		}
+		if (t->accel_inputs[0] >= MAX_SENSOR_SOURCES || t->func_units[0] >= MAX_FUNCTION_UNITS ||
+		    (two && t->accel_inputs[1] >= MAX_SENSOR_SOURCES) ||
+		    (type == TOPO_T4 && t->func_units[1] >= MAX_FUNCTION_UNITS)) {
+			continue;
+		}
+
+		vport_write(vps, base, sources[t->accel_inputs[0]]);
+		if (two) {
+			vport_write(vps, base, sources[t->accel_inputs[1]]);
+		}
+		int16_t f0 = func_process(&functions[t->func_units[0]], vport_read_raw(vps, base));
+
+		vport_write(vps, base + 1, f0);
+		if (m0 < MAX_MIDI_OUTPUTS) {
+			outputs[m0] = vport_read(vps, base + 1);
+		}
+		if (type == TOPO_T3 && m1 < MAX_MIDI_OUTPUTS) {
+			outputs[m1] = vport_read(vps, base + 1);
+		}
+		if (type == TOPO_T4) {
+			int16_t f1 = func_process(&functions[t->func_units[1]], f0);
+
+			vport_write(vps, base + 2, f1);
+			if (m1 < MAX_MIDI_OUTPUTS) {
+				outputs[m1] = vport_read(vps, base + 2);
+			}
+		}
+	}
+}
+
+/* Deterministic pseudo-random numbers (LCG) */
+static uint32_t rng_state = 12345;
+
+static uint32_t rng(void)
+{
+	rng_state = rng_state * 1664525u + 1013904223u;
+	return rng_state >> 8;
+}
+
+static int16_t rng_range(int16_t lo, int16_t hi)
+{
+	return (int16_t)(lo + (int32_t)(rng() % (uint32_t)(hi - lo + 1)));
+}
+
+static void random_function(struct function_unit *func)
+{
+	memset(func, 0, sizeof(*func));
+	func->function_type = rng() % (FUNC_LOWPASS + 2);   /* Includes an unknown type */
+	func->enabled = (rng() % 8) != 0;
+	func->param_count = rng() % (FUNC_MAX_PARAMS + 1);
+
+	if (func->function_type == FUNC_LINEAR) {
+		/* Bounded so in_offset * out_range fits in int32, as real patches do */
+		func->params[0] = rng_range(-4000, 4000);
+		func->params[1] = (rng() % 8) ? rng_range(-4000, 4000) : func->params[0];
+		func->params[2] = rng_range(-300, 300);
+		func->params[3] = rng_range(-300, 300);
+	} else {
+		for (int i = 0; i < FUNC_MAX_PARAMS; i++) {
+			func->params[i] = rng_range(-3000, 3000);
+		}
+	}
+}
+
+static void random_patch(struct patch_topology_config *patch)
+{
+	memset(patch, 0, sizeof(*patch));
+	patch->default_mixer_type = rng() % (MIXER_MIN + 2);    /* Includes an unknown mixer */
+
+	for (int i = 0; i < MAX_TOPOLOGY_INSTANCES; i++) {
+		struct topology_instance *t = &patch->topologies[i];
+
+		t->topology_type = rng() % (TOPO_T4 + 2);
+		t->enabled = (rng() % 6) != 0;
+		for (int k = 0; k < 2; k++) {
+			t->accel_inputs[k] = rng() % (MAX_SENSOR_SOURCES + 1);
+			t->func_units[k] = rng() % (MAX_FUNCTION_UNITS + 1);
+			t->midi_outputs[k] = 14 + rng() % (MAX_MIDI_OUTPUTS + 4);
+		}
+	}
+}
+
+static bool same_vports(const struct virtual_port_system *a, const struct virtual_port_system *b)
+{
+	for (int i = 0; i < MAX_VIRTUAL_PORTS; i++) {
+		if (a->ports[i].value != b->ports[i].value ||
+		    a->ports[i].input_count != b->ports[i].input_count ||
+		    vport_read_raw(a, i) != vport_read_raw(b, i)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/* ============================================================
+ * TEST CASES
+ * ============================================================ */
+
+static int function_mismatches(const struct function_unit *func)
+{
+	struct function_unit functions[MAX_FUNCTION_UNITS];
+	struct patch_topology_config patch;
+	struct virtual_port_system vps;
+	struct topology_runtime rt;
+	int mismatches = 0;
+
+	memset(&patch, 0, sizeof(patch));
+	vport_init(&vps, MIXER_AVERAGE);
+	for (int i = 0; i < MAX_FUNCTION_UNITS; i++) {
+		functions[i] = *func;
+	}
+	topology_runtime_compile(&rt, patch.topologies, functions, &vps);
+
+	for (int32_t x = INT16_MIN; x <= INT16_MAX; x++) {
+		if (topology_runtime_function(&rt, 3, (int16_t)x) != func_process(func, (int16_t)x)) {
+			mismatches++;
+		}
+	}
+	return mismatches;
+}
+
+static void test_function_ops(void)
+{
+	printf("\nTest: Compiled Functions Match func_process()\n");
+	print_separator('-', 60);
+
+	struct function_unit func;
+
+	func_init_linear(&func, -2000, 2000, 0, 127);
+	assert_equal_int("Linear", 0, function_mismatches(&func));
+	func_init_linear(&func, 2000, -2000, 0, 127);
+	assert_equal_int("Linear, inverted input range", 0, function_mismatches(&func));
+	func_init_linear(&func, -500, 1500, 127, 10);
+	assert_equal_int("Linear, falling output", 0, function_mismatches(&func));
+	func_init_linear(&func, 300, 300, 42, 127);
+	assert_equal_int("Linear, empty input range", 0, function_mismatches(&func));
+	func_init_linear(&func, -2000, 2000, 0, 127);
+	func.param_count = 3;
+	assert_equal_int("Linear, too few params", 0, function_mismatches(&func));
+
+	func_init_deadzone(&func, 100);
+	assert_equal_int("Deadzone", 0, function_mismatches(&func));
+	func_init_deadzone(&func, -5);
+	assert_equal_int("Deadzone, negative threshold", 0, function_mismatches(&func));
+
+	func_init(&func, FUNC_INVERT);
+	assert_equal_int("Invert", 0, function_mismatches(&func));
+
+	func_init(&func, FUNC_SCALE);
+	func.params[0] = 250;
+	assert_equal_int("Scale", 0, function_mismatches(&func));
+	func.params[0] = -80;
+	assert_equal_int("Scale, negative factor", 0, function_mismatches(&func));
+
+	func_init(&func, FUNC_CLAMP);
+	func.params[0] = 20;
+	func.params[1] = 90;
+	assert_equal_int("Clamp", 0, function_mismatches(&func));
+	func.params[0] = 90;
+	func.params[1] = 20;
+	assert_equal_int("Clamp, min above max", 0, function_mismatches(&func));
+	func.param_count = 1;
+	assert_equal_int("Clamp, too few params", 0, function_mismatches(&func));
+
+	func_init(&func, FUNC_PASSTHROUGH);
+	assert_equal_int("Passthrough", 0, function_mismatches(&func));
+	func_init_scale_offset(&func, 2);
+	assert_equal_int("Scale/offset", 0, function_mismatches(&func));
+
+	func_init_linear(&func, -2000, 2000, 0, 127);
+	func.enabled = 0;
+	assert_equal_int("Disabled unit", 0, function_mismatches(&func));
+	func_init(&func, FUNC_LOWPASS);
+	func.enabled = 1;
+	assert_equal_int("Unimplemented type", 0, function_mismatches(&func));
+}
+
+static void test_compile(void)
+{
+	printf("\nTest: Compiling Leaves Out Invalid Instances\n");
+	print_separator('-', 60);
+
+	struct patch_topology_config patch;
+	struct function_unit functions[MAX_FUNCTION_UNITS];
+	struct virtual_port_system vps;
+	struct topology_runtime rt;
+
+	topology_patch_init_default(&patch);
+	for (int i = 0; i < MAX_FUNCTION_UNITS; i++) {
+		func_init(&functions[i], FUNC_LINEAR);
+	}
+	vport_init(&vps, MIXER_MAX);
+
+	patch.topologies[1].enabled = 0;
+	patch.topologies[2].topology_type = 9;
+	patch.topologies[3].accel_inputs[0] = MAX_SENSOR_SOURCES;
+	patch.topologies[4].topology_type = TOPO_T4;
+	patch.topologies[4].func_units[1] = MAX_FUNCTION_UNITS;
+	patch.topologies[5].topology_type = TOPO_T3;
+	patch.topologies[5].midi_outputs[0] = 60;
+	patch.topologies[5].midi_outputs[1] = 16;
+
+	topology_runtime_compile(&rt, patch.topologies, functions, &vps);
+
+	assert_equal_int("Two of six instances compiled", 2, rt.steps);
+	assert_equal_int("Step 0 is instance 0", 0, rt.port[0]);
+	assert_equal_int("Step 1 is instance 5", 15, rt.port[1]);
+	assert_equal_int("CC 16 is output 0", 0, rt.output[0][0]);
+	assert_equal_int("T1 has no second output", TOPO_RT_NO_OUTPUT, rt.output[1][0]);
+	assert_equal_int("CC 60 not connected", TOPO_RT_NO_OUTPUT, rt.output[0][1]);
+	assert_equal_int("Fan-out to CC 16", 0, rt.output[1][1]);
+	assert_equal_int("Fan-out flag", TOPO_RT_FAN_OUT, rt.flags[1]);
+	assert_equal_int("Mixer taken from the port", MIXER_MAX, rt.mixer[0]);
+	assert_equal_int("Linear op", TOPO_RT_OP_LINEAR, rt.fn_op[0]);
+	assert_equal_int("Params aligned", 0, (int)(offsetof(struct topology_runtime, fn_param) %
+	                                          sizeof(int32_t)));
+}
+
+static void test_random_patches(void)
+{
+	printf("\nTest: Random Patches Match the Packed Interpreter\n");
+	print_separator('-', 60);
+
+	const int patches = 2000;
+	const int samples = 64;
+	int output_mismatches = 0;
+	int vport_mismatches = 0;
+	int steps = 0;
+
+	for (int p = 0; p < patches; p++) {
+		struct patch_topology_config patch;
+		struct function_unit functions[MAX_FUNCTION_UNITS];
+		struct topology_processor proc;
+		struct virtual_port_system ref_vps;
+		uint8_t ref_out[MAX_MIDI_OUTPUTS];
+
+		random_patch(&patch);
+		topo_proc_init(&proc, &patch);
+		for (int i = 0; i < MAX_FUNCTION_UNITS; i++) {
+			random_function(&functions[i]);
+			topo_proc_set_function(&proc, (uint8_t)i, &functions[i]);
+		}
+		vport_init(&ref_vps, (enum vport_mixer_type)patch.default_mixer_type);
+
+		for (int s = 0; s < samples; s++) {
+			int16_t sources[MAX_SENSOR_SOURCES];
+
+			for (int i = 0; i < MAX_SENSOR_SOURCES; i++) {
+				/* Mostly realistic values, sometimes the int16 extremes */
+				sources[i] = (rng() % 16) ? rng_range(-2500, 2500) :
+				             ((rng() & 1) ? INT16_MAX : INT16_MIN);
+			}
+
+			topo_proc_set_accel_inputs(&proc, sources);
+			topo_proc_execute(&proc);
+			reference_execute(&patch, functions, sources, &ref_vps, ref_out);
+
+			if (memcmp(proc.midi_outputs, ref_out, MAX_MIDI_OUTPUTS) != 0) {
+				output_mismatches++;
+			}
+			if (!same_vports(&proc.vport_system, &ref_vps)) {
+				vport_mismatches++;
+			}
+		}
+		steps += proc.runtime.steps;
+	}
+
+	printf("  %d patches x %d samples, %d instances compiled\n", patches, samples, steps);
+	assert_equal_int("MIDI outputs identical", 0, output_mismatches);
+	assert_equal_int("Virtual ports identical", 0, vport_mismatches);
+	assert_true("Some instances left out, most compiled",
+	            steps > patches * 2 && steps < patches * MAX_TOPOLOGY_INSTANCES);
+}
+
+static void test_recompile(void)
+{
+	printf("\nTest: Changes Recompile\n");
+	print_separator('-', 60);
+
+	struct patch_topology_config patch;
+	struct topology_processor proc;
+	struct function_unit func;
+	int16_t sources[MAX_SENSOR_SOURCES] = { 0 };
+
+	topology_patch_init_default(&patch);
+	topo_proc_init(&proc, &patch);
+	func_init_linear(&func, -2000, 2000, 0, 127);
+	topo_proc_set_function(&proc, 0, &func);
+	topo_proc_set_accel_inputs(&proc, sources);
+
+	topo_proc_execute(&proc);
+	assert_equal_int("Linear at center", 63, topo_proc_get_midi_output(&proc, 0));
+
+	func_init(&func, FUNC_INVERT);
+	topo_proc_set_function(&proc, 0, &func);
+	topo_proc_execute(&proc);
+	assert_equal_int("New function used", 127, topo_proc_get_midi_output(&proc, 0));
+
+	/* Patch edited in place: runs the old compile until recompiled */
+	patch.topologies[0].midi_outputs[0] = 17;
+	topo_proc_execute(&proc);
+	assert_equal_int("Old routing before recompiling", 127, topo_proc_get_midi_output(&proc, 0));
+	assert_equal_int("Compile", 0, topo_proc_compile(&proc));
+	topo_proc_execute(&proc);
+	assert_equal_int("CC 16 no longer driven after recompiling", 0,
+	                 topo_proc_get_midi_output(&proc, 0));
+	assert_equal_int("Without a patch", -1, topo_proc_compile(&(struct topology_processor){ 0 }));
+}
+
+/* ============================================================
+ * MAIN
+ * ============================================================ */
+
+int main(void)
+{
+	printf("\n");
+	print_separator('=', 60);
+	printf("TOPOLOGY RUNTIME TESTS\n");
+	print_separator('=', 60);
+
+	test_function_ops();
+	test_compile();
+	test_random_patches();
+	test_recompile();
+
+	printf("\n");
+	print_separator('=', 60);
+	printf("TEST SUMMARY\n");
+	print_separator('=', 60);
+	printf("Total tests:  %d\n", total_tests);
+	printf("Passed:       %d\n", passed_tests);
+	printf("Failed:       %d\n", failed_tests);
+	printf("Success rate: %.1f%%\n",
+	       total_tests > 0 ? (100.0 * passed_tests / total_tests) : 0.0);
+	print_separator('=', 60);
+
+	return (failed_tests == 0) ? 0 : 1;
+}
@@ -0,0 +1,259 @@
+/*
+ * Deferred Trace Point Unit Tests
+ *
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "../src/trace.h"
+
+/* Test statistics */
+static int total_tests = 0;
+static int passed_tests = 0;
+static int failed_tests = 0;
+
+/* Test utilities */
+static void print_separator(char c, int length)
+{
+	for (int i = 0; i < length; i++) {
+		putchar(c);
+	}
+	putchar('\n');
+}
+
+static void assert_equal_uint32(const char *test_name, uint32_t expected, uint32_t actual)
+{
+	total_tests++;
+	if (expected == actual) {
+		printf("  ✓ %s: %u\n", test_name, actual);
+		passed_tests++;
+	} else {
+		printf("  ✗ %s: expected %u, got %u\n", test_name, expected, actual);
+		failed_tests++;
+	}
+}
+
+static void assert_true(const char *test_name, bool condition)
+{
+	total_tests++;
+	if (condition) {
+		printf("  ✓ %s\n", test_name);
+		passed_tests++;
+	} else {
+		printf("  ✗ %s: assertion failed\n", test_name);
+		failed_tests++;
+	}
+}
+
+/* ============================================================
+ * TEST CASES
+ * ============================================================ */
+
+static void test_defaults_and_record(void)
+{
+	printf("\nTest: Defaults and Recording\n");
+	print_separator('-', 60);
+
+	trace_init();
+
+	const struct trace_site_state *s = trace_site_get(TRACE_SITE_ACCEL_IN);
+	assert_equal_uint32("Default 1-in-N", 1, s->sample_every);
+	assert_true("Default rate limit set", s->max_per_sec > 0);
+	assert_equal_uint32("Ring empty", 0, (uint32_t)trace_count());
+
+	int16_t args[4] = {100, -200, 300, 0};
+	assert_true("Event recorded", trace_point_at(TRACE_SITE_ACCEL_IN, 1000, args, sizeof(args)));
+
+	struct trace_event ev;
+	assert_true("Get oldest", trace_get(0, &ev) == 0);
+	assert_equal_uint32("Timestamp", 1000, ev.timestamp_us);
+	assert_equal_uint32("Site", TRACE_SITE_ACCEL_IN, ev.site);
+	assert_true("Arg y", ev.arg.s16[1] == -200);
+	assert_true("Out of range index", trace_get(1, &ev) == -1);
+	assert_true("Invalid site ignored", !trace_point_at(TRACE_SITE_COUNT, 0, NULL, 0));
+}
+
+static void test_sampling(void)
+{
+	printf("\nTest: 1-in-N Sampling\n");
+	print_separator('-', 60);
+
+	trace_init();
+	trace_site_configure(TRACE_SITE_BLE_RX, 4, 0);
+
+	for (uint32_t i = 0; i < 20; i++) {
+		trace_point_at(TRACE_SITE_BLE_RX, i * 100, NULL, 0);
+	}
+
+	const struct trace_site_state *s = trace_site_get(TRACE_SITE_BLE_RX);
+	assert_equal_uint32("Hits counted", 20, s->hits);
+	assert_equal_uint32("Every 4th recorded", 5, s->recorded);
+
+	struct trace_event ev;
+	trace_get(0, &ev);
+	assert_equal_uint32("First recorded is 4th hit", 300, ev.timestamp_us);
+	assert_equal_uint32("Suppressed before first", 3, ev.suppressed);
+	trace_get(1, &ev);
+	assert_equal_uint32("Suppressed between events", 3, ev.suppressed);
+}
+
+static void test_rate_limit(void)
+{
+	printf("\nTest: Per-Second Rate Limit\n");
+	print_separator('-', 60);
+
+	trace_init();
+	trace_site_configure(TRACE_SITE_MIDI_TX_DROP, 1, 5);
+
+	/* 100 hits in 0.5 s, then 100 more in the next second */
+	for (uint32_t i = 0; i < 100; i++) {
+		trace_point_at(TRACE_SITE_MIDI_TX_DROP, 2000000 + i * 5000, NULL, 0);
+	}
+	assert_equal_uint32("Capped in first window", 5,
+	                    trace_site_get(TRACE_SITE_MIDI_TX_DROP)->recorded);
+
+	for (uint32_t i = 0; i < 100; i++) {
+		trace_point_at(TRACE_SITE_MIDI_TX_DROP, 3000000 + i * 5000, NULL, 0);
+	}
+	assert_equal_uint32("New window admits more", 10,
+	                    trace_site_get(TRACE_SITE_MIDI_TX_DROP)->recorded);
+
+	struct trace_event ev;
+	trace_get(5, &ev);
+	assert_equal_uint32("Skipped hits reported on next event", 95, ev.suppressed);
+
+	/* Other sites have independent limits */
+	assert_true("Other site unaffected", trace_point_at(TRACE_SITE_BLE_RX, 3000000, NULL, 0));
+}
+
+static void test_disabled_site(void)
+{
+	printf("\nTest: Disabled Site\n");
+	print_separator('-', 60);
+
+	trace_init();
+	trace_site_configure(TRACE_SITE_MIDI_OUT, 0, 0);
+
+	assert_true("Not recorded", !trace_point_at(TRACE_SITE_MIDI_OUT, 0, NULL, 0));
+	assert_equal_uint32("Hit still counted", 1, trace_site_get(TRACE_SITE_MIDI_OUT)->hits);
+	assert_equal_uint32("Ring empty", 0, (uint32_t)trace_count());
+
+	trace_clear();
+	assert_equal_uint32("Clear keeps settings", 0, trace_site_get(TRACE_SITE_MIDI_OUT)->sample_every);
+	assert_equal_uint32("Clear resets hits", 0, trace_site_get(TRACE_SITE_MIDI_OUT)->hits);
+
+	trace_init();
+	assert_equal_uint32("Init restores defaults", 1, trace_site_get(TRACE_SITE_MIDI_OUT)->sample_every);
+}
+
+static void test_ring_overwrite(void)
+{
+	printf("\nTest: Ring Overwrites Oldest\n");
+	print_separator('-', 60);
+
+	trace_init();
+	trace_site_configure(TRACE_SITE_ACCEL_IN, 1, 0);
+
+	for (uint32_t i = 0; i < TRACE_RING_SIZE + 10; i++) {
+		trace_point_at(TRACE_SITE_ACCEL_IN, i, NULL, 0);
+	}
+
+	struct trace_event ev;
+	assert_equal_uint32("Ring full", TRACE_RING_SIZE, (uint32_t)trace_count());
+	assert_equal_uint32("Overwritten count", 10, trace_overwritten());
+	trace_get(0, &ev);
+	assert_equal_uint32("Oldest kept", 10, ev.timestamp_us);
+	trace_get(TRACE_RING_SIZE - 1, &ev);
+	assert_equal_uint32("Newest kept", TRACE_RING_SIZE + 9, ev.timestamp_us);
+}
+
+static void test_format(void)
+{
+	printf("\nTest: Deferred Formatting\n");
+	print_separator('-', 60);
+
+	trace_init();
+
+	int16_t accel[4] = {-1000, 0, 1000, 0};
+	uint8_t midi[6] = {0, 64, 127, 1, 2, 3};
+	char line[80];
+	struct trace_event ev;
+
+	trace_point_at(TRACE_SITE_ACCEL_IN, 0, accel, sizeof(accel));
+	trace_point_at(TRACE_SITE_MIDI_OUT, 0, midi, sizeof(midi));
+
+	trace_get(0, &ev);
+	trace_format(&ev, line, sizeof(line));
+	assert_true("Accel formatted", strstr(line, "accel_in") && strstr(line, "x=-1000 y=0 z=1000"));
+
+	trace_get(1, &ev);
+	trace_format(&ev, line, sizeof(line));
+	assert_true("MIDI bytes formatted", strstr(line, "[0,64,127,1,2,3]") != NULL);
+
+	/* Truncated output never overruns */
+	char small[8];
+	trace_format(&ev, small, sizeof(small));
+	assert_equal_uint32("Truncated string terminated", 7, (uint32_t)strlen(small));
+
+	assert_true("Site lookup", trace_site_find("midi_out") == TRACE_SITE_MIDI_OUT);
+	assert_true("Unknown site lookup", trace_site_find("nope") == -1);
+	assert_equal_uint32("Event is 16 bytes", 16, (uint32_t)sizeof(struct trace_event));
+}
+
+static void test_macros(void)
+{
+	printf("\nTest: Trace Point Macros\n");
+	print_separator('-', 60);
+
+	trace_init();
+
+	uint8_t midi[6] = {10, 20, 30, 40, 50, 60};
+	TRACE_S16(TRACE_SITE_BLE_RX, 10, 0, 0, 0);
+	TRACE_BYTES(TRACE_SITE_MIDI_OUT, midi, sizeof(midi));
+
+	struct trace_event ev;
+	assert_equal_uint32("Two events via macros", 2, (uint32_t)trace_count());
+	trace_get(0, &ev);
+	assert_true("S16 macro args", ev.arg.s16[0] == 10);
+	trace_get(1, &ev);
+	assert_equal_uint32("Byte macro args", 60, ev.arg.u8[5]);
+	assert_equal_uint32("Unused bytes zeroed", 0, ev.arg.u8[7]);
+}
+
+/* ============================================================
+ * MAIN
+ * ============================================================ */
+
+int main(void)
+{
+	printf("\n");
+	print_separator('=', 60);
+	printf("TRACE UNIT TESTS\n");
+	print_separator('=', 60);
+
+	test_defaults_and_record();
+	test_sampling();
+	test_rate_limit();
+	test_disabled_site();
+	test_ring_overwrite();
+	test_format();
+	test_macros();
+
+	printf("\n");
+	print_separator('=', 60);
+	printf("TEST SUMMARY\n");
+	print_separator('=', 60);
+	printf("Total tests:  %d\n", total_tests);
+	printf("Passed:       %d\n", passed_tests);
+	printf("Failed:       %d\n", failed_tests);
+	printf("Success rate: %.1f%%\n",
+	       total_tests > 0 ? (100.0 * passed_tests / total_tests) : 0.0);
+	print_separator('=', 60);
+
+	return (failed_tests == 0) ? 0 : 1;
+}
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "edge_events.h"
+#include <math.h>
+#include <stddef.h>  /* for NULL */
+#include <stdlib.h>  /* for abs */
+#include <string.h>
+
+/* Radians to decidegrees */
+#define RAD_TO_DDEG (1800.0 / 3.14159265358979323846)
+
+static int16_t clamp_int16(int32_t value)
+{
+	if (value > INT16_MAX) {
+		return INT16_MAX;
+	} else if (value < INT16_MIN) {
+		return INT16_MIN;
+	}
+	return (int16_t)value;
+}
+
+static int emit(struct motion_event *events, int n, uint8_t type, uint8_t flags,
+                int32_t value, uint32_t timestamp_us)
+{
+	events[n].type = type;
+	events[n].flags = flags;
+	events[n].value = clamp_int16(value);
+	events[n].timestamp_us = timestamp_us;
+	return n + 1;
+}
+
+/* Pitch of the low-passed gravity vector, same convention as the basestation */
+static int32_t gravity_pitch_ddeg(const struct edge_detector *det)
+{
+	double gx = det->gravity_q4[0] / 16.0;
+	double gy = det->gravity_q4[1] / 16.0;
+	double gz = det->gravity_q4[2] / 16.0;
+
+	return (int32_t)lround(atan2(-gx, sqrt(gy * gy + gz * gz)) * RAD_TO_DDEG);
+}
+
+void edge_config_default(struct edge_config *cfg)
+{
+	if (cfg == NULL) {
+		return;
+	}
+
+	cfg->tap_mg = EDGE_DEFAULT_TAP_MG;
+	cfg->shake_mg = EDGE_DEFAULT_SHAKE_MG;
+	cfg->tilt_mg = EDGE_DEFAULT_TILT_MG;
+	cfg->hold = EDGE_DEFAULT_HOLD;
+	cfg->release = EDGE_DEFAULT_RELEASE;
+}
+
+void edge_detector_init(struct edge_detector *det, const struct edge_config *cfg)
+{
+	if (det == NULL) {
+		return;
+	}
+
+	memset(det, 0, sizeof(*det));
+	if (cfg != NULL) {
+		det->cfg = *cfg;
+	} else {
+		edge_config_default(&det->cfg);
+	}
+}
+
+int edge_detector_update(struct edge_detector *det, const int16_t accel[3],
+                         uint32_t timestamp_us, struct motion_event events[EDGE_MAX_EVENTS])
+{
+	const struct edge_config *cfg;
+	int n = 0;
+
+	if (det == NULL || accel == NULL || events == NULL) {
+		return 0;
+	}
+
+	cfg = &det->cfg;
+	det->samples++;
+
+	if (!det->primed) {
+		/* First sample: nothing to compare against yet */
+		for (int i = 0; i < 3; i++) {
+			det->prev[i] = accel[i];
+			det->gravity_q4[i] = (int32_t)accel[i] << 4;
+		}
+		det->primed = true;
+		return 0;
+	}
+
+	/* Jerk, gravity low-pass and deviation from gravity */
+	int32_t jerk = 0;
+	int32_t deviation = 0;
+	for (int i = 0; i < 3; i++) {
+		int32_t d = (int32_t)accel[i] - det->prev[i];
+
+		if (abs(d) > abs(jerk)) {
+			jerk = d;
+		}
+		det->gravity_q4[i] += (((int32_t)accel[i] << 4) - det->gravity_q4[i]) >>
+		                      EDGE_GRAVITY_SHIFT;
+		deviation += abs((int32_t)accel[i] - (det->gravity_q4[i] >> 4));
+		det->prev[i] = accel[i];
+	}
+	det->envelope_q4 += ((deviation << 4) - det->envelope_q4) >> EDGE_ENVELOPE_SHIFT;
+	int32_t envelope = det->envelope_q4 >> 4;
+
+	/* TAP: one-shot, fixed length */
+	if (det->tap_hold > 0 && --det->tap_hold == 0 && det->tapping) {
+		det->tapping = false;
+		n = emit(events, n, MOTION_EVENT_TAP, MOTION_EVENT_F_END, 0, timestamp_us);
+	}
+	if (cfg->tap_mg > 0 && det->tap_hold == 0 && !det->shaking && abs(jerk) >= cfg->tap_mg) {
+		det->tapping = true;
+		det->tap_hold = (cfg->hold > 0) ? cfg->hold : 1;
+		n = emit(events, n, MOTION_EVENT_TAP, 0, jerk, timestamp_us);
+	}
+
+	/* SHAKE: envelope with hysteresis */
+	if (cfg->shake_mg > 0) {
+		if (!det->shaking && envelope >= cfg->shake_mg) {
+			det->shaking = true;
+			det->shake_quiet = 0;
+			n = emit(events, n, MOTION_EVENT_SHAKE, 0, envelope, timestamp_us);
+		} else if (det->shaking) {
+			if (envelope >= cfg->shake_mg / 2) {
+				det->shake_quiet = 0;
+			} else if (++det->shake_quiet >= cfg->release) {
+				det->shaking = false;
+				n = emit(events, n, MOTION_EVENT_SHAKE, MOTION_EVENT_F_END, envelope,
+				         timestamp_us);
+			}
+		}
+	}
+
+	/* TILT: gravity on X with hysteresis */
+	if (cfg->tilt_mg > 0) {
+		int32_t gx = abs(det->gravity_q4[0] >> 4);
+
+		if (!det->tilted && gx >= cfg->tilt_mg) {
+			det->tilted = true;
+			n = emit(events, n, MOTION_EVENT_TILT, 0, gravity_pitch_ddeg(det), timestamp_us);
+		} else if (det->tilted && gx < cfg->tilt_mg - EDGE_TILT_HYST_MG) {
+			det->tilted = false;
+			n = emit(events, n, MOTION_EVENT_TILT, MOTION_EVENT_F_END,
+			         gravity_pitch_ddeg(det), timestamp_us);
+		}
+	}
+
+	det->events += (uint32_t)n;
+	return n;
+}
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Edge Event Detection
+ * Tap, shake and tilt detection on the guitar's own samples
+ *
+ * In edge mode the client runs this detector on every raw sample, at a
+ * higher rate than the continuous stream, and notifies a compact
+ * motion_event when a gesture starts or ends. The basestation turns the
+ * events into MIDI through the patch's gesture slots. Events share the
+ * acceleration characteristic with the continuous samples and are told
+ * apart by length, so both can run on one connection.
+ *
+ * Every detection works on integer milli-g and does a fixed amount of
+ * work per sample. Thresholds and times are per sample, so they depend
+ * on the rate the detector runs at (EDGE_DEFAULT_* assume 200 Hz).
+ *
+ * Pure logic with no hardware dependencies - can be tested on host.
+ */
+
+#ifndef EDGE_EVENTS_H
+#define EDGE_EVENTS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* ========== WIRE FORMAT ========== */
+
+/* Event types (motion_event.type) */
+enum motion_event_type {
+	MOTION_EVENT_TAP = 1,   /* Sharp hit: value is the jerk peak in milli-g */
+	MOTION_EVENT_SHAKE,     /* Sustained shake: value is the envelope in milli-g */
+	MOTION_EVENT_TILT,      /* Neck past the tilt threshold: value is pitch in decidegrees */
+};
+
+#define MOTION_EVENT_F_END  0x01  /* Gesture ended (basestation sends Note Off) */
+
+/* Gesture start or end, sent instead of (or between) continuous samples */
+struct motion_event {
+	uint8_t type;           /* enum motion_event_type */
+	uint8_t flags;          /* MOTION_EVENT_F_* */
+	int16_t value;          /* Strength, see enum motion_event_type */
+	uint32_t timestamp_us;  /* Uptime when the triggering sample was taken */
+} __attribute__((packed));
+
+/* ========== DETECTOR ========== */
+
+#define EDGE_MAX_EVENTS         4    /* Per sample: tap end + tap, shake, tilt */
+
+#define EDGE_DEFAULT_TAP_MG     600  /* Jerk (change per sample) for a tap */
+#define EDGE_DEFAULT_SHAKE_MG   300  /* Envelope for a shake; ends below half */
+#define EDGE_DEFAULT_TILT_MG    500  /* Gravity on X for a tilt (about 30 degrees) */
+#define EDGE_DEFAULT_HOLD       20   /* Tap length and refractory, samples (100 ms) */
+#define EDGE_DEFAULT_RELEASE    10   /* Samples below threshold ending a shake */
+
+#define EDGE_TILT_HYST_MG       100  /* Tilt ends this far below the threshold */
+#define EDGE_GRAVITY_SHIFT      4    /* Gravity low-pass: 1/16 per sample */
+#define EDGE_ENVELOPE_SHIFT     3    /* Shake envelope: 1/8 per sample */
+
+/* Thresholds (0 disables that event type) */
+struct edge_config {
+	int16_t tap_mg;
+	int16_t shake_mg;
+	int16_t tilt_mg;
+	uint8_t hold;           /* Samples a tap lasts; no new tap meanwhile */
+	uint8_t release;        /* Samples below shake_mg / 2 ending a shake */
+};
+
+/* Detector state */
+struct edge_detector {
+	struct edge_config cfg;
+	int16_t prev[3];        /* Previous raw sample */
+	int32_t gravity_q4[3];  /* Low-passed acceleration, milli-g << 4 */
+	int32_t envelope_q4;    /* Low-passed |a - gravity| (L1), milli-g << 4 */
+	bool primed;
+	uint8_t tap_hold;       /* Samples until the tap ends */
+	uint8_t shake_quiet;    /* Samples below the shake release level */
+	bool tapping;
+	bool shaking;
+	bool tilted;
+
+	/* Statistics */
+	uint32_t samples;
+	uint32_t events;
+};
+
+/**
+ * @brief Fill a config with the EDGE_DEFAULT_* values
+ *
+ * @param cfg Output configuration
+ */
+void edge_config_default(struct edge_config *cfg);
+
+/**
+ * @brief Initialize detector
+ *
+ * @param det Detector state
+ * @param cfg Thresholds (NULL for defaults)
+ */
+void edge_detector_init(struct edge_detector *det, const struct edge_config *cfg);
+
+/**
+ * @brief Run detection on one raw sample
+ *
+ * Runs on the unfiltered samples: the spike limiter and running average
+ * of the continuous stream would flatten the taps this detects.
+ *
+ * - TAP: largest per-axis change since the previous sample reaches
+ *   tap_mg. Ends hold samples later; no new tap meanwhile, nor while
+ *   shaking.
+ * - SHAKE: envelope of the deviation from gravity reaches shake_mg. Ends
+ *   after release samples below half of it.
+ * - TILT: low-passed gravity on X reaches tilt_mg in either direction.
+ *   Ends EDGE_TILT_HYST_MG below it.
+ *
+ * @param det Detector state
+ * @param accel Raw sample, X/Y/Z in milli-g
+ * @param timestamp_us Sample time, copied into the events
+ * @param events Output: events, in order
+ * @return Number of events (0 to EDGE_MAX_EVENTS)
+ */
+int edge_detector_update(struct edge_detector *det, const int16_t accel[3],
+                         uint32_t timestamp_us, struct motion_event events[EDGE_MAX_EVENTS]);
+
+#endif /* EDGE_EVENTS_H */
@@ -31,6 +31,7 @@
 // #include <zephyr/pm/device.h>
 #include <math.h>
 #include "motion_logic.h"
+#include "edge_events.h"
 
 LOG_MODULE_REGISTER(guitar, LOG_LEVEL_DBG);
 
@@ -48,7 +49,28 @@ LOG_MODULE_REGISTER(guitar, LOG_LEVEL_DBG);
 
 #define MOVEMENT_THRESHOLD_MILLI_G  50  /* Minimum change to transmit (0.05g) */
 
+/* Continuous stream rate; edge event mode samples faster and sends every Nth */
+#define STREAM_RATE_HZ  10
+#if defined(CONFIG_GUITARACC_EDGE_EVENTS)
+#define SAMPLE_RATE_HZ  CONFIG_GUITARACC_EDGE_SAMPLE_HZ
+#else
+#define SAMPLE_RATE_HZ  STREAM_RATE_HZ
+#endif
+#define STREAM_DIVIDER  (SAMPLE_RATE_HZ / STREAM_RATE_HZ)
+
 #define ACCEL_ALIAS DT_ALIAS(accel0)
+
+/* Optional gyroscope (BMI270 on Thingy:53) fills roll/pitch/yaw at the basestation */
+#define GYRO_NODE DT_NODELABEL(bmi270)
+#define HAS_GYRO (DT_NODE_HAS_STATUS(GYRO_NODE, okay) && !TEST_MODE_ENABLED)
+#define ROTATION_THRESHOLD_DDPS     50  /* Keep transmitting while turning (5 dps) */
+/* Longest gap between IMU samples, still or not: the basestation's fusion
+ * restarts after 250 ms (IMU_FUSION_MAX_DT_US) and learns gyro bias only
+ * from still samples */
+#define IMU_KEEPALIVE_MS            200
+#define GYRO_SAMPLE_HZ              CONFIG_GUITARACC_GYRO_SAMPLE_HZ
+#define GYRO_THREAD_STACK_SIZE      1024
+#define GYRO_THREAD_PRIORITY        5
 // COMMENTED OUT FOR TROUBLESHOOTING
 // #define MOTION_TIMEOUT_MS 30000  /* 30 seconds of inactivity before sleep */
 
@@ -66,6 +88,11 @@ LOG_MODULE_REGISTER(guitar, LOG_LEVEL_DBG);
 static const struct device *accel_dev = DEVICE_DT_GET(ACCEL_ALIAS);
 #endif
 
+#if HAS_GYRO
+static const struct device *gyro_dev = DEVICE_DT_GET(GYRO_NODE);
+static bool gyro_ready = false;
+#endif
+
 // COMMENTED OUT FOR TROUBLESHOOTING
 // static struct k_timer motion_timer;
 // static bool is_sleeping = false;
@@ -90,8 +117,31 @@ static struct bt_uuid_128 guitar_accel_char_uuid = BT_UUID_INIT_128(
 
 static struct accel_data current_accel;
 static struct accel_data previous_accel;
+static uint32_t current_sample_us;  /* Uptime when current_accel was sampled */
+#if HAS_GYRO
+/* Filled by gyro_thread() at GYRO_SAMPLE_HZ, drained by notifications */
+static struct gyro_accumulator gyro_acc;
+static struct k_spinlock gyro_lock;
+static uint32_t imu_sent_us;  /* Timestamp of the last IMU sample sent */
+static bool imu_sent;
+#endif
 static bool accel_notify_enabled = false;
 
+#if defined(CONFIG_GUITARACC_EDGE_EVENTS)
+static struct edge_detector edge_det;
+
+/* Events of one sample, handed to send_edge_events() */
+struct edge_batch {
+	struct motion_event events[EDGE_MAX_EVENTS];
+	int count;
+};
+
+/* Gesture end the stack rejected, per event type: resent before anything
+ * else so the basestation never keeps a note sounding */
+static struct motion_event edge_end_retry[MOTION_EVENT_TILT];
+static bool edge_end_pending[MOTION_EVENT_TILT];
+#endif
+
 /* ========== ADVERTISING DATA ========== */
 #if CONFIG_BT_DIRECTED_ADVERTISING
 /* Bonded address queue. */
@@ -378,11 +428,50 @@ static int send_accel_notification(struct bt_conn *conn)
 	}
 
 	/* Only send if movement exceeds threshold (filter minor changes/noise) */
-	if (!detect_movement_threshold(&current_accel, &previous_accel, MOVEMENT_THRESHOLD_MILLI_G)) {
+	bool moved = detect_movement_threshold(&current_accel, &previous_accel,
+					       MOVEMENT_THRESHOLD_MILLI_G);
+#if HAS_GYRO
+	/* Mean rate over exactly the interval the basestation integrates */
+	struct gyro_data gyro = {0};
+	uint32_t interval_us = imu_sent ? current_sample_us - imu_sent_us : 0;
+	
+	if (gyro_ready) {
+		k_spinlock_key_t key = k_spin_lock(&gyro_lock);
+		gyro_accum_rate(&gyro_acc, interval_us, &gyro);
+		k_spin_unlock(&gyro_lock, key);
+		
+		moved = moved || !imu_sent ||
+			detect_rotation_threshold(&gyro, ROTATION_THRESHOLD_DDPS) ||
+			interval_us >= IMU_KEEPALIVE_MS * USEC_PER_MSEC;
+	}
+#endif
+	if (!moved) {
 		return 0;
 	}
 
-	err = bt_gatt_notify(conn, &guitar_svc.attrs[1], &current_accel, sizeof(current_accel));
+	/* Timestamp lets the basestation trace motion-to-MIDI latency */
+	struct accel_sample sample = {
+		.accel = current_accel,
+		.timestamp_us = current_sample_us,
+	};
+	const void *payload = &sample;
+	uint16_t len = sizeof(sample);
+
+#if HAS_GYRO
+	/* Accel + gyro: basestation fuses roll/pitch/yaw from these */
+	struct imu_sample imu = {
+		.accel = current_accel,
+		.gyro = gyro,
+		.timestamp_us = current_sample_us,
+	};
+
+	if (gyro_ready) {
+		payload = &imu;
+		len = sizeof(imu);
+	}
+#endif
+	
+	err = bt_gatt_notify(conn, &guitar_svc.attrs[1], payload, len);
 	if (err) {
 		LOG_ERR("Failed to send notification (err %d)", err);
 		return err;
@@ -390,6 +479,15 @@ static int send_accel_notification(struct bt_conn *conn)
 
 	/* Update previous values after successful send */
 	previous_accel = current_accel;
+#if HAS_GYRO
+	if (gyro_ready) {
+		k_spinlock_key_t key = k_spin_lock(&gyro_lock);
+		gyro_accum_consume(&gyro_acc, &gyro, interval_us);
+		k_spin_unlock(&gyro_lock, key);
+		imu_sent_us = current_sample_us;
+		imu_sent = true;
+	}
+#endif
 	
 	LOG_DBG("Sent accel: X=%d, Y=%d, Z=%d milli-g", 
 		current_accel.x, current_accel.y, current_accel.z);
@@ -397,6 +495,91 @@ static int send_accel_notification(struct bt_conn *conn)
 	return 0;
 }
 
+#if HAS_GYRO
+/* Reads the gyro at its output data rate and integrates every sample; the
+ * 10 Hz notification loop alone would alias fast turns */
+static void gyro_thread(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+	
+	struct k_timer tick;
+	
+	k_timer_init(&tick, NULL, NULL);
+	k_timer_start(&tick, K_USEC(USEC_PER_SEC / GYRO_SAMPLE_HZ),
+		      K_USEC(USEC_PER_SEC / GYRO_SAMPLE_HZ));
+	
+	while (1) {
+		k_timer_status_sync(&tick);
+		
+		if (sensor_sample_fetch(gyro_dev) != 0) {
+			continue;
+		}
+		
+		uint32_t now_us = (uint32_t)k_ticks_to_us_floor64(k_uptime_ticks());
+		struct sensor_value value[3];
+		struct gyro_data rate;
+		
+		sensor_channel_get(gyro_dev, SENSOR_CHAN_GYRO_XYZ, value);
+		convert_gyro_to_ddps(sensor_value_to_double(&value[0]),
+				     sensor_value_to_double(&value[1]),
+				     sensor_value_to_double(&value[2]),
+				     &rate);
+		
+		k_spinlock_key_t key = k_spin_lock(&gyro_lock);
+		gyro_accum_add(&gyro_acc, &rate, now_us);
+		k_spin_unlock(&gyro_lock, key);
+	}
+}
+
+/* Started from main() once the gyroscope is ready */
+K_THREAD_DEFINE(gyro_tid, GYRO_THREAD_STACK_SIZE, gyro_thread, NULL, NULL, NULL,
+		GYRO_THREAD_PRIORITY, 0, SYS_FOREVER_MS);
+#endif
+
+#if defined(CONFIG_GUITARACC_EDGE_EVENTS)
+static int notify_edge_event(struct bt_conn *conn, const struct motion_event *ev)
+{
+	int err = bt_gatt_notify(conn, &guitar_svc.attrs[1], ev, sizeof(*ev));
+	
+	if (err && (ev->flags & MOTION_EVENT_F_END) &&
+	    ev->type >= MOTION_EVENT_TAP && ev->type <= MOTION_EVENT_TILT) {
+		edge_end_retry[ev->type - 1] = *ev;
+		edge_end_pending[ev->type - 1] = true;
+	}
+	return err;
+}
+
+static void send_edge_events(struct bt_conn *conn, void *data)
+{
+	const struct edge_batch *batch = data;
+	
+	if (!accel_notify_enabled || !transmission_enabled) {
+		return;
+	}
+	
+	for (int i = 0; i < MOTION_EVENT_TILT; i++) {
+		if (edge_end_pending[i]) {
+			edge_end_pending[i] = false;
+			notify_edge_event(conn, &edge_end_retry[i]);
+		}
+	}
+	
+	for (int i = 0; i < batch->count; i++) {
+		int err = notify_edge_event(conn, &batch->events[i]);
+		
+		if (err) {
+			LOG_ERR("Failed to send edge event %d (err %d)", batch->events[i].type, err);
+		} else {
+			LOG_DBG("Sent edge event %d%s, value %d", batch->events[i].type,
+				(batch->events[i].flags & MOTION_EVENT_F_END) ? " end" : "",
+				batch->events[i].value);
+		}
+	}
+}
+#endif
+
 /* ========== MAIN FUNCTION ========== */
 
 int main(void)
@@ -416,6 +599,28 @@ int main(void)
 	}
 	LOG_INF("Accelerometer initialized");
 
+#if HAS_GYRO
+	gyro_ready = device_is_ready(gyro_dev);
+	if (gyro_ready && !IS_ENABLED(CONFIG_GUITARACC_CONTINUOUS_STREAM)) {
+		/* Rates only travel in the continuous stream */
+		gyro_ready = false;
+		LOG_INF("Gyroscope unused: continuous stream off");
+	} else if (gyro_ready) {
+		struct sensor_value odr = { .val1 = GYRO_SAMPLE_HZ };
+		
+		if (sensor_attr_set(gyro_dev, SENSOR_CHAN_GYRO_XYZ,
+				    SENSOR_ATTR_SAMPLING_FREQUENCY, &odr) != 0) {
+			LOG_WRN("Gyroscope ODR not set to %d Hz", GYRO_SAMPLE_HZ);
+		}
+		gyro_accum_init(&gyro_acc);
+		k_thread_start(gyro_tid);
+		LOG_INF("Gyroscope initialized at %d Hz, sending roll/pitch/yaw rates",
+			GYRO_SAMPLE_HZ);
+	} else {
+		LOG_WRN("Gyroscope not ready, sending accel only");
+	}
+#endif
+
 	/* Configure GPIO interrupt for ADXL362 INT1 pin */
 	const struct gpio_dt_spec int1_gpio = GPIO_DT_SPEC_GET_BY_IDX(DT_ALIAS(accel0), int1_gpios, 0);
 	
@@ -520,6 +725,15 @@ int main(void)
 	LOG_INF("Running average filter disabled");
 #endif
 
+#if defined(CONFIG_GUITARACC_EDGE_EVENTS)
+	edge_detector_init(&edge_det, NULL);
+	LOG_INF("Edge events enabled at %d Hz (continuous stream %s)", SAMPLE_RATE_HZ,
+		IS_ENABLED(CONFIG_GUITARACC_CONTINUOUS_STREAM) ? "on" : "off");
+#endif
+#if !TEST_MODE_ENABLED
+	int stream_tick = 0;  /* Samples since the last continuous stream update */
+#endif
+
 	// COMMENTED OUT FOR TROUBLESHOOTING
 	// k_timer_start(&motion_timer, K_MSEC(MOTION_TIMEOUT_MS), K_NO_WAIT);
 
@@ -528,6 +742,7 @@ int main(void)
 	while (1) {
 #if TEST_MODE_ENABLED
 		/* Generate synthetic incrementing test data */
+		current_sample_us = (uint32_t)k_ticks_to_us_floor64(k_uptime_ticks());
 		current_accel.x = test_counter;
 		current_accel.y = test_counter + 100;
 		current_accel.z = test_counter + 200;
@@ -549,6 +764,8 @@ int main(void)
 		/* Read accelerometer and send notifications */
 		err = sensor_sample_fetch(accel_dev);
 		if (err == 0) {
+			current_sample_us = (uint32_t)k_ticks_to_us_floor64(k_uptime_ticks());
+			
 			struct accel_data raw_accel, filtered_accel;
 			
 			sensor_channel_get(accel_dev, SENSOR_CHAN_ACCEL_XYZ, accel);
@@ -561,6 +778,26 @@ int main(void)
 			/* Convert to milli-g */
 			convert_accel_to_milli_g(x, y, z, &raw_accel);
 			
+#if defined(CONFIG_GUITARACC_EDGE_EVENTS)
+			/* Edge events: every raw sample, before any filtering */
+			const int16_t xyz[3] = {raw_accel.x, raw_accel.y, raw_accel.z};
+			struct edge_batch batch;
+			
+			batch.count = edge_detector_update(&edge_det, xyz, current_sample_us,
+							   batch.events);
+			if (is_connected) {
+				bt_conn_foreach(BT_CONN_TYPE_LE, send_edge_events, &batch);
+			}
+#endif
+			
+			/* Continuous stream: every STREAM_DIVIDER-th sample, so the
+			 * filters see the same 10 Hz input as without edge events */
+			if (++stream_tick < STREAM_DIVIDER) {
+				k_sleep(K_USEC(USEC_PER_SEC / SAMPLE_RATE_HZ));
+				continue;
+			}
+			stream_tick = 0;
+			
 			/* Apply spike limiter */
 			apply_spike_limiter(&raw_accel, &filtered_accel);
 			
@@ -571,9 +808,10 @@ int main(void)
 			/* No running average - use spike-limited data directly */
 			current_accel = filtered_accel;
 #endif
+
 			
 			/* Send notification if connected and enabled (only if data changed) */
-			if (is_connected) {
+			if (is_connected && IS_ENABLED(CONFIG_GUITARACC_CONTINUOUS_STREAM)) {
 				bt_conn_foreach(BT_CONN_TYPE_LE, 
 					       (void (*)(struct bt_conn *, void *))send_accel_notification,
 					       NULL);
@@ -582,7 +820,7 @@ int main(void)
 			LOG_ERR("Failed to fetch sensor sample (err %d)", err);
 		}
 		
-		k_sleep(K_MSEC(100)); /* 10Hz sample rate */
+		k_sleep(K_USEC(USEC_PER_SEC / SAMPLE_RATE_HZ)); /* 10Hz, or the edge event rate */
 #endif
 	}
 
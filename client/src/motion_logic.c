@@ -8,10 +8,15 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <stddef.h>  /* for NULL */
+#include <stdlib.h>  /* for abs */
+#include <string.h>  /* for memset */
 
 /* Gravitational constant in m/s² */
 #define GRAVITY 9.81
 
+/* Radians to decidegrees */
+#define RAD_TO_DDEG (1800.0 / 3.14159265358979323846)
+
 /* Maximum and minimum values for int16_t */
 #define INT16_MAX_VAL 32767
 #define INT16_MIN_VAL -32768
@@ -169,6 +174,119 @@ void convert_accel_to_milli_g(double x, double y, double z, struct accel_data *d
 	data->z = convert_to_milli_g(z);
 }
 
+int16_t convert_to_ddps(double rad_s)
+{
+	double ddps = rad_s * RAD_TO_DDEG;
+	
+	/* Clamp to int16_t range */
+	if (ddps > INT16_MAX_VAL) {
+		return INT16_MAX_VAL;
+	} else if (ddps < INT16_MIN_VAL) {
+		return INT16_MIN_VAL;
+	}
+	
+	return (int16_t)ddps;
+}
+
+void convert_gyro_to_ddps(double x, double y, double z, struct gyro_data *data)
+{
+	if (data == NULL) {
+		return;
+	}
+	
+	data->x = convert_to_ddps(x);
+	data->y = convert_to_ddps(y);
+	data->z = convert_to_ddps(z);
+}
+
+bool detect_rotation_threshold(const struct gyro_data *gyro, int16_t threshold_ddps)
+{
+	if (gyro == NULL) {
+		return false;
+	}
+	
+	return (abs(gyro->x) > threshold_ddps ||
+	        abs(gyro->y) > threshold_ddps ||
+	        abs(gyro->z) > threshold_ddps);
+}
+
+void gyro_accum_init(struct gyro_accumulator *acc)
+{
+	if (acc == NULL) {
+		return;
+	}
+	
+	memset(acc, 0, sizeof(*acc));
+}
+
+void gyro_accum_add(struct gyro_accumulator *acc, const struct gyro_data *rate,
+		    uint32_t timestamp_us)
+{
+	if (acc == NULL || rate == NULL) {
+		return;
+	}
+	
+	if (acc->started) {
+		int64_t dt_us = (uint32_t)(timestamp_us - acc->last_us);
+		
+		/* Trapezoid: mean of both rates over the gap, times 2 */
+		acc->angle[0] += ((int64_t)acc->last.x + rate->x) * dt_us;
+		acc->angle[1] += ((int64_t)acc->last.y + rate->y) * dt_us;
+		acc->angle[2] += ((int64_t)acc->last.z + rate->z) * dt_us;
+	}
+	
+	acc->last = *rate;
+	acc->last_us = timestamp_us;
+	acc->started = true;
+}
+
+/* Accumulated angle is kept doubled (trapezoid sums); halve on the way out */
+static int16_t mean_rate(int64_t angle2, uint32_t interval_us)
+{
+	int64_t mean = angle2 / (2 * (int64_t)interval_us);
+	
+	if (mean > INT16_MAX_VAL) {
+		return INT16_MAX_VAL;
+	} else if (mean < INT16_MIN_VAL) {
+		return INT16_MIN_VAL;
+	}
+	return (int16_t)mean;
+}
+
+void gyro_accum_rate(const struct gyro_accumulator *acc, uint32_t interval_us,
+		     struct gyro_data *rate)
+{
+	if (acc == NULL || rate == NULL) {
+		return;
+	}
+	
+	if (interval_us == 0) {
+		*rate = acc->last;
+		return;
+	}
+	
+	rate->x = mean_rate(acc->angle[0], interval_us);
+	rate->y = mean_rate(acc->angle[1], interval_us);
+	rate->z = mean_rate(acc->angle[2], interval_us);
+}
+
+void gyro_accum_consume(struct gyro_accumulator *acc, const struct gyro_data *rate,
+			uint32_t interval_us)
+{
+	if (acc == NULL || rate == NULL) {
+		return;
+	}
+	
+	if (interval_us == 0) {
+		memset(acc->angle, 0, sizeof(acc->angle));
+		return;
+	}
+	
+	acc->angle[0] -= 2 * (int64_t)rate->x * interval_us;
+	acc->angle[1] -= 2 * (int64_t)rate->y * interval_us;
+	acc->angle[2] -= 2 * (int64_t)rate->z * interval_us;
+}
+
 double calculate_magnitude(double x, double y, double z)
 {
 	return sqrt(x*x + y*y + z*z);
@@ -16,6 +16,26 @@ struct accel_data {
 	int16_t z;  /* Z-axis in milli-g */
 } __attribute__((packed));
 
+/* Timestamped sample sent over BLE (used for basestation latency tracing) */
+struct accel_sample {
+	struct accel_data accel;
+	uint32_t timestamp_us;  /* Uptime when the sample was taken */
+} __attribute__((packed));
+
+/* Angular rate: X, Y, Z in decidegrees per second */
+struct gyro_data {
+	int16_t x;  /* X-axis (roll) in decidegrees/s */
+	int16_t y;  /* Y-axis (pitch) in decidegrees/s */
+	int16_t z;  /* Z-axis (yaw) in decidegrees/s */
+} __attribute__((packed));
+
+/* Timestamped accel + gyro sample sent by boards with a gyroscope */
+struct imu_sample {
+	struct accel_data accel;
+	struct gyro_data gyro;
+	uint32_t timestamp_us;  /* Uptime when the sample was taken */
+} __attribute__((packed));
+
 /* Motion detection configuration */
 #define MOTION_THRESHOLD 0.5     /* m/s² threshold for motion detection */
 
@@ -94,6 +114,94 @@ int16_t convert_to_milli_g(double m_s2);
  */
 void convert_accel_to_milli_g(double x, double y, double z, struct accel_data *data);
 
+/**
+ * @brief Convert angular rate from rad/s to decidegrees/s
+ * 
+ * Zephyr reports SENSOR_CHAN_GYRO_* in rad/s. Decidegrees keep 0.1 dps
+ * resolution and cover +/-3276 dps. Result is clamped to int16_t range.
+ * 
+ * @param rad_s Angular rate in rad/s
+ * @return Angular rate in decidegrees/s
+ */
+int16_t convert_to_ddps(double rad_s);
+
+/**
+ * @brief Convert XYZ angular rate from rad/s to decidegrees/s
+ * 
+ * @param x X-axis rate in rad/s
+ * @param y Y-axis rate in rad/s
+ * @param z Z-axis rate in rad/s
+ * @param data Output structure to store converted values
+ */
+void convert_gyro_to_ddps(double x, double y, double z, struct gyro_data *data);
+
+/**
+ * @brief Detect rotation exceeding threshold
+ * 
+ * A steady turn leaves acceleration unchanged, so movement detection
+ * alone would stop sending while roll or yaw is still changing.
+ * 
+ * @param gyro Current angular rate in decidegrees/s
+ * @param threshold_ddps Minimum rate on any axis to count as rotating
+ * @return true if any axis exceeds threshold, false otherwise
+ */
+bool detect_rotation_threshold(const struct gyro_data *gyro, int16_t threshold_ddps);
+
+/*
+ * Rotation integrated at the gyro's own output rate between notifications.
+ * A rate sampled only when a notification goes out aliases fast turns; the
+ * accumulator sums every sample instead, and each notification carries the
+ * mean rate over the interval the basestation integrates it for, so the
+ * total rotation arrives intact at any send rate. What a clamped mean
+ * cannot carry stays for the next notification.
+ */
+struct gyro_accumulator {
+	int64_t angle[3];       /* Twice the integrated rate (trapezoid sums),
+	                         * decidegrees/s x microseconds */
+	struct gyro_data last;  /* Latest rate */
+	uint32_t last_us;       /* Time of the latest rate */
+	bool started;
+};
+
+/**
+ * @brief Clear the accumulator
+ */
+void gyro_accum_init(struct gyro_accumulator *acc);
+
+/**
+ * @brief Integrate one gyro sample (trapezoid from the previous one)
+ * 
+ * @param acc Accumulator
+ * @param rate Angular rate in decidegrees/s
+ * @param timestamp_us Time the rate was read (any microsecond clock, may wrap)
+ */
+void gyro_accum_add(struct gyro_accumulator *acc, const struct gyro_data *rate,
+		    uint32_t timestamp_us);
+
+/**
+ * @brief Mean rate that carries the accumulated rotation over an interval
+ * 
+ * Does not change the accumulator; call gyro_accum_consume() once the
+ * rate has been sent.
+ * 
+ * @param acc Accumulator
+ * @param interval_us Time since the previous sent sample, 0 if none
+ *                    (the latest rate is returned)
+ * @param rate Output: mean rate in decidegrees/s, clamped to int16_t
+ */
+void gyro_accum_rate(const struct gyro_accumulator *acc, uint32_t interval_us,
+		     struct gyro_data *rate);
+
+/**
+ * @brief Remove the rotation a sent rate carried
+ * 
+ * @param acc Accumulator
+ * @param rate Rate returned by gyro_accum_rate() and sent
+ * @param interval_us Interval passed to gyro_accum_rate() (0 clears all)
+ */
+void gyro_accum_consume(struct gyro_accumulator *acc, const struct gyro_data *rate,
+			uint32_t interval_us);
+
 /**
  * @brief Calculate magnitude of 3D acceleration vector
  * 
@@ -0,0 +1,284 @@
+/*
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Host-based unit tests for edge event detection
+ */
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <math.h>
+#include "../src/edge_events.h"
+
+/* Test counter */
+static int tests_passed = 0;
+static int tests_total = 0;
+
+#define TEST(name) \
+	do { \
+		tests_total++; \
+		printf("TEST: %s ... ", name); \
+	} while(0)
+
+#define PASS() \
+	do { \
+		tests_passed++; \
+		printf("PASS\n"); \
+	} while(0)
+
+#define ASSERT_EQ(a, b) \
+	do { \
+		if ((a) != (b)) { \
+			printf("FAIL: Expected %d, got %d\n", (int)(b), (int)(a)); \
+			return; \
+		} \
+	} while(0)
+
+#define ASSERT_TRUE(cond) \
+	do { \
+		if (!(cond)) { \
+			printf("FAIL: Condition false\n"); \
+			return; \
+		} \
+	} while(0)
+
+static const int16_t rest[3] = {0, 0, 1000};
+
+/* Feed the same sample count times, return the number of events */
+static int feed(struct edge_detector *det, const int16_t accel[3], int count,
+                struct motion_event *last)
+{
+	struct motion_event events[EDGE_MAX_EVENTS];
+	int total = 0;
+
+	for (int i = 0; i < count; i++) {
+		int n = edge_detector_update(det, accel, (uint32_t)i * 5000, events);
+
+		if (n > 0 && last) {
+			*last = events[n - 1];
+		}
+		total += n;
+	}
+	return total;
+}
+
+/* Test: Wire format is 8 bytes, distinct from the sample packets */
+void test_event_size(void)
+{
+	TEST("event_size");
+	ASSERT_EQ(sizeof(struct motion_event), 8);
+	PASS();
+}
+
+/* Test: Defaults and NULL config */
+void test_init_defaults(void)
+{
+	TEST("init_defaults");
+	struct edge_detector det;
+	edge_detector_init(&det, NULL);
+	ASSERT_EQ(det.cfg.tap_mg, EDGE_DEFAULT_TAP_MG);
+	ASSERT_EQ(det.cfg.shake_mg, EDGE_DEFAULT_SHAKE_MG);
+	ASSERT_EQ(det.cfg.tilt_mg, EDGE_DEFAULT_TILT_MG);
+	ASSERT_EQ(det.cfg.hold, EDGE_DEFAULT_HOLD);
+	ASSERT_EQ(det.cfg.release, EDGE_DEFAULT_RELEASE);
+	PASS();
+}
+
+/* Test: A guitar at rest sends nothing */
+void test_rest_no_events(void)
+{
+	TEST("rest_no_events");
+	struct edge_detector det;
+	edge_detector_init(&det, NULL);
+	ASSERT_EQ(feed(&det, rest, 400, NULL), 0);
+	ASSERT_EQ(det.samples, 400);
+	PASS();
+}
+
+/* Test: The first sample only primes the detector, even far from rest */
+void test_first_sample_primes(void)
+{
+	TEST("first_sample_primes");
+	struct edge_detector det;
+	struct motion_event events[EDGE_MAX_EVENTS];
+	const int16_t tilted[3] = {-900, 0, 400};
+	edge_detector_init(&det, NULL);
+	ASSERT_EQ(edge_detector_update(&det, tilted, 0, events), 0);
+	PASS();
+}
+
+/* Test: A sharp hit gives a tap start, then its end hold samples later */
+void test_tap_start_and_end(void)
+{
+	TEST("tap_start_and_end");
+	struct edge_detector det;
+	struct motion_event events[EDGE_MAX_EVENTS];
+	const int16_t hit[3] = {0, 900, 1000};
+	edge_detector_init(&det, NULL);
+	feed(&det, rest, 10, NULL);
+
+	ASSERT_EQ(edge_detector_update(&det, hit, 12345, events), 1);
+	ASSERT_EQ(events[0].type, MOTION_EVENT_TAP);
+	ASSERT_EQ(events[0].flags, 0);
+	ASSERT_EQ(events[0].value, 900);
+	ASSERT_EQ(events[0].timestamp_us, 12345);
+
+	/* The drop back is no second tap; the end comes after hold samples */
+	struct motion_event last = {0};
+	ASSERT_EQ(feed(&det, rest, EDGE_DEFAULT_HOLD - 1, NULL), 0);
+	ASSERT_EQ(feed(&det, rest, 1, &last), 1);
+	ASSERT_EQ(last.type, MOTION_EVENT_TAP);
+	ASSERT_EQ(last.flags, MOTION_EVENT_F_END);
+	PASS();
+}
+
+/* Test: Jerk below the threshold is no tap; negative jerk is */
+void test_tap_threshold_and_polarity(void)
+{
+	TEST("tap_threshold_and_polarity");
+	struct edge_detector det;
+	struct motion_event events[EDGE_MAX_EVENTS];
+	const int16_t soft[3] = {0, 0, 1000 - (EDGE_DEFAULT_TAP_MG - 1)};
+	const int16_t down[3] = {0, 0, 1000 - EDGE_DEFAULT_TAP_MG};
+	edge_detector_init(&det, NULL);
+	feed(&det, rest, 10, NULL);
+
+	ASSERT_EQ(edge_detector_update(&det, soft, 0, events), 0);
+	feed(&det, rest, 10, NULL);
+	ASSERT_EQ(edge_detector_update(&det, down, 0, events), 1);
+	ASSERT_EQ(events[0].value, -EDGE_DEFAULT_TAP_MG);
+	PASS();
+}
+
+/* Test: Sustained shaking gives one start and, once still, one end */
+void test_shake_start_and_end(void)
+{
+	TEST("shake_start_and_end");
+	struct edge_detector det;
+	struct motion_event events[EDGE_MAX_EVENTS];
+	int starts = 0;
+	int ends = 0;
+	int taps = 0;
+	edge_detector_init(&det, NULL);
+	feed(&det, rest, 10, NULL);
+
+	/* 10 Hz, 0.7 g on X for 0.5 s at 200 Hz, then still */
+	for (int i = 0; i < 200; i++) {
+		int16_t a[3] = {0, 0, 1000};
+		if (i < 100) {
+			a[0] = (int16_t)lround(700.0 * sin(2.0 * 3.14159265358979 * i / 20.0));
+		}
+		int n = edge_detector_update(&det, a, 0, events);
+		for (int k = 0; k < n; k++) {
+			if (events[k].type == MOTION_EVENT_SHAKE) {
+				if (events[k].flags & MOTION_EVENT_F_END) {
+					ends++;
+				} else {
+					starts++;
+					ASSERT_TRUE(events[k].value >= EDGE_DEFAULT_SHAKE_MG);
+				}
+			} else if (events[k].type == MOTION_EVENT_TAP) {
+				taps++;
+			}
+		}
+	}
+	ASSERT_EQ(starts, 1);
+	ASSERT_EQ(ends, 1);
+	ASSERT_EQ(taps, 0);
+	ASSERT_TRUE(!det.shaking);
+	PASS();
+}
+
+/* Test: Tilt starts past the threshold and ends below the hysteresis */
+void test_tilt_hysteresis(void)
+{
+	TEST("tilt_hysteresis");
+	struct edge_detector det;
+	struct motion_event last = {0};
+	const int16_t tilted[3] = {-EDGE_DEFAULT_TILT_MG - 50, 0, 850};
+	const int16_t within[3] = {-(EDGE_DEFAULT_TILT_MG - EDGE_TILT_HYST_MG / 2), 0, 900};
+	const int16_t level[3] = {-(EDGE_DEFAULT_TILT_MG - 2 * EDGE_TILT_HYST_MG), 0, 950};
+	edge_detector_init(&det, NULL);
+	feed(&det, rest, 10, NULL);
+
+	/* Ramp over enough samples that nothing looks like a tap or shake */
+	int n = 0;
+	for (int i = 1; i <= 50; i++) {
+		int16_t a[3] = {(int16_t)(tilted[0] * i / 50), 0,
+		                (int16_t)(1000 + (tilted[2] - 1000) * i / 50)};
+		n += feed(&det, a, 1, &last);
+	}
+	n += feed(&det, tilted, 100, &last);
+	ASSERT_EQ(n, 1);
+	ASSERT_TRUE(det.tilted);
+	ASSERT_EQ(last.type, MOTION_EVENT_TILT);
+	ASSERT_EQ(last.flags, 0);
+	ASSERT_TRUE(last.value > 0);  /* Neck up: positive pitch */
+
+	ASSERT_EQ(feed(&det, within, 100, NULL), 0);
+	ASSERT_EQ(feed(&det, level, 100, &last), 1);
+	ASSERT_EQ(last.flags, MOTION_EVENT_F_END);
+	PASS();
+}
+
+/* Test: A zero threshold disables that event type */
+void test_disabled_types(void)
+{
+	TEST("disabled_types");
+	struct edge_config cfg;
+	struct edge_detector det;
+	struct motion_event events[EDGE_MAX_EVENTS];
+	const int16_t hit[3] = {-900, 0, 400};
+	edge_config_default(&cfg);
+	cfg.tap_mg = 0;
+	cfg.shake_mg = 0;
+	cfg.tilt_mg = 0;
+	edge_detector_init(&det, &cfg);
+	feed(&det, rest, 10, NULL);
+
+	ASSERT_EQ(edge_detector_update(&det, hit, 0, events), 0);
+	ASSERT_EQ(feed(&det, hit, 200, NULL), 0);
+	PASS();
+}
+
+/* Test: NULL arguments are ignored */
+void test_null_safety(void)
+{
+	TEST("null_safety");
+	struct edge_detector det;
+	struct motion_event events[EDGE_MAX_EVENTS];
+	edge_detector_init(NULL, NULL);
+	edge_config_default(NULL);
+	edge_detector_init(&det, NULL);
+	ASSERT_EQ(edge_detector_update(NULL, rest, 0, events), 0);
+	ASSERT_EQ(edge_detector_update(&det, NULL, 0, events), 0);
+	ASSERT_EQ(edge_detector_update(&det, rest, 0, NULL), 0);
+	PASS();
+}
+
+int main(void)
+{
+	printf("=== Edge Event Unit Tests ===\n\n");
+
+	test_event_size();
+	test_init_defaults();
+	test_rest_no_events();
+	test_first_sample_primes();
+	test_tap_start_and_end();
+	test_tap_threshold_and_polarity();
+	test_shake_start_and_end();
+	test_tilt_hysteresis();
+	test_disabled_types();
+	test_null_safety();
+
+	printf("\n=== Test Summary ===\n");
+	printf("Passed: %d/%d\n", tests_passed, tests_total);
+
+	if (tests_passed == tests_total) {
+		printf("ALL TESTS PASSED!\n");
+		return 0;
+	} else {
+		printf("SOME TESTS FAILED!\n");
+		return 1;
+	}
+}
@@ -435,6 +435,120 @@ void test_movement_threshold_null_safety(void)
 	PASS();
 }
 
+/* Test: Convert angular rate to decidegrees/s */
+void test_convert_gyro(void)
+{
+	TEST("convert_gyro");
+	ASSERT_EQ(convert_to_ddps(0.0), 0);
+	ASSERT_EQ(convert_to_ddps(1.5708), 900);       /* 90 dps */
+	ASSERT_EQ(convert_to_ddps(-3.1416), -1800);
+	ASSERT_EQ(convert_to_ddps(100.0), 32767);       /* ~5700 dps, clamped */
+	ASSERT_EQ(convert_to_ddps(-100.0), -32768);
+	
+	struct gyro_data g;
+	convert_gyro_to_ddps(0.01, -0.5, 2.0, &g);
+	ASSERT_EQ(g.x, 5);
+	ASSERT_EQ(g.y, -286);
+	ASSERT_EQ(g.z, 1145);
+	convert_gyro_to_ddps(1.0, 1.0, 1.0, NULL);  /* Should not crash */
+	PASS();
+}
+
+/* Test: Rotation threshold on any axis, either direction */
+void test_rotation_threshold(void)
+{
+	TEST("rotation_threshold");
+	struct gyro_data still = { .x = 10, .y = -20, .z = 50 };
+	struct gyro_data turning = { .x = 0, .y = 0, .z = -51 };
+	
+	ASSERT_FALSE(detect_rotation_threshold(&still, 50));
+	ASSERT_TRUE(detect_rotation_threshold(&turning, 50));
+	ASSERT_FALSE(detect_rotation_threshold(NULL, 50));
+	ASSERT_EQ(sizeof(struct imu_sample), 16);
+	PASS();
+}
+
+/* Test: A burst between two sends reaches the basestation in full */
+void test_gyro_accum_burst(void)
+{
+	TEST("gyro_accum_burst");
+	struct gyro_accumulator acc;
+	struct gyro_data rate;
+	struct gyro_data still = { 0, 0, 0 };
+	struct gyro_data flick = { .x = 0, .y = 0, .z = 9000 };  /* 900 dps */
+	
+	gyro_accum_init(&acc);
+	
+	/* 100 Hz gyro: 50 ms flick inside a 100 ms send interval; a read
+	 * at send time would see the guitar still */
+	for (int i = 0; i <= 10; i++) {
+		gyro_accum_add(&acc, (i >= 3 && i < 8) ? &flick : &still, i * 10000);
+	}
+	gyro_accum_rate(&acc, 100000, &rate);
+	ASSERT_EQ(rate.x, 0);
+	ASSERT_EQ(rate.z, 4500);   /* 45 degrees over 100 ms */
+	gyro_accum_consume(&acc, &rate, 100000);
+	gyro_accum_rate(&acc, 100000, &rate);
+	ASSERT_EQ(rate.z, 0);
+	PASS();
+}
+
+/* Test: A turn below the rotation threshold is still integrated */
+void test_gyro_accum_slow_turn(void)
+{
+	TEST("gyro_accum_slow_turn");
+	struct gyro_accumulator acc;
+	struct gyro_data rate;
+	struct gyro_data turn = { .x = 0, .y = 0, .z = 30 };    /* 3 dps */
+	int64_t sent = 0;
+	
+	gyro_accum_init(&acc);
+	gyro_accum_add(&acc, &turn, 0);
+	
+	/* Keepalive every 200 ms for one second */
+	for (int t = 10000; t <= 1000000; t += 10000) {
+		gyro_accum_add(&acc, &turn, t);
+		if (t % 200000 == 0) {
+			gyro_accum_rate(&acc, 200000, &rate);
+			ASSERT_FALSE(detect_rotation_threshold(&rate, 50));
+			sent += (int64_t)rate.z * 200000;
+			gyro_accum_consume(&acc, &rate, 200000);
+		}
+	}
+	ASSERT_EQ((int)(sent / 100000), 300);   /* 30 decidegrees = 3 degrees */
+	PASS();
+}
+
+/* Test: Clamped mean leaves the rest for the next send; no interval
+ * sends the latest rate */
+void test_gyro_accum_carry(void)
+{
+	TEST("gyro_accum_carry");
+	struct gyro_accumulator acc;
+	struct gyro_data rate;
+	struct gyro_data fast = { .x = -30000, .y = 0, .z = 0 };
+	
+	gyro_accum_init(&acc);
+	gyro_accum_add(&acc, &fast, 0xFFFFFFFF - 49999);   /* Clock wraps */
+	gyro_accum_add(&acc, &fast, 50000);                 /* 100 ms */
+	
+	gyro_accum_rate(&acc, 50000, &rate);
+	ASSERT_EQ(rate.x, -32768);
+	gyro_accum_consume(&acc, &rate, 50000);
+	gyro_accum_rate(&acc, 50000, &rate);
+	ASSERT_EQ(rate.x, -27232);   /* 2 x 30000 - 32768 */
+	
+	gyro_accum_rate(&acc, 0, &rate);
+	ASSERT_EQ(rate.x, -30000);
+	gyro_accum_consume(&acc, &rate, 0);
+	gyro_accum_rate(&acc, 50000, &rate);
+	ASSERT_EQ(rate.x, 0);
+	
+	gyro_accum_rate(NULL, 0, &rate);     /* Should not crash */
+	gyro_accum_add(&acc, NULL, 0);
+	PASS();
+}
+
 int main(void)
 {
 	printf("=== Motion Logic Unit Tests ===\n\n");
@@ -484,6 +598,13 @@ int main(void)
 	test_movement_threshold_negative_change();
 	test_movement_threshold_null_safety();
 	
+	/* Gyroscope tests */
+	test_convert_gyro();
+	test_rotation_threshold();
+	test_gyro_accum_burst();
+	test_gyro_accum_slow_turn();
+	test_gyro_accum_carry();
+	
 	printf("\n=== Test Summary ===\n");
 	printf("Passed: %d/%d\n", tests_passed, tests_total);
 	
@@ -6,18 +6,11 @@
  */
 
 #include "basestation_emulator.h"
+#include "edge_events.h"
+#include <errno.h>
 #include <string.h>
 #include <stdio.h>
 
-/* MIDI CC numbers (from midi_logic.h) */
-#define MIDI_CC_X_AXIS 16
-#define MIDI_CC_Y_AXIS 17
-#define MIDI_CC_Z_AXIS 18
-
-/* External midi_logic functions (implemented in midi_logic.c) */
-extern uint8_t accel_to_midi_cc(int16_t milli_g);
-extern void construct_midi_cc_msg(uint8_t channel, uint8_t cc_number, uint8_t value, uint8_t *msg_out);
-
 /* GATT Characteristic handle for acceleration data */
 #define ACCEL_CHAR_HANDLE 1
 
@@ -34,6 +27,9 @@ static void basestation_disconnected_cb(ble_conn_handle_t handle, uint8_t reason
 static void basestation_notify_cb(ble_conn_handle_t handle, ble_gatt_handle_t char_handle,
                                   const void *data, size_t len);
 
+static int basestation_midi_tx(int guitar_id, int output, const uint8_t *msg, size_t len,
+                               void *user_data);
+
 /* Global reference for callbacks */
 static basestation_emulator_t *g_base = NULL;
 
@@ -59,6 +55,21 @@ int basestation_emulator_init(basestation_emulator_t *base)
 	}
 	
 	memset(base, 0, sizeof(basestation_emulator_t));
+	latency_init(&base->latency);
+	midi_uart_model_init(&base->uart);
+	midi_pipeline_init(&base->pipeline, basestation_midi_tx, base);
+	
+	/* Factory default patch (config_storage_get_hardcoded_defaults()) */
+	struct patch_topology_config topo;
+	struct function_unit funcs[MAX_FUNCTION_UNITS];
+	
+	topology_patch_init_default(&topo);
+	for (int i = 0; i < MAX_FUNCTION_UNITS; i++) {
+		func_init_linear(&funcs[i], -2000, 2000, 0, 127);
+	}
+	midi_pipeline_configure(&base->pipeline, topo.topologies, topo.default_mixer_type,
+	                        funcs, 0, 1);
+	
 	base->initialized = true;
 	g_base = base;
 	
@@ -176,6 +187,10 @@ int basestation_emulator_connect(basestation_emulator_t *base, const uint8_t *ad
 	guitar->connected = true;
 	guitar->handle = handle;
 	memcpy(guitar->addr, addr, 6);
+	latency_clock_reset(&guitar->clock);
+	imu_fusion_init(&guitar->fusion, 0);
+	derived_sources_init(&guitar->derived, DERIVED_TILT_DEFAULT_SHIFT);
+	gesture_engine_init(&guitar->gestures);
 	
 	return 0;
 }
@@ -197,6 +212,11 @@ static void basestation_disconnected_cb(ble_conn_handle_t handle, uint8_t reason
 	/* Remove from guitar list */
 	for (int i = 0; i < g_base->num_guitars; i++) {
 		if (g_base->guitars[i].handle == handle) {
+			/* No gesture note left hanging, as in main.c */
+			g_base->tx_ctx.guitar_index = i;
+			g_base->tx_ctx.timed = false;
+			midi_pipeline_release_gestures(&g_base->pipeline, i, &g_base->guitars[i].gestures);
+			
 			/* Shift remaining guitars down */
 			for (int j = i; j < g_base->num_guitars - 1; j++) {
 				g_base->guitars[j] = g_base->guitars[j + 1];
@@ -236,10 +256,41 @@ int basestation_emulator_enable_notifications(basestation_emulator_t *base, int
 	return err;
 }
 
+/* Pipeline TX backend: the MIDI UART model, a CC queued now finishes after
+ * any bytes ahead of it */
+static int basestation_midi_tx(int guitar_id, int output, const uint8_t *msg, size_t len,
+                               void *user_data)
+{
+	basestation_emulator_t *base = user_data;
+	uint32_t queued_us = ble_hal_get_time_us();
+	uint32_t done_us;
+	
+	if (midi_uart_model_queue(&base->uart, queued_us, len, &done_us) != 0) {
+		base->midi_messages_dropped++;
+		return -ENOMEM;
+	}
+	
+	if (len <= sizeof(base->last_midi[output].msg)) {
+		memcpy(base->last_midi[output].msg, msg, len);
+		base->last_midi[output].valid = true;
+	}
+	base->midi_messages_sent++;
+	
+	if (base->tx_ctx.timed) {
+		latency_record(&base->latency, base->tx_ctx.sample_us, base->tx_ctx.rx_us,
+		               queued_us, done_us);
+	}
+	if (base->midi_cb) {
+		base->midi_cb(guitar_id, msg, len, queued_us, done_us, base->midi_cb_data);
+	}
+	
+	return 0;
+}
+
 static void basestation_notify_cb(ble_conn_handle_t handle, ble_gatt_handle_t char_handle,
                                   const void *data, size_t len)
 {
-	if (!g_base || len != sizeof(struct accel_data)) {
+	if (!g_base) {
 		return;
 	}
 	
@@ -248,31 +299,117 @@ static void basestation_notify_cb(ble_conn_handle_t handle, ble_gatt_handle_t ch
 		return;
 	}
 	
+	const struct accel_data *accel;
+	const struct gyro_data *gyro = NULL;
+	uint32_t sample_ts = 0;
+	uint32_t rx_us = ble_hal_get_time_us();
+	
+	g_base->tx_ctx.guitar_index = (int)(guitar - g_base->guitars);
+	g_base->tx_ctx.rx_us = rx_us;
+	g_base->tx_ctx.timed = false;
+	
+	if (len == sizeof(struct accel_sample)) {
+		/* Timestamped sample: same clock offset estimation as firmware */
+		const struct accel_sample *sample = (const struct accel_sample *)data;
+		
+		latency_clock_update(&guitar->clock, sample->timestamp_us, rx_us);
+		g_base->tx_ctx.sample_us = latency_clock_to_local(&guitar->clock, sample->timestamp_us);
+		g_base->tx_ctx.timed = true;
+		accel = &sample->accel;
+	} else if (len == sizeof(struct imu_sample)) {
+		const struct imu_sample *sample = (const struct imu_sample *)data;
+		
+		latency_clock_update(&guitar->clock, sample->timestamp_us, rx_us);
+		g_base->tx_ctx.sample_us = latency_clock_to_local(&guitar->clock, sample->timestamp_us);
+		g_base->tx_ctx.timed = true;
+		accel = &sample->accel;
+		gyro = &sample->gyro;
+		sample_ts = sample->timestamp_us;
+	} else if (len == sizeof(struct accel_data)) {
+		accel = (const struct accel_data *)data;
+	} else if (len == sizeof(struct motion_event)) {
+		/* Edge event: same path as process_motion_event() in main.c */
+		const struct motion_event *ev = (const struct motion_event *)data;
+		uint8_t type = (ev->type == MOTION_EVENT_TAP) ? GESTURE_TAP :
+		               (ev->type == MOTION_EVENT_SHAKE) ? GESTURE_SHAKE :
+		               (ev->type == MOTION_EVENT_TILT) ? GESTURE_TILT : GESTURE_NONE;
+		
+		latency_clock_update(&guitar->clock, ev->timestamp_us, rx_us);
+		g_base->tx_ctx.sample_us = latency_clock_to_local(&guitar->clock, ev->timestamp_us);
+		g_base->tx_ctx.timed = true;
+		g_base->packets_received++;
+		if (type == GESTURE_NONE) {
+			return;
+		}
+		
+		int sent = midi_pipeline_process_remote_gesture(&g_base->pipeline,
+		                                                g_base->tx_ctx.guitar_index,
+		                                                &guitar->gestures, type,
+		                                                (ev->flags & MOTION_EVENT_F_END) != 0,
+		                                                ev->value);
+		if (!g_base->quiet) {
+			printf("[BASESTATION] Received event: %s%s, value %d (%d sent)\n",
+			       gesture_type_name(type),
+			       (ev->flags & MOTION_EVENT_F_END) ? " end" : "", ev->value, sent);
+		}
+		return;
+	} else {
+		return;
+	}
+	
 	/* Copy acceleration data */
-	const struct accel_data *accel = (const struct accel_data *)data;
 	guitar->last_accel = *accel;
 	g_base->packets_received++;
 	
-	printf("[BASESTATION DEBUG] Notify callback: g_base=%p, packets_received=%u\n",
-	       (void*)g_base, g_base->packets_received);
-	
-	/* Convert to MIDI using actual midi_logic */
-	uint8_t midi_x = accel_to_midi_cc(accel->x);
-	uint8_t midi_y = accel_to_midi_cc(accel->y);
-	uint8_t midi_z = accel_to_midi_cc(accel->z);
-	
-	/* Construct MIDI CC messages */
-	construct_midi_cc_msg(0, MIDI_CC_X_AXIS, midi_x, g_base->last_midi_x.msg);
-	construct_midi_cc_msg(0, MIDI_CC_Y_AXIS, midi_y, g_base->last_midi_y.msg);
-	construct_midi_cc_msg(0, MIDI_CC_Z_AXIS, midi_z, g_base->last_midi_z.msg);
+	/* Same path as process_accel_data() in main.c */
+	int16_t accel_values[MAX_SENSOR_SOURCES] = {accel->x, accel->y, accel->z};
+	if (gyro) {
+		const int16_t a[3] = {accel->x, accel->y, accel->z};
+		const int16_t g[3] = {gyro->x, gyro->y, gyro->z};
+		
+		imu_fusion_update(&guitar->fusion, a, g, sample_ts);
+		imu_fusion_get_angles(&guitar->fusion, &accel_values[3]);
+	}
+	derived_sources_update(&guitar->derived, accel_values, gyro != NULL,
+	                       g_base->pipeline.source_mask);
+	int sent = midi_pipeline_process_gestures(&g_base->pipeline, g_base->tx_ctx.guitar_index,
+	                                          &guitar->gestures, accel_values);
+	sent += midi_pipeline_process(&g_base->pipeline, g_base->tx_ctx.guitar_index,
+	                              accel_values);
+	
+	if (!g_base->quiet) {
+		const uint8_t *out = g_base->pipeline.outputs;
+		printf("[BASESTATION] Received accel: X=%d, Y=%d, Z=%d milli-g -> "
+		       "MIDI: %d %d %d %d %d %d (%d sent)\n",
+		       accel->x, accel->y, accel->z,
+		       out[0], out[1], out[2], out[3], out[4], out[5], sent);
+	}
+}
+
+int basestation_emulator_configure(basestation_emulator_t *base,
+                                   const struct topology_instance *topologies,
+                                   uint8_t mixer_type,
+                                   const struct function_unit *functions,
+                                   uint8_t midi_channel, int16_t deadzone)
+{
+	if (!base || !base->initialized || !topologies || !functions) {
+		return -1;
+	}
 	
-	g_base->last_midi_x.valid = true;
-	g_base->last_midi_y.valid = true;
-	g_base->last_midi_z.valid = true;
-	g_base->midi_messages_sent += 3;
+	midi_pipeline_configure(&base->pipeline, topologies, mixer_type, functions,
+	                        midi_channel, deadzone);
+	return 0;
+}
+
+void basestation_emulator_set_midi_cb(basestation_emulator_t *base,
+                                      basestation_midi_cb_t cb, void *user_data)
+{
+	if (!base) {
+		return;
+	}
 	
-	printf("[BASESTATION] Received accel: X=%d, Y=%d, Z=%d milli-g -> MIDI: X=%d, Y=%d, Z=%d\n",
-	       accel->x, accel->y, accel->z, midi_x, midi_y, midi_z);
+	base->midi_cb = cb;
+	base->midi_cb_data = user_data;
 }
 
 /* ============================================================================
@@ -280,26 +417,17 @@ static void basestation_notify_cb(ble_conn_handle_t handle, ble_gatt_handle_t ch
  * ============================================================================ */
 
 bool basestation_emulator_get_last_midi(const basestation_emulator_t *base,
-                                        int axis, uint8_t *msg)
+                                        int output, uint8_t *msg)
 {
-	if (!base || !msg) {
+	if (!base || !msg || output < 0 || output >= MIDI_PIPELINE_NUM_OUTPUTS) {
 		return false;
 	}
 	
-	const midi_output_t *output = NULL;
-	
-	switch (axis) {
-	case 0: output = &base->last_midi_x; break;
-	case 1: output = &base->last_midi_y; break;
-	case 2: output = &base->last_midi_z; break;
-	default: return false;
-	}
-	
-	if (!output->valid) {
+	if (!base->last_midi[output].valid) {
 		return false;
 	}
 	
-	memcpy(msg, output->msg, 3);
+	memcpy(msg, base->last_midi[output].msg, 3);
 	return true;
 }
 
@@ -308,6 +436,11 @@ int basestation_emulator_get_num_guitars(const basestation_emulator_t *base)
 	return base ? base->num_guitars : 0;
 }
 
+const struct latency_tracker *basestation_emulator_get_latency(const basestation_emulator_t *base)
+{
+	return base ? &base->latency : NULL;
+}
+
 /* ============================================================================
  * Debug Functions
  * ============================================================================ */
@@ -331,21 +464,18 @@ void basestation_emulator_dump_state(const basestation_emulator_t *base)
 	}
 	
 	printf("\nLast MIDI Output:\n");
-	if (base->last_midi_x.valid) {
-		printf("  X-axis: [0x%02X 0x%02X 0x%02X]\n",
-		       base->last_midi_x.msg[0], base->last_midi_x.msg[1], base->last_midi_x.msg[2]);
-	}
-	if (base->last_midi_y.valid) {
-		printf("  Y-axis: [0x%02X 0x%02X 0x%02X]\n",
-		       base->last_midi_y.msg[0], base->last_midi_y.msg[1], base->last_midi_y.msg[2]);
-	}
-	if (base->last_midi_z.valid) {
-		printf("  Z-axis: [0x%02X 0x%02X 0x%02X]\n",
-		       base->last_midi_z.msg[0], base->last_midi_z.msg[1], base->last_midi_z.msg[2]);
+	for (int i = 0; i < MIDI_PIPELINE_NUM_OUTPUTS; i++) {
+		const midi_output_t *out = &base->last_midi[i];
+		if (out->valid) {
+			printf("  Output %d: [0x%02X 0x%02X 0x%02X]\n",
+			       i, out->msg[0], out->msg[1], out->msg[2]);
+		}
 	}
 	
 	printf("\nStatistics:\n");
 	printf("  Packets received:     %u\n", base->packets_received);
 	printf("  MIDI messages sent:   %u\n", base->midi_messages_sent);
+	printf("  MIDI messages dropped: %u\n", base->midi_messages_dropped);
+	printf("  UART backlog max:     %u us\n", base->uart.max_backlog_us);
 	printf("===================================\n\n");
 }
@@ -3,7 +3,8 @@
  * SPDX-License-Identifier: Apache-2.0
  *
  * Basestation Emulator for Integration Testing
- * Uses actual midi_logic.c for business logic
+ * Runs every sample through the firmware's midi_pipeline.c (topology
+ * processor, deadzone, CC construction) into a model of the MIDI TX queue
  */
 
 #ifndef BASESTATION_EMULATOR_H
@@ -13,6 +14,10 @@
 #include <stdbool.h>
 #include "ble_hal.h"
 #include "common_defs.h"
+#include "latency_tracker.h"
+#include "midi_pipeline.h"
+#include "imu_fusion.h"
+#include "derived_sources.h"
 
 #define MAX_GUITARS 4
 
@@ -28,8 +33,28 @@ typedef struct {
 	ble_conn_handle_t handle;
 	uint8_t addr[6];
 	struct accel_data last_accel;
+	struct latency_clock clock;  /* Client-to-simulated clock offset */
+	struct imu_fusion fusion;    /* Roll/pitch/yaw from imu_sample packets */
+	struct derived_sources derived;  /* Accel-only tilt */
+	struct gesture_engine gestures;  /* Note/trigger detection */
 } guitar_info_t;
 
+/**
+ * @brief MIDI output observer
+ * 
+ * Called for every message the TX queue model accepts.
+ * 
+ * @param guitar_index Guitar index (0-3)
+ * @param msg Message bytes, as queued for the UART
+ * @param len Message length
+ * @param queued_us Simulated time the message was queued
+ * @param tx_done_us Simulated time its last byte leaves the UART
+ * @param user_data Pointer given to basestation_emulator_set_midi_cb()
+ */
+typedef void (*basestation_midi_cb_t)(int guitar_index, const uint8_t *msg, size_t len,
+                                      uint32_t queued_us, uint32_t tx_done_us,
+                                      void *user_data);
+
 /* Basestation state */
 typedef struct {
 	bool initialized;
@@ -39,14 +64,33 @@ typedef struct {
 	guitar_info_t guitars[MAX_GUITARS];
 	int num_guitars;
 	
-	/* Last MIDI outputs (for verification) */
-	midi_output_t last_midi_x;
-	midi_output_t last_midi_y;
-	midi_output_t last_midi_z;
+	/* Firmware MIDI pipeline, shared by all guitars as on target */
+	struct midi_pipeline pipeline;
+	struct midi_uart_model uart;
+	
+	/* Last MIDI message queued per output (for verification) */
+	midi_output_t last_midi[MIDI_PIPELINE_NUM_OUTPUTS];
 	
 	/* Statistics */
 	uint32_t packets_received;
-	uint32_t midi_messages_sent;
+	uint32_t midi_messages_sent;     /* Accepted by the TX queue model */
+	uint32_t midi_messages_dropped;  /* Rejected as the firmware ring would */
+	
+	/* Latency tracing (same tracker as firmware, simulated timestamps) */
+	struct latency_tracker latency;
+	
+	/* Sample being processed; consumed by the TX backend */
+	struct {
+		int guitar_index;
+		bool timed;
+		uint32_t sample_us;
+		uint32_t rx_us;
+	} tx_ctx;
+	
+	/* Optional MIDI observer (replay driver) */
+	basestation_midi_cb_t midi_cb;
+	void *midi_cb_data;
+	bool quiet;  /* Suppress per-sample log lines */
 } basestation_emulator_t;
 
 /**
@@ -91,16 +135,47 @@ int basestation_emulator_connect(basestation_emulator_t *base, const uint8_t *ad
  */
 int basestation_emulator_enable_notifications(basestation_emulator_t *base, int guitar_index);
 
+/**
+ * @brief Load a patch into the MIDI pipeline
+ * 
+ * basestation_emulator_init() loads the factory default patch (T1 per axis,
+ * linear ±2g to 0-127 on CC 16-21, channel 1, deadzone 1).
+ * 
+ * @param base Basestation emulator instance
+ * @param topologies MAX_TOPOLOGY_INSTANCES topology instances
+ * @param mixer_type Default virtual port mixer
+ * @param functions MAX_FUNCTION_UNITS function units
+ * @param midi_channel MIDI channel (0-15)
+ * @param deadzone Minimum CC change to send
+ * @return 0 on success, negative errno on failure
+ */
+int basestation_emulator_configure(basestation_emulator_t *base,
+                                   const struct topology_instance *topologies,
+                                   uint8_t mixer_type,
+                                   const struct function_unit *functions,
+                                   uint8_t midi_channel, int16_t deadzone);
+
+/**
+ * @brief Observe every MIDI message accepted by the TX queue model
+ * 
+ * @param base Basestation emulator instance
+ * @param cb Observer, or NULL to remove
+ * @param user_data Passed to the observer
+ */
+void basestation_emulator_set_midi_cb(basestation_emulator_t *base,
+                                      basestation_midi_cb_t cb, void *user_data);
+
 /**
  * @brief Get last MIDI output for verification
  * 
  * @param base Basestation emulator instance
- * @param axis Axis (0=X, 1=Y, 2=Z)
+ * @param output MIDI output index (default patch: 0=X, 1=Y, 2=Z), or
+ *               MIDI_PIPELINE_GESTURE_OUTPUT(slot) for gesture messages
  * @param msg Output buffer for MIDI message (3 bytes)
  * @return true if valid MIDI message available, false otherwise
  */
 bool basestation_emulator_get_last_midi(const basestation_emulator_t *base,
-                                        int axis, uint8_t *msg);
+                                        int output, uint8_t *msg);
 
 /**
  * @brief Get number of connected guitars
@@ -110,6 +185,14 @@ bool basestation_emulator_get_last_midi(const basestation_emulator_t *base,
  */
 int basestation_emulator_get_num_guitars(const basestation_emulator_t *base);
 
+/**
+ * @brief Get motion-to-MIDI latency tracker
+ * 
+ * @param base Basestation emulator instance
+ * @return Pointer to latency tracker, NULL if base is NULL
+ */
+const struct latency_tracker *basestation_emulator_get_latency(const basestation_emulator_t *base);
+
 /**
  * @brief Cleanup basestation emulator
  * 
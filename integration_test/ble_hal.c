@@ -17,7 +17,7 @@
 
 #define MAX_CONNECTIONS 4
 #define MAX_DEVICES 10
-#define MAX_EVENTS 100
+#define MAX_EVENTS 256
 #define MAX_ADV_DATA 31
 
 /* Event types */
@@ -44,6 +44,8 @@ typedef struct {
 	uint8_t data[256];
 	size_t data_len;
 	uint8_t reason;
+	uint32_t queued_at_us;   /* Simulated time the event was posted */
+	uint32_t deliver_at_us;  /* Simulated delivery time */
 } ble_event_t;
 
 /* Device information (for scanning) */
@@ -68,6 +70,18 @@ typedef struct {
 	ble_notify_rx_cb_t notify_rx_cb;
 	ble_gatt_handle_t notify_char_handle;
 	bool notify_enabled;
+	
+	/* Radio model */
+	ble_radio_params_t radio;
+	uint32_t rng;
+	bool burst;                 /* Burst loss state */
+	bool sched_valid;
+	uint32_t sched_anchor_us;   /* Latest connection event with data scheduled */
+	uint32_t sched_jitter_us;
+	uint32_t sched_used_us;     /* Air time used in that event */
+	uint8_t sched_pdus;
+	uint32_t in_flight;
+	ble_conn_metrics_t metrics;
 } ble_connection_t;
 
 /* Global state */
@@ -91,7 +105,13 @@ static struct {
 	ble_device_t devices[MAX_DEVICES];
 	int num_devices;
 	
-	/* Message queue */
+	/* Simulated clock */
+	uint32_t time_us;
+	
+	/* Radio model seed */
+	uint32_t seed;
+	
+	/* Message queue, ordered by delivery time */
 	ble_event_t event_queue[MAX_EVENTS];
 	int queue_head;
 	int queue_tail;
@@ -103,16 +123,37 @@ static struct {
  * Internal Helper Functions
  * ============================================================================ */
 
-static void enqueue_event(const ble_event_t *event)
+/* Events posted without a delivery time are due now */
+static int enqueue_event_at(const ble_event_t *event, uint32_t deliver_at_us)
 {
 	if (ble_state.queue_count >= MAX_EVENTS) {
 		printf("WARNING: BLE event queue full, dropping event\n");
-		return;
+		return -1;
 	}
 	
-	ble_state.event_queue[ble_state.queue_tail] = *event;
+	/* Insert after every event due at or before this one; almost always
+	 * the tail, since time only moves forward */
+	int pos = ble_state.queue_tail;
+	for (int n = ble_state.queue_count; n > 0; n--) {
+		int prev = (pos + MAX_EVENTS - 1) % MAX_EVENTS;
+		if ((int32_t)(ble_state.event_queue[prev].deliver_at_us - deliver_at_us) <= 0) {
+			break;
+		}
+		ble_state.event_queue[pos] = ble_state.event_queue[prev];
+		pos = prev;
+	}
+	
+	ble_state.event_queue[pos] = *event;
+	ble_state.event_queue[pos].queued_at_us = ble_state.time_us;
+	ble_state.event_queue[pos].deliver_at_us = deliver_at_us;
 	ble_state.queue_tail = (ble_state.queue_tail + 1) % MAX_EVENTS;
 	ble_state.queue_count++;
+	return 0;
+}
+
+static void enqueue_event(const ble_event_t *event)
+{
+	enqueue_event_at(event, ble_state.time_us);
 }
 
 static bool dequeue_event(ble_event_t *event)
@@ -138,6 +179,127 @@ static ble_conn_handle_t allocate_connection(void)
 	return BLE_CONN_HANDLE_INVALID;
 }
 
+/* ============================================================================
+ * Radio Model
+ * ============================================================================ */
+
+static void radio_seed(ble_connection_t *conn, ble_conn_handle_t handle)
+{
+	conn->rng = ble_state.seed ^ ((uint32_t)(handle + 1) * 0x9E3779B9u);
+	if (conn->rng == 0) {
+		conn->rng = 0x6D2B79F5u;
+	}
+	conn->burst = false;
+}
+
+/* xorshift32 */
+static uint32_t radio_rand(ble_connection_t *conn)
+{
+	uint32_t x = conn->rng;
+	
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	conn->rng = x;
+	return x;
+}
+
+static bool radio_pdu_lost(ble_connection_t *conn)
+{
+	const ble_radio_params_t *rp = &conn->radio;
+	
+	if (conn->burst) {
+		if (radio_rand(conn) % 1000 < rp->burst_exit_permille) {
+			conn->burst = false;
+		}
+	} else if (rp->burst_enter_permille &&
+	           radio_rand(conn) % 1000 < rp->burst_enter_permille) {
+		conn->burst = true;
+	}
+	if (conn->burst) {
+		return true;
+	}
+	
+	return rp->loss_permille && radio_rand(conn) % 1000 < rp->loss_permille;
+}
+
+/* Central's empty PDU, T_IFS, notification PDU, T_IFS */
+static uint32_t radio_exchange_us(ble_phy_t phy, size_t len)
+{
+	/* Preamble, access address, header, CRC; plus L2CAP and ATT headers */
+	if (phy == BLE_PHY_2M) {
+		return (2 + 4 + 2 + 3) * 4 + BLE_T_IFS_US +
+		       (uint32_t)(2 + 4 + 2 + 4 + 3 + len + 3) * 4 + BLE_T_IFS_US;
+	}
+	return (1 + 4 + 2 + 3) * 8 + BLE_T_IFS_US +
+	       (uint32_t)(1 + 4 + 2 + 4 + 3 + len + 3) * 8 + BLE_T_IFS_US;
+}
+
+/* First connection event anchor at or after t */
+static uint32_t radio_next_anchor(const ble_connection_t *conn, uint32_t t)
+{
+	uint32_t interval = conn->radio.conn_interval_us;
+	uint32_t rem = (t + interval - conn->radio.anchor_offset_us) % interval;
+	
+	return rem ? t + (interval - rem) : t;
+}
+
+/**
+ * Place a notification of len bytes sent now into a connection event
+ * 
+ * @return 0 with *deliver_at_us set, or -1 if lost after max_retx
+ */
+static int radio_schedule(ble_connection_t *conn, size_t len, uint32_t *deliver_at_us)
+{
+	const ble_radio_params_t *rp = &conn->radio;
+	uint32_t interval = rp->conn_interval_us;
+	uint32_t exchange = radio_exchange_us(rp->phy, len);
+	uint32_t retx_delay = interval * (rp->retx_delay_events ? rp->retx_delay_events : 1);
+	uint32_t anchor = radio_next_anchor(conn, ble_state.time_us);
+	int retx = 0;
+	
+	/* In order: never ahead of the last scheduled notification */
+	if (conn->sched_valid && (int32_t)(conn->sched_anchor_us - anchor) > 0) {
+		anchor = conn->sched_anchor_us;
+	}
+	
+	for (;;) {
+		if (!conn->sched_valid || anchor != conn->sched_anchor_us) {
+			conn->sched_valid = true;
+			conn->sched_anchor_us = anchor;
+			conn->sched_used_us = 0;
+			conn->sched_pdus = 0;
+			conn->sched_jitter_us = rp->jitter_us ? radio_rand(conn) % (rp->jitter_us + 1) : 0;
+			conn->metrics.data_events++;
+		}
+		
+		bool full = (conn->sched_pdus > 0 && conn->sched_used_us + exchange > interval) ||
+		            (rp->max_pdus_per_event && conn->sched_pdus >= rp->max_pdus_per_event);
+		if (full) {
+			anchor += interval;
+			continue;
+		}
+		
+		uint32_t end_us = anchor + conn->sched_jitter_us + conn->sched_used_us +
+		                  exchange - BLE_T_IFS_US;
+		conn->sched_used_us += exchange;
+		conn->sched_pdus++;
+		
+		if (!radio_pdu_lost(conn)) {
+			*deliver_at_us = end_us;
+			return 0;
+		}
+		
+		/* Lost PDU closes the event */
+		if (rp->max_retx && retx >= rp->max_retx) {
+			return -1;
+		}
+		retx++;
+		conn->metrics.retransmissions++;
+		anchor += retx_delay;
+	}
+}
+
 static void free_connection(ble_conn_handle_t handle)
 {
 	if (handle < MAX_CONNECTIONS) {
@@ -174,6 +336,8 @@ int ble_hal_init(void)
 {
 	memset(&ble_state, 0, sizeof(ble_state));
 	
+	ble_state.seed = 1;
+	
 	/* Generate a random address for this device */
 	for (int i = 0; i < 6; i++) {
 		ble_state.own_addr[i] = rand() & 0xFF;
@@ -346,6 +510,7 @@ ble_conn_handle_t ble_hal_connect(const uint8_t *addr,
 	ble_connection_t *conn = &ble_state.connections[handle];
 	conn->state = BLE_CONN_STATE_CONNECTING;
 	memcpy(conn->addr, addr, 6);
+	radio_seed(conn, handle);
 	conn->connected_cb = connected_cb;
 	conn->disconnected_cb = disconnected_cb;
 	
@@ -418,14 +583,41 @@ int ble_hal_notify(ble_conn_handle_t handle, ble_gatt_handle_t char_handle,
 		return -4;  /* Data too large */
 	}
 	
-	/* Post notification event */
+	if (conn->radio.tx_buffers && conn->in_flight >= conn->radio.tx_buffers) {
+		conn->metrics.rejected++;
+		return -5;  /* No TX buffer */
+	}
+	
+	/* Post notification event, delivered when its PDU ends */
+	uint32_t deliver_at_us = ble_state.time_us;
 	ble_event_t event = {0};
 	event.type = EVENT_NOTIFY_RX;
 	event.handle = handle;
 	event.char_handle = char_handle;
 	memcpy(event.data, data, len);
 	event.data_len = len;
-	enqueue_event(&event);
+	
+	if (conn->metrics.notifications == 0) {
+		conn->metrics.first_notify_us = ble_state.time_us;
+	}
+	
+	if (conn->radio.conn_interval_us > 0 && radio_schedule(conn, len, &deliver_at_us) != 0) {
+		/* Link gave up: the sender never finds out */
+		conn->metrics.notifications++;
+		conn->metrics.lost++;
+		return 0;
+	}
+	
+	if (enqueue_event_at(&event, deliver_at_us) != 0) {
+		conn->metrics.rejected++;
+		return -5;
+	}
+	
+	conn->metrics.notifications++;
+	conn->in_flight++;
+	if (conn->in_flight > conn->metrics.max_in_flight) {
+		conn->metrics.max_in_flight = conn->in_flight;
+	}
 	
 	return 0;
 }
@@ -480,94 +672,143 @@ int ble_hal_notify_disable(ble_conn_handle_t handle, ble_gatt_handle_t char_hand
  * Event Processing
  * ============================================================================ */
 
-int ble_hal_process_events(void)
+/* Deliver one event; the clock jumps to its delivery time */
+static void process_event(const ble_event_t *event)
 {
-	if (!ble_state.initialized) {
-		return -1;
+	if ((int32_t)(event->deliver_at_us - ble_state.time_us) > 0) {
+		ble_state.time_us = event->deliver_at_us;
 	}
 	
-	int processed = 0;
-	ble_event_t event;
-	
-	while (dequeue_event(&event)) {
-		processed++;
-		
-		switch (event.type) {
-		case EVENT_CONNECTED:
-			if (event.handle < MAX_CONNECTIONS) {
-				ble_connection_t *conn = &ble_state.connections[event.handle];
-				conn->state = BLE_CONN_STATE_CONNECTED;
-				
-				/* Notify central (initiator) */
-				if (conn->connected_cb) {
-					conn->connected_cb(event.handle);
-				}
-				
-				/* Notify peripheral (acceptor) */
-				ble_device_t *peripheral = find_device_by_addr(conn->addr);
-				if (peripheral && peripheral->peripheral_connected_cb) {
-					peripheral->peripheral_connected_cb(event.handle, conn->addr);
-				}
+	switch (event->type) {
+	case EVENT_CONNECTED:
+		if (event->handle < MAX_CONNECTIONS) {
+			ble_connection_t *conn = &ble_state.connections[event->handle];
+			conn->state = BLE_CONN_STATE_CONNECTED;
+			
+			/* Notify central (initiator) */
+			if (conn->connected_cb) {
+				conn->connected_cb(event->handle);
 			}
-			break;
 			
-		case EVENT_DISCONNECTED:
-			if (event.handle < MAX_CONNECTIONS) {
-				ble_connection_t *conn = &ble_state.connections[event.handle];
-				conn->state = BLE_CONN_STATE_DISCONNECTED;
-				
-				/* Notify central */
-				if (conn->disconnected_cb) {
-					conn->disconnected_cb(event.handle, event.reason);
-				}
-				
-				/* Notify peripheral */
-				ble_device_t *peripheral = find_device_by_addr(conn->addr);
-				if (peripheral && peripheral->peripheral_disconnected_cb) {
-					peripheral->peripheral_disconnected_cb(event.handle, event.reason);
-				}
-				
-				free_connection(event.handle);
+			/* Notify peripheral (acceptor) */
+			ble_device_t *peripheral = find_device_by_addr(conn->addr);
+			if (peripheral && peripheral->peripheral_connected_cb) {
+				peripheral->peripheral_connected_cb(event->handle, conn->addr);
 			}
-			break;
+		}
+		break;
+		
+	case EVENT_DISCONNECTED:
+		if (event->handle < MAX_CONNECTIONS) {
+			ble_connection_t *conn = &ble_state.connections[event->handle];
+			conn->state = BLE_CONN_STATE_DISCONNECTED;
 			
-		case EVENT_NOTIFY_RX:
-			if (event.handle < MAX_CONNECTIONS) {
-				ble_connection_t *conn = &ble_state.connections[event.handle];
-				if (conn->notify_rx_cb) {
-					conn->notify_rx_cb(event.handle, event.char_handle,
-					                  event.data, event.data_len);
-				}
+			/* Notify central */
+			if (conn->disconnected_cb) {
+				conn->disconnected_cb(event->handle, event->reason);
 			}
-			break;
 			
-		case EVENT_ADV_START:
-			/* Notify scanners */
-			if (ble_state.scanning && ble_state.scan_cb) {
-				ble_device_t *dev = find_device_by_addr(event.addr);
-				if (dev && dev->advertising) {
-					ble_adv_data_t adv_data = {
-						.data = dev->adv_data,
-						.len = dev->adv_data_len
-					};
-					ble_state.scan_cb(dev->addr, &adv_data);
-				}
+			/* Notify peripheral */
+			ble_device_t *peripheral = find_device_by_addr(conn->addr);
+			if (peripheral && peripheral->peripheral_disconnected_cb) {
+				peripheral->peripheral_disconnected_cb(event->handle, event->reason);
 			}
-			break;
 			
-		case EVENT_NOTIFY_ENABLE:
-			/* Notify peripheral that notifications were enabled */
-			{
-				ble_device_t *peripheral = find_device_by_addr(event.addr);
-				if (peripheral && peripheral->peripheral_notify_enabled_cb) {
-					peripheral->peripheral_notify_enabled_cb(event.handle, event.char_handle);
-				}
+			free_connection(event->handle);
+		}
+		break;
+		
+	case EVENT_NOTIFY_RX:
+		if (event->handle < MAX_CONNECTIONS) {
+			ble_connection_t *conn = &ble_state.connections[event->handle];
+			ble_conn_metrics_t *m = &conn->metrics;
+			uint32_t latency_us = event->deliver_at_us - event->queued_at_us;
+			
+			if (conn->in_flight > 0) {
+				conn->in_flight--;
 			}
-			break;
+			if (m->delivered == 0 || latency_us < m->latency_min_us) {
+				m->latency_min_us = latency_us;
+			}
+			if (latency_us > m->latency_max_us) {
+				m->latency_max_us = latency_us;
+			}
+			m->latency_sum_us += latency_us;
+			m->delivered++;
+			m->bytes_delivered += (uint32_t)event->data_len;
+			m->last_delivery_us = event->deliver_at_us;
 			
-		default:
-			break;
+			if (conn->notify_rx_cb) {
+				conn->notify_rx_cb(event->handle, event->char_handle,
+				                  event->data, event->data_len);
+			}
+		}
+		break;
+		
+	case EVENT_ADV_START:
+		/* Notify scanners */
+		if (ble_state.scanning && ble_state.scan_cb) {
+			ble_device_t *dev = find_device_by_addr(event->addr);
+			if (dev && dev->advertising) {
+				ble_adv_data_t adv_data = {
+					.data = dev->adv_data,
+					.len = dev->adv_data_len
+				};
+				ble_state.scan_cb(dev->addr, &adv_data);
+			}
+		}
+		break;
+		
+	case EVENT_NOTIFY_ENABLE:
+		/* Notify peripheral that notifications were enabled */
+		{
+			ble_device_t *peripheral = find_device_by_addr(event->addr);
+			if (peripheral && peripheral->peripheral_notify_enabled_cb) {
+				peripheral->peripheral_notify_enabled_cb(event->handle, event->char_handle);
+			}
 		}
+		break;
+		
+	default:
+		break;
+	}
+}
+
+int ble_hal_process_events(void)
+{
+	if (!ble_state.initialized) {
+		return -1;
+	}
+	
+	int processed = 0;
+	ble_event_t event;
+	
+	while (dequeue_event(&event)) {
+		process_event(&event);
+		processed++;
+	}
+	
+	return processed;
+}
+
+int ble_hal_run_until(uint32_t time_us)
+{
+	if (!ble_state.initialized) {
+		return -1;
+	}
+	
+	int processed = 0;
+	ble_event_t event;
+	
+	while (ble_state.queue_count > 0 &&
+	       (int32_t)(ble_state.event_queue[ble_state.queue_head].deliver_at_us - time_us) <= 0) {
+		dequeue_event(&event);
+		process_event(&event);
+		processed++;
+	}
+	
+	if ((int32_t)(time_us - ble_state.time_us) > 0) {
+		ble_state.time_us = time_us;
 	}
 	
 	return processed;
@@ -578,6 +819,122 @@ int ble_hal_pending_events(void)
 	return ble_state.queue_count;
 }
 
+/* ============================================================================
+ * Simulated Time
+ * ============================================================================ */
+
+uint32_t ble_hal_get_time_us(void)
+{
+	return ble_state.time_us;
+}
+
+void ble_hal_advance_time_us(uint32_t delta_us)
+{
+	ble_state.time_us += delta_us;
+}
+
+int ble_hal_set_conn_interval(ble_conn_handle_t handle, uint32_t interval_us)
+{
+	ble_radio_params_t params = {.conn_interval_us = interval_us};
+	
+	return ble_hal_set_radio_params(handle, &params);
+}
+
+/* ============================================================================
+ * Radio Model Configuration and Metrics
+ * ============================================================================ */
+
+int ble_hal_set_radio_params(ble_conn_handle_t handle, const ble_radio_params_t *params)
+{
+	if (!ble_state.initialized || handle >= MAX_CONNECTIONS || !params) {
+		return -1;
+	}
+	
+	ble_connection_t *conn = &ble_state.connections[handle];
+	if (!conn->in_use) {
+		return -2;
+	}
+	
+	if ((params->phy != BLE_PHY_1M && params->phy != BLE_PHY_2M) ||
+	    params->loss_permille > 1000 || params->burst_enter_permille > 1000 ||
+	    params->burst_exit_permille > 1000) {
+		return -3;
+	}
+	
+	conn->radio = *params;
+	if (conn->radio.conn_interval_us > 0) {
+		conn->radio.anchor_offset_us %= conn->radio.conn_interval_us;
+	}
+	conn->sched_valid = false;
+	radio_seed(conn, handle);
+	return 0;
+}
+
+int ble_hal_get_radio_params(ble_conn_handle_t handle, ble_radio_params_t *params)
+{
+	if (!ble_state.initialized || handle >= MAX_CONNECTIONS || !params) {
+		return -1;
+	}
+	
+	if (!ble_state.connections[handle].in_use) {
+		return -2;
+	}
+	
+	*params = ble_state.connections[handle].radio;
+	return 0;
+}
+
+void ble_hal_set_seed(uint32_t seed)
+{
+	ble_state.seed = seed;
+}
+
+int ble_hal_get_conn_metrics(ble_conn_handle_t handle, ble_conn_metrics_t *metrics)
+{
+	if (!ble_state.initialized || handle >= MAX_CONNECTIONS || !metrics) {
+		return -1;
+	}
+	
+	if (!ble_state.connections[handle].in_use) {
+		return -2;
+	}
+	
+	*metrics = ble_state.connections[handle].metrics;
+	return 0;
+}
+
+void ble_hal_write_metrics_csv(FILE *out)
+{
+	if (!out) {
+		return;
+	}
+	
+	fprintf(out, "handle,addr,interval_us,phy,notifications,delivered,rejected,lost,"
+	             "retransmissions,data_events,bytes,max_in_flight,"
+	             "latency_min_us,latency_avg_us,latency_max_us,throughput_bps\n");
+	
+	for (int i = 0; i < MAX_CONNECTIONS; i++) {
+		const ble_connection_t *conn = &ble_state.connections[i];
+		const ble_conn_metrics_t *m = &conn->metrics;
+		
+		if (!conn->in_use) {
+			continue;
+		}
+		
+		uint32_t avg_us = m->delivered ? (uint32_t)(m->latency_sum_us / m->delivered) : 0;
+		uint32_t span_us = m->last_delivery_us - m->first_notify_us;
+		uint32_t bps = span_us ? (uint32_t)((uint64_t)m->bytes_delivered * 8 * 1000000 / span_us) : 0;
+		
+		fprintf(out, "%d,%02X:%02X:%02X:%02X:%02X:%02X,%u,%s,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u\n",
+		        i, conn->addr[0], conn->addr[1], conn->addr[2],
+		        conn->addr[3], conn->addr[4], conn->addr[5],
+		        conn->radio.conn_interval_us, conn->radio.phy == BLE_PHY_2M ? "2M" : "1M",
+		        m->notifications, m->delivered, m->rejected, m->lost,
+		        m->retransmissions, m->data_events, m->bytes_delivered, m->max_in_flight,
+		        m->latency_min_us, avg_us, m->latency_max_us, bps);
+	}
+}
+
 /* ============================================================================
  * Debug Functions
  * ============================================================================ */
@@ -609,6 +966,10 @@ void ble_hal_dump_state(void)
 			       conn->addr[0], conn->addr[1], conn->addr[2],
 			       conn->addr[3], conn->addr[4], conn->addr[5],
 			       conn->notify_enabled ? "Enabled" : "Disabled");
+			printf("      Interval=%u us, Notifications=%u, Delivered=%u, Lost=%u, Retx=%u\n",
+			       conn->radio.conn_interval_us, conn->metrics.notifications,
+			       conn->metrics.delivered, conn->metrics.lost,
+			       conn->metrics.retransmissions);
 		}
 	}
 	printf("====================\n\n");
@@ -15,6 +15,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdio.h>
 
 /* ============================================================================
  * BLE Connection Management
@@ -153,6 +154,9 @@ bool ble_hal_notify_enabled(ble_conn_handle_t handle, ble_gatt_handle_t char_han
 /**
  * @brief Send a GATT notification
  * 
+ * Scheduled by the connection's radio model (see ble_radio_params_t).
+ * Fails with -5 when no TX buffer is free.
+ * 
  * @param handle Connection handle
  * @param char_handle Characteristic handle
  * @param data Data to send
@@ -236,6 +240,163 @@ int ble_hal_init(void);
  */
 int ble_hal_cleanup(void);
 
+/* ============================================================================
+ * Simulated Time
+ * ============================================================================ */
+
+/**
+ * @brief Get current simulated time
+ * 
+ * Time starts at 0 on ble_hal_init() and only moves forward, either via
+ * ble_hal_advance_time_us() or when a notification is delivered at its
+ * connection event.
+ * 
+ * @return Simulated time in microseconds
+ */
+uint32_t ble_hal_get_time_us(void);
+
+/**
+ * @brief Advance simulated time
+ * 
+ * @param delta_us Microseconds to advance
+ */
+void ble_hal_advance_time_us(uint32_t delta_us);
+
+/**
+ * @brief Process events due up to a simulated time
+ * 
+ * Delivers every event scheduled at or before @p time_us in time order
+ * (callbacks may queue more), then moves the clock to @p time_us. Use this
+ * to step several clients at their own rates; ble_hal_process_events()
+ * instead runs until the queue is empty.
+ * 
+ * @param time_us Simulated time to run to
+ * @return Number of events processed
+ */
+int ble_hal_run_until(uint32_t time_us);
+
+/**
+ * @brief Set connection interval for a connection
+ * 
+ * Shorthand for ble_hal_set_radio_params() with only the interval set.
+ * An interval of 0 delivers immediately.
+ * 
+ * @param handle Connection handle
+ * @param interval_us Connection interval in microseconds
+ * @return 0 on success, negative errno on failure
+ */
+int ble_hal_set_conn_interval(ble_conn_handle_t handle, uint32_t interval_us);
+
+/* ============================================================================
+ * Radio Model
+ * ============================================================================ */
+
+/* PHY used for data PDUs */
+typedef enum {
+	BLE_PHY_1M,
+	BLE_PHY_2M,
+} ble_phy_t;
+
+/* Inter frame space between PDUs */
+#define BLE_T_IFS_US 150
+
+/**
+ * Per-connection radio parameters
+ * 
+ * With a non-zero interval each notification is scheduled into a
+ * connection event: the central's empty PDU, T_IFS, the notification PDU
+ * and T_IFS, so an event carries as many notifications as fit in the
+ * interval (or max_pdus_per_event). A notification arrives when its PDU
+ * ends. A lost PDU closes the event and is sent again retx_delay_events
+ * later; later notifications queue behind it, as the link layer is
+ * in order.
+ * 
+ * Loss is random (loss_permille per PDU) plus an optional two-state burst
+ * model: a good link turns bad with burst_enter_permille per PDU, a bad
+ * link loses every PDU and recovers with burst_exit_permille.
+ * 
+ * Random numbers come from a per-connection generator seeded by
+ * ble_hal_set_seed(), so runs are reproducible.
+ */
+typedef struct {
+	uint32_t conn_interval_us;      /* 0 = deliver immediately, no radio model */
+	uint32_t anchor_offset_us;      /* First anchor after time 0 (mod interval) */
+	ble_phy_t phy;
+	uint8_t max_pdus_per_event;     /* 0 = as many as fit in the interval */
+	uint8_t tx_buffers;             /* Notifications in flight, 0 = no limit */
+	uint8_t retx_delay_events;      /* Events until a lost PDU is resent, 0 = 1 */
+	uint8_t max_retx;               /* Resends before giving up, 0 = never give up */
+	uint16_t loss_permille;
+	uint16_t burst_enter_permille;
+	uint16_t burst_exit_permille;
+	uint32_t jitter_us;             /* Anchor late by 0..jitter_us per event */
+} ble_radio_params_t;
+
+/* Per-connection metrics, reset on connect */
+typedef struct {
+	uint32_t notifications;         /* Accepted by ble_hal_notify() */
+	uint32_t rejected;              /* No TX buffer or event queue full */
+	uint32_t delivered;
+	uint32_t lost;                  /* Gave up after max_retx */
+	uint32_t retransmissions;
+	uint32_t data_events;           /* Connection events carrying data */
+	uint32_t bytes_delivered;       /* Notification payload bytes */
+	uint32_t max_in_flight;
+	uint32_t latency_min_us;        /* ble_hal_notify() to delivery */
+	uint32_t latency_max_us;
+	uint64_t latency_sum_us;
+	uint32_t first_notify_us;
+	uint32_t last_delivery_us;
+} ble_conn_metrics_t;
+
+/**
+ * @brief Set radio parameters for a connection
+ * 
+ * Applies to notifications sent afterwards; ones already scheduled keep
+ * their delivery time.
+ * 
+ * @param handle Connection handle
+ * @param params Radio parameters
+ * @return 0 on success, negative errno on failure
+ */
+int ble_hal_set_radio_params(ble_conn_handle_t handle, const ble_radio_params_t *params);
+
+/**
+ * @brief Get radio parameters for a connection
+ * 
+ * @param handle Connection handle
+ * @param params Output: radio parameters
+ * @return 0 on success, negative errno on failure
+ */
+int ble_hal_get_radio_params(ble_conn_handle_t handle, ble_radio_params_t *params);
+
+/**
+ * @brief Seed the radio model's random numbers
+ * 
+ * Takes effect for connections made or configured afterwards.
+ * 
+ * @param seed Any value
+ */
+void ble_hal_set_seed(uint32_t seed);
+
+/**
+ * @brief Get metrics for a connection
+ * 
+ * @param handle Connection handle
+ * @param metrics Output: metrics
+ * @return 0 on success, negative errno on failure
+ */
+int ble_hal_get_conn_metrics(ble_conn_handle_t handle, ble_conn_metrics_t *metrics);
+
+/**
+ * @brief Write metrics for all connections as CSV
+ * 
+ * One header line, then one line per connection.
+ * 
+ * @param out Output stream
+ */
+void ble_hal_write_metrics_csv(FILE *out);
+
 /* ============================================================================
  * Test/Debug Functions
  * ============================================================================ */
@@ -0,0 +1,274 @@
+/*
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Motion Capture Replay Implementation
+ */
+
+#define _POSIX_C_SOURCE 199309L  /* clock_gettime(), nanosleep() */
+
+#include "capture_replay.h"
+#include "ble_hal.h"
+#include "client_emulator.h"
+#include "basestation_emulator.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Output state for one replay */
+typedef struct {
+	uint32_t t0_us;             /* Simulated time of the first record */
+	const replay_options_t *opt;
+	replay_stats_t *stats;
+} replay_ctx_t;
+
+static double wall_now_s(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/* Sleep until offset_us after the replay started (realtime mode) */
+static void pace_until(double wall_start, uint32_t offset_us)
+{
+	double remaining = wall_start + (double)offset_us / 1e6 - wall_now_s();
+
+	if (remaining > 0) {
+		struct timespec ts = {
+			.tv_sec = (time_t)remaining,
+			.tv_nsec = (long)((remaining - (double)(time_t)remaining) * 1e9),
+		};
+		nanosleep(&ts, NULL);
+	}
+}
+
+/* ============================================================================
+ * Capture Files
+ * ============================================================================ */
+
+int capture_file_parse(const uint8_t *data, size_t len, capture_file_t *cap)
+{
+	if (!data || !cap || len < sizeof(struct capture_header)) {
+		return -1;
+	}
+
+	memset(cap, 0, sizeof(*cap));
+	memcpy(&cap->header, data, sizeof(cap->header));
+
+	if (capture_check_header(&cap->header, len - sizeof(cap->header)) != 0) {
+		return -1;
+	}
+
+	cap->count = cap->header.record_count;
+	if (cap->count > 0) {
+		cap->records = malloc(cap->count * sizeof(struct capture_record));
+		if (!cap->records) {
+			cap->count = 0;
+			return -2;
+		}
+		memcpy(cap->records, data + sizeof(cap->header),
+		       cap->count * sizeof(struct capture_record));
+	}
+
+	for (size_t i = 0; i < cap->count; i++) {
+		if (cap->records[i].guitar + 1 > cap->num_guitars) {
+			cap->num_guitars = cap->records[i].guitar + 1;
+		}
+	}
+
+	return 0;
+}
+
+int capture_file_load(const char *path, capture_file_t *cap)
+{
+	FILE *f = fopen(path, "rb");
+	if (!f) {
+		return -1;
+	}
+
+	fseek(f, 0, SEEK_END);
+	long len = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	if (len < 0) {
+		fclose(f);
+		return -1;
+	}
+
+	uint8_t *buf = malloc(len > 0 ? (size_t)len : 1);
+	if (!buf) {
+		fclose(f);
+		return -2;
+	}
+
+	size_t got = fread(buf, 1, (size_t)len, f);
+	fclose(f);
+
+	int err = capture_file_parse(buf, got, cap);
+	free(buf);
+
+	return err;
+}
+
+void capture_file_free(capture_file_t *cap)
+{
+	if (!cap) {
+		return;
+	}
+
+	free(cap->records);
+	memset(cap, 0, sizeof(*cap));
+}
+
+/* ============================================================================
+ * MIDI Output
+ * ============================================================================ */
+
+/* Called by the emulator for every message its TX queue model accepts */
+static void replay_midi_cb(int guitar_index, const uint8_t *msg, size_t len,
+                           uint32_t queued_us, uint32_t tx_done_us, void *user_data)
+{
+	replay_ctx_t *ctx = user_data;
+	const replay_options_t *opt = ctx->opt;
+	uint32_t queued_rel = queued_us - ctx->t0_us;
+	uint32_t done_rel = tx_done_us - ctx->t0_us;
+
+	ctx->stats->midi_messages++;
+	ctx->stats->midi_bytes += (uint32_t)len;
+
+	if (opt->midi_out) {
+		fwrite(msg, 1, len, opt->midi_out);
+	}
+	if (opt->timing_out) {
+		fprintf(opt->timing_out, "%u,%u,%d,0x%02X,%u,%u\n", queued_rel, done_rel, guitar_index,
+		        msg[0], len > 1 ? msg[1] : 0, len > 2 ? msg[2] : 0);
+	}
+	if (opt->midi_cb) {
+		opt->midi_cb(queued_rel, done_rel, guitar_index, msg, len, opt->user_data);
+	}
+}
+
+/* ============================================================================
+ * Replay
+ * ============================================================================ */
+
+int replay_run(const capture_file_t *cap, const replay_options_t *opt, replay_stats_t *stats)
+{
+	static const replay_options_t default_opt = {0};
+	static replay_ctx_t ctx;
+	static basestation_emulator_t base;
+	static client_emulator_t clients[MAX_GUITARS];
+	replay_stats_t local_stats;
+	int err = 0;
+
+	if (!cap) {
+		return -1;
+	}
+	if (!opt) {
+		opt = &default_opt;
+	}
+	if (!stats) {
+		stats = &local_stats;
+	}
+	memset(stats, 0, sizeof(*stats));
+
+	int num_guitars = cap->num_guitars;
+	if (num_guitars > MAX_GUITARS) {
+		num_guitars = MAX_GUITARS;
+	}
+
+	memset(&ctx, 0, sizeof(ctx));
+	ctx.opt = opt;
+	ctx.stats = stats;
+
+	/* One emulated guitar per captured guitar id, factory default patch */
+	ble_hal_init();
+	if (basestation_emulator_init(&base) != 0) {
+		return -1;
+	}
+	base.quiet = true;
+	midi_pipeline_set_gestures(&base.pipeline, opt->gestures);
+
+	for (int g = 0; g < num_guitars; g++) {
+		uint8_t addr[6] = {0xC0, 0x47, 0x41, 0x43, 0x50, (uint8_t)(g + 1)};
+
+		if (client_emulator_init(&clients[g], addr) != 0 ||
+		    client_emulator_start_advertising(&clients[g]) != 0 ||
+		    basestation_emulator_connect(&base, addr) != 0) {
+			err = -2;
+			goto cleanup;
+		}
+		ble_hal_process_events();
+		if (basestation_emulator_enable_notifications(&base, g) != 0) {
+			err = -2;
+			goto cleanup;
+		}
+		ble_hal_process_events();
+	}
+
+	basestation_emulator_set_midi_cb(&base, replay_midi_cb, &ctx);
+
+	if (opt->timing_out) {
+		fprintf(opt->timing_out, "queued_us,tx_done_us,guitar,status,data1,data2\n");
+	}
+
+	ctx.t0_us = ble_hal_get_time_us();
+	uint32_t ts0 = cap->count > 0 ? cap->records[0].timestamp_us : 0;
+	double wall_start = wall_now_s();
+
+	for (size_t i = 0; i < cap->count; i++) {
+		const struct capture_record *rec = &cap->records[i];
+
+		if (rec->guitar >= num_guitars) {
+			stats->samples_skipped++;
+			continue;
+		}
+
+		/* Unsigned offsets stay correct across a timestamp wrap */
+		uint32_t offset_us = rec->timestamp_us - ts0;
+		int32_t ahead = (int32_t)(ctx.t0_us + offset_us - ble_hal_get_time_us());
+		if (ahead > 0) {
+			ble_hal_advance_time_us((uint32_t)ahead);
+		}
+		if (opt->realtime) {
+			pace_until(wall_start, offset_us);
+		}
+
+		if (rec->flags & CAPTURE_F_EVENT) {
+			client_emulator_send_event(&clients[rec->guitar], (uint8_t)rec->x,
+			                           (uint8_t)rec->y, rec->z);
+		} else if (rec->flags & CAPTURE_F_GYRO) {
+			struct accel_data accel = {rec->x, rec->y, rec->z};
+			struct gyro_data gyro = {rec->gx, rec->gy, rec->gz};
+			client_emulator_send_imu(&clients[rec->guitar], &accel, &gyro);
+		} else {
+			struct accel_data accel = {rec->x, rec->y, rec->z};
+			client_emulator_send_accel(&clients[rec->guitar], &accel);
+		}
+		ble_hal_process_events();
+
+		stats->duration_us = offset_us;
+	}
+
+	/* End of capture: let the UART drain, then no gesture note left hanging */
+	ble_hal_advance_time_us(MIDI_TX_QUEUE_SIZE * MIDI_BYTE_TIME_US);
+	for (int g = 0; g < base.num_guitars; g++) {
+		midi_pipeline_release_gestures(&base.pipeline, g, &base.guitars[g].gestures);
+	}
+
+	stats->wall_s = wall_now_s() - wall_start;
+	stats->samples = base.pipeline.samples;
+	stats->midi_dropped = base.midi_messages_dropped;
+	stats->max_backlog_us = base.uart.max_backlog_us;
+
+cleanup:
+	basestation_emulator_set_midi_cb(&base, NULL, NULL);
+	for (int g = 0; g < num_guitars; g++) {
+		client_emulator_cleanup(&clients[g]);
+	}
+	basestation_emulator_cleanup(&base);
+	ble_hal_process_events();
+	ble_hal_cleanup();
+
+	return err;
+}
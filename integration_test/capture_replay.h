@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Motion Capture Replay
+ * Feeds a basestation capture (motion_capture.h format) through the
+ * emulated BLE link and the real topology processor
+ */
+
+#ifndef CAPTURE_REPLAY_H
+#define CAPTURE_REPLAY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include "motion_capture.h"
+#include "gesture_engine.h"
+
+/* Loaded capture */
+typedef struct {
+	struct capture_header header;
+	struct capture_record *records;
+	size_t count;
+	int num_guitars;  /* Highest guitar id + 1 */
+} capture_file_t;
+
+/**
+ * @brief Called for each MIDI message the pipeline queues
+ *
+ * Times are relative to the first captured sample.
+ *
+ * @param queued_us When the message was queued
+ * @param tx_done_us When its last byte leaves the 31250-baud UART
+ * @param guitar Guitar whose sample produced the message
+ * @param msg Message bytes
+ * @param len Message length
+ * @param user_data Pointer from replay_options_t
+ */
+typedef void (*replay_midi_cb_t)(uint32_t queued_us, uint32_t tx_done_us, int guitar,
+                                 const uint8_t *msg, size_t len, void *user_data);
+
+/* Replay options */
+typedef struct {
+	bool realtime;             /* Pace samples at capture speed (1x) */
+	FILE *midi_out;            /* Raw MIDI byte stream, or NULL */
+	FILE *timing_out;          /* CSV, one line per MIDI message, or NULL */
+	replay_midi_cb_t midi_cb;  /* Optional per-message callback */
+	void *user_data;
+	const struct gesture_config *gestures;  /* Gesture slots to run, or NULL for none */
+} replay_options_t;
+
+/* Replay results */
+typedef struct {
+	uint32_t samples;          /* Samples delivered to the basestation */
+	uint32_t samples_skipped;  /* Records with an out-of-range guitar id */
+	uint32_t midi_messages;
+	uint32_t midi_bytes;
+	uint32_t midi_dropped;     /* Messages rejected by the TX queue model */
+	uint32_t duration_us;      /* Capture span */
+	uint32_t max_backlog_us;   /* Worst UART backlog when queueing */
+	double wall_s;             /* Host time spent replaying */
+} replay_stats_t;
+
+/**
+ * @brief Parse a capture from memory
+ *
+ * Records are copied; the buffer may be freed afterwards.
+ *
+ * @param data File contents
+ * @param len File length
+ * @param cap Output
+ * @return 0 on success, -1 on invalid or truncated capture, -2 on allocation failure
+ */
+int capture_file_parse(const uint8_t *data, size_t len, capture_file_t *cap);
+
+/**
+ * @brief Load a capture file
+ *
+ * @param path File written by capture_tool.py
+ * @param cap Output
+ * @return 0 on success, negative on failure
+ */
+int capture_file_load(const char *path, capture_file_t *cap);
+
+/**
+ * @brief Free a loaded capture
+ */
+void capture_file_free(capture_file_t *cap);
+
+/**
+ * @brief Replay a capture through the emulated basestation
+ *
+ * Sets up one client emulator per guitar, connects them to a basestation
+ * emulator over ble_hal, then sends every record at its captured time.
+ * Each received sample goes through the firmware's midi_pipeline.c
+ * (factory default patch): topology, deadzone, construct_midi_cc_msg()
+ * and the MIDI TX queue limits. With opt->gestures, gesture messages are
+ * sent ahead of each sample's CCs and every note still sounding at the end
+ * gets its Note Off. Simulated time always follows the capture; realtime
+ * only adds host-side pacing.
+ *
+ * Initializes (and cleans up) ble_hal itself.
+ *
+ * @param cap Capture to replay
+ * @param opt Options (NULL = as fast as possible, no output)
+ * @param stats Results (may be NULL)
+ * @return 0 on success, negative on failure
+ */
+int replay_run(const capture_file_t *cap, const replay_options_t *opt, replay_stats_t *stats);
+
+#endif /* CAPTURE_REPLAY_H */
@@ -31,8 +31,73 @@ static void client_connected_cb(ble_conn_handle_t handle, const uint8_t *addr);
 static void client_disconnected_cb(ble_conn_handle_t handle, uint8_t reason);
 static void client_notify_enabled_cb(ble_conn_handle_t handle, ble_gatt_handle_t char_handle);
 
-/* Global reference for callbacks */
-static client_emulator_t *g_client = NULL;
+/* Live clients, looked up by address or handle from BLE callbacks.
+ * The address is copied so a client re-initialized at the same address
+ * (tests reuse stack instances) replaces the old entry.
+ */
+#define MAX_CLIENTS 4
+static struct {
+	client_emulator_t *client;
+	uint8_t addr[6];
+} g_clients[MAX_CLIENTS];
+
+static client_emulator_t *find_client_by_addr(const uint8_t *addr)
+{
+	for (int i = 0; i < MAX_CLIENTS; i++) {
+		if (g_clients[i].client && memcmp(g_clients[i].addr, addr, 6) == 0) {
+			return g_clients[i].client;
+		}
+	}
+	return NULL;
+}
+
+static client_emulator_t *find_client_by_handle(ble_conn_handle_t handle)
+{
+	for (int i = 0; i < MAX_CLIENTS; i++) {
+		client_emulator_t *client = g_clients[i].client;
+		if (client && client->connected && client->conn_handle == handle) {
+			return client;
+		}
+	}
+	return NULL;
+}
+
+static void unregister_client(const client_emulator_t *client, const uint8_t *addr)
+{
+	for (int i = 0; i < MAX_CLIENTS; i++) {
+		if (g_clients[i].client == client || memcmp(g_clients[i].addr, addr, 6) == 0) {
+			g_clients[i].client = NULL;
+			memset(g_clients[i].addr, 0, 6);
+		}
+	}
+}
+
+static void register_client(client_emulator_t *client)
+{
+	unregister_client(client, client->addr);
+	for (int i = 0; i < MAX_CLIENTS; i++) {
+		if (!g_clients[i].client) {
+			g_clients[i].client = client;
+			memcpy(g_clients[i].addr, client->addr, 6);
+			return;
+		}
+	}
+	/* Full: leaked entries from aborted tests, reuse the first slot */
+	g_clients[0].client = client;
+	memcpy(g_clients[0].addr, client->addr, 6);
+}
+
+/* Send accel data stamped with the client's own clock */
+static int client_notify_sample(client_emulator_t *client, const struct accel_data *accel)
+{
+	struct accel_sample sample = {
+		.accel = *accel,
+		.timestamp_us = ble_hal_get_time_us() + client->clock_offset_us,
+	};
+	
+	return ble_hal_notify(client->conn_handle, ACCEL_CHAR_HANDLE,
+	                      &sample, sizeof(sample));
+}
 
 /* ============================================================================
  * Initialization
@@ -58,7 +123,7 @@ int client_emulator_init(client_emulator_t *client, const uint8_t *addr)
 	}
 	
 	client->initialized = true;
-	g_client = client;
+	register_client(client);
 	
 	return 0;
 }
@@ -77,7 +142,7 @@ void client_emulator_cleanup(client_emulator_t *client)
 		ble_hal_disconnect(client->conn_handle);
 	}
 	
-	g_client = NULL;
+	unregister_client(client, client->addr);
 	memset(client, 0, sizeof(client_emulator_t));
 }
 
@@ -148,13 +213,14 @@ int client_emulator_stop_advertising(client_emulator_t *client)
 
 static void client_connected_cb(ble_conn_handle_t handle, const uint8_t *addr)
 {
-	if (!g_client) {
+	client_emulator_t *client = find_client_by_addr(addr);
+	if (!client) {
 		return;
 	}
 	
-	g_client->connected = true;
-	g_client->conn_handle = handle;
-	g_client->advertising = false;  /* Stop advertising when connected */
+	client->connected = true;
+	client->conn_handle = handle;
+	client->advertising = false;  /* Stop advertising when connected */
 	
 	printf("[CLIENT] Connected (handle %d) to basestation %02X:%02X:%02X:%02X:%02X:%02X\n",
 	       handle, addr[0], addr[1], addr[2], addr[3], addr[4], addr[5]);
@@ -162,26 +228,28 @@ static void client_connected_cb(ble_conn_handle_t handle, const uint8_t *addr)
 
 static void client_disconnected_cb(ble_conn_handle_t handle, uint8_t reason)
 {
-	if (!g_client) {
+	client_emulator_t *client = find_client_by_handle(handle);
+	if (!client) {
 		return;
 	}
 	
 	printf("[CLIENT] Disconnected (handle %d, reason 0x%02X)\n", handle, reason);
 	
-	g_client->connected = false;
-	g_client->conn_handle = BLE_CONN_HANDLE_INVALID;
-	g_client->notify_enabled = false;
+	client->connected = false;
+	client->conn_handle = BLE_CONN_HANDLE_INVALID;
+	client->notify_enabled = false;
 }
 
 static void client_notify_enabled_cb(ble_conn_handle_t handle, ble_gatt_handle_t char_handle)
 {
-	if (!g_client) {
+	client_emulator_t *client = find_client_by_handle(handle);
+	if (!client) {
 		return;
 	}
 	
 	(void)char_handle;  /* Unused - we only have one characteristic */
 	
-	g_client->notify_enabled = true;
+	client->notify_enabled = true;
 	
 	printf("[CLIENT] Notifications enabled (handle %d)\n", handle);
 }
@@ -222,8 +290,7 @@ int client_emulator_update_accel(client_emulator_t *client,
 	}
 	
 	/* Send notification */
-	int err = ble_hal_notify(client->conn_handle, ACCEL_CHAR_HANDLE,
-	                         &client->current_accel, sizeof(client->current_accel));
+	int err = client_notify_sample(client, &client->current_accel);
 	
 	if (err == 0) {
 		client->previous_accel = client->current_accel;
@@ -258,8 +325,37 @@ int client_emulator_send_accel(client_emulator_t *client,
 	}
 	
 	/* Send notification with acceleration data */
+	int err = client_notify_sample(client, accel);
+	
+	if (err == 0) {
+		client->current_accel = *accel;
+		client->notifications_sent++;
+	}
+	
+	return err;
+}
+
+int client_emulator_send_imu(client_emulator_t *client,
+                             const struct accel_data *accel,
+                             const struct gyro_data *gyro)
+{
+	if (!client || !client->initialized || !accel || !gyro) {
+		return -1;
+	}
+	
+	if (!client->connected || !client->notify_enabled) {
+		client->notifications_skipped++;
+		return -2;
+	}
+	
+	struct imu_sample sample = {
+		.accel = *accel,
+		.gyro = *gyro,
+		.timestamp_us = ble_hal_get_time_us() + client->clock_offset_us,
+	};
+	
 	int err = ble_hal_notify(client->conn_handle, ACCEL_CHAR_HANDLE,
-	                         accel, sizeof(*accel));
+	                         &sample, sizeof(sample));
 	
 	if (err == 0) {
 		client->current_accel = *accel;
@@ -269,6 +365,74 @@ int client_emulator_send_accel(client_emulator_t *client,
 	return err;
 }
 
+int client_emulator_send_event(client_emulator_t *client, uint8_t type,
+                               uint8_t flags, int16_t value)
+{
+	if (!client || !client->initialized) {
+		return -1;
+	}
+	
+	if (!client->connected || !client->notify_enabled) {
+		client->notifications_skipped++;
+		return -2;
+	}
+	
+	struct motion_event ev = {
+		.type = type,
+		.flags = flags,
+		.value = value,
+		.timestamp_us = ble_hal_get_time_us() + client->clock_offset_us,
+	};
+	
+	int err = ble_hal_notify(client->conn_handle, ACCEL_CHAR_HANDLE, &ev, sizeof(ev));
+	
+	if (err == 0) {
+		client->events_sent++;
+	}
+	
+	return err;
+}
+
+int client_emulator_enable_edge(client_emulator_t *client, const struct edge_config *cfg)
+{
+	if (!client || !client->initialized) {
+		return -1;
+	}
+	
+	edge_detector_init(&client->edge, cfg);
+	client->edge_enabled = true;
+	return 0;
+}
+
+int client_emulator_edge_sample(client_emulator_t *client, const struct accel_data *accel)
+{
+	struct motion_event events[EDGE_MAX_EVENTS];
+	int sent = 0;
+	
+	if (!client || !client->initialized || !client->edge_enabled || !accel) {
+		return -1;
+	}
+	
+	/* Detection runs whether or not anyone is listening, as on the guitar */
+	const int16_t xyz[3] = {accel->x, accel->y, accel->z};
+	int count = edge_detector_update(&client->edge, xyz,
+	                                 ble_hal_get_time_us() + client->clock_offset_us, events);
+	
+	if (!client->connected || !client->notify_enabled) {
+		return 0;
+	}
+	
+	for (int i = 0; i < count; i++) {
+		if (ble_hal_notify(client->conn_handle, ACCEL_CHAR_HANDLE,
+		                   &events[i], sizeof(events[i])) == 0) {
+			client->events_sent++;
+			sent++;
+		}
+	}
+	
+	return sent;
+}
+
 void client_emulator_get_accel(const client_emulator_t *client, 
                                struct accel_data *data)
 {
@@ -13,6 +13,7 @@
 #include <stdbool.h>
 #include "ble_hal.h"
 #include "common_defs.h"
+#include "edge_events.h"
 
 /* Client state */
 typedef struct {
@@ -29,9 +30,17 @@ typedef struct {
 	/* Connection state */
 	bool notify_enabled;
 	
+	/* Client uptime minus simulated time (models an unsynchronized clock) */
+	uint32_t clock_offset_us;
+	
+	/* Edge event mode (uses actual edge_events.c) */
+	bool edge_enabled;
+	struct edge_detector edge;
+	
 	/* Statistics */
 	uint32_t notifications_sent;
 	uint32_t notifications_skipped;  /* Due to no change */
+	uint32_t events_sent;            /* Edge events */
 } client_emulator_t;
 
 /**
@@ -86,6 +95,59 @@ int client_emulator_update_accel(client_emulator_t *client,
 int client_emulator_send_accel(client_emulator_t *client, 
                                 const struct accel_data *accel);
 
+/**
+ * @brief Send acceleration and angular rate
+ * 
+ * Sends an imu_sample as a client with a gyroscope would; the basestation
+ * fuses it into the roll/pitch/yaw sources.
+ * 
+ * @param client Client emulator instance
+ * @param accel Acceleration data in milli-g
+ * @param gyro Angular rate in decidegrees/s
+ * @return 0 on success, negative errno on failure
+ */
+int client_emulator_send_imu(client_emulator_t *client,
+                             const struct accel_data *accel,
+                             const struct gyro_data *gyro);
+
+/**
+ * @brief Send one edge event as a client in edge event mode would
+ * 
+ * Bypasses the detector; used to replay events recorded on the basestation.
+ * 
+ * @param client Client emulator instance
+ * @param type enum motion_event_type
+ * @param flags MOTION_EVENT_F_* flags
+ * @param value Event strength
+ * @return 0 on success, negative errno on failure
+ */
+int client_emulator_send_event(client_emulator_t *client, uint8_t type,
+                               uint8_t flags, int16_t value);
+
+/**
+ * @brief Turn on edge event mode
+ * 
+ * Events are sent from client_emulator_edge_sample(); the continuous
+ * stream calls keep working alongside, as on the guitar.
+ * 
+ * @param client Client emulator instance
+ * @param cfg Detector thresholds (NULL for defaults)
+ * @return 0 on success, negative errno on failure
+ */
+int client_emulator_enable_edge(client_emulator_t *client, const struct edge_config *cfg);
+
+/**
+ * @brief Run the edge detector on one raw sample
+ * 
+ * Sends a motion_event notification for every gesture start or end the
+ * sample produces, as the firmware does at CONFIG_GUITARACC_EDGE_SAMPLE_HZ.
+ * 
+ * @param client Client emulator instance
+ * @param accel Raw acceleration in milli-g
+ * @return Number of events sent, negative errno on failure
+ */
+int client_emulator_edge_sample(client_emulator_t *client, const struct accel_data *accel);
+
 /**
  * @brief Check if connected to basestation
  * 
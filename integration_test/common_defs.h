@@ -18,4 +18,24 @@ struct accel_data {
 	int16_t z;  /* Z-axis in milli-g */
 } __attribute__((packed));
 
+/* Timestamped sample: accel_data plus client sample time in microseconds */
+struct accel_sample {
+	struct accel_data accel;
+	uint32_t timestamp_us;
+} __attribute__((packed));
+
+/* Angular rate in decidegrees per second */
+struct gyro_data {
+	int16_t x;  /* Roll rate */
+	int16_t y;  /* Pitch rate */
+	int16_t z;  /* Yaw rate */
+} __attribute__((packed));
+
+/* Timestamped accel + gyro sample from clients with a gyroscope */
+struct imu_sample {
+	struct accel_data accel;
+	struct gyro_data gyro;
+	uint32_t timestamp_us;
+} __attribute__((packed));
+
 #endif /* COMMON_DEFS_H */
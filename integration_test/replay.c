@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Capture Replay Driver
+ *
+ * Replays a basestation motion capture through the emulated BLE link and
+ * the real topology processor, writing the exact MIDI byte stream and a
+ * per-message timing CSV.
+ *
+ *   ./replay show.gcap --midi show.midi.bin --timing show_timing.csv
+ *   ./replay show.gcap --smf show.mid
+ *   ./replay show.gcap --realtime
+ *   ./replay show.gcap --gesture 1:8:0:60:400 --smf strums.mid
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "capture_replay.h"
+#include "smf_writer.h"
+
+/* SMF events are placed at the time the last byte leaves the UART */
+static void write_smf_event(uint32_t queued_us, uint32_t tx_done_us, int guitar,
+                            const uint8_t *msg, size_t len, void *user_data)
+{
+	(void)queued_us;
+	smf_writer_event(user_data, guitar, tx_done_us, msg, len);
+}
+
+static void usage(const char *prog)
+{
+	fprintf(stderr,
+	        "Usage: %s <capture.gcap> [options]\n"
+	        "  --realtime        Pace samples at capture speed (default: as fast as possible)\n"
+	        "  --midi <file>     Write raw MIDI bytes as sent on the UART\n"
+	        "  --timing <file>   Write per-message CSV (queued_us, tx_done_us, guitar, bytes)\n"
+	        "  --smf <file>      Write Type-1 Standard MIDI File, one track per guitar\n"
+	        "  --gesture <type:source:action:number:threshold[:curve]>\n"
+	        "                    Add a gesture slot (up to %d), as for 'gesture set'\n",
+	        prog, GESTURE_SLOTS);
+}
+
+/* type:source:action:number:threshold[:curve], threshold in source units */
+static int parse_gesture(const char *arg, struct gesture_slot *slot)
+{
+	int type, source, action, number, threshold;
+	int curve = GESTURE_VELOCITY_LINEAR;
+	int n = sscanf(arg, "%d:%d:%d:%d:%d:%d", &type, &source, &action, &number,
+	               &threshold, &curve);
+
+	if (n < 5 || threshold < GESTURE_THRESHOLD_UNIT ||
+	    threshold > 255 * GESTURE_THRESHOLD_UNIT || curve < 0 || curve > 127) {
+		return -1;
+	}
+
+	slot->type = (uint8_t)type;
+	slot->source = (uint8_t)source;
+	slot->action = (uint8_t)action;
+	slot->number = (uint8_t)number;
+	slot->threshold = (uint8_t)(threshold / GESTURE_THRESHOLD_UNIT);
+	slot->velocity_curve = (uint8_t)curve;
+
+	struct gesture_config check = {.slots = {*slot}};
+	return (slot->type != GESTURE_NONE && gesture_config_validate(&check)) ? 0 : -1;
+}
+
+int main(int argc, char **argv)
+{
+	const char *capture_path = NULL;
+	const char *midi_path = NULL;
+	const char *timing_path = NULL;
+	const char *smf_path = NULL;
+	replay_options_t opt = {0};
+	static smf_writer_t smf;
+	struct gesture_config gestures = {0};
+	int num_gestures = 0;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--realtime") == 0) {
+			opt.realtime = true;
+		} else if (strcmp(argv[i], "--midi") == 0 && i + 1 < argc) {
+			midi_path = argv[++i];
+		} else if (strcmp(argv[i], "--timing") == 0 && i + 1 < argc) {
+			timing_path = argv[++i];
+		} else if (strcmp(argv[i], "--smf") == 0 && i + 1 < argc) {
+			smf_path = argv[++i];
+		} else if (strcmp(argv[i], "--gesture") == 0 && i + 1 < argc) {
+			if (num_gestures >= GESTURE_SLOTS ||
+			    parse_gesture(argv[++i], &gestures.slots[num_gestures]) != 0) {
+				fprintf(stderr, "Invalid or too many gestures: %s\n", argv[i]);
+				return 1;
+			}
+			opt.gestures = &gestures;
+			num_gestures++;
+		} else if (argv[i][0] != '-' && !capture_path) {
+			capture_path = argv[i];
+		} else {
+			usage(argv[0]);
+			return 1;
+		}
+	}
+
+	if (!capture_path) {
+		usage(argv[0]);
+		return 1;
+	}
+
+	capture_file_t cap;
+	int err = capture_file_load(capture_path, &cap);
+	if (err) {
+		fprintf(stderr, "Cannot load capture %s (err %d)\n", capture_path, err);
+		return 1;
+	}
+
+	if (midi_path && !(opt.midi_out = fopen(midi_path, "wb"))) {
+		fprintf(stderr, "Cannot write %s\n", midi_path);
+		capture_file_free(&cap);
+		return 1;
+	}
+	if (timing_path && !(opt.timing_out = fopen(timing_path, "w"))) {
+		fprintf(stderr, "Cannot write %s\n", timing_path);
+		if (opt.midi_out) {
+			fclose(opt.midi_out);
+		}
+		capture_file_free(&cap);
+		return 1;
+	}
+
+	if (smf_path) {
+		int tracks = cap.num_guitars;
+		if (tracks < 1) {
+			tracks = 1;
+		} else if (tracks > SMF_MAX_TRACKS) {
+			tracks = SMF_MAX_TRACKS;
+		}
+		if (smf_writer_open(&smf, smf_path, tracks) != 0) {
+			fprintf(stderr, "Cannot write %s\n", smf_path);
+			smf_path = NULL;
+			err = -1;
+		} else {
+			opt.midi_cb = write_smf_event;
+			opt.user_data = &smf;
+		}
+	}
+
+	replay_stats_t stats;
+	if (!err) {
+		err = replay_run(&cap, &opt, &stats);
+	}
+
+	if (opt.midi_out) {
+		fclose(opt.midi_out);
+	}
+	if (opt.timing_out) {
+		fclose(opt.timing_out);
+	}
+	if (smf_path && smf_writer_close(&smf) != 0) {
+		fprintf(stderr, "Failed writing %s\n", smf_path);
+		err = err ? err : -1;
+	}
+
+	if (err) {
+		fprintf(stderr, "Replay failed (err %d)\n", err);
+		capture_file_free(&cap);
+		return 1;
+	}
+
+	printf("\n=== Replay: %s ===\n", capture_path);
+	printf("Records:        %zu (%d guitar%s%s)\n", cap.count, cap.num_guitars,
+	       cap.num_guitars == 1 ? "" : "s",
+	       (cap.header.flags & CAPTURE_H_WRAPPED) ? ", ring wrapped" : "");
+	printf("Samples:        %u delivered, %u skipped\n", stats.samples, stats.samples_skipped);
+	printf("Capture span:   %.3f s\n", stats.duration_us / 1e6);
+	printf("MIDI messages:  %u (%u bytes), %u dropped by TX queue\n",
+	       stats.midi_messages, stats.midi_bytes, stats.midi_dropped);
+	printf("UART backlog:   %u us max\n", stats.max_backlog_us);
+	printf("Host time:      %.3f s (%.0fx capture speed)\n", stats.wall_s,
+	       stats.wall_s > 0 ? (stats.duration_us / 1e6) / stats.wall_s : 0.0);
+	if (smf_path) {
+		printf("SMF:            %s (%d track%s + tempo, %u us/tick)\n", smf_path,
+		       cap.num_guitars > 1 ? cap.num_guitars : 1, cap.num_guitars > 1 ? "s" : "",
+		       (unsigned int)SMF_TICK_US);
+	}
+
+	capture_file_free(&cap);
+	return 0;
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Concurrent Sample Queue Implementation
+ */
+
+#include "sample_queue.h"
+#include <errno.h>
+#include <string.h>
+
+int sample_queue_init(sample_queue_t *q, int depth)
+{
+	if (!q || depth < 1 || depth > SAMPLE_QUEUE_MAX_DEPTH) {
+		return -EINVAL;
+	}
+
+	memset(q, 0, sizeof(*q));
+	q->depth = depth;
+	pthread_mutex_init(&q->lock, NULL);
+	pthread_cond_init(&q->not_empty, NULL);
+	return 0;
+}
+
+void sample_queue_destroy(sample_queue_t *q)
+{
+	if (q) {
+		pthread_cond_destroy(&q->not_empty);
+		pthread_mutex_destroy(&q->lock);
+	}
+}
+
+int sample_queue_push(sample_queue_t *q, const queued_sample_t *item)
+{
+	int err = 0;
+
+	pthread_mutex_lock(&q->lock);
+	if (q->closed) {
+		err = -EPIPE;
+	} else if (q->count >= q->depth) {
+		q->dropped++;
+		err = -ENOBUFS;
+	} else {
+		q->items[(q->head + q->count) % q->depth] = *item;
+		q->count++;
+		q->pushed++;
+		if (q->count > q->high_water) {
+			q->high_water = q->count;
+		}
+		pthread_cond_signal(&q->not_empty);
+	}
+	pthread_mutex_unlock(&q->lock);
+
+	return err;
+}
+
+int sample_queue_pop(sample_queue_t *q, queued_sample_t *item)
+{
+	int err = 0;
+
+	pthread_mutex_lock(&q->lock);
+	while (q->count == 0 && !q->closed) {
+		pthread_cond_wait(&q->not_empty, &q->lock);
+	}
+	if (q->count == 0) {
+		err = -EPIPE;
+	} else {
+		*item = q->items[q->head];
+		q->head = (q->head + 1) % q->depth;
+		q->count--;
+	}
+	pthread_mutex_unlock(&q->lock);
+
+	return err;
+}
+
+void sample_queue_close(sample_queue_t *q)
+{
+	pthread_mutex_lock(&q->lock);
+	q->closed = true;
+	pthread_cond_broadcast(&q->not_empty);
+	pthread_mutex_unlock(&q->lock);
+}
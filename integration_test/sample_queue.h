@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Concurrent Sample Queue for the Stress Harness
+ *
+ * Bounded multi-producer / single-consumer queue between client threads
+ * and the basestation thread. It stands in for the BLE host RX buffers
+ * that carry notifications to the thread running notify_func() and
+ * process_accel_data() on target: a full queue drops the sample.
+ */
+
+#ifndef SAMPLE_QUEUE_H
+#define SAMPLE_QUEUE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "common_defs.h"
+
+#define SAMPLE_QUEUE_MAX_DEPTH 256
+
+/* Queued notification */
+typedef struct {
+	int guitar;
+	struct accel_sample sample;   /* As sent over BLE */
+} queued_sample_t;
+
+typedef struct {
+	pthread_mutex_t lock;
+	pthread_cond_t not_empty;
+	queued_sample_t items[SAMPLE_QUEUE_MAX_DEPTH];
+	int depth;
+	int head;
+	int count;
+	bool closed;
+
+	/* Statistics */
+	int high_water;
+	uint32_t pushed;
+	uint32_t dropped;
+} sample_queue_t;
+
+/**
+ * @brief Initialize queue
+ *
+ * @param q Queue
+ * @param depth Capacity (1 to SAMPLE_QUEUE_MAX_DEPTH)
+ * @return 0 on success, negative errno on failure
+ */
+int sample_queue_init(sample_queue_t *q, int depth);
+
+/**
+ * @brief Destroy queue
+ *
+ * @param q Queue
+ */
+void sample_queue_destroy(sample_queue_t *q);
+
+/**
+ * @brief Add a sample without blocking
+ *
+ * @param q Queue
+ * @param item Sample
+ * @return 0 on success, -ENOBUFS if full (sample dropped), -EPIPE if closed
+ */
+int sample_queue_push(sample_queue_t *q, const queued_sample_t *item);
+
+/**
+ * @brief Remove the oldest sample, waiting until one arrives
+ *
+ * @param q Queue
+ * @param item Output: sample
+ * @return 0 on success, -EPIPE once closed and empty
+ */
+int sample_queue_pop(sample_queue_t *q, queued_sample_t *item);
+
+/**
+ * @brief Close queue: pushes fail, pop drains what is left
+ *
+ * @param q Queue
+ */
+void sample_queue_close(sample_queue_t *q);
+
+#endif /* SAMPLE_QUEUE_H */
@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Standard MIDI File Writer Implementation
+ */
+
+#include "smf_writer.h"
+#include <string.h>
+
+/* ============================================================================
+ * Helpers
+ * ============================================================================ */
+
+static void put_be32(uint8_t *p, uint32_t v)
+{
+	p[0] = (uint8_t)(v >> 24);
+	p[1] = (uint8_t)(v >> 16);
+	p[2] = (uint8_t)(v >> 8);
+	p[3] = (uint8_t)v;
+}
+
+static int write_chunk_header(FILE *f, const char *id, uint32_t len)
+{
+	uint8_t hdr[8];
+
+	memcpy(hdr, id, 4);
+	put_be32(&hdr[4], len);
+	return fwrite(hdr, 1, sizeof(hdr), f) == sizeof(hdr) ? 0 : -1;
+}
+
+/* Track name meta event at delta 0 */
+static int write_track_name(FILE *f, const char *name, uint32_t *len)
+{
+	size_t n = strlen(name);
+	uint8_t ev[4] = {0x00, 0xFF, 0x03, (uint8_t)n};
+
+	if (fwrite(ev, 1, sizeof(ev), f) != sizeof(ev) || fwrite(name, 1, n, f) != n) {
+		return -1;
+	}
+	*len += (uint32_t)(sizeof(ev) + n);
+	return 0;
+}
+
+int smf_encode_vlq(uint32_t value, uint8_t *out)
+{
+	uint8_t tmp[4];
+	int n = 0;
+
+	value &= 0x0FFFFFFF;
+	do {
+		tmp[n++] = value & 0x7F;
+		value >>= 7;
+	} while (value && n < 4);
+
+	for (int i = 0; i < n; i++) {
+		out[i] = tmp[n - 1 - i] | (i < n - 1 ? 0x80 : 0);
+	}
+	return n;
+}
+
+/* ============================================================================
+ * Writer
+ * ============================================================================ */
+
+int smf_writer_open(smf_writer_t *smf, const char *path, int num_tracks)
+{
+	if (!smf || !path || num_tracks < 1 || num_tracks > SMF_MAX_TRACKS) {
+		return -1;
+	}
+
+	memset(smf, 0, sizeof(*smf));
+	smf->num_tracks = num_tracks;
+
+	smf->out = fopen(path, "wb");
+	if (!smf->out) {
+		return -2;
+	}
+
+	for (int t = 0; t < num_tracks; t++) {
+		char name[16];
+
+		smf->track[t] = tmpfile();
+		snprintf(name, sizeof(name), "Guitar %d", t + 1);
+		if (!smf->track[t] || write_track_name(smf->track[t], name, &smf->track_len[t]) != 0) {
+			for (int i = 0; i <= t; i++) {
+				if (smf->track[i]) {
+					fclose(smf->track[i]);
+				}
+			}
+			fclose(smf->out);
+			memset(smf, 0, sizeof(*smf));
+			return -2;
+		}
+	}
+
+	return 0;
+}
+
+int smf_writer_event(smf_writer_t *smf, int track, uint32_t time_us,
+                     const uint8_t *msg, size_t len)
+{
+	if (!smf || !smf->out || track < 0 || track >= smf->num_tracks ||
+	    !msg || len == 0 || len > 3) {
+		return -1;
+	}
+
+	uint32_t tick = time_us / SMF_TICK_US;
+	if (tick < smf->last_tick[track]) {
+		return -1;
+	}
+
+	uint8_t buf[4 + 3];
+	int n = smf_encode_vlq(tick - smf->last_tick[track], buf);
+	memcpy(&buf[n], msg, len);
+	n += (int)len;
+
+	if (fwrite(buf, 1, (size_t)n, smf->track[track]) != (size_t)n) {
+		return -2;
+	}
+
+	smf->track_len[track] += (uint32_t)n;
+	smf->last_tick[track] = tick;
+	smf->events++;
+
+	return 0;
+}
+
+int smf_writer_close(smf_writer_t *smf)
+{
+	static const uint8_t end_of_track[] = {0x00, 0xFF, 0x2F, 0x00};
+	int err = 0;
+
+	if (!smf || !smf->out) {
+		return -1;
+	}
+
+	/* Header: format 1, tempo track + one track per guitar */
+	uint8_t mthd[6] = {
+		0x00, 0x01,
+		0x00, (uint8_t)(smf->num_tracks + 1),
+		(uint8_t)(SMF_DIVISION >> 8), (uint8_t)(SMF_DIVISION & 0xFF),
+	};
+	if (write_chunk_header(smf->out, "MThd", sizeof(mthd)) != 0 ||
+	    fwrite(mthd, 1, sizeof(mthd), smf->out) != sizeof(mthd)) {
+		err = -2;
+	}
+
+	/* Track 0: tempo and 4/4 time signature */
+	static const uint8_t tempo_track[] = {
+		0x00, 0xFF, 0x51, 0x03,
+		(SMF_TEMPO_US >> 16) & 0xFF, (SMF_TEMPO_US >> 8) & 0xFF, SMF_TEMPO_US & 0xFF,
+		0x00, 0xFF, 0x58, 0x04, 0x04, 0x02, 0x18, 0x08,
+		0x00, 0xFF, 0x2F, 0x00,
+	};
+	if (!err && (write_chunk_header(smf->out, "MTrk", sizeof(tempo_track)) != 0 ||
+	             fwrite(tempo_track, 1, sizeof(tempo_track), smf->out) != sizeof(tempo_track))) {
+		err = -2;
+	}
+
+	/* Guitar tracks, copied from temporary storage */
+	for (int t = 0; t < smf->num_tracks; t++) {
+		FILE *tf = smf->track[t];
+		uint8_t buf[512];
+		size_t n;
+
+		if (!err && write_chunk_header(smf->out, "MTrk",
+		                               smf->track_len[t] + sizeof(end_of_track)) != 0) {
+			err = -2;
+		}
+		if (!err) {
+			rewind(tf);
+			while ((n = fread(buf, 1, sizeof(buf), tf)) > 0) {
+				if (fwrite(buf, 1, n, smf->out) != n) {
+					err = -2;
+					break;
+				}
+			}
+		}
+		if (!err && fwrite(end_of_track, 1, sizeof(end_of_track), smf->out) !=
+		    sizeof(end_of_track)) {
+			err = -2;
+		}
+		fclose(tf);
+	}
+
+	if (fclose(smf->out) != 0) {
+		err = -2;
+	}
+	memset(smf, 0, sizeof(*smf));
+
+	return err;
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Standard MIDI File Writer
+ * Streams MIDI messages into a Type-1 SMF, one track per guitar
+ *
+ * Events are appended to one temporary file per track as they arrive,
+ * so memory use does not grow with the length of the capture. The SMF
+ * itself (header, tempo track, guitar tracks) is assembled on close.
+ */
+
+#ifndef SMF_WRITER_H
+#define SMF_WRITER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#define SMF_MAX_TRACKS   4        /* Guitar tracks; track 0 holds the tempo */
+#define SMF_TEMPO_US     500000   /* 120 BPM */
+#define SMF_DIVISION     5000     /* Ticks per quarter note: 1 tick = 100 us */
+#define SMF_TICK_US      (SMF_TEMPO_US / SMF_DIVISION)
+
+/* Streaming writer state */
+typedef struct {
+	FILE *out;
+	FILE *track[SMF_MAX_TRACKS];      /* Temporary event data per guitar */
+	uint32_t track_len[SMF_MAX_TRACKS];
+	uint32_t last_tick[SMF_MAX_TRACKS];
+	uint32_t events;
+	int num_tracks;
+} smf_writer_t;
+
+/**
+ * @brief Open an SMF for writing
+ *
+ * @param smf Writer state
+ * @param path Output .mid file
+ * @param num_tracks Guitar tracks (1-SMF_MAX_TRACKS)
+ * @return 0 on success, -1 on invalid arguments, -2 on file error
+ */
+int smf_writer_open(smf_writer_t *smf, const char *path, int num_tracks);
+
+/**
+ * @brief Append one MIDI message to a guitar's track
+ *
+ * Times must not go backwards within a track.
+ *
+ * @param smf Writer state
+ * @param track Guitar track (0-based)
+ * @param time_us Event time in microseconds
+ * @param msg Message bytes, written unchanged
+ * @param len Message length (1-3)
+ * @return 0 on success, negative on failure
+ */
+int smf_writer_event(smf_writer_t *smf, int track, uint32_t time_us,
+                     const uint8_t *msg, size_t len);
+
+/**
+ * @brief Assemble the file and release temporary storage
+ *
+ * @return 0 on success, negative on write failure
+ */
+int smf_writer_close(smf_writer_t *smf);
+
+/**
+ * @brief Encode a MIDI variable-length quantity
+ *
+ * @param value Value (at most 0x0FFFFFFF)
+ * @param out Output buffer (4 bytes)
+ * @return Number of bytes written
+ */
+int smf_encode_vlq(uint32_t value, uint8_t *out);
+
+#endif /* SMF_WRITER_H */
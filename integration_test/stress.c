@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Stress Harness Driver
+ *
+ * Runs emulated guitars on their own threads against the basestation
+ * pipeline in real time and reports where it saturates.
+ *
+ *   ./stress --guitars 4 --rate 500
+ *   ./stress --rates 1000,100,100,100 --queue 4 --process-us 200
+ *   ./stress --sweep --duration 500
+ */
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "stress_harness.h"
+
+static const int sweep_guitars[] = {1, 2, 4, 8, 16};
+static const uint32_t sweep_rates[] = {100, 250, 500, 1000};
+
+static void usage(const char *prog)
+{
+	fprintf(stderr,
+	        "Usage: %s [options]\n"
+	        "  --guitars <n>       Emulated guitars, 1-%d (default 4)\n"
+	        "  --rate <hz>         Sample rate for every guitar, 1-%d (default 100)\n"
+	        "  --rates <a,b,...>   Sample rate per guitar (sets --guitars)\n"
+	        "  --duration <ms>     Run time (default 1000)\n"
+	        "  --queue <n>         Handoff queue depth (default 8)\n"
+	        "  --process-us <us>   Extra CPU time per sample, to model the target\n"
+	        "  --sweep             Run guitars x rates grid and print one line each\n",
+	        prog, STRESS_MAX_GUITARS, STRESS_MAX_RATE_HZ);
+}
+
+static int parse_rates(const char *arg, stress_config_t *cfg)
+{
+	char buf[256];
+	int n = 0;
+
+	snprintf(buf, sizeof(buf), "%s", arg);
+	for (char *tok = strtok(buf, ","); tok; tok = strtok(NULL, ",")) {
+		if (n >= STRESS_MAX_GUITARS) {
+			return -1;
+		}
+		cfg->rate_hz[n++] = (uint32_t)strtoul(tok, NULL, 10);
+	}
+	cfg->num_guitars = n;
+	return n > 0 ? 0 : -1;
+}
+
+static int run_sweep(const stress_config_t *base_cfg)
+{
+	printf("Guitars  Rate  Drops %%  Queue HW  Handoff p99 us  Sample->UART p99 us"
+	       "  MIDI drops %%  UART busy %%\n");
+
+	for (size_t gi = 0; gi < sizeof(sweep_guitars) / sizeof(sweep_guitars[0]); gi++) {
+		for (size_t ri = 0; ri < sizeof(sweep_rates) / sizeof(sweep_rates[0]); ri++) {
+			stress_config_t cfg = *base_cfg;
+			static stress_result_t res;
+			uint32_t handoff_p99 = 0;
+			uint32_t total_p99 = 0;
+
+			cfg.num_guitars = sweep_guitars[gi];
+			for (int i = 0; i < STRESS_MAX_GUITARS; i++) {
+				cfg.rate_hz[i] = sweep_rates[ri];
+			}
+
+			int err = stress_run(&cfg, &res);
+			if (err) {
+				fprintf(stderr, "Stress run failed (err %d)\n", err);
+				return 1;
+			}
+
+			for (int i = 0; i < cfg.num_guitars; i++) {
+				uint32_t h = latency_percentile_us(&res.guitar[i].handoff, 99);
+				uint32_t t = latency_percentile_us(&res.guitar[i].total, 99);
+
+				handoff_p99 = h > handoff_p99 ? h : handoff_p99;
+				total_p99 = t > total_p99 ? t : total_p99;
+			}
+
+			uint32_t offered = res.midi_messages + res.midi_dropped;
+			printf("%7d %5u %8.2f %9d %15u %20u %13.1f %12.1f\n",
+			       cfg.num_guitars, sweep_rates[ri], stress_drop_rate(&res) * 100.0,
+			       res.queue_high_water, handoff_p99, total_p99,
+			       offered ? 100.0 * res.midi_dropped / offered : 0.0,
+			       stress_uart_utilization(&res) * 100.0);
+			fflush(stdout);
+		}
+	}
+
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	stress_config_t cfg;
+	bool sweep = false;
+
+	stress_config_default(&cfg);
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--guitars") == 0 && i + 1 < argc) {
+			cfg.num_guitars = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "--rate") == 0 && i + 1 < argc) {
+			uint32_t rate = (uint32_t)strtoul(argv[++i], NULL, 10);
+			for (int g = 0; g < STRESS_MAX_GUITARS; g++) {
+				cfg.rate_hz[g] = rate;
+			}
+		} else if (strcmp(argv[i], "--rates") == 0 && i + 1 < argc) {
+			if (parse_rates(argv[++i], &cfg) != 0) {
+				usage(argv[0]);
+				return 1;
+			}
+		} else if (strcmp(argv[i], "--duration") == 0 && i + 1 < argc) {
+			cfg.duration_ms = (uint32_t)strtoul(argv[++i], NULL, 10);
+		} else if (strcmp(argv[i], "--queue") == 0 && i + 1 < argc) {
+			cfg.queue_depth = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "--process-us") == 0 && i + 1 < argc) {
+			cfg.process_us = (uint32_t)strtoul(argv[++i], NULL, 10);
+		} else if (strcmp(argv[i], "--sweep") == 0) {
+			sweep = true;
+		} else {
+			usage(argv[0]);
+			return 1;
+		}
+	}
+
+	if (sweep) {
+		return run_sweep(&cfg);
+	}
+
+	static stress_result_t res;
+	int err = stress_run(&cfg, &res);
+	if (err) {
+		fprintf(stderr, "Stress run failed (err %d)\n", err);
+		usage(argv[0]);
+		return 1;
+	}
+
+	stress_print_report(&cfg, &res, stdout);
+	return 0;
+}
@@ -0,0 +1,324 @@
+/*
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Multi-threaded Stress Harness Implementation
+ */
+
+#define _XOPEN_SOURCE 600  /* clock_gettime(), clock_nanosleep(), M_PI */
+
+#include "stress_harness.h"
+#include "sample_queue.h"
+#include "midi_pipeline.h"
+#include <errno.h>
+#include <math.h>
+#include <string.h>
+#include <time.h>
+
+/* External motion_logic functions (implemented in motion_logic.c) */
+extern void convert_accel_to_milli_g(double x, double y, double z, struct accel_data *data);
+
+/* Client thread state */
+typedef struct {
+	int guitar;
+	uint32_t rate_hz;
+	uint32_t samples;
+	sample_queue_t *queue;
+	stress_guitar_stats_t *stats;
+} client_ctx_t;
+
+/* Basestation thread state */
+typedef struct {
+	const stress_config_t *cfg;
+	sample_queue_t *queue;
+	stress_result_t *res;
+	struct midi_pipeline pipeline;
+	struct midi_uart_model uart;
+	uint32_t last_done_us;   /* Last byte of the sample being processed */
+	bool sent;
+} base_ctx_t;
+
+/* ============================================================================
+ * Helpers
+ * ============================================================================ */
+
+static uint32_t now_us(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint32_t)((uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u);
+}
+
+/* Same bucketing as latency_tracker.c, so latency_percentile_us() applies */
+static void hist_add(struct latency_hist *h, uint32_t from_us, uint32_t to_us)
+{
+	int32_t diff = (int32_t)(to_us - from_us);
+	uint32_t us = diff < 0 ? 0 : (uint32_t)diff;
+	uint32_t bucket = us / LATENCY_BUCKET_US;
+
+	if (bucket >= LATENCY_HIST_BUCKETS) {
+		bucket = LATENCY_HIST_BUCKETS - 1;
+	}
+	if (h->count == 0 || us < h->min_us) {
+		h->min_us = us;
+	}
+	if (us > h->max_us) {
+		h->max_us = us;
+	}
+	h->count++;
+	h->total_us += us;
+	h->buckets[bucket]++;
+}
+
+static void busy_wait_us(uint32_t us)
+{
+	uint32_t start = now_us();
+
+	while (now_us() - start < us) {
+	}
+}
+
+/* ============================================================================
+ * Threads
+ * ============================================================================ */
+
+/* Strumming motion, phase offset per guitar so outputs keep changing */
+static void *client_thread(void *arg)
+{
+	client_ctx_t *c = arg;
+	long period_ns = 1000000000L / (long)c->rate_hz;
+	struct timespec next;
+
+	clock_gettime(CLOCK_MONOTONIC, &next);
+
+	for (uint32_t n = 0; n < c->samples; n++) {
+		next.tv_nsec += period_ns;
+		while (next.tv_nsec >= 1000000000L) {
+			next.tv_nsec -= 1000000000L;
+			next.tv_sec++;
+		}
+		clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+
+		double t = (double)n / c->rate_hz + c->guitar * 0.1;
+		queued_sample_t item = {.guitar = c->guitar};
+
+		convert_accel_to_milli_g(1.5 * sin(2 * M_PI * 2 * t), 0.5 * cos(2 * M_PI * 2 * t),
+		                         1.0, &item.sample.accel);
+		item.sample.timestamp_us = now_us();
+
+		uint32_t due_us = (uint32_t)((uint64_t)next.tv_sec * 1000000u +
+		                             (uint64_t)next.tv_nsec / 1000u);
+		if ((int32_t)(item.sample.timestamp_us - due_us) > (int32_t)(period_ns / 1000)) {
+			c->stats->late++;
+		}
+
+		c->stats->generated++;
+		if (sample_queue_push(c->queue, &item) != 0) {
+			c->stats->dropped++;
+		}
+	}
+
+	return NULL;
+}
+
+/* Pipeline TX backend: MIDI UART model in real time */
+static int stress_midi_tx(int guitar_id, int output, const uint8_t *msg, size_t len,
+                          void *user_data)
+{
+	base_ctx_t *b = user_data;
+	uint32_t done_us;
+
+	(void)guitar_id;
+	(void)output;
+	(void)msg;
+
+	if (midi_uart_model_queue(&b->uart, now_us(), len, &done_us) != 0) {
+		return -ENOMEM;
+	}
+
+	b->res->midi_bytes += (uint32_t)len;
+	b->last_done_us = done_us;
+	b->sent = true;
+	return 0;
+}
+
+/* Same work as notify_func() -> process_accel_data() on target */
+static void *basestation_thread(void *arg)
+{
+	base_ctx_t *b = arg;
+	queued_sample_t item;
+
+	while (sample_queue_pop(b->queue, &item) == 0) {
+		stress_guitar_stats_t *g = &b->res->guitar[item.guitar];
+		const struct accel_data *a = &item.sample.accel;
+		int16_t accel_values[MAX_SENSOR_SOURCES] = {a->x, a->y, a->z};
+
+		hist_add(&g->handoff, item.sample.timestamp_us, now_us());
+		if (b->cfg->process_us) {
+			busy_wait_us(b->cfg->process_us);
+		}
+
+		b->sent = false;
+		midi_pipeline_process(&b->pipeline, item.guitar, accel_values);
+		if (b->sent) {
+			hist_add(&g->total, item.sample.timestamp_us, b->last_done_us);
+		}
+		g->processed++;
+	}
+
+	return NULL;
+}
+
+/* ============================================================================
+ * Public API
+ * ============================================================================ */
+
+void stress_config_default(stress_config_t *cfg)
+{
+	memset(cfg, 0, sizeof(*cfg));
+	cfg->num_guitars = 4;
+	for (int i = 0; i < STRESS_MAX_GUITARS; i++) {
+		cfg->rate_hz[i] = 100;
+	}
+	cfg->duration_ms = 1000;
+	cfg->queue_depth = 8;
+}
+
+int stress_run(const stress_config_t *cfg, stress_result_t *res)
+{
+	static sample_queue_t queue;
+	static base_ctx_t base;
+	client_ctx_t clients[STRESS_MAX_GUITARS];
+	pthread_t client_tids[STRESS_MAX_GUITARS];
+	pthread_t base_tid;
+	int started = 0;
+	int err;
+
+	if (!cfg || !res || cfg->num_guitars < 1 || cfg->num_guitars > STRESS_MAX_GUITARS) {
+		return -EINVAL;
+	}
+	for (int i = 0; i < cfg->num_guitars; i++) {
+		if (cfg->rate_hz[i] == 0 || cfg->rate_hz[i] > STRESS_MAX_RATE_HZ) {
+			return -EINVAL;
+		}
+	}
+
+	err = sample_queue_init(&queue, cfg->queue_depth);
+	if (err) {
+		return err;
+	}
+
+	memset(res, 0, sizeof(*res));
+	memset(&base, 0, sizeof(base));
+	base.cfg = cfg;
+	base.queue = &queue;
+	base.res = res;
+	midi_uart_model_init(&base.uart);
+	midi_pipeline_init(&base.pipeline, stress_midi_tx, &base);
+
+	/* Factory default patch (config_storage_get_hardcoded_defaults()) */
+	struct patch_topology_config topo;
+	struct function_unit funcs[MAX_FUNCTION_UNITS];
+
+	topology_patch_init_default(&topo);
+	for (int i = 0; i < MAX_FUNCTION_UNITS; i++) {
+		func_init_linear(&funcs[i], -2000, 2000, 0, 127);
+	}
+	midi_pipeline_configure(&base.pipeline, topo.topologies, topo.default_mixer_type,
+	                        funcs, 0, 1);
+
+	uint32_t start_us = now_us();
+
+	err = -pthread_create(&base_tid, NULL, basestation_thread, &base);
+	if (err) {
+		sample_queue_destroy(&queue);
+		return err;
+	}
+
+	for (int i = 0; i < cfg->num_guitars; i++) {
+		clients[i] = (client_ctx_t){
+			.guitar = i,
+			.rate_hz = cfg->rate_hz[i],
+			.samples = (uint32_t)((uint64_t)cfg->duration_ms * cfg->rate_hz[i] / 1000),
+			.queue = &queue,
+			.stats = &res->guitar[i],
+		};
+		err = -pthread_create(&client_tids[i], NULL, client_thread, &clients[i]);
+		if (err) {
+			break;
+		}
+		started++;
+	}
+
+	for (int i = 0; i < started; i++) {
+		pthread_join(client_tids[i], NULL);
+	}
+	sample_queue_close(&queue);
+	pthread_join(base_tid, NULL);
+
+	res->elapsed_us = now_us() - start_us;
+	res->queue_high_water = queue.high_water;
+	res->midi_messages = base.uart.queued;
+	res->midi_dropped = base.uart.dropped;
+	res->max_backlog_us = base.uart.max_backlog_us;
+
+	sample_queue_destroy(&queue);
+	return err;
+}
+
+double stress_drop_rate(const stress_result_t *res)
+{
+	uint64_t generated = 0;
+	uint64_t dropped = 0;
+
+	for (int i = 0; i < STRESS_MAX_GUITARS; i++) {
+		generated += res->guitar[i].generated;
+		dropped += res->guitar[i].dropped;
+	}
+	return generated ? (double)dropped / generated : 0.0;
+}
+
+double stress_uart_utilization(const stress_result_t *res)
+{
+	if (res->elapsed_us == 0) {
+		return 0.0;
+	}
+
+	/* Bytes still queued at the end can push this past 1 */
+	double busy = (double)res->midi_bytes * MIDI_BYTE_TIME_US / res->elapsed_us;
+	return busy > 1.0 ? 1.0 : busy;
+}
+
+void stress_print_report(const stress_config_t *cfg, const stress_result_t *res, FILE *out)
+{
+	uint32_t offered = 0;
+
+	fprintf(out, "\n=== Stress: %d guitar%s, queue %d, +%u us/sample, %.2f s ===\n",
+	        cfg->num_guitars, cfg->num_guitars == 1 ? "" : "s", cfg->queue_depth,
+	        cfg->process_us, res->elapsed_us / 1e6);
+	fprintf(out, "Guitar  Rate  Generated  Dropped  Late  Handoff us (p50/p99/max)"
+	             "  Sample->UART us (p50/p99/max)\n");
+
+	for (int i = 0; i < cfg->num_guitars; i++) {
+		const stress_guitar_stats_t *g = &res->guitar[i];
+
+		offered += cfg->rate_hz[i];
+		fprintf(out, "%6d %5u %10u %8u %5u  %7u/%6u/%6u          %7u/%6u/%6u\n",
+		        i, cfg->rate_hz[i], g->generated, g->dropped, g->late,
+		        latency_percentile_us(&g->handoff, 50),
+		        latency_percentile_us(&g->handoff, 99), g->handoff.max_us,
+		        latency_percentile_us(&g->total, 50),
+		        latency_percentile_us(&g->total, 99), g->total.max_us);
+	}
+
+	fprintf(out, "Offered load:    %u samples/s\n", offered);
+	fprintf(out, "Queue drops:     %.2f %% (high water %d of %d)\n",
+	        stress_drop_rate(res) * 100.0, res->queue_high_water, cfg->queue_depth);
+	fprintf(out, "MIDI TX:         %u sent, %u dropped (%.1f %%), UART busy %.1f %%, "
+	             "backlog max %u us\n",
+	        res->midi_messages, res->midi_dropped,
+	        res->midi_messages + res->midi_dropped ?
+	        100.0 * res->midi_dropped / (res->midi_messages + res->midi_dropped) : 0.0,
+	        stress_uart_utilization(res) * 100.0, res->max_backlog_us);
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2026 GuitarAcc Project
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Multi-threaded Stress Harness
+ *
+ * One pthread per emulated guitar generates motion at its own rate in
+ * real time and hands timestamped samples to a basestation thread through
+ * a bounded queue (sample_queue.h). The basestation thread runs each
+ * sample through the firmware's midi_pipeline.c into the MIDI UART model,
+ * so the report shows where the design saturates: queue drops, handoff
+ * latency, and the 31250-baud UART.
+ */
+
+#ifndef STRESS_HARNESS_H
+#define STRESS_HARNESS_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "latency_tracker.h"
+
+#define STRESS_MAX_GUITARS 16
+#define STRESS_MAX_RATE_HZ 1000
+
+/* Run configuration */
+typedef struct {
+	int num_guitars;
+	uint32_t rate_hz[STRESS_MAX_GUITARS];   /* Samples per second per guitar */
+	uint32_t duration_ms;
+	int queue_depth;                        /* Samples the handoff queue holds */
+	uint32_t process_us;                    /* Extra CPU time per sample (target cost) */
+} stress_config_t;
+
+/* Per-guitar results */
+typedef struct {
+	uint32_t generated;
+	uint32_t dropped;            /* Queue full */
+	uint32_t processed;
+	uint32_t late;               /* Producer woke a whole period late */
+	struct latency_hist handoff; /* Sample time -> basestation thread picks it up */
+	struct latency_hist total;   /* Sample time -> last CC byte leaves the UART */
+} stress_guitar_stats_t;
+
+/* Run results */
+typedef struct {
+	stress_guitar_stats_t guitar[STRESS_MAX_GUITARS];
+	int queue_high_water;
+	uint32_t midi_messages;      /* Accepted by the UART model */
+	uint32_t midi_dropped;       /* Rejected as the firmware TX ring would */
+	uint32_t midi_bytes;
+	uint32_t max_backlog_us;
+	uint32_t elapsed_us;
+} stress_result_t;
+
+/**
+ * @brief Fill a configuration with defaults
+ *
+ * Four guitars at 100 Hz for one second, queue depth 8, no extra cost.
+ *
+ * @param cfg Configuration
+ */
+void stress_config_default(stress_config_t *cfg);
+
+/**
+ * @brief Run the harness in real time
+ *
+ * @param cfg Configuration
+ * @param res Output: results
+ * @return 0 on success, negative errno on failure
+ */
+int stress_run(const stress_config_t *cfg, stress_result_t *res);
+
+/**
+ * @brief Fraction of samples dropped before processing, all guitars
+ *
+ * @param res Results
+ * @return Drop rate (0.0 to 1.0)
+ */
+double stress_drop_rate(const stress_result_t *res);
+
+/**
+ * @brief Fraction of the run the MIDI UART spent sending
+ *
+ * @param res Results
+ * @return Utilization (0.0 to 1.0)
+ */
+double stress_uart_utilization(const stress_result_t *res);
+
+/**
+ * @brief Print per-guitar and overall report
+ *
+ * @param cfg Configuration used
+ * @param res Results
+ * @param out Output stream
+ */
+void stress_print_report(const stress_config_t *cfg, const stress_result_t *res, FILE *out);
+
+#endif /* STRESS_HARNESS_H */
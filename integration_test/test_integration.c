@@ -13,12 +13,16 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <stdlib.h>
 #include <assert.h>
 #include <math.h>
 
 #include "ble_hal.h"
 #include "client_emulator.h"
 #include "basestation_emulator.h"
+#include "capture_replay.h"
+#include "smf_writer.h"
+#include "stress_harness.h"
 
 /* Test utilities */
 static int test_count = 0;
@@ -185,8 +189,10 @@ static void test_simple_data_flow(void)
 
 /**
  * Test 4: Multiple Packets
- * - Send multiple acceleration packets
+ * - Send multiple acceleration packets at the 100 Hz sensor rate
  * - Verify all are received and converted correctly
+ * - The first sample's six CCs overflow the 16-byte TX ring after three,
+ *   exactly as on target; X, Y, Z then fit comfortably every 10 ms
  */
 static void test_multiple_packets(void)
 {
@@ -213,13 +219,18 @@ static void test_multiple_packets(void)
 			(int16_t)(i * 100),
 			(int16_t)(i * 100)
 		};
+		ble_hal_advance_time_us(10000);
 		TEST_ASSERT(client_emulator_send_accel(&client, &accel) == 0, "Send accel failed");
 		ble_hal_process_events();
 	}
 	
 	/* Verify all received */
 	TEST_ASSERT(base.packets_received == 10, "Not all packets received");
+	/* X/Y/Z change every packet. The tilt (roll 45, pitch -35) changes
+	 * once, on the second packet, and its two CCs find the TX ring full */
+	printf("  %u sent, %u dropped\n", base.midi_messages_sent, base.midi_messages_dropped);
 	TEST_ASSERT(base.midi_messages_sent == 30, "Wrong MIDI message count");
+	TEST_ASSERT(base.midi_messages_dropped == 5, "Only the first burst and the tilt change should overflow");
 	
 	/* Cleanup */
 	client_emulator_cleanup(&client);
@@ -343,6 +354,7 @@ static void test_midi_range(void)
 	
 	/* Test minimum value (-2000 milli-g should map to MIDI 0) */
 	struct accel_data min_accel = {-2000, -2000, -2000};
+	ble_hal_advance_time_us(10000);
 	TEST_ASSERT(client_emulator_send_accel(&client, &min_accel) == 0, "Send failed");
 	ble_hal_process_events();
 	TEST_ASSERT(basestation_emulator_get_last_midi(&base, 0, midi_msg), "No MIDI data");
@@ -350,6 +362,7 @@ static void test_midi_range(void)
 	
 	/* Test zero (0 milli-g should map to MIDI 64) */
 	struct accel_data zero_accel = {0, 0, 0};
+	ble_hal_advance_time_us(10000);
 	TEST_ASSERT(client_emulator_send_accel(&client, &zero_accel) == 0, "Send failed");
 	ble_hal_process_events();
 	TEST_ASSERT(basestation_emulator_get_last_midi(&base, 0, midi_msg), "No MIDI data");
@@ -357,6 +370,7 @@ static void test_midi_range(void)
 	
 	/* Test maximum value (+2000 milli-g should map to MIDI 127) */
 	struct accel_data max_accel = {2000, 2000, 2000};
+	ble_hal_advance_time_us(10000);
 	TEST_ASSERT(client_emulator_send_accel(&client, &max_accel) == 0, "Send failed");
 	ble_hal_process_events();
 	TEST_ASSERT(basestation_emulator_get_last_midi(&base, 0, midi_msg), "No MIDI data");
@@ -459,6 +473,1092 @@ static void test_disconnection(void)
 	TEST_PASS();
 }
 
+/**
+ * Test 9: Latency Breakdown from Simulated Timestamps
+ * - 7.5 ms connection interval, 10 Hz samples, client clock 5 s ahead
+ * - Sample phases repeat every 3 samples: waits of 6.5, 4.0 and 1.5 ms
+ *   until the next connection event
+ * - Clock offset settles on the 1.5 ms minimum, so the radio segment
+ *   reports 0, 2.5 and 5.0 ms; the UART model adds 0.96 ms per queued CC
+ * - X, Y and Z change every sample, so each sample queues three CCs
+ */
+static void test_latency_breakdown(void)
+{
+	TEST_START("Latency Breakdown");
+	
+	basestation_emulator_t base;
+	client_emulator_t client;
+	uint8_t client_addr[6] = {0x11, 0x22, 0x33, 0x44, 0x55, 0x66};
+	const uint32_t interval_us = 7500;
+	const int num_samples = 30;
+	
+	/* Setup */
+	TEST_ASSERT(basestation_emulator_init(&base) == 0, "Basestation init failed");
+	TEST_ASSERT(client_emulator_init(&client, client_addr) == 0, "Client init failed");
+	client.clock_offset_us = 5000000;
+	TEST_ASSERT(client_emulator_start_advertising(&client) == 0, "Start advertising failed");
+	TEST_ASSERT(basestation_emulator_connect(&base, client_addr) == 0, "Connect failed");
+	ble_hal_process_events();
+	TEST_ASSERT(basestation_emulator_enable_notifications(&base, 0) == 0,
+	            "Enable notifications failed");
+	ble_hal_process_events();
+	TEST_ASSERT(ble_hal_set_conn_interval(base.guitars[0].handle, interval_us) == 0,
+	            "Set connection interval failed");
+	
+	/* Align so the first sample is 1 ms after a connection event anchor */
+	uint32_t now = ble_hal_get_time_us();
+	ble_hal_advance_time_us(interval_us - (now % interval_us) + 1000);
+	
+	for (int i = 0; i < num_samples; i++) {
+		uint32_t sample_time = ble_hal_get_time_us();
+		struct accel_data accel = {
+			(int16_t)(i * 100 - 1500),
+			(int16_t)(1500 - i * 100),
+			(int16_t)(i * 50 - 750)
+		};
+		
+		TEST_ASSERT(client_emulator_send_accel(&client, &accel) == 0, "Send accel failed");
+		ble_hal_process_events();
+		
+		/* Next sample 100 ms after this one */
+		ble_hal_advance_time_us(sample_time + 100000 - ble_hal_get_time_us());
+	}
+	
+	const struct latency_tracker *lat = basestation_emulator_get_latency(&base);
+	const struct latency_hist *radio = &lat->hist[LAT_SEG_RADIO];
+	const struct latency_hist *process = &lat->hist[LAT_SEG_PROCESS];
+	const struct latency_hist *tx = &lat->hist[LAT_SEG_TX];
+	const struct latency_hist *total = &lat->hist[LAT_SEG_TOTAL];
+	
+	printf("  Latency (us): radio max=%u, uart max=%u, total p50=%u max=%u\n",
+	       radio->max_us, tx->max_us, latency_percentile_us(total, 50), total->max_us);
+	
+	TEST_ASSERT(total->count == (uint32_t)(num_samples * 3), "Wrong traced CC count");
+	TEST_ASSERT(radio->min_us == 0, "Radio min should be 0 (offset anchor)");
+	TEST_ASSERT(radio->max_us == 5000, "Radio max should be 6.5 - 1.5 ms");
+	TEST_ASSERT(process->max_us == 0, "Emulator processing is instantaneous");
+	TEST_ASSERT(tx->min_us == 960, "First CC should take 3 byte times");
+	TEST_ASSERT(tx->max_us == 2880, "Third CC should wait behind two others");
+	TEST_ASSERT(total->max_us == 5000 + 2880, "Total should be radio + UART");
+	
+	/* Cleanup */
+	client_emulator_cleanup(&client);
+	basestation_emulator_cleanup(&base);
+	
+	TEST_PASS();
+}
+
+/* MIDI collected from a replay */
+typedef struct {
+	uint8_t bytes[4096];
+	size_t len;
+	uint32_t last_queued_us;
+	bool monotonic;
+	int guitars_seen;
+} replay_capture_t;
+
+static void collect_midi(uint32_t queued_us, uint32_t tx_done_us, int guitar,
+                         const uint8_t *msg, size_t len, void *user_data)
+{
+	replay_capture_t *out = user_data;
+	
+	if (queued_us < out->last_queued_us || tx_done_us <= queued_us) {
+		out->monotonic = false;
+	}
+	out->last_queued_us = queued_us;
+	out->guitars_seen |= 1 << guitar;
+	if (out->len + len <= sizeof(out->bytes)) {
+		memcpy(&out->bytes[out->len], msg, len);
+		out->len += len;
+	}
+}
+
+/* Two guitars interleaved at 100 Hz each, timestamps crossing the 32-bit wrap */
+#define REPLAY_NUM_RECORDS 100
+#define REPLAY_FILE_SIZE (sizeof(struct capture_header) + \
+                          REPLAY_NUM_RECORDS * sizeof(struct capture_record))
+
+static void build_test_capture(uint8_t *file)
+{
+	struct capture_header hdr = {
+		.magic = CAPTURE_MAGIC,
+		.version = CAPTURE_VERSION,
+		.record_size = sizeof(struct capture_record),
+		.record_count = REPLAY_NUM_RECORDS,
+	};
+	
+	memcpy(file, &hdr, sizeof(hdr));
+	for (int i = 0; i < REPLAY_NUM_RECORDS; i++) {
+		struct capture_record rec = {
+			.timestamp_us = 0xFFFF0000u + (uint32_t)i * 5000,
+			.guitar = (uint8_t)(i % 2),
+			.x = (int16_t)((i % 2) ? -1000 : i * 20),
+			.y = 0,
+			.z = 1000,
+		};
+		memcpy(&file[sizeof(hdr) + i * sizeof(rec)], &rec, sizeof(rec));
+	}
+}
+
+/**
+ * Test 10: Capture Replay
+ * - Build a two-guitar capture file in memory
+ * - Replay it twice through the emulated link and topology processor
+ * - Verify MIDI stream is deterministic, well-formed and time-ordered
+ */
+static void test_capture_replay(void)
+{
+	TEST_START("Capture Replay");
+	
+	static uint8_t file[REPLAY_FILE_SIZE];
+	
+	build_test_capture(file);
+	
+	capture_file_t cap;
+	TEST_ASSERT(capture_file_parse(file, sizeof(file), &cap) == 0, "Parse failed");
+	TEST_ASSERT(cap.count == REPLAY_NUM_RECORDS, "Wrong record count");
+	TEST_ASSERT(cap.num_guitars == 2, "Expected two guitars");
+	TEST_ASSERT(capture_file_parse(file, sizeof(file) - 1, &cap) != 0 ||
+	            (capture_file_free(&cap), 0), "Truncated capture accepted");
+	TEST_ASSERT(capture_file_parse(file, sizeof(file), &cap) == 0, "Re-parse failed");
+	
+	static replay_capture_t run1, run2;
+	replay_options_t opt = {.midi_cb = collect_midi};
+	replay_stats_t stats;
+	
+	memset(&run1, 0, sizeof(run1));
+	run1.monotonic = true;
+	opt.user_data = &run1;
+	TEST_ASSERT(replay_run(&cap, &opt, &stats) == 0, "First replay failed");
+	
+	memset(&run2, 0, sizeof(run2));
+	run2.monotonic = true;
+	opt.user_data = &run2;
+	TEST_ASSERT(replay_run(&cap, &opt, NULL) == 0, "Second replay failed");
+	
+	printf("  Replayed %u samples -> %u MIDI messages (%u dropped), span %u us\n",
+	       stats.samples, stats.midi_messages, stats.midi_dropped, stats.duration_us);
+	
+	TEST_ASSERT(stats.samples == REPLAY_NUM_RECORDS, "Not every sample delivered");
+	TEST_ASSERT(stats.duration_us == (REPLAY_NUM_RECORDS - 1) * 5000, "Wrong span across wrap");
+	TEST_ASSERT(stats.midi_messages > 0, "No MIDI produced");
+	TEST_ASSERT(run1.len == stats.midi_bytes, "Callback saw every byte");
+	TEST_ASSERT(run1.len == run2.len && memcmp(run1.bytes, run2.bytes, run1.len) == 0,
+	            "Replay is not deterministic");
+	TEST_ASSERT(run1.monotonic, "MIDI timing not monotonic");
+	TEST_ASSERT(run1.guitars_seen == 0x3, "Both guitars should produce MIDI");
+	
+	/* First sample sends all six outputs at once; the TX queue limit
+	 * (as in queue_midi_bytes()) only lets CC 16-18 through.
+	 */
+	TEST_ASSERT(run1.len >= 9, "Too few bytes for initial outputs");
+	for (int i = 0; i < 3; i++) {
+		TEST_ASSERT(run1.bytes[i * 3] == 0xB0, "Expected CC on channel 1");
+		TEST_ASSERT(run1.bytes[i * 3 + 1] == 16 + i, "Expected CC 16-18");
+	}
+	TEST_ASSERT(run1.bytes[2] == 63, "X=0 milli-g should map to 63");
+	TEST_ASSERT(stats.midi_dropped >= 3, "Initial burst should overflow TX queue");
+	
+	capture_file_free(&cap);
+	
+	/* Later tests (if any) expect the shared BLE HAL to be initialized */
+	ble_hal_init();
+	
+	TEST_PASS();
+}
+
+static uint32_t read_be32(const uint8_t *p)
+{
+	return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+/* Append MIDI bytes for one guitar, in arrival order */
+typedef struct {
+	uint8_t bytes[2][4096];
+	size_t len[2];
+	smf_writer_t *smf;
+} smf_check_t;
+
+static void collect_smf(uint32_t queued_us, uint32_t tx_done_us, int guitar,
+                        const uint8_t *msg, size_t len, void *user_data)
+{
+	smf_check_t *chk = user_data;
+	
+	(void)queued_us;
+	smf_writer_event(chk->smf, guitar, tx_done_us, msg, len);
+	if (guitar < 2 && chk->len[guitar] + len <= sizeof(chk->bytes[0])) {
+		memcpy(&chk->bytes[guitar][chk->len[guitar]], msg, len);
+		chk->len[guitar] += len;
+	}
+}
+
+/**
+ * Test 11: Standard MIDI File Export
+ * - Variable-length quantity encoding
+ * - Replay a two-guitar capture into a Type-1 SMF
+ * - Verify header, one track per guitar, and that each track carries
+ *   exactly the bytes the pipeline queued for that guitar
+ */
+static void test_smf_export(void)
+{
+	TEST_START("Standard MIDI File Export");
+	
+	static const struct {
+		uint32_t value;
+		uint8_t bytes[4];
+		int len;
+	} vlq[] = {
+		{0x00, {0x00}, 1},
+		{0x7F, {0x7F}, 1},
+		{0x80, {0x81, 0x00}, 2},
+		{0x3FFF, {0xFF, 0x7F}, 2},
+		{0x200000, {0x81, 0x80, 0x80, 0x00}, 4},
+		{0x0FFFFFFF, {0xFF, 0xFF, 0xFF, 0x7F}, 4},
+	};
+	for (size_t i = 0; i < sizeof(vlq) / sizeof(vlq[0]); i++) {
+		uint8_t out[4];
+		int n = smf_encode_vlq(vlq[i].value, out);
+		TEST_ASSERT(n == vlq[i].len && memcmp(out, vlq[i].bytes, n) == 0, "VLQ encoding wrong");
+	}
+	
+	static uint8_t file[REPLAY_FILE_SIZE];
+	static smf_check_t chk;
+	static smf_writer_t smf;
+	const char *path = "test_replay.mid";
+	capture_file_t cap;
+	replay_stats_t stats;
+	
+	build_test_capture(file);
+	TEST_ASSERT(capture_file_parse(file, sizeof(file), &cap) == 0, "Parse failed");
+	TEST_ASSERT(smf_writer_open(&smf, path, cap.num_guitars) == 0, "SMF open failed");
+	
+	memset(&chk, 0, sizeof(chk));
+	chk.smf = &smf;
+	replay_options_t opt = {.midi_cb = collect_smf, .user_data = &chk};
+	TEST_ASSERT(replay_run(&cap, &opt, &stats) == 0, "Replay failed");
+	TEST_ASSERT(smf.events == stats.midi_messages, "Every message should become an event");
+	TEST_ASSERT(smf_writer_close(&smf) == 0, "SMF close failed");
+	capture_file_free(&cap);
+	ble_hal_init();
+	
+	/* Read back */
+	static uint8_t mid[16384];
+	FILE *f = fopen(path, "rb");
+	TEST_ASSERT(f != NULL, "SMF not written");
+	size_t size = fread(mid, 1, sizeof(mid), f);
+	fclose(f);
+	remove(path);
+	
+	TEST_ASSERT(size > 14 && memcmp(mid, "MThd", 4) == 0, "Missing MThd");
+	TEST_ASSERT(read_be32(&mid[4]) == 6, "Header length should be 6");
+	TEST_ASSERT(mid[8] == 0 && mid[9] == 1, "Expected format 1");
+	TEST_ASSERT(mid[10] == 0 && mid[11] == 3, "Expected tempo + 2 guitar tracks");
+	TEST_ASSERT(((mid[12] << 8) | mid[13]) == SMF_DIVISION, "Wrong division");
+	
+	size_t off = 14;
+	uint32_t events = 0;
+	for (int t = 0; t < 3; t++) {
+		TEST_ASSERT(off + 8 <= size && memcmp(&mid[off], "MTrk", 4) == 0, "Missing MTrk");
+		uint32_t len = read_be32(&mid[off + 4]);
+		size_t p = off + 8, end = p + len;
+		TEST_ASSERT(end <= size, "Track overruns file");
+		
+		uint8_t track_bytes[4096];
+		size_t track_len = 0;
+		uint32_t tick = 0, last_tick = 0;
+		
+		while (p < end) {
+			uint32_t delta = 0;
+			do {
+				delta = (delta << 7) | (mid[p] & 0x7F);
+			} while (mid[p++] & 0x80);
+			tick += delta;
+			
+			if (mid[p] == 0xFF) {
+				p += 3 + mid[p + 2];  /* Meta event */
+			} else {
+				/* Channel message, written without running status */
+				TEST_ASSERT((mid[p] & 0xF0) == 0xB0, "Expected CC message");
+				memcpy(&track_bytes[track_len], &mid[p], 3);
+				track_len += 3;
+				p += 3;
+				events++;
+				TEST_ASSERT(tick >= last_tick, "Ticks went backwards");
+				last_tick = tick;
+			}
+		}
+		TEST_ASSERT(p == end, "Track length mismatch");
+		TEST_ASSERT(memcmp(&mid[end - 3], "\xFF\x2F\x00", 3) == 0, "Missing end of track");
+		
+		if (t > 0) {
+			TEST_ASSERT(track_len == chk.len[t - 1] &&
+			            memcmp(track_bytes, chk.bytes[t - 1], track_len) == 0,
+			            "Track bytes differ from pipeline output");
+		}
+		off = end;
+	}
+	
+	printf("  %u events, %zu bytes, %u us per tick\n", events, size, (unsigned int)SMF_TICK_US);
+	TEST_ASSERT(off == size, "Trailing data after last track");
+	TEST_ASSERT(events == stats.midi_messages, "Event count mismatch");
+	
+	TEST_PASS();
+}
+
+/**
+ * Test 12: Patch Configuration
+ * - Load a non-default patch into the emulator's firmware pipeline
+ * - MIDI channel and deadzone come from the patch
+ * - Outputs of disabled topologies stay at 0 and are sent once
+ */
+static void test_patch_configuration(void)
+{
+	TEST_START("Patch Configuration");
+	
+	basestation_emulator_t base;
+	client_emulator_t client;
+	uint8_t client_addr[6] = {0x11, 0x22, 0x33, 0x44, 0x55, 0x66};
+	struct patch_topology_config topo;
+	struct function_unit funcs[MAX_FUNCTION_UNITS];
+	uint8_t midi_msg[3];
+	
+	/* X only (CC 16), channel 10, deadzone 8 */
+	topology_patch_init_default(&topo);
+	for (int i = 1; i < MAX_TOPOLOGY_INSTANCES; i++) {
+		topo.topologies[i].enabled = 0;
+	}
+	for (int i = 0; i < MAX_FUNCTION_UNITS; i++) {
+		func_init_linear(&funcs[i], -2000, 2000, 0, 127);
+	}
+	
+	/* Setup */
+	TEST_ASSERT(basestation_emulator_init(&base) == 0, "Basestation init failed");
+	TEST_ASSERT(basestation_emulator_configure(&base, topo.topologies, topo.default_mixer_type,
+	                                           funcs, 9, 8) == 0, "Configure failed");
+	TEST_ASSERT(client_emulator_init(&client, client_addr) == 0, "Client init failed");
+	TEST_ASSERT(client_emulator_start_advertising(&client) == 0, "Start advertising failed");
+	TEST_ASSERT(basestation_emulator_connect(&base, client_addr) == 0, "Connect failed");
+	ble_hal_process_events();
+	TEST_ASSERT(basestation_emulator_enable_notifications(&base, 0) == 0,
+	            "Enable notifications failed");
+	ble_hal_process_events();
+	
+	/* X sweeps in 50 milli-g steps (about 1.6 CC steps) */
+	for (int i = 0; i < 20; i++) {
+		struct accel_data accel = {(int16_t)(i * 50), 0, 0};
+		ble_hal_advance_time_us(10000);
+		TEST_ASSERT(client_emulator_send_accel(&client, &accel) == 0, "Send accel failed");
+		ble_hal_process_events();
+	}
+	
+	TEST_ASSERT(basestation_emulator_get_last_midi(&base, 0, midi_msg), "No X MIDI data");
+	TEST_ASSERT(midi_msg[0] == 0xB9, "Expected CC on channel 10");
+	TEST_ASSERT(midi_msg[1] == 16, "Expected CC 16 from patch");
+	
+	TEST_ASSERT(basestation_emulator_get_last_midi(&base, 1, midi_msg), "No output 1 data");
+	TEST_ASSERT(midi_msg[1] == 17 && midi_msg[2] == 0, "Disabled topology: default CC, value 0");
+	
+	/* 63 -> 93 over 19 steps: first sample sends, then only changes of 8 or more */
+	printf("  %u sent, %u dropped, last X value %u\n", base.midi_messages_sent,
+	       base.midi_messages_dropped, base.last_midi[0].msg[2]);
+	TEST_ASSERT(base.midi_messages_sent + base.midi_messages_dropped == 6 + 3,
+	            "Deadzone should allow three X updates after the first burst");
+	TEST_ASSERT(base.last_midi[0].msg[2] >= 63 + 3 * 8, "Last X update below deadzone steps");
+	
+	/* Cleanup */
+	client_emulator_cleanup(&client);
+	basestation_emulator_cleanup(&base);
+	
+	TEST_PASS();
+}
+
+/* Four guitars on different radio settings, as in radio_params below */
+#define RADIO_GUITARS      4
+#define RADIO_DURATION_US  2000000
+#define RADIO_CHAR_HANDLE  1    /* Accel characteristic, as in the emulators */
+
+typedef struct {
+	ble_conn_metrics_t metrics[RADIO_GUITARS];
+	uint32_t sent[RADIO_GUITARS];
+	uint32_t refused[RADIO_GUITARS];
+	uint32_t received;
+} radio_result_t;
+
+static const uint32_t radio_period_us[RADIO_GUITARS] = {10000, 5000, 10000, 20000};
+
+static const ble_radio_params_t radio_params[RADIO_GUITARS] = {
+	/* Clean link */
+	{.conn_interval_us = 7500},
+	/* Untimestamped 6-byte packets, one PDU per 15 ms event, 4 buffers */
+	{.conn_interval_us = 15000, .anchor_offset_us = 1875, .max_pdus_per_event = 1,
+	 .tx_buffers = 4},
+	/* 2M PHY, 10% random loss, anchor jitter */
+	{.conn_interval_us = 7500, .anchor_offset_us = 3750, .phy = BLE_PHY_2M,
+	 .loss_permille = 100, .jitter_us = 500},
+	/* Bursty loss, link layer gives up after two resends */
+	{.conn_interval_us = 7500, .anchor_offset_us = 5625, .max_retx = 2,
+	 .burst_enter_permille = 50, .burst_exit_permille = 300},
+};
+
+/* Connect four guitars, stream for RADIO_DURATION_US and collect metrics */
+static int run_radio_scenario(radio_result_t *res, FILE *csv)
+{
+	static basestation_emulator_t base;
+	static client_emulator_t clients[RADIO_GUITARS];
+	int err = -1;
+	
+	memset(res, 0, sizeof(*res));
+	ble_hal_init();
+	ble_hal_set_seed(0x5EED);
+	if (basestation_emulator_init(&base) != 0) {
+		return -1;
+	}
+	base.quiet = true;
+	
+	for (int g = 0; g < RADIO_GUITARS; g++) {
+		uint8_t addr[6] = {0xC0, 0x00, 0x00, 0x00, 0x00, (uint8_t)(0x10 + g)};
+		
+		if (client_emulator_init(&clients[g], addr) != 0 ||
+		    client_emulator_start_advertising(&clients[g]) != 0 ||
+		    basestation_emulator_connect(&base, addr) != 0) {
+			goto out;
+		}
+		ble_hal_process_events();
+		if (basestation_emulator_enable_notifications(&base, g) != 0) {
+			goto out;
+		}
+		ble_hal_process_events();
+		if (ble_hal_set_radio_params(base.guitars[g].handle, &radio_params[g]) != 0) {
+			goto out;
+		}
+	}
+	
+	/* Step in 1 ms ticks; each guitar samples at its own rate */
+	uint32_t t0 = ble_hal_get_time_us();
+	for (uint32_t t = 0; t < RADIO_DURATION_US; t += 1000) {
+		ble_hal_run_until(t0 + t);
+		
+		for (int g = 0; g < RADIO_GUITARS; g++) {
+			if (t % radio_period_us[g] != 0) {
+				continue;
+			}
+			
+			int16_t v = (int16_t)((t / radio_period_us[g]) % 2000 - 1000);
+			struct accel_data accel = {v, (int16_t)-v, 0};
+			int ret;
+			
+			if (g == 1) {
+				ret = ble_hal_notify(clients[g].conn_handle, RADIO_CHAR_HANDLE,
+				                     &accel, sizeof(accel));
+			} else {
+				ret = client_emulator_send_accel(&clients[g], &accel);
+			}
+			if (ret == 0) {
+				res->sent[g]++;
+			} else {
+				res->refused[g]++;
+			}
+		}
+	}
+	ble_hal_process_events();
+	
+	for (int g = 0; g < RADIO_GUITARS; g++) {
+		ble_hal_get_conn_metrics(base.guitars[g].handle, &res->metrics[g]);
+	}
+	res->received = base.packets_received;
+	if (csv) {
+		ble_hal_write_metrics_csv(csv);
+	}
+	err = 0;
+	
+out:
+	for (int g = 0; g < RADIO_GUITARS; g++) {
+		client_emulator_cleanup(&clients[g]);
+	}
+	basestation_emulator_cleanup(&base);
+	ble_hal_process_events();
+	return err;
+}
+
+/**
+ * Test 13: Radio Model
+ * - Four guitars at 100, 200, 100 and 50 Hz with different connection
+ *   intervals, PHYs, packet sizes, loss and TX buffer limits
+ * - Same seed gives identical per-connection metrics
+ * - Clean link delivers every packet within one interval plus air time
+ * - Per-event budget and TX buffers refuse packets beyond link capacity
+ * - Random loss is retransmitted, bursty loss with max_retx loses packets
+ */
+static void test_radio_model(void)
+{
+	TEST_START("Radio Model");
+	
+	static radio_result_t run1, run2;
+	
+	TEST_ASSERT(run_radio_scenario(&run1, stdout) == 0, "Scenario setup failed");
+	TEST_ASSERT(run_radio_scenario(&run2, NULL) == 0, "Scenario setup failed");
+	TEST_ASSERT(memcmp(run1.metrics, run2.metrics, sizeof(run1.metrics)) == 0,
+	            "Radio model is not deterministic");
+	
+	uint32_t delivered = 0;
+	for (int g = 0; g < RADIO_GUITARS; g++) {
+		const ble_conn_metrics_t *m = &run1.metrics[g];
+		
+		TEST_ASSERT(m->notifications == run1.sent[g], "Metrics miss accepted notifications");
+		TEST_ASSERT(m->rejected == run1.refused[g], "Metrics miss refused notifications");
+		TEST_ASSERT(m->delivered + m->lost == m->notifications, "Notifications unaccounted");
+		delivered += m->delivered;
+	}
+	TEST_ASSERT(run1.received == delivered, "Basestation should receive every delivery");
+	
+	/* Clean link: 10-byte sample needs 80 + 150 + 216 us after the anchor */
+	const ble_conn_metrics_t *clean = &run1.metrics[0];
+	TEST_ASSERT(clean->delivered == RADIO_DURATION_US / radio_period_us[0],
+	            "Clean link should deliver every sample");
+	TEST_ASSERT(clean->retransmissions == 0 && clean->rejected == 0, "Clean link had errors");
+	TEST_ASSERT(clean->latency_max_us <= 7500 + 80 + 150 + 216, "Clean link latency too high");
+	TEST_ASSERT(clean->bytes_delivered == clean->delivered * sizeof(struct accel_sample),
+	            "Clean link byte count wrong");
+	
+	/* 200 Hz into 66.7 events/s */
+	const ble_conn_metrics_t *slow = &run1.metrics[1];
+	TEST_ASSERT(slow->rejected > 0, "Budget-limited link should refuse packets");
+	TEST_ASSERT(slow->max_in_flight == 4, "TX buffers should cap packets in flight");
+	TEST_ASSERT(slow->delivered <= RADIO_DURATION_US / 15000 + 1u + radio_params[1].tx_buffers,
+	            "More PDUs than events (plus buffers drained after the run)");
+	
+	const ble_conn_metrics_t *lossy = &run1.metrics[2];
+	TEST_ASSERT(lossy->retransmissions > 0 && lossy->lost == 0,
+	            "Random loss should be retransmitted");
+	TEST_ASSERT(lossy->latency_max_us > 7500, "Retransmission should add an interval");
+	
+	const ble_conn_metrics_t *bursty = &run1.metrics[3];
+	TEST_ASSERT(bursty->lost > 0, "Bursts longer than max_retx should lose packets");
+	
+	/* Deliberately lossy link still beats the budget-limited one */
+	TEST_ASSERT(lossy->delivered > slow->delivered, "Unexpected throughput ordering");
+	
+	ble_hal_init();
+	
+	TEST_PASS();
+}
+
+/**
+ * Test 14: Multi-threaded Stress Harness
+ * - Four client threads at 200 Hz feed the basestation thread for 200 ms
+ * - Only checks that every sample is accounted for; timing depends on
+ *   the host, run ./stress for the saturation report
+ */
+static void test_stress_harness(void)
+{
+	TEST_START("Multi-threaded Stress Harness");
+	
+	static stress_result_t res;
+	stress_config_t cfg;
+	
+	stress_config_default(&cfg);
+	for (int i = 0; i < cfg.num_guitars; i++) {
+		cfg.rate_hz[i] = 200;
+	}
+	cfg.duration_ms = 200;
+	
+	TEST_ASSERT(stress_run(&cfg, &res) == 0, "Stress run failed");
+	stress_print_report(&cfg, &res, stdout);
+	
+	for (int i = 0; i < cfg.num_guitars; i++) {
+		const stress_guitar_stats_t *g = &res.guitar[i];
+		
+		TEST_ASSERT(g->generated == 40, "Each guitar should generate 40 samples");
+		TEST_ASSERT(g->processed + g->dropped == g->generated, "Samples unaccounted");
+		TEST_ASSERT(g->handoff.count == g->processed, "Handoff latency not recorded");
+	}
+	TEST_ASSERT(res.queue_high_water >= 1 && res.queue_high_water <= cfg.queue_depth,
+	            "Queue high water out of range");
+	TEST_ASSERT(res.midi_messages > 0 && res.midi_bytes == res.midi_messages * 3,
+	            "MIDI TX accounting wrong");
+	
+	stress_config_t bad = cfg;
+	bad.rate_hz[0] = STRESS_MAX_RATE_HZ + 1;
+	TEST_ASSERT(stress_run(&bad, &res) != 0, "Rate above maximum should be rejected");
+	
+	TEST_PASS();
+}
+
+static void test_gyro_fusion(void)
+{
+	TEST_START("Gyro Fusion to Roll/Pitch/Yaw Sources");
+	
+	basestation_emulator_t base;
+	client_emulator_t client;
+	uint8_t client_addr[6] = {0x11, 0x22, 0x33, 0x44, 0x55, 0x77};
+	struct patch_topology_config topo;
+	struct function_unit funcs[MAX_FUNCTION_UNITS];
+	uint8_t midi_msg[3];
+	int16_t angles[IMU_AXES];
+	
+	/* Roll (source 3) and yaw (source 5) only, -180..180 degrees -> 0..127 */
+	topology_patch_init_default(&topo);
+	for (int i = 0; i < MAX_TOPOLOGY_INSTANCES; i++) {
+		topo.topologies[i].enabled = (i == 3 || i == 5);
+	}
+	for (int i = 0; i < MAX_FUNCTION_UNITS; i++) {
+		func_init_linear(&funcs[i], -1800, 1800, 0, 127);
+	}
+	
+	TEST_ASSERT(basestation_emulator_init(&base) == 0, "Basestation init failed");
+	base.quiet = true;
+	TEST_ASSERT(basestation_emulator_configure(&base, topo.topologies, topo.default_mixer_type,
+	                                           funcs, 0, 1) == 0, "Configure failed");
+	TEST_ASSERT(client_emulator_init(&client, client_addr) == 0, "Client init failed");
+	TEST_ASSERT(client_emulator_start_advertising(&client) == 0, "Start advertising failed");
+	TEST_ASSERT(basestation_emulator_connect(&base, client_addr) == 0, "Connect failed");
+	ble_hal_process_events();
+	TEST_ASSERT(basestation_emulator_enable_notifications(&base, 0) == 0,
+	            "Enable notifications failed");
+	ble_hal_process_events();
+	
+	/* Roll 0 -> 45 degrees over 1 s while yawing at 30 dps, 100 Hz */
+	struct gyro_data gyro = {450, 0, 300};
+	for (int i = 0; i <= 100; i++) {
+		double roll = 45.0 * i / 100.0 * (3.14159265358979 / 180.0);
+		struct accel_data accel = {0, (int16_t)lround(1000.0 * sin(roll)),
+		                           (int16_t)lround(1000.0 * cos(roll))};
+		TEST_ASSERT(client_emulator_send_imu(&client, &accel, &gyro) == 0, "Send IMU failed");
+		ble_hal_process_events();
+		ble_hal_advance_time_us(10000);
+	}
+	
+	imu_fusion_get_angles(&base.guitars[0].fusion, angles);
+	printf("  Fused roll %d, pitch %d, yaw %d decidegrees\n", angles[IMU_ROLL],
+	       angles[IMU_PITCH], angles[IMU_YAW]);
+	TEST_ASSERT(abs(angles[IMU_ROLL] - 450) <= 5, "Roll should reach 45 degrees");
+	TEST_ASSERT(abs(angles[IMU_PITCH]) <= 5, "Pitch should stay level");
+	TEST_ASSERT(abs(angles[IMU_YAW] - 300) <= 5, "Yaw should reach 30 degrees");
+	
+	/* 45 degrees: (450 + 1800) * 127 / 3600 = 79; 30 degrees: 74 */
+	TEST_ASSERT(basestation_emulator_get_last_midi(&base, 3, midi_msg), "No roll MIDI data");
+	TEST_ASSERT(midi_msg[1] == 19, "Expected CC 19 for GYRO_ROLL");
+	TEST_ASSERT(abs(midi_msg[2] - 79) <= 1, "Roll CC value wrong");
+	TEST_ASSERT(basestation_emulator_get_last_midi(&base, 5, midi_msg), "No yaw MIDI data");
+	TEST_ASSERT(midi_msg[1] == 21, "Expected CC 21 for GYRO_YAW");
+	TEST_ASSERT(abs(midi_msg[2] - 74) <= 1, "Yaw CC value wrong");
+	
+	/* Legacy accel-only packets leave the gyro sources at 0 (CC value 63) */
+	struct accel_data flat = {0, 0, 1000};
+	TEST_ASSERT(client_emulator_send_accel(&client, &flat) == 0, "Send accel failed");
+	ble_hal_process_events();
+	TEST_ASSERT(basestation_emulator_get_last_midi(&base, 3, midi_msg), "No roll MIDI data");
+	TEST_ASSERT(midi_msg[2] == 63, "Accel-only sample should zero the roll source");
+	
+	client_emulator_cleanup(&client);
+	basestation_emulator_cleanup(&base);
+	
+	TEST_PASS();
+}
+
+static void test_derived_motion_sources(void)
+{
+	TEST_START("Derived Motion Sources (Magnitude, Energy)");
+	
+	basestation_emulator_t base;
+	client_emulator_t client;
+	uint8_t client_addr[6] = {0x11, 0x22, 0x33, 0x44, 0x55, 0x88};
+	struct patch_topology_config topo;
+	struct function_unit funcs[MAX_FUNCTION_UNITS];
+	uint8_t midi_msg[3];
+	
+	/* Energy 0..1000 mg on CC 16, |a| 0..2000 mg on CC 17 */
+	topology_patch_init_default(&topo);
+	for (int i = 2; i < MAX_TOPOLOGY_INSTANCES; i++) {
+		topo.topologies[i].enabled = 0;
+	}
+	topo.topologies[0].accel_inputs[0] = SOURCE_ENERGY;
+	topo.topologies[1].accel_inputs[0] = SOURCE_MAGNITUDE;
+	for (int i = 0; i < MAX_FUNCTION_UNITS; i++) {
+		func_init_linear(&funcs[i], 0, 2000, 0, 127);
+	}
+	func_init_linear(&funcs[0], 0, 1000, 0, 127);
+	
+	TEST_ASSERT(basestation_emulator_init(&base) == 0, "Basestation init failed");
+	base.quiet = true;
+	TEST_ASSERT(basestation_emulator_configure(&base, topo.topologies, topo.default_mixer_type,
+	                                           funcs, 0, 1) == 0, "Configure failed");
+	TEST_ASSERT(base.pipeline.source_mask == ((1u << SOURCE_ENERGY) | (1u << SOURCE_MAGNITUDE)),
+	            "Patch should read only energy and magnitude");
+	TEST_ASSERT(client_emulator_init(&client, client_addr) == 0, "Client init failed");
+	TEST_ASSERT(client_emulator_start_advertising(&client) == 0, "Start advertising failed");
+	TEST_ASSERT(basestation_emulator_connect(&base, client_addr) == 0, "Connect failed");
+	ble_hal_process_events();
+	TEST_ASSERT(basestation_emulator_enable_notifications(&base, 0) == 0,
+	            "Enable notifications failed");
+	ble_hal_process_events();
+	
+	/* Shake +/-500 mg on X for 0.4 s at 100 Hz */
+	for (int i = 0; i < 40; i++) {
+		struct accel_data accel = {(int16_t)((i & 1) ? 500 : -500), 0, 1000};
+		TEST_ASSERT(client_emulator_send_accel(&client, &accel) == 0, "Send accel failed");
+		ble_hal_process_events();
+		ble_hal_advance_time_us(10000);
+	}
+	TEST_ASSERT(basestation_emulator_get_last_midi(&base, 0, midi_msg), "No energy MIDI data");
+	printf("  Shaking: energy CC %u\n", midi_msg[2]);
+	TEST_ASSERT(midi_msg[1] == 16, "Expected CC 16 for ENERGY");
+	TEST_ASSERT(abs(midi_msg[2] - 63) <= 1, "Energy of a +/-500 mg shake should be 63");
+	TEST_ASSERT(basestation_emulator_get_last_midi(&base, 1, midi_msg), "No magnitude MIDI data");
+	TEST_ASSERT(abs(midi_msg[2] - 71) <= 1, "|a| of (500, 0, 1000) should be 71");
+	
+	/* Held still: the envelope falls to 0 within one window */
+	for (int i = 0; i < DERIVED_ENERGY_WINDOW; i++) {
+		struct accel_data accel = {0, 0, 1000};
+		TEST_ASSERT(client_emulator_send_accel(&client, &accel) == 0, "Send accel failed");
+		ble_hal_process_events();
+		ble_hal_advance_time_us(10000);
+	}
+	TEST_ASSERT(basestation_emulator_get_last_midi(&base, 0, midi_msg), "No energy MIDI data");
+	printf("  Still: energy CC %u\n", midi_msg[2]);
+	TEST_ASSERT(midi_msg[2] == 0, "Energy should decay to 0 when still");
+	TEST_ASSERT(basestation_emulator_get_last_midi(&base, 1, midi_msg), "No magnitude MIDI data");
+	TEST_ASSERT(abs(midi_msg[2] - 63) <= 1, "|a| at rest should be 63");
+	
+	client_emulator_cleanup(&client);
+	basestation_emulator_cleanup(&base);
+	
+	TEST_PASS();
+}
+
+/* Note messages seen during a gesture replay */
+typedef struct {
+	int note_on;
+	int note_off;
+	int other;
+	bool overlap;         /* Note On while the previous note still sounds */
+	bool sounding;
+	uint8_t first_velocity;
+} gesture_check_t;
+
+static void collect_notes(uint32_t queued_us, uint32_t tx_done_us, int guitar,
+                          const uint8_t *msg, size_t len, void *user_data)
+{
+	gesture_check_t *chk = user_data;
+	
+	(void)queued_us;
+	(void)tx_done_us;
+	(void)guitar;
+	if (len == 3 && msg[0] == 0x90 && msg[1] == 60) {
+		chk->overlap |= chk->sounding;
+		chk->sounding = true;
+		if (chk->note_on++ == 0) {
+			chk->first_velocity = msg[2];
+		}
+	} else if (len == 3 && msg[0] == 0x80 && msg[1] == 60) {
+		chk->sounding = false;
+		chk->note_off++;
+	} else if ((msg[0] & 0xF0) != 0xB0) {
+		chk->other++;
+	}
+}
+
+#define STRUM_COUNT    4
+#define STRUM_RECORDS  (STRUM_COUNT * 50)
+
+static void test_gesture_replay(void)
+{
+	TEST_START("Gesture Notes From a Replayed Capture");
+	
+	/* One guitar at 100 Hz: four down-strums of 1.2 g on Y, 0.5 s apart */
+	static const int16_t strum_y[] = {0, 300, 900, 1200, 800, 300, 100};
+	static uint8_t file[sizeof(struct capture_header) +
+	                    STRUM_RECORDS * sizeof(struct capture_record)];
+	struct capture_header hdr = {
+		.magic = CAPTURE_MAGIC,
+		.version = CAPTURE_VERSION,
+		.record_size = sizeof(struct capture_record),
+		.record_count = STRUM_RECORDS,
+	};
+	
+	memcpy(file, &hdr, sizeof(hdr));
+	for (int i = 0; i < STRUM_RECORDS; i++) {
+		int phase = i % 50;
+		struct capture_record rec = {
+			.timestamp_us = (uint32_t)i * 10000,
+			.guitar = 0,
+			.x = 0,
+			.y = (phase < (int)(sizeof(strum_y) / sizeof(strum_y[0]))) ? strum_y[phase] : 0,
+			.z = 1000,
+		};
+		memcpy(&file[sizeof(hdr) + i * sizeof(rec)], &rec, sizeof(rec));
+	}
+	
+	/* STRUM on the Y jerk (change per sample), 400 mg threshold, Note 60 */
+	struct gesture_config gestures = {0};
+	gestures.slots[0] = (struct gesture_slot){
+		.type = GESTURE_STRUM,
+		.source = SOURCE_JERK_Y,
+		.action = GESTURE_ACTION_NOTE,
+		.number = 60,
+		.threshold = 400 / GESTURE_THRESHOLD_UNIT,
+		.velocity_curve = GESTURE_VELOCITY_LINEAR,
+	};
+	TEST_ASSERT(gesture_config_validate(&gestures), "Gesture config should be valid");
+	
+	capture_file_t cap;
+	gesture_check_t chk;
+	replay_stats_t stats;
+	replay_options_t opt = {.midi_cb = collect_notes, .user_data = &chk};
+	
+	TEST_ASSERT(capture_file_parse(file, sizeof(file), &cap) == 0, "Parse failed");
+	
+	/* Without gestures: CCs only */
+	memset(&chk, 0, sizeof(chk));
+	TEST_ASSERT(replay_run(&cap, &opt, &stats) == 0, "Replay failed");
+	TEST_ASSERT(chk.note_on == 0 && chk.note_off == 0, "No notes without gestures");
+	
+	memset(&chk, 0, sizeof(chk));
+	opt.gestures = &gestures;
+	TEST_ASSERT(replay_run(&cap, &opt, &stats) == 0, "Gesture replay failed");
+	capture_file_free(&cap);
+	ble_hal_init();
+	
+	printf("  %d strums -> %d Note On, %d Note Off (first velocity %u), %u dropped\n",
+	       STRUM_COUNT, chk.note_on, chk.note_off, chk.first_velocity, stats.midi_dropped);
+	
+	/* Jerk peak 600 mg at threshold 400: strength 42, linear curve */
+	TEST_ASSERT(chk.note_on == STRUM_COUNT, "One Note On per strum");
+	TEST_ASSERT(chk.note_off == STRUM_COUNT, "Every Note On needs its Note Off");
+	TEST_ASSERT(!chk.overlap && !chk.sounding, "Notes should not overlap or hang");
+	TEST_ASSERT(chk.first_velocity == gesture_velocity(42, GESTURE_VELOCITY_LINEAR),
+	            "Velocity should follow the jerk peak");
+	TEST_ASSERT(chk.other == 0, "Only notes and CCs expected");
+	
+	TEST_PASS();
+}
+
+/* Yaw CC and tap notes seen while replaying an IMU capture */
+typedef struct {
+	gesture_check_t notes;
+	int yaw_cc;           /* Last GYRO_YAW value, -1 if none */
+} imu_replay_check_t;
+
+static void collect_imu_replay(uint32_t queued_us, uint32_t tx_done_us, int guitar,
+                               const uint8_t *msg, size_t len, void *user_data)
+{
+	imu_replay_check_t *chk = user_data;
+	
+	if (len == 3 && msg[0] == 0xB0 && msg[1] == 21) {
+		chk->yaw_cc = msg[2];
+	}
+	collect_notes(queued_us, tx_done_us, guitar, msg, len, &chk->notes);
+}
+
+#define IMU_RECORDS  101
+
+static void test_imu_capture_replay(void)
+{
+	TEST_START("Gyro and Edge Events From a Replayed Capture");
+	
+	/* One guitar at 100 Hz yawing at 90 dps for 1 s, plus a client tap
+	 * at 0.5 s; the gyro and event records must reach the basestation */
+	static uint8_t file[sizeof(struct capture_header) +
+	                    (IMU_RECORDS + 2) * sizeof(struct capture_record)];
+	struct capture_header hdr = {
+		.magic = CAPTURE_MAGIC,
+		.version = CAPTURE_VERSION,
+		.record_size = sizeof(struct capture_record),
+		.record_count = IMU_RECORDS + 2,
+	};
+	size_t off = sizeof(hdr);
+	
+	memcpy(file, &hdr, sizeof(hdr));
+	for (int i = 0; i < IMU_RECORDS; i++) {
+		struct capture_record rec = {
+			.timestamp_us = (uint32_t)i * 10000,
+			.flags = CAPTURE_F_TIMED | CAPTURE_F_GYRO,
+			.z = 1000,
+			.gz = 900,
+		};
+		memcpy(&file[off], &rec, sizeof(rec));
+		off += sizeof(rec);
+		
+		if (i == 50 || i == 60) {
+			struct capture_record ev = {
+				.timestamp_us = (uint32_t)i * 10000 + 1000,
+				.flags = CAPTURE_F_TIMED | CAPTURE_F_EVENT,
+				.x = MOTION_EVENT_TAP,
+				.y = (i == 60) ? MOTION_EVENT_F_END : 0,
+				.z = 900,
+			};
+			memcpy(&file[off], &ev, sizeof(ev));
+			off += sizeof(ev);
+		}
+	}
+	
+	struct gesture_config gestures = {0};
+	gestures.slots[0] = (struct gesture_slot){GESTURE_TAP, SOURCE_JERK, GESTURE_ACTION_NOTE,
+	                                          60, 600 / GESTURE_THRESHOLD_UNIT,
+	                                          GESTURE_VELOCITY_LINEAR};
+	TEST_ASSERT(gesture_config_validate(&gestures), "Gesture config should be valid");
+	
+	capture_file_t cap;
+	imu_replay_check_t chk;
+	replay_stats_t stats;
+	replay_options_t opt = {.midi_cb = collect_imu_replay, .user_data = &chk,
+	                        .gestures = &gestures};
+	
+	memset(&chk, 0, sizeof(chk));
+	chk.yaw_cc = -1;
+	TEST_ASSERT(capture_file_parse(file, sizeof(file), &cap) == 0, "Parse failed");
+	TEST_ASSERT(replay_run(&cap, &opt, &stats) == 0, "Replay failed");
+	capture_file_free(&cap);
+	ble_hal_init();
+	
+	printf("  Yaw CC %d, %d Note On, %d Note Off\n", chk.yaw_cc, chk.notes.note_on,
+	       chk.notes.note_off);
+	
+	/* 90 degrees: (900 + 2000) * 127 / 4000 = 92 */
+	TEST_ASSERT(abs(chk.yaw_cc - 92) <= 1, "Captured gyro should drive the yaw source");
+	TEST_ASSERT(chk.notes.note_on == 1 && chk.notes.note_off == 1,
+	            "Captured tap events should play one note");
+	TEST_ASSERT(chk.notes.first_velocity == gesture_velocity(44, GESTURE_VELOCITY_LINEAR),
+	            "Tap velocity should follow the captured event value");
+	
+	TEST_PASS();
+}
+
+/* Messages seen while a client sends edge events */
+typedef struct {
+	int note_on;
+	int note_off;
+	int cc;
+	int sounding;
+	uint8_t notes[4];        /* Note On numbers, in order */
+	uint8_t velocities[4];
+	uint32_t first_on_us;    /* Queue time of the first Note On */
+} edge_check_t;
+
+static void collect_edge_midi(int guitar_index, const uint8_t *msg, size_t len,
+                              uint32_t queued_us, uint32_t tx_done_us, void *user_data)
+{
+	edge_check_t *chk = user_data;
+	
+	(void)guitar_index;
+	(void)tx_done_us;
+	if (len == 3 && (msg[0] & 0xF0) == 0x90 && msg[2] > 0) {
+		if (chk->note_on == 0) {
+			chk->first_on_us = queued_us;
+		}
+		if (chk->note_on < 4) {
+			chk->notes[chk->note_on] = msg[1];
+			chk->velocities[chk->note_on] = msg[2];
+		}
+		chk->note_on++;
+		chk->sounding++;
+	} else if (len == 3 && (msg[0] & 0xF0) == 0x80) {
+		chk->note_off++;
+		chk->sounding--;
+	} else if (len == 3 && (msg[0] & 0xF0) == 0xB0) {
+		chk->cc++;
+	}
+}
+
+#define EDGE_RATE_HZ     200
+#define EDGE_PERIOD_US   (1000000 / EDGE_RATE_HZ)
+#define EDGE_STREAM_DIV  (EDGE_RATE_HZ / 10)   /* Continuous stream at 10 Hz */
+
+static void test_edge_events(void)
+{
+	TEST_START("Edge Events Alongside the Continuous Stream");
+	
+	basestation_emulator_t base;
+	client_emulator_t client;
+	uint8_t client_addr[6] = {0x11, 0x22, 0x33, 0x44, 0x55, 0x79};
+	struct patch_topology_config topo;
+	struct function_unit funcs[MAX_FUNCTION_UNITS];
+	edge_check_t chk = {0};
+	
+	topology_patch_init_default(&topo);
+	for (int i = 0; i < MAX_FUNCTION_UNITS; i++) {
+		func_init_linear(&funcs[i], -2000, 2000, 0, 127);
+	}
+	
+	/* Tap -> Note 60, shake -> Note 62, tilt -> Note 64. The tilt threshold
+	 * is above the 44 degrees reached, so only the client's event fires it */
+	struct gesture_config gestures = {0};
+	gestures.slots[0] = (struct gesture_slot){GESTURE_TAP, SOURCE_JERK, GESTURE_ACTION_NOTE,
+	                                          60, 600 / GESTURE_THRESHOLD_UNIT,
+	                                          GESTURE_VELOCITY_LINEAR};
+	gestures.slots[1] = (struct gesture_slot){GESTURE_SHAKE, SOURCE_ENERGY, GESTURE_ACTION_NOTE,
+	                                          62, 300 / GESTURE_THRESHOLD_UNIT,
+	                                          GESTURE_VELOCITY_LINEAR};
+	gestures.slots[2] = (struct gesture_slot){GESTURE_TILT, 4, GESTURE_ACTION_NOTE,
+	                                          64, 500 / GESTURE_THRESHOLD_UNIT,
+	                                          GESTURE_VELOCITY_LINEAR};
+	TEST_ASSERT(gesture_config_validate(&gestures), "Gesture config should be valid");
+	
+	TEST_ASSERT(basestation_emulator_init(&base) == 0, "Basestation init failed");
+	base.quiet = true;
+	TEST_ASSERT(basestation_emulator_configure(&base, topo.topologies, topo.default_mixer_type,
+	                                           funcs, 0, 1) == 0, "Configure failed");
+	midi_pipeline_set_gestures(&base.pipeline, &gestures);
+	basestation_emulator_set_midi_cb(&base, collect_edge_midi, &chk);
+	TEST_ASSERT(client_emulator_init(&client, client_addr) == 0, "Client init failed");
+	TEST_ASSERT(client_emulator_enable_edge(&client, NULL) == 0, "Enable edge mode failed");
+	TEST_ASSERT(client_emulator_start_advertising(&client) == 0, "Start advertising failed");
+	TEST_ASSERT(basestation_emulator_connect(&base, client_addr) == 0, "Connect failed");
+	ble_hal_process_events();
+	TEST_ASSERT(basestation_emulator_enable_notifications(&base, 0) == 0,
+	            "Enable notifications failed");
+	ble_hal_process_events();
+	
+	/* 4 s at 200 Hz: a tap at 0.5 s, a 10 Hz shake of 0.7 g from 1 to 1.5 s,
+	 * the neck tilted to 44 degrees over 0.5 s from 2 s, held for 0.5 s and
+	 * brought back, at rest otherwise */
+	uint32_t tap_us = 0;
+	for (int i = 0; i < 4 * EDGE_RATE_HZ; i++) {
+		struct accel_data accel = {0, 0, 1000};
+		
+		if (i == 105) {
+			accel.y = 900;
+			tap_us = ble_hal_get_time_us();
+		} else if (i >= 200 && i < 300) {
+			accel.x = (int16_t)lround(700.0 * sin(2.0 * 3.14159265358979 * 10.0 * i /
+			                                      EDGE_RATE_HZ));
+		} else if (i >= 400 && i < 700) {
+			int step = (i < 500) ? i - 400 : (i < 600) ? 100 : 700 - i;
+			double angle = step / 100.0 * (44.0 * 3.14159265358979 / 180.0);
+			
+			accel.x = (int16_t)lround(-1000.0 * sin(angle));
+			accel.z = (int16_t)lround(1000.0 * cos(angle));
+		}
+		
+		TEST_ASSERT(client_emulator_edge_sample(&client, &accel) >= 0, "Edge sample failed");
+		if (i % EDGE_STREAM_DIV == 0) {
+			TEST_ASSERT(client_emulator_send_accel(&client, &accel) == 0, "Send accel failed");
+		}
+		ble_hal_process_events();
+		ble_hal_advance_time_us(EDGE_PERIOD_US);
+	}
+	
+	printf("  %u events -> %d Note On, %d Note Off, %d CC; tap reaction %u us\n",
+	       client.events_sent, chk.note_on, chk.note_off, chk.cc, chk.first_on_us - tap_us);
+	
+	TEST_ASSERT(client.events_sent == 6, "Expected start and end of tap, shake and tilt");
+	TEST_ASSERT(chk.note_on == 3, "One Note On per gesture");
+	TEST_ASSERT(chk.notes[0] == 60 && chk.notes[1] == 62 && chk.notes[2] == 64,
+	            "Tap, shake and tilt notes in order");
+	/* Jerk 900 mg at threshold 592: strength 44, linear curve */
+	TEST_ASSERT(chk.velocities[0] == gesture_velocity(44, GESTURE_VELOCITY_LINEAR),
+	            "Tap velocity should follow the client's jerk peak");
+	TEST_ASSERT(chk.first_on_us - tap_us < EDGE_PERIOD_US,
+	            "Tap should sound within one client sample, not one stream period");
+	TEST_ASSERT(chk.note_off == 3 && chk.sounding == 0, "Every gesture end sends Note Off");
+	TEST_ASSERT(chk.cc > 0, "The continuous stream should keep sending CCs");
+	
+	client_emulator_cleanup(&client);
+	basestation_emulator_cleanup(&base);
+	
+	TEST_PASS();
+}
+
 /* ============================================================================
  * Main Test Runner
  * ============================================================================ */
@@ -483,6 +1583,17 @@ int main(void)
 	test_midi_range();
 	test_midi_format();
 	test_disconnection();
+	test_latency_breakdown();
+	test_capture_replay();
+	test_smf_export();
+	test_patch_configuration();
+	test_radio_model();
+	test_stress_harness();
+	test_gyro_fusion();
+	test_derived_motion_sources();
+	test_gesture_replay();
+	test_imu_capture_replay();
+	test_edge_events();
 	
 	/* Print summary */
 	printf("\n");